@@ -0,0 +1,185 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Filesystem.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Noncopyable.h"
+#include "cinder/Surface.h"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class BatchImageLoader>	BatchImageLoaderRef;
+
+//! Decodes many image files into Surfaces on a pool of worker threads, bounding the number of decoded bytes that are in flight at once.
+//!
+//! Each file is opened with loadImage() and decoded with Surface8u::create(), so every ImageSource the platform registers is supported. Completed
+//! images are delivered in completion order, both through the optional CompletionFn and through the future returned from load(). Queued images are
+//! decoded highest priority first, in the order they were added within the same priority.
+//!
+//! \note The CompletionFn is called on a worker thread, or on the thread calling cancel() for images which were still queued. Use app::App::dispatchAsync() to hand results to the main thread, for example to create gl::Textures.
+class CI_API BatchImageLoader : private Noncopyable {
+  public:
+	typedef uint64_t	RequestId;
+
+	//! The outcome of a single load() request.
+	class CI_API Result {
+	  public:
+		Result() : mId( 0 ), mCancelled( false ), mQueuedSeconds( 0 ), mOpenSeconds( 0 ), mDecodeSeconds( 0 ) {}
+
+		//! Returns the id returned from load() for this image.
+		RequestId			getId() const				{ return mId; }
+		//! Returns the path passed to load().
+		const fs::path&		getPath() const				{ return mPath; }
+		//! Returns the decoded Surface, or \c nullptr if the image was cancelled or failed to load.
+		const SurfaceRef&	getSurface() const			{ return mSurface; }
+		//! Returns whether the image was cancelled before it was delivered.
+		bool				isCancelled() const			{ return mCancelled; }
+		//! Returns whether loading the image threw an exception.
+		bool				hasError() const			{ return (bool)mError; }
+		//! Returns the exception thrown while loading the image, or \c nullptr.
+		std::exception_ptr	getError() const			{ return mError; }
+		//! Returns the number of seconds the image waited in the queue before a worker picked it up.
+		double				getQueuedSeconds() const	{ return mQueuedSeconds; }
+		//! Returns the number of seconds spent opening the file and reading its header.
+		double				getOpenSeconds() const		{ return mOpenSeconds; }
+		//! Returns the number of seconds spent decoding the pixels into the Surface.
+		double				getDecodeSeconds() const	{ return mDecodeSeconds; }
+
+	  private:
+		RequestId			mId;
+		fs::path			mPath;
+		SurfaceRef			mSurface;
+		bool				mCancelled;
+		std::exception_ptr	mError;
+		double				mQueuedSeconds, mOpenSeconds, mDecodeSeconds;
+
+		friend class BatchImageLoader;
+	};
+
+	typedef std::function<void( const Result &result )>	CompletionFn;
+
+	//! Returned from load(), identifies a queued image and provides a future for its Result.
+	class CI_API Request {
+	  public:
+		Request() : mId( 0 ) {}
+
+		//! Returns the id used to cancel() or setPriority() this image.
+		RequestId							getId() const		{ return mId; }
+		//! Returns a future which becomes ready once the image has been delivered or cancelled.
+		const std::shared_future<Result>&	getFuture() const	{ return mFuture; }
+
+	  private:
+		Request( RequestId id, const std::shared_future<Result> &future ) : mId( id ), mFuture( future ) {}
+
+		RequestId					mId;
+		std::shared_future<Result>	mFuture;
+
+		friend class BatchImageLoader;
+	};
+
+	struct CI_API Options {
+		Options() : mNumThreads( 0 ), mMaxBytesInFlight( 512 * 1024 * 1024 ) {}
+
+		//! Sets the number of worker threads. A value of \c 0 uses one thread per hardware core. Default is \c 0.
+		Options&	numThreads( int numThreads ) { mNumThreads = numThreads; return *this; }
+		//! Sets the maximum number of bytes of decoded Surfaces held by the workers at once. An image larger than the budget is still decoded, but only while no other image is in flight. Default is 512MB.
+		Options&	maxBytesInFlight( size_t bytes ) { mMaxBytesInFlight = bytes; return *this; }
+		//! Sets the ImageSource::Options passed to loadImage().
+		Options&	imageOptions( const ImageSource::Options &options ) { mImageOptions = options; return *this; }
+		//! Sets a function called on the worker thread with each completed or cancelled image.
+		Options&	completionFn( const CompletionFn &fn ) { mCompletionFn = fn; return *this; }
+
+		int							getNumThreads() const		{ return mNumThreads; }
+		size_t						getMaxBytesInFlight() const	{ return mMaxBytesInFlight; }
+		const ImageSource::Options&	getImageOptions() const		{ return mImageOptions; }
+		const CompletionFn&			getCompletionFn() const		{ return mCompletionFn; }
+
+	  private:
+		int						mNumThreads;
+		size_t					mMaxBytesInFlight;
+		ImageSource::Options	mImageOptions;
+		CompletionFn			mCompletionFn;
+	};
+
+	static BatchImageLoaderRef	create( const Options &options = Options() ) { return BatchImageLoaderRef( new BatchImageLoader( options ) ); }
+	//! Cancels every queued image and waits for the images being decoded to be delivered.
+	~BatchImageLoader();
+
+	//! Queues the image at \a path for decoding. Higher \a priority images are decoded first.
+	Request					load( const fs::path &path, int priority = 0 );
+	//! Queues every image in \a paths for decoding with the same \a priority, preserving their order.
+	std::vector<Request>	load( const std::vector<fs::path> &paths, int priority = 0 );
+
+	//! Changes the priority of a queued image, for example when it scrolls on screen. Returns \c false if the image is no longer queued.
+	bool	setPriority( RequestId id, int priority );
+	//! Cancels the image \a id. A queued image is delivered immediately as cancelled; an image being decoded is delivered as cancelled once its decode finishes. Returns \c false if the image was already delivered.
+	bool	cancel( RequestId id );
+	//! Cancels every queued and in-flight image.
+	void	cancelAll();
+	//! Blocks until every queued image has been delivered.
+	void	waitAll();
+
+	//! Returns the number of images which have not yet been picked up by a worker.
+	size_t	getNumQueued() const;
+	//! Returns the number of bytes of decoded Surfaces currently held by the workers.
+	size_t	getBytesInFlight() const;
+	//! Returns the number of worker threads.
+	size_t	getNumThreads() const	{ return mThreads.size(); }
+
+  protected:
+	BatchImageLoader( const Options &options );
+
+  private:
+	struct Job;
+
+	void	threadEntry();
+	void	deliver( const std::shared_ptr<Job> &job, Result &result, size_t bytesInFlight );
+	void	deliverCancelled( const std::vector<std::shared_ptr<Job>> &jobs );
+
+	Options									mOptions;
+	std::vector<std::thread>				mThreads;
+	mutable std::mutex						mMutex;
+	std::condition_variable					mQueueCond, mBudgetCond, mIdleCond;
+	//! queued jobs, ordered by descending priority and then by id
+	std::map<std::pair<int,RequestId>, std::shared_ptr<Job>>	mQueue;
+	//! every job which has not been delivered yet, queued or in flight
+	std::unordered_map<RequestId, std::shared_ptr<Job>>			mJobs;
+	RequestId								mNextId;
+	size_t									mBytesInFlight;
+	bool									mQuit;
+};
+
+} // namespace cinder
@@ -23,6 +23,8 @@
 #pragma once
 
 #include "cinder/Cinder.h"
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <mutex>
 
@@ -81,27 +83,48 @@ class CI_API Buffer {
 	bool	mOwnsData;
 };
 
-//! Thread-safe single-producer, single-consumer block-based double-ended byte queue
+//! Lock-free single-producer, single-consumer block-based double-ended byte queue. One thread may push, using pushFront(), reserve(), commit() and shrinkToFit(),
+//! while another pops, using popBack(), peek(), consume(), copyTo() and clear(). getSize() and empty() may be called from either. Drained blocks are recycled
+//! by the producer, so a steady stream allocates nothing.
 class CI_API StreamingBuffer {
   public:
+	//! A contiguous run of readable bytes inside one block, returned by peek()
+	struct Region {
+		const uint8_t	*mData;
+		size_t			mSize;
+	};
+
 	StreamingBuffer( size_t blockSizeBytes = 65536 );
+	~StreamingBuffer();
 
-	//! pushes \a sizeBytes bytes at the front of the deque
+	//! pushes \a sizeBytes bytes at the front of the deque. Producer only.
 	void	pushFront( const void *data, size_t sizeBytes );
-	//! pops up to \a maxSize bytes from the back of the deque. Returns the number of bytes popped, which may be 0.
+	//! pops up to \a maxSize bytes from the back of the deque. Returns the number of bytes popped, which may be 0. Consumer only.
 	size_t	popBack( void *output, size_t maxSize );
 
+	//! Returns writable memory for up to \a maxSize bytes at the front of the deque, setting \a reservedSize to its size, which is never 0 for a nonzero \a maxSize
+	//! but is limited to what remains of the current block. Nothing is visible to the consumer until commit(). Producer only.
+	uint8_t*	reserve( size_t maxSize, size_t *reservedSize );
+	//! Pushes the first \a sizeBytes bytes written to the memory returned by the last reserve(), which must not exceed its reserved size. Producer only.
+	void		commit( size_t sizeBytes );
+
+	//! Fills \a regions with up to \a maxRegions views of the oldest readable bytes, at most \a maxSize in total and in order, without popping them.
+	//! Returns the number of regions filled. The views stay valid until the bytes are consumed. Consumer only.
+	size_t	peek( Region *regions, size_t maxRegions, size_t maxSize = SIZE_MAX ) const;
+	//! Pops \a sizeBytes bytes from the back of the deque without copying them, typically after reading them through peek(). Consumer only.
+	void	consume( size_t sizeBytes );
+
 	//! returns the number of bytes currently in the deque
 	size_t	getSize() const;
 
 	//! returns \c true if the deque is empty
 	bool 	empty() const { return getSize() == 0; }
-	//! clears all data in the deque but does not deallocate internal storage
+	//! clears all data in the deque but does not deallocate internal storage. Consumer only.
 	void	clear();
-	//! deallocates internal storage to precisely fit current size
+	//! deallocates the blocks that are waiting to be reused. Producer only.
 	void	shrinkToFit();
 
-	//! Performs a non-destructive copy to \a output, up to \a maxSize bytes. Does not pop any data. Returns number of bytes written
+	//! Performs a non-destructive copy to \a output, up to \a maxSize bytes. Does not pop any data. Returns number of bytes written. Consumer only.
 	size_t	copyTo( void *output, size_t maxSize ) const;
 
   private:
@@ -111,15 +134,30 @@ class CI_API StreamingBuffer {
 	StreamingBuffer&	operator=( const StreamingBuffer &rhs ) = delete;
 	StreamingBuffer&	operator=( StreamingBuffer &&rhs ) = delete;
 
-	void	allocateNewWriteBlock();
-	void	releaseCurrentReadBlock();
-	size_t	calcSize() const;
-
-	std::deque<std::unique_ptr<uint8_t[]>>		mBlocks, mUnusedBlocks;
-
-	mutable std::mutex					mMutex;
-	const size_t						mBlockSize;
-	size_t								mWriteOffset, mReadOffset; // expressed in bytes
+	struct Block {
+		Block( size_t size ) : mData( new uint8_t[size] ), mNext( nullptr ) {}
+
+		std::unique_ptr<uint8_t[]>	mData;
+		std::atomic<Block*>			mNext;
+	};
+
+	Block*	acquireBlock();
+
+	// Blocks form a list from the oldest recycled one to the one being written. Those before the consumer's read block are free for the producer to reuse.
+	struct alignas( 64 ) ProducerState {
+		Block					*mFirstBlock, *mWriteBlock, *mReadBlockCache;
+		size_t					mWriteOffset;
+		std::atomic<size_t>		mNumWritten; // total bytes committed
+	};
+	struct alignas( 64 ) ConsumerState {
+		std::atomic<Block*>		mReadBlock;
+		size_t					mReadOffset;
+		std::atomic<size_t>		mNumRead; // total bytes consumed
+	};
+
+	const size_t		mBlockSize;
+	ProducerState		mProducer;
+	ConsumerState		mConsumer;
 };
 
 CI_API Buffer compressBuffer( const Buffer &buffer, int8_t compressionLevel = DEFAULT_COMPRESSION_LEVEL, bool resizeResult = true );
@@ -29,6 +29,15 @@
 #include "cinder/Noncopyable.h"
 #include "cinder/Thread.h"
 
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <utility>
+
+#if ( defined( _M_X64 ) || defined( _M_IX86 ) ) && defined( _MSC_VER )
+	#include <intrin.h>
+#endif
+
 namespace cinder {
 
 template<typename T>
@@ -134,4 +143,532 @@ class ConcurrentCircularBuffer : private Noncopyable {
 	bool					mCanceled;
 };
 
+namespace detail {
+
+//! Number of times the blocking calls of the lock-free buffers poll before parking the thread, by default
+const uint32_t CIRCULAR_BUFFER_DEFAULT_SPIN_COUNT = 128;
+
+//! Returns the smallest power of two that is at least \a n, so that the lock-free buffers can wrap positions with a mask rather than a division
+inline size_t roundUpToPowerOfTwo( size_t n )
+{
+	size_t result = 1;
+	while( result < n )
+		result *= 2;
+	return result;
+}
+
+//! Hints to the CPU that the calling thread is spinning on a shared value
+inline void cpuRelax()
+{
+#if ( defined( _M_X64 ) || defined( _M_IX86 ) ) && defined( _MSC_VER )
+	_mm_pause();
+#elif defined( __x86_64__ ) || defined( __i386__ )
+	__builtin_ia32_pause();
+#elif defined( __aarch64__ ) || defined( __arm__ )
+	asm volatile( "yield" );
+#endif
+}
+
+//! Where threads of a lock-free buffer wait for room or for items. A waiting thread polls a few times, then parks on a futex-style atomic wait; a notifying thread only
+//! makes a system call when someone is actually parked.
+class ParkingSpot {
+  public:
+	ParkingSpot() : mEpoch( 0 ), mNumParked( 0 ) {}
+
+	//! Returns once \a readyFn returns true or \a canceled is set, polling \a spinCount times before parking. \a readyFn must read the buffer's state with acquire loads.
+	template<typename ReadyFn>
+	void wait( uint32_t spinCount, const std::atomic<bool> &canceled, ReadyFn readyFn )
+	{
+		for( uint32_t i = 0; i < spinCount; ++i ) {
+			if( readyFn() || canceled.load( std::memory_order_relaxed ) )
+				return;
+			cpuRelax();
+		}
+
+		while( ! readyFn() && ! canceled.load() ) {
+			// Stays registered until a notify() claims it, like a condition variable waiter, so that only the first notify() after parking makes a system call.
+			// A waiter that finds readyFn true below leaves a stale registration, which costs one needless wake.
+			mNumParked.fetch_add( 1 );
+			const uint32_t epoch = mEpoch.load();
+			// checked again now that notify() is bound to see this thread as parked
+			if( ! readyFn() && ! canceled.load() )
+				mEpoch.wait( epoch );
+		}
+	}
+
+	//! Wakes every parked thread. Called after the state that \a readyFn reads has been updated.
+	void notify()
+	{
+		// A read-modify-write either claims a waiter's registration or is seen by it, in which case the waiter's final check of readyFn sees the caller's update.
+		// A plain load could miss both, and a fence would do as well but isn't understood by ThreadSanitizer.
+		if( mNumParked.exchange( 0, std::memory_order_acq_rel ) > 0 )
+			wakeAll();
+	}
+
+	//! Wakes every parked thread unconditionally, as cancellation requires.
+	void wakeAll()
+	{
+		mEpoch.fetch_add( 1 );
+		mEpoch.notify_all();
+	}
+
+  private:
+	std::atomic<uint32_t>	mEpoch;
+	std::atomic<uint32_t>	mNumParked;
+};
+
+} // namespace detail
+
+//! A lock-free variant of ConcurrentCircularBuffer for exactly one producer thread and one consumer thread, such as a capture thread handing frames to the render thread.
+//! Supports move-only types and batched pushes and pops, which publish all of their items at once. Blocking calls spin briefly before parking the thread, and a push or pop
+//! only makes a system call when the other side is parked. Only the producer may push and only the consumer may pop or clear(). Moving a \c T out of the buffer must not throw.
+template<typename T>
+class SpscCircularBuffer : private Noncopyable {
+  public:
+	typedef size_t size_type;
+
+	//! Creates a buffer holding up to \a capacity items, whose blocking calls poll \a spinCount times before parking.
+	explicit SpscCircularBuffer( size_type capacity, uint32_t spinCount = detail::CIRCULAR_BUFFER_DEFAULT_SPIN_COUNT )
+		: mCapacity( std::max<size_type>( 1, capacity ) ), mSpinCount( spinCount ), mCanceled( false )
+	{
+		const size_type numSlots = detail::roundUpToPowerOfTwo( mCapacity );
+		mMask = numSlots - 1;
+		mSlots.reset( new Slot[numSlots] );
+		mProducer.mTail = 0;
+		mProducer.mHeadCache = 0;
+		mConsumer.mHead = 0;
+		mConsumer.mTailCache = 0;
+	}
+
+	~SpscCircularBuffer()
+	{
+		for( size_type pos = mConsumer.mHead.load(); pos != mProducer.mTail.load(); ++pos )
+			item( pos )->~T();
+	}
+
+	//! Pushes \a item, waiting for room. Returns \c false without pushing if the buffer is canceled.
+	bool pushFront( const T &item )		{ return pushImpl( item ); }
+	//! Pushes \a item, waiting for room. Returns \c false without pushing if the buffer is canceled.
+	bool pushFront( T &&item )			{ return pushImpl( std::move( item ) ); }
+	//! Pushes every item of [\a first, \a last), waiting for room as necessary. Returns the number of items pushed, which is smaller only if the buffer is canceled.
+	template<typename InputIt>
+	size_type pushFront( InputIt first, InputIt last )
+	{
+		size_type result = 0;
+		while( first != last && ! mCanceled.load() ) {
+			result += tryPushRange( first, last );
+			if( first != last )
+				mNotFull.wait( mSpinCount, mCanceled, [this] { return isNotFull(); } );
+		}
+		return result;
+	}
+
+	//! Pops the oldest item into \a pItem, waiting for one. Returns \c false without popping if the buffer is canceled.
+	bool popBack( T *pItem )
+	{
+		while( ! mCanceled.load() ) {
+			if( tryPopBack( pItem ) )
+				return true;
+			mNotEmpty.wait( mSpinCount, mCanceled, [this] { return isNotEmpty(); } );
+		}
+		return false;
+	}
+
+	//! Pops up to \a maxCount of the oldest items into \a out, waiting until there is at least one. Returns the number of items popped, which is \c 0 only if the buffer is canceled.
+	template<typename OutputIt>
+	size_type popBack( OutputIt out, size_type maxCount )
+	{
+		while( ! mCanceled.load() ) {
+			if( size_type result = tryPopBack( out, maxCount ) )
+				return result;
+			mNotEmpty.wait( mSpinCount, mCanceled, [this] { return isNotEmpty(); } );
+		}
+		return 0;
+	}
+
+	//! Attempts to push \a item to the front of the buffer, but does not wait for room. Returns success as true or false.
+	bool tryPushFront( const T &item )	{ return tryPushImpl( item ); }
+	//! Attempts to push \a item to the front of the buffer, but does not wait for room. Returns success as true or false.
+	bool tryPushFront( T &&item )		{ return tryPushImpl( std::move( item ) ); }
+	//! Pushes as many items of [\a first, \a last) as there is room for without waiting, returning how many were pushed. Use std::make_move_iterator() to move items in.
+	template<typename InputIt>
+	size_type tryPushFront( InputIt first, InputIt last )	{ return tryPushRange( first, last ); }
+
+	//! Attempts to pop an item from the back of the buffer, but does not wait for one. Returns success as true or false.
+	bool tryPopBack( T *pItem )			{ return tryPopBack( pItem, 1 ) == 1; }
+	//! Pops up to \a maxCount of the oldest items into \a out without waiting, returning how many were popped.
+	template<typename OutputIt>
+	size_type tryPopBack( OutputIt out, size_type maxCount )
+	{
+		const size_type head = mConsumer.mHead.load( std::memory_order_relaxed );
+		if( mConsumer.mTailCache - head < maxCount )
+			mConsumer.mTailCache = mProducer.mTail.load( std::memory_order_acquire );
+		const size_type count = std::min( maxCount, mConsumer.mTailCache - head );
+		for( size_type i = 0; i < count; ++i ) {
+			T *source = item( head + i );
+			*out = std::move( *source );
+			++out;
+			source->~T();
+		}
+		if( count ) {
+			mConsumer.mHead.store( head + count, std::memory_order_release );
+			mNotFull.notify();
+		}
+		return count;
+	}
+
+	bool isNotEmpty() const		{ return mProducer.mTail.load() != mConsumer.mHead.load(); }
+	bool isNotFull() const		{ return mProducer.mTail.load() - mConsumer.mHead.load() < mCapacity; }
+
+	//! Makes blocking calls return \c false rather than wait, including those already waiting.
+	void cancel()
+	{
+		mCanceled.store( true );
+		mNotFull.wakeAll();
+		mNotEmpty.wakeAll();
+	}
+
+	void uncancel()				{ mCanceled.store( false ); }
+
+	//! Destroys every item in the buffer. May only be called by the consumer.
+	void clear()
+	{
+		const size_type tail = mProducer.mTail.load( std::memory_order_acquire );
+		size_type head = mConsumer.mHead.load( std::memory_order_relaxed );
+		for( ; head != tail; ++head )
+			item( head )->~T();
+		mConsumer.mHead.store( head, std::memory_order_release );
+		mNotFull.notify();
+	}
+
+	//! Returns the number of items the buffer can hold
+	size_t getCapacity() const	{ return mCapacity; }
+	//! Returns the number of items the buffer is currently holding, which may be out of date by the time it returns
+	size_t getSize() const
+	{
+		const size_type head = mConsumer.mHead.load();
+		return std::min<size_type>( mProducer.mTail.load() - head, mCapacity );
+	}
+
+  private:
+	struct Slot {
+		alignas( T ) unsigned char	mStorage[sizeof( T )];
+	};
+
+	T* item( size_type pos )	{ return std::launder( reinterpret_cast<T*>( mSlots[pos & mMask].mStorage ) ); }
+
+	template<typename U>
+	bool tryPushImpl( U &&value )
+	{
+		const size_type tail = mProducer.mTail.load( std::memory_order_relaxed );
+		if( tail - mProducer.mHeadCache == mCapacity ) {
+			mProducer.mHeadCache = mConsumer.mHead.load( std::memory_order_acquire );
+			if( tail - mProducer.mHeadCache == mCapacity )
+				return false;
+		}
+		new( mSlots[tail & mMask].mStorage ) T( std::forward<U>( value ) );
+		mProducer.mTail.store( tail + 1, std::memory_order_release );
+		mNotEmpty.notify();
+		return true;
+	}
+
+	template<typename U>
+	bool pushImpl( U &&value )
+	{
+		while( ! mCanceled.load() ) {
+			// only moves from value once it succeeds
+			if( tryPushImpl( std::forward<U>( value ) ) )
+				return true;
+			mNotFull.wait( mSpinCount, mCanceled, [this] { return isNotFull(); } );
+		}
+		return false;
+	}
+
+	// Pushes items from \a first, advancing it past those that fit
+	template<typename InputIt>
+	size_type tryPushRange( InputIt &first, InputIt last )
+	{
+		const size_type tail = mProducer.mTail.load( std::memory_order_relaxed );
+		size_type count = 0;
+		for( ; first != last; ++first, ++count ) {
+			if( tail + count - mProducer.mHeadCache == mCapacity ) {
+				mProducer.mHeadCache = mConsumer.mHead.load( std::memory_order_acquire );
+				if( tail + count - mProducer.mHeadCache == mCapacity )
+					break;
+			}
+			new( mSlots[( tail + count ) & mMask].mStorage ) T( *first );
+		}
+		if( count ) {
+			mProducer.mTail.store( tail + count, std::memory_order_release );
+			mNotEmpty.notify();
+		}
+		return count;
+	}
+
+	// each side's index and its cached copy of the other side's index share a cache line of their own
+	struct alignas( 64 ) ProducerState {
+		std::atomic<size_type>	mTail;
+		size_type				mHeadCache;
+	};
+	struct alignas( 64 ) ConsumerState {
+		std::atomic<size_type>	mHead;
+		size_type				mTailCache;
+	};
+
+	ProducerState				mProducer;
+	ConsumerState				mConsumer;
+	const size_type				mCapacity;
+	size_type					mMask;
+	std::unique_ptr<Slot[]>		mSlots;
+	const uint32_t				mSpinCount;
+	std::atomic<bool>			mCanceled;
+	detail::ParkingSpot			mNotEmpty, mNotFull;
+};
+
+//! A lock-free, bounded variant of ConcurrentCircularBuffer for any number of producer and consumer threads. Items are claimed through a compare-and-swap on a shared
+//! position and published through a per-slot sequence number, so producers and consumers only contend with their own kind. Supports move-only types and batched pushes and pops.
+//! Blocking calls spin briefly before parking the thread. Copying or moving a \c T into or out of the buffer must not throw, since its slot has already been claimed.
+template<typename T>
+class MpmcCircularBuffer : private Noncopyable {
+  public:
+	typedef size_t size_type;
+
+	//! Creates a buffer holding up to \a capacity items, whose blocking calls poll \a spinCount times before parking.
+	explicit MpmcCircularBuffer( size_type capacity, uint32_t spinCount = detail::CIRCULAR_BUFFER_DEFAULT_SPIN_COUNT )
+		: mCapacity( std::max<size_type>( 1, capacity ) ), mNumCells( detail::roundUpToPowerOfTwo( std::max<size_type>( 2, mCapacity ) ) ), mMask( mNumCells - 1 ), mCells( new Cell[mNumCells] ), mSpinCount( spinCount ), mCanceled( false )
+	{
+		for( size_type i = 0; i < mNumCells; ++i )
+			mCells[i].mSequence.store( i, std::memory_order_relaxed );
+		mEnqueuePos.mValue = 0;
+		mDequeuePos.mValue = 0;
+	}
+
+	~MpmcCircularBuffer()
+	{
+		clear();
+	}
+
+	//! Pushes \a item, waiting for room. Returns \c false without pushing if the buffer is canceled.
+	bool pushFront( const T &item )		{ return pushImpl( item ); }
+	//! Pushes \a item, waiting for room. Returns \c false without pushing if the buffer is canceled.
+	bool pushFront( T &&item )			{ return pushImpl( std::move( item ) ); }
+	//! Pushes every item of [\a first, \a last), waiting for room as necessary. Returns the number of items pushed, which is smaller only if the buffer is canceled.
+	//! Items of one batch may be interleaved with those of other producers.
+	template<typename InputIt>
+	size_type pushFront( InputIt first, InputIt last )
+	{
+		size_type result = 0;
+		while( first != last && ! mCanceled.load() ) {
+			result += tryPushRange( first, last );
+			if( first != last )
+				mNotFull.wait( mSpinCount, mCanceled, [this] { return isNotFull(); } );
+		}
+		return result;
+	}
+
+	//! Pops the oldest item into \a pItem, waiting for one. Returns \c false without popping if the buffer is canceled.
+	bool popBack( T *pItem )
+	{
+		while( ! mCanceled.load() ) {
+			if( tryPopBack( pItem ) )
+				return true;
+			mNotEmpty.wait( mSpinCount, mCanceled, [this] { return isNotEmpty(); } );
+		}
+		return false;
+	}
+
+	//! Pops up to \a maxCount of the oldest items into \a out, waiting until there is at least one. Returns the number of items popped, which is \c 0 only if the buffer is canceled.
+	template<typename OutputIt>
+	size_type popBack( OutputIt out, size_type maxCount )
+	{
+		while( ! mCanceled.load() ) {
+			if( size_type result = tryPopBack( out, maxCount ) )
+				return result;
+			mNotEmpty.wait( mSpinCount, mCanceled, [this] { return isNotEmpty(); } );
+		}
+		return 0;
+	}
+
+	//! Attempts to push \a item to the front of the buffer, but does not wait for room. Returns success as true or false.
+	bool tryPushFront( const T &item )
+	{
+		if( ! tryPushOne( item ) )
+			return false;
+		mNotEmpty.notify();
+		return true;
+	}
+
+	//! Attempts to push \a item to the front of the buffer, but does not wait for room. Returns success as true or false.
+	bool tryPushFront( T &&item )
+	{
+		if( ! tryPushOne( std::move( item ) ) )
+			return false;
+		mNotEmpty.notify();
+		return true;
+	}
+
+	//! Pushes as many items of [\a first, \a last) as there is room for without waiting, returning how many were pushed. Use std::make_move_iterator() to move items in.
+	template<typename InputIt>
+	size_type tryPushFront( InputIt first, InputIt last )	{ return tryPushRange( first, last ); }
+
+	//! Attempts to pop an item from the back of the buffer, but does not wait for one. Returns success as true or false.
+	bool tryPopBack( T *pItem )			{ return tryPopBack( pItem, 1 ) == 1; }
+	//! Pops up to \a maxCount of the oldest items into \a out without waiting, returning how many were popped. Other consumers may pop items in between.
+	template<typename OutputIt>
+	size_type tryPopBack( OutputIt out, size_type maxCount )
+	{
+		size_type count = 0;
+		while( count < maxCount && tryPopWith( [&out]( T &item ) { *out = std::move( item ); ++out; } ) )
+			++count;
+		if( count )
+			mNotFull.notify();
+		return count;
+	}
+
+	bool isNotEmpty() const
+	{
+		const size_type pos = mDequeuePos.mValue.load();
+		return mCells[pos & mMask].mSequence.load() == pos + 1;
+	}
+
+	bool isNotFull() const
+	{
+		const size_type pos = mEnqueuePos.mValue.load();
+		return mCells[pos & mMask].mSequence.load() == pos && hasRoomAt( pos );
+	}
+
+	//! Makes blocking calls return \c false rather than wait, including those already waiting.
+	void cancel()
+	{
+		mCanceled.store( true );
+		mNotFull.wakeAll();
+		mNotEmpty.wakeAll();
+	}
+
+	void uncancel()				{ mCanceled.store( false ); }
+
+	//! Pops and destroys every item in the buffer.
+	void clear()
+	{
+		bool popped = false;
+		while( tryPopWith( []( T & ) {} ) )
+			popped = true;
+		if( popped )
+			mNotFull.notify();
+	}
+
+	//! Returns the number of items the buffer can hold
+	size_t getCapacity() const	{ return mCapacity; }
+	//! Returns the number of items the buffer is currently holding, which may be out of date by the time it returns
+	size_t getSize() const
+	{
+		const size_type dequeuePos = mDequeuePos.mValue.load();
+		const size_type enqueuePos = mEnqueuePos.mValue.load();
+		return enqueuePos > dequeuePos ? std::min<size_type>( enqueuePos - dequeuePos, mCapacity ) : 0;
+	}
+
+  private:
+	struct Cell {
+		T* item()	{ return std::launder( reinterpret_cast<T*>( mStorage ) ); }
+
+		std::atomic<size_type>		mSequence;
+		alignas( T ) unsigned char	mStorage[sizeof( T )];
+	};
+
+	// A single cell couldn't tell an item written at one position from a free cell at the next, so a capacity of 1 gets two cells. Those, and the cells that rounding
+	// up to a power of two adds, are kept free by limiting the positions to the capacity instead.
+	bool hasRoomAt( size_type enqueuePos ) const
+	{
+		return mCapacity == mNumCells || std::ptrdiff_t( enqueuePos - mDequeuePos.mValue.load() ) < std::ptrdiff_t( mCapacity );
+	}
+
+	// Claims the slot at the enqueue position and constructs \a value in it, without notifying consumers
+	template<typename U>
+	bool tryPushOne( U &&value )
+	{
+		size_type pos = mEnqueuePos.mValue.load( std::memory_order_relaxed );
+		while( true ) {
+			Cell &cell = mCells[pos & mMask];
+			const size_type seq = cell.mSequence.load( std::memory_order_acquire );
+			const std::ptrdiff_t diff = std::ptrdiff_t( seq - pos );
+			if( diff == 0 ) {
+				if( ! hasRoomAt( pos ) )
+					return false; // full
+				if( mEnqueuePos.mValue.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+					new( cell.mStorage ) T( std::forward<U>( value ) );
+					cell.mSequence.store( pos + 1, std::memory_order_release );
+					return true;
+				}
+			}
+			else if( diff < 0 )
+				return false; // full
+			else
+				pos = mEnqueuePos.mValue.load( std::memory_order_relaxed );
+		}
+	}
+
+	// Claims the slot at the dequeue position and hands its item to \a consumeFn before destroying it, without notifying producers
+	template<typename ConsumeFn>
+	bool tryPopWith( ConsumeFn consumeFn )
+	{
+		size_type pos = mDequeuePos.mValue.load( std::memory_order_relaxed );
+		while( true ) {
+			Cell &cell = mCells[pos & mMask];
+			const size_type seq = cell.mSequence.load( std::memory_order_acquire );
+			const std::ptrdiff_t diff = std::ptrdiff_t( seq - ( pos + 1 ) );
+			if( diff == 0 ) {
+				if( mDequeuePos.mValue.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+					T *item = cell.item();
+					consumeFn( *item );
+					item->~T();
+					cell.mSequence.store( pos + mNumCells, std::memory_order_release );
+					return true;
+				}
+			}
+			else if( diff < 0 )
+				return false; // empty
+			else
+				pos = mDequeuePos.mValue.load( std::memory_order_relaxed );
+		}
+	}
+
+	template<typename U>
+	bool pushImpl( U &&value )
+	{
+		while( ! mCanceled.load() ) {
+			// only moves from value once it succeeds
+			if( tryPushOne( std::forward<U>( value ) ) ) {
+				mNotEmpty.notify();
+				return true;
+			}
+			mNotFull.wait( mSpinCount, mCanceled, [this] { return isNotFull(); } );
+		}
+		return false;
+	}
+
+	// Pushes items from \a first, advancing it past those that fit, and notifies consumers once for all of them
+	template<typename InputIt>
+	size_type tryPushRange( InputIt &first, InputIt last )
+	{
+		size_type count = 0;
+		for( ; first != last && tryPushOne( *first ); ++first )
+			++count;
+		if( count )
+			mNotEmpty.notify();
+		return count;
+	}
+
+	// the two positions are contended by producers and consumers respectively, and kept on separate cache lines
+	struct alignas( 64 ) Position {
+		std::atomic<size_type>	mValue;
+	};
+
+	Position					mEnqueuePos, mDequeuePos;
+	const size_type				mCapacity, mNumCells, mMask;
+	std::unique_ptr<Cell[]>		mCells;
+	const uint32_t				mSpinCount;
+	std::atomic<bool>			mCanceled;
+	detail::ParkingSpot			mNotEmpty, mNotFull;
+};
+
 } // namespace cinder
\ No newline at end of file
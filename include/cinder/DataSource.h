@@ -67,19 +67,31 @@ typedef std::shared_ptr<class DataSourcePath>	DataSourcePathRef;
 
 class CI_API DataSourcePath : public DataSource {
   public:
-	static DataSourcePathRef	create( const fs::path &path );
+	//! Creates a DataSource for the file at \a path. If \a memoryMapped (the default) files of at least MIN_MAPPED_FILE_SIZE bytes are mapped into memory: getBuffer() returns a Buffer viewing the mapping rather than a copy of the file, and createStream() returns an IStreamMapped. Falls back to reading the file if it can't be mapped.
+	//! \note The file must not be truncated while the DataSource, its Buffer or its streams are alive, and on Windows it can't be overwritten until then.
+	//! A mapping covers the file as it was when first mapped, so data appended later is not seen, and its stream reports the end at the old size. Pass \c false for files that grow while they're read, such as logs.
+	static DataSourcePathRef	create( const fs::path &path, bool memoryMapped = true );
 
 	virtual bool	isFilePath() { return true; }
 	virtual bool	isUrl() { return false; }
 
 	virtual IStreamRef	createStream();
 
+	//! Files smaller than this many bytes are read rather than memory mapped
+	static const size_t	MIN_MAPPED_FILE_SIZE = 64 * 1024;
+
+	//! Returns whether the file is read through a MappedFile. Becomes \c false once the file turns out to be too small or mapping it fails.
+	bool			isMemoryMapped() const { return mMemoryMapped; }
+
   protected:
-	explicit DataSourcePath( const fs::path &path );
+	DataSourcePath( const fs::path &path, bool memoryMapped );
 	
 	virtual	void	createBuffer();
+	//! Returns the MappedFile, mapping it on first use, or \c nullptr if the file isn't memory mapped
+	MappedFileRef	getMappedFile();
 	
-	IStreamFileRef	mStream;	
+	bool			mMemoryMapped;
+	MappedFileRef	mMappedFile;
 };
 
 
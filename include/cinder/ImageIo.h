@@ -34,6 +34,7 @@
 #include <vector>
 #include <map>
 #include <utility>
+#include <functional>
 
 namespace cinder {
 
@@ -85,27 +86,37 @@ class CI_API ImageIo {
 
 class CI_API ImageSource : public ImageIo {
   public:
-	ImageSource() : ImageIo(), mIsPremultiplied( false ), mPixelAspectRatio( 1 ), mCustomPixelInc( 0 ), mFrameCount( 1 ) {}
+	ImageSource() : ImageIo(), mIsPremultiplied( false ), mPixelAspectRatio( 1 ), mCustomPixelInc( 0 ), mFrameCount( 1 ), mReductionFactor( 1 ), mFullWidth( 0 ), mFullHeight( 0 ) {}
 	virtual ~ImageSource() {}  
 
 	//! Optional parameters passed when creating an Image. \see loadImage()
 	class Options {
 	  public:
-		Options() : mIndex( 0 ), mThrowOnFirstException( false ) {}
+		Options() : mIndex( 0 ), mThrowOnFirstException( false ), mReductionFactor( 1 ), mMaxSize( 0 ) {}
 
 		//! Specifies an image index for multi-part images, like animated GIFs. 0-based index.
 		Options& index( int32_t index )						{ mIndex = index; return *this; }
 		//! If an exception occurs, enabling this will prevent any attempts at using other handlers to load the image. Default = false, all handlers are tried and if none succeed, the last exception is rethrown. \see ImageIoException
 		Options& throwOnFirstException( bool b = true )		{ mThrowOnFirstException = b; return *this; }
+		//! Requests that the image is box-filtered down by \a factor, rounded down to a power of two and capped where the longer side becomes a single pixel, while it is decoded. Honored by the PNG, QOI, EXR, Radiance and stb_image decoders; others ignore it. \see ImageSource::getReductionFactor()
+		Options& reductionFactor( int32_t factor )			{ mReductionFactor = factor; return *this; }
+		//! Requests the largest power-of-two reduction which keeps the longer side of the image at least \a maxSize pixels, for example to decode thumbnails. \c 0 (the default) decodes at full resolution. \see reductionFactor()
+		Options& maxSize( int32_t maxSize )					{ mMaxSize = maxSize; return *this; }
 
 		//! Returns image index. \see index()
 		int32_t				getIndex() const				{ return mIndex; }
 		//! Returns whether throwOnFirstException() is enabled or not.
 		bool				getThrowOnFirstException()		{ return mThrowOnFirstException; }
+		//! Returns the requested reduction factor. \see reductionFactor()
+		int32_t				getReductionFactor() const		{ return mReductionFactor; }
+		//! Returns the requested minimum size of the longer side of a reduced image, or \c 0. \see maxSize()
+		int32_t				getMaxSize() const				{ return mMaxSize; }
 		
 	  protected:
 		int32_t			mIndex;
 		bool			mThrowOnFirstException;
+		int32_t			mReductionFactor;
+		int32_t			mMaxSize;
 	};
 
 	//! Returns the aspect ratio of individual pixels to accommodate non-square pixels
@@ -116,6 +127,8 @@ class CI_API ImageSource : public ImageIo {
 	size_t		getRowBytes() const;	
 	//! Returns the number of images. Generally \c 1 but may not be in the case of animated GIFs. \see Options::index()
 	int32_t		getCount() const { return mFrameCount; }
+	//! Returns the factor by which the decoder reduced the image, which is \c 1 unless the ImageSource::Options requested a reduction and the decoder supports it. getWidth() and getHeight() return the reduced size.
+	int32_t		getReductionFactor() const { return mReductionFactor; }
 
 	virtual void	load( ImageTargetRef target ) = 0;
 
@@ -127,6 +140,12 @@ class CI_API ImageSource : public ImageIo {
 	//! Allows declaration of a pixel increment different from what its ColorModel would imply. For example a non-planar Channel.
 	void		setCustomPixelInc( int8_t customPixelInc ) { mCustomPixelInc = customPixelInc; }
 	void		setFrameCount( int32_t frameCount ) { mFrameCount = frameCount; }
+	//! Sets the size to \a fullWidth x \a fullHeight reduced by the factor \a options select. Decoders calling this must iterate over mFullWidth x mFullHeight pixels and deliver their rows through processRow().
+	void		setSizeReduced( int32_t fullWidth, int32_t fullHeight, const Options &options );
+	//! Delivers the full resolution row \a row to \a target through \a rowFunc, box-filtering the rows into reduced ones when the ImageSource is reduced. Rows must arrive in increasing order.
+	void		processRow( RowFunc rowFunc, ImageTargetRef target, int32_t row, const void *data );
+	template<typename T>
+	void		processRowReduced( RowFunc rowFunc, ImageTargetRef target, int32_t row, const void *data );
 
 	RowFunc		setupRowFunc( ImageTargetRef target );
 	void		setupRowFuncRgbSource( ImageTargetRef target );
@@ -137,11 +156,20 @@ class CI_API ImageSource : public ImageIo {
 	RowFunc		setupRowFuncForTypes( ImageTargetRef target );
 	template<typename SD>
 	RowFunc		setupRowFuncForSourceType( ImageTargetRef target );
+	//! Returns a specialized RowFunc for copies, 8-bit swizzles and 8-bit <-> float conversions into an RGB target, or \c nullptr when the generic one is needed
+	template<typename SD, typename TD>
+	RowFunc		setupRowFuncFastPath();
 
 	template<typename SD, typename TD, ImageIo::ColorModel TCM, bool ALPHA>
 	void		rowFuncSourceRgb( ImageTargetRef target, int32_t row, const void *data );
 	template<typename SD, typename TD, ColorModel TCM, bool ALPHA>
 	void		rowFuncSourceGray( ImageTargetRef target, int32_t row, const void *data );
+	template<typename T>
+	void		rowFuncCopy( ImageTargetRef target, int32_t row, const void *data );
+	template<int SOURCE_INC, int TARGET_INC>
+	void		rowFuncSwizzle8u( ImageTargetRef target, int32_t row, const void *data );
+	void		rowFunc8uTo32f( ImageTargetRef target, int32_t row, const void *data );
+	void		rowFunc32fTo8u( ImageTargetRef target, int32_t row, const void *data );
 
 	float						mPixelAspectRatio;
 	bool						mIsPremultiplied;
@@ -152,6 +180,13 @@ class CI_API ImageSource : public ImageIo {
 	int8_t						mRowFuncTargetRed, mRowFuncTargetGreen, mRowFuncTargetBlue, mRowFuncTargetAlpha;
 	int8_t						mRowFuncSourceGray, mRowFuncTargetGray;
 	int8_t						mRowFuncSourceInc, mRowFuncTargetInc;
+	//! Source channel of each target channel for rowFuncSwizzle8u(), where -1 means the channel is set to 255
+	int8_t						mRowFuncSwizzle[4];
+
+	int32_t						mReductionFactor;
+	//! Size of the image before reduction, as set by setSizeReduced()
+	int32_t						mFullWidth, mFullHeight;
+	std::vector<uint8_t>		mReductionSums, mReductionRow;
 };
 
 class CI_API ImageTarget : public ImageIo {
@@ -161,6 +196,8 @@ class CI_API ImageTarget : public ImageIo {
 	virtual void*	getRowPointer( int32_t row ) = 0;
 	virtual void	setRow( int32_t /*row*/, const void * /*data*/ ) { throw; }
 	virtual void	finalize() { }
+	//! Returns whether the target only keeps a band of rows at a time, which asks sources that can to decode incrementally rather than the whole image up front
+	virtual bool	isBanded() const { return false; }
 	
 	class Options {
 	  public:
@@ -185,6 +222,41 @@ class CI_API ImageTarget : public ImageIo {
 	ImageTarget() {}
 };
 
+//! ImageTarget which hands the rows of an ImageSource to a callback in bands of at most \a bandHeight rows, so that only a single band of decoded pixels is resident at a time. Expects rows in increasing order, as all of Cinder's ImageSources deliver them.
+template<typename T>
+class CI_API ImageTargetBandsT : public ImageTarget {
+  public:
+	//! Receives each band in order, where \a firstRow is the band's first row in the source image. \a band aliases the target's storage and is only valid for the duration of the call.
+	typedef std::function<void( const SurfaceT<T> &band, int32_t firstRow )>	BandFn;
+
+	//! Creates a target delivering \a imageSource to \a bandFn in bands of \a bandHeight rows, with an alpha channel if \a imageSource has one.
+	static std::shared_ptr<ImageTargetBandsT<T>>	create( const ImageSourceRef &imageSource, int32_t bandHeight, const BandFn &bandFn );
+	//! Creates a target delivering \a imageSource to \a bandFn in bands of \a bandHeight rows, with an alpha channel if \a alpha.
+	static std::shared_ptr<ImageTargetBandsT<T>>	create( const ImageSourceRef &imageSource, int32_t bandHeight, const BandFn &bandFn, bool alpha );
+
+	bool	hasAlpha() const override { return mBand.hasAlpha(); }
+	void*	getRowPointer( int32_t row ) override;
+	//! Delivers the last, possibly partial, band. Called by writeImage() once the source has finished loading.
+	void	finalize() override;
+	bool	isBanded() const override { return true; }
+
+	//! Returns the maximum number of rows in a band
+	int32_t		getBandHeight() const { return mBand.getHeight(); }
+
+  protected:
+	ImageTargetBandsT( const ImageSourceRef &imageSource, int32_t bandHeight, const BandFn &bandFn, bool alpha );
+
+	void	flushBand();
+
+	SurfaceT<T>		mBand;
+	BandFn			mBandFn;
+	int32_t			mBandStart, mBandRows;
+};
+
+typedef ImageTargetBandsT<uint8_t>	ImageTargetBands8u;
+typedef ImageTargetBandsT<uint16_t>	ImageTargetBands16u;
+typedef ImageTargetBandsT<float>	ImageTargetBands32f;
+
 
 //! Loads an image from the file path \a path. Optional \a extension parameter allows specification of a file type. For example, "jpg" would force the file to load as a JPEG
 CI_API ImageSourceRef	loadImage( const fs::path &path, ImageSource::Options options = ImageSource::Options(), std::string extension = "" );
@@ -197,6 +269,9 @@ CI_API void				writeImage( DataTargetRef dataTarget, const ImageSourceRef &image
 CI_API void				writeImage( const fs::path &path, const ImageSourceRef &imageSource, ImageTarget::Options options = ImageTarget::Options(), std::string extension = "" );
 /** \brief Writes \a imageSource to \a imageTarget. **/
 CI_API void				writeImage( ImageTargetRef imageTarget, const ImageSourceRef &imageSource );
+//! Loads \a imageSource in bands of at most \a bandHeight rows, calling \a bandFn for each band in order. Decoders which support it never hold more than a band's worth of pixels. \see ImageTargetBandsT
+template<typename T>
+CI_API void				loadImageBands( const ImageSourceRef &imageSource, int32_t bandHeight, const typename ImageTargetBandsT<T>::BandFn &bandFn );
 
 class CI_API ImageIoException : public Exception {
   public:
@@ -33,8 +33,6 @@ typedef std::shared_ptr<class ImageSourceFileQoi>	ImageSourceFileQoiRef;
 
 class ImageSourceFileQoi : public ImageSource {
   public:
-	~ImageSourceFileQoi();
-
 	static ImageSourceRef	create( DataSourceRef dataSourceRef, ImageSource::Options options ) { return ImageSourceFileQoiRef( new ImageSourceFileQoi( dataSourceRef, options ) ); }
 
 	static void		registerSelf();
@@ -44,8 +42,8 @@ class ImageSourceFileQoi : public ImageSource {
   protected:
 	ImageSourceFileQoi( DataSourceRef dataSourceRef, ImageSource::Options options );
 
-	uint8_t		*mData;
-	size_t		mRowBytes;
+	IStreamRef	mStream;
+	int			mChannels;
 };
 
 } // namespace cinder
@@ -44,9 +44,10 @@ class ImageSourceFileRadiance : public ImageSource {
   protected:
 	ImageSourceFileRadiance( DataSourceRef dataSourceRef, ImageSource::Options options );
 	
-	void	loadStream( IStreamRef stream );
+	void	loadHeader( const ImageSource::Options &options );
 	
-	std::unique_ptr<float[]>		mRgbData;
+	IStreamRef		mStream;
+	off_t			mDataOffset;
 };
 
 class ImageSourceFileRadianceException : public ImageIoException {
@@ -43,10 +43,25 @@ class ImageSourceFileStbImage : public ImageSource {
 
   protected:
 	ImageSourceFileStbImage( DataSourceRef dataSourceRef, ImageSource::Options options );
-	
+
+	//! Decodes all of \a dataSourceRef through stb_image into mData8u or mData32f
+	void	decode( const DataSourceRef &dataSourceRef, int *width, int *height, int *components );
+	//! Returns whether \a dataSourceRef is a PNG which can be decoded a row at a time, filling in its dimensions if so
+	bool	parsePngHeader( const DataSourceRef &dataSourceRef, int *width, int *height, int *components );
+	//! Decodes the PNG a row at a time, for banded targets
+	void	loadPng( ImageTargetRef target, ImageSource::RowFunc func );
+
+	//! PNGs are only decoded once load() knows whether its target is banded
+	DataSourceRef	mDataSource;
+
 	uint8_t		*mData8u;
 	float		*mData32f;
 	size_t		mRowBytes;
+
+	IStreamRef				mPngStream;
+	off_t					mPngDataOffset;
+	uint8_t					mPngColorType;
+	std::vector<uint8_t>	mPngPalette;
 };
 
 } // namespace cinder
@@ -47,7 +47,7 @@ class ImageSourcePng : public ImageSource {
 
   protected:
 	ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Options options );
-	bool loadHeader();
+	bool loadHeader( const ImageSource::Options &options );
 	
 	std::shared_ptr<ci_png_info>	mCiInfoPtr;
 	png_struct_def					*mPngPtr;
@@ -24,16 +24,18 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Vector.h"
+#include "cinder/Thread.h"
 
 #include <vector>
 #include <float.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <functional>
 #include <utility>
 
 namespace cinder {
 
-// KdTree Declarations
+//! \deprecated The node of the pointer-based tree KdTree used to build. KdTree's nodes are now implicit in its point order, and it no longer uses this.
 template<unsigned char K>
 struct KdNode {
 	void init( float p, uint32_t a) {
@@ -59,35 +61,6 @@ struct NullLookupProc {
 	void process( uint32_t id, float distSqrd, float &maxDistSqrd ) {}
 };
 
-template <typename NodeData, unsigned char K=3, class LookupProc = NullLookupProc> class KdTree {
-public:
-	typedef std::pair<const NodeData*, uint32_t> NodeDataIndex;
-	
-	// KdTree Public Methods
-	template<typename NodeDataVector>
-	KdTree( const NodeDataVector &data );
-	KdTree() {}
-	template<typename NodeDataVector>
-	void initialize( const NodeDataVector &d );
-	~KdTree() {
-		free( nodes );
-		delete[] mNodeData;
-	}
-	void recursiveBuild( uint32_t nodeNum, uint32_t start, uint32_t end, std::vector<NodeDataIndex> &buildNodes );
-	void lookup( const NodeData &p, const LookupProc &process, float maxDist ) const;
-	void findNearest( float p[K], float result[K], uint32_t *resultIndex ) const;
-	
-private:
-	// KdTree Private Methods
-	void privateLookup(uint32_t nodeNum, float p[K], const LookupProc &process, float &maxDistSquared) const;
-	void privateFindNearest( uint32_t nodeNum, float p[K], float &maxDistSquared, float result[K], uint32_t *resultIndex ) const;
-	// KdTree Private Data
-	KdNode<K> *nodes;
-	NodeDataIndex *mNodeData;
-	uint32_t nNodes, nextFreeNode;
-};
-
-
 // Shims
 template<typename NDV>
 struct NodeDataVectorTraits
@@ -132,6 +105,7 @@ struct NodeDataTraits<vec2>
 	}
 };
 
+//! \deprecated The ordering KdTree used to sort its KdTree::NodeDataIndex pairs along an axis. KdTree now partitions its own copies of the points and no longer uses this.
 template<typename NodeData> struct CompareNode {
 	CompareNode( int a ) { axis = a; }
 	int axis;
@@ -142,163 +116,325 @@ template<typename NodeData> struct CompareNode {
 	}
 };
 
-// KdTree Method Definitions
+/*! A K-dimensional tree over points whose coordinates are read through NodeDataTraits<NodeData>.
+	The points are copied into a flat array in tree order, and the tree is implicit in it: the node \a j of level \a L covers the points
+	[j * n / 2^L, (j + 1) * n / 2^L) and splits them at their median along its axis, so that the nodes only store their split positions, level by level.
+	Ranges of at most \a leafSize points are leaves, which are scanned linearly. The nodes of each level are split in parallel on TaskScheduler::global().
+	Queries are const and can run concurrently, and the batched queries run many of them in parallel. */
+template <typename NodeData, unsigned char K=3, class LookupProc = NullLookupProc> class KdTree {
+  public:
+	//! The index that the batched queries report for missing neighbors
+	static constexpr uint32_t	INVALID_INDEX = 0xFFFFFFFF;
+	static constexpr uint32_t	DEFAULT_LEAF_SIZE = 8;
+	//! \deprecated A point and its index, as the tree used to store them. Unused by KdTree, which reports indices on their own.
+	typedef std::pair<const NodeData*, uint32_t> NodeDataIndex;
+
+	KdTree() : mLeafSize( DEFAULT_LEAF_SIZE ) {}
+	//! Builds the tree over \a data, splitting the nodes of a level on up to \a numThreads threads at once, or without a limit for \c 0. Medians are chosen the same way on any number of threads.
+	template<typename NodeDataVector>
+	KdTree( const NodeDataVector &data, uint32_t leafSize = DEFAULT_LEAF_SIZE, int numThreads = 0 );
+	//! Rebuilds the tree over \a data. The points are copied, so \a data doesn't need to outlive the tree.
+	template<typename NodeDataVector>
+	void initialize( const NodeDataVector &data, uint32_t leafSize = DEFAULT_LEAF_SIZE, int numThreads = 0 );
+
+	size_t	size() const { return mPoints.size(); }
+	bool	empty() const { return mPoints.empty(); }
+
+	//! Calls \a process.process( index, distSqrd, maxDistSqrd ) for every point closer than \a maxDist to \a p, nearer points tending to come first. The process can lower \a maxDistSqrd to narrow the search.
+	void	lookup( const NodeData &p, const LookupProc &process, float maxDist ) const;
+	//! Finds the point nearest to \a p, returning its coordinates in \a result and its index in \a resultIndex, which is \c -1 for an empty tree
+	void	findNearest( float p[K], float result[K], uint32_t *resultIndex ) const;
+	//! Finds the up to \a k points nearest to \a p and closer than \a maxDist, returning their number. Fills \a indices, and \a distancesSqrd when given, with them in order of increasing distance.
+	size_t	findNearest( const NodeData &p, size_t k, uint32_t *indices, float *distancesSqrd = nullptr, float maxDist = FLT_MAX ) const;
+	//! Finds the points closer than \a radius to \a p and returns their number. Fills \a indices, and \a distancesSqrd when given, with up to \a maxResults of them, in no particular order.
+	size_t	findInRadius( const NodeData &p, float radius, uint32_t *indices, size_t maxResults, float *distancesSqrd = nullptr ) const;
+	//! Replaces the contents of \a indices with the points closer than \a radius to \a p, in no particular order
+	void	findInRadius( const NodeData &p, float radius, std::vector<uint32_t> *indices ) const;
+
+	/*! Finds the \a k nearest neighbors of each of the \a numPoints \a points in parallel. The neighbors of point \a i fill \a indices[i * k, (i + 1) * k),
+		and \a distancesSqrd when given, as findNearest() does, and missing neighbors are INVALID_INDEX at a distance of \c FLT_MAX. */
+	void	findNearest( const NodeData *points, size_t numPoints, size_t k, uint32_t *indices, float *distancesSqrd = nullptr, float maxDist = FLT_MAX, int numThreads = 0 ) const;
+	/*! Finds the points closer than \a radius to each of the \a numPoints \a points in parallel. Up to \a maxResults of those of point \a i fill \a indices[i * maxResults, (i + 1) * maxResults),
+		and \a distancesSqrd when given, while \a counts[i] receives how many there are in total. */
+	void	findInRadius( const NodeData *points, size_t numPoints, float radius, size_t maxResults, uint32_t *indices, uint32_t *counts, float *distancesSqrd = nullptr, int numThreads = 0 ) const;
+
+  private:
+	struct Point {
+		float		coords[K];
+		uint32_t	index;
+	};
+
+	// A neighbor in the bounded max-heap of findNearest(), ordered by distance and then index so that ties resolve the same way every time
+	struct Neighbor {
+		float		distSqrd;
+		uint32_t	index;
+
+		bool operator<( const Neighbor &rhs ) const { return distSqrd < rhs.distSqrd || ( distSqrd == rhs.distSqrd && index < rhs.index ); }
+	};
+
+	// the first point of node \a j of \a level
+	uint32_t	getRangeBegin( uint32_t level, uint32_t j ) const { return uint32_t( ( uint64_t( j ) * mPoints.size() ) >> level ); }
+	void		toCoords( const NodeData &p, float coords[K] ) const;
+
+	// Calls \a leafFn( begin, end, maxDistSqrd ) for the leaves that may hold points closer than sqrt( \a maxDistSqrd ) to \a p, nearest first
+	template<typename LeafFn>
+	void		search( uint32_t level, uint32_t j, const float p[K], float &maxDistSqrd, LeafFn &leafFn ) const;
+	template<typename LeafFn>
+	void		search( const float p[K], float &maxDistSqrd, LeafFn &leafFn ) const { if( ! mPoints.empty() ) search( 0, 0, p, maxDistSqrd, leafFn ); }
+
+	std::vector<Point>		mPoints;
+	// the split position and axis of each node, level by level
+	std::vector<float>		mSplits;
+	std::vector<uint8_t>	mAxes;
+	uint32_t				mLeafSize;
+};
+
 template<typename NodeData, unsigned char K, typename LookupProc>
  template<typename NodeDataVector>
-KdTree<NodeData, K, LookupProc>::KdTree(const NodeDataVector &d)
+KdTree<NodeData, K, LookupProc>::KdTree( const NodeDataVector &data, uint32_t leafSize, int numThreads )
 {
-	initialize( d );
+	initialize( data, leafSize, numThreads );
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
- template<typename NodeDataVector>
-void KdTree<NodeData, K, LookupProc>::initialize( const NodeDataVector &d )
+void KdTree<NodeData, K, LookupProc>::toCoords( const NodeData &p, float coords[K] ) const
 {
-	nNodes = NodeDataVectorTraits<NodeDataVector>::getSize( d );
-	nextFreeNode = 1;
-	nodes = (KdNode<K> *)malloc(nNodes * sizeof(KdNode<K>));
-	mNodeData = new NodeDataIndex[nNodes];
-	std::vector<NodeDataIndex> buildNodes;
-	buildNodes.reserve( nNodes );
-	for( uint32_t i = 0; i < nNodes; ++i )
-		buildNodes.push_back( std::make_pair( &d[i], i ) );
-	// Begin the KdTree building process
-	recursiveBuild( 0, 0, nNodes, buildNodes );
+	for( unsigned char k = 0; k < K; ++k )
+		coords[k] = NodeDataTraits<NodeData>::getAxis( p, k );
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
-void KdTree<NodeData, K, LookupProc>::recursiveBuild( uint32_t nodeNum, uint32_t start, uint32_t end, std::vector<NodeDataIndex> &buildNodes )
+ template<typename NodeDataVector>
+void KdTree<NodeData, K, LookupProc>::initialize( const NodeDataVector &data, uint32_t leafSize, int numThreads )
 {
-	// Create leaf node of kd-tree if we've reached the bottom
-	if( start + 1 == end) {
-		nodes[nodeNum].initLeaf();
-		mNodeData[nodeNum] = buildNodes[start];
-		return;
+	const uint32_t numPoints = NodeDataVectorTraits<NodeDataVector>::getSize( data );
+	mLeafSize = std::max<uint32_t>( 1, leafSize );
+	mPoints.resize( numPoints );
+	for( uint32_t i = 0; i < numPoints; ++i ) {
+		toCoords( data[i], mPoints[i].coords );
+		mPoints[i].index = i;
 	}
-	// Choose split direction and partition data
-	// Compute bounds of data from _start_ to _end_
-	float boundMin[K], boundMax[K];
-	for( unsigned char k = 0; k < K; ++k ) {
-		boundMin[k] = FLT_MAX;
-		boundMax[k] = FLT_MIN;
-	}
-	
-	for( uint32_t i = start; i < end; ++i ) {
-		for( uint8_t axis = 0; axis < K; axis++ ) {
-			// NOT Compiling? you should define NOMINMAX
-			boundMin[axis] = std::min( boundMin[axis], NodeDataTraits<NodeData>::getAxis( *buildNodes[i].first, axis ) );
-			boundMax[axis] = std::max( boundMax[axis], NodeDataTraits<NodeData>::getAxis( *buildNodes[i].first, axis ) );
-		}
-	}
-	int splitAxis = 0;
-	float maxExtent = boundMax[0] - boundMin[0];
-	for( unsigned char k = 1; k < K; ++k ) {
-		if( boundMax[k] - boundMin[k] > maxExtent ) {
-			splitAxis = k;
-			maxExtent = boundMax[k] - boundMin[k];
-		}	
-	}
-	uint32_t splitPos = ( start + end ) / 2;
-	std::nth_element( &buildNodes[start], &buildNodes[splitPos], &buildNodes[end-1] + 1, CompareNode<NodeData>(splitAxis) );
-	// Allocate kd-tree node and continue recursively
-	nodes[nodeNum].init( NodeDataTraits<NodeData>::getAxis( *buildNodes[splitPos].first, splitAxis ), splitAxis );
-	mNodeData[nodeNum] = buildNodes[splitPos];
-	if( start < splitPos ) {
-		nodes[nodeNum].hasLeftChild = 1;
-		uint32_t childNum = nextFreeNode++;
-		recursiveBuild( childNum, start, splitPos, buildNodes );
-	}
-	if( splitPos + 1 < end ) {
-		nodes[nodeNum].rightChild = nextFreeNode++;
-		recursiveBuild( nodes[nodeNum].rightChild, splitPos + 1, end, buildNodes );
+
+	// the levels that hold internal nodes, which split ranges of more than mLeafSize points
+	uint32_t numLevels = 0;
+	while( ( ( uint64_t( numPoints ) + ( 1ull << numLevels ) - 1 ) >> numLevels ) > mLeafSize )
+		++numLevels;
+	mSplits.assign( ( size_t( 1 ) << numLevels ) - 1, 0.0f );
+	mAxes.assign( mSplits.size(), 0 );
+
+	for( uint32_t level = 0; level < numLevels; ++level ) {
+		const uint32_t numNodes = 1u << level;
+		// a node's points are spread over fewer bands in the first levels, so a level runs as a band per node, while later ones group the nodes
+		TaskScheduler::global()->parallelFor( 0, numNodes, [&]( size_t firstNode, size_t lastNode ) {
+			for( uint32_t j = uint32_t( firstNode ); j < lastNode; ++j ) {
+				const uint32_t begin = getRangeBegin( level, j ), end = getRangeBegin( level, j + 1 );
+				if( end - begin <= mLeafSize )
+					continue;
+
+				// split the longest side of the points' bounds at their median
+				float boundMin[K], boundMax[K];
+				std::fill( boundMin, boundMin + K, FLT_MAX );
+				std::fill( boundMax, boundMax + K, -FLT_MAX );
+				for( uint32_t i = begin; i < end; ++i ) {
+					for( unsigned char k = 0; k < K; ++k ) {
+						boundMin[k] = std::min( boundMin[k], mPoints[i].coords[k] );
+						boundMax[k] = std::max( boundMax[k], mPoints[i].coords[k] );
+					}
+				}
+				unsigned char axis = 0;
+				for( unsigned char k = 1; k < K; ++k ) {
+					if( boundMax[k] - boundMin[k] > boundMax[axis] - boundMin[axis] )
+						axis = k;
+				}
+
+				const uint32_t mid = getRangeBegin( level + 1, 2 * j + 1 );
+				std::nth_element( mPoints.begin() + begin, mPoints.begin() + mid, mPoints.begin() + end, [axis]( const Point &a, const Point &b ) {
+					return a.coords[axis] < b.coords[axis] || ( a.coords[axis] == b.coords[axis] && a.index < b.index );
+				} );
+				const size_t node = numNodes - 1 + j;
+				mSplits[node] = mPoints[mid].coords[axis];
+				mAxes[node] = axis;
+			}
+		}, 0, numThreads );
 	}
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
-void KdTree<NodeData, K, LookupProc>::lookup( const NodeData &p, const LookupProc &proc, float maxDist ) const 
+ template<typename LeafFn>
+void KdTree<NodeData, K, LookupProc>::search( uint32_t level, uint32_t j, const float p[K], float &maxDistSqrd, LeafFn &leafFn ) const
 {
-	float maxDistSqrd = maxDist * maxDist;
-	float pt[K];
-	for( unsigned char k = 0; k < K; ++k )
-		pt[k] = NodeDataTraits<NodeData>::getAxis( p, k );
+	const uint32_t begin = getRangeBegin( level, j ), end = getRangeBegin( level, j + 1 );
+	if( end - begin <= mLeafSize ) {
+		leafFn( begin, end, maxDistSqrd );
+		return;
+	}
 
-	privateLookup( 0, pt, proc, maxDistSqrd );
+	// the points left of the split are at or below it, and those right of it at or above it
+	const size_t node = ( size_t( 1 ) << level ) - 1 + j;
+	const float d = p[mAxes[node]] - mSplits[node];
+	const uint32_t nearChild = d < 0 ? 2 * j : 2 * j + 1;
+	search( level + 1, nearChild, p, maxDistSqrd, leafFn );
+	if( d * d < maxDistSqrd )
+		search( level + 1, nearChild ^ 1, p, maxDistSqrd, leafFn );
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
-void KdTree<NodeData, K, LookupProc>::privateLookup( uint32_t nodeNum, float p[K], const LookupProc &process, float &maxDistSquared ) const 
+void KdTree<NodeData, K, LookupProc>::lookup( const NodeData &p, const LookupProc &process, float maxDist ) const
 {
-	KdNode<K> *node = &nodes[nodeNum];
-	// process kd-tree node's children
-	int axis = node->splitAxis;
-	if( axis != K ) {
-		float dist2 = ( p[axis] - node->splitPos ) * ( p[axis] - node->splitPos );
-		if( p[axis] <= node->splitPos ) {
-			if(node->hasLeftChild)
-				privateLookup( nodeNum + 1, p, process, maxDistSquared );
-			if( ( dist2 < maxDistSquared ) && ( node->rightChild < nNodes ) )
-				privateLookup( node->rightChild, p, process, maxDistSquared );
-		}
-		else {
-			if( node->rightChild < nNodes )
-				privateLookup( node->rightChild, p, process, maxDistSquared );
-			if( ( dist2 < maxDistSquared ) && node->hasLeftChild )
-				privateLookup( nodeNum + 1, p, process, maxDistSquared );
+	float pt[K];
+	toCoords( p, pt );
+	float maxDistSqrd = maxDist * maxDist;
+	auto leafFn = [&]( uint32_t begin, uint32_t end, float &maxDistSqrd ) {
+		for( uint32_t i = begin; i < end; ++i ) {
+			float distSqrd = 0;
+			for( unsigned char k = 0; k < K; ++k )
+				distSqrd += ( mPoints[i].coords[k] - pt[k] ) * ( mPoints[i].coords[k] - pt[k] );
+			if( distSqrd < maxDistSqrd )
+				process.process( mPoints[i].index, distSqrd, maxDistSqrd );
 		}
-	}
-	// Hand kd-tree node to processing function
-	float distSqr = 0.0f;
-	for( unsigned char k = 0; k < K; ++k ) {
-		float v = NodeDataTraits<NodeData>::getAxis( *mNodeData[nodeNum].first, k ) - p[k];
-		distSqr += v * v;
-	}
-	
-	if( distSqr < maxDistSquared )
-		process.process( mNodeData[nodeNum].second, distSqr, maxDistSquared );
+	};
+	search( pt, maxDistSqrd, leafFn );
 }
 
-// Find Nearest
 template<typename NodeData, unsigned char K, typename LookupProc>
 void KdTree<NodeData, K, LookupProc>::findNearest( float p[K], float result[K], uint32_t *resultIndex ) const
 {
-	float maxDist = FLT_MAX;
 	*resultIndex = -1;
-	privateFindNearest( 0, p, maxDist, result, resultIndex );
+	float maxDistSqrd = FLT_MAX;
+	const Point *nearest = nullptr;
+	auto leafFn = [&]( uint32_t begin, uint32_t end, float &maxDistSqrd ) {
+		for( uint32_t i = begin; i < end; ++i ) {
+			float distSqrd = 0;
+			for( unsigned char k = 0; k < K; ++k )
+				distSqrd += ( mPoints[i].coords[k] - p[k] ) * ( mPoints[i].coords[k] - p[k] );
+			if( distSqrd < maxDistSqrd || ( distSqrd == maxDistSqrd && nearest && mPoints[i].index < nearest->index ) ) {
+				maxDistSqrd = distSqrd;
+				nearest = &mPoints[i];
+			}
+		}
+	};
+	search( p, maxDistSqrd, leafFn );
+
+	if( nearest ) {
+		std::copy( nearest->coords, nearest->coords + K, result );
+		*resultIndex = nearest->index;
+	}
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
-void KdTree<NodeData, K, LookupProc>::privateFindNearest( uint32_t nodeNum, float p[K], float &maxDistSquared, float result[K], uint32_t *resultIndex ) const
+size_t KdTree<NodeData, K, LookupProc>::findNearest( const NodeData &p, size_t k, uint32_t *indices, float *distancesSqrd, float maxDist ) const
 {
-	KdNode<K> *node = &nodes[nodeNum];
-	// process kd-tree node's children
-	int axis = node->splitAxis;
-	if( axis != K ) {
-		float dist2 = (p[axis] - node->splitPos) * (p[axis] - node->splitPos);
-		if( p[axis] <= node->splitPos ) {
-			if( node->hasLeftChild )
-				privateFindNearest( nodeNum+1, p, maxDistSquared, result, resultIndex );
-			if( ( dist2 < maxDistSquared ) && ( node->rightChild < nNodes) )
-				privateFindNearest( node->rightChild, p, maxDistSquared, result, resultIndex );
-		}
-		else {
-			if( node->rightChild < nNodes)
-				privateFindNearest(node->rightChild,
-				              p,
-							  maxDistSquared, result, resultIndex );
-			if( dist2 < maxDistSquared && node->hasLeftChild)
-				privateFindNearest(nodeNum+1,
-				              p,
-							  maxDistSquared, result, resultIndex );
+	if( k == 0 )
+		return 0;
+
+	float pt[K];
+	toCoords( p, pt );
+
+	// the heap lives on the stack for the common small k
+	const size_t STACK_NEIGHBORS = 64;
+	Neighbor stackHeap[STACK_NEIGHBORS];
+	std::vector<Neighbor> vectorHeap;
+	if( k > STACK_NEIGHBORS )
+		vectorHeap.resize( k );
+	Neighbor *heap = k > STACK_NEIGHBORS ? vectorHeap.data() : stackHeap;
+	size_t heapSize = 0;
+
+	// a full heap only takes points nearer than its farthest, which bounds the search
+	float maxDistSqrd = maxDist < FLT_MAX ? maxDist * maxDist : FLT_MAX;
+	auto leafFn = [&]( uint32_t begin, uint32_t end, float &maxDistSqrd ) {
+		for( uint32_t i = begin; i < end; ++i ) {
+			float distSqrd = 0;
+			for( unsigned char c = 0; c < K; ++c )
+				distSqrd += ( mPoints[i].coords[c] - pt[c] ) * ( mPoints[i].coords[c] - pt[c] );
+			const Neighbor neighbor = { distSqrd, mPoints[i].index };
+			if( heapSize < k ) {
+				if( distSqrd >= maxDistSqrd )
+					continue;
+				heap[heapSize++] = neighbor;
+				std::push_heap( heap, heap + heapSize );
+			}
+			else if( neighbor < heap[0] ) {
+				std::pop_heap( heap, heap + heapSize );
+				heap[heapSize - 1] = neighbor;
+				std::push_heap( heap, heap + heapSize );
+			}
+			else
+				continue;
+			if( heapSize == k )
+				maxDistSqrd = std::nextafter( heap[0].distSqrd, FLT_MAX );
 		}
+	};
+	search( pt, maxDistSqrd, leafFn );
+
+	std::sort_heap( heap, heap + heapSize );
+	for( size_t i = 0; i < heapSize; ++i ) {
+		indices[i] = heap[i].index;
+		if( distancesSqrd )
+			distancesSqrd[i] = heap[i].distSqrd;
 	}
-	
-	float distSqr = NodeDataTraits<NodeData>::distanceSquared( *mNodeData[nodeNum].first, p );
-	if( distSqr < maxDistSquared ) {
-		maxDistSquared = distSqr;
-		for( unsigned char k = 0; k < K; ++k )
-			result[k] = NodeDataTraits<NodeData>::getAxis( *mNodeData[nodeNum].first, k );
-		*resultIndex = mNodeData[nodeNum].second;
+
+	return heapSize;
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+size_t KdTree<NodeData, K, LookupProc>::findInRadius( const NodeData &p, float radius, uint32_t *indices, size_t maxResults, float *distancesSqrd ) const
+{
+	float pt[K];
+	toCoords( p, pt );
+	size_t result = 0;
+	float maxDistSqrd = radius * radius;
+	auto leafFn = [&]( uint32_t begin, uint32_t end, float &maxDistSqrd ) {
+		for( uint32_t i = begin; i < end; ++i ) {
+			float distSqrd = 0;
+			for( unsigned char k = 0; k < K; ++k )
+				distSqrd += ( mPoints[i].coords[k] - pt[k] ) * ( mPoints[i].coords[k] - pt[k] );
+			if( distSqrd >= maxDistSqrd )
+				continue;
+			if( result < maxResults ) {
+				indices[result] = mPoints[i].index;
+				if( distancesSqrd )
+					distancesSqrd[result] = distSqrd;
+			}
+			++result;
+		}
+	};
+	search( pt, maxDistSqrd, leafFn );
+
+	return result;
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+void KdTree<NodeData, K, LookupProc>::findInRadius( const NodeData &p, float radius, std::vector<uint32_t> *indices ) const
+{
+	indices->resize( indices->capacity() );
+	size_t count = findInRadius( p, radius, indices->data(), indices->size() );
+	if( count > indices->size() ) {
+		indices->resize( count );
+		count = findInRadius( p, radius, indices->data(), indices->size() );
 	}
+	indices->resize( count );
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+void KdTree<NodeData, K, LookupProc>::findNearest( const NodeData *points, size_t numPoints, size_t k, uint32_t *indices, float *distancesSqrd, float maxDist, int numThreads ) const
+{
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i ) {
+			const size_t found = findNearest( points[i], k, indices + i * k, distancesSqrd ? distancesSqrd + i * k : nullptr, maxDist );
+			std::fill( indices + i * k + found, indices + ( i + 1 ) * k, INVALID_INDEX );
+			if( distancesSqrd )
+				std::fill( distancesSqrd + i * k + found, distancesSqrd + ( i + 1 ) * k, FLT_MAX );
+		}
+	}, 0, numThreads );
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+void KdTree<NodeData, K, LookupProc>::findInRadius( const NodeData *points, size_t numPoints, float radius, size_t maxResults, uint32_t *indices, uint32_t *counts, float *distancesSqrd, int numThreads ) const
+{
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			counts[i] = uint32_t( findInRadius( points[i], radius, indices + i * maxResults, maxResults, distancesSqrd ? distancesSqrd + i * maxResults : nullptr ) );
+	}, 0, numThreads );
 }
 
 } // namespace ci
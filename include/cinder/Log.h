@@ -35,6 +35,8 @@
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <functional>
 
 // CI_MIN_LOG_LEVEL is designed so that if you set it to 7 : nothing logs, 6 : only fatal, 5 : fatal + error, ..., 1 : everything
@@ -61,8 +63,8 @@ enum Level {
 struct CI_API Location {
 	Location() {}
 
-	Location( const std::string &functionName, const std::string &fileName, const size_t &lineNumber )
-		: mFunctionName( functionName ), mFileName( fileName ), mLineNumber( lineNumber )
+	Location( std::string functionName, std::string fileName, const size_t &lineNumber )
+		: mFunctionName( std::move( functionName ) ), mFileName( std::move( fileName ) ), mLineNumber( lineNumber )
 	{}
 
 	const std::string&	getFileName() const				{ return mFileName; }
@@ -80,6 +82,8 @@ struct CI_API Metadata {
 
 	Level		mLevel;
 	Location	mLocation;
+	//! When the entry was logged. Loggers use the current time when it's left at its default of the epoch.
+	std::chrono::system_clock::time_point	mTime;
 };
 
 CI_API extern std::ostream& operator<<( std::ostream &os, const Location &rhs );
@@ -93,6 +97,8 @@ class CI_API Logger : private Noncopyable {
 	virtual ~Logger()	{}
 
 	virtual void write( const Metadata &meta, const std::string &text ) = 0;
+	//! Flushes any output buffered by write(). Called after every write() when logging synchronously, and after each batch when logging asynchronously.
+	virtual void flush()	{}
 
 	void setTimestampEnabled( bool enable = true )	{ mTimeStampEnabled = enable; }
 	bool isTimestampEnabled() const					{ return mTimeStampEnabled; }
@@ -116,6 +122,7 @@ typedef std::shared_ptr<Logger>	LoggerRef;
 class CI_API LoggerConsole : public Logger {
   public:
 	void write( const Metadata &meta, const std::string &text ) override;
+	void flush() override;
 };
 
 //! \brief LoggerFile will write log messages to a specified file.
@@ -130,6 +137,7 @@ class CI_API LoggerFile : public Logger {
 	virtual ~LoggerFile();
 
 	void write( const Metadata &meta, const std::string &text ) override;
+	void flush() override;
 
 	//! Returns the file path targeted by this logger.
 	const fs::path&		getFilePath() const		{ return mFilePath; }
@@ -196,15 +204,26 @@ protected:
 #endif
 };
 
+//! Determines what happens to an entry logged while the asynchronous queue is full. Dropped entries are counted either way.
+enum OverflowPolicy {
+	//! The entry is discarded. The writer thread reports the number of discarded entries to the Loggers once it catches up.
+	OVERFLOW_DROP,
+	//! The logging thread waits until the writer thread makes room.
+	OVERFLOW_BLOCK
+};
+
 //! \brief LogManager manages a stack of all active Loggers.
 //!
 //! LogManager's default state contains a single LoggerConsole.  LogManager allows for adding and removing Loggers via their pointer values.
+//! By default entries are written synchronously by the logging thread. After enableAsync() entries are pushed into a bounded lock-free queue instead,
+//! and a dedicated writer thread passes them to the Loggers in batches.
 class CI_API LogManager {
 public:
 	// Returns a pointer to the shared instance. To enable logging during shutdown, this instance is leaked at shutdown.
 	static LogManager* instance()	{ return sInstance; }
 	//! Destroys the shared instance. Useful to remove false positives with leak detectors like valgrind.
 	static void destroyInstance()	{ delete sInstance; }
+	~LogManager();
 	//! Restores LogManager to its default state - a single LoggerConsole.
 	void restoreToDefault();
 
@@ -227,7 +246,21 @@ public:
 	void	setLevel( Level level );
 	
 	void write( const Metadata &meta, const std::string &text );
-	
+	//! Writes an entry, taking ownership of \a meta when the entry is queued for the writer thread.
+	void write( Metadata &&meta, const std::string &text );
+
+	//! Starts writing entries on a dedicated thread, through a queue of \a queueSize entries (rounded up to a power of two). \a policy determines what happens when the queue is full.
+	//! Calling enableAsync() again replaces the queue, after writing everything already queued.
+	void		enableAsync( size_t queueSize = 8192, OverflowPolicy policy = OVERFLOW_BLOCK );
+	//! Writes everything already queued and returns to synchronous logging. Entries logged concurrently with disableAsync() may be written synchronously or lost.
+	void		disableAsync();
+	//! Returns whether entries are currently written on a dedicated thread.
+	bool		isAsyncEnabled() const;
+	//! Blocks until every entry logged before the call has been written and the Loggers flushed. Suitable for shutdown and crash handlers. Does nothing when logging synchronously, or when called by a Logger on the writer thread.
+	void		flush();
+	//! Returns the number of entries discarded since enableAsync() because the queue was full.
+	uint64_t	getNumDropped() const;
+
 	template<typename LoggerT, typename... Args>
 	std::shared_ptr<LoggerT> makeLogger( Args&&... args );
 
@@ -237,23 +270,41 @@ public:
 protected:
 	LogManager();
 
+	class AsyncWriter;
+
+	//! Passes an entry to every Logger, with mMutex locked. Does not flush them.
+	void writeLocked( const Metadata &meta, const std::string &text );
+
 	std::vector<LoggerRef>			mLoggers;
 	
 	mutable std::mutex				mMutex;
+
+	std::atomic<AsyncWriter*>		mAsyncWriter;
+	//! Every writer created by enableAsync(), at most one per queue size. Stopped writers are kept alive until the LogManager is destroyed, since other threads may still be pushing into them,
+	//! and are restarted by enableAsync() calls with the same queue size.
+	std::vector<std::unique_ptr<AsyncWriter>>	mAsyncWriters;
+	std::mutex						mAsyncMutex;
 	
 	static LogManager 				*sInstance;
 };
-	
+
+namespace detail {
+class EntryStream;
+} // namespace detail
+
+//! Entry is the temporary created by the CI_LOG_* macros, formatting into a thread-local buffer that is reused between entries.
 struct CI_API Entry {
-	// TODO: move &&location
-	Entry( Level level, const Location &location );
+	Entry( Level level, Location location );
 	~Entry();
 
+	Entry( const Entry & ) = delete;
+	Entry& operator=( const Entry & ) = delete;
+
 	template <typename T>
 	Entry& operator<<( const T &rhs )
 	{
 		mHasContent = true;
-		mStream << rhs;
+		*mStream << rhs;
 		return *this;
 	}
 
@@ -262,9 +313,10 @@ struct CI_API Entry {
 
 private:
 
-	Metadata			mMetaData;
-	bool				mHasContent;
-	std::stringstream	mStream;
+	Metadata				mMetaData;
+	bool					mHasContent;
+	detail::EntryStream		*mEntryStream;
+	std::ostream			*mStream;
 };
 
 // ----------------------------------------------------------------------------------
@@ -0,0 +1,301 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Log.h"
+#include "cinder/Exception.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+//! Deferred logging captures a static format descriptor and the raw bytes of its arguments into a per-thread buffer, rather than
+//! formatting text at the call site. DeferredLogManager's thread drains the buffers, formatting the entries for the Loggers managed by
+//! LogManager, writing them to a binary file for the LogDecoder tool in tools/, or both.
+//!
+//! \code CI_LOG_DEFERRED_I( "frame {} took {} ms in {}", frameNumber, ms, passName ); \endcode
+//!
+//! The format must be a string literal. Each "{}" is replaced by the next argument, formatted as operator<<() of a std::ostream would.
+//! Arguments may be arithmetic types, pointers, C strings, std::string and std::string_view.
+
+namespace cinder { namespace log {
+
+namespace detail {
+class DeferredLogImpl;
+} // namespace detail
+
+//! The types of arguments deferred entries capture
+enum class DeferredArgType : uint8_t {
+	BOOL, CHAR, INT32, UINT32, INT64, UINT64, FLOAT, DOUBLE, STRING, POINTER
+};
+
+//! Describes the call site of deferred entries
+struct CI_API DeferredFormat {
+	uint32_t						mId = 0;
+	Level							mLevel = LEVEL_INFO;
+	std::string						mFormat, mFunctionName, mFileName;
+	uint32_t						mLineNumber = 0;
+	std::vector<DeferredArgType>	mArgTypes;
+};
+
+//! Exception thrown by readDeferredLog() for a file that isn't a well-formed binary log.
+class CI_API DeferredLogExc : public Exception {
+  public:
+	DeferredLogExc( const std::string &description ) : Exception( description ) {}
+};
+
+//! \brief DeferredLogManager drains the buffers written by the CI_LOG_DEFERRED_* macros.
+//!
+//! Every thread that logs a deferred entry gets a lock-free single-producer buffer. A dedicated thread started on first use drains them
+//! every few milliseconds, or sooner when a buffer passes half full. Each pass sorts the entries it finds in all threads' buffers by
+//! timestamp before passing them to the Loggers and the binary file; a thread's entries always stay in order.
+class CI_API DeferredLogManager : private Noncopyable {
+  public:
+	//! Returns a pointer to the shared instance, which is leaked at shutdown like LogManager's.
+	static DeferredLogManager* instance();
+
+	//! Sets whether entries are formatted and written to LogManager's Loggers. Enabled by default.
+	void	setFormatToLoggers( bool enable );
+	bool	isFormatToLoggers() const;
+	//! Writes entries to the binary file at \a path, which is overwritten. An empty path closes the current file.
+	void	setBinaryFile( const fs::path &path );
+	//! Sets the size of the buffers of threads logging their first deferred entry after this call. Defaults to 256KB.
+	void	setThreadBufferSize( size_t bytes );
+	//! Sets what happens to an entry logged while its thread's buffer is full. Defaults to OVERFLOW_DROP, which keeps logging wait-free.
+	void	setOverflowPolicy( OverflowPolicy policy );
+
+	//! Blocks until every entry logged before the call has been written to the binary file and the Loggers, and flushes both.
+	void		flush();
+	//! Returns the number of entries dropped because their thread's buffer was full.
+	uint64_t	getNumDropped() const;
+
+	//! Returns a copy of the format registered with \a id, or a DeferredFormat whose mId is 0 if there is none.
+	DeferredFormat	getFormat( uint32_t id ) const;
+
+  private:
+	DeferredLogManager();
+
+	std::unique_ptr<detail::DeferredLogImpl>	mImpl;
+};
+
+//! Returns the shared DeferredLogManager.
+CI_API DeferredLogManager* deferredManager();
+
+//! Reads the binary log at \a path written through DeferredLogManager::setBinaryFile(), calling \a fn with the Metadata and formatted text of every entry in the order they were written. Throws DeferredLogExc for malformed files.
+CI_API void readDeferredLog( const fs::path &path, const std::function<void( const Metadata &meta, const std::string &text )> &fn );
+
+//! Returns \a format with its "{}" placeholders replaced by the arguments encoded in [\a args, \a argsEnd). Throws DeferredLogExc if the arguments don't match the format's argument types.
+CI_API std::string formatDeferred( const DeferredFormat &format, const char *args, const char *argsEnd );
+
+namespace detail {
+
+//! The static state of a CI_LOG_DEFERRED_* call site. Constant-initialized, so it costs nothing until the first entry registers it.
+struct DeferredSite {
+	Level					mLevel;
+	const char				*mFunctionName;
+	const char				*mFileName;
+	uint32_t				mLineNumber;
+	std::atomic<uint32_t>	mId{ 0 };
+};
+
+//! Registers \a site and returns its id
+CI_API uint32_t registerDeferredSite( DeferredSite &site, const char *format, const DeferredArgType *argTypes, size_t numArgs );
+//! Reserves room for an entry with \a argsSize bytes of arguments in the calling thread's buffer, returning where the arguments go, or nullptr if the entry was dropped
+CI_API char* beginDeferredRecord( uint32_t formatId, size_t argsSize );
+//! Publishes the entry started by beginDeferredRecord()
+CI_API void endDeferredRecord();
+
+template<typename T>
+constexpr bool isDeferredString()
+{
+	return std::is_same_v<T, const char*> || std::is_same_v<T, char*> || std::is_same_v<T, const unsigned char*> || std::is_same_v<T, unsigned char*>
+		|| std::is_same_v<T, const signed char*> || std::is_same_v<T, signed char*> || std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+}
+
+template<typename T>
+constexpr DeferredArgType getDeferredArgType()
+{
+	using U = std::decay_t<T>;
+	static_assert( ! std::is_same_v<U, wchar_t> && ! std::is_same_v<U, char8_t> && ! std::is_same_v<U, char16_t> && ! std::is_same_v<U, char32_t>,
+		"wide characters can't be written to a std::ostream" );
+	static_assert( std::is_arithmetic_v<U> || std::is_pointer_v<U> || isDeferredString<U>(),
+		"deferred log arguments must be arithmetic types, pointers or strings; convert other types (such as enums) first" );
+
+	if constexpr( std::is_same_v<U, bool> )
+		return DeferredArgType::BOOL;
+	else if constexpr( std::is_same_v<U, char> || std::is_same_v<U, signed char> || std::is_same_v<U, unsigned char> )
+		return DeferredArgType::CHAR;
+	else if constexpr( std::is_integral_v<U> && sizeof( U ) <= 4 )
+		return std::is_signed_v<U> ? DeferredArgType::INT32 : DeferredArgType::UINT32;
+	else if constexpr( std::is_integral_v<U> )
+		return std::is_signed_v<U> ? DeferredArgType::INT64 : DeferredArgType::UINT64;
+	else if constexpr( std::is_floating_point_v<U> )
+		return sizeof( U ) == sizeof( float ) ? DeferredArgType::FLOAT : DeferredArgType::DOUBLE;
+	else if constexpr( isDeferredString<U>() )
+		return DeferredArgType::STRING;
+	else
+		return DeferredArgType::POINTER;
+}
+
+//! Strings are measured once, as views; other arguments pass through
+template<typename T>
+auto prepareDeferredArg( const T &arg )
+{
+	using U = std::decay_t<T>;
+	if constexpr( std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view> )
+		return std::string_view( arg );
+	else if constexpr( isDeferredString<U>() ) {
+		const std::remove_pointer_t<U> *str = arg;
+		return str ? std::string_view( reinterpret_cast<const char*>( str ) ) : std::string_view( "(null)" );
+	}
+	else
+		return arg;
+}
+
+template<typename T>
+size_t getDeferredArgSize( const T &arg )
+{
+	if constexpr( std::is_same_v<T, std::string_view> )
+		return sizeof( uint32_t ) + arg.size();
+	else if constexpr( std::is_pointer_v<T> )
+		return sizeof( uint64_t );
+	else if constexpr( std::is_same_v<T, bool> )
+		return 1;
+	else if constexpr( std::is_integral_v<T> && sizeof( T ) <= 4 )
+		return sizeof( T ) == 1 ? 1 : 4;
+	else if constexpr( std::is_integral_v<T> )
+		return 8;
+	else
+		return sizeof( T ) == sizeof( float ) ? 4 : 8;
+}
+
+template<typename T>
+char* writeDeferredArg( char *dst, const T &arg )
+{
+	if constexpr( std::is_same_v<T, std::string_view> ) {
+		const uint32_t size = uint32_t( arg.size() );
+		std::memcpy( dst, &size, sizeof( size ) );
+		std::memcpy( dst + sizeof( size ), arg.data(), size );
+		return dst + sizeof( size ) + size;
+	}
+	else if constexpr( std::is_pointer_v<T> ) {
+		const uint64_t value = uint64_t( reinterpret_cast<uintptr_t>( arg ) );
+		std::memcpy( dst, &value, sizeof( value ) );
+		return dst + sizeof( value );
+	}
+	else if constexpr( std::is_same_v<T, bool> ) {
+		*dst = arg ? 1 : 0;
+		return dst + 1;
+	}
+	else if constexpr( std::is_integral_v<T> && sizeof( T ) == 1 ) {
+		*dst = char( arg );
+		return dst + 1;
+	}
+	else if constexpr( std::is_integral_v<T> ) {
+		// widened to the INT32 / UINT32 / INT64 / UINT64 of getDeferredArgType()
+		using Wide = std::conditional_t<( sizeof( T ) <= 4 ), std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+		const Wide value = Wide( arg );
+		std::memcpy( dst, &value, sizeof( value ) );
+		return dst + sizeof( value );
+	}
+	else {
+		using Wide = std::conditional_t<sizeof( T ) == sizeof( float ), float, double>;
+		const Wide value = Wide( arg );
+		std::memcpy( dst, &value, sizeof( value ) );
+		return dst + sizeof( value );
+	}
+}
+
+template<typename... Args>
+void writeDeferred( uint32_t id, const Args&... args )
+{
+	char *dst = beginDeferredRecord( id, ( size_t( 0 ) + ... + getDeferredArgSize( args ) ) );
+	if( dst ) {
+		( ( dst = writeDeferredArg( dst, args ) ), ... );
+		endDeferredRecord();
+	}
+}
+
+template<size_t N, typename... Args>
+void logDeferred( DeferredSite &site, const char ( &format )[N], const Args&... args )
+{
+	uint32_t id = site.mId.load( std::memory_order_acquire );
+	if( id == 0 ) {
+		static constexpr DeferredArgType sArgTypes[sizeof...( Args ) + 1] = { getDeferredArgType<Args>()..., DeferredArgType::BOOL };
+		id = registerDeferredSite( site, format, sArgTypes, sizeof...( Args ) );
+	}
+
+	writeDeferred( id, prepareDeferredArg( args )... );
+}
+
+} // namespace detail
+
+} } // namespace cinder::log
+
+// ----------------------------------------------------------------------------------
+// Deferred logging macros
+
+#define CINDER_LOG_DEFERRED( level, ... )																						\
+	do {																														\
+		static ::cinder::log::detail::DeferredSite sCinderDeferredSite{ level, CINDER_CURRENT_FUNCTION, __FILE__, __LINE__ };	\
+		::cinder::log::detail::logDeferred( sCinderDeferredSite, __VA_ARGS__ );												\
+	} while( 0 )
+
+#if( CI_MIN_LOG_LEVEL <= 0 )
+	#define CI_LOG_DEFERRED_V( ... )	CINDER_LOG_DEFERRED( ::cinder::log::LEVEL_VERBOSE, __VA_ARGS__ )
+#else
+	#define CI_LOG_DEFERRED_V( ... )	((void)0)
+#endif
+
+#if( CI_MIN_LOG_LEVEL <= 1 )
+	#define CI_LOG_DEFERRED_D( ... )	CINDER_LOG_DEFERRED( ::cinder::log::LEVEL_DEBUG, __VA_ARGS__ )
+#else
+	#define CI_LOG_DEFERRED_D( ... )	((void)0)
+#endif
+
+#if( CI_MIN_LOG_LEVEL <= 2 )
+	#define CI_LOG_DEFERRED_I( ... )	CINDER_LOG_DEFERRED( ::cinder::log::LEVEL_INFO, __VA_ARGS__ )
+#else
+	#define CI_LOG_DEFERRED_I( ... )	((void)0)
+#endif
+
+#if( CI_MIN_LOG_LEVEL <= 3 )
+	#define CI_LOG_DEFERRED_W( ... )	CINDER_LOG_DEFERRED( ::cinder::log::LEVEL_WARNING, __VA_ARGS__ )
+#else
+	#define CI_LOG_DEFERRED_W( ... )	((void)0)
+#endif
+
+#if( CI_MIN_LOG_LEVEL <= 4 )
+	#define CI_LOG_DEFERRED_E( ... )	CINDER_LOG_DEFERRED( ::cinder::log::LEVEL_ERROR, __VA_ARGS__ )
+#else
+	#define CI_LOG_DEFERRED_E( ... )	((void)0)
+#endif
+
+#if( CI_MIN_LOG_LEVEL <= 5 )
+	#define CI_LOG_DEFERRED_F( ... )	CINDER_LOG_DEFERRED( ::cinder::log::LEVEL_FATAL, __VA_ARGS__ )
+#else
+	#define CI_LOG_DEFERRED_F( ... )	((void)0)
+#endif
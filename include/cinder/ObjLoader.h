@@ -43,6 +43,8 @@ namespace cinder {
  * myCubeRef = gl::Batch::create( loader, gl::getStockShader( gl::ShaderDef().color() ) );
  * myCubeRef->draw();
  * \endcode
+ *
+ * Large files are split into chunks of lines which are parsed in parallel, one thread per core. Files loaded through a DataSource are parsed straight from their memory mapping.
 **/
 
 class CI_API ObjLoader : public geom::Source {
@@ -122,19 +124,20 @@ class CI_API ObjLoader : public geom::Source {
 	Source*			clone() const override { return new ObjLoader( *this ); }
 
   private:
-	typedef std::tuple<int,int> VertexPair;
-	typedef std::tuple<int,int,int> VertexTriple;
+	class UniqueVertexMap;
 
+	//! Parses the stream in chunks of lines across threads, then stitches their records together in order.
 	void	parse( bool includeNormals, bool includeTexCoords );
- 	void	parseFace( Group *group, const Material *material, const std::string &s, bool includeNormals, bool includeTexCoords );
+	//! Appends \a face, whose indices are as written in the file, to \a group, resolving them against the group and updating its mHasTexCoords and mHasNormals.
+	void	addFace( Group *group, const Material *material, Face &&face, uint8_t flags );
     void    parseMaterial( std::shared_ptr<IStreamCinder> material );
 
 	void	load() const;
 
-	void	loadGroupNormalsTextures( const Group &group, std::map<VertexTriple,int> &uniqueVerts ) const;
-	void	loadGroupNormals( const Group &group, std::map<VertexPair,int> &uniqueVerts ) const;
-	void	loadGroupTextures( const Group &group, std::map<VertexPair,int> &uniqueVerts ) const;
-	void	loadGroup( const Group &group, std::map<int,int> &uniqueVerts ) const;
+	void	loadGroupNormalsTextures( const Group &group, UniqueVertexMap &uniqueVerts ) const;
+	void	loadGroupNormals( const Group &group, UniqueVertexMap &uniqueVerts ) const;
+	void	loadGroupTextures( const Group &group, UniqueVertexMap &uniqueVerts ) const;
+	void	loadGroup( const Group &group, UniqueVertexMap &uniqueVerts ) const;
 
 	std::shared_ptr<IStreamCinder>	mStream;
 
@@ -278,7 +278,9 @@ class CI_API Path2d {
 
 	//! Find all points where the path crosses itself. \a tolerance controls approximation accuracy.
 	//! Returns a vector of self-intersection results, each containing the two t-values and the intersection point.
-	std::vector<SelfIntersection>	findSelfIntersections( float tolerance = 1e-4f ) const;
+	//! Pairs of segments whose bounds overlap along a sweep are intersected in parallel on TaskScheduler::global(), on up to \a numThreads threads, or on all of them for the default \c 0.
+	//! The loops of each cubic come first, by segment, followed by the crossings of the pairs in the order the sweep finds them, which is by the left edge of their bounds. The order doesn't depend on the thread count.
+	std::vector<SelfIntersection>	findSelfIntersections( float tolerance = 1e-4f, int numThreads = 0 ) const;
 
 	//! Result of a path-to-path intersection search
 	struct Intersection {
@@ -291,12 +293,14 @@ class CI_API Path2d {
 	};
 
 	//! Find all points where this path intersects with \a other. \a tolerance controls approximation accuracy.
-	//! Returns intersection results where t1/segment1 refer to this path and t2/segment2 refer to \a other.
-	std::vector<Intersection>	findIntersections( const Path2d &other, float tolerance = 1e-4f ) const;
+	//! Returns intersection results where t1/segment1 refer to this path and t2/segment2 refer to \a other, ordered by segment1 and then segment2 for any thread count.
+	//! Both paths' segments share one sweep over their bounds, and the overlapping pairs are intersected in parallel on TaskScheduler::global(), on up to \a numThreads threads, or on all of them for the default \c 0.
+	std::vector<Intersection>	findIntersections( const Path2d &other, float tolerance = 1e-4f, int numThreads = 0 ) const;
 
 	//! Find all points where this path intersects with any contour of \a shape. \a tolerance controls approximation accuracy.
-	//! Returns intersection results where t1/segment1 refer to this path and t2/segment2 refer to the shape's contours.
-	std::vector<Intersection>	findIntersections( const Shape2d &shape, float tolerance = 1e-4f ) const;
+	//! Returns intersection results where t1/segment1 refer to this path and t2/segment2 refer to the shape's contours, ordered by contour and then as findIntersections( const Path2d& ) orders them.
+	//! Each contour is intersected in parallel as with a Path2d, on up to \a numThreads threads, or on all of them for the default \c 0.
+	std::vector<Intersection>	findIntersections( const Shape2d &shape, float tolerance = 1e-4f, int numThreads = 0 ) const;
 
 	//! Returns true if this path is coincident with \a other (all control points within \a tolerance).
 	//! Coincident paths have the same geometry and would cause pathological intersection behavior.
@@ -0,0 +1,403 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/AxisAlignedBox.h"
+#include "cinder/Vector.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace cinder {
+
+/*! A uniform grid of cells of a fixed size over \a Dim dimensional points, for the neighborhoods of points that move every frame, such as particles.
+	The cells are hashed into a power of two number of buckets, so the grid is unbounded, and the points are counting sorted by bucket into one array,
+	which keeps the points of a cell contiguous. Only the rows of cells along x are hashed, so that consecutive cells of a row are consecutive buckets and a query scans a range per row.
+	A bucket can hold several cells, whose points the queries tell apart by their distance.
+	build() takes O(N) time, with its hashing, counting and scattering passes run in parallel on TaskScheduler::global(). update() then only moves the points that left their bucket, rebuilding when too many did.
+	Queries are const and can run concurrently, and report the indices of the points passed to build(). */
+template<typename T = float, int Dim = 3>
+class SpatialHashGrid {
+  public:
+	static_assert( Dim >= 1 && Dim <= 4, "SpatialHashGrid supports 1 to 4 dimensions" );
+
+	typedef glm::vec<Dim, T, glm::defaultp>			VecT;
+	typedef glm::vec<Dim, int32_t, glm::defaultp>	CellT;
+
+	static constexpr uint32_t	INVALID_INDEX = 0xFFFFFFFF;
+
+	//! Constructs an empty grid of cells of \a cellSize, hashed into \a numBuckets buckets, rounded up to a power of two, or into about a bucket per point for \c 0
+	explicit SpatialHashGrid( T cellSize = T( 1 ), uint32_t numBuckets = 0 );
+
+	//! Replaces the contents of the grid with \a numPoints \a positions, hashed and sorted on up to \a numThreads threads, or without a limit for \c 0. Buckets are ordered by index whatever the thread count.
+	void	build( const VecT *positions, size_t numPoints, int numThreads = 0 );
+	void	build( const std::vector<VecT> &positions, int numThreads = 0 ) { build( positions.data(), positions.size(), numThreads ); }
+	/*! Moves the points to \a positions, which must list the points of the last build() in the same order. Points that stayed in their bucket are updated in place, and those that left it are
+		kept aside in a small secondary grid. Rebuilds and returns \c false when the number of points changed or more than a quarter of them left their buckets. */
+	bool	update( const VecT *positions, size_t numPoints, int numThreads = 0 );
+	bool	update( const std::vector<VecT> &positions, int numThreads = 0 ) { return update( positions.data(), positions.size(), numThreads ); }
+
+	T			getCellSize() const { return mCellSize; }
+	//! Returns the number of buckets of the last build()
+	uint32_t	getNumBuckets() const { return mMain.starts.empty() ? 0 : uint32_t( mMain.starts.size() - 1 ); }
+	//! Returns the number of points that left their bucket since the last build()
+	size_t		getNumMoved() const { return mMoved.ids.size(); }
+	size_t		size() const { return mSlots.size(); }
+	bool		empty() const { return mSlots.empty(); }
+	//! Returns the cell containing \a p
+	CellT		getCell( const VecT &p ) const;
+
+	//! Calls \a fn( index, position, distSqrd ) for every point closer than \a radius to \a p, in no particular order
+	template<typename Fn>
+	void	forEachInRadius( const VecT &p, T radius, Fn &&fn ) const;
+	//! Calls \a fn( index, position ) for every point inside the box from \a boxMin to \a boxMax, boundary included, in no particular order
+	template<typename Fn>
+	void	forEachInBox( const VecT &boxMin, const VecT &boxMax, Fn &&fn ) const;
+	//! Calls \a fn( index, position ) for every point inside \a box, boundary included. Requires a 3D grid.
+	template<typename Fn>
+	void	forEachInBox( const AxisAlignedBox &box, Fn &&fn ) const;
+
+	//! Finds the points closer than \a radius to \a p and returns their number. Fills \a indices, and \a distancesSqrd when given, with up to \a maxResults of them, in no particular order.
+	size_t	findInRadius( const VecT &p, T radius, uint32_t *indices, size_t maxResults, T *distancesSqrd = nullptr ) const;
+	//! Replaces the contents of \a indices with the points closer than \a radius to \a p, in no particular order
+	void	findInRadius( const VecT &p, T radius, std::vector<uint32_t> *indices ) const;
+	/*! Finds the points closer than \a radius to each of the \a numPoints \a points in parallel. Up to \a maxResults of those of point \a i fill \a indices[i * maxResults, (i + 1) * maxResults),
+		and \a distancesSqrd when given, while \a counts[i] receives how many there are in total. */
+	void	findInRadius( const VecT *points, size_t numPoints, T radius, size_t maxResults, uint32_t *indices, uint32_t *counts, T *distancesSqrd = nullptr, int numThreads = 0 ) const;
+
+  private:
+	// the points or buckets handed to a thread at a time by the parallel loops, which only do a little work for each
+	static constexpr int64_t	GRAIN_SIZE = 4096;
+
+	// The points of a counting sort by bucket. Bucket b holds the slots [starts[b], starts[b + 1]), ordered by index, and a slot whose point moved away holds INVALID_INDEX.
+	struct Table {
+		std::vector<uint32_t>	starts;
+		std::vector<VecT>		positions;
+		std::vector<uint32_t>	ids;
+		uint32_t				mask = 0;
+	};
+
+	// the hash of the row of \a cell, to which its x is added
+	uint32_t	hashRow( const CellT &cell ) const;
+	uint32_t	hashCell( const CellT &cell, uint32_t mask ) const { return ( hashRow( cell ) + uint32_t( cell[0] ) ) & mask; }
+	// Sorts the points \a ids, which must be increasing, or 0 to \a count - 1 when null, into \a table, returning their buckets in \a buckets and their slots in \a slots when given
+	void		buildTable( Table *table, const VecT *positions, const uint32_t *ids, size_t count, uint32_t numBuckets, int numThreads, uint32_t *buckets, uint32_t *slots );
+	// Calls \a fn( slot ) for the slots of the buckets of the cells from \a lo to \a hi, visiting each bucket once
+	template<typename Fn>
+	void		forEachInCells( const Table &table, const CellT &lo, const CellT &hi, Fn &fn ) const;
+
+	T						mCellSize, mInvCellSize;
+	uint32_t				mNumBuckets;
+	Table					mMain, mMoved;
+	// the bucket and slot in mMain of each point
+	std::vector<uint32_t>	mBuckets, mSlots;
+	std::vector<uint32_t>	mMovedBuckets, mCursors;
+	std::vector<uint8_t>	mMovedFlags;
+};
+
+template<typename T, int Dim>
+SpatialHashGrid<T, Dim>::SpatialHashGrid( T cellSize, uint32_t numBuckets )
+	: mCellSize( cellSize ), mInvCellSize( T( 1 ) / cellSize ), mNumBuckets( numBuckets )
+{
+}
+
+template<typename T, int Dim>
+typename SpatialHashGrid<T, Dim>::CellT SpatialHashGrid<T, Dim>::getCell( const VecT &p ) const
+{
+	// clamped so that far away points share the outermost cells rather than overflow
+	CellT result;
+	for( int k = 0; k < Dim; ++k )
+		result[k] = int32_t( std::clamp<T>( std::floor( p[k] * mInvCellSize ), T( -( 1 << 30 ) ), T( 1 << 30 ) ) );
+	return result;
+}
+
+template<typename T, int Dim>
+uint32_t SpatialHashGrid<T, Dim>::hashRow( const CellT &cell ) const
+{
+	const uint32_t primes[3] = { 73856093u, 19349663u, 83492791u };
+	uint32_t h = 0;
+	for( int k = 1; k < Dim; ++k )
+		h ^= uint32_t( cell[k] ) * primes[k - 1];
+	// spreads the low bits, which the mask keeps
+	h *= 0x9E3779B1u;
+	return h ^ ( h >> 16 );
+}
+
+template<typename T, int Dim>
+void SpatialHashGrid<T, Dim>::buildTable( Table *table, const VecT *positions, const uint32_t *ids, size_t count, uint32_t numBuckets, int numThreads, uint32_t *buckets, uint32_t *slots )
+{
+	uint32_t log2Buckets = 0;
+	while( ( 1u << log2Buckets ) < numBuckets && log2Buckets < 31 )
+		++log2Buckets;
+	numBuckets = 1u << log2Buckets;
+	table->mask = numBuckets - 1;
+	table->starts.assign( numBuckets + 1, 0 );
+	table->positions.resize( count );
+	table->ids.resize( count );
+
+	// A counting sort over a chunk of consecutive points per thread: each chunk counts its points per bucket, the counts are turned into the slots
+	// where each chunk starts in each bucket, and each chunk then scatters its points in index order, which leaves every bucket ordered by index.
+	int64_t numChunks = ( (int64_t)count + GRAIN_SIZE - 1 ) / GRAIN_SIZE;
+	numChunks = std::max<int64_t>( 1, std::min<int64_t>( numChunks, numThreads > 0 ? numThreads : TaskScheduler::global()->getNumThreads() + 1 ) );
+	const auto chunkBegin = [&]( int64_t chunk ) { return size_t( chunk * (int64_t)count / numChunks ); };
+	// the counts, then the cursors, of chunk c in bucket b are at mCursors[c * numBuckets + b]
+	mCursors.assign( size_t( numChunks ) * numBuckets, 0 );
+
+	TaskScheduler::global()->parallelFor( 0, numChunks, [&]( int64_t firstChunk, int64_t lastChunk ) {
+		for( int64_t c = firstChunk; c < lastChunk; ++c ) {
+			uint32_t *counts = mCursors.data() + c * numBuckets;
+			for( size_t i = chunkBegin( c ), end = chunkBegin( c + 1 ); i < end; ++i ) {
+				buckets[i] = hashCell( getCell( positions[ids ? ids[i] : i] ), table->mask );
+				++counts[buckets[i]];
+			}
+		}
+	}, 1, numThreads );
+
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numBuckets, [&]( int64_t firstBucket, int64_t lastBucket ) {
+		for( int64_t b = firstBucket; b < lastBucket; ++b ) {
+			uint32_t total = 0;
+			for( int64_t c = 0; c < numChunks; ++c )
+				total += mCursors[c * numBuckets + b];
+			table->starts[b + 1] = total;
+		}
+	}, GRAIN_SIZE, numThreads );
+	for( uint32_t b = 0; b < numBuckets; ++b )
+		table->starts[b + 1] += table->starts[b];
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numBuckets, [&]( int64_t firstBucket, int64_t lastBucket ) {
+		for( int64_t b = firstBucket; b < lastBucket; ++b ) {
+			uint32_t cursor = table->starts[b];
+			for( int64_t c = 0; c < numChunks; ++c ) {
+				const uint32_t chunkCount = mCursors[c * numBuckets + b];
+				mCursors[c * numBuckets + b] = cursor;
+				cursor += chunkCount;
+			}
+		}
+	}, GRAIN_SIZE, numThreads );
+
+	TaskScheduler::global()->parallelFor( 0, numChunks, [&]( int64_t firstChunk, int64_t lastChunk ) {
+		for( int64_t c = firstChunk; c < lastChunk; ++c ) {
+			uint32_t *cursors = mCursors.data() + c * numBuckets;
+			for( size_t i = chunkBegin( c ), end = chunkBegin( c + 1 ); i < end; ++i ) {
+				const uint32_t id = ids ? ids[i] : uint32_t( i );
+				const uint32_t slot = cursors[buckets[i]]++;
+				table->ids[slot] = id;
+				table->positions[slot] = positions[id];
+				if( slots )
+					slots[id] = slot;
+			}
+		}
+	}, 1, numThreads );
+}
+
+template<typename T, int Dim>
+void SpatialHashGrid<T, Dim>::build( const VecT *positions, size_t numPoints, int numThreads )
+{
+	mBuckets.resize( numPoints );
+	mSlots.resize( numPoints );
+	buildTable( &mMain, positions, nullptr, numPoints, mNumBuckets ? mNumBuckets : uint32_t( std::max<size_t>( numPoints, 64 ) ), numThreads, mBuckets.data(), mSlots.data() );
+	mMoved = Table();
+}
+
+template<typename T, int Dim>
+bool SpatialHashGrid<T, Dim>::update( const VecT *positions, size_t numPoints, int numThreads )
+{
+	if( numPoints != mSlots.size() || mMain.starts.empty() ) {
+		build( positions, numPoints, numThreads );
+		return false;
+	}
+
+	// points back in their bucket reclaim their slot, and the others leave it empty
+	mMovedFlags.resize( numPoints );
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i ) {
+			const uint32_t slot = mSlots[i];
+			const bool moved = hashCell( getCell( positions[i] ), mMain.mask ) != mBuckets[i];
+			mMain.positions[slot] = positions[i];
+			mMain.ids[slot] = moved ? INVALID_INDEX : uint32_t( i );
+			mMovedFlags[i] = moved;
+		}
+	}, GRAIN_SIZE, numThreads );
+
+	std::vector<uint32_t> moved;
+	moved.reserve( mMoved.ids.size() );
+	for( size_t i = 0; i < numPoints; ++i ) {
+		if( mMovedFlags[i] )
+			moved.push_back( uint32_t( i ) );
+	}
+	if( moved.size() > numPoints / 4 ) {
+		build( positions, numPoints, numThreads );
+		return false;
+	}
+
+	mMovedBuckets.resize( moved.size() );
+	buildTable( &mMoved, positions, moved.data(), moved.size(), uint32_t( moved.size() ), numThreads, mMovedBuckets.data(), nullptr );
+	return true;
+}
+
+template<typename T, int Dim>
+ template<typename Fn>
+void SpatialHashGrid<T, Dim>::forEachInCells( const Table &table, const CellT &lo, const CellT &hi, Fn &fn ) const
+{
+	if( table.ids.empty() )
+		return;
+
+	double numCells = 1;
+	for( int k = 0; k < Dim; ++k ) {
+		if( hi[k] < lo[k] )
+			return;
+		numCells *= double( hi[k] ) - lo[k] + 1;
+	}
+	const uint32_t numBuckets = uint32_t( table.starts.size() - 1 );
+	if( numCells >= numBuckets ) {
+		for( uint32_t slot = 0; slot < table.ids.size(); ++slot )
+			fn( slot );
+		return;
+	}
+
+	// each row of cells is a range of buckets, split in two where it wraps around, and ranges that overlap or touch are merged so that each bucket is visited once
+	const uint32_t rowLength = uint32_t( hi[0] - lo[0] + 1 );
+	const size_t numRanges = size_t( numCells ) / rowLength * 2;
+	const size_t STACK_RANGES = 64;
+	std::pair<uint32_t, uint32_t> stackRanges[STACK_RANGES];
+	std::vector<std::pair<uint32_t, uint32_t>> vectorRanges;
+	if( numRanges > STACK_RANGES )
+		vectorRanges.resize( numRanges );
+	std::pair<uint32_t, uint32_t> *ranges = numRanges > STACK_RANGES ? vectorRanges.data() : stackRanges;
+	size_t numVisited = 0;
+	for( CellT cell = lo;; ) {
+		const uint32_t first = hashCell( cell, table.mask );
+		if( first + rowLength <= numBuckets )
+			ranges[numVisited++] = { first, first + rowLength };
+		else {
+			ranges[numVisited++] = { first, numBuckets };
+			ranges[numVisited++] = { 0, first + rowLength - numBuckets };
+		}
+		int k = 1;
+		for( ; k < Dim; ++k ) {
+			if( cell[k] < hi[k] ) {
+				++cell[k];
+				break;
+			}
+			cell[k] = lo[k];
+		}
+		if( k == Dim )
+			break;
+	}
+	std::sort( ranges, ranges + numVisited );
+
+	for( size_t i = 0; i < numVisited; ) {
+		const uint32_t begin = ranges[i].first;
+		uint32_t end = ranges[i].second;
+		for( ++i; i < numVisited && ranges[i].first <= end; ++i )
+			end = std::max( end, ranges[i].second );
+		for( uint32_t slot = table.starts[begin]; slot < table.starts[end]; ++slot )
+			fn( slot );
+	}
+}
+
+template<typename T, int Dim>
+ template<typename Fn>
+void SpatialHashGrid<T, Dim>::forEachInRadius( const VecT &p, T radius, Fn &&fn ) const
+{
+	const T radiusSqrd = radius * radius;
+	const CellT lo = getCell( p - VecT( radius ) ), hi = getCell( p + VecT( radius ) );
+	for( const Table *table : { &mMain, &mMoved } ) {
+		auto slotFn = [&]( uint32_t slot ) {
+			const uint32_t id = table->ids[slot];
+			if( id == INVALID_INDEX )
+				return;
+			const VecT delta = table->positions[slot] - p;
+			const T distSqrd = glm::dot( delta, delta );
+			if( distSqrd < radiusSqrd )
+				fn( id, table->positions[slot], distSqrd );
+		};
+		forEachInCells( *table, lo, hi, slotFn );
+	}
+}
+
+template<typename T, int Dim>
+ template<typename Fn>
+void SpatialHashGrid<T, Dim>::forEachInBox( const VecT &boxMin, const VecT &boxMax, Fn &&fn ) const
+{
+	const CellT lo = getCell( boxMin ), hi = getCell( boxMax );
+	for( const Table *table : { &mMain, &mMoved } ) {
+		auto slotFn = [&]( uint32_t slot ) {
+			const uint32_t id = table->ids[slot];
+			if( id == INVALID_INDEX )
+				return;
+			const VecT &position = table->positions[slot];
+			for( int k = 0; k < Dim; ++k ) {
+				if( position[k] < boxMin[k] || position[k] > boxMax[k] )
+					return;
+			}
+			fn( id, position );
+		};
+		forEachInCells( *table, lo, hi, slotFn );
+	}
+}
+
+template<typename T, int Dim>
+ template<typename Fn>
+void SpatialHashGrid<T, Dim>::forEachInBox( const AxisAlignedBox &box, Fn &&fn ) const
+{
+	static_assert( Dim == 3, "AxisAlignedBox queries require a 3D SpatialHashGrid" );
+	forEachInBox( VecT( box.getMin() ), VecT( box.getMax() ), fn );
+}
+
+template<typename T, int Dim>
+size_t SpatialHashGrid<T, Dim>::findInRadius( const VecT &p, T radius, uint32_t *indices, size_t maxResults, T *distancesSqrd ) const
+{
+	size_t result = 0;
+	forEachInRadius( p, radius, [&]( uint32_t index, const VecT &, T distSqrd ) {
+		if( result < maxResults ) {
+			indices[result] = index;
+			if( distancesSqrd )
+				distancesSqrd[result] = distSqrd;
+		}
+		++result;
+	} );
+
+	return result;
+}
+
+template<typename T, int Dim>
+void SpatialHashGrid<T, Dim>::findInRadius( const VecT &p, T radius, std::vector<uint32_t> *indices ) const
+{
+	indices->clear();
+	forEachInRadius( p, radius, [&]( uint32_t index, const VecT &, T ) { indices->push_back( index ); } );
+}
+
+template<typename T, int Dim>
+void SpatialHashGrid<T, Dim>::findInRadius( const VecT *points, size_t numPoints, T radius, size_t maxResults, uint32_t *indices, uint32_t *counts, T *distancesSqrd, int numThreads ) const
+{
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			counts[i] = uint32_t( findInRadius( points[i], radius, indices + i * maxResults, maxResults, distancesSqrd ? distancesSqrd + i * maxResults : nullptr ) );
+	}, GRAIN_SIZE, numThreads );
+}
+
+} // namespace cinder
@@ -31,7 +31,9 @@
   #include "cinder/app/android/AssetFileSystem.h"
 #endif
 
+#include <iterator>
 #include <string>
+#include <string_view>
 
 namespace cinder {
 
@@ -122,6 +124,7 @@ class CI_API IStreamCinder : public virtual StreamBase {
 	void		read( fs::path *p );
 	void		readFixedString( char *t, size_t maxSize, bool nullTerminate );
 	void		readFixedString( std::string *t, size_t size );
+	//! Reads characters up to the next "\n", "\r\n" or "\r", returning them without the terminator. Scans the stream's buffer a block at a time when the stream exposes it through IOPeek(). Consider LineReader to avoid allocating a string per line.
 	std::string	readLine();
 	
 	void			readData( void *dest, size_t size );
@@ -134,11 +137,62 @@ class CI_API IStreamCinder : public virtual StreamBase {
 	IStreamCinder() = default;
 
 	virtual void		IORead( void *t, size_t size ) = 0;
+	//! Points \a data at the bytes following the read position which the stream already holds in memory, refilling its buffer first if it is exhausted, and returns how many there are without consuming them. Returns 0 at the end of the stream, and always for streams which don't expose a buffer.
+	virtual size_t		IOPeek( const uint8_t ** /*data*/ ) { return 0; }
+	//! Consumes \a size of the bytes exposed by the last call to IOPeek().
+	virtual void		IOSkip( size_t /*size*/ ) {}
 		
 	static const int	MINIMUM_BUFFER_SIZE = 8; // minimum bytes of random access a stream must offer relative to the file start
+
+	friend class LineReader;
 };
 typedef std::shared_ptr<IStreamCinder>		IStreamRef;
 
+//! Reads the lines of an IStreamCinder as std::string_views, terminated by "\n", "\r\n" or "\r" like IStreamCinder::readLine(). Lines point straight into the stream's buffer, or into the mapped data of an IStreamMem, and are only copied when they span a refill of the buffer. Leaves the stream positioned just past the last line returned.
+/** \code
+	for( std::string_view line : LineReader( stream ) )
+		...
+	\endcode **/
+class CI_API LineReader {
+ public:
+	LineReader( const IStreamRef &stream ) : mStream( stream ) {}
+
+	//! Reads the next line into \a line, without its terminator. Returns \c false at the end of the stream. \a line remains valid until the next call or until the stream is otherwise read from.
+	bool	readLine( std::string_view *line );
+
+	class Iterator {
+	  public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const std::string_view*;
+		using reference = const std::string_view&;
+
+		Iterator() : mReader( nullptr ) {}
+		explicit Iterator( LineReader *reader ) : mReader( reader ) { ++*this; }
+
+		reference	operator*() const { return mLine; }
+		pointer		operator->() const { return &mLine; }
+		Iterator&	operator++() { if( ! mReader->readLine( &mLine ) ) mReader = nullptr; return *this; }
+		void		operator++( int ) { ++*this; }
+
+		bool	operator==( const Iterator &rhs ) const { return mReader == rhs.mReader; }
+		bool	operator!=( const Iterator &rhs ) const { return mReader != rhs.mReader; }
+
+	  private:
+		LineReader			*mReader;
+		std::string_view	mLine;
+	};
+
+	//! Returns an iterator over the remaining lines. Advancing it consumes them from the stream.
+	Iterator	begin() { return Iterator( this ); }
+	Iterator	end() { return Iterator(); }
+
+ private:
+	IStreamRef		mStream;
+	std::string		mCarry; // holds lines which span a refill of the stream's buffer, and lines read from streams which don't expose one
+};
+
 
 class CI_API IoStream : public IStreamCinder, public OStream {
  public:
@@ -171,6 +225,8 @@ class CI_API IStreamFile : public IStreamCinder {
 	IStreamFile( FILE *aFile, bool aOwnsFile = true, int32_t aDefaultBufferSize = 2048 );
 
 	virtual void		IORead( void *t, size_t size );
+	size_t				IOPeek( const uint8_t **data ) override;
+	void				IOSkip( size_t size ) override;
 	size_t				readDataImpl( void *dest, size_t maxSize );
  
 	FILE						*mFile;
@@ -308,6 +364,8 @@ class CI_API IStreamMem : public IStreamCinder {
  	IStreamMem( const void *aData, size_t aDataSize );
 
 	virtual void	IORead( void *t, size_t size );
+	size_t			IOPeek( const uint8_t **data ) override;
+	void			IOSkip( size_t size ) override;
  
 	const uint8_t	*mData;
 	size_t			mDataSize;
@@ -315,6 +373,48 @@ class CI_API IStreamMem : public IStreamCinder {
 };
 
 
+typedef std::shared_ptr<class MappedFile>	MappedFileRef;
+
+//! A read-only file mapped into memory in its entirety. The OS pages the contents in as they are first touched. Pages are mapped copy-on-write, so writes through getData() stay private to the process and never reach the file.
+class CI_API MappedFile : private Noncopyable {
+ public:
+	//! Maps the file at \a path. Throws StreamExc if it can't be opened or mapped.
+	static MappedFileRef	create( const fs::path &path );
+	~MappedFile();
+
+	//! Returns a pointer to the mapped contents of the file, or \c nullptr if the file is empty
+	void*			getData()				{ return mData; }
+	//! Returns a pointer to the mapped contents of the file, or \c nullptr if the file is empty
+	const void*		getData() const			{ return mData; }
+	//! Returns the size of the file in bytes
+	size_t			getSize() const			{ return mSize; }
+	//! Returns the path of the mapped file
+	const fs::path&	getFilePath() const		{ return mFilePath; }
+
+ protected:
+	MappedFile( const fs::path &path );
+
+	fs::path	mFilePath;
+	void		*mData;
+	size_t		mSize;
+};
+
+typedef std::shared_ptr<class IStreamMapped>	IStreamMappedRef;
+
+//! An IStreamMem which reads from a MappedFile, serving reads straight from the mapped pages rather than through fread(). Keeps the mapping alive for its own lifetime.
+class CI_API IStreamMapped : public IStreamMem {
+ public:
+	static IStreamMappedRef		create( const MappedFileRef &mappedFile );
+
+	//! Returns the MappedFile the stream reads from
+	const MappedFileRef&	getMappedFile() const { return mMappedFile; }
+
+ protected:
+	IStreamMapped( const MappedFileRef &mappedFile );
+
+	MappedFileRef	mMappedFile;
+};
+
 typedef std::shared_ptr<class OStreamMem>		OStreamMemRef;
 
 class CI_API OStreamMem : public OStream {
@@ -360,6 +460,8 @@ CI_API IStreamFileRef	loadFileStream( const fs::path &path );
 CI_API OStreamFileRef	writeFileStream( const fs::path &path, bool createParents = true );
 //! Opens a path for read-write access as a stream.
 CI_API IoStreamFileRef readWriteFileStream( const fs::path &path );
+//! Maps the file located at \a path into memory and opens it for read access as a stream. Returns \c nullptr if the file can't be mapped.
+CI_API IStreamMappedRef	loadFileStreamMapped( const fs::path &path );
 
 //! Loads the contents of a stream into a contiguous block of memory, pointed to by \a resultData. The size of this block is stored in \a resultDataSize.
 CI_API void loadStreamMemory( IStreamRef is, std::shared_ptr<uint8_t> *resultData, size_t *resultDataSize );
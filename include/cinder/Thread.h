@@ -30,10 +30,14 @@
 	#include <objc/objc-auto.h>
 #endif
 
+#include "cinder/Noncopyable.h"
+
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <functional>
+#include <memory>
 
 namespace cinder {
 //! Create an instance of this class at the beginning of any multithreaded code that makes use of Cinder functionality
@@ -51,4 +55,86 @@ class CI_API ThreadSetup {
 #endif
 };
 
+namespace detail {
+class TaskSchedulerImpl;
+struct TaskGroupState;
+} // namespace detail
+
+//! Order in which a TaskScheduler picks up queued tasks. \c HIGH tasks are started ahead of every \c NORMAL one, which suits latency-sensitive work such as preparing the next frame.
+enum class TaskPriority { NORMAL, HIGH };
+
+//! Runs short tasks on a fixed set of worker threads. Each worker keeps its own deque of tasks, running the newest first, and steals the oldest tasks of other workers once it runs dry, so that
+//! recursively spawned work stays on warm caches while idle workers balance the load. Threads waiting on a TaskGroup, including parallelFor() callers, help run tasks rather than blocking.
+//! Tasks should not block on I/O or on each other outside of TaskGroup::wait(), which would hold up a worker; long-lived or blocking work still belongs on its own std::thread.
+class CI_API TaskScheduler : private Noncopyable {
+  public:
+	struct CI_API Options {
+		Options() : mNumThreads( 0 ), mPinThreads( false ) {}
+
+		//! Sets the number of worker threads. A value of \c 0 uses one fewer than the number of hardware cores (but at least one), leaving a core for the thread that waits on the results. Default is \c 0.
+		Options&	numThreads( int numThreads ) { mNumThreads = numThreads; return *this; }
+		//! Sets whether each worker thread is pinned to a single core, in turn. Ignored on platforms without thread affinity support (currently everything but Linux and Windows). Default is \c false.
+		Options&	pinThreads( bool pin = true ) { mPinThreads = pin; return *this; }
+
+		int		getNumThreads() const { return mNumThreads; }
+		bool	getPinThreads() const { return mPinThreads; }
+
+	  private:
+		int		mNumThreads;
+		bool	mPinThreads;
+	};
+
+	//! Starts the worker threads described by \a options.
+	explicit TaskScheduler( const Options &options = Options() );
+	//! Runs every task that is still queued, then joins the worker threads.
+	~TaskScheduler();
+
+	//! Returns the scheduler shared by Cinder's parallel algorithms, created with default Options upon first use.
+	static TaskScheduler*	global();
+
+	//! Returns the number of worker threads.
+	int		getNumThreads() const;
+	//! Returns the index of the calling thread among this scheduler's workers, or \c -1 if it isn't one of them.
+	int		getCurrentThreadIndex() const;
+
+	//! Queues \a fn to run on a worker thread without a way of waiting on it. Exceptions thrown by \a fn are logged. Use a TaskGroup to wait on tasks or to retrieve their exceptions.
+	void	spawn( std::function<void()> fn, TaskPriority priority = TaskPriority::NORMAL );
+
+	//! Calls \a rangeFn( rangeBegin, rangeEnd ) over consecutive chunks of [\a begin, \a end), spread across the workers and the calling thread, and blocks until all of them have completed.
+	//! Chunks hold about \a grainSize indices, or give each thread a few chunks when \a grainSize is \c 0. When \a maxThreads is positive, at most that many threads, including the calling one, take part.
+	//! Rethrows the first exception thrown by \a rangeFn, after which no further chunks are started.
+	void	parallelFor( int64_t begin, int64_t end, const std::function<void( int64_t, int64_t )> &rangeFn, int64_t grainSize = 0, int maxThreads = 0 );
+
+  private:
+	std::unique_ptr<detail::TaskSchedulerImpl>	mImpl;
+
+	friend class TaskGroup;
+};
+
+//! A set of tasks running on a TaskScheduler which can be waited on together. Tasks may add further tasks to the group they belong to, so that recursive fork/join algorithms can be written as
+//! a TaskGroup per level. The destructor waits for any tasks still running.
+class CI_API TaskGroup : private Noncopyable {
+  public:
+	TaskGroup( TaskScheduler *scheduler = TaskScheduler::global() );
+	//! Waits for the group's tasks to complete. Exceptions they threw that were not retrieved through wait() are discarded.
+	~TaskGroup();
+
+	//! Queues \a fn to run on the scheduler as part of this group.
+	void	run( std::function<void()> fn, TaskPriority priority = TaskPriority::NORMAL );
+	//! Blocks until every task of the group has completed, running queued tasks on the calling thread in the meantime. Rethrows the first exception thrown by any of the tasks since the last wait().
+	void	wait();
+	//! Queues \a fn on the scheduler once the group next has no tasks left, whether or not they threw, or right away if it has none now. \a fn is not part of the group.
+	void	then( std::function<void()> fn, TaskPriority priority = TaskPriority::NORMAL );
+	//! Returns whether every task of the group has completed.
+	bool	isDone() const;
+
+  private:
+	TaskGroup( TaskScheduler *scheduler, std::shared_ptr<detail::TaskGroupState> state );
+
+	TaskScheduler							*mScheduler;
+	std::shared_ptr<detail::TaskGroupState>	mState;
+
+	friend class TaskScheduler;
+};
+
 } // namespace cinder
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <vector>
+#include <limits>
 #include "cinder/Vector.h"
 #include "cinder/AxisAlignedBox.h"
 #include "cinder/DataSource.h"
@@ -324,7 +325,7 @@ class CI_API TriMesh : public geom::Source {
 	//! Calculates the bounding box of all vertices as transformed by \a transform. Fails if the positions are not 3D.
 	AxisAlignedBox	calcBoundingBox( const mat4 &transform ) const;
 
-	//! Fills this TriMesh with the data from a binary file, which was created with TriMesh::write().
+	//! Fills this TriMesh with the data from a binary file, which was created with TriMesh::write() or TriMeshCache::write(). Use TriMeshCache directly to render a cache file without copying it into a TriMesh.
 	void		read( const DataSourceRef &dataSource );
 	//! Writes this TriMesh out to a binary data file.
 	void		write( const DataTargetRef &dataTarget ) const { write( dataTarget, ~0u ); }
@@ -333,13 +334,42 @@ class CI_API TriMesh : public geom::Source {
 	//! Writes this TriMesh out to a binary data file. You can specify which attributes to write by supplying a list of \a attribs.
 	void		write( const DataTargetRef &dataTarget, const std::set<geom::Attrib> &attribs ) const;
 
+	/*! The triangles around each vertex of a TriMesh, which recalculateNormals() and recalculateTangents() can reuse for as long as the indices don't change,
+		such as for a mesh that deforms every frame. With \a smooth, vertices at the same position are grouped the way recalculateNormals( true ) groups them,
+		which assumes that they keep sharing their positions as the mesh deforms. */
+	class CI_API Adjacency {
+	  public:
+		Adjacency() : mNumVertices( 0 ), mNumIndices( 0 ), mValid( false ) {}
+		Adjacency( const TriMesh &mesh, bool smooth = false );
+
+		//! Returns whether similar vertices were grouped for smooth normals
+		bool	isSmooth() const { return ! mGroupOffsets.empty(); }
+		//! Returns whether the adjacency was built from valid indices and \a mesh still has as many vertices and indices
+		bool	matches( const TriMesh &mesh ) const { return mValid && mNumVertices == mesh.getNumVertices() && mNumIndices == mesh.getNumIndices(); }
+
+	  private:
+		size_t					mNumVertices, mNumIndices;
+		bool					mValid;
+		// the triangles around vertex v are mTriangles[mOffsets[v]] up to mTriangles[mOffsets[v + 1]], in increasing order
+		std::vector<uint32_t>	mOffsets, mTriangles;
+		// for smooth normals, the vertices of group g are mGroupVertices[mGroupOffsets[g]] up to mGroupVertices[mGroupOffsets[g + 1]]
+		std::vector<uint32_t>	mGroupOffsets, mGroupVertices, mGroupOfVertex;
+
+		friend class TriMesh;
+	};
+
 	/*! Adds or replaces normals by calculating them from the vertices and faces. If \a smooth is TRUE,
 		similar vertices are grouped together to calculate their average. This will not change the mesh,
 		nor will it affect texture mapping. If \a weighted is TRUE, larger polygons contribute more to
-		the calculated normal. Renormalization requires 3D vertices. */
+		the calculated normal. Renormalization requires 3D vertices. Runs across all cores. */
 	bool		recalculateNormals( bool smooth = false, bool weighted = false );
-	//! Adds or replaces tangents by calculating them from the normals and texture coordinates. Requires 3D normals and 2D texture coordinates.
+	/*! Adds or replaces normals like recalculateNormals( bool, bool ), reusing \a adjacency and smoothing if it is smooth. Face normals and their sums per vertex
+		are computed in bands on up to \a numThreads threads, or without a limit for \c 0, adding up in the same order for any count. Returns \c false if \a adjacency doesn't match the mesh. */
+	bool		recalculateNormals( const Adjacency &adjacency, bool weighted = false, int numThreads = 0 );
+	//! Adds or replaces tangents by calculating them from the normals and texture coordinates. Requires 3D normals and 2D texture coordinates. Runs across all cores.
 	bool		recalculateTangents();
+	//! Adds or replaces tangents like recalculateTangents(), reusing \a adjacency. Triangle tangents are gathered per vertex and orthogonalized on up to \a numThreads threads, or without a limit for \c 0.
+	bool		recalculateTangents( const Adjacency &adjacency, int numThreads = 0 );
 	//! Adds or replaces bitangents by calculating them from the normals and tangents. Requires 3D normals and tangents.
 	bool		recalculateBitangents();
 
@@ -347,6 +377,63 @@ class CI_API TriMesh : public geom::Source {
 		Optionally, vertices are normalized if \a normalize is TRUE. */
 	void		subdivide( int division = 2, bool normalize = false );
 
+	//! Post-transform vertex cache statistics of the indices, as returned by analyzeVertexCache()
+	struct VertexCacheStats {
+		size_t	numTransformed;	//!< Number of vertices transformed, which is the number of cache misses
+		float	acmr;			//!< Average cache miss ratio: vertices transformed per triangle, ranging from about 0.5 at best to 3
+		float	atvr;			//!< Average transform to vertex ratio: vertices transformed per referenced vertex, 1 at best
+	};
+
+	/*! Merges vertices whose attributes all lie within \a tolerance of each other per component, finding candidates through a spatial hash of the positions.
+		A \a tolerance of 0 merges identical vertices only. Merged vertices keep the attributes of the vertex with the lowest index. Triangles that become degenerate are kept.
+		Returns the number of vertices removed. */
+	size_t		weldVertices( float tolerance = 0 );
+	//! Reorders the triangles for the locality of a post-transform vertex cache of \a cacheSize vertices, using Tipsify. Neither the vertices nor the winding of the triangles change.
+	void		optimizeVertexCache( uint32_t cacheSize = 16 );
+	/*! Reorders clusters of triangles so that those facing away from the center of the mesh come first, which reduces overdraw. Call it after optimizeVertexCache(): clusters end where the cache is flushed
+		or where their own cache miss ratio is within \a threshold times that of the surrounding run of triangles, which bounds the loss of vertex cache locality. Requires 3D positions. */
+	bool		optimizeOverdraw( float threshold = 1.05f, uint32_t cacheSize = 16 );
+	//! Reorders the vertices in the order the indices first reference them, remapping every attribute, and removes unreferenced vertices. Returns the number of vertices removed.
+	size_t		optimizeVertexFetch();
+	//! Simulates a FIFO post-transform vertex cache of \a cacheSize vertices over the indices
+	VertexCacheStats	analyzeVertexCache( uint32_t cacheSize = 16 ) const;
+
+	//! Options for simplify() and generateLods()
+	class CI_API SimplifyOptions {
+	  public:
+		SimplifyOptions() : mTargetError( std::numeric_limits<float>::max() ), mNormalWeight( 0.01f ), mTexCoordWeight( 0.01f ), mColorWeight( 0.01f ), mLockBorders( false ) {}
+
+		//! Stops simplifying before any collapse whose error exceeds \a error, relative to the largest extent of the mesh's bounds. Unlimited by default.
+		SimplifyOptions&	targetError( float error ) { mTargetError = error; return *this; }
+		//! Sets the error of a unit of difference between normals, relative to the largest extent of the mesh's bounds. Defaults to \c 0.01, and \c 0 ignores normals.
+		SimplifyOptions&	normalWeight( float weight ) { mNormalWeight = weight; return *this; }
+		//! Sets the error of a unit of difference between texture coordinates of unit 0. Defaults to \c 0.01.
+		SimplifyOptions&	texCoordWeight( float weight ) { mTexCoordWeight = weight; return *this; }
+		//! Sets the error of a unit of difference between colors. Defaults to \c 0.01.
+		SimplifyOptions&	colorWeight( float weight ) { mColorWeight = weight; return *this; }
+		//! Keeps the vertices on the open borders of the mesh in place. By default, border vertices only collapse along the border.
+		SimplifyOptions&	lockBorders( bool lock = true ) { mLockBorders = lock; return *this; }
+
+		float	getTargetError() const { return mTargetError; }
+		float	getNormalWeight() const { return mNormalWeight; }
+		float	getTexCoordWeight() const { return mTexCoordWeight; }
+		float	getColorWeight() const { return mColorWeight; }
+		bool	getLockBorders() const { return mLockBorders; }
+
+	  private:
+		float	mTargetError, mNormalWeight, mTexCoordWeight, mColorWeight;
+		bool	mLockBorders;
+	};
+
+	/*! Removes triangles by collapsing edges in the order of the quadric error of their positions and of their normals, texture coordinates and colors, until at most \a targetTriangles remain
+		or no collapse is within the target error of \a options. Vertices that share a position collapse together and onto vertices at one position, so attribute seams stay closed
+		and collapse only along themselves. Unreferenced vertices are removed, and triangles with two corners at one position are dropped. Requires 3D positions.
+		Returns the largest error of a collapse, relative to the largest extent of the mesh's bounds. */
+	float					simplify( size_t targetTriangles, const SimplifyOptions &options = SimplifyOptions() );
+	/*! Returns a simplified copy of the mesh for each of \a targetTriangles, which should be decreasing, as simplify() would make them. The levels come from a single pass
+		in which each continues from the one before. Fills \a errors, if given, with the error of each level. */
+	std::vector<TriMesh>	generateLods( const std::vector<size_t> &targetTriangles, const SimplifyOptions &options = SimplifyOptions(), std::vector<float> *errors = nullptr ) const;
+
 	//! Create TriMesh from vectors of vertex data.
 /*	static TriMesh		create( std::vector<uint32_t> &indices, const std::vector<ColorAf> &colors,
 							   const std::vector<vec3> &normals, const std::vector<vec3> &positions,
@@ -366,6 +453,8 @@ class CI_API TriMesh : public geom::Source {
 
 	//! Returns whether or not the vertex, color etc. at both indices is the same.
 	bool		verticesEqual( uint32_t indexA, uint32_t indexB ) const;
+	//! Moves the attributes of each vertex \a v to \a remap[v], dropping the vertex if it's \c 0xFFFFFFFF. Where several vertices share a target, the one with the lowest index wins.
+	void		remapVertices( const std::vector<uint32_t> &remap, size_t numVertices );
 
 	void		readImplV2( const IStreamRef &in );
 	void		readImplV1( const IStreamRef &in );
@@ -0,0 +1,128 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/AxisAlignedBox.h"
+#include "cinder/Ray.h"
+#include "cinder/Sphere.h"
+#include "cinder/TriMesh.h"
+
+#include <limits>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class TriMeshBvh>		TriMeshBvhRef;
+
+/*! A bounding volume hierarchy over the triangles of a TriMesh, for picking and collision queries that don't visit every triangle.
+	The hierarchy is built top-down with a binned surface area heuristic and flattened into an array of nodes with four children each, whose bounds are stored as four-wide arrays so that a query tests all of them at once.
+	The triangles are copied in leaf order, so the mesh doesn't need to outlive the hierarchy, and refit() updates the bounds of a deforming mesh without rebuilding. Queries are const and can run concurrently. */
+class CI_API TriMeshBvh {
+  public:
+	class CI_API Options {
+	  public:
+		Options() : mMaxLeafTriangles( 4 ), mNumThreads( 0 ) {}
+
+		//! Sets the largest number of triangles in a leaf. Smaller leaves are made wherever the surface area heuristic favors them. Defaults to \c 4.
+		Options&	maxLeafTriangles( uint32_t count ) { mMaxLeafTriangles = std::max<uint32_t>( 1, count ); return *this; }
+		//! Limits the threads that bin triangles during the build and recompute bounds in refit(), or leaves it to the scheduler for \c 0. The same hierarchy results either way. Defaults to \c 0.
+		Options&	numThreads( int numThreads ) { mNumThreads = numThreads; return *this; }
+
+		uint32_t	getMaxLeafTriangles() const { return mMaxLeafTriangles; }
+		int			getNumThreads() const { return mNumThreads; }
+
+	  private:
+		uint32_t	mMaxLeafTriangles;
+		int			mNumThreads;
+	};
+
+	//! The result of calcIntersection() and calcClosestPoint()
+	struct Hit {
+		//! The index of the triangle in the mesh
+		uint32_t	triangle;
+		//! For intersections the distance along the ray in multiples of its direction, as Ray::calcTriangleIntersection() returns it. For closest points the distance to the query point.
+		float		distance;
+		//! The point on the triangle
+		vec3		position;
+		//! The barycentric coordinates of \a position for the triangle's second and third vertices
+		vec2		barycentric;
+	};
+
+	//! A node of the hierarchy. Its four children are stored as arrays of each coordinate of their bounds, followed by where they lead.
+	struct alignas( 16 ) Node {
+		//! The minimum x, y and z of the bounds of each child. Unused children have empty bounds, whose minimum is above their maximum.
+		float		min[3][4];
+		//! The maximum x, y and z of the bounds of each child
+		float		max[3][4];
+		//! The index in getNodes() of each internal child, or the index in getTriangleIds() of the first triangle of each leaf child. \c 0 for unused children.
+		uint32_t	children[4];
+		//! The number of triangles of each leaf child, or \c 0 for internal and unused children
+		uint32_t	numTriangles[4];
+	};
+
+	//! Creates an empty hierarchy, which no query hits
+	TriMeshBvh() {}
+	//! Builds the hierarchy over the triangles of \a mesh. A mesh without 3D positions results in an empty hierarchy.
+	explicit TriMeshBvh( const TriMesh &mesh, const Options &options = Options() );
+	//! Builds the hierarchy over the \a numTriangles triangles of \a indices, which index \a numPositions \a positions. Throws ci::Exception for an index out of range.
+	TriMeshBvh( const vec3 *positions, size_t numPositions, const uint32_t *indices, size_t numTriangles, const Options &options = Options() );
+
+	static TriMeshBvhRef	create( const TriMesh &mesh, const Options &options = Options() ) { return TriMeshBvhRef( new TriMeshBvh( mesh, options ) ); }
+
+	//! Returns whether \a ray hits a triangle within \a maxDistance, in multiples of its direction, and fills \a hit with the closest one. Both sides of a triangle are hit, while triangles behind the ray's origin are not.
+	bool	calcIntersection( const Ray &ray, Hit *hit, float maxDistance = std::numeric_limits<float>::max() ) const;
+	//! Returns whether \a ray hits any triangle within \a maxDistance, in multiples of its direction, stopping at the first one found. Cheaper than calcIntersection() for visibility and shadow tests.
+	bool	intersects( const Ray &ray, float maxDistance = std::numeric_limits<float>::max() ) const;
+	//! Replaces the contents of \a triangles with the indices of the triangles that overlap \a box, in no particular order
+	void	calcOverlaps( const AxisAlignedBox &box, std::vector<uint32_t> *triangles ) const;
+	//! Replaces the contents of \a triangles with the indices of the triangles that overlap \a sphere, in no particular order
+	void	calcOverlaps( const Sphere &sphere, std::vector<uint32_t> *triangles ) const;
+	//! Returns whether a triangle lies within \a maxDistance of \a point, and fills \a hit with the closest point on the mesh
+	bool	calcClosestPoint( const vec3 &point, Hit *hit, float maxDistance = std::numeric_limits<float>::max() ) const;
+
+	//! Updates the hierarchy to the positions of \a mesh, whose indices must be those it was built from. Queries stay fast as long as the deformation keeps neighboring triangles close.
+	void	refit( const TriMesh &mesh, int numThreads = 0 );
+	//! Updates the hierarchy to \a numPositions \a positions, indexed by the triangles it was built from. Throws ci::Exception when an index is out of range.
+	void	refit( const vec3 *positions, size_t numPositions, int numThreads = 0 );
+
+	//! Returns the bounds of all triangles, which are empty for an empty hierarchy
+	AxisAlignedBox				getBounds() const;
+	size_t						getNumTriangles() const { return mTriangleIds.size(); }
+	//! Returns the nodes, the first of which is the root
+	const std::vector<Node>&	getNodes() const { return mNodes; }
+	//! Returns the index in the mesh of each triangle, in the order of the leaves
+	const std::vector<uint32_t>&	getTriangleIds() const { return mTriangleIds; }
+
+  private:
+	void	build( const vec3 *positions, size_t numPositions, const uint32_t *indices, size_t numTriangles, const Options &options );
+
+	std::vector<Node>		mNodes;
+	std::vector<uint32_t>	mTriangleIds;
+	//! The indices of each triangle, in leaf order
+	std::vector<uint32_t>	mIndices;
+	//! The three vertices of each triangle, in leaf order
+	std::vector<vec3>		mVertices;
+};
+
+} // namespace cinder
@@ -0,0 +1,106 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Buffer.h"
+#include "cinder/DataSource.h"
+#include "cinder/DataTarget.h"
+#include "cinder/Exception.h"
+#include "cinder/GeomIo.h"
+
+namespace cinder {
+
+typedef std::shared_ptr<class TriMeshCache>		TriMeshCacheRef;
+
+/*! A read-only geom::Source over a binary mesh cache file written by TriMeshCache::write(), which is also what TriMesh::read() loads as version 3.
+	The file holds a header, a table of blocks and the blocks themselves: the indices and one block of tightly packed floats per attribute, each starting at a 64-byte aligned offset.
+	Uncompressed blocks are used in place, so a cache loaded from a memory mapped DataSourcePath doesn't copy any attribute until loadInto() hands it on; only compressed blocks are inflated on load.
+	Data is stored in little-endian byte order. */
+class CI_API TriMeshCache : public geom::Source {
+  public:
+	class CI_API Options {
+	  public:
+		Options() : mCompressionLevel( 0 ), mAllAttribs( true ) {}
+
+		//! Compresses each block with zlib at \a level (1 - 9) when that makes it smaller. Defaults to \c 0, which stores every block uncompressed so that it can be used in place.
+		Options&	compressionLevel( int8_t level ) { mCompressionLevel = level; return *this; }
+		//! Restricts the written attributes to \a attribs. By default all of the source's available attributes are written.
+		Options&	attribs( const geom::AttribSet &attribs ) { mAttribs = attribs; mAllAttribs = false; return *this; }
+
+		int8_t					getCompressionLevel() const { return mCompressionLevel; }
+		bool					getAllAttribs() const { return mAllAttribs; }
+		const geom::AttribSet&	getAttribs() const { return mAttribs; }
+
+	  private:
+		int8_t			mCompressionLevel;
+		bool			mAllAttribs;
+		geom::AttribSet	mAttribs;
+	};
+
+	//! Loads the cache file \a dataSource. Keeps the DataSource's Buffer, which for a DataSourcePath is a view of the memory mapped file, alive for the lifetime of the TriMeshCache and its clones. Throws TriMeshCacheExc if the file is invalid.
+	static TriMeshCacheRef	create( const DataSourceRef &dataSource ) { return TriMeshCacheRef( new TriMeshCache( dataSource ) ); }
+	//! Writes \a source to \a dataTarget as a cache file. Non-indexed sources are stored without indices.
+	static void				write( const DataTargetRef &dataTarget, const geom::Source &source, const Options &options = Options() );
+
+	TriMeshCache( const DataSourceRef &dataSource );
+
+	//! Returns the tightly packed data of \a attr, or \c nullptr if the cache doesn't contain it
+	const float*		getAttribData( geom::Attrib attr ) const { return attr < geom::NUM_ATTRIBS ? mAttribData[attr] : nullptr; }
+	//! Returns the indices, or \c nullptr if the cache is non-indexed
+	const uint32_t*		getIndices() const { return mIndices; }
+	//! Returns the Buffer holding the file
+	const BufferRef&	getBuffer() const { return mBuffer; }
+
+	// geom::Source virtuals
+	size_t				getNumVertices() const override { return mNumVertices; }
+	size_t				getNumIndices() const override { return mNumIndices; }
+	geom::Primitive		getPrimitive() const override { return mPrimitive; }
+	uint8_t				getAttribDims( geom::Attrib attr ) const override { return attr < geom::NUM_ATTRIBS ? mAttribDims[attr] : 0; }
+	geom::AttribSet		getAvailableAttribs() const override;
+	void				loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const override;
+	geom::Source*		clone() const override { return new TriMeshCache( *this ); }
+
+	//! The version number stored in the first byte of cache files, following TriMesh::write()'s versions 1 and 2
+	static const uint8_t	VERSION = 3;
+
+  private:
+	BufferRef			mBuffer;
+	//! Storage of the blocks that were compressed in the file
+	std::vector<std::shared_ptr<uint32_t[]>>	mInflatedBlocks;
+
+	size_t				mNumVertices, mNumIndices;
+	geom::Primitive		mPrimitive;
+	const uint32_t		*mIndices;
+	uint8_t				mAttribDims[geom::NUM_ATTRIBS];
+	const float			*mAttribData[geom::NUM_ATTRIBS];
+};
+
+class CI_API TriMeshCacheExc : public Exception {
+  public:
+	TriMeshCacheExc( const std::string &description )
+		: Exception( description )
+	{}
+};
+
+} // namespace cinder
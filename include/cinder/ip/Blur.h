@@ -66,4 +66,44 @@ CI_API void			stackBlur( Channel32f *channel, const Area &area, int radius );
 //! Create a blurred copy of \a channel using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
 CI_API Channel32f	stackBlurCopy( const Channel32f &channel, int radius );
 
+//! Blur \a surface in-place with a box filter spanning \a radius pixels to either side. A fractional \a radius partially weights the outermost pixels. The cost per pixel is independent of \a radius.
+template<typename T>
+CI_API void			boxBlur( SurfaceT<T> *surface, float radius );
+//! Blur \a surface in-place in \a area with a box filter spanning \a radius pixels to either side. The cost per pixel is independent of \a radius.
+template<typename T>
+CI_API void			boxBlur( SurfaceT<T> *surface, const Area &area, float radius );
+//! Create a copy of \a surface blurred with a box filter spanning \a radius pixels to either side. The cost per pixel is independent of \a radius.
+template<typename T>
+CI_API SurfaceT<T>	boxBlurCopy( const SurfaceT<T> &surface, float radius );
+
+//! Blur \a channel in-place with a box filter spanning \a radius pixels to either side. A fractional \a radius partially weights the outermost pixels. The cost per pixel is independent of \a radius.
+template<typename T>
+CI_API void			boxBlur( ChannelT<T> *channel, float radius );
+//! Blur \a channel in-place in \a area with a box filter spanning \a radius pixels to either side. The cost per pixel is independent of \a radius.
+template<typename T>
+CI_API void			boxBlur( ChannelT<T> *channel, const Area &area, float radius );
+//! Create a copy of \a channel blurred with a box filter spanning \a radius pixels to either side. The cost per pixel is independent of \a radius.
+template<typename T>
+CI_API ChannelT<T>	boxBlurCopy( const ChannelT<T> &channel, float radius );
+
+//! Blur \a surface in-place with a Gaussian of standard deviation \a sigma, approximated by three extended box filters. The cost per pixel is independent of \a sigma.
+template<typename T>
+CI_API void			gaussianBlur( SurfaceT<T> *surface, float sigma );
+//! Blur \a surface in-place in \a area with a Gaussian of standard deviation \a sigma, approximated by three extended box filters. The cost per pixel is independent of \a sigma.
+template<typename T>
+CI_API void			gaussianBlur( SurfaceT<T> *surface, const Area &area, float sigma );
+//! Create a copy of \a surface blurred with a Gaussian of standard deviation \a sigma, approximated by three extended box filters. The cost per pixel is independent of \a sigma.
+template<typename T>
+CI_API SurfaceT<T>	gaussianBlurCopy( const SurfaceT<T> &surface, float sigma );
+
+//! Blur \a channel in-place with a Gaussian of standard deviation \a sigma, approximated by three extended box filters. The cost per pixel is independent of \a sigma.
+template<typename T>
+CI_API void			gaussianBlur( ChannelT<T> *channel, float sigma );
+//! Blur \a channel in-place in \a area with a Gaussian of standard deviation \a sigma, approximated by three extended box filters. The cost per pixel is independent of \a sigma.
+template<typename T>
+CI_API void			gaussianBlur( ChannelT<T> *channel, const Area &area, float sigma );
+//! Create a copy of \a channel blurred with a Gaussian of standard deviation \a sigma, approximated by three extended box filters. The cost per pixel is independent of \a sigma.
+template<typename T>
+CI_API ChannelT<T>	gaussianBlurCopy( const ChannelT<T> &channel, float sigma );
+
 } } // namespace cinder::ip
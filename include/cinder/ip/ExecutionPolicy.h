@@ -0,0 +1,88 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Noncopyable.h"
+
+#include <functional>
+
+namespace cinder { namespace ip {
+
+//! Describes how the ip:: functions distribute their work across threads and whether they use SIMD kernels. The default policy runs serially on the calling thread, using the widest SIMD instruction set the CPU supports.
+class CI_API ExecutionPolicy {
+  public:
+	ExecutionPolicy() : mNumThreads( 1 ), mMinRowsPerTask( 16 ), mSimd( true ) {}
+
+	//! Returns a policy which runs every ip:: function serially on the calling thread.
+	static ExecutionPolicy	serial() { return ExecutionPolicy(); }
+	//! Returns a policy which splits the processed Area into row bands executed across up to \a numThreads threads. A value of \c 0 uses one thread per hardware core.
+	//! Bands run on TaskScheduler::global(), so no more threads take part than its workers plus the calling thread.
+	static ExecutionPolicy	parallel( int numThreads = 0 ) { return ExecutionPolicy().numThreads( numThreads ); }
+
+	//! Sets the maximum number of threads, including the calling thread, that participate in an ip:: function. A value of \c 0 uses one thread per hardware core.
+	ExecutionPolicy&	numThreads( int numThreads ) { mNumThreads = numThreads; return *this; }
+	//! Sets the minimum number of rows (or columns) assigned to a single band, so that small images are not split into bands that cost more to schedule than to process. Default is \c 16.
+	ExecutionPolicy&	minRowsPerTask( int rows ) { mMinRowsPerTask = rows; return *this; }
+	//! Sets whether ip:: functions may use SIMD kernels selected at runtime (SSE2, AVX2 or NEON). Disabling this forces the scalar code paths. Default is \c true.
+	ExecutionPolicy&	simd( bool enable = true ) { mSimd = enable; return *this; }
+
+	//! Returns the number of threads this policy will use, resolving \c 0 to the number of hardware cores.
+	int		getNumThreads() const;
+	//! Returns the minimum number of rows (or columns) assigned to a single band.
+	int		getMinRowsPerTask() const { return mMinRowsPerTask; }
+	//! Returns whether this policy runs on the calling thread alone.
+	bool	isSerial() const { return getNumThreads() <= 1; }
+	//! Returns whether ip:: functions may use SIMD kernels.
+	bool	isSimdEnabled() const { return mSimd; }
+
+  private:
+	int		mNumThreads;
+	int		mMinRowsPerTask;
+	bool	mSimd;
+};
+
+//! Returns the ExecutionPolicy used by ip:: functions invoked from the current thread.
+CI_API const ExecutionPolicy&	getExecutionPolicy();
+//! Sets the ExecutionPolicy used by ip:: functions invoked from the current thread.
+CI_API void						setExecutionPolicy( const ExecutionPolicy &policy );
+
+//! Sets the ExecutionPolicy of the current thread for the lifetime of the object, restoring the previous policy upon destruction.
+class CI_API ScopedExecutionPolicy : private Noncopyable {
+  public:
+	ScopedExecutionPolicy( const ExecutionPolicy &policy );
+	~ScopedExecutionPolicy();
+
+  private:
+	ExecutionPolicy		mPreviousPolicy;
+};
+
+namespace detail {
+
+//! Splits [\a begin, \a end) into contiguous bands according to the current ExecutionPolicy and calls \a bandFn( bandBegin, bandEnd ) for each on TaskScheduler::global(), blocking until all bands have completed. Bands run on the calling thread when the policy is serial.
+CI_API void parallelBands( int32_t begin, int32_t end, const std::function<void( int32_t, int32_t )> &bandFn );
+
+} // namespace detail
+
+} } // namespace cinder::ip
@@ -0,0 +1,105 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Channel.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/Area.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace cinder { namespace ip {
+
+//! Summed-area table of a Channel, which returns the sum, mean or variance of any rectangle in constant time. A single table can be shared by adaptiveThreshold(), boxFilter() and localContrastNormalize().
+/** Sums are accumulated in 32 bits for 8-bit channels, which is exact for rectangles of up to 16 million pixels, in 64 bits for 16-bit channels and in double precision for float channels. **/
+template<typename T>
+class CI_API IntegralImageT {
+  public:
+	typedef typename std::conditional<std::is_same<T,uint8_t>::value, uint32_t,
+				typename std::conditional<std::is_same<T,uint16_t>::value, uint64_t, double>::type>::type	SumT;
+	typedef typename std::conditional<std::is_integral<T>::value, uint64_t, double>::type						SumSquaresT;
+
+	IntegralImageT() : mWidth( 0 ), mHeight( 0 ), mHasSquares( false ) {}
+	//! Builds the table of \a channel in a single pass. The sums of squares required by getVariance() are only accumulated when \a squares is \c true.
+	IntegralImageT( const ChannelT<T> &channel, bool squares = false );
+
+	//! Rebuilds the table from \a channel, reusing the existing storage when its size is unchanged.
+	void	update( const ChannelT<T> &channel );
+	//! Updates the table after the pixels of \a channel inside \a area have changed. Only the entries below and to the right of the upper-left corner of \a area are recomputed.
+	void	update( const ChannelT<T> &channel, const Area &area );
+
+	int32_t		getWidth() const { return mWidth; }
+	int32_t		getHeight() const { return mHeight; }
+	ivec2		getSize() const { return ivec2( mWidth, mHeight ); }
+	Area		getBounds() const { return Area( 0, 0, mWidth, mHeight ); }
+	//! Returns whether the table holds the sums of squares required by getSumSquares() and getVariance().
+	bool		hasSquares() const { return mHasSquares; }
+
+	//! Returns the sum of the pixels inside \a area, clipped to the bounds of the image.
+	SumT		getSum( const Area &area ) const;
+	//! Returns the sum of the squared pixels inside \a area, clipped to the bounds of the image. Requires a table built with squares.
+	SumSquaresT	getSumSquares( const Area &area ) const;
+	//! Returns the mean of the pixels inside \a area, clipped to the bounds of the image, or \c 0 if the clipped area is empty.
+	double		getMean( const Area &area ) const;
+	//! Returns the variance of the pixels inside \a area, clipped to the bounds of the image, or \c 0 if the clipped area is empty. Requires a table built with squares.
+	double		getVariance( const Area &area ) const;
+
+	//! Returns the table, whose entry at ( \a x, \a y ) holds the sum of the pixels in [0,x) x [0,y). Rows hold getWidth() + 1 entries and there are getHeight() + 1 rows.
+	const SumT*			getSums() const { return mSums.data(); }
+	//! Returns the table of sums of squares, laid out as getSums(), or \c nullptr when the table was built without squares.
+	const SumSquaresT*	getSumsSquares() const { return mHasSquares ? mSquares.data() : nullptr; }
+	//! Returns the number of entries in each row of the tables.
+	size_t				getStride() const { return (size_t)mWidth + 1; }
+
+  private:
+	void	accumulate( const ChannelT<T> &channel, int32_t x1, int32_t y1 );
+
+	int32_t						mWidth, mHeight;
+	bool						mHasSquares;
+	std::vector<SumT>			mSums;
+	std::vector<SumSquaresT>	mSquares;
+};
+
+typedef IntegralImageT<uint8_t>		IntegralImage;
+typedef IntegralImageT<uint8_t>		IntegralImage8u;
+typedef IntegralImageT<uint16_t>	IntegralImage16u;
+typedef IntegralImageT<float>		IntegralImage32f;
+
+//! Sets each pixel of \a dstChannel to the mean of the pixels of \a integralImage within \a windowSize / 2 pixels of it horizontally and vertically. Only pixels inside the image are averaged at the borders. The cost per pixel is independent of \a windowSize.
+template<typename T>
+CI_API void boxFilter( const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel );
+//! Sets each pixel of \a dstChannel to the mean of the pixels of \a srcChannel within \a windowSize / 2 pixels of it horizontally and vertically. Only pixels inside the image are averaged at the borders.
+template<typename T>
+CI_API void boxFilter( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel );
+
+//! Sets each pixel of \a dstChannel to the number of standard deviations \a srcChannel differs from the mean of the window within \a windowSize / 2 pixels of it. \a integralImage must be built from \a srcChannel with squares. The standard deviation is clamped to at least \a minStdDev, expressed as a fraction of the channel's full range, so flat regions are not amplified into noise.
+template<typename T>
+CI_API void localContrastNormalize( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, Channel32f *dstChannel, float minStdDev = 1 / 255.0f );
+//! Sets each pixel of \a dstChannel to the number of standard deviations \a srcChannel differs from the mean of the window within \a windowSize / 2 pixels of it. The standard deviation is clamped to at least \a minStdDev, expressed as a fraction of the channel's full range.
+template<typename T>
+CI_API void localContrastNormalize( const ChannelT<T> &srcChannel, int32_t windowSize, Channel32f *dstChannel, float minStdDev = 1 / 255.0f );
+
+} } // namespace cinder::ip
@@ -25,6 +25,9 @@
 #include "cinder/Surface.h"
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
+#include "cinder/Exception.h"
+
+#include <memory>
 
 namespace cinder { namespace ip {
 
@@ -40,4 +43,45 @@ CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcAre
 template<typename T>
 CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter = FilterTriangle() );
 
+//! Precomputed filter weights for repeatedly resizing images of one size to another, as when scaling every frame of a video stream. The weights of a channel type are built the first time the plan
+//! executes with it, after which executing performs no heap allocation once each participating thread has run it once. Copies share the same weights.
+class CI_API ResizePlan {
+  public:
+	ResizePlan() {}
+	//! Creates a plan which resizes all of a \a srcSize image into all of a \a dstSize image using \a filter.
+	ResizePlan( const ivec2 &srcSize, const ivec2 &dstSize, const FilterBase &filter = FilterTriangle() );
+	//! Creates a plan which resizes the area \a srcArea of a \a srcSize image into the area \a dstArea of a \a dstSize image using \a filter.
+	ResizePlan( const ivec2 &srcSize, const Area &srcArea, const ivec2 &dstSize, const Area &dstArea, const FilterBase &filter = FilterTriangle() );
+
+	//! Resizes \a srcSurface into \a dstSurface, which must match the sizes the plan was created with. The alpha channel is only written when both Surfaces have one.
+	template<typename T>
+	void	execute( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const;
+	//! Resizes \a srcChannel into \a dstChannel, which must match the sizes the plan was created with.
+	template<typename T>
+	void	execute( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel ) const;
+
+	//! Returns the size of the source images this plan accepts.
+	ivec2	getSrcSize() const;
+	//! Returns the size of the destination images this plan accepts.
+	ivec2	getDstSize() const;
+	//! Returns the destination area written by execute(), after clipping to both images.
+	Area	getDstArea() const;
+	//! Returns whether the plan writes no pixels, either because it was default constructed or because its areas clip away entirely.
+	bool	isEmpty() const;
+
+	class CI_API Exception : public cinder::Exception {
+	  public:
+		Exception( const std::string &description ) : cinder::Exception( description ) {}
+	};
+
+  private:
+	struct Obj;
+
+	template<typename T>
+	void	resample( const ChannelT<T> * const *srcChannels, ChannelT<T> * const *dstChannels, size_t numChannels ) const;
+	void	checkSizes( const ivec2 &srcSize, const ivec2 &dstSize ) const;
+
+	std::shared_ptr<const Obj>	mObj;
+};
+
 } } // namespace cinder::ip
@@ -24,6 +24,7 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Surface.h"
+#include "cinder/ip/IntegralImage.h"
 
 #include <vector>
 
@@ -56,24 +57,25 @@ CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize );
 
 template<typename T>
 CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel );
+//! Thresholds \a srcChannel using an adaptive thresholding algorithm which considers a window of size \a windowSize pixels and stores the result in \a dstChannel, reusing \a integralImage, which must have been built from \a srcChannel.
+template<typename T>
+CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel );
+//! Equivalent to adaptiveThreshold() with a 0 for percentageDelta, reusing \a integralImage, which must have been built from \a srcChannel.
+template<typename T>
+CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel );
 
 template<typename T>
 class CI_API AdaptiveThresholdT {
   public:
-	AdaptiveThresholdT()	{}
+	AdaptiveThresholdT()	: mChannel( nullptr ) {}
 	//! Uses \a channel as source, but not assume ownership
 	AdaptiveThresholdT( const ChannelT<T> *channel );
 
 	void calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel );
 
  private:
-	typedef typename CHANTRAIT<T>::Accum SUMT;
-
 	const ChannelT<T>*	mChannel;
-	int32_t				mImageWidth;
-	int32_t				mImageHeight;
-	uint8_t				mIncrement;
-	std::vector<SUMT>	mIntegralImage;
+	IntegralImageT<T>	mIntegralImage;
 };
 
 typedef AdaptiveThresholdT<uint8_t>		AdaptiveThreshold;
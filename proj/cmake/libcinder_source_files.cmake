@@ -9,6 +9,7 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Area.cpp
 	${CINDER_SRC_DIR}/cinder/BandedMatrix.cpp
 	${CINDER_SRC_DIR}/cinder/Base64.cpp
+	${CINDER_SRC_DIR}/cinder/BatchImageLoader.cpp
 	${CINDER_SRC_DIR}/cinder/BSpline.cpp
 	${CINDER_SRC_DIR}/cinder/BSplineFit.cpp
 	${CINDER_SRC_DIR}/cinder/Buffer.cpp
@@ -37,6 +38,7 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/ImageTargetFileQoi.cpp
 	${CINDER_SRC_DIR}/cinder/Json.cpp
 	${CINDER_SRC_DIR}/cinder/Log.cpp
+	${CINDER_SRC_DIR}/cinder/LogDeferred.cpp
 	${CINDER_SRC_DIR}/cinder/Matrix.cpp
 	${CINDER_SRC_DIR}/cinder/MediaTime.cpp
 	${CINDER_SRC_DIR}/cinder/ObjLoader.cpp
@@ -58,8 +60,11 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Timeline.cpp
 	${CINDER_SRC_DIR}/cinder/TimelineItem.cpp
 	${CINDER_SRC_DIR}/cinder/Timer.cpp
+	${CINDER_SRC_DIR}/cinder/Thread.cpp
 	${CINDER_SRC_DIR}/cinder/Triangulate.cpp
 	${CINDER_SRC_DIR}/cinder/TriMesh.cpp
+	${CINDER_SRC_DIR}/cinder/TriMeshCache.cpp
+	${CINDER_SRC_DIR}/cinder/TriMeshBvh.cpp
 	${CINDER_SRC_DIR}/cinder/Tween.cpp
 	${CINDER_SRC_DIR}/cinder/Unicode.cpp
 	${CINDER_SRC_DIR}/cinder/Url.cpp
@@ -194,8 +199,10 @@ list( APPEND SRC_SET_CINDER_IP
 	${CINDER_SRC_DIR}/cinder/ip/Premultiply.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Threshold.cpp
 	${CINDER_SRC_DIR}/cinder/ip/EdgeDetect.cpp
+	${CINDER_SRC_DIR}/cinder/ip/ExecutionPolicy.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Flip.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Hdr.cpp
+	${CINDER_SRC_DIR}/cinder/ip/IntegralImage.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Resize.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Trim.cpp
 )
@@ -0,0 +1,252 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/BatchImageLoader.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace std;
+
+namespace cinder {
+
+struct BatchImageLoader::Job {
+	Job( RequestId id, const fs::path &path, int priority )
+		: mId( id ), mPath( path ), mPriority( priority ), mStarted( false ), mCancelled( false ), mQueuedTimer( true )
+	{}
+
+	RequestId			mId;
+	fs::path			mPath;
+	int					mPriority;
+	bool				mStarted; // guarded by BatchImageLoader::mMutex
+	std::atomic<bool>	mCancelled;
+	Timer				mQueuedTimer;
+	std::promise<Result>	mPromise;
+};
+
+BatchImageLoader::BatchImageLoader( const Options &options )
+	: mOptions( options ), mNextId( 1 ), mBytesInFlight( 0 ), mQuit( false )
+{
+	int numThreads = options.getNumThreads();
+	if( numThreads <= 0 )
+		numThreads = std::max<int>( 1, std::thread::hardware_concurrency() );
+
+	for( int t = 0; t < numThreads; ++t )
+		mThreads.emplace_back( &BatchImageLoader::threadEntry, this );
+}
+
+BatchImageLoader::~BatchImageLoader()
+{
+	cancelAll();
+	{
+		lock_guard<mutex> lock( mMutex );
+		mQuit = true;
+	}
+	mQueueCond.notify_all();
+	mBudgetCond.notify_all();
+
+	for( auto &thread : mThreads )
+		thread.join();
+}
+
+BatchImageLoader::Request BatchImageLoader::load( const fs::path &path, int priority )
+{
+	return load( vector<fs::path>( 1, path ), priority ).front();
+}
+
+vector<BatchImageLoader::Request> BatchImageLoader::load( const vector<fs::path> &paths, int priority )
+{
+	vector<Request> result;
+	result.reserve( paths.size() );
+	{
+		lock_guard<mutex> lock( mMutex );
+		for( const auto &path : paths ) {
+			auto job = make_shared<Job>( mNextId++, path, priority );
+			result.push_back( Request( job->mId, job->mPromise.get_future().share() ) );
+			mQueue[make_pair( -priority, job->mId )] = job;
+			mJobs[job->mId] = job;
+		}
+	}
+
+	mQueueCond.notify_all();
+	return result;
+}
+
+bool BatchImageLoader::setPriority( RequestId id, int priority )
+{
+	lock_guard<mutex> lock( mMutex );
+	auto jobIt = mJobs.find( id );
+	if( jobIt == mJobs.end() || jobIt->second->mStarted )
+		return false;
+
+	auto job = jobIt->second;
+	mQueue.erase( make_pair( -job->mPriority, id ) );
+	job->mPriority = priority;
+	mQueue[make_pair( -priority, id )] = job;
+	return true;
+}
+
+bool BatchImageLoader::cancel( RequestId id )
+{
+	vector<shared_ptr<Job>> cancelled;
+	{
+		lock_guard<mutex> lock( mMutex );
+		auto jobIt = mJobs.find( id );
+		if( jobIt == mJobs.end() )
+			return false;
+
+		auto job = jobIt->second;
+		job->mCancelled = true;
+		if( ! job->mStarted ) {
+			mQueue.erase( make_pair( -job->mPriority, id ) );
+			cancelled.push_back( job );
+		}
+	}
+
+	// wakes a worker waiting on the budget for this image
+	mBudgetCond.notify_all();
+	deliverCancelled( cancelled );
+	return true;
+}
+
+void BatchImageLoader::cancelAll()
+{
+	vector<shared_ptr<Job>> cancelled;
+	{
+		lock_guard<mutex> lock( mMutex );
+		for( auto &job : mJobs )
+			job.second->mCancelled = true;
+		for( auto &queued : mQueue )
+			cancelled.push_back( queued.second );
+		mQueue.clear();
+	}
+
+	mBudgetCond.notify_all();
+	deliverCancelled( cancelled );
+}
+
+void BatchImageLoader::waitAll()
+{
+	unique_lock<mutex> lock( mMutex );
+	mIdleCond.wait( lock, [this] { return mJobs.empty(); } );
+}
+
+size_t BatchImageLoader::getNumQueued() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mQueue.size();
+}
+
+size_t BatchImageLoader::getBytesInFlight() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mBytesInFlight;
+}
+
+void BatchImageLoader::deliver( const shared_ptr<Job> &job, Result &result, size_t bytesInFlight )
+{
+	result.mId = job->mId;
+	result.mPath = job->mPath;
+	if( job->mCancelled ) {
+		result.mCancelled = true;
+		result.mSurface.reset();
+	}
+
+	if( mOptions.getCompletionFn() )
+		mOptions.getCompletionFn()( result );
+	job->mPromise.set_value( result );
+
+	{
+		lock_guard<mutex> lock( mMutex );
+		mBytesInFlight -= bytesInFlight;
+		mJobs.erase( job->mId );
+	}
+	if( bytesInFlight )
+		mBudgetCond.notify_all();
+	mIdleCond.notify_all();
+}
+
+void BatchImageLoader::deliverCancelled( const vector<shared_ptr<Job>> &jobs )
+{
+	for( const auto &job : jobs ) {
+		Result result;
+		result.mQueuedSeconds = job->mQueuedTimer.getSeconds();
+		deliver( job, result, 0 );
+	}
+}
+
+void BatchImageLoader::threadEntry()
+{
+	ThreadSetup threadSetup;
+
+	while( true ) {
+		shared_ptr<Job> job;
+		{
+			unique_lock<mutex> lock( mMutex );
+			mQueueCond.wait( lock, [this] { return mQuit || ! mQueue.empty(); } );
+			if( mQuit )
+				return;
+
+			job = mQueue.begin()->second;
+			mQueue.erase( mQueue.begin() );
+			job->mStarted = true;
+		}
+
+		Result result;
+		result.mQueuedSeconds = job->mQueuedTimer.getSeconds();
+		size_t bytes = 0;
+		try {
+			Timer openTimer( true );
+			ImageSourceRef source = loadImage( job->mPath, mOptions.getImageOptions() );
+			result.mOpenSeconds = openTimer.getSeconds();
+
+			// the decode waits until its Surface fits within the budget, unless nothing else is in flight
+			const size_t surfaceBytes = size_t( source->getWidth() ) * source->getHeight() * ( source->hasAlpha() ? 4 : 3 );
+			{
+				unique_lock<mutex> lock( mMutex );
+				mBudgetCond.wait( lock, [&] {
+					return job->mCancelled || mBytesInFlight == 0 || mBytesInFlight + surfaceBytes <= mOptions.getMaxBytesInFlight();
+				} );
+				if( ! job->mCancelled ) {
+					bytes = surfaceBytes;
+					mBytesInFlight += bytes;
+				}
+			}
+
+			if( ! job->mCancelled ) {
+				Timer decodeTimer( true );
+				result.mSurface = Surface8u::create( source );
+				result.mDecodeSeconds = decodeTimer.getSeconds();
+			}
+		}
+		catch( ... ) {
+			result.mError = current_exception();
+		}
+
+		deliver( job, result, bytes );
+	}
+}
+
+} // namespace cinder
@@ -25,6 +25,7 @@
 #include "cinder/DataSource.h"
 #include "cinder/DataTarget.h"
 #include <zlib.h>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <string.h>
@@ -107,7 +108,7 @@ void Buffer::resize( size_t newSize )
 		mData = realloc( mData, newSize );
 	else {
 		void *newData = malloc( newSize );
-		memcpy( newData, mData, mDataSize );
+		memcpy( newData, mData, std::min( mDataSize, newSize ) );
 		mData = newData;
 		mOwnsData = true;
 	}
@@ -133,125 +134,173 @@ void Buffer::write( const DataTargetRef &dataTarget )
 StreamingBuffer::StreamingBuffer( size_t blockSizeBytes )
 	: mBlockSize( std::max<size_t>( blockSizeBytes, 1 ) )
 {
-	allocateNewWriteBlock();
-	mReadOffset = 0;
+	Block *block = new Block( mBlockSize );
+	mProducer.mFirstBlock = mProducer.mWriteBlock = mProducer.mReadBlockCache = block;
+	mProducer.mWriteOffset = 0;
+	mProducer.mNumWritten.store( 0, std::memory_order_relaxed );
+	mConsumer.mReadBlock.store( block, std::memory_order_relaxed );
+	mConsumer.mReadOffset = 0;
+	mConsumer.mNumRead.store( 0, std::memory_order_relaxed );
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+	Block *block = mProducer.mFirstBlock;
+	while( block ) {
+		Block *next = block->mNext.load( std::memory_order_relaxed );
+		delete block;
+		block = next;
+	}
 }
 
 void StreamingBuffer::pushFront( const void *data, size_t dataSize )
 {
-	std::lock_guard<std::mutex> lock( mMutex );
 	size_t offset = 0;
-
 	while( offset < dataSize ) {
-		size_t copyCount = std::min( dataSize - offset, mBlockSize - mWriteOffset );
-		memcpy( &mBlocks.back()[mWriteOffset], &reinterpret_cast<const uint8_t*>(data)[offset], copyCount );
+		size_t copyCount;
+		uint8_t *dest = reserve( dataSize - offset, &copyCount );
+		memcpy( dest, &reinterpret_cast<const uint8_t*>(data)[offset], copyCount );
+		commit( copyCount );
 		offset += copyCount;
-		mWriteOffset += copyCount;
-		if( mWriteOffset == mBlockSize )
-			allocateNewWriteBlock();
 	}
 }
 
 size_t StreamingBuffer::popBack( void *output, size_t maxSize )
 {
-	std::lock_guard<std::mutex> lock( mMutex );
+	Region regions[16];
 	size_t offset = 0;
-
-	maxSize = std::min( maxSize, calcSize() );
-
-	while( offset < maxSize && ( ! mBlocks.empty() ) ) {
-		// for the last block, we can only read up to `mWriteOffset`; for other blocks we can read up to 'mBlockSize'
-		size_t copyCount = std::min( maxSize - offset, ( ( mBlocks.size() == 1 ) ? mWriteOffset : mBlockSize ) - mReadOffset );
-		memcpy( &reinterpret_cast<uint8_t*>(output)[offset], &mBlocks.front()[mReadOffset], copyCount );
-		offset += copyCount;
-		mReadOffset += copyCount;
-		if( mReadOffset == mBlockSize )
-			releaseCurrentReadBlock();
+	while( offset < maxSize ) {
+		const size_t numRegions = peek( regions, 16, maxSize - offset );
+		if( numRegions == 0 )
+			break;
+		const size_t start = offset;
+		for( size_t r = 0; r < numRegions; ++r ) {
+			memcpy( &reinterpret_cast<uint8_t*>(output)[offset], regions[r].mData, regions[r].mSize );
+			offset += regions[r].mSize;
+		}
+		consume( offset - start );
 	}
 
 	return offset;
 }
 
-size_t StreamingBuffer::getSize() const
+uint8_t* StreamingBuffer::reserve( size_t maxSize, size_t *reservedSize )
 {
-	std::lock_guard<std::mutex> lock( mMutex );
-	return calcSize();
+	// the next block is linked before anything is committed into it, so the consumer always finds it
+	if( mProducer.mWriteOffset == mBlockSize && maxSize > 0 ) {
+		Block *block = acquireBlock();
+		mProducer.mWriteBlock->mNext.store( block, std::memory_order_release );
+		mProducer.mWriteBlock = block;
+		mProducer.mWriteOffset = 0;
+	}
+
+	*reservedSize = std::min( maxSize, mBlockSize - mProducer.mWriteOffset );
+	return &mProducer.mWriteBlock->mData[mProducer.mWriteOffset];
 }
 
-void StreamingBuffer::clear()
+void StreamingBuffer::commit( size_t sizeBytes )
 {
-	std::lock_guard<std::mutex> lock( mMutex );
-	while( mBlocks.size() > 1 )
-		releaseCurrentReadBlock();
-	mReadOffset = mWriteOffset = 0;
+	mProducer.mWriteOffset += sizeBytes;
+	mProducer.mNumWritten.store( mProducer.mNumWritten.load( std::memory_order_relaxed ) + sizeBytes, std::memory_order_release );
 }
 
-void StreamingBuffer::shrinkToFit()
+size_t StreamingBuffer::peek( Region *regions, size_t maxRegions, size_t maxSize ) const
 {
-	std::lock_guard<std::mutex> lock( mMutex );
-	mUnusedBlocks.clear();
+	size_t available = std::min( maxSize, mProducer.mNumWritten.load( std::memory_order_acquire ) - mConsumer.mNumRead.load( std::memory_order_relaxed ) );
+	const Block *block = mConsumer.mReadBlock.load( std::memory_order_relaxed );
+	size_t offset = mConsumer.mReadOffset;
+	size_t numRegions = 0;
+	while( available > 0 && numRegions < maxRegions ) {
+		if( offset == mBlockSize ) {
+			block = block->mNext.load( std::memory_order_acquire );
+			offset = 0;
+		}
+		const size_t size = std::min( available, mBlockSize - offset );
+		regions[numRegions++] = { &block->mData[offset], size };
+		offset += size;
+		available -= size;
+	}
+
+	return numRegions;
 }
 
-size_t StreamingBuffer::copyTo( void *output, size_t maxSize ) const
+void StreamingBuffer::consume( size_t sizeBytes )
 {
-	std::lock_guard<std::mutex> lock( mMutex );
-	size_t offset = 0, copyCount;
-
-	// the first buffer we copy from read offset, up to either 'mBlockSize' or in the case of a single block, 'mWriteOffset'
-	size_t firstBlockSize = ( mBlocks.size() == 1 ) ? mWriteOffset : mBlockSize;
-	copyCount = std::min( maxSize, firstBlockSize - mReadOffset );
-	memcpy( &reinterpret_cast<uint8_t*>(output)[0], &mBlocks.front()[mReadOffset], copyCount );
-	offset += copyCount;
-	if( maxSize == offset || mBlocks.size() == 1 )
-		return offset;
-
-	// all but the first and last buffer we can copy in its entirety
-	for( size_t block = 1; block < mBlocks.size() - 1; ++block ) {
-		copyCount = std::min( maxSize - offset, mBlockSize );
-		memcpy( &reinterpret_cast<uint8_t*>(output)[offset], &mBlocks[block][0], copyCount );
-		offset += copyCount;
-		if( maxSize == offset )
-			return offset;
+	const size_t numRead = mConsumer.mNumRead.load( std::memory_order_relaxed );
+	sizeBytes = std::min( sizeBytes, mProducer.mNumWritten.load( std::memory_order_acquire ) - numRead );
+	Block *block = mConsumer.mReadBlock.load( std::memory_order_relaxed );
+	size_t offset = mConsumer.mReadOffset;
+	for( size_t remaining = sizeBytes; remaining > 0; ) {
+		if( offset == mBlockSize ) {
+			// publishing the new read block hands the previous ones back to the producer
+			block = block->mNext.load( std::memory_order_acquire );
+			mConsumer.mReadBlock.store( block, std::memory_order_release );
+			offset = 0;
+		}
+		const size_t count = std::min( remaining, mBlockSize - offset );
+		offset += count;
+		remaining -= count;
 	}
 
-	// last block we should read up to 'writeOffset'
-	copyCount = std::min( maxSize - offset, mWriteOffset );
-	memcpy( &reinterpret_cast<uint8_t*>(output)[offset], &mBlocks.back()[0], copyCount );
-	offset += copyCount;
+	mConsumer.mReadOffset = offset;
+	mConsumer.mNumRead.store( numRead + sizeBytes, std::memory_order_release );
+}
 
-	return offset;
+size_t StreamingBuffer::getSize() const
+{
+	// reading the consumer's total first means the difference can never be negative
+	const size_t numRead = mConsumer.mNumRead.load( std::memory_order_acquire );
+	return mProducer.mNumWritten.load( std::memory_order_acquire ) - numRead;
 }
 
-// implicitly thread-safe; only called by thread-safe methods
-void StreamingBuffer::allocateNewWriteBlock()
+void StreamingBuffer::clear()
 {
-	if( ! mUnusedBlocks.empty() ) {
-		mBlocks.push_back( std::move( mUnusedBlocks.back() ) );
-		mUnusedBlocks.pop_back();
-	}
-	else
-		mBlocks.emplace_back( new uint8_t[mBlockSize] );
-	mWriteOffset = 0;
+	consume( SIZE_MAX );
 }
 
-// implicitly thread-safe; only called by thread-safe methods
-void StreamingBuffer::releaseCurrentReadBlock()
+void StreamingBuffer::shrinkToFit()
 {
-	mUnusedBlocks.push_back( std::move( mBlocks.front() ) );
-	mBlocks.pop_front();
-	mReadOffset = 0;
+	Block *readBlock = mConsumer.mReadBlock.load( std::memory_order_acquire );
+	while( mProducer.mFirstBlock != readBlock ) {
+		Block *next = mProducer.mFirstBlock->mNext.load( std::memory_order_relaxed );
+		delete mProducer.mFirstBlock;
+		mProducer.mFirstBlock = next;
+	}
+	mProducer.mReadBlockCache = readBlock;
 }
 
-// implicitly thread-safe; only called by thread-safe methods
-size_t StreamingBuffer::calcSize() const
+size_t StreamingBuffer::copyTo( void *output, size_t maxSize ) const
 {
-	if( mBlocks.size() == 1 )
-		return mWriteOffset - mReadOffset;
-	else {
-		size_t frontBlockSize = mBlockSize - mReadOffset;
-		size_t backBlockSize = mWriteOffset;
-		return ( mBlocks.size() - 2 ) * mBlockSize + frontBlockSize + backBlockSize;
+	size_t remaining = std::min( maxSize, mProducer.mNumWritten.load( std::memory_order_acquire ) - mConsumer.mNumRead.load( std::memory_order_relaxed ) );
+	const Block *block = mConsumer.mReadBlock.load( std::memory_order_relaxed );
+	size_t readOffset = mConsumer.mReadOffset, offset = 0;
+	while( remaining > 0 ) {
+		if( readOffset == mBlockSize ) {
+			block = block->mNext.load( std::memory_order_acquire );
+			readOffset = 0;
+		}
+		const size_t copyCount = std::min( remaining, mBlockSize - readOffset );
+		memcpy( &reinterpret_cast<uint8_t*>(output)[offset], &block->mData[readOffset], copyCount );
+		readOffset += copyCount;
+		offset += copyCount;
+		remaining -= copyCount;
 	}
+
+	return offset;
+}
+
+StreamingBuffer::Block* StreamingBuffer::acquireBlock()
+{
+	// blocks older than the consumer's read block have been drained; refresh our view of it only once those we know about run out
+	if( mProducer.mFirstBlock == mProducer.mReadBlockCache )
+		mProducer.mReadBlockCache = mConsumer.mReadBlock.load( std::memory_order_acquire );
+	if( mProducer.mFirstBlock == mProducer.mReadBlockCache )
+		return new Block( mBlockSize );
+
+	Block *result = mProducer.mFirstBlock;
+	mProducer.mFirstBlock = result->mNext.load( std::memory_order_relaxed );
+	result->mNext.store( nullptr, std::memory_order_relaxed );
+	return result;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -614,9 +614,11 @@ union float32_t
 // Algorithm due to Fabian "ryg" Giesen.
 static half_float float_to_half( float32_t f )
 {
-    float32_t f32infty = { 255 << 23 };
-    float32_t f16infty = { 31 << 23 };
-    float32_t magic = { 15 << 23 };
+    // the constants are bit patterns, so they have to be assigned through the integer member
+    float32_t f32infty, f16infty, magic;
+    f32infty.u = 255 << 23;
+    f16infty.u = 31 << 23;
+    magic.u = 15 << 23;
     uint sign_mask = 0x80000000u;
     uint round_mask = ~0xfffu; 
     half_float o = { 0 };
@@ -653,7 +655,8 @@ cinder::half_float floatToHalf( float f )
 // Algorithm due to Fabian "ryg" Giesen.
 float halfToFloat( cinder::half_float h )
 {
-	static const float32_t magic = { 113 << 23 };
+	float32_t magic;
+	magic.u = 113 << 23;
 	static const uint shifted_exp = 0x7c00 << 13; // exponent mask after shift
 	float32_t o;
 
@@ -62,20 +62,48 @@ BufferRef DataSource::getBuffer()
 
 /////////////////////////////////////////////////////////////////////////////
 // DataSourcePath
-DataSourcePathRef DataSourcePath::create( const fs::path &path )
+DataSourcePathRef DataSourcePath::create( const fs::path &path, bool memoryMapped )
 {
-	return DataSourcePathRef( new DataSourcePath( path ) );
+	return DataSourcePathRef( new DataSourcePath( path, memoryMapped ) );
 }
 
-DataSourcePath::DataSourcePath( const fs::path &path )
-	: DataSource( path, Url() )
+DataSourcePath::DataSourcePath( const fs::path &path, bool memoryMapped )
+	: DataSource( path, Url() ), mMemoryMapped( memoryMapped )
 {
 	setFilePathHint( path );
 }
 
+MappedFileRef DataSourcePath::getMappedFile()
+{
+	if( mMemoryMapped && ! mMappedFile ) {
+		// small files are as cheap to read as to map, and reading them doesn't hold the file open
+		std::error_code ec;
+		const auto fileSize = fs::file_size( mFilePath, ec );
+		if( ec || fileSize < MIN_MAPPED_FILE_SIZE ) {
+			mMemoryMapped = false;
+			return nullptr;
+		}
+
+		try {
+			mMappedFile = MappedFile::create( mFilePath );
+		}
+		catch( StreamExc & ) {
+			mMemoryMapped = false;
+		}
+	}
+
+	return mMappedFile;
+}
+
 void DataSourcePath::createBuffer()
 {
-	// no-op - we already supplied the buffer in the constructor
+	// the Buffer views the mapping and keeps it alive, rather than holding a copy of the file
+	MappedFileRef mappedFile = getMappedFile();
+	if( mappedFile ) {
+		mBuffer = BufferRef( new Buffer( mappedFile->getData(), mappedFile->getSize() ), [mappedFile]( Buffer *buffer ) { delete buffer; } );
+		return;
+	}
+
 	IStreamFileRef stream = loadFileStream( mFilePath );
 	if( ! stream )
 		throw StreamExc();
@@ -85,6 +113,10 @@ void DataSourcePath::createBuffer()
 
 IStreamRef DataSourcePath::createStream()
 {
+	MappedFileRef mappedFile = getMappedFile();
+	if( mappedFile )
+		return IStreamMapped::create( mappedFile );
+
 	return loadFileStream( mFilePath );
 }
 
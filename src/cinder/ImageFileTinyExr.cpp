@@ -48,7 +48,7 @@ void ImageSourceFileTinyExr::registerSelf()
 	ImageIoRegistrar::registerSourceType( "exr", sourceFunc, 1 ); // lower is higher priority
 }
 
-ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options /*options*/ )
+ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options options )
 	: mExrHeader( new EXRHeader, FreeEXRHeader ) // We're using the provided FreeEXRHeader function as a custom deleter
 	, mExrImage( new EXRImage, FreeEXRImage )    // We're using the provided FreeEXRImage function as a custom deleter
 {
@@ -134,7 +134,7 @@ ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageS
 			break;
 	}
 
-	setSize( mExrImage->width, mExrImage->height );
+	setSizeReduced( mExrImage->width, mExrImage->height, options );
 
 	switch( mExrImage->num_channels ) {
 		case 1:
@@ -184,58 +184,58 @@ void ImageSourceFileTinyExr::load( ImageTargetRef target )
 
 	if( gray ) {
 		if( getDataType() == ImageIo::FLOAT32 ) {
-			vector<float> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const float *>( gray )[row * mWidth + col];
+			vector<float> rowData( mFullWidth * mExrImage->num_channels, 0 );
+			for( int32_t row = 0; row < mFullHeight; row++ ) {
+				for( int32_t col = 0; col < mFullWidth; col++ ) {
+					rowData.at( col * numChannels + 0 ) = static_cast<const float *>( gray )[row * mFullWidth + col];
 					if( alpha )
-						rowData.at( col * numChannels + 1 ) = static_cast<const float *>( alpha )[row * mWidth + col];
+						rowData.at( col * numChannels + 1 ) = static_cast<const float *>( alpha )[row * mFullWidth + col];
 				}
 
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
+				processRow( rowFunc, target, row, rowData.data() );
 			}
 		}
 		else { // float16
-			vector<uint16_t> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( gray )[row * mWidth + col];
+			vector<uint16_t> rowData( mFullWidth * mExrImage->num_channels, 0 );
+			for( int32_t row = 0; row < mFullHeight; row++ ) {
+				for( int32_t col = 0; col < mFullWidth; col++ ) {
+					rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( gray )[row * mFullWidth + col];
 					if( alpha )
-						rowData.at( col * numChannels + 1 ) = static_cast<const uint16_t *>( alpha )[row * mWidth + col];
+						rowData.at( col * numChannels + 1 ) = static_cast<const uint16_t *>( alpha )[row * mFullWidth + col];
 				}
 
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
+				processRow( rowFunc, target, row, rowData.data() );
 			}
 		}
 	}
 	else {
 		// load one interleaved row at a time
 		if( getDataType() == ImageIo::FLOAT32 ) {
-			vector<float> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const float *>( red )[row * mWidth + col];
-					rowData.at( col * numChannels + 1 ) = static_cast<const float *>( green )[row * mWidth + col];
-					rowData.at( col * numChannels + 2 ) = static_cast<const float *>( blue )[row * mWidth + col];
+			vector<float> rowData( mFullWidth * mExrImage->num_channels, 0 );
+			for( int32_t row = 0; row < mFullHeight; row++ ) {
+				for( int32_t col = 0; col < mFullWidth; col++ ) {
+					rowData.at( col * numChannels + 0 ) = static_cast<const float *>( red )[row * mFullWidth + col];
+					rowData.at( col * numChannels + 1 ) = static_cast<const float *>( green )[row * mFullWidth + col];
+					rowData.at( col * numChannels + 2 ) = static_cast<const float *>( blue )[row * mFullWidth + col];
 					if( alpha )
-						rowData.at( col * numChannels + 3 ) = static_cast<const float *>( alpha )[row * mWidth + col];
+						rowData.at( col * numChannels + 3 ) = static_cast<const float *>( alpha )[row * mFullWidth + col];
 				}
 
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
+				processRow( rowFunc, target, row, rowData.data() );
 			}
 		}
 		else { // float16
-			vector<uint16_t> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( red )[row * mWidth + col];
-					rowData.at( col * numChannels + 1 ) = static_cast<const uint16_t *>( green )[row * mWidth + col];
-					rowData.at( col * numChannels + 2 ) = static_cast<const uint16_t *>( blue )[row * mWidth + col];
+			vector<uint16_t> rowData( mFullWidth * mExrImage->num_channels, 0 );
+			for( int32_t row = 0; row < mFullHeight; row++ ) {
+				for( int32_t col = 0; col < mFullWidth; col++ ) {
+					rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( red )[row * mFullWidth + col];
+					rowData.at( col * numChannels + 1 ) = static_cast<const uint16_t *>( green )[row * mFullWidth + col];
+					rowData.at( col * numChannels + 2 ) = static_cast<const uint16_t *>( blue )[row * mFullWidth + col];
 					if( alpha )
-						rowData.at( col * numChannels + 3 ) = static_cast<const uint16_t *>( alpha )[row * mWidth + col];
+						rowData.at( col * numChannels + 3 ) = static_cast<const uint16_t *>( alpha )[row * mFullWidth + col];
 				}
 
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
+				processRow( rowFunc, target, row, rowData.data() );
 			}
 		}
 	}
@@ -23,10 +23,23 @@
 */
 
 #include "cinder/ImageIo.h"
+#include "cinder/ChanTraits.h"
 #include "cinder/Utilities.h"
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/ip/Fill.h"
+#include "ip/Simd.h"
 
+#include <algorithm>
 #include <iterator>
 #include <cctype>
+#include <cstring>
+#include <type_traits>
+
+#if defined( CINDER_IP_SIMD_X86 )
+	#include <immintrin.h>
+#elif defined( CINDER_IP_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
 
 #if defined( CINDER_COCOA )
 	#include "cinder/cocoa/CinderCocoa.h"
@@ -38,6 +51,189 @@ using namespace std;
 
 namespace cinder {
 
+namespace {
+
+// Kernels behind ImageSource's row function fast paths. The SIMD variants process as many whole vectors as fit and return the number
+// of pixels (or values) they handled, leaving the remainder to the scalar loops. All of them match the CHANTRAIT conversions exactly.
+
+template<int SOURCE_INC, int TARGET_INC>
+void swizzleRow8u( const uint8_t *src, uint8_t *dst, int32_t width, const int8_t *swizzle )
+{
+	// a 255 byte appended to each source pixel stands in for the channels the source lacks
+	int8_t map[TARGET_INC];
+	for( int c = 0; c < TARGET_INC; ++c )
+		map[c] = ( swizzle[c] < 0 ) ? SOURCE_INC : swizzle[c];
+
+	uint8_t px[SOURCE_INC + 1];
+	px[SOURCE_INC] = 255;
+	for( int32_t x = 0; x < width; ++x, src += SOURCE_INC, dst += TARGET_INC ) {
+		for( int c = 0; c < SOURCE_INC; ++c )
+			px[c] = src[c];
+		for( int c = 0; c < TARGET_INC; ++c )
+			dst[c] = px[map[c]];
+	}
+}
+
+#if defined( CINDER_IP_SIMD_X86 )
+
+// Swizzles 8 pixels per iteration; each 128-bit lane shuffles 4 pixels out of a 16-byte load
+template<int SOURCE_INC, int TARGET_INC>
+CINDER_IP_TARGET_AVX2 int32_t swizzleRowAvx2( const uint8_t *src, uint8_t *dst, int32_t width, const int8_t *swizzle )
+{
+	alignas(16) int8_t control[16], fill[16];
+	for( int i = 0; i < 16; ++i ) {
+		control[i] = -128;
+		fill[i] = 0;
+	}
+	for( int p = 0; p < 4; ++p ) {
+		for( int c = 0; c < TARGET_INC; ++c ) {
+			control[p * TARGET_INC + c] = ( swizzle[c] < 0 ) ? -128 : int8_t( p * SOURCE_INC + swizzle[c] );
+			fill[p * TARGET_INC + c] = ( swizzle[c] < 0 ) ? -1 : 0;
+		}
+	}
+	const __m256i controlV = _mm256_broadcastsi128_si256( _mm_load_si128( reinterpret_cast<const __m128i*>( control ) ) );
+	const __m256i fillV = _mm256_broadcastsi128_si256( _mm_load_si128( reinterpret_cast<const __m128i*>( fill ) ) );
+
+	// the upper lane reads 16 bytes from pixel x + 4 and 3-byte targets are stored as two overlapping 16-byte halves,
+	// neither of which may run past the end of the row
+	int32_t x = 0;
+	for( ; x + 8 <= width && ( x + 4 ) * SOURCE_INC + 16 <= width * SOURCE_INC && ( x + 4 ) * TARGET_INC + 16 <= width * TARGET_INC; x += 8 ) {
+		__m128i lo = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * SOURCE_INC ) );
+		__m128i hi = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + ( x + 4 ) * SOURCE_INC ) );
+		__m256i px = _mm256_inserti128_si256( _mm256_castsi128_si256( lo ), hi, 1 );
+		__m256i result = _mm256_or_si256( _mm256_shuffle_epi8( px, controlV ), fillV );
+		if constexpr( TARGET_INC == 4 )
+			_mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + x * 4 ), result );
+		else {
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * 3 ), _mm256_castsi256_si128( result ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + ( x + 4 ) * 3 ), _mm256_extracti128_si256( result, 1 ) );
+		}
+	}
+	return x;
+}
+
+// Division rather than multiplication by the reciprocal, so that the results are identical to CHANTRAIT<float>::convert()
+CINDER_IP_TARGET_AVX2 size_t convertRow8uTo32fAvx2( const uint8_t *src, float *dst, size_t count )
+{
+	const __m256 scale = _mm256_set1_ps( 255.0f );
+	size_t i = 0;
+	for( ; i + 16 <= count; i += 16 ) {
+		__m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+		_mm256_storeu_ps( dst + i, _mm256_div_ps( _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( v ) ), scale ) );
+		_mm256_storeu_ps( dst + i + 8, _mm256_div_ps( _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( _mm_srli_si128( v, 8 ) ) ), scale ) );
+	}
+	return i;
+}
+
+CINDER_IP_TARGET_SSE2 size_t convertRow8uTo32fSse2( const uint8_t *src, float *dst, size_t count )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps( 255.0f );
+	size_t i = 0;
+	for( ; i + 16 <= count; i += 16 ) {
+		__m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+		__m128i lo = _mm_unpacklo_epi8( v, zero ), hi = _mm_unpackhi_epi8( v, zero );
+		_mm_storeu_ps( dst + i, _mm_div_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) ), scale ) );
+		_mm_storeu_ps( dst + i + 4, _mm_div_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) ), scale ) );
+		_mm_storeu_ps( dst + i + 8, _mm_div_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) ), scale ) );
+		_mm_storeu_ps( dst + i + 12, _mm_div_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) ), scale ) );
+	}
+	return i;
+}
+
+// Clamps to [0, 1], scales by 255 and truncates like CHANTRAIT<uint8_t>::convert()
+CINDER_IP_TARGET_SSE2 size_t convertRow32fTo8uSse2( const float *src, uint8_t *dst, size_t count )
+{
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps( 1.0f ), scale = _mm_set1_ps( 255.0f );
+	size_t i = 0;
+	for( ; i + 16 <= count; i += 16 ) {
+		__m128i q[4];
+		for( int k = 0; k < 4; ++k ) {
+			__m128 v = _mm_min_ps( _mm_max_ps( _mm_loadu_ps( src + i + k * 4 ), zero ), one );
+			q[k] = _mm_cvttps_epi32( _mm_mul_ps( v, scale ) );
+		}
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_packus_epi16( _mm_packs_epi32( q[0], q[1] ), _mm_packs_epi32( q[2], q[3] ) ) );
+	}
+	return i;
+}
+
+#elif defined( CINDER_IP_SIMD_NEON )
+
+template<int SOURCE_INC, int TARGET_INC>
+int32_t swizzleRowNeon( const uint8_t *src, uint8_t *dst, int32_t width, const int8_t *swizzle )
+{
+	const uint8x16_t opaque = vdupq_n_u8( 255 );
+	int32_t x = 0;
+	for( ; x + 16 <= width; x += 16 ) {
+		// de-interleaving loads and interleaving stores turn the swizzle into register moves
+		uint8x16_t in[4];
+		const uint8_t *s = src + x * SOURCE_INC;
+		if constexpr( SOURCE_INC == 1 )
+			in[0] = vld1q_u8( s );
+		else if constexpr( SOURCE_INC == 2 ) {
+			uint8x16x2_t v = vld2q_u8( s );
+			in[0] = v.val[0]; in[1] = v.val[1];
+		}
+		else if constexpr( SOURCE_INC == 3 ) {
+			uint8x16x3_t v = vld3q_u8( s );
+			in[0] = v.val[0]; in[1] = v.val[1]; in[2] = v.val[2];
+		}
+		else {
+			uint8x16x4_t v = vld4q_u8( s );
+			in[0] = v.val[0]; in[1] = v.val[1]; in[2] = v.val[2]; in[3] = v.val[3];
+		}
+
+		if constexpr( TARGET_INC == 3 ) {
+			uint8x16x3_t out;
+			for( int c = 0; c < 3; ++c )
+				out.val[c] = ( swizzle[c] < 0 ) ? opaque : in[swizzle[c]];
+			vst3q_u8( dst + x * 3, out );
+		}
+		else {
+			uint8x16x4_t out;
+			for( int c = 0; c < 4; ++c )
+				out.val[c] = ( swizzle[c] < 0 ) ? opaque : in[swizzle[c]];
+			vst4q_u8( dst + x * 4, out );
+		}
+	}
+	return x;
+}
+
+#if defined( __aarch64__ ) || defined( _M_ARM64 )
+// Division rather than multiplication by the reciprocal, so that the results are identical to CHANTRAIT<float>::convert()
+size_t convertRow8uTo32fNeon( const uint8_t *src, float *dst, size_t count )
+{
+	const float32x4_t scale = vdupq_n_f32( 255.0f );
+	size_t i = 0;
+	for( ; i + 16 <= count; i += 16 ) {
+		uint8x16_t v = vld1q_u8( src + i );
+		uint16x8_t lo = vmovl_u8( vget_low_u8( v ) ), hi = vmovl_u8( vget_high_u8( v ) );
+		vst1q_f32( dst + i, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( lo ) ) ), scale ) );
+		vst1q_f32( dst + i + 4, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( lo ) ) ), scale ) );
+		vst1q_f32( dst + i + 8, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( hi ) ) ), scale ) );
+		vst1q_f32( dst + i + 12, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( hi ) ) ), scale ) );
+	}
+	return i;
+}
+#endif
+
+// Clamps to [0, 1], scales by 255 and truncates like CHANTRAIT<uint8_t>::convert()
+size_t convertRow32fTo8uNeon( const float *src, uint8_t *dst, size_t count )
+{
+	const float32x4_t zero = vdupq_n_f32( 0.0f ), one = vdupq_n_f32( 1.0f );
+	size_t i = 0;
+	for( ; i + 8 <= count; i += 8 ) {
+		uint32x4_t q0 = vcvtq_u32_f32( vmulq_n_f32( vminq_f32( vmaxq_f32( vld1q_f32( src + i ), zero ), one ), 255.0f ) );
+		uint32x4_t q1 = vcvtq_u32_f32( vmulq_n_f32( vminq_f32( vmaxq_f32( vld1q_f32( src + i + 4 ), zero ), one ), 255.0f ) );
+		vst1_u8( dst + i, vmovn_u16( vcombine_u16( vmovn_u32( q0 ), vmovn_u32( q1 ) ) ) );
+	}
+	return i;
+}
+
+#endif
+
+} // anonymous namespace
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // ImageSource
@@ -158,6 +354,110 @@ size_t ImageSource::getRowBytes() const
 	return getWidth() * ImageIo::channelOrderNumChannels( getChannelOrder() ) * ImageIo::dataTypeBytes( getDataType() );
 }
 
+namespace {
+
+// Sum type used to box-filter rows of each data type in ImageSource::processRowReduced(), and how a sum of \a count values is averaged
+template<typename T>
+struct ReductionTraits {
+	typedef uint32_t Sum;
+	static Sum	toSum( T v )						{ return v; }
+	static T	average( Sum sum, uint32_t count )	{ return T( ( sum + count / 2 ) / count ); }
+};
+
+template<>
+struct ReductionTraits<uint16_t> {
+	typedef uint64_t Sum;
+	static Sum		toSum( uint16_t v )						{ return v; }
+	static uint16_t	average( Sum sum, uint32_t count )		{ return uint16_t( ( sum + count / 2 ) / count ); }
+};
+
+template<>
+struct ReductionTraits<float> {
+	typedef float Sum;
+	static Sum		toSum( float v )						{ return v; }
+	static float	average( Sum sum, uint32_t count )		{ return sum / count; }
+};
+
+template<>
+struct ReductionTraits<half_float> {
+	typedef float Sum;
+	static Sum			toSum( half_float v )					{ return halfToFloat( v ); }
+	static half_float	average( Sum sum, uint32_t count )		{ return floatToHalf( sum / count ); }
+};
+
+} // anonymous namespace
+
+void ImageSource::setSizeReduced( int32_t fullWidth, int32_t fullHeight, const Options &options )
+{
+	// stops once the longer side is reduced to a single pixel, so that huge requests neither overflow nor loop forever
+	const int32_t fullSize = std::max( fullWidth, fullHeight );
+	int32_t factor = 1;
+	while( factor <= options.getReductionFactor() / 2 && factor < fullSize )
+		factor *= 2;
+	if( options.getMaxSize() > 0 ) {
+		while( fullSize / factor / 2 >= options.getMaxSize() )
+			factor *= 2;
+	}
+
+	mReductionFactor = factor;
+	mFullWidth = fullWidth;
+	mFullHeight = fullHeight;
+	setSize( ( fullWidth + factor - 1 ) / factor, ( fullHeight + factor - 1 ) / factor );
+}
+
+void ImageSource::processRow( RowFunc rowFunc, ImageTargetRef target, int32_t row, const void *data )
+{
+	if( mReductionFactor <= 1 ) {
+		((*this).*rowFunc)( target, row, data );
+		return;
+	}
+
+	switch( getDataType() ) {
+		case UINT8: processRowReduced<uint8_t>( rowFunc, target, row, data ); break;
+		case UINT16: processRowReduced<uint16_t>( rowFunc, target, row, data ); break;
+		case FLOAT32: processRowReduced<float>( rowFunc, target, row, data ); break;
+		case FLOAT16: processRowReduced<half_float>( rowFunc, target, row, data ); break;
+		default:
+			throw ImageIoExceptionIllegalDataType( "Unknown data type." );
+	}
+}
+
+template<typename T>
+void ImageSource::processRowReduced( RowFunc rowFunc, ImageTargetRef target, int32_t row, const void *data )
+{
+	typedef typename ReductionTraits<T>::Sum Sum;
+	const int32_t factor = mReductionFactor;
+	const int32_t inc = ( mCustomPixelInc != 0 ) ? mCustomPixelInc : ImageIo::channelOrderNumChannels( getChannelOrder() );
+
+	// every reduced pixel sums a box of factor x factor source pixels, clipped at the right and bottom edges
+	if( row % factor == 0 )
+		mReductionSums.assign( mWidth * inc * sizeof( Sum ), 0 );
+	Sum *sums = reinterpret_cast<Sum*>( mReductionSums.data() );
+	const T *source = reinterpret_cast<const T*>( data );
+	for( int32_t x = 0; x < mWidth; ++x, sums += inc ) {
+		const int32_t columns = std::min( factor, mFullWidth - x * factor );
+		for( int32_t i = 0; i < columns; ++i, source += inc ) {
+			for( int32_t c = 0; c < inc; ++c )
+				sums[c] += ReductionTraits<T>::toSum( source[c] );
+		}
+	}
+
+	if( ( row % factor != factor - 1 ) && ( row != mFullHeight - 1 ) )
+		return;
+
+	const int32_t rows = row % factor + 1;
+	mReductionRow.resize( mWidth * inc * sizeof( T ) );
+	T *reduced = reinterpret_cast<T*>( mReductionRow.data() );
+	sums = reinterpret_cast<Sum*>( mReductionSums.data() );
+	for( int32_t x = 0; x < mWidth; ++x, sums += inc, reduced += inc ) {
+		const uint32_t count = uint32_t( std::min( factor, mFullWidth - x * factor ) * rows );
+		for( int32_t c = 0; c < inc; ++c )
+			reduced[c] = ReductionTraits<T>::average( sums[c], count );
+	}
+
+	((*this).*rowFunc)( target, row / factor, mReductionRow.data() );
+}
+
 /* SD - source data type, TD - target data type, TCM - target color model */
 template<typename SD, typename TD, ImageIo::ColorModel TCM, bool ALPHA>
 void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const void *data )
@@ -274,6 +574,71 @@ void ImageSource::rowFuncSourceGray( ImageTargetRef target, int32_t row, const v
 	}
 }
 
+template<typename T>
+void ImageSource::rowFuncCopy( ImageTargetRef target, int32_t row, const void *data )
+{
+	memcpy( target->getRowPointer( row ), data, getWidth() * mRowFuncSourceInc * sizeof(T) );
+}
+
+template<int SOURCE_INC, int TARGET_INC>
+void ImageSource::rowFuncSwizzle8u( ImageTargetRef target, int32_t row, const void *data )
+{
+	const uint8_t *sourceData = reinterpret_cast<const uint8_t*>( data );
+	uint8_t *targetData = reinterpret_cast<uint8_t*>( target->getRowPointer( row ) );
+	const int32_t width = getWidth();
+
+	int32_t x = 0;
+#if defined( CINDER_IP_SIMD_X86 )
+	if constexpr( SOURCE_INC >= 3 ) {
+		if( ip::detail::getSimdLevel() == ip::detail::SimdLevel::AVX2 )
+			x = swizzleRowAvx2<SOURCE_INC,TARGET_INC>( sourceData, targetData, width, mRowFuncSwizzle );
+	}
+#elif defined( CINDER_IP_SIMD_NEON )
+	if( ip::detail::getSimdLevel() == ip::detail::SimdLevel::NEON )
+		x = swizzleRowNeon<SOURCE_INC,TARGET_INC>( sourceData, targetData, width, mRowFuncSwizzle );
+#endif
+	swizzleRow8u<SOURCE_INC,TARGET_INC>( sourceData + x * SOURCE_INC, targetData + x * TARGET_INC, width - x, mRowFuncSwizzle );
+}
+
+void ImageSource::rowFunc8uTo32f( ImageTargetRef target, int32_t row, const void *data )
+{
+	const uint8_t *sourceData = reinterpret_cast<const uint8_t*>( data );
+	float *targetData = reinterpret_cast<float*>( target->getRowPointer( row ) );
+	const size_t count = getWidth() * mRowFuncSourceInc;
+
+	size_t i = 0;
+#if defined( CINDER_IP_SIMD_X86 )
+	const ip::detail::SimdLevel simdLevel = ip::detail::getSimdLevel();
+	if( simdLevel == ip::detail::SimdLevel::AVX2 )
+		i = convertRow8uTo32fAvx2( sourceData, targetData, count );
+	else if( simdLevel == ip::detail::SimdLevel::SSE2 )
+		i = convertRow8uTo32fSse2( sourceData, targetData, count );
+#elif defined( CINDER_IP_SIMD_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+	if( ip::detail::getSimdLevel() == ip::detail::SimdLevel::NEON )
+		i = convertRow8uTo32fNeon( sourceData, targetData, count );
+#endif
+	for( ; i < count; ++i )
+		targetData[i] = CHANTRAIT<float>::convert( sourceData[i] );
+}
+
+void ImageSource::rowFunc32fTo8u( ImageTargetRef target, int32_t row, const void *data )
+{
+	const float *sourceData = reinterpret_cast<const float*>( data );
+	uint8_t *targetData = reinterpret_cast<uint8_t*>( target->getRowPointer( row ) );
+	const size_t count = getWidth() * mRowFuncSourceInc;
+
+	size_t i = 0;
+#if defined( CINDER_IP_SIMD_X86 )
+	if( ip::detail::getSimdLevel() != ip::detail::SimdLevel::NONE )
+		i = convertRow32fTo8uSse2( sourceData, targetData, count );
+#elif defined( CINDER_IP_SIMD_NEON )
+	if( ip::detail::getSimdLevel() == ip::detail::SimdLevel::NEON )
+		i = convertRow32fTo8uNeon( sourceData, targetData, count );
+#endif
+	for( ; i < count; ++i )
+		targetData[i] = CHANTRAIT<uint8_t>::convert( sourceData[i] );
+}
+
 void ImageSource::setupRowFuncRgbSource( ImageTargetRef target )
 {
 	translateRgbColorModelToOffsets( mChannelOrder, &mRowFuncSourceRed, &mRowFuncSourceGreen, &mRowFuncSourceBlue, &mRowFuncSourceAlpha, &mRowFuncSourceInc );
@@ -292,6 +657,57 @@ void ImageSource::setupRowFuncGraySource( ImageTargetRef target )
 		translateGrayColorModelToOffsets( target->getChannelOrder(), &mRowFuncTargetGray, &mRowFuncTargetAlpha, &mRowFuncTargetInc );
 }
 
+template<typename SD, typename TD>
+ImageSource::RowFunc ImageSource::setupRowFuncFastPath()
+{
+	const bool graySource = ( mColorModel == CM_GRAY );
+	const int8_t sourceRed = graySource ? mRowFuncSourceGray : mRowFuncSourceRed;
+	const int8_t sourceGreen = graySource ? mRowFuncSourceGray : mRowFuncSourceGreen;
+	const int8_t sourceBlue = graySource ? mRowFuncSourceGray : mRowFuncSourceBlue;
+	const bool sameLayout = ( ! graySource ) && ( mRowFuncSourceInc == mRowFuncTargetInc ) && ( mRowFuncSourceRed == mRowFuncTargetRed )
+							&& ( mRowFuncSourceGreen == mRowFuncTargetGreen ) && ( mRowFuncSourceBlue == mRowFuncTargetBlue ) && ( mRowFuncSourceAlpha == mRowFuncTargetAlpha );
+
+	if constexpr( std::is_same<SD,TD>::value ) {
+		if( sameLayout )
+			return &ImageSource::rowFuncCopy<SD>;
+	}
+
+	if constexpr( std::is_same<SD,uint8_t>::value && std::is_same<TD,uint8_t>::value ) {
+		// every target channel is a copy of some source channel, or 255 for padding and alpha missing from the source
+		for( int c = 0; c < 4; ++c )
+			mRowFuncSwizzle[c] = -1;
+		mRowFuncSwizzle[mRowFuncTargetRed] = sourceRed;
+		mRowFuncSwizzle[mRowFuncTargetGreen] = sourceGreen;
+		mRowFuncSwizzle[mRowFuncTargetBlue] = sourceBlue;
+		if( mRowFuncTargetAlpha != -1 )
+			mRowFuncSwizzle[mRowFuncTargetAlpha] = mRowFuncSourceAlpha;
+
+		switch( mRowFuncSourceInc * 10 + mRowFuncTargetInc ) {
+			case 13: return &ImageSource::rowFuncSwizzle8u<1,3>;
+			case 14: return &ImageSource::rowFuncSwizzle8u<1,4>;
+			case 23: return &ImageSource::rowFuncSwizzle8u<2,3>;
+			case 24: return &ImageSource::rowFuncSwizzle8u<2,4>;
+			case 33: return &ImageSource::rowFuncSwizzle8u<3,3>;
+			case 34: return &ImageSource::rowFuncSwizzle8u<3,4>;
+			case 43: return &ImageSource::rowFuncSwizzle8u<4,3>;
+			case 44: return &ImageSource::rowFuncSwizzle8u<4,4>;
+			default: return nullptr;
+		}
+	}
+
+	if constexpr( std::is_same<SD,uint8_t>::value && std::is_same<TD,float>::value ) {
+		if( sameLayout )
+			return &ImageSource::rowFunc8uTo32f;
+	}
+
+	if constexpr( std::is_same<SD,float>::value && std::is_same<TD,uint8_t>::value ) {
+		if( sameLayout )
+			return &ImageSource::rowFunc32fTo8u;
+	}
+
+	return nullptr;
+}
+
 template<typename SD, typename TD, ImageIo::ColorModel TCM>
 ImageSource::RowFunc ImageSource::setupRowFuncForTypesAndTargetColorModel( ImageTargetRef target )
 {
@@ -300,6 +716,10 @@ ImageSource::RowFunc ImageSource::setupRowFuncForTypesAndTargetColorModel( Image
 			setupRowFuncRgbSource( target );
 			if( mCustomPixelInc != 0 )
 				mRowFuncSourceInc = mCustomPixelInc;
+			if( TCM == CM_RGB ) {
+				if( RowFunc fastPath = setupRowFuncFastPath<SD,TD>() )
+					return fastPath;
+			}
 			bool alpha = ( mRowFuncSourceAlpha != -1 ) && ( mRowFuncTargetAlpha != -1 );
 			if( alpha )
 				return &ImageSource::rowFuncSourceRgb<SD,TD,TCM,true>;
@@ -311,6 +731,10 @@ ImageSource::RowFunc ImageSource::setupRowFuncForTypesAndTargetColorModel( Image
 			setupRowFuncGraySource( target );
 			if( mCustomPixelInc != 0 )
 				mRowFuncSourceInc = mCustomPixelInc;
+			if( TCM == CM_RGB ) {
+				if( RowFunc fastPath = setupRowFuncFastPath<SD,TD>() )
+					return fastPath;
+			}
 			bool alpha = ( mRowFuncSourceAlpha != -1 ) && ( mRowFuncTargetAlpha != -1 );
 			if( alpha )
 				return &ImageSource::rowFuncSourceGray<SD,TD,TCM,true>;
@@ -439,6 +863,97 @@ void writeImage( ImageTargetRef imageTarget, const ImageSourceRef &imageSource )
 	imageTarget->finalize();
 }
 
+template<typename T>
+void loadImageBands( const ImageSourceRef &imageSource, int32_t bandHeight, const typename ImageTargetBandsT<T>::BandFn &bandFn )
+{
+	writeImage( ImageTargetBandsT<T>::create( imageSource, bandHeight, bandFn ), imageSource );
+}
+
+template CI_API void loadImageBands<uint8_t>( const ImageSourceRef &imageSource, int32_t bandHeight, const ImageTargetBandsT<uint8_t>::BandFn &bandFn );
+template CI_API void loadImageBands<uint16_t>( const ImageSourceRef &imageSource, int32_t bandHeight, const ImageTargetBandsT<uint16_t>::BandFn &bandFn );
+template CI_API void loadImageBands<float>( const ImageSourceRef &imageSource, int32_t bandHeight, const ImageTargetBandsT<float>::BandFn &bandFn );
+
+///////////////////////////////////////////////////////////////////////////////
+// ImageTargetBandsT
+template<typename T>
+std::shared_ptr<ImageTargetBandsT<T>> ImageTargetBandsT<T>::create( const ImageSourceRef &imageSource, int32_t bandHeight, const BandFn &bandFn )
+{
+	return create( imageSource, bandHeight, bandFn, imageSource->hasAlpha() );
+}
+
+template<typename T>
+std::shared_ptr<ImageTargetBandsT<T>> ImageTargetBandsT<T>::create( const ImageSourceRef &imageSource, int32_t bandHeight, const BandFn &bandFn, bool alpha )
+{
+	if( bandHeight <= 0 )
+		throw ImageIoException( "Band height must be positive" );
+
+	return std::shared_ptr<ImageTargetBandsT<T>>( new ImageTargetBandsT<T>( imageSource, bandHeight, bandFn, alpha ) );
+}
+
+template<typename T>
+ImageTargetBandsT<T>::ImageTargetBandsT( const ImageSourceRef &imageSource, int32_t bandHeight, const BandFn &bandFn, bool alpha )
+	: ImageTarget(), mBand( imageSource->getWidth(), std::max( 1, std::min( bandHeight, imageSource->getHeight() ) ), alpha ),
+		mBandFn( bandFn ), mBandStart( 0 ), mBandRows( 0 )
+{
+	if( std::is_same<T,float>::value )
+		setDataType( ImageIo::FLOAT32 );
+	else if( std::is_same<T,uint16_t>::value )
+		setDataType( ImageIo::UINT16 );
+	else
+		setDataType( ImageIo::UINT8 );
+
+	setColorModel( ImageIo::CM_RGB );
+	setChannelOrder( ImageIo::ChannelOrder( mBand.getChannelOrder().getImageIoChannelOrder() ) );
+	mBand.setPremultiplied( imageSource->isPremultiplied() );
+
+	// not every row function writes alpha when the source lacks it, so fill it once for the lifetime of the band
+	if( alpha && ( ! imageSource->hasAlpha() ) )
+		ip::fill( &mBand.getChannelAlpha(), CHANTRAIT<T>::max() );
+}
+
+template<typename T>
+void* ImageTargetBandsT<T>::getRowPointer( int32_t row )
+{
+	if( row < mBandStart )
+		throw ImageIoException( "ImageTargetBands requires rows in increasing order" );
+
+	if( row >= mBandStart + mBand.getHeight() ) {
+		flushBand();
+		mBandStart = row;
+	}
+
+	mBandRows = std::max( mBandRows, row - mBandStart + 1 );
+	return mBand.getData( ivec2( 0, row - mBandStart ) );
+}
+
+template<typename T>
+void ImageTargetBandsT<T>::finalize()
+{
+	flushBand();
+}
+
+template<typename T>
+void ImageTargetBandsT<T>::flushBand()
+{
+	if( mBandRows == 0 )
+		return;
+
+	if( mBandRows == mBand.getHeight() )
+		mBandFn( mBand, mBandStart );
+	else {
+		SurfaceT<T> partial( mBand.getData(), mBand.getWidth(), mBandRows, mBand.getRowBytes(), mBand.getChannelOrder() );
+		partial.setPremultiplied( mBand.isPremultiplied() );
+		mBandFn( partial, mBandStart );
+	}
+
+	mBandStart += mBandRows;
+	mBandRows = 0;
+}
+
+template class CI_API ImageTargetBandsT<uint8_t>;
+template class CI_API ImageTargetBandsT<uint16_t>;
+template class CI_API ImageTargetBandsT<float>;
+
 ///////////////////////////////////////////////////////////////////////////////
 ImageIoRegistrar::Inst* ImageIoRegistrar::instance()
 {
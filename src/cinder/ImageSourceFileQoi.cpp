@@ -26,48 +26,12 @@
 #define QOI_IMPLEMENTATION
 #include "qoi/qoi.h"
 
-#include <cstdio>
-#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace cinder {
 
-namespace {
-
-// Cross-platform wrapper for qoi_read that handles Unicode paths properly
-void* qoiReadPath( const fs::path &path, qoi_desc *desc, int channels )
-{
-#if defined( CINDER_MSW )
-	FILE *f = _wfopen( path.wstring().c_str(), L"rb" );
-#else
-	FILE *f = fopen( path.string().c_str(), "rb" );
-#endif
-
-	if( ! f )
-		return nullptr;
-
-	fseek( f, 0, SEEK_END );
-	int size = ftell( f );
-	if( size <= 0 || fseek( f, 0, SEEK_SET ) != 0 ) {
-		fclose( f );
-		return nullptr;
-	}
-
-	void *data = malloc( size );
-	if( ! data ) {
-		fclose( f );
-		return nullptr;
-	}
-
-	int bytesRead = (int)fread( data, 1, size, f );
-	fclose( f );
-
-	void *pixels = ( bytesRead != size ) ? nullptr : qoi_decode( data, bytesRead, desc, channels );
-	free( data );
-	return pixels;
-}
-
-} // anonymous namespace
-
 ///////////////////////////////////////////////////////////////////////////////
 // Registrar
 void ImageSourceFileQoi::registerSelf()
@@ -86,34 +50,30 @@ void ImageSourceFileQoi::registerSelf()
 
 ///////////////////////////////////////////////////////////////////////////////
 // ImageSourceFileQoi
-ImageSourceFileQoi::ImageSourceFileQoi( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
-	: mData( nullptr ), mRowBytes( 0 )
+ImageSourceFileQoi::ImageSourceFileQoi( DataSourceRef dataSourceRef, ImageSource::Options options )
+	: mChannels( 0 )
 {
-	qoi_desc desc;
-	int channels = 0;
-
-	if( dataSourceRef->isFilePath() ) {
-		mData = (uint8_t*)qoiReadPath( dataSourceRef->getFilePath(), &desc, 0 );
-		if( ! mData )
-			throw ImageIoExceptionFailedLoad( "Failed to load QOI image" );
-
-		channels = desc.channels;
-		mRowBytes = desc.width * channels;
-	}
-	else { // we'll use a dataref from the buffer
-		BufferRef buffer = dataSourceRef->getBuffer();
-		mData = (uint8_t*)qoi_decode( buffer->getData(), (int)buffer->getSize(), &desc, 0 );
-		if( ! mData )
-			throw ImageIoExceptionFailedLoad( "Failed to decode QOI image" );
-
-		channels = desc.channels;
-		mRowBytes = desc.width * channels;
-	}
+	// only the stream is retained; pixels are decoded a row at a time in load()
+	mStream = dataSourceRef->createStream();
+	if( ! mStream || mStream->size() < QOI_HEADER_SIZE + (off_t)sizeof( qoi_padding ) )
+		throw ImageIoExceptionFailedLoad( "Failed to load QOI image" );
+
+	unsigned char header[QOI_HEADER_SIZE];
+	mStream->readData( header, QOI_HEADER_SIZE );
+
+	int p = 0;
+	unsigned int magic = qoi_read_32( header, &p );
+	unsigned int width = qoi_read_32( header, &p );
+	unsigned int height = qoi_read_32( header, &p );
+	mChannels = header[p++];
+	unsigned int colorspace = header[p++];
+	if( magic != QOI_MAGIC || width == 0 || height == 0 || colorspace > 1 || height >= QOI_PIXELS_MAX / width )
+		throw ImageIoExceptionFailedLoad( "Failed to decode QOI image" );
 
 	setDataType( ImageIo::UINT8 );
-	setSize( desc.width, desc.height );
+	setSizeReduced( (int32_t)width, (int32_t)height, options );
 
-	switch( channels ) {
+	switch( mChannels ) {
 		case 3:
 			setColorModel( ImageIo::CM_RGB );
 			setChannelOrder( ImageIo::ChannelOrder::RGB );
@@ -123,23 +83,91 @@ ImageSourceFileQoi::ImageSourceFileQoi( DataSourceRef dataSourceRef, ImageSource
 			setChannelOrder( ImageIo::ChannelOrder::RGBA );
 		break;
 		default:
-			free( mData );
 			throw ImageIoException( "QOI: Unsupported number of channels" );
 	}
 }
 
-
-ImageSourceFileQoi::~ImageSourceFileQoi()
-{
-	if( mData )
-		free( mData );
-}
-
 void ImageSourceFileQoi::load( ImageTargetRef target )
 {
 	ImageSource::RowFunc func = setupRowFunc( target );
-	for( int32_t row = 0; row < mHeight; ++row ) {
-		((*this).*func)( target, row, mData + row * mRowBytes );
+
+	// mirrors qoi_decode(), but reads the stream through a small window and emits each row as soon as it is complete
+	const size_t MAX_OP_SIZE = 5;
+	std::vector<unsigned char> input( 64 * 1024 + sizeof( qoi_padding ) );
+	size_t p = 0, inputLen = 0;
+	off_t remaining = mStream->size() - QOI_HEADER_SIZE - (off_t)sizeof( qoi_padding );
+	mStream->seekAbsolute( QOI_HEADER_SIZE );
+	int run = 0;
+
+	qoi_rgba_t index[64];
+	QOI_ZEROARR( index );
+	qoi_rgba_t px;
+	px.rgba.r = 0;
+	px.rgba.g = 0;
+	px.rgba.b = 0;
+	px.rgba.a = 255;
+
+	const int rowLen = mFullWidth * mChannels;
+	std::vector<uint8_t> rowData( rowLen );
+	for( int32_t row = 0; row < mFullHeight; ++row ) {
+		for( int pxPos = 0; pxPos < rowLen; pxPos += mChannels ) {
+			if( run == 0 && inputLen - p < MAX_OP_SIZE && remaining > 0 ) {
+				memmove( input.data(), input.data() + p, inputLen - p );
+				inputLen -= p;
+				p = 0;
+				const size_t bytes = (size_t)std::min<off_t>( remaining, (off_t)( input.size() - sizeof( qoi_padding ) - inputLen ) );
+				mStream->readData( input.data() + inputLen, bytes );
+				inputLen += bytes;
+				remaining -= bytes;
+			}
+
+			if( run > 0 ) {
+				run--;
+			}
+			else if( p < inputLen ) {
+				int b1 = input[p++];
+
+				if( b1 == QOI_OP_RGB ) {
+					px.rgba.r = input[p++];
+					px.rgba.g = input[p++];
+					px.rgba.b = input[p++];
+				}
+				else if( b1 == QOI_OP_RGBA ) {
+					px.rgba.r = input[p++];
+					px.rgba.g = input[p++];
+					px.rgba.b = input[p++];
+					px.rgba.a = input[p++];
+				}
+				else if( ( b1 & QOI_MASK_2 ) == QOI_OP_INDEX ) {
+					px = index[b1];
+				}
+				else if( ( b1 & QOI_MASK_2 ) == QOI_OP_DIFF ) {
+					px.rgba.r += ( ( b1 >> 4 ) & 0x03 ) - 2;
+					px.rgba.g += ( ( b1 >> 2 ) & 0x03 ) - 2;
+					px.rgba.b += ( b1 & 0x03 ) - 2;
+				}
+				else if( ( b1 & QOI_MASK_2 ) == QOI_OP_LUMA ) {
+					int b2 = input[p++];
+					int vg = ( b1 & 0x3f ) - 32;
+					px.rgba.r += vg - 8 + ( ( b2 >> 4 ) & 0x0f );
+					px.rgba.g += vg;
+					px.rgba.b += vg - 8 + ( b2 & 0x0f );
+				}
+				else if( ( b1 & QOI_MASK_2 ) == QOI_OP_RUN ) {
+					run = ( b1 & 0x3f );
+				}
+
+				index[QOI_COLOR_HASH( px ) & ( 64 - 1 )] = px;
+			}
+
+			rowData[pxPos + 0] = px.rgba.r;
+			rowData[pxPos + 1] = px.rgba.g;
+			rowData[pxPos + 2] = px.rgba.b;
+			if( mChannels == 4 )
+				rowData[pxPos + 3] = px.rgba.a;
+		}
+
+		processRow( func, target, row, rowData.data() );
 	}
 }
 
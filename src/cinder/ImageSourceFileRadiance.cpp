@@ -25,6 +25,9 @@
 #include "cinder/ImageSourceFileRadiance.h"
 #include "cinder/Stream.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace cinder {
 
 ImageSourceRef ImageSourceFileRadiance::create( DataSourceRef dataSourceRef, ImageSource::Options options )
@@ -32,27 +35,17 @@ ImageSourceRef ImageSourceFileRadiance::create( DataSourceRef dataSourceRef, Ima
 	return ImageSourceRef( new ImageSourceFileRadiance( dataSourceRef, options ) );
 }
 
-void ImageSourceFileRadiance::load( ImageTargetRef target )
-{
-	// get a pointer to the ImageSource function appropriate for handling our data configuration
-	ImageSource::RowFunc func = setupRowFunc( target );
-	//int number_passes = png_set_interlace_handling( mPngPtr );
-	for( int32_t row = 0; row < mHeight; ++row ) {
-		((*this).*func)( target, row, mRgbData.get() + ( row * mWidth * 3 ) );
-	}
-}
-
 void ImageSourceFileRadiance::registerSelf()
 {
 	ImageIoRegistrar::SourceCreationFunc sourceFunc = ImageSourceFileRadiance::create;
 	ImageIoRegistrar::registerSourceType( "hdr", sourceFunc, 1 );
 }
 
-ImageSourceFileRadiance::ImageSourceFileRadiance( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
+ImageSourceFileRadiance::ImageSourceFileRadiance( DataSourceRef dataSourceRef, ImageSource::Options options )
 {
-	IStreamRef stream = dataSourceRef->createStream();
+	mStream = dataSourceRef->createStream();
 
-	loadStream( stream );
+	loadHeader( options );
 }
 
 namespace {
@@ -68,8 +61,10 @@ bool decrunchScanline( RgbePixel *scanline, int len, IStreamCinder *stream );
 bool oldStyleDecrunch( RgbePixel *scanline, int len, IStreamCinder *stream );
 }
 
-void ImageSourceFileRadiance::loadStream( IStreamRef stream )
+void ImageSourceFileRadiance::loadHeader( const ImageSource::Options &options )
 {
+	IStreamCinder *stream = mStream.get();
+
 	setDataType( ImageIo::FLOAT32 );
 	setColorModel( ImageIo::CM_RGB );
 	setChannelOrder( ImageIo::RGB );
@@ -112,18 +107,31 @@ void ImageSourceFileRadiance::loadStream( IStreamRef stream )
 	int width, height;
 	if( ! sscanf( resolution, "-Y %d +X %d", &height, &width ) )
 		throw ImageSourceFileRadianceException( "Unable to parse size" );
-	setSize( width, height );
+	setSizeReduced( width, height, options );
 
-	mRgbData = std::unique_ptr<float[]>( new float[width * height * 3] );
-	std::unique_ptr<RgbePixel[]> scanline( new RgbePixel[width] );
+	mDataOffset = stream->tell();
+}
 
-	// convert image
-	float *cols = mRgbData.get();
-	for( int y = height - 1; y >= 0; y-- ) {
-		if( ! decrunchScanline( scanline.get(), width, stream.get() ) )
-			break;
-		workOnRgbeScanline( scanline.get(), width, cols );
-		cols += width * 3;
+void ImageSourceFileRadiance::load( ImageTargetRef target )
+{
+	// get a pointer to the ImageSource function appropriate for handling our data configuration
+	ImageSource::RowFunc func = setupRowFunc( target );
+
+	// scanlines are decoded straight from the stream, so only a single row is ever resident
+	std::unique_ptr<RgbePixel[]> scanline( new RgbePixel[mFullWidth] );
+	std::vector<float> cols( mFullWidth * 3, 0.0f );
+
+	mStream->seekAbsolute( mDataOffset );
+	bool valid = true;
+	for( int32_t row = 0; row < mFullHeight; ++row ) {
+		// a truncated file leaves the remaining rows black
+		valid = valid && decrunchScanline( scanline.get(), mFullWidth, mStream.get() );
+		if( valid )
+			workOnRgbeScanline( scanline.get(), mFullWidth, cols.data() );
+		else
+			std::fill( cols.begin(), cols.end(), 0.0f );
+
+		processRow( func, target, row, cols.data() );
 	}
 }
 
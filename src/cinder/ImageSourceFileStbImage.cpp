@@ -27,9 +27,83 @@
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
 #include "stb/stb_image.h"
+#include "cinder/Stream.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 namespace cinder {
 
+namespace {
+
+constexpr uint32_t pngChunkType( char a, char b, char c, char d )
+{
+	return ( uint32_t( a ) << 24 ) | ( uint32_t( b ) << 16 ) | ( uint32_t( c ) << 8 ) | uint32_t( d );
+}
+
+const uint32_t PNG_IHDR = pngChunkType( 'I', 'H', 'D', 'R' );
+const uint32_t PNG_PLTE = pngChunkType( 'P', 'L', 'T', 'E' );
+const uint32_t PNG_TRNS = pngChunkType( 't', 'R', 'N', 'S' );
+const uint32_t PNG_IDAT = pngChunkType( 'I', 'D', 'A', 'T' );
+const uint32_t PNG_IEND = pngChunkType( 'I', 'E', 'N', 'D' );
+
+int pngChannels( uint8_t colorType )
+{
+	switch( colorType ) {
+		case 0: return 1; // gray
+		case 2: return 3; // rgb
+		case 3: return 1; // palette index
+		case 4: return 2; // gray + alpha
+		case 6: return 4; // rgba
+		default: return 0;
+	}
+}
+
+uint8_t paeth( int a, int b, int c )
+{
+	int p = a + b - c;
+	int pa = abs( p - a ), pb = abs( p - b ), pc = abs( p - c );
+	if( pa <= pb && pa <= pc )
+		return (uint8_t)a;
+	return (uint8_t)( ( pb <= pc ) ? b : c );
+}
+
+// reverses the PNG filter \a filter on \a cur in place, given the already unfiltered previous row \a prev
+void unfilterPngRow( uint8_t filter, uint8_t *cur, const uint8_t *prev, size_t rowBytes, size_t bpp )
+{
+	switch( filter ) {
+		case 0: // none
+		break;
+		case 1: // sub
+			for( size_t i = bpp; i < rowBytes; ++i )
+				cur[i] += cur[i - bpp];
+		break;
+		case 2: // up
+			for( size_t i = 0; i < rowBytes; ++i )
+				cur[i] += prev[i];
+		break;
+		case 3: // average
+			for( size_t i = 0; i < bpp; ++i )
+				cur[i] += prev[i] >> 1;
+			for( size_t i = bpp; i < rowBytes; ++i )
+				cur[i] += ( cur[i - bpp] + prev[i] ) >> 1;
+		break;
+		case 4: // paeth
+			for( size_t i = 0; i < bpp; ++i )
+				cur[i] += prev[i];
+			for( size_t i = bpp; i < rowBytes; ++i )
+				cur[i] += paeth( cur[i - bpp], prev[i], prev[i - bpp] );
+		break;
+		default:
+			throw ImageIoExceptionFailedLoad( "PNG: invalid filter type" );
+	}
+}
+
+} // anonymous namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 // Registrar
 void ImageSourceFileStbImage::registerSelf()
@@ -57,74 +131,82 @@ void ImageSourceFileStbImage::registerSelf()
 
 ///////////////////////////////////////////////////////////////////////////////
 // ImageSourceFileStbImage
-ImageSourceFileStbImage::ImageSourceFileStbImage( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
-	: mData8u( nullptr ), mData32f( nullptr ), mRowBytes( 0 )
+ImageSourceFileStbImage::ImageSourceFileStbImage( DataSourceRef dataSourceRef, ImageSource::Options options )
+	: mData8u( nullptr ), mData32f( nullptr ), mRowBytes( 0 ), mPngDataOffset( 0 ), mPngColorType( 0 )
 {
 	int width = 0, height = 0, components = 0;
 
+	if( parsePngHeader( dataSourceRef, &width, &height, &components ) )
+		mDataSource = dataSourceRef;
+	else
+		decode( dataSourceRef, &width, &height, &components );
+
+	if( mData32f )
+		setDataType( ImageIo::FLOAT32 );
+	else
+		setDataType( ImageIo::UINT8 );
+	setSizeReduced( width, height, options );
+
+	switch( components ) {
+		case 1:
+			setColorModel( ImageIo::CM_GRAY );
+			setChannelOrder( ImageIo::ChannelOrder::Y );
+		break;
+		case 2:
+			setColorModel( ImageIo::CM_GRAY );
+			setChannelOrder( ImageIo::ChannelOrder::YA );
+		break;
+		case 3:
+			setColorModel( ImageIo::CM_RGB );
+			setChannelOrder( ImageIo::ChannelOrder::RGB );			
+		break;
+		case 4:
+			setColorModel( ImageIo::CM_RGB );
+			setChannelOrder( ImageIo::ChannelOrder::RGBA );
+		break;
+		default:
+			throw ImageIoException();
+	}
+}
+
+
+void ImageSourceFileStbImage::decode( const DataSourceRef &dataSourceRef, int *width, int *height, int *components )
+{
 	if( dataSourceRef->isFilePath() ) {
 		if( stbi_is_hdr( dataSourceRef->getFilePath().string().c_str() ) ) {
-			mData32f = stbi_loadf( dataSourceRef->getFilePath().string().c_str(), &width, &height, &components, 0 /*any # of components*/ );
+			mData32f = stbi_loadf( dataSourceRef->getFilePath().string().c_str(), width, height, components, 0 /*any # of components*/ );
 			if( ! mData32f )
 				throw ImageIoException( stbi_failure_reason() );
 
-			mRowBytes = width * components * sizeof( float );
+			mRowBytes = *width * *components * sizeof( float );
 		}
 		else {
-			mData8u = stbi_load( dataSourceRef->getFilePath().string().c_str(), &width, &height, &components, 0 /*any # of components*/ );
+			mData8u = stbi_load( dataSourceRef->getFilePath().string().c_str(), width, height, components, 0 /*any # of components*/ );
 			if( ! mData8u )
 				throw ImageIoException( stbi_failure_reason() );
 
-			mRowBytes = width * components;
+			mRowBytes = *width * *components;
 		}
 	}
 	else { // we'll use a dataref from the buffer
 		BufferRef buffer = dataSourceRef->getBuffer();
 		if( stbi_is_hdr_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize() ) ) {
-			mData32f = stbi_loadf_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize(), &width, &height, &components, 0 /*any # of components*/ );
+			mData32f = stbi_loadf_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize(), width, height, components, 0 /*any # of components*/ );
 			if( ! mData32f )
 				throw ImageIoException( stbi_failure_reason() );
 			
-			mRowBytes = width * components * sizeof(float);
+			mRowBytes = *width * *components * sizeof(float);
 		}
 		else {
-			mData8u = stbi_load_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize(), &width, &height, &components, 0 /*any # of components*/ );
+			mData8u = stbi_load_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize(), width, height, components, 0 /*any # of components*/ );
 			if( ! mData8u )
 				throw ImageIoException( stbi_failure_reason() );
 				
-			mRowBytes = width * components;
+			mRowBytes = *width * *components;
 		}
 	}
-
-	if( mData8u )
-		setDataType( ImageIo::UINT8 );
-	else if( mData32f )
-		setDataType( ImageIo::FLOAT32 );
-	setSize( width, height );
-
-	switch( components ) {
-		case 1:
-			setColorModel( ImageIo::CM_GRAY );
-			setChannelOrder( ImageIo::ChannelOrder::Y );
-		break;
-		case 2:
-			setColorModel( ImageIo::CM_GRAY );
-			setChannelOrder( ImageIo::ChannelOrder::YA );
-		break;
-		case 3:
-			setColorModel( ImageIo::CM_RGB );
-			setChannelOrder( ImageIo::ChannelOrder::RGB );			
-		break;
-		case 4:
-			setColorModel( ImageIo::CM_RGB );
-			setChannelOrder( ImageIo::ChannelOrder::RGBA );
-		break;
-		default:
-			throw ImageIoException();
-	}
 }
 
-
 ImageSourceFileStbImage::~ImageSourceFileStbImage()
 {
 	if( mData8u )
@@ -133,12 +215,177 @@ ImageSourceFileStbImage::~ImageSourceFileStbImage()
 		stbi_image_free( (void*)mData32f );
 }
 
+bool ImageSourceFileStbImage::parsePngHeader( const DataSourceRef &dataSourceRef, int *width, int *height, int *components )
+{
+	static const uint8_t signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+	IStreamRef stream = dataSourceRef->createStream();
+	if( ! stream || stream->size() < 8 )
+		return false;
+
+	// anything other than a well-formed, non-interlaced 8-bit PNG is left to stb_image, including its error reporting
+	try {
+		uint8_t fileSignature[8];
+		stream->readData( fileSignature, 8 );
+		if( memcmp( fileSignature, signature, 8 ) != 0 )
+			return false;
+
+		bool hasHeader = false, hasTransparency = false;
+		std::vector<uint8_t> palette;
+		while( true ) {
+			const off_t chunkStart = stream->tell();
+			uint32_t length, type;
+			stream->readBig( &length );
+			stream->readBig( &type );
+
+			if( ! hasHeader ) {
+				if( type != PNG_IHDR || length != 13 )
+					return false;
+				uint32_t w, h;
+				uint8_t bitDepth, colorType, compression, filter, interlace;
+				stream->readBig( &w );
+				stream->readBig( &h );
+				stream->read( &bitDepth );
+				stream->read( &colorType );
+				stream->read( &compression );
+				stream->read( &filter );
+				stream->read( &interlace );
+				if( w == 0 || h == 0 || w > ( 1 << 24 ) || h > ( 1 << 24 ) || bitDepth != 8 || compression != 0 || filter != 0 || interlace != 0 || pngChannels( colorType ) == 0 )
+					return false;
+				*width = (int)w;
+				*height = (int)h;
+				mPngColorType = colorType;
+				hasHeader = true;
+			}
+			else if( type == PNG_PLTE && mPngColorType == 3 ) {
+				if( length == 0 || length > 768 || length % 3 != 0 )
+					return false;
+				palette.assign( 256 * 4, 0 );
+				for( uint32_t i = 0; i < 256; ++i )
+					palette[i * 4 + 3] = 255;
+				for( uint32_t i = 0; i < length / 3; ++i )
+					stream->readData( &palette[i * 4], 3 );
+			}
+			else if( type == PNG_TRNS ) {
+				// color-keyed transparency is only handled for palettes
+				if( mPngColorType != 3 || palette.empty() || length > 256 )
+					return false;
+				for( uint32_t i = 0; i < length; ++i )
+					stream->read( &palette[i * 4 + 3] );
+				hasTransparency = true;
+			}
+			else if( type == PNG_IDAT ) {
+				if( mPngColorType == 3 && palette.empty() )
+					return false;
+				mPngDataOffset = chunkStart;
+				break;
+			}
+			else if( type == PNG_IEND )
+				return false;
+			else
+				stream->seekRelative( length );
+
+			// skip the CRC
+			stream->seekRelative( 4 );
+		}
+
+		if( mPngColorType == 3 )
+			*components = hasTransparency ? 4 : 3;
+		else
+			*components = pngChannels( mPngColorType );
+		mPngPalette = std::move( palette );
+		mPngStream = stream;
+		return true;
+	}
+	catch( StreamExc & ) {
+		return false;
+	}
+}
+
+void ImageSourceFileStbImage::loadPng( ImageTargetRef target, ImageSource::RowFunc func )
+{
+	const size_t bpp = pngChannels( mPngColorType );
+	const size_t rowBytes = mFullWidth * bpp;
+
+	// the filter byte precedes every row; the previous row starts out as zeros
+	std::vector<uint8_t> rows( 2 * ( rowBytes + 1 ), 0 );
+	uint8_t *prev = rows.data();
+	uint8_t *cur = rows.data() + rowBytes + 1;
+	std::vector<uint8_t> expanded( mPngPalette.empty() ? 0 : mFullWidth * 4 );
+	const int expandedChannels = hasAlpha() ? 4 : 3;
+	std::vector<uint8_t> input( 64 * 1024 );
+
+	z_stream zs;
+	memset( &zs, 0, sizeof( zs ) );
+	if( inflateInit( &zs ) != Z_OK )
+		throw ImageIoExceptionFailedLoad( "PNG: failed to initialize zlib" );
+	std::unique_ptr<z_stream, int(*)( z_stream* )> inflateGuard( &zs, inflateEnd );
+
+	mPngStream->seekAbsolute( mPngDataOffset );
+	uint32_t chunkRemaining = 0;
+	bool inChunk = false;
+	for( int32_t row = 0; row < mFullHeight; ++row ) {
+		zs.next_out = cur;
+		zs.avail_out = (uInt)( rowBytes + 1 );
+		while( zs.avail_out > 0 ) {
+			if( zs.avail_in == 0 ) {
+				while( chunkRemaining == 0 ) {
+					if( inChunk )
+						mPngStream->seekRelative( 4 ); // CRC of the previous IDAT
+					uint32_t type;
+					mPngStream->readBig( &chunkRemaining );
+					mPngStream->readBig( &type );
+					if( type != PNG_IDAT )
+						throw ImageIoExceptionFailedLoad( "PNG: image data is truncated" );
+					inChunk = true;
+				}
+				const uint32_t bytes = std::min<uint32_t>( chunkRemaining, (uint32_t)input.size() );
+				mPngStream->readData( input.data(), bytes );
+				chunkRemaining -= bytes;
+				zs.next_in = input.data();
+				zs.avail_in = bytes;
+			}
+
+			int status = inflate( &zs, Z_NO_FLUSH );
+			if( ( status == Z_STREAM_END && zs.avail_out > 0 ) || ( status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR ) )
+				throw ImageIoExceptionFailedLoad( "PNG: corrupt image data" );
+		}
+
+		unfilterPngRow( cur[0], cur + 1, prev + 1, rowBytes, bpp );
+
+		if( ! expanded.empty() ) {
+			for( int32_t x = 0; x < mFullWidth; ++x )
+				memcpy( &expanded[x * expandedChannels], &mPngPalette[cur[1 + x] * 4], expandedChannels );
+			processRow( func, target, row, expanded.data() );
+		}
+		else
+			processRow( func, target, row, cur + 1 );
+
+		std::swap( prev, cur );
+	}
+}
+
 void ImageSourceFileStbImage::load( ImageTargetRef target )
 {
+	if( mDataSource ) {
+		if( target->isBanded() ) {
+			loadPng( target, setupRowFunc( target ) );
+			return;
+		}
+
+		// everything else goes through stb_image, and keeps the result for further loads
+		int width, height, components;
+		decode( mDataSource, &width, &height, &components );
+		mDataSource.reset();
+		mPngStream.reset();
+		if( width != mFullWidth || height != mFullHeight || components != channelOrderNumChannels( getChannelOrder() ) )
+			throw ImageIoExceptionFailedLoad( "PNG: header doesn't match the decoded image" );
+	}
+
 	ImageSource::RowFunc func = setupRowFunc( target );
 	const uint8_t *data = ( mData8u ) ? mData8u : reinterpret_cast<uint8_t*>( mData32f );
-	for( int32_t row = 0; row < mHeight; ++row ) {
-		((*this).*func)( target, row, data + row * mRowBytes );
+	for( int32_t row = 0; row < mFullHeight; ++row ) {
+		processRow( func, target, row, data + row * mRowBytes );
 	}
 }
 
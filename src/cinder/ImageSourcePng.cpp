@@ -76,7 +76,7 @@ ImageSourcePngRef ImageSourcePng::createRef( DataSourceRef dataSourceRef, ImageS
 	return ImageSourcePngRef( new ImageSourcePng( dataSourceRef, options ) );
 }
 
-ImageSourcePng::ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
+ImageSourcePng::ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Options options )
 	: ImageSource(), mInfoPtr( 0 ), mPngPtr( 0 )
 {
 	mPngPtr = png_create_read_struct( PNG_LIBPNG_VER_STRING, (png_voidp)NULL, NULL, NULL );
@@ -96,12 +96,12 @@ ImageSourcePng::ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Option
 		throw ImageSourcePngException( "Could not destroy png read struct." );
 	}
 	
-	if( ! loadHeader() )
+	if( ! loadHeader( options ) )
 		throw ImageSourcePngException( "Could not load png header." );
 }
 
 // part of this being separated allows for us to play nicely with the setjmp of libpng
-bool ImageSourcePng::loadHeader()
+bool ImageSourcePng::loadHeader( const ImageSource::Options &options )
 {
 	bool success = true;
 
@@ -120,7 +120,7 @@ bool ImageSourcePng::loadHeader()
 			return false;
 		}
 
-		setSize( width, height );
+		setSizeReduced( width, height, options );
 		setDataType( ( bitDepth == 16 ) ? ImageIo::UINT16 : ImageIo::UINT8 );
 		
 	#ifdef CINDER_LITTLE_ENDIAN
@@ -178,9 +178,9 @@ void ImageSourcePng::load( ImageTargetRef target )
 		ImageSource::RowFunc func = setupRowFunc( target );
 		//int number_passes = png_set_interlace_handling( mPngPtr );
 		unique_ptr<png_byte[]> row_pointer( new png_byte[png_get_rowbytes( mPngPtr, mInfoPtr )] );
-		for( int32_t row = 0; row < mHeight; ++row ) {
+		for( int32_t row = 0; row < mFullHeight; ++row ) {
 			png_read_row( mPngPtr, row_pointer.get(), NULL );
-			((*this).*func)( target, row, row_pointer.get() );
+			processRow( func, target, row, row_pointer.get() );
 		}
 	}
 	
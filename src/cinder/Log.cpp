@@ -25,6 +25,7 @@
 #include "cinder/CinderAssert.h"
 #include "cinder/Utilities.h"
 #include "cinder/Breakpoint.h"
+#include "cinder/Thread.h"
 #include "cinder/app/Platform.h"
 
 #if defined( CINDER_COCOA )
@@ -48,6 +49,8 @@
 #endif
 
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <algorithm>
 #include <time.h>
 #include <cstring>
@@ -59,9 +62,9 @@ namespace cinder { namespace log {
 namespace  {
 
 // output format is YYYY-MM-DD.HH:mm:ss
-const std::string getCurrentDateTimeString()
+const std::string getDateTimeString( const chrono::system_clock::time_point &time )
 {
-	time_t timeSinceEpoch = time( NULL );
+	time_t timeSinceEpoch = ( time == chrono::system_clock::time_point() ) ? ::time( NULL ) : chrono::system_clock::to_time_t( time );
 	struct tm *now = localtime( &timeSinceEpoch );
 
 	char result[100];
@@ -91,6 +94,331 @@ const std::string getDailyLogString( const std::string& format )
 
 } // anonymous namespace
 
+// ----------------------------------------------------------------------------------------------------
+// EntryStream
+// ----------------------------------------------------------------------------------------------------
+
+namespace detail {
+
+//! An ostream formatting into a string whose capacity is kept from one entry to the next
+class EntryStream : private std::streambuf, public std::ostream {
+  public:
+	EntryStream()
+		: std::ostream( this )
+	{}
+
+	//! Starts a new entry, restoring the formatting state of a newly constructed stream
+	void begin()
+	{
+		mText.resize( std::max<size_t>( mText.capacity(), 256 ) );
+		setp( &mText[0], &mText[0] + mText.size() );
+		clear();
+		flags( std::ios_base::dec | std::ios_base::skipws );
+		precision( 6 );
+		width( 0 );
+		fill( ' ' );
+	}
+
+	//! Returns the text formatted since begin(). Further output is appended.
+	const std::string& str()
+	{
+		const size_t size = pptr() - pbase();
+		mText.resize( size );
+		setp( &mText[0], &mText[0] + size );
+		pbump( int( size ) );
+		return mText;
+	}
+
+	size_t getCapacity() const	{ return mText.capacity(); }
+
+  private:
+	using std::streambuf::int_type;
+	using std::streambuf::traits_type;
+
+	int_type overflow( int_type ch ) override
+	{
+		if( traits_type::eq_int_type( ch, traits_type::eof() ) )
+			return traits_type::not_eof( ch );
+
+		const size_t size = pptr() - pbase();
+		mText.resize( std::max( mText.capacity(), 2 * size ) );
+		setp( &mText[0], &mText[0] + mText.size() );
+		pbump( int( size ) );
+		*pptr() = traits_type::to_char_type( ch );
+		pbump( 1 );
+		return ch;
+	}
+
+	std::string		mText;
+};
+
+} // namespace detail
+
+namespace {
+
+// streams larger than this are freed rather than kept for the next entry
+const size_t MAX_POOLED_ENTRY_CAPACITY = 64 * 1024;
+
+// trivially destructible, so it can still be read while the thread's pool is being destroyed, or afterwards
+thread_local bool tEntryStreamPoolDestroyed = false;
+
+// Each thread keeps the streams of finished entries for reuse. There is more than one when entries nest, as when formatting calls a function that logs.
+struct EntryStreamPool {
+	~EntryStreamPool()	{ tEntryStreamPoolDestroyed = true; }
+
+	std::vector<std::unique_ptr<detail::EntryStream>>	mStreams;
+};
+
+EntryStreamPool* getEntryStreamPool()
+{
+	if( tEntryStreamPoolDestroyed )
+		return nullptr;
+
+	static thread_local EntryStreamPool sPool;
+	return &sPool;
+}
+
+// the AsyncWriter whose thread this is, if any
+thread_local const void *tAsyncWriterOfThread = nullptr;
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------------------------------
+// LogManager::AsyncWriter
+// ----------------------------------------------------------------------------------------------------
+
+// A bounded multiple-producer, single-consumer queue of entries, after Dmitry Vyukov's bounded MPMC queue: producers claim a cell by
+// advancing mEnqueuePos and publish it through the cell's sequence number. The writer thread formats entries in place, so a cell's
+// strings keep their capacity from one lap of the ring to the next.
+class LogManager::AsyncWriter : private Noncopyable {
+  public:
+	AsyncWriter( LogManager *manager, size_t queueSize, OverflowPolicy policy )
+		: mManager( manager ), mPolicy( policy ), mEnqueuePos( 0 ), mNumWritten( 0 ), mDequeuePos( 0 ), mNumDropped( 0 ), mNumDroppedReported( 0 ),
+			mWriterWaiting( false ), mStopping( false )
+	{
+		const size_t size = calcNumCells( queueSize );
+		mCells.reset( new Cell[size] );
+		mMask = size - 1;
+		for( size_t i = 0; i < size; ++i )
+			mCells[i].mSequence.store( i, memory_order_relaxed );
+
+		mThread = std::thread( &AsyncWriter::run, this );
+	}
+
+	~AsyncWriter()
+	{
+		stop();
+	}
+
+	//! Queues an entry, or drops it when the queue is full and the policy allows. Returns false if the writer has stopped, in which case the caller should write the entry itself.
+	bool push( Metadata &&meta, const std::string &text )
+	{
+		Cell *cell;
+		size_t pos = mEnqueuePos.load( memory_order_relaxed );
+		while( true ) {
+			cell = &mCells[pos & mMask];
+			const intptr_t diff = intptr_t( cell->mSequence.load( memory_order_acquire ) ) - intptr_t( pos );
+			if( diff == 0 ) {
+				if( mEnqueuePos.compare_exchange_weak( pos, pos + 1, memory_order_relaxed ) )
+					break;
+			}
+			else if( diff < 0 ) {
+				// full; a Logger logging on the writer thread can't wait for itself
+				if( mPolicy.load( memory_order_relaxed ) == OVERFLOW_DROP || isWriterThread() ) {
+					mNumDropped.fetch_add( 1, memory_order_relaxed );
+					return true;
+				}
+				if( mStopping.load( memory_order_acquire ) )
+					return false;
+				// drain() frees cells before taking mWakeMutex to notify, so checking for room under the mutex can't miss it
+				wakeWriter();
+				{
+					unique_lock<mutex> lock( mWakeMutex );
+					mWrittenCv.wait( lock, [&] { return isWritable() || mStopping.load( memory_order_acquire ); } );
+				}
+				pos = mEnqueuePos.load( memory_order_relaxed );
+			}
+			else
+				pos = mEnqueuePos.load( memory_order_relaxed );
+		}
+
+		cell->mMeta = std::move( meta );
+		cell->mText.assign( text );
+		cell->mSequence.store( pos + 1, memory_order_release );
+
+		// pairs with the fence in run(), so that either the writer sees the entry before sleeping or we see it waiting
+		atomic_thread_fence( memory_order_seq_cst );
+		if( mWriterWaiting.load( memory_order_relaxed ) )
+			wakeWriter();
+
+		return true;
+	}
+
+	void flush()
+	{
+		if( isWriterThread() )
+			return;
+
+		const size_t target = mEnqueuePos.load( memory_order_acquire );
+		unique_lock<mutex> lock( mWakeMutex );
+		mWrittenCv.wait( lock, [&] { return mNumWritten.load( memory_order_acquire ) >= target || mStopped; } );
+	}
+
+	//! Writes everything queued and joins the writer thread
+	void stop()
+	{
+		if( ! mThread.joinable() )
+			return;
+
+		mStopping.store( true, memory_order_release );
+		wakeWriter();
+		mThread.join();
+		// entries pushed after the writer thread's last look at the queue
+		drain();
+		{
+			lock_guard<mutex> lock( mWakeMutex );
+			mStopped = true;
+		}
+		mWrittenCv.notify_all();
+	}
+
+	//! Starts writing again after stop(), under \a policy. Entries pushed into the queue in the meantime are written first.
+	void restart( OverflowPolicy policy )
+	{
+		mPolicy.store( policy, memory_order_relaxed );
+		mNumDropped.store( 0, memory_order_relaxed );
+		mNumDroppedReported = 0;
+		mStopping.store( false, memory_order_release );
+		{
+			lock_guard<mutex> lock( mWakeMutex );
+			mStopped = false;
+		}
+		mThread = std::thread( &AsyncWriter::run, this );
+	}
+
+	//! Returns the number of cells a queue of \a queueSize entries is rounded up to
+	static size_t calcNumCells( size_t queueSize )
+	{
+		size_t result = 2;
+		while( result < queueSize )
+			result *= 2;
+		return result;
+	}
+
+	size_t		getNumCells() const		{ return mMask + 1; }
+	bool		isWriterThread() const	{ return tAsyncWriterOfThread == this; }
+	uint64_t	getNumDropped() const	{ return mNumDropped.load( memory_order_relaxed ); }
+
+  private:
+	struct Cell {
+		std::atomic<size_t>		mSequence;
+		Metadata				mMeta;
+		std::string				mText;
+	};
+
+	// the most entries written while holding the LogManager's mutex
+	static const size_t MAX_BATCH_SIZE = 256;
+
+	void run()
+	{
+		ThreadSetup threadSetup;
+		tAsyncWriterOfThread = this;
+
+		while( true ) {
+			if( drain() > 0 )
+				continue;
+			if( mStopping.load( memory_order_acquire ) )
+				break;
+
+			mWriterWaiting.store( true, memory_order_relaxed );
+			atomic_thread_fence( memory_order_seq_cst );
+			{
+				unique_lock<mutex> lock( mWakeMutex );
+				mWakeCv.wait( lock, [&] { return isReadable() || mStopping.load( memory_order_acquire ); } );
+			}
+			mWriterWaiting.store( false, memory_order_relaxed );
+		}
+	}
+
+	bool isReadable() const
+	{
+		return mCells[mDequeuePos & mMask].mSequence.load( memory_order_acquire ) == mDequeuePos + 1;
+	}
+
+	bool isWritable() const
+	{
+		const size_t pos = mEnqueuePos.load( memory_order_relaxed );
+		return intptr_t( mCells[pos & mMask].mSequence.load( memory_order_acquire ) ) - intptr_t( pos ) >= 0;
+	}
+
+	void wakeWriter()
+	{
+		{
+			lock_guard<mutex> lock( mWakeMutex );
+		}
+		mWakeCv.notify_one();
+	}
+
+	//! Writes up to MAX_BATCH_SIZE queued entries and flushes the Loggers, returning the number of entries written
+	size_t drain()
+	{
+		size_t count = 0;
+		{
+			lock_guard<mutex> lock( mManager->mMutex );
+			while( count < MAX_BATCH_SIZE && isReadable() ) {
+				Cell &cell = mCells[mDequeuePos & mMask];
+				mManager->writeLocked( cell.mMeta, cell.mText );
+				cell.mSequence.store( mDequeuePos + mMask + 1, memory_order_release );
+				++mDequeuePos;
+				++count;
+			}
+
+			const uint64_t numDropped = mNumDropped.load( memory_order_relaxed );
+			if( numDropped != mNumDroppedReported ) {
+				Metadata meta;
+				meta.mLevel = LEVEL_WARNING;
+				meta.mLocation = Location( CINDER_CURRENT_FUNCTION, __FILE__, __LINE__ );
+				mManager->writeLocked( meta, to_string( numDropped - mNumDroppedReported ) + " log entries were dropped because the asynchronous log queue was full" );
+				mNumDroppedReported = numDropped;
+				++count;
+			}
+
+			if( count > 0 ) {
+				for( auto &logger : mManager->mLoggers )
+					logger->flush();
+			}
+		}
+
+		if( count > 0 ) {
+			mNumWritten.store( mDequeuePos, memory_order_release );
+			{
+				lock_guard<mutex> lock( mWakeMutex );
+			}
+			mWrittenCv.notify_all();
+		}
+
+		return count;
+	}
+
+	LogManager					*mManager;
+	std::atomic<OverflowPolicy>	mPolicy;
+	std::unique_ptr<Cell[]>	mCells;
+	size_t					mMask;
+
+	alignas( 64 ) std::atomic<size_t>	mEnqueuePos;
+	alignas( 64 ) std::atomic<size_t>	mNumWritten;
+	// only touched by the writer thread, and by stop() once it has been joined
+	size_t					mDequeuePos;
+	std::atomic<uint64_t>	mNumDropped;
+	uint64_t				mNumDroppedReported;
+
+	std::atomic<bool>		mWriterWaiting, mStopping;
+	bool					mStopped = false;
+	std::mutex				mWakeMutex;
+	std::condition_variable	mWakeCv, mWrittenCv;
+	std::thread				mThread;
+};
+
 // ----------------------------------------------------------------------------------------------------
 // LogManager
 // ----------------------------------------------------------------------------------------------------
@@ -103,10 +431,16 @@ LogManager* manager()
 }
 
 LogManager::LogManager()
+	: mAsyncWriter( nullptr )
 {
 	restoreToDefault();
 }
 
+LogManager::~LogManager()
+{
+	disableAsync();
+}
+
 void LogManager::clearLoggers()
 {
 	lock_guard<mutex> lock( mMutex );
@@ -163,34 +497,125 @@ void LogManager::setLevel( Level level )
 
 void LogManager::write( const Metadata &meta, const std::string &text )
 {
-	// TODO move this to a shared_lock_timed with c++14 support
+	AsyncWriter *asyncWriter = mAsyncWriter.load( memory_order_acquire );
+	if( asyncWriter && asyncWriter->push( Metadata( meta ), text ) )
+		return;
+
 	lock_guard<mutex> lock( mMutex );
+	writeLocked( meta, text );
+	for( auto& logger : mLoggers ) {
+		logger->flush();
+	}
+}
+
+void LogManager::write( Metadata &&meta, const std::string &text )
+{
+	AsyncWriter *asyncWriter = mAsyncWriter.load( memory_order_acquire );
+	if( asyncWriter && asyncWriter->push( std::move( meta ), text ) )
+		return;
 
+	lock_guard<mutex> lock( mMutex );
+	writeLocked( meta, text );
+	for( auto& logger : mLoggers ) {
+		logger->flush();
+	}
+}
+
+void LogManager::writeLocked( const Metadata &meta, const std::string &text )
+{
 	for( auto& logger : mLoggers ) {
 		logger->write( meta, text );
 	}
 }
 
+void LogManager::enableAsync( size_t queueSize, OverflowPolicy policy )
+{
+	lock_guard<mutex> lock( mAsyncMutex );
+	// the previous writer finishes before the new one starts, so that entries stay in order
+	AsyncWriter *previous = mAsyncWriter.exchange( nullptr );
+	if( previous )
+		previous->stop();
+
+	// a stopped writer of the same size is restarted rather than replaced, which bounds the writers kept alive to one per queue size
+	AsyncWriter *writer = nullptr;
+	for( auto &stopped : mAsyncWriters ) {
+		if( stopped->getNumCells() == AsyncWriter::calcNumCells( queueSize ) ) {
+			writer = stopped.get();
+			writer->restart( policy );
+			break;
+		}
+	}
+	if( ! writer ) {
+		mAsyncWriters.push_back( make_unique<AsyncWriter>( this, queueSize, policy ) );
+		writer = mAsyncWriters.back().get();
+	}
+	mAsyncWriter.store( writer, memory_order_release );
+}
+
+void LogManager::disableAsync()
+{
+	lock_guard<mutex> lock( mAsyncMutex );
+	AsyncWriter *previous = mAsyncWriter.exchange( nullptr );
+	if( previous )
+		previous->stop();
+}
+
+bool LogManager::isAsyncEnabled() const
+{
+	return mAsyncWriter.load( memory_order_acquire ) != nullptr;
+}
+
+void LogManager::flush()
+{
+	AsyncWriter *asyncWriter = mAsyncWriter.load( memory_order_acquire );
+	if( asyncWriter )
+		asyncWriter->flush();
+}
+
+uint64_t LogManager::getNumDropped() const
+{
+	AsyncWriter *asyncWriter = mAsyncWriter.load( memory_order_acquire );
+	return asyncWriter ? asyncWriter->getNumDropped() : 0;
+}
+
 // ----------------------------------------------------------------------------------------------------
 // Entry
 // ----------------------------------------------------------------------------------------------------
 
-Entry::Entry( Level level, const Location &location )
+Entry::Entry( Level level, Location location )
 : mHasContent( false )
 {
 	mMetaData.mLevel = level;
-	mMetaData.mLocation = location;
+	mMetaData.mLocation = std::move( location );
+	mMetaData.mTime = chrono::system_clock::now();
+
+	EntryStreamPool *pool = getEntryStreamPool();
+	if( pool && ! pool->mStreams.empty() ) {
+		mEntryStream = pool->mStreams.back().release();
+		pool->mStreams.pop_back();
+	}
+	else
+		mEntryStream = new detail::EntryStream;
+
+	mEntryStream->begin();
+	mStream = mEntryStream;
 }
 
 Entry::~Entry()
 {
 	if( mHasContent )
-		writeToLog();
+		manager()->write( std::move( mMetaData ), mEntryStream->str() );
+
+	EntryStreamPool *pool = getEntryStreamPool();
+	if( pool && mEntryStream->getCapacity() <= MAX_POOLED_ENTRY_CAPACITY )
+		pool->mStreams.emplace_back( mEntryStream );
+	else
+		delete mEntryStream;
 }
 
 void Entry::writeToLog()
 {
-	manager()->write( mMetaData, mStream.str() );
+	manager()->write( mMetaData, mEntryStream->str() );
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -202,9 +627,9 @@ void Logger::writeDefault( std::ostream &stream, const Metadata &meta, const std
 	stream << meta.mLevel << " ";
 
 	if( isTimestampEnabled() )
-		stream << getCurrentDateTimeString() << " ";
+		stream << getDateTimeString( meta.mTime ) << " ";
 
-	stream << meta.mLocation << " " << text << endl;
+	stream << meta.mLocation << " " << text << '\n';
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -219,6 +644,11 @@ void LoggerConsole::write( const Metadata &meta, const string &text )
 	writeDefault( app::Platform::get()->console(), meta, text );
 }
 
+void LoggerConsole::flush()
+{
+	app::Platform::get()->console().flush();
+}
+
 // ----------------------------------------------------------------------------------------------------
 // LoggerFile
 // ----------------------------------------------------------------------------------------------------
@@ -251,6 +681,12 @@ void LoggerFile::write( const Metadata &meta, const string &text )
 	writeDefault( mStream, meta, text );
 }
 
+void LoggerFile::flush()
+{
+	if( mStream.is_open() )
+		mStream.flush();
+}
+
 fs::path LoggerFile::getDefaultLogFilePath() const
 {
 	return app::Platform::get()->getExecutablePath() / fs::path( "cinder.log" );
@@ -0,0 +1,700 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/LogDeferred.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace cinder { namespace log {
+
+namespace {
+
+// Binary log layout, in the byte order of the machine that wrote it:
+//   header: FILE_MAGIC, uint32 BYTE_ORDER_MARK, uint32 FILE_VERSION
+//   then a sequence of chunks, each starting with a tag byte:
+//   TAG_FORMAT: uint32 id, uint8 level, uint32 line, uint8 numArgs, numArgs DeferredArgType bytes, then the format, function and file
+//               names as uint32 lengths followed by their characters. A format precedes the first record that uses it.
+//   TAG_RECORD: a RecordHeader followed by the record's arguments, mSize bytes in all
+const char		FILE_MAGIC[8] = { 'C', 'I', 'D', 'E', 'F', 'L', 'O', 'G' };
+const uint32_t	BYTE_ORDER_MARK = 0x01020304;
+const uint32_t	FILE_VERSION = 1;
+const char		TAG_FORMAT = 'F';
+const char		TAG_RECORD = 'R';
+
+struct RecordHeader {
+	uint32_t	mFormatId;	// 0 for the padding that skips to the start of a thread buffer
+	uint32_t	mSize;		// in bytes, including the header and the padding up to RECORD_ALIGNMENT
+	int64_t		mTime;		// nanoseconds since the system clock's epoch
+};
+
+const size_t RECORD_ALIGNMENT = 8;
+const size_t DEFAULT_THREAD_BUFFER_SIZE = 256 * 1024;
+// how often the drain thread wakes up when no buffer is filling up quickly
+const chrono::milliseconds DRAIN_INTERVAL( 10 );
+
+size_t alignRecordSize( size_t size )
+{
+	return ( size + RECORD_ALIGNMENT - 1 ) & ~( RECORD_ALIGNMENT - 1 );
+}
+
+int64_t toNanoseconds( const chrono::system_clock::time_point &time )
+{
+	return chrono::duration_cast<chrono::nanoseconds>( time.time_since_epoch() ).count();
+}
+
+chrono::system_clock::time_point fromNanoseconds( int64_t ns )
+{
+	return chrono::system_clock::time_point( chrono::duration_cast<chrono::system_clock::duration>( chrono::nanoseconds( ns ) ) );
+}
+
+// A ring of records written by one thread and drained by DeferredLogImpl's thread. Positions increase monotonically and are masked
+// into mData, whose size is a power of two. Records never wrap: one that doesn't fit before the end of mData is preceded by padding.
+struct ThreadBuffer {
+	ThreadBuffer( size_t capacity )
+		: mData( new char[capacity] ), mMask( capacity - 1 ), mHead( 0 ), mPendingHead( 0 ), mTail( 0 ), mWakeRequested( false ), mRetired( false )
+	{}
+
+	size_t	getCapacity() const	{ return mMask + 1; }
+
+	std::unique_ptr<char[]>		mData;
+	const size_t				mMask;
+
+	// published by the owning thread
+	alignas( 64 ) std::atomic<uint64_t>	mHead;
+	// the owning thread's head once the record being written is published
+	uint64_t							mPendingHead;
+	// published by the drain thread
+	alignas( 64 ) std::atomic<uint64_t>	mTail;
+	std::atomic<bool>					mWakeRequested;
+	std::atomic<bool>					mRetired;
+};
+
+// the calling thread's buffer, once it has logged a deferred entry
+thread_local ThreadBuffer *tThreadBuffer = nullptr;
+// trivially destructible, so they can still be read while the thread is exiting
+thread_local bool tThreadBufferDestroyed = false;
+thread_local bool tIsDrainThread = false;
+
+// retires the thread's buffer when the thread exits, leaving the drain thread to free it once drained
+struct ThreadBufferOwner {
+	~ThreadBufferOwner()
+	{
+		tThreadBufferDestroyed = true;
+		if( tThreadBuffer )
+			tThreadBuffer->mRetired.store( true, memory_order_release );
+		tThreadBuffer = nullptr;
+	}
+};
+
+detail::DeferredLogImpl	*sImpl = nullptr;
+
+template<typename T>
+const char* readArg( const char *src, const char *end, T *result )
+{
+	if( end - src < (ptrdiff_t)sizeof( T ) )
+		throw DeferredLogExc( "deferred log record is shorter than its arguments" );
+	memcpy( result, src, sizeof( T ) );
+	return src + sizeof( T );
+}
+
+const char* formatArg( ostream &stream, DeferredArgType type, const char *src, const char *end )
+{
+	switch( type ) {
+		case DeferredArgType::BOOL: { uint8_t v; src = readArg( src, end, &v ); stream << ( v != 0 ); } break;
+		case DeferredArgType::CHAR: { char v; src = readArg( src, end, &v ); stream << v; } break;
+		case DeferredArgType::INT32: { int32_t v; src = readArg( src, end, &v ); stream << v; } break;
+		case DeferredArgType::UINT32: { uint32_t v; src = readArg( src, end, &v ); stream << v; } break;
+		case DeferredArgType::INT64: { int64_t v; src = readArg( src, end, &v ); stream << v; } break;
+		case DeferredArgType::UINT64: { uint64_t v; src = readArg( src, end, &v ); stream << v; } break;
+		case DeferredArgType::FLOAT: { float v; src = readArg( src, end, &v ); stream << v; } break;
+		case DeferredArgType::DOUBLE: { double v; src = readArg( src, end, &v ); stream << v; } break;
+		case DeferredArgType::STRING: {
+			uint32_t size;
+			src = readArg( src, end, &size );
+			if( end - src < (ptrdiff_t)size )
+				throw DeferredLogExc( "deferred log record is shorter than its arguments" );
+			stream.write( src, size );
+			src += size;
+		}
+		break;
+		case DeferredArgType::POINTER: { uint64_t v; src = readArg( src, end, &v ); stream << reinterpret_cast<const void*>( uintptr_t( v ) ); } break;
+		default:
+			throw DeferredLogExc( "unknown deferred log argument type " + to_string( int( type ) ) );
+	}
+
+	return src;
+}
+
+Metadata makeMetadata( const DeferredFormat &format, int64_t time )
+{
+	Metadata result;
+	result.mLevel = format.mLevel;
+	result.mLocation = Location( format.mFunctionName, format.mFileName, format.mLineNumber );
+	result.mTime = fromNanoseconds( time );
+	return result;
+}
+
+void writeString( FILE *file, const string &str )
+{
+	const uint32_t size = uint32_t( str.size() );
+	fwrite( &size, sizeof( size ), 1, file );
+	fwrite( str.data(), 1, size, file );
+}
+
+template<typename T>
+void readValue( FILE *file, T *result )
+{
+	if( fread( result, sizeof( T ), 1, file ) != 1 )
+		throw DeferredLogExc( "deferred log file is truncated" );
+}
+
+// Throws unless \a size bytes are left of the \a fileSize bytes of \a file, so that a corrupt length doesn't allocate more than the file holds
+void checkRemaining( FILE *file, uint64_t fileSize, uint64_t size )
+{
+	const long pos = ftell( file );
+	if( pos < 0 || uint64_t( pos ) > fileSize || size > fileSize - uint64_t( pos ) )
+		throw DeferredLogExc( "deferred log file is truncated" );
+}
+
+string readString( FILE *file, uint64_t fileSize )
+{
+	uint32_t size;
+	readValue( file, &size );
+	checkRemaining( file, fileSize, size );
+	string result( size, 0 );
+	if( size && fread( &result[0], 1, size, file ) != size )
+		throw DeferredLogExc( "deferred log file is truncated" );
+	return result;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------------------------------
+// DeferredLogImpl
+// ----------------------------------------------------------------------------------------------------
+
+namespace detail {
+
+class DeferredLogImpl {
+  public:
+	DeferredLogImpl()
+		: mThreadBufferSize( DEFAULT_THREAD_BUFFER_SIZE ), mOverflowPolicy( OVERFLOW_DROP ), mNumDropped( 0 ), mFormatToLoggers( true )
+	{
+		// the drain thread reports dropped entries through a format of its own
+		mDroppedSite.mLevel = LEVEL_WARNING;
+		mDroppedSite.mFunctionName = CINDER_CURRENT_FUNCTION;
+		mDroppedSite.mFileName = __FILE__;
+		mDroppedSite.mLineNumber = __LINE__;
+		const DeferredArgType argType = DeferredArgType::UINT64;
+		mDroppedId = registerSite( mDroppedSite, "{} deferred log entries were dropped because their thread's buffer was full", &argType, 1 );
+	}
+
+	~DeferredLogImpl()
+	{
+		if( mThread.joinable() ) {
+			{
+				lock_guard<mutex> lock( mWakeMutex );
+				mStopping = true;
+			}
+			mWakeCv.notify_one();
+			mThread.join();
+		}
+		if( mFile )
+			fclose( mFile );
+	}
+
+	uint32_t registerSite( DeferredSite &site, const char *format, const DeferredArgType *argTypes, size_t numArgs )
+	{
+		lock_guard<mutex> lock( mFormatsMutex );
+		// another thread may have registered the site first
+		uint32_t id = site.mId.load( memory_order_acquire );
+		if( id != 0 )
+			return id;
+
+		DeferredFormat result;
+		result.mId = id = uint32_t( mFormats.size() + 1 );
+		result.mLevel = site.mLevel;
+		result.mFormat = format;
+		result.mFunctionName = site.mFunctionName;
+		result.mFileName = site.mFileName;
+		result.mLineNumber = site.mLineNumber;
+		result.mArgTypes.assign( argTypes, argTypes + numArgs );
+		mFormats.push_back( std::move( result ) );
+
+		site.mId.store( id, memory_order_release );
+		return id;
+	}
+
+	DeferredFormat getFormat( uint32_t id ) const
+	{
+		lock_guard<mutex> lock( mFormatsMutex );
+		return ( id > 0 && id <= mFormats.size() ) ? mFormats[id - 1] : DeferredFormat();
+	}
+
+	ThreadBuffer* createThreadBuffer()
+	{
+		size_t capacity = 1024;
+		while( capacity < mThreadBufferSize.load( memory_order_relaxed ) )
+			capacity *= 2;
+
+		lock_guard<mutex> lock( mBuffersMutex );
+		mBuffers.push_back( make_unique<ThreadBuffer>( capacity ) );
+		if( ! mThread.joinable() )
+			mThread = std::thread( &DeferredLogImpl::run, this );
+
+		return mBuffers.back().get();
+	}
+
+	//! Called by a thread whose buffer lacks room for a record. Returns whether the room is now available.
+	bool waitForRoom( ThreadBuffer *buffer, uint64_t head, size_t needed )
+	{
+		// the drain thread can't wait for itself
+		if( mOverflowPolicy.load( memory_order_relaxed ) == OVERFLOW_DROP || tIsDrainThread )
+			return false;
+
+		while( buffer->getCapacity() - ( head - buffer->mTail.load( memory_order_acquire ) ) < needed ) {
+			wake();
+			this_thread::yield();
+		}
+		return true;
+	}
+
+	void countDropped()
+	{
+		mNumDropped.fetch_add( 1, memory_order_relaxed );
+	}
+
+	void wake()
+	{
+		{
+			lock_guard<mutex> lock( mWakeMutex );
+			mWakeRequested = true;
+		}
+		mWakeCv.notify_one();
+	}
+
+	void flush()
+	{
+		{
+			lock_guard<mutex> lock( mBuffersMutex );
+			if( ! mThread.joinable() || tIsDrainThread )
+				return;
+		}
+
+		{
+			unique_lock<mutex> lock( mWakeMutex );
+			const uint64_t target = ++mNumPassesRequested;
+			mWakeCv.notify_one();
+			mPassCv.wait( lock, [&] { return mNumPassesCompleted >= target; } );
+		}
+
+		if( mFormatToLoggers.load( memory_order_relaxed ) )
+			manager()->flush();
+	}
+
+	void setBinaryFile( const fs::path &path )
+	{
+		lock_guard<mutex> lock( mOutputMutex );
+		if( mFile ) {
+			fclose( mFile );
+			mFile = nullptr;
+		}
+		if( path.empty() )
+			return;
+
+		mFile = fopen( path.string().c_str(), "wb" );
+		if( ! mFile )
+			throw DeferredLogExc( "Unable to open deferred log file \"" + path.string() + "\"" );
+
+		fwrite( FILE_MAGIC, 1, sizeof( FILE_MAGIC ), mFile );
+		fwrite( &BYTE_ORDER_MARK, sizeof( BYTE_ORDER_MARK ), 1, mFile );
+		fwrite( &FILE_VERSION, sizeof( FILE_VERSION ), 1, mFile );
+		// every format known so far is written before the next record
+		mNumFormatsWritten = 0;
+		fflush( mFile );
+	}
+
+	std::atomic<size_t>		mThreadBufferSize;
+	std::atomic<int>		mOverflowPolicy;
+	std::atomic<uint64_t>	mNumDropped;
+	std::atomic<bool>		mFormatToLoggers;
+
+  private:
+	void run()
+	{
+		ThreadSetup threadSetup;
+		tIsDrainThread = true;
+
+		while( true ) {
+			uint64_t numPassesRequested;
+			bool stopping;
+			{
+				unique_lock<mutex> lock( mWakeMutex );
+				mWakeCv.wait_for( lock, DRAIN_INTERVAL, [&] { return mWakeRequested || mNumPassesRequested > mNumPassesCompleted || mStopping; } );
+				mWakeRequested = false;
+				numPassesRequested = mNumPassesRequested;
+				stopping = mStopping;
+			}
+
+			drain();
+
+			{
+				lock_guard<mutex> lock( mWakeMutex );
+				mNumPassesCompleted = numPassesRequested;
+			}
+			mPassCv.notify_all();
+
+			if( stopping )
+				break;
+		}
+	}
+
+	// Writes every published record of every thread, sorted by timestamp
+	void drain()
+	{
+		{
+			lock_guard<mutex> lock( mBuffersMutex );
+			mDrainBuffers.clear();
+			for( auto &buffer : mBuffers )
+				mDrainBuffers.push_back( buffer.get() );
+		}
+
+		mDrainHeads.resize( mDrainBuffers.size() );
+		mRecords.clear();
+		for( size_t i = 0; i < mDrainBuffers.size(); ++i ) {
+			ThreadBuffer *buffer = mDrainBuffers[i];
+			mDrainHeads[i] = buffer->mHead.load( memory_order_acquire );
+			for( uint64_t pos = buffer->mTail.load( memory_order_relaxed ); pos < mDrainHeads[i]; ) {
+				const RecordHeader *record = reinterpret_cast<const RecordHeader*>( &buffer->mData[pos & buffer->mMask] );
+				if( record->mFormatId != 0 )
+					mRecords.push_back( record );
+				pos += record->mSize;
+			}
+		}
+		stable_sort( mRecords.begin(), mRecords.end(), []( const RecordHeader *a, const RecordHeader *b ) { return a->mTime < b->mTime; } );
+
+		{
+			lock_guard<mutex> lock( mOutputMutex );
+			// every format used by the records above was registered before they were published
+			{
+				lock_guard<mutex> formatsLock( mFormatsMutex );
+				mDrainFormats.insert( mDrainFormats.end(), mFormats.begin() + mDrainFormats.size(), mFormats.end() );
+			}
+
+			for( const RecordHeader *record : mRecords )
+				write( record );
+
+			const uint64_t numDropped = mNumDropped.load( memory_order_relaxed );
+			if( numDropped != mNumDroppedReported ) {
+				struct {
+					RecordHeader	mHeader;
+					uint64_t		mNumDropped;
+				} dropped = { { mDroppedId, uint32_t( sizeof( dropped ) ), toNanoseconds( chrono::system_clock::now() ) }, numDropped - mNumDroppedReported };
+				write( &dropped.mHeader );
+				mNumDroppedReported = numDropped;
+			}
+
+			if( mFile )
+				fflush( mFile );
+		}
+
+		for( size_t i = 0; i < mDrainBuffers.size(); ++i ) {
+			mDrainBuffers[i]->mTail.store( mDrainHeads[i], memory_order_release );
+			mDrainBuffers[i]->mWakeRequested.store( false, memory_order_relaxed );
+		}
+
+		// free the buffers of exited threads once they're empty
+		lock_guard<mutex> lock( mBuffersMutex );
+		mBuffers.erase( remove_if( mBuffers.begin(), mBuffers.end(), []( const unique_ptr<ThreadBuffer> &buffer ) {
+			return buffer->mRetired.load( memory_order_acquire ) && buffer->mHead.load( memory_order_acquire ) == buffer->mTail.load( memory_order_relaxed );
+		} ), mBuffers.end() );
+	}
+
+	void write( const RecordHeader *record )
+	{
+		const DeferredFormat &format = mDrainFormats[record->mFormatId - 1];
+		if( mFile ) {
+			while( mNumFormatsWritten < mDrainFormats.size() )
+				writeFormat( mDrainFormats[mNumFormatsWritten++] );
+			fputc( TAG_RECORD, mFile );
+			fwrite( record, 1, record->mSize, mFile );
+		}
+
+		if( mFormatToLoggers.load( memory_order_relaxed ) ) {
+			const char *args = reinterpret_cast<const char*>( record + 1 );
+			manager()->write( makeMetadata( format, record->mTime ), formatDeferred( format, args, reinterpret_cast<const char*>( record ) + record->mSize ) );
+		}
+	}
+
+	void writeFormat( const DeferredFormat &format )
+	{
+		fputc( TAG_FORMAT, mFile );
+		fwrite( &format.mId, sizeof( format.mId ), 1, mFile );
+		fputc( int( format.mLevel ), mFile );
+		fwrite( &format.mLineNumber, sizeof( format.mLineNumber ), 1, mFile );
+		fputc( int( format.mArgTypes.size() ), mFile );
+		for( DeferredArgType type : format.mArgTypes )
+			fputc( int( type ), mFile );
+		writeString( mFile, format.mFormat );
+		writeString( mFile, format.mFunctionName );
+		writeString( mFile, format.mFileName );
+	}
+
+	mutable mutex					mFormatsMutex;
+	vector<DeferredFormat>			mFormats;
+	DeferredSite					mDroppedSite;
+	uint32_t						mDroppedId;
+
+	mutex							mBuffersMutex;
+	vector<unique_ptr<ThreadBuffer>>	mBuffers;
+
+	// touched by the drain thread, with mOutputMutex locked where setBinaryFile() may race
+	mutex							mOutputMutex;
+	FILE							*mFile = nullptr;
+	size_t							mNumFormatsWritten = 0;
+	vector<DeferredFormat>			mDrainFormats;
+	vector<ThreadBuffer*>			mDrainBuffers;
+	vector<uint64_t>				mDrainHeads;
+	vector<const RecordHeader*>		mRecords;
+	uint64_t						mNumDroppedReported = 0;
+
+	std::thread						mThread;
+	mutex							mWakeMutex;
+	condition_variable				mWakeCv, mPassCv;
+	bool							mWakeRequested = false, mStopping = false;
+	uint64_t						mNumPassesRequested = 0, mNumPassesCompleted = 0;
+};
+
+uint32_t registerDeferredSite( DeferredSite &site, const char *format, const DeferredArgType *argTypes, size_t numArgs )
+{
+	DeferredLogManager::instance();
+	return sImpl->registerSite( site, format, argTypes, numArgs );
+}
+
+char* beginDeferredRecord( uint32_t formatId, size_t argsSize )
+{
+	ThreadBuffer *buffer = tThreadBuffer;
+	if( ! buffer ) {
+		DeferredLogManager::instance();
+		// entries logged by a thread's static destructors, after its buffer was retired, are dropped
+		if( tThreadBufferDestroyed ) {
+			sImpl->countDropped();
+			return nullptr;
+		}
+		static thread_local ThreadBufferOwner sOwner;
+		buffer = tThreadBuffer = sImpl->createThreadBuffer();
+	}
+
+	const size_t size = alignRecordSize( sizeof( RecordHeader ) + argsSize );
+	const size_t capacity = buffer->getCapacity();
+	uint64_t head = buffer->mHead.load( memory_order_relaxed );
+	const size_t contiguous = capacity - size_t( head & buffer->mMask );
+	const size_t needed = ( size <= contiguous ) ? size : contiguous + size;
+	if( size > capacity / 2 || ( capacity - ( head - buffer->mTail.load( memory_order_acquire ) ) < needed && ! sImpl->waitForRoom( buffer, head, needed ) ) ) {
+		sImpl->countDropped();
+		return nullptr;
+	}
+
+	if( size > contiguous ) {
+		RecordHeader *padding = reinterpret_cast<RecordHeader*>( &buffer->mData[head & buffer->mMask] );
+		padding->mFormatId = 0;
+		padding->mSize = uint32_t( contiguous );
+		head += contiguous;
+	}
+
+	RecordHeader *record = reinterpret_cast<RecordHeader*>( &buffer->mData[head & buffer->mMask] );
+	record->mFormatId = formatId;
+	record->mSize = uint32_t( size );
+	record->mTime = toNanoseconds( chrono::system_clock::now() );
+	buffer->mPendingHead = head + size;
+
+	return reinterpret_cast<char*>( record + 1 );
+}
+
+void endDeferredRecord()
+{
+	ThreadBuffer *buffer = tThreadBuffer;
+	const uint64_t head = buffer->mPendingHead;
+	buffer->mHead.store( head, memory_order_release );
+
+	// wake the drain thread once the buffer is half full, rather than waiting for its next pass
+	if( head - buffer->mTail.load( memory_order_relaxed ) > buffer->getCapacity() / 2 && ! buffer->mWakeRequested.exchange( true, memory_order_relaxed ) )
+		sImpl->wake();
+}
+
+} // namespace detail
+
+// ----------------------------------------------------------------------------------------------------
+// DeferredLogManager
+// ----------------------------------------------------------------------------------------------------
+
+DeferredLogManager* DeferredLogManager::instance()
+{
+	static DeferredLogManager *sInstance = new DeferredLogManager;	// note: leaks to enable logging during shutdown
+	return sInstance;
+}
+
+DeferredLogManager* deferredManager()
+{
+	return DeferredLogManager::instance();
+}
+
+DeferredLogManager::DeferredLogManager()
+	: mImpl( new detail::DeferredLogImpl )
+{
+	sImpl = mImpl.get();
+}
+
+void DeferredLogManager::setFormatToLoggers( bool enable )
+{
+	mImpl->mFormatToLoggers.store( enable, memory_order_relaxed );
+}
+
+bool DeferredLogManager::isFormatToLoggers() const
+{
+	return mImpl->mFormatToLoggers.load( memory_order_relaxed );
+}
+
+void DeferredLogManager::setBinaryFile( const fs::path &path )
+{
+	mImpl->setBinaryFile( path );
+}
+
+void DeferredLogManager::setThreadBufferSize( size_t bytes )
+{
+	mImpl->mThreadBufferSize.store( bytes, memory_order_relaxed );
+}
+
+void DeferredLogManager::setOverflowPolicy( OverflowPolicy policy )
+{
+	mImpl->mOverflowPolicy.store( policy, memory_order_relaxed );
+}
+
+void DeferredLogManager::flush()
+{
+	mImpl->flush();
+}
+
+uint64_t DeferredLogManager::getNumDropped() const
+{
+	return mImpl->mNumDropped.load( memory_order_relaxed );
+}
+
+DeferredFormat DeferredLogManager::getFormat( uint32_t id ) const
+{
+	return mImpl->getFormat( id );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Decoding
+// ----------------------------------------------------------------------------------------------------
+
+string formatDeferred( const DeferredFormat &format, const char *args, const char *argsEnd )
+{
+	ostringstream stream;
+	size_t pos = 0;
+	for( DeferredArgType type : format.mArgTypes ) {
+		const size_t placeholder = format.mFormat.find( "{}", pos );
+		if( placeholder == string::npos )
+			break;
+		stream.write( format.mFormat.data() + pos, placeholder - pos );
+		args = formatArg( stream, type, args, argsEnd );
+		pos = placeholder + 2;
+	}
+	stream.write( format.mFormat.data() + pos, format.mFormat.size() - pos );
+
+	return stream.str();
+}
+
+void readDeferredLog( const fs::path &path, const function<void( const Metadata &meta, const string &text )> &fn )
+{
+	unique_ptr<FILE, int (*)( FILE* )> file( fopen( path.string().c_str(), "rb" ), fclose );
+	if( ! file )
+		throw DeferredLogExc( "Unable to open deferred log file \"" + path.string() + "\"" );
+	error_code ec;
+	const uint64_t fileSize = fs::file_size( path, ec );
+	if( ec )
+		throw DeferredLogExc( "Unable to read the size of deferred log file \"" + path.string() + "\"" );
+
+	char magic[sizeof( FILE_MAGIC )];
+	uint32_t byteOrderMark, version;
+	if( fread( magic, 1, sizeof( magic ), file.get() ) != sizeof( magic ) || memcmp( magic, FILE_MAGIC, sizeof( magic ) ) != 0 )
+		throw DeferredLogExc( "\"" + path.string() + "\" is not a deferred log file" );
+	readValue( file.get(), &byteOrderMark );
+	readValue( file.get(), &version );
+	if( byteOrderMark != BYTE_ORDER_MARK )
+		throw DeferredLogExc( "deferred log file was written with a different byte order" );
+	if( version != FILE_VERSION )
+		throw DeferredLogExc( "unsupported deferred log file version " + to_string( version ) );
+
+	vector<DeferredFormat> formats;
+	vector<char> record;
+	int tag;
+	while( ( tag = fgetc( file.get() ) ) != EOF ) {
+		if( tag == TAG_FORMAT ) {
+			DeferredFormat format;
+			uint8_t level, numArgs;
+			readValue( file.get(), &format.mId );
+			readValue( file.get(), &level );
+			readValue( file.get(), &format.mLineNumber );
+			readValue( file.get(), &numArgs );
+			format.mLevel = Level( level );
+			format.mArgTypes.resize( numArgs );
+			if( numArgs && fread( format.mArgTypes.data(), 1, numArgs, file.get() ) != numArgs )
+				throw DeferredLogExc( "deferred log file is truncated" );
+			format.mFormat = readString( file.get(), fileSize );
+			format.mFunctionName = readString( file.get(), fileSize );
+			format.mFileName = readString( file.get(), fileSize );
+			// the writer numbers the formats from 1 in the order it writes them
+			if( format.mId == 0 || format.mId > formats.size() + 1 )
+				throw DeferredLogExc( "deferred log format has an invalid id" );
+			if( formats.size() < format.mId )
+				formats.resize( format.mId );
+			formats[format.mId - 1] = std::move( format );
+		}
+		else if( tag == TAG_RECORD ) {
+			RecordHeader header;
+			readValue( file.get(), &header );
+			if( header.mSize < sizeof( header ) || header.mFormatId == 0 || header.mFormatId > formats.size() || formats[header.mFormatId - 1].mId == 0 )
+				throw DeferredLogExc( "deferred log record has an invalid header" );
+			checkRemaining( file.get(), fileSize, header.mSize - sizeof( header ) );
+			record.resize( header.mSize - sizeof( header ) );
+			if( ! record.empty() && fread( record.data(), 1, record.size(), file.get() ) != record.size() )
+				throw DeferredLogExc( "deferred log file is truncated" );
+
+			const DeferredFormat &format = formats[header.mFormatId - 1];
+			fn( makeMetadata( format, header.mTime ), formatDeferred( format, record.data(), record.data() + record.size() ) );
+		}
+		else
+			throw DeferredLogExc( "deferred log file has an unknown chunk" );
+	}
+}
+
+} } // namespace cinder::log
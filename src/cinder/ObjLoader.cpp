@@ -24,8 +24,15 @@
 */
 
 #include "cinder/ObjLoader.h"
+#include "cinder/Thread.h"
 
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <exception>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
 using namespace std;
 
 // For stoi
@@ -181,83 +188,181 @@ void ObjLoader::parseMaterial( std::shared_ptr<IStreamCinder> material )
         mMaterials[m.mName] = m;
 }
 
-void ObjLoader::parse( bool includeNormals, bool includeTexCoords )
+namespace {
+
+// Records of a chunk of the file are parsed in parallel; chunks are sized so that each is worth a task
+const size_t PARSE_CHUNK_SIZE = 1024 * 1024;
+
+// How a face's "v/vt/vn" triples updated its group's mHasTexCoords and mHasNormals
+enum FaceFlags : uint8_t { TEX_COORD_LAST = 1, TEX_COORD_ANY_EMPTY = 2, NORMAL_LAST = 4, NORMAL_ANY = 8 };
+
+struct ParsedChunk {
+	// A "g" or resolved "usemtl" record, which applies before face \a mFace of the chunk
+	struct Event {
+		size_t						mFace;
+		size_t						mNumVertices, mNumTexCoords, mNumNormals;
+		std::string					mGroupName;
+		const ObjLoader::Material	*mMaterial; // null for groups
+	};
+
+	vector<vec3>				mVertices, mNormals;
+	vector<vec2>				mTexCoords;
+	vector<ObjLoader::Face>		mFaces; // with the indices as written in the file
+	vector<uint8_t>				mFaceFlags;
+	vector<int32_t>				mFaceIndices[3]; // the vertex, tex coord and normal indices of the face being parsed, which are then copied into it with a single allocation each
+	vector<Event>				mEvents;
+	std::exception_ptr			mException;
+};
+
+inline bool isSpace( char c )
 {
-	Group *currentGroup;
-	mGroups.push_back( Group() );
-	currentGroup = &mGroups[mGroups.size()-1];
-	currentGroup->mBaseVertexOffset = currentGroup->mBaseTexCoordOffset = currentGroup->mBaseNormalOffset = 0;
+	return c == ' ' || ( c >= '\t' && c <= '\r' );
+}
 
-    const Material *currentMaterial = 0;
+inline bool isDigit( char c )
+{
+	return c >= '0' && c <= '9';
+}
 
-	size_t lineNumber = 0;
-	while( ! mStream->isEof() ) {
-		lineNumber++;
-		string line = mStream->readLine(), tag;
-        if( line.empty() || line[0] == '#' )
-            continue;
+// Returns the first '\n' or '\r' in [p, end), or \a end
+inline const char* findLineEnd( const char *p, const char *end )
+{
+	while( p < end && *p != '\n' && *p != '\r' )
+		++p;
+	return p;
+}
 
-		while( line.back() == '\\' && ! mStream->isEof() ) {
-			auto next = mStream->readLine();
-			line = line.substr( 0, line.size() - 1 ) + next;
+// Returns the start of the line following the one which ends at \a lineEnd, treating "\r\n" as a single terminator
+inline const char* skipLineEnd( const char *lineEnd, const char *end )
+{
+	if( lineEnd == end )
+		return end;
+	return ( *lineEnd == '\r' && lineEnd + 1 < end && lineEnd[1] == '\n' ) ? lineEnd + 2 : lineEnd + 1;
+}
+
+// Parses an int the way std::stoi() does, throwing std::invalid_argument or std::out_of_range in the same cases
+int32_t parseIndex( std::string_view s )
+{
+	size_t i = 0;
+	while( i < s.size() && isSpace( s[i] ) )
+		++i;
+	bool negative = false;
+	if( i < s.size() && ( s[i] == '-' || s[i] == '+' ) )
+		negative = s[i++] == '-';
+	if( i == s.size() || ! isDigit( s[i] ) )
+		throw std::invalid_argument( "stoi" );
+
+	int64_t value = 0;
+	for( ; i < s.size() && isDigit( s[i] ); ++i ) {
+		value = value * 10 + ( s[i] - '0' );
+		if( value > int64_t( numeric_limits<int32_t>::max() ) + 1 )
+			throw std::out_of_range( "stoi" );
+	}
+	value = negative ? -value : value;
+	if( value > numeric_limits<int32_t>::max() )
+		throw std::out_of_range( "stoi" );
+
+	return int32_t( value );
+}
+
+// Parses the plain decimals which make up most OBJ files, such as "-0.123456", returning the number of characters consumed, or 0 if \a p doesn't start with one.
+// With fewer than 2^24 as the digits and at most 10 decimals, both the digits and the power of ten are exact floats, so a single division rounds correctly just like strtof()
+size_t parseFloatFast( const char *p, const char *end, float *result )
+{
+	static const float sPowersOfTen[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+	const char *start = p;
+	const bool negative = p < end && *p == '-';
+	if( negative )
+		++p;
+
+	uint32_t mantissa = 0;
+	int digits = 0, decimals = -1;
+	for( ; p < end; ++p ) {
+		if( isDigit( *p ) ) {
+			mantissa = mantissa * 10 + ( *p - '0' );
+			if( mantissa >= ( 1u << 24 ) )
+				return 0;
+			++digits;
+			if( decimals >= 0 )
+				++decimals;
 		}
+		else if( *p == '.' && decimals < 0 )
+			decimals = 0;
+		else
+			break;
+	}
+	if( digits == 0 || decimals > 10 || ( p < end && ( *p == 'e' || *p == 'E' ) ) )
+		return 0;
 
-		stringstream ss( line );
-		ss >> tag;
-		if( tag == "v" ) { // vertex
-			vec3 v;
-			ss >> v.x >> v.y >> v.z;
-			mInternalVertices.push_back( v );
-		}
-		else if( tag == "vt" ) { // vertex texture coordinates
-			if( includeTexCoords ) {
-				vec2 tex;
-				ss >> tex.x >> tex.y;
-				mInternalTexCoords.push_back( tex );
-			}
+	const float value = ( decimals > 0 ) ? float( mantissa ) / sPowersOfTen[decimals] : float( mantissa );
+	*result = negative ? -value : value;
+	return p - start;
+}
+
+// Parses a float with strtof(), returning the number of characters consumed, or 0 on failure
+size_t parseFloatStrtof( const char *p, const char *end, float *result )
+{
+	char buffer[128];
+	const size_t length = std::min<size_t>( end - p, sizeof( buffer ) - 1 );
+	memcpy( buffer, p, length );
+	buffer[length] = 0;
+	char *parsedEnd;
+	*result = strtof( buffer, &parsedEnd );
+	return parsedEnd - buffer;
+}
+
+// Extracts up to \a count floats from \a s starting at \a offset the way successive istream::operator>>() calls do: once one fails, the remaining values are set to zero, and values which overflow are clamped
+void parseFloats( std::string_view s, size_t offset, float *result, int count )
+{
+	const char *p = s.data() + offset, *end = s.data() + s.size();
+	for( int i = 0; i < count; ++i ) {
+		while( p < end && isSpace( *p ) )
+			++p;
+		if( p + 1 < end && *p == '+' && p[1] != '-' )
+			++p;
+
+		size_t consumed = parseFloatFast( p, end, &result[i] );
+		if( consumed != 0 ) {
+			p += consumed;
+			continue;
 		}
-		else if( tag == "vn" ) { // vertex normals
-			if ( includeNormals ) {
-				vec3 v;
-				ss >> v.x >> v.y >> v.z;
-				mInternalNormals.push_back( normalize( v ) );
-			}
+#if defined( __cpp_lib_to_chars )
+		auto parsed = std::from_chars( p, end, result[i] );
+		if( parsed.ec == std::errc::result_out_of_range )
+			consumed = parseFloatStrtof( p, end, &result[i] );
+		else
+			consumed = ( parsed.ec == std::errc() ) ? parsed.ptr - p : 0;
+#else
+		consumed = parseFloatStrtof( p, end, &result[i] );
+#endif
+		if( consumed == 0 ) {
+			std::fill( result + i, result + count, 0.0f );
+			return;
 		}
-		else if( tag == "f" ) { // face
-			parseFace( currentGroup, currentMaterial, line, includeNormals, includeTexCoords );
-		}
-		else if( tag == "g" ) { // group
-			if( ! currentGroup->mFaces.empty() )
-				mGroups.push_back( Group() );
-			currentGroup = &mGroups[mGroups.size()-1];
-			currentGroup->mBaseVertexOffset = (int32_t)mInternalVertices.size();
-			currentGroup->mBaseTexCoordOffset = (int32_t)mInternalTexCoords.size();
-			currentGroup->mBaseNormalOffset = (int32_t)mInternalNormals.size();
-			currentGroup->mName = line.substr( line.find( ' ' ) + 1 );
-		}
-        else if( tag == "usemtl") { // material
-            string tag;
-            ss >> tag;
-            std::map<std::string, Material>::const_iterator m = mMaterials.find(tag);
-            if( m != mMaterials.end() ) {
-                currentMaterial = &m->second;
-            }
-        }
+		else if( std::isinf( result[i] ) ) {
+			result[i] = std::signbit( result[i] ) ? -numeric_limits<float>::max() : numeric_limits<float>::max();
+			std::fill( result + i + 1, result + count, 0.0f );
+			return;
+		}
+		p += consumed;
 	}
 }
 
-void ObjLoader::parseFace( Group *group, const Material *material, const std::string &s, bool includeNormals, bool includeTexCoords )
+// Parses the "v/vt/vn" triples of the face record \a s, leaving the indices as written in the file. \a indices holds three vectors to collect the indices in.
+void parseFace( std::string_view s, bool includeNormals, bool includeTexCoords, vector<int32_t> *indices, ObjLoader::Face *result, uint8_t *flags )
 {
-	ObjLoader::Face result;
-	result.mNumVertices = 0;
-    result.mMaterial = material;
+	result->mNumVertices = 0;
+	result->mMaterial = nullptr;
+	*flags = 0;
+	for( int i = 0; i < 3; ++i )
+		indices[i].clear();
 
 	size_t offset = 2; // account for "f "
 	size_t length = s.length();
 	while( offset < length ) {
 		size_t endOfTriple, firstSlashOffset, secondSlashOffset;
 
-		while( s[offset] == ' ' )
+		while( offset < length && s[offset] == ' ' )
 			++offset;
 
 		// find the end of this triple "v/vt/vn"
@@ -272,52 +377,338 @@ void ObjLoader::parseFace( Group *group, const Material *material, const std::st
 			secondSlashOffset = string::npos;
 
 		// process the vertex index
-		int vertexIndex = (firstSlashOffset != string::npos) ?
-            stoi( s.substr( offset, firstSlashOffset - offset ) ) :
-            stoi( s.substr( offset, endOfTriple - offset));
-
-		if( vertexIndex < 0 )
-			result.mVertexIndices.push_back( group->mBaseVertexOffset + vertexIndex );
-		else
-			result.mVertexIndices.push_back( vertexIndex - 1 );
+		indices[0].push_back( ( firstSlashOffset != string::npos ) ?
+			parseIndex( s.substr( offset, firstSlashOffset - offset ) ) :
+			parseIndex( s.substr( offset, endOfTriple - offset ) ) );
 
 		// process the tex coord index
+		*flags &= ~TEX_COORD_LAST;
 		if( includeTexCoords && ( firstSlashOffset != string::npos ) ) {
 			size_t numSize = ( secondSlashOffset == string::npos ) ? ( endOfTriple - firstSlashOffset - 1 ) : secondSlashOffset - firstSlashOffset - 1;
 			if( numSize > 0 ) {
-				int texCoordIndex = stoi( s.substr( firstSlashOffset + 1, numSize ) );
-				if( texCoordIndex < 0 )
-					result.mTexCoordIndices.push_back( group->mBaseTexCoordOffset + texCoordIndex );
-				else
-					result.mTexCoordIndices.push_back( texCoordIndex - 1 );
-				if( group->mFaces.empty() )
-					group->mHasTexCoords = true;
+				indices[1].push_back( parseIndex( s.substr( firstSlashOffset + 1, numSize ) ) );
+				*flags |= TEX_COORD_LAST;
 			}
 			else
-				group->mHasTexCoords = false;
+				*flags |= TEX_COORD_ANY_EMPTY;
 		}
-		else if( group->mFaces.empty() ) // if this is the first face, let's note that this group has no tex coords
-			group->mHasTexCoords = false;
 
 		// process the normal index
+		*flags &= ~NORMAL_LAST;
 		if( includeNormals && ( secondSlashOffset != string::npos ) ) {
-			int normalIndex = stoi( s.substr( secondSlashOffset + 1, endOfTriple - secondSlashOffset - 1 ) );
-			if( normalIndex < 0 )
-				result.mNormalIndices.push_back( group->mBaseNormalOffset + normalIndex );
-			else
-				result.mNormalIndices.push_back( normalIndex - 1 );
-			group->mHasNormals = true;
+			indices[2].push_back( parseIndex( s.substr( secondSlashOffset + 1, endOfTriple - secondSlashOffset - 1 ) ) );
+			*flags |= NORMAL_LAST | NORMAL_ANY;
 		}
-		else if( group->mFaces.empty() ) // if this is the first face, let's note that this group has no normals
-			group->mHasNormals = false;
 
 		offset = endOfTriple + 1;
-		result.mNumVertices++;
+		result->mNumVertices++;
+	}
+
+	result->mVertexIndices.assign( indices[0].begin(), indices[0].end() );
+	result->mTexCoordIndices.assign( indices[1].begin(), indices[1].end() );
+	result->mNormalIndices.assign( indices[2].begin(), indices[2].end() );
+}
+
+void parseLine( std::string_view line, bool includeNormals, bool includeTexCoords, const std::map<std::string, ObjLoader::Material> &materials, ParsedChunk *chunk )
+{
+	size_t tagBegin = 0;
+	while( tagBegin < line.size() && isSpace( line[tagBegin] ) )
+		++tagBegin;
+	size_t tagEnd = tagBegin;
+	while( tagEnd < line.size() && ! isSpace( line[tagEnd] ) )
+		++tagEnd;
+	const std::string_view tag = line.substr( tagBegin, tagEnd - tagBegin );
+
+	if( tag == "v" ) { // vertex
+		vec3 v;
+		parseFloats( line, tagEnd, &v.x, 3 );
+		chunk->mVertices.push_back( v );
+	}
+	else if( tag == "vt" ) { // vertex texture coordinates
+		if( includeTexCoords ) {
+			vec2 tex;
+			parseFloats( line, tagEnd, &tex.x, 2 );
+			chunk->mTexCoords.push_back( tex );
+		}
+	}
+	else if( tag == "vn" ) { // vertex normals
+		if( includeNormals ) {
+			vec3 v;
+			parseFloats( line, tagEnd, &v.x, 3 );
+			chunk->mNormals.push_back( normalize( v ) );
+		}
+	}
+	else if( tag == "f" ) { // face
+		chunk->mFaces.emplace_back();
+		chunk->mFaceFlags.emplace_back();
+		parseFace( line, includeNormals, includeTexCoords, chunk->mFaceIndices, &chunk->mFaces.back(), &chunk->mFaceFlags.back() );
+	}
+	else if( tag == "g" ) { // group
+		chunk->mEvents.push_back( { chunk->mFaces.size(), chunk->mVertices.size(), chunk->mTexCoords.size(), chunk->mNormals.size(), std::string( line.substr( line.find( ' ' ) + 1 ) ), nullptr } );
+	}
+	else if( tag == "usemtl" ) { // material
+		size_t nameBegin = tagEnd;
+		while( nameBegin < line.size() && isSpace( line[nameBegin] ) )
+			++nameBegin;
+		size_t nameEnd = nameBegin;
+		while( nameEnd < line.size() && ! isSpace( line[nameEnd] ) )
+			++nameEnd;
+		auto m = materials.find( std::string( line.substr( nameBegin, nameEnd - nameBegin ) ) );
+		if( m != materials.end() )
+			chunk->mEvents.push_back( { chunk->mFaces.size(), 0, 0, 0, std::string(), &m->second } );
+	}
+}
+
+void parseChunk( const char *begin, const char *end, bool includeNormals, bool includeTexCoords, const std::map<std::string, ObjLoader::Material> &materials, ParsedChunk *chunk )
+{
+	string joined;
+	const char *p = begin;
+	while( p < end ) {
+		const char *lineEnd = findLineEnd( p, end );
+		std::string_view line( p, lineEnd - p );
+		p = skipLineEnd( lineEnd, end );
+		if( line.empty() || line[0] == '#' )
+			continue;
+
+		// join continued lines; chunks never end on one
+		if( line.back() == '\\' && p < end ) {
+			joined.assign( line );
+			while( ! joined.empty() && joined.back() == '\\' && p < end ) {
+				lineEnd = findLineEnd( p, end );
+				joined.pop_back();
+				joined.append( p, lineEnd );
+				p = skipLineEnd( lineEnd, end );
+			}
+			line = joined;
+		}
+
+		parseLine( line, includeNormals, includeTexCoords, materials, chunk );
+	}
+}
+
+// Splits \a data into chunks of about PARSE_CHUNK_SIZE bytes which start at the beginning of a line, never separating a line ending in '\\' from its continuation
+vector<std::pair<const char*, const char*>> splitChunks( const char *data, size_t size )
+{
+	vector<std::pair<const char*, const char*>> result;
+	const char *end = data + size;
+	const char *begin = data;
+	while( begin < end ) {
+		const char *chunkEnd = ( (size_t)( end - begin ) <= PARSE_CHUNK_SIZE ) ? end : begin + PARSE_CHUNK_SIZE;
+		while( chunkEnd < end ) {
+			const char *lineEnd = findLineEnd( chunkEnd, end );
+			const char *last = ( *lineEnd == '\n' && lineEnd > data && lineEnd[-1] == '\r' ) ? lineEnd - 2 : lineEnd - 1;
+			chunkEnd = skipLineEnd( lineEnd, end );
+			if( lineEnd == end || last < data || *last != '\\' )
+				break;
+		}
+		result.emplace_back( begin, chunkEnd );
+		begin = chunkEnd;
+	}
+
+	return result;
+}
+
+} // anonymous namespace
+
+void ObjLoader::parse( bool includeNormals, bool includeTexCoords )
+{
+	// parse the stream's remaining bytes in place when they're in memory already, as large files loaded from a DataSource are memory mapped
+	const char *data;
+	size_t size;
+	vector<char> contents;
+	if( auto memStream = dynamic_pointer_cast<IStreamMem>( mStream ) ) {
+		const off_t offset = memStream->tell();
+		data = reinterpret_cast<const char*>( memStream->getData() ) + offset;
+		size = static_cast<size_t>( memStream->size() - offset );
+		memStream->seekAbsolute( memStream->size() );
+	}
+	else {
+		const size_t blockSize = 1024 * 1024;
+		while( ! mStream->isEof() ) {
+			const size_t oldSize = contents.size();
+			contents.resize( oldSize + blockSize );
+			const size_t bytesRead = mStream->readDataAvailable( contents.data() + oldSize, blockSize );
+			contents.resize( oldSize + bytesRead );
+			if( bytesRead == 0 )
+				break;
+		}
+		data = contents.data();
+		size = contents.size();
+	}
+
+	// parse the chunks on the shared scheduler; a chunk's exception is kept so that the earliest one in the file is rethrown
+	const auto ranges = splitChunks( data, size );
+	vector<ParsedChunk> chunks( ranges.size() );
+	TaskScheduler::global()->parallelFor( 0, (int64_t)chunks.size(), [&]( int64_t begin, int64_t end ) {
+		for( int64_t c = begin; c < end; ++c ) {
+			try {
+				parseChunk( ranges[c].first, ranges[c].second, includeNormals, includeTexCoords, mMaterials, &chunks[c] );
+			}
+			catch( ... ) {
+				chunks[c].mException = std::current_exception();
+			}
+		}
+	}, 1 );
+
+	size_t numVertices = 0, numTexCoords = 0, numNormals = 0;
+	for( const auto &chunk : chunks ) {
+		if( chunk.mException )
+			std::rethrow_exception( chunk.mException );
+		numVertices += chunk.mVertices.size();
+		numTexCoords += chunk.mTexCoords.size();
+		numNormals += chunk.mNormals.size();
+	}
+	mInternalVertices.reserve( numVertices );
+	mInternalTexCoords.reserve( numTexCoords );
+	mInternalNormals.reserve( numNormals );
+
+	// count the faces of each group, so that their vectors can be allocated up front
+	vector<size_t> groupSizes( 1, 0 );
+	for( const auto &chunk : chunks ) {
+		auto event = chunk.mEvents.begin();
+		for( size_t f = 0; f <= chunk.mFaces.size(); ++f ) {
+			for( ; event != chunk.mEvents.end() && event->mFace == f; ++event ) {
+				if( ! event->mMaterial && groupSizes.back() != 0 )
+					groupSizes.push_back( 0 );
+			}
+			if( f < chunk.mFaces.size() )
+				++groupSizes.back();
+		}
+	}
+
+	// stitch the chunks together in order, resolving groups, materials and relative indices
+	mGroups.reserve( groupSizes.size() );
+	mGroups.push_back( Group() );
+	mGroups.back().mFaces.reserve( groupSizes[0] );
+	Group *currentGroup = &mGroups.back();
+	currentGroup->mBaseVertexOffset = currentGroup->mBaseTexCoordOffset = currentGroup->mBaseNormalOffset = 0;
+	const Material *currentMaterial = nullptr;
+
+	for( auto &chunk : chunks ) {
+		const size_t vertexOffset = mInternalVertices.size(), texCoordOffset = mInternalTexCoords.size(), normalOffset = mInternalNormals.size();
+		auto event = chunk.mEvents.begin();
+		for( size_t f = 0; f <= chunk.mFaces.size(); ++f ) {
+			for( ; event != chunk.mEvents.end() && event->mFace == f; ++event ) {
+				if( event->mMaterial ) {
+					currentMaterial = event->mMaterial;
+					continue;
+				}
+
+				if( ! currentGroup->mFaces.empty() ) {
+					mGroups.push_back( Group() );
+					mGroups.back().mFaces.reserve( groupSizes[mGroups.size() - 1] );
+				}
+				currentGroup = &mGroups.back();
+				currentGroup->mBaseVertexOffset = (int32_t)( vertexOffset + event->mNumVertices );
+				currentGroup->mBaseTexCoordOffset = (int32_t)( texCoordOffset + event->mNumTexCoords );
+				currentGroup->mBaseNormalOffset = (int32_t)( normalOffset + event->mNumNormals );
+				currentGroup->mName = std::move( event->mGroupName );
+			}
+
+			if( f < chunk.mFaces.size() )
+				addFace( currentGroup, currentMaterial, std::move( chunk.mFaces[f] ), chunk.mFaceFlags[f] );
+		}
+
+		mInternalVertices.insert( mInternalVertices.end(), chunk.mVertices.begin(), chunk.mVertices.end() );
+		mInternalTexCoords.insert( mInternalTexCoords.end(), chunk.mTexCoords.begin(), chunk.mTexCoords.end() );
+		mInternalNormals.insert( mInternalNormals.end(), chunk.mNormals.begin(), chunk.mNormals.end() );
+		chunk = ParsedChunk();
 	}
+}
 
-	group->mFaces.push_back( result );
+void ObjLoader::addFace( Group *group, const Material *material, Face &&face, uint8_t flags )
+{
+	face.mMaterial = material;
+	for( auto &index : face.mVertexIndices )
+		index = ( index < 0 ) ? group->mBaseVertexOffset + index : index - 1;
+	for( auto &index : face.mTexCoordIndices )
+		index = ( index < 0 ) ? group->mBaseTexCoordOffset + index : index - 1;
+	for( auto &index : face.mNormalIndices )
+		index = ( index < 0 ) ? group->mBaseNormalOffset + index : index - 1;
+
+	// the first face of a group decides whether it has tex coords and normals; later ones can only take tex coords away, or add normals
+	if( face.mNumVertices > 0 ) {
+		if( group->mFaces.empty() ) {
+			group->mHasTexCoords = ( flags & TEX_COORD_LAST ) != 0;
+			group->mHasNormals = ( flags & NORMAL_LAST ) != 0;
+		}
+		else {
+			if( flags & TEX_COORD_ANY_EMPTY )
+				group->mHasTexCoords = false;
+			if( flags & NORMAL_ANY )
+				group->mHasNormals = true;
+		}
+	}
+
+	group->mFaces.push_back( std::move( face ) );
 }
 
+// Open addressing hash map from a vertex's position, tex coord and normal indices to its index in the output; unused components are passed as zero
+class ObjLoader::UniqueVertexMap {
+  public:
+	//! Sizes the table for about \a expectedSize vertices without growing.
+	UniqueVertexMap( size_t expectedSize )
+		: mSize( 0 )
+	{
+		size_t capacity = 1024;
+		while( capacity < expectedSize * 2 )
+			capacity *= 2;
+		mSlots.resize( capacity );
+	}
+
+	//! Returns the output index of the vertex \a v, \a t, \a n, assigning it \a newIndex and setting \a inserted if it is new.
+	uint32_t insert( int32_t v, int32_t t, int32_t n, uint32_t newIndex, bool *inserted )
+	{
+		if( ( mSize + 1 ) * 2 > mSlots.size() )
+			grow();
+
+		for( size_t i = hash( v, t, n ) & ( mSlots.size() - 1 ); ; i = ( i + 1 ) & ( mSlots.size() - 1 ) ) {
+			Slot &slot = mSlots[i];
+			if( slot.mIndex == EMPTY ) {
+				slot = { v, t, n, newIndex };
+				++mSize;
+				*inserted = true;
+				return newIndex;
+			}
+			else if( slot.mV == v && slot.mT == t && slot.mN == n ) {
+				*inserted = false;
+				return slot.mIndex;
+			}
+		}
+	}
+
+  private:
+	static const uint32_t EMPTY = 0xFFFFFFFF;
+
+	struct Slot {
+		int32_t		mV = 0, mT = 0, mN = 0;
+		uint32_t	mIndex = EMPTY;
+	};
+
+	static size_t hash( int32_t v, int32_t t, int32_t n )
+	{
+		uint64_t h = uint32_t( v ) * 0x9E3779B97F4A7C15ull;
+		h ^= uint32_t( t ) * 0xC2B2AE3D27D4EB4Full + ( h >> 29 );
+		h ^= uint32_t( n ) * 0x165667B19E3779F9ull + ( h >> 31 );
+		return size_t( h ^ ( h >> 32 ) );
+	}
+
+	void grow()
+	{
+		vector<Slot> slots( mSlots.size() * 2 );
+		mSlots.swap( slots );
+		mSize = 0;
+		bool inserted;
+		for( const auto &slot : slots ) {
+			if( slot.mIndex != EMPTY )
+				insert( slot.mV, slot.mT, slot.mN, slot.mIndex, &inserted );
+		}
+	}
+
+	vector<Slot>	mSlots;
+	size_t			mSize;
+};
+
 void ObjLoader::load() const
 {
 	if( mOutputCached )
@@ -361,44 +752,44 @@ void ObjLoader::load() const
 
 	if( normals && texCoords ) {
 		if( hasGroupIndex ) {
-			map<VertexTriple,int> uniqueVerts;
+			UniqueVertexMap uniqueVerts( mInternalVertices.size() );
 			loadGroupNormalsTextures( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexTriple,int> uniqueVerts;
+			UniqueVertexMap uniqueVerts( mInternalVertices.size() );
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupNormalsTextures( *groupIt, uniqueVerts );
 		}
 	}
 	else if( normals ) {
 		if( hasGroupIndex ) {
-			map<VertexPair,int> uniqueVerts;
+			UniqueVertexMap uniqueVerts( mInternalVertices.size() );
 			loadGroupNormals( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexPair,int> uniqueVerts;
+			UniqueVertexMap uniqueVerts( mInternalVertices.size() );
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupNormals( *groupIt, uniqueVerts );
 		}
 	}
 	else if( texCoords ) {
 		if( hasGroupIndex ) {
-			map<VertexPair,int> uniqueVerts;
+			UniqueVertexMap uniqueVerts( mInternalVertices.size() );
 			loadGroupTextures( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexPair,int> uniqueVerts;
+			UniqueVertexMap uniqueVerts( mInternalVertices.size() );
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupTextures( *groupIt, uniqueVerts );
 		}
 	}
 	else {
 		if( hasGroupIndex ) {
-			map<int,int> uniqueVerts;
+			UniqueVertexMap uniqueVerts( mInternalVertices.size() );
 			loadGroup( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<int,int> uniqueVerts;
+			UniqueVertexMap uniqueVerts( mInternalVertices.size() );
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroup( *groupIt, uniqueVerts );
 		}
@@ -407,9 +798,10 @@ void ObjLoader::load() const
 	mOutputCached = true;
 }
 
-void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,int> &uniqueVerts ) const
+void ObjLoader::loadGroupNormalsTextures( const Group &group, UniqueVertexMap &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
+	vector<int32_t> faceIndices;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
 		vec3 inferredNormal;
 		bool forceUnique = ! mOptimizeVertices;
@@ -437,13 +829,12 @@ void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,i
 		if( group.mFaces[f].mTexCoordIndices.empty() )
 			forceUnique = true;
 
-		vector<int> faceIndices;
-		faceIndices.reserve( group.mFaces[f].mNumVertices );
+		faceIndices.clear();
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
-				VertexTriple vTriple = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v], group.mFaces[f].mNormalIndices[v] );
-				pair<map<VertexTriple,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vTriple, mOutputVertices.size() ) );
-				if( result.second ) { // we've got a new, unique vertex here, so let's append it
+				bool inserted;
+				uint32_t index = uniqueVerts.insert( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v], group.mFaces[f].mNormalIndices[v], (uint32_t)mOutputVertices.size(), &inserted );
+				if( inserted ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
 					mOutputTexCoords.push_back( mInternalTexCoords[group.mFaces[f].mTexCoordIndices[v]] );
@@ -451,7 +842,7 @@ void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,i
 						mOutputColors.push_back( rgb );
 				}
 				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
+				faceIndices.push_back( index );
 			}
 			else { // have to force unique because this group lacks either normals or texCoords
 				faceIndices.push_back( (int32_t)mOutputVertices.size() );
@@ -477,9 +868,10 @@ void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,i
 	}
 }
 
-void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqueVerts ) const
+void ObjLoader::loadGroupNormals( const Group &group, UniqueVertexMap &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
+	vector<int32_t> faceIndices;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
         Color rgb;
         if( hasColors ) {
@@ -504,20 +896,19 @@ void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqu
 			forceUnique = true;
 		}
 
-		vector<int> faceIndices;
-		faceIndices.reserve( group.mFaces[f].mNumVertices );
+		faceIndices.clear();
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
-				VertexPair vPair = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mNormalIndices[v] );
-				pair<map<VertexPair,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
-				if( result.second ) { // we've got a new, unique vertex here, so let's append it
+				bool inserted;
+				uint32_t index = uniqueVerts.insert( group.mFaces[f].mVertexIndices[v], 0, group.mFaces[f].mNormalIndices[v], (uint32_t)mOutputVertices.size(), &inserted );
+				if( inserted ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
                     if( hasColors )
                         mOutputColors.push_back( rgb );
 				}
 				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
+				faceIndices.push_back( index );
 			}
 			else { // have to force unique because this group lacks normals
 				faceIndices.push_back( (int32_t)mOutputVertices.size() );
@@ -539,9 +930,10 @@ void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqu
 	}
 }
 
-void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniqueVerts ) const
+void ObjLoader::loadGroupTextures( const Group &group, UniqueVertexMap &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
+	vector<int32_t> faceIndices;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
         Color rgb;
         if( hasColors ) {
@@ -561,20 +953,19 @@ void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniq
 		if( group.mFaces[f].mTexCoordIndices.empty() )
 			forceUnique = true;
 
-		vector<int32_t> faceIndices;
-		faceIndices.reserve( group.mFaces[f].mNumVertices );
+		faceIndices.clear();
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
-				VertexPair vPair = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v] );
-				pair<map<VertexPair,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
-				if( result.second ) { // we've got a new, unique vertex here, so let's append it
+				bool inserted;
+				uint32_t index = uniqueVerts.insert( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v], 0, (uint32_t)mOutputVertices.size(), &inserted );
+				if( inserted ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputTexCoords.push_back( mInternalTexCoords[group.mFaces[f].mTexCoordIndices[v]] );
                     if( hasColors )
                         mOutputColors.push_back( rgb );
 				}
 				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
+				faceIndices.push_back( index );
 			}
 			else { // have to force unique because this group lacks texCoords
 				faceIndices.push_back( (int32_t)mOutputVertices.size() );
@@ -596,9 +987,10 @@ void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniq
 	}
 }
 
-void ObjLoader::loadGroup( const Group &group, map<int,int> &uniqueVerts ) const
+void ObjLoader::loadGroup( const Group &group, UniqueVertexMap &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
+	vector<int32_t> faceIndices;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
         Color rgb;
         if( hasColors ) {
@@ -614,17 +1006,17 @@ void ObjLoader::loadGroup( const Group &group, map<int,int> &uniqueVerts ) const
                 rgb.b = 1;
             }
         }
-		vector<int> faceIndices;
-		faceIndices.reserve( group.mFaces[f].mNumVertices );
+		faceIndices.clear();
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
-			pair<map<int,int>::iterator,bool> result = uniqueVerts.insert( make_pair( group.mFaces[f].mVertexIndices[v], mOutputVertices.size() ) );
-			if( result.second ) { // we've got a new, unique vertex here, so let's append it
+			bool inserted;
+			uint32_t index = uniqueVerts.insert( group.mFaces[f].mVertexIndices[v], 0, 0, (uint32_t)mOutputVertices.size(), &inserted );
+			if( inserted ) { // we've got a new, unique vertex here, so let's append it
 				mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
                 if( hasColors )
                     mOutputColors.push_back( rgb );
 			}
 			// the unique ID of the vertex is appended for this vert
-			faceIndices.push_back( result.first->second );
+			faceIndices.push_back( index );
 		}
 
 		int32_t triangles = (int32_t)faceIndices.size() - 2;
@@ -31,12 +31,15 @@
 #include "cinder/CinderMath.h"
 #include "cinder/Path2d.h"
 #include "cinder/Shape2d.h"
+#include "cinder/Thread.h"
 
 #include <algorithm>
 #include <map>
 #include <set>
 #include <cfloat>
 #include <iterator>
+#include <functional>
+#include <mutex>
 
 using std::vector;
 
@@ -1132,14 +1135,11 @@ Path2d Path2d::transformed( const mat3& matrix ) const
 }
 
 namespace { // getSubPath helpers
-void appendChopped( const Path2d& source, size_t segment, float segRelT, bool secondHalf, Path2d* result )
+// \a firstPoint is the index of the first point of \a segment
+void appendChopped( const Path2d& source, size_t segment, size_t firstPoint, float segRelT, bool secondHalf, Path2d* result )
 {
-	auto sourceSegments = source.getSegments();
-	auto sourcePoints = source.getPoints();
-	// iterate to first point of segment
-	size_t firstPoint = 0;
-	for( size_t s = 0; s < segment; ++s )
-		firstPoint += Path2d::sSegmentTypePointCounts[sourceSegments[s]];
+	const auto& sourceSegments = source.getSegments();
+	const auto& sourcePoints = source.getPoints();
 
 	vec2 temp[7];
 	switch( sourceSegments[segment] ) {
@@ -1178,15 +1178,9 @@ void appendChopped( const Path2d& source, size_t segment, float segRelT, bool se
 	}
 }
 
-void append( const Path2d& source, size_t segment, Path2d* result )
+void append( const Path2d& source, size_t segment, size_t firstPoint, Path2d* result )
 {
-	auto   sourceSegments = source.getSegments();
-	auto   sourcePoints = source.getPoints();
-	size_t firstPoint = 0;
-	for( size_t s = 0; s < segment; ++s )
-		firstPoint += Path2d::sSegmentTypePointCounts[sourceSegments[s]];
-
-	result->appendSegment( sourceSegments[segment], &sourcePoints[firstPoint] );
+	result->appendSegment( source.getSegments()[segment], &source.getPoints()[firstPoint] );
 }
 } // namespace
 
@@ -1200,14 +1194,14 @@ Path2d Path2d::getSubPath( float startT, float endT ) const
 	getSegmentRelativeT( startT, &startSegment, &startRelT );
 	getSegmentRelativeT( endT, &endSegment, &endRelT );
 
+	// iterate to first point of the start segment
+	size_t firstPoint = 0;
+	for( size_t s = 0; s < startSegment; ++s )
+		firstPoint += sSegmentTypePointCounts[mSegments[s]];
+
 	Path2d result;
 	// startT and endT are the same segment
 	if( startSegment == endSegment ) {
-		// iterate to first point of the segment
-		size_t firstPoint = 0;
-		for( size_t s = 0; s < startSegment; ++s )
-			firstPoint += sSegmentTypePointCounts[mSegments[s]];
-
 		switch( mSegments[startSegment] ) {
 			case LINETO: // trim line
 				result.mPoints.push_back( mPoints[firstPoint] + startRelT * ( mPoints[firstPoint + 1] - mPoints[firstPoint] ) );
@@ -1235,12 +1229,15 @@ Path2d Path2d::getSubPath( float startT, float endT ) const
 	}
 	else {
 		// append first segment chopped at startRelT
-		appendChopped( *this, startSegment, startRelT, true, &result );
+		appendChopped( *this, startSegment, firstPoint, startRelT, true, &result );
+		firstPoint += sSegmentTypePointCounts[mSegments[startSegment]];
 		// append all intermediate segments
-		for( size_t s = startSegment + 1; s < endSegment; ++s )
-			append( *this, s, &result );
+		for( size_t s = startSegment + 1; s < endSegment; ++s ) {
+			append( *this, s, firstPoint, &result );
+			firstPoint += sSegmentTypePointCounts[mSegments[s]];
+		}
 		// append last segment chopped at endRelT
-		appendChopped( *this, endSegment, endRelT, false, &result );
+		appendChopped( *this, endSegment, firstPoint, endRelT, false, &result );
 	}
 
 	return result;
@@ -2255,119 +2252,205 @@ float Path2dCalcCache::calcTimeForDistance( float distance, bool wrap, float tol
 	return mPath.segmentSolveTimeForDistance( currentSegment, currentSegmentLength, distance, tolerance, maxIterations );
 }
 
-std::vector<Path2d::SelfIntersection> Path2d::findSelfIntersections( float tolerance ) const
-{
-	std::vector<SelfIntersection> results;
+namespace { // findSelfIntersections() and findIntersections() helpers
+
+typedef std::pair<uint32_t, uint32_t> SegmentPair;
+
+// The control points of a segment and the bounds of its control polygon, which contain the curve. CLOSE is the line back to the first point.
+struct SegmentCurve {
+	Path2d::SegmentType	type;
+	size_t				numPts; // 0 for segments without geometry
+	dvec2				pts[4];
+	Rectf				bounds;
+};
+
+std::vector<SegmentCurve> calcSegmentCurves( const std::vector<vec2> &points, const std::vector<Path2d::SegmentType> &segments )
+{
+	std::vector<SegmentCurve> result( segments.size() );
+	// MOVETO is NOT stored in the segments array, so segment s starts at the last point of segment s - 1
+	size_t firstPt = 0;
+	for( size_t s = 0; s < segments.size(); ++s ) {
+		SegmentCurve &curve = result[s];
+		curve.type = segments[s];
+		curve.numPts = 0;
+		if( segments[s] == Path2d::CLOSE ) {
+			if( ! points.empty() ) {
+				curve.type = Path2d::LINETO;
+				curve.pts[0] = dvec2( points.back() );
+				curve.pts[1] = dvec2( points[0] );
+				curve.numPts = 2;
+			}
+		}
+		else if( segments[s] != Path2d::MOVETO ) {
+			curve.numPts = Path2d::sSegmentTypePointCounts[segments[s]] + 1;
+			for( size_t p = 0; p < curve.numPts; ++p )
+				curve.pts[p] = dvec2( points[firstPt + p] );
+		}
 
-	if( mSegments.empty() )
-		return results;
+		if( curve.numPts ) {
+			curve.bounds = Rectf( vec2( curve.pts[0] ), vec2( curve.pts[0] ) );
+			for( size_t p = 1; p < curve.numPts; ++p )
+				curve.bounds.include( vec2( curve.pts[p] ) );
+		}
+		firstPt += Path2d::sSegmentTypePointCounts[segments[s]];
+	}
 
-	// Pre-computed segment control points to avoid per-pair allocations
-	struct SegmentPts {
-		SegmentType type;
-		dvec2		pts[4];
-		size_t		numPts;
-	};
+	return result;
+}
 
-	// Build segment info (first point index for each segment)
-	std::vector<size_t> segmentFirstPoint;
-	size_t				ptIdx = 1; // Start after MOVETO point
-	for( size_t s = 0; s < mSegments.size(); ++s ) {
-		segmentFirstPoint.push_back( ptIdx - 1 ); // Include the "from" point
-		ptIdx += sSegmentTypePointCounts[mSegments[s]];
+// Elevates lines and quadratics to cubics
+void toCubic( const SegmentCurve &curve, dvec2 c[4] )
+{
+	if( curve.type == Path2d::QUADTO )
+		raiseQuadraticToCubic( curve.pts, c );
+	else if( curve.type == Path2d::CUBICTO )
+		std::copy( curve.pts, curve.pts + 4, c );
+	else {
+		c[0] = curve.pts[0];
+		c[1] = curve.pts[0] + ( curve.pts[1] - curve.pts[0] ) / 3.0;
+		c[2] = curve.pts[0] + 2.0 * ( curve.pts[1] - curve.pts[0] ) / 3.0;
+		c[3] = curve.pts[1];
 	}
+}
 
-	// Pre-compute bounding boxes for all segments (for early rejection)
-	// Uses control polygon convex hull property: curve is contained within control point bounds
-	std::vector<Rectf> segmentBounds( mSegments.size() );
-	ptIdx = 1;
-	for( size_t s = 0; s < mSegments.size(); ++s ) {
-		if( mSegments[s] == CUBICTO || mSegments[s] == QUADTO ) {
-			Rectf  bounds( mPoints[ptIdx - 1], mPoints[ptIdx - 1] );
-			size_t numPts = sSegmentTypePointCounts[mSegments[s]];
-			for( size_t p = 0; p <= numPts; ++p ) { // <= to include endpoint
-				bounds.include( mPoints[ptIdx - 1 + p] );
-			}
-			segmentBounds[s] = bounds;
-		}
-		else if( mSegments[s] == LINETO ) {
-			// Use include() to ensure canonical bounds (x1 <= x2, y1 <= y2)
-			Rectf bounds( mPoints[ptIdx - 1], mPoints[ptIdx - 1] );
-			bounds.include( mPoints[ptIdx] );
-			segmentBounds[s] = bounds;
-		}
-		else if( mSegments[s] == CLOSE && ! mPoints.empty() ) {
-			// CLOSE is an implicit line from last point to first point
-			Rectf bounds( mPoints[ptIdx - 1], mPoints[ptIdx - 1] );
-			bounds.include( mPoints[0] );
-			segmentBounds[s] = bounds;
-		}
-		ptIdx += sSegmentTypePointCounts[mSegments[s]];
+std::vector<CurveIntersection<double>> intersectSegmentCurves( const SegmentCurve &a, const SegmentCurve &b, double tolerance )
+{
+	std::vector<CurveIntersection<double>> result;
+	if( a.type == Path2d::CUBICTO && b.type == Path2d::CUBICTO )
+		result = intersectCubicCubic( a.pts, b.pts, tolerance );
+	else if( a.type == Path2d::CUBICTO && b.type == Path2d::LINETO ) {
+		LineIntersection<double> lineIsects[3];
+		int count = intersectLineCubic( a.pts, b.pts[0], b.pts[1], lineIsects );
+		for( int k = 0; k < count; ++k )
+			result.emplace_back( lineIsects[k].segmentT, lineIsects[k].lineT );
+	}
+	else if( a.type == Path2d::LINETO && b.type == Path2d::CUBICTO ) {
+		LineIntersection<double> lineIsects[3];
+		int count = intersectLineCubic( b.pts, a.pts[0], a.pts[1], lineIsects );
+		for( int k = 0; k < count; ++k )
+			result.emplace_back( lineIsects[k].lineT, lineIsects[k].segmentT );
+	}
+	else if( a.type == Path2d::LINETO && b.type == Path2d::LINETO ) {
+		LineIntersection<double> lineIsect[1];
+		if( intersectLineLine( a.pts[0], a.pts[1], b.pts[0], b.pts[1], lineIsect ) > 0 )
+			result.emplace_back( lineIsect[0].segmentT, lineIsect[0].lineT );
+	}
+	else {
+		// a quadratic with anything, as cubics
+		dvec2 c1[4], c2[4];
+		toCubic( a, c1 );
+		toCubic( b, c2 );
+		result = intersectCubicCubic( c1, c2, tolerance );
 	}
 
-	// Pre-compute control points for all segments (avoid per-pair allocations in hot loop)
-	std::vector<SegmentPts> segmentCtrlPts( mSegments.size() );
-	ptIdx = 1;
-	for( size_t s = 0; s < mSegments.size(); ++s ) {
-		size_t		firstPt = ptIdx - 1;
-		SegmentType type = mSegments[s];
-		SegmentPts& sp = segmentCtrlPts[s];
-		sp.type = type;
-		sp.numPts = 0;
+	return result;
+}
 
-		switch( type ) {
-			case LINETO:
-				sp.pts[0] = dvec2( mPoints[firstPt] );
-				sp.pts[1] = dvec2( mPoints[firstPt + 1] );
-				sp.numPts = 2;
-				break;
-			case QUADTO:
-				sp.pts[0] = dvec2( mPoints[firstPt] );
-				sp.pts[1] = dvec2( mPoints[firstPt + 1] );
-				sp.pts[2] = dvec2( mPoints[firstPt + 2] );
-				sp.numPts = 3;
-				break;
-			case CUBICTO:
-				sp.pts[0] = dvec2( mPoints[firstPt] );
-				sp.pts[1] = dvec2( mPoints[firstPt + 1] );
-				sp.pts[2] = dvec2( mPoints[firstPt + 2] );
-				sp.pts[3] = dvec2( mPoints[firstPt + 3] );
-				sp.numPts = 4;
-				break;
-			case CLOSE:
-				// CLOSE is an implicit line from the last point back to the first point
-				if( ! mPoints.empty() ) {
-					sp.pts[0] = dvec2( mPoints[firstPt] );
-					sp.pts[1] = dvec2( mPoints[0] );
-					sp.numPts = 2;
-				}
-				sp.type = LINETO; // Treat CLOSE as LINETO for intersection purposes
-				break;
-			default:
-				break;
+vec2 evalSegmentCurve( const SegmentCurve &curve, double t )
+{
+	if( curve.type == Path2d::CUBICTO )
+		return vec2( evalCubicBezier( curve.pts, t ) );
+	else if( curve.type == Path2d::QUADTO )
+		return vec2( evalQuadraticBezier( curve.pts, t ) );
+	else
+		return vec2( glm::mix( curve.pts[0], curve.pts[1], t ) );
+}
+
+// The segments with geometry, sorted by the left of their bounds
+std::vector<uint32_t> sortByLeft( const std::vector<SegmentCurve> &curves )
+{
+	std::vector<uint32_t> result;
+	for( uint32_t s = 0; s < curves.size(); ++s ) {
+		if( curves[s].numPts )
+			result.push_back( s );
+	}
+	std::sort( result.begin(), result.end(), [&curves]( uint32_t a, uint32_t b ) {
+		return curves[a].bounds.x1 < curves[b].bounds.x1 || ( curves[a].bounds.x1 == curves[b].bounds.x1 && a < b );
+	} );
+
+	return result;
+}
+
+bool overlapsVertically( const Rectf &a, const Rectf &b )
+{
+	return a.y1 <= b.y2 && a.y2 >= b.y1;
+}
+
+// Sweep-and-prune: the pairs of segments whose bounds overlap, in sweep order. This takes O(n log n + k) rather than O(n²) for k overlapping pairs.
+std::vector<SegmentPair> findOverlappingPairs( const std::vector<SegmentCurve> &curves )
+{
+	const std::vector<uint32_t> sorted = sortByLeft( curves );
+	std::vector<SegmentPair> result;
+	for( size_t ii = 0; ii < sorted.size(); ++ii ) {
+		const Rectf &bounds = curves[sorted[ii]].bounds;
+		// the segments starting left of our right edge, after which all others will too
+		for( size_t jj = ii + 1; jj < sorted.size() && curves[sorted[jj]].bounds.x1 <= bounds.x2; ++jj ) {
+			if( overlapsVertically( bounds, curves[sorted[jj]].bounds ) )
+				result.emplace_back( sorted[ii], sorted[jj] );
 		}
-		ptIdx += sSegmentTypePointCounts[mSegments[s]];
 	}
 
-	// Check each cubic segment for self-intersection
-	ptIdx = 1;
-	for( size_t s = 0; s < mSegments.size(); ++s ) {
-		if( mSegments[s] == CUBICTO ) {
-			dvec2 c[4] = { dvec2( mPoints[ptIdx - 1] ), dvec2( mPoints[ptIdx] ), dvec2( mPoints[ptIdx + 1] ), dvec2( mPoints[ptIdx + 2] ) };
+	return result;
+}
 
-			auto selfIsects = selfIntersectCubic( c, double( tolerance ), 0.02 );
-			for( const auto& isect : selfIsects ) {
-				SelfIntersection si;
-				si.segment1 = s;
-				si.segment2 = s;
-				si.t1 = float( s ) + float( isect.t1 );
-				si.t2 = float( s ) + float( isect.t2 );
-				si.point = vec2( evalCubicBezier( c, isect.t1 ) );
-				results.push_back( si );
+// Sweep-and-prune over two paths: the pairs of a segment of \a curves1 and one of \a curves2 whose bounds overlap, ordered by segment.
+// The segment of a pair that starts first finds the other among those of the other path that start within it.
+std::vector<SegmentPair> findOverlappingPairs( const std::vector<SegmentCurve> &curves1, const std::vector<SegmentCurve> &curves2 )
+{
+	const std::vector<uint32_t> sorted1 = sortByLeft( curves1 ), sorted2 = sortByLeft( curves2 );
+	std::vector<SegmentPair> result;
+	size_t ii = 0, jj = 0;
+	while( ii < sorted1.size() && jj < sorted2.size() ) {
+		const Rectf &bounds1 = curves1[sorted1[ii]].bounds, &bounds2 = curves2[sorted2[jj]].bounds;
+		if( bounds1.x1 <= bounds2.x1 ) {
+			for( size_t j = jj; j < sorted2.size() && curves2[sorted2[j]].bounds.x1 <= bounds1.x2; ++j ) {
+				if( overlapsVertically( bounds1, curves2[sorted2[j]].bounds ) )
+					result.emplace_back( sorted1[ii], sorted2[j] );
 			}
+			++ii;
+		}
+		else {
+			for( size_t i = ii; i < sorted1.size() && curves1[sorted1[i]].bounds.x1 <= bounds2.x2; ++i ) {
+				if( overlapsVertically( curves1[sorted1[i]].bounds, bounds2 ) )
+					result.emplace_back( sorted1[i], sorted2[jj] );
+			}
+			++jj;
 		}
-		ptIdx += sSegmentTypePointCounts[mSegments[s]];
 	}
+	std::sort( result.begin(), result.end() );
+
+	return result;
+}
+
+// Calls \a bandFn( begin, end, &results ) over bands of [0, \a count) in parallel, and concatenates the results of the bands in order
+template<typename R>
+std::vector<R> collectInBands( size_t count, int numThreads, const std::function<void( size_t, size_t, std::vector<R>* )> &bandFn )
+{
+	std::mutex mutex;
+	std::vector<std::pair<size_t, std::vector<R>>> bands;
+	TaskScheduler::global()->parallelFor( 0, (int64_t)count, [&]( int64_t begin, int64_t end ) {
+		std::vector<R> results;
+		bandFn( size_t( begin ), size_t( end ), &results );
+		std::lock_guard<std::mutex> lock( mutex );
+		bands.emplace_back( size_t( begin ), std::move( results ) );
+	}, 64, numThreads );
+	std::sort( bands.begin(), bands.end(), []( const auto &a, const auto &b ) { return a.first < b.first; } );
+
+	std::vector<R> result;
+	for( const auto &band : bands )
+		result.insert( result.end(), band.second.begin(), band.second.end() );
+	return result;
+}
+
+} // namespace
+
+std::vector<Path2d::SelfIntersection> Path2d::findSelfIntersections( float tolerance, int numThreads ) const
+{
+	if( mSegments.empty() )
+		return {};
+
+	// Pre-computed segment control points and bounds, to avoid per-pair allocations
+	const std::vector<SegmentCurve> curves = calcSegmentCurves( mPoints, mSegments );
 
 	// Cache isClosed() to avoid repeated calls in inner loop
 	const bool pathIsClosed = isClosed();
@@ -2386,149 +2469,52 @@ std::vector<Path2d::SelfIntersection> Path2d::findSelfIntersections( float toler
 		}
 	}
 
-	// Sweep-and-prune: sort segments by x-min, then sweep to find overlapping pairs
-	// This reduces average complexity from O(n²) to O(n log n + k) where k is overlapping pairs
-
-	// Build list of drawable segments with their bounds
-	std::vector<size_t> drawableSegments;
-	for( size_t s = 0; s < mSegments.size(); ++s ) {
-		if( mSegments[s] != MOVETO )
-			drawableSegments.push_back( s );
+	// Each cubic against itself, in segment order, followed by the pairs of segments whose bounds overlap
+	std::vector<SegmentPair> pairs;
+	for( uint32_t s = 0; s < curves.size(); ++s ) {
+		if( curves[s].type == CUBICTO )
+			pairs.emplace_back( s, s );
 	}
+	const std::vector<SegmentPair> overlapping = findOverlappingPairs( curves );
+	pairs.insert( pairs.end(), overlapping.begin(), overlapping.end() );
 
-	// Sort by x-min of bounding box
-	std::sort( drawableSegments.begin(), drawableSegments.end(), [&segmentBounds]( size_t a, size_t b ) { return segmentBounds[a].x1 < segmentBounds[b].x1; } );
-
-	// Sweep through segments, maintaining active set
-	for( size_t ii = 0; ii < drawableSegments.size(); ++ii ) {
-		size_t i = drawableSegments[ii];
-		float  xMax_i = segmentBounds[i].x2;
-
-		const SegmentPts& sp1 = segmentCtrlPts[i];
-		if( sp1.numPts == 0 )
-			continue;
-
-		// Check against subsequent segments while their x-min <= our x-max
-		for( size_t jj = ii + 1; jj < drawableSegments.size(); ++jj ) {
-			size_t j = drawableSegments[jj];
-
-			// Early termination: if this segment starts after our x-max, all subsequent will too
-			if( segmentBounds[j].x1 > xMax_i )
-				break;
-
-			// Still need to check y-overlap
-			if( segmentBounds[i].y1 > segmentBounds[j].y2 || segmentBounds[i].y2 < segmentBounds[j].y1 )
+	// The narrow phase runs in parallel over the pairs
+	return collectInBands<SelfIntersection>( pairs.size(), numThreads, [&]( size_t begin, size_t end, std::vector<SelfIntersection> *results ) {
+		for( size_t p = begin; p < end; ++p ) {
+			// Ensure consistent ordering (smaller index first) for result reporting
+			const size_t seg1Idx = std::min( pairs[p].first, pairs[p].second ), seg2Idx = std::max( pairs[p].first, pairs[p].second );
+			const SegmentCurve &curve1 = curves[seg1Idx], &curve2 = curves[seg2Idx];
+
+			if( seg1Idx == seg2Idx ) {
+				for( const auto& isect : selfIntersectCubic( curve1.pts, double( tolerance ), 0.02 ) ) {
+					SelfIntersection si;
+					si.segment1 = seg1Idx;
+					si.segment2 = seg1Idx;
+					si.t1 = float( seg1Idx ) + float( isect.t1 );
+					si.t2 = float( seg1Idx ) + float( isect.t2 );
+					si.point = vec2( evalCubicBezier( curve1.pts, isect.t1 ) );
+					results->push_back( si );
+				}
 				continue;
+			}
 
 			// Check adjacency: consecutive segments, first-last for closed paths,
 			// or CLOSE segment adjacent to its neighbors
-			bool areAdjacent = ( j == i + 1 || i == j + 1 );
+			bool areAdjacent = ( seg2Idx == seg1Idx + 1 );
 			if( ! areAdjacent && pathIsClosed ) {
 				// First and last drawable segments are adjacent via CLOSE
-				if( ( i == firstDrawable && j == lastDrawable ) || ( j == firstDrawable && i == lastDrawable ) )
+				if( seg1Idx == firstDrawable && seg2Idx == lastDrawable )
 					areAdjacent = true;
 				// CLOSE segment is adjacent to lastDrawable and firstDrawable
-				if( mSegments[i] == CLOSE && ( j == firstDrawable || j == lastDrawable ) )
+				if( mSegments[seg1Idx] == CLOSE && ( seg2Idx == firstDrawable || seg2Idx == lastDrawable ) )
 					areAdjacent = true;
-				if( mSegments[j] == CLOSE && ( i == firstDrawable || i == lastDrawable ) )
+				if( mSegments[seg2Idx] == CLOSE && ( seg1Idx == firstDrawable || seg1Idx == lastDrawable ) )
 					areAdjacent = true;
 			}
 
-			const SegmentPts& sp2 = segmentCtrlPts[j];
-			if( sp2.numPts == 0 )
-				continue;
-
-			// Ensure consistent ordering (smaller index first) for result reporting
-			size_t			  seg1Idx = i, seg2Idx = j;
-			SegmentType		  t1 = sp1.type, t2 = sp2.type;
-			const SegmentPts* p1 = &sp1;
-			const SegmentPts* p2 = &sp2;
-			if( i > j ) {
-				std::swap( seg1Idx, seg2Idx );
-				std::swap( t1, t2 );
-				std::swap( p1, p2 );
-			}
-
-			// Check intersection based on segment types
-			std::vector<CurveIntersection<double>> isects;
-
-			if( t1 == CUBICTO && t2 == CUBICTO ) {
-				// Cubic-Cubic
-				dvec2 c1[4] = { p1->pts[0], p1->pts[1], p1->pts[2], p1->pts[3] };
-				dvec2 c2[4] = { p2->pts[0], p2->pts[1], p2->pts[2], p2->pts[3] };
-				isects = intersectCubicCubic( c1, c2, double( tolerance ) );
-			}
-			else if( t1 == CUBICTO && t2 == LINETO ) {
-				// Cubic-Line
-				dvec2					 c[4] = { p1->pts[0], p1->pts[1], p1->pts[2], p1->pts[3] };
-				LineIntersection<double> lineIsects[3];
-				int						 count = intersectLineCubic( c, p2->pts[0], p2->pts[1], lineIsects );
-				for( int k = 0; k < count; ++k ) {
-					isects.emplace_back( lineIsects[k].segmentT, lineIsects[k].lineT );
-				}
-			}
-			else if( t1 == LINETO && t2 == CUBICTO ) {
-				// Line-Cubic
-				dvec2					 c[4] = { p2->pts[0], p2->pts[1], p2->pts[2], p2->pts[3] };
-				LineIntersection<double> lineIsects[3];
-				int						 count = intersectLineCubic( c, p1->pts[0], p1->pts[1], lineIsects );
-				for( int k = 0; k < count; ++k ) {
-					// Swap t1/t2 since we swapped the order
-					isects.emplace_back( lineIsects[k].lineT, lineIsects[k].segmentT );
-				}
-			}
-			else if( t1 == LINETO && t2 == LINETO ) {
-				// Line-Line
-				LineIntersection<double> lineIsect[1];
-				int						 count = intersectLineLine( p1->pts[0], p1->pts[1], p2->pts[0], p2->pts[1], lineIsect );
-				if( count > 0 ) {
-					isects.emplace_back( lineIsect[0].segmentT, lineIsect[0].lineT );
-				}
-			}
-			else if( t1 == QUADTO || t2 == QUADTO ) {
-				// Elevate quadratics to cubics
-				dvec2 c1[4], c2[4];
-
-				if( t1 == QUADTO ) {
-					dvec2 q[3] = { p1->pts[0], p1->pts[1], p1->pts[2] };
-					raiseQuadraticToCubic( q, c1 );
-				}
-				else if( t1 == CUBICTO ) {
-					c1[0] = p1->pts[0];
-					c1[1] = p1->pts[1];
-					c1[2] = p1->pts[2];
-					c1[3] = p1->pts[3];
-				}
-				else { // LINETO - elevate to cubic
-					c1[0] = p1->pts[0];
-					c1[1] = p1->pts[0] + ( p1->pts[1] - p1->pts[0] ) / 3.0;
-					c1[2] = p1->pts[0] + 2.0 * ( p1->pts[1] - p1->pts[0] ) / 3.0;
-					c1[3] = p1->pts[1];
-				}
-
-				if( t2 == QUADTO ) {
-					dvec2 q[3] = { p2->pts[0], p2->pts[1], p2->pts[2] };
-					raiseQuadraticToCubic( q, c2 );
-				}
-				else if( t2 == CUBICTO ) {
-					c2[0] = p2->pts[0];
-					c2[1] = p2->pts[1];
-					c2[2] = p2->pts[2];
-					c2[3] = p2->pts[3];
-				}
-				else { // LINETO - elevate to cubic
-					c2[0] = p2->pts[0];
-					c2[1] = p2->pts[0] + ( p2->pts[1] - p2->pts[0] ) / 3.0;
-					c2[2] = p2->pts[0] + 2.0 * ( p2->pts[1] - p2->pts[0] ) / 3.0;
-					c2[3] = p2->pts[1];
-				}
-
-				isects = intersectCubicCubic( c1, c2, double( tolerance ) );
-			}
-
 			// Add results (filtering out endpoint intersections for adjacent segments)
 			constexpr double ENDPOINT_THRESHOLD = 0.01;
-			for( const auto& isect : isects ) {
+			for( const auto& isect : intersectSegmentCurves( curve1, curve2, double( tolerance ) ) ) {
 				// For adjacent segments, skip the shared endpoint intersection
 				if( areAdjacent ) {
 					// Skip if t1 ≈ 1 and t2 ≈ 0 (shared endpoint between consecutive segments)
@@ -2558,26 +2544,11 @@ std::vector<Path2d::SelfIntersection> Path2d::findSelfIntersections( float toler
 				si.segment2 = seg2Idx;
 				si.t1 = float( seg1Idx ) + float( isect.t1 );
 				si.t2 = float( seg2Idx ) + float( isect.t2 );
-
-				// Compute intersection point
-				if( t1 == CUBICTO ) {
-					dvec2 c[4] = { p1->pts[0], p1->pts[1], p1->pts[2], p1->pts[3] };
-					si.point = vec2( evalCubicBezier( c, isect.t1 ) );
-				}
-				else if( t1 == QUADTO ) {
-					dvec2 q[3] = { p1->pts[0], p1->pts[1], p1->pts[2] };
-					si.point = vec2( evalQuadraticBezier( q, isect.t1 ) );
-				}
-				else {
-					si.point = vec2( glm::mix( p1->pts[0], p1->pts[1], isect.t1 ) );
-				}
-
-				results.push_back( si );
+				si.point = evalSegmentCurve( curve1, isect.t1 );
+				results->push_back( si );
 			}
 		}
-	}
-
-	return results;
+	} );
 }
 
 bool Path2d::isCoincident( const Path2d& other, float tolerance ) const
@@ -2613,261 +2584,43 @@ bool Path2d::isCoincident( const Shape2d& shape, float tolerance ) const
 	return false;
 }
 
-std::vector<Path2d::Intersection> Path2d::findIntersections( const Path2d& other, float tolerance ) const
+std::vector<Path2d::Intersection> Path2d::findIntersections( const Path2d& other, float tolerance, int numThreads ) const
 {
-	std::vector<Intersection> results;
-
 	if( mSegments.empty() || mPoints.empty() || other.mSegments.empty() || other.mPoints.empty() )
-		return results;
+		return {};
 
 	// Check for coincident paths - prevents pathological behavior with overlapping curves
 	if( isCoincident( other, tolerance ) )
-		return results;
-
-	// Helper to get segment control points for intersection testing
-	// firstPt represents the index of the first point of this segment (including inherited start point)
-	// Note: MOVETO is NOT stored in the segments array - only the point is stored
-	// So for LINETO at index 0: firstPt=0, uses points[0] (inherited from moveTo) and points[1]
-	// For LINETO at index N: firstPt=N, uses points[N] and points[N+1]
-	auto getSegmentPoints = []( const Path2d& path, size_t segIdx, size_t firstPt ) -> std::pair<SegmentType, std::vector<dvec2>> {
-		std::vector<dvec2> pts;
-		SegmentType		   type = path.getSegments()[segIdx];
-		const auto&		   points = path.getPoints();
-		switch( type ) {
-			case LINETO:
-				pts.push_back( dvec2( points[firstPt] ) );	   // start
-				pts.push_back( dvec2( points[firstPt + 1] ) ); // end
-				break;
-			case QUADTO:
-				pts.push_back( dvec2( points[firstPt] ) );	   // start
-				pts.push_back( dvec2( points[firstPt + 1] ) ); // control
-				pts.push_back( dvec2( points[firstPt + 2] ) ); // end
-				break;
-			case CUBICTO:
-				pts.push_back( dvec2( points[firstPt] ) );	   // start
-				pts.push_back( dvec2( points[firstPt + 1] ) ); // control 1
-				pts.push_back( dvec2( points[firstPt + 2] ) ); // control 2
-				pts.push_back( dvec2( points[firstPt + 3] ) ); // end
-				break;
-			case CLOSE:
-				// CLOSE is an implicit line from the last point back to the first point
-				// Note: firstPt is invalid for CLOSE (points past end), use points.size()-1
-				if( ! points.empty() ) {
-					pts.push_back( dvec2( points[points.size() - 1] ) ); // Last point
-					pts.push_back( dvec2( points[0] ) );				 // First point (MOVETO)
-				}
-				break;
-			default:
-				break;
-		}
-		// For CLOSE, treat it as LINETO for intersection purposes
-		if( type == CLOSE && pts.size() == 2 ) {
-			return { LINETO, pts };
-		}
-		return { type, pts };
-	};
-
-	// Build segment info for this path
-	std::vector<size_t> segmentFirstPoint1;
-	size_t				ptIdx = 1;
-	for( size_t s = 0; s < mSegments.size(); ++s ) {
-		segmentFirstPoint1.push_back( ptIdx - 1 );
-		ptIdx += sSegmentTypePointCounts[mSegments[s]];
-	}
+		return {};
 
-	// Build segment info for other path
-	std::vector<size_t> segmentFirstPoint2;
-	ptIdx = 1;
-	for( size_t s = 0; s < other.mSegments.size(); ++s ) {
-		segmentFirstPoint2.push_back( ptIdx - 1 );
-		ptIdx += sSegmentTypePointCounts[other.mSegments[s]];
-	}
-
-	// Pre-compute bounding boxes for this path
-	// Note: MOVETO is NOT stored in the segments array - only the point is stored
-	// ptIdx starts at 1, and for the first segment (after implicit moveTo), ptIdx=1 means
-	// the segment uses points[0] and points[1]
-	std::vector<Rectf> bounds1( mSegments.size() );
-	ptIdx = 1;
-	for( size_t s = 0; s < mSegments.size(); ++s ) {
-		if( mSegments[s] == CUBICTO || mSegments[s] == QUADTO ) {
-			Rectf  bounds( mPoints[ptIdx - 1], mPoints[ptIdx - 1] );
-			size_t numPts = sSegmentTypePointCounts[mSegments[s]];
-			for( size_t p = 0; p <= numPts; ++p ) {
-				bounds.include( mPoints[ptIdx - 1 + p] );
-			}
-			bounds1[s] = bounds;
-		}
-		else if( mSegments[s] == LINETO ) {
-			Rectf bounds( mPoints[ptIdx - 1], mPoints[ptIdx - 1] );
-			bounds.include( mPoints[ptIdx] );
-			bounds1[s] = bounds;
-		}
-		else if( mSegments[s] == CLOSE && ! mPoints.empty() ) {
-			// CLOSE is a line from last point to first point
-			// Note: ptIdx-1 is invalid for CLOSE (points past end), use mPoints.size()-1
-			Rectf bounds( mPoints[mPoints.size() - 1], mPoints[mPoints.size() - 1] );
-			bounds.include( mPoints[0] );
-			bounds1[s] = bounds;
-		}
-		ptIdx += sSegmentTypePointCounts[mSegments[s]];
-	}
-
-	// Pre-compute bounding boxes for other path
-	std::vector<Rectf> bounds2( other.mSegments.size() );
-	ptIdx = 1;
-	for( size_t s = 0; s < other.mSegments.size(); ++s ) {
-		if( other.mSegments[s] == CUBICTO || other.mSegments[s] == QUADTO ) {
-			Rectf  bounds( other.mPoints[ptIdx - 1], other.mPoints[ptIdx - 1] );
-			size_t numPts = sSegmentTypePointCounts[other.mSegments[s]];
-			for( size_t p = 0; p <= numPts; ++p ) {
-				bounds.include( other.mPoints[ptIdx - 1 + p] );
-			}
-			bounds2[s] = bounds;
-		}
-		else if( other.mSegments[s] == LINETO ) {
-			Rectf bounds( other.mPoints[ptIdx - 1], other.mPoints[ptIdx - 1] );
-			bounds.include( other.mPoints[ptIdx] );
-			bounds2[s] = bounds;
-		}
-		else if( other.mSegments[s] == CLOSE && ! other.mPoints.empty() ) {
-			// CLOSE is a line from last point to first point
-			// Note: ptIdx-1 is invalid for CLOSE (points past end), use points.size()-1
-			Rectf bounds( other.mPoints[other.mPoints.size() - 1], other.mPoints[other.mPoints.size() - 1] );
-			bounds.include( other.mPoints[0] );
-			bounds2[s] = bounds;
-		}
-		ptIdx += sSegmentTypePointCounts[other.mSegments[s]];
-	}
-
-	// Check all pairs of segments between paths
-	for( size_t i = 0; i < mSegments.size(); ++i ) {
-		if( mSegments[i] == MOVETO )
-			continue;
-
-		auto [type1, pts1] = getSegmentPoints( *this, i, segmentFirstPoint1[i] );
-		if( pts1.empty() )
-			continue;
+	const std::vector<SegmentCurve> curves1 = calcSegmentCurves( mPoints, mSegments );
+	const std::vector<SegmentCurve> curves2 = calcSegmentCurves( other.mPoints, other.mSegments );
+	const std::vector<SegmentPair> pairs = findOverlappingPairs( curves1, curves2 );
 
-		for( size_t j = 0; j < other.mSegments.size(); ++j ) {
-			if( other.mSegments[j] == MOVETO )
-				continue;
-
-			// Early rejection: skip if bounding boxes don't overlap
-			if( ! bounds1[i].intersects( bounds2[j] ) )
-				continue;
-
-			auto [type2, pts2] = getSegmentPoints( other, j, segmentFirstPoint2[j] );
-			if( pts2.empty() )
-				continue;
-
-			// Check intersection based on segment types
-			std::vector<CurveIntersection<double>> isects;
-
-			if( type1 == CUBICTO && type2 == CUBICTO ) {
-				dvec2 c1[4] = { pts1[0], pts1[1], pts1[2], pts1[3] };
-				dvec2 c2[4] = { pts2[0], pts2[1], pts2[2], pts2[3] };
-				isects = intersectCubicCubic( c1, c2, double( tolerance ) );
-			}
-			else if( type1 == CUBICTO && type2 == LINETO ) {
-				dvec2					 c[4] = { pts1[0], pts1[1], pts1[2], pts1[3] };
-				LineIntersection<double> lineIsects[3];
-				int						 count = intersectLineCubic( c, pts2[0], pts2[1], lineIsects );
-				for( int k = 0; k < count; ++k ) {
-					isects.emplace_back( lineIsects[k].segmentT, lineIsects[k].lineT );
-				}
-			}
-			else if( type1 == LINETO && type2 == CUBICTO ) {
-				dvec2					 c[4] = { pts2[0], pts2[1], pts2[2], pts2[3] };
-				LineIntersection<double> lineIsects[3];
-				int						 count = intersectLineCubic( c, pts1[0], pts1[1], lineIsects );
-				for( int k = 0; k < count; ++k ) {
-					isects.emplace_back( lineIsects[k].lineT, lineIsects[k].segmentT );
-				}
-			}
-			else if( type1 == LINETO && type2 == LINETO ) {
-				LineIntersection<double> lineIsect[1];
-				int						 count = intersectLineLine( pts1[0], pts1[1], pts2[0], pts2[1], lineIsect );
-				if( count > 0 ) {
-					isects.emplace_back( lineIsect[0].segmentT, lineIsect[0].lineT );
-				}
-			}
-			else if( type1 == QUADTO || type2 == QUADTO ) {
-				// Elevate quadratics to cubics
-				dvec2 c1[4], c2[4];
-
-				if( type1 == QUADTO ) {
-					dvec2 q[3] = { pts1[0], pts1[1], pts1[2] };
-					raiseQuadraticToCubic( q, c1 );
-				}
-				else if( type1 == CUBICTO ) {
-					c1[0] = pts1[0];
-					c1[1] = pts1[1];
-					c1[2] = pts1[2];
-					c1[3] = pts1[3];
-				}
-				else {
-					c1[0] = pts1[0];
-					c1[1] = pts1[0] + ( pts1[1] - pts1[0] ) / 3.0;
-					c1[2] = pts1[0] + 2.0 * ( pts1[1] - pts1[0] ) / 3.0;
-					c1[3] = pts1[1];
-				}
-
-				if( type2 == QUADTO ) {
-					dvec2 q[3] = { pts2[0], pts2[1], pts2[2] };
-					raiseQuadraticToCubic( q, c2 );
-				}
-				else if( type2 == CUBICTO ) {
-					c2[0] = pts2[0];
-					c2[1] = pts2[1];
-					c2[2] = pts2[2];
-					c2[3] = pts2[3];
-				}
-				else {
-					c2[0] = pts2[0];
-					c2[1] = pts2[0] + ( pts2[1] - pts2[0] ) / 3.0;
-					c2[2] = pts2[0] + 2.0 * ( pts2[1] - pts2[0] ) / 3.0;
-					c2[3] = pts2[1];
-				}
-
-				isects = intersectCubicCubic( c1, c2, double( tolerance ) );
-			}
-
-			// Add results
-			for( const auto& isect : isects ) {
+	return collectInBands<Intersection>( pairs.size(), numThreads, [&]( size_t begin, size_t end, std::vector<Intersection> *results ) {
+		for( size_t p = begin; p < end; ++p ) {
+			const size_t i = pairs[p].first, j = pairs[p].second;
+			for( const auto& isect : intersectSegmentCurves( curves1[i], curves2[j], double( tolerance ) ) ) {
 				Intersection ix;
 				ix.segment1 = i;
 				ix.segment2 = j;
+				ix.contour2 = 0;
 				ix.t1 = float( i ) + float( isect.t1 );
 				ix.t2 = float( j ) + float( isect.t2 );
-
 				// Compute intersection point using this path's segment
-				if( type1 == CUBICTO ) {
-					dvec2 c[4] = { pts1[0], pts1[1], pts1[2], pts1[3] };
-					ix.point = vec2( evalCubicBezier( c, isect.t1 ) );
-				}
-				else if( type1 == QUADTO ) {
-					dvec2 q[3] = { pts1[0], pts1[1], pts1[2] };
-					ix.point = vec2( evalQuadraticBezier( q, isect.t1 ) );
-				}
-				else {
-					ix.point = vec2( glm::mix( pts1[0], pts1[1], isect.t1 ) );
-				}
-
-				results.push_back( ix );
+				ix.point = evalSegmentCurve( curves1[i], isect.t1 );
+				results->push_back( ix );
 			}
 		}
-	}
-
-	return results;
+	} );
 }
 
-std::vector<Path2d::Intersection> Path2d::findIntersections( const Shape2d& shape, float tolerance ) const
+std::vector<Path2d::Intersection> Path2d::findIntersections( const Shape2d& shape, float tolerance, int numThreads ) const
 {
 	std::vector<Intersection> results;
 
 	for( size_t i = 0; i < shape.getNumContours(); ++i ) {
-		auto contourIsects = findIntersections( shape.getContour( i ), tolerance );
+		auto contourIsects = findIntersections( shape.getContour( i ), tolerance, numThreads );
 		// Set the contour index for each intersection
 		for( auto& ix : contourIsects ) {
 			ix.contour2 = i;
@@ -3159,11 +2912,8 @@ void appendPath( Path2d& dest, const Path2d& src )
 	if( src.empty() )
 		return;
 
-	for( size_t s = 0; s < src.getNumSegments(); ++s ) {
-		size_t ptIdx = 1;
-		for( size_t i = 0; i < s; ++i ) {
-			ptIdx += Path2d::sSegmentTypePointCounts[src.getSegments()[i]];
-		}
+	size_t ptIdx = 1;
+	for( size_t s = 0; s < src.getNumSegments(); ptIdx += Path2d::sSegmentTypePointCounts[src.getSegments()[s++]] ) {
 		switch( src.getSegmentType( s ) ) {
 			case Path2d::LINETO:
 				dest.lineTo( src.getPoints()[ptIdx] );
@@ -32,6 +32,20 @@
 #include <string>
 #include <cstring>
 #include <algorithm>
+#include <bit>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#include <emmintrin.h>
+#endif
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 using std::string;
 using std::memcpy;
 
@@ -119,18 +133,64 @@ void IStreamCinder::readFixedString( std::string *t, size_t size )
 	*t = buffer.get();
 }
 
+namespace {
+
+// Returns the first '\n' or '\r' in [begin, end), or \a end if there is none
+const char* findLineEnd( const char *begin, const char *end )
+{
+	const char *p = begin;
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	const __m128i lf = _mm_set1_epi8( '\n' ), cr = _mm_set1_epi8( '\r' );
+	for( ; end - p >= 16; p += 16 ) {
+		const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+		const int mask = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, lf ), _mm_cmpeq_epi8( v, cr ) ) );
+		if( mask )
+			return p + std::countr_zero( static_cast<unsigned>( mask ) );
+	}
+#endif
+	for( ; p < end; ++p ) {
+		if( *p == '\n' || *p == '\r' )
+			return p;
+	}
+
+	return end;
+}
+
+} // anonymous namespace
+
 std::string IStreamCinder::readLine()
 {
 	string result;
+	const uint8_t *data;
+	size_t size;
+	while( ( size = IOPeek( &data ) ) > 0 ) {
+		const char *begin = reinterpret_cast<const char*>( data );
+		const char *end = findLineEnd( begin, begin + size );
+		result.append( begin, end );
+		if( end == begin + size ) {
+			IOSkip( size );
+			continue;
+		}
+
+		const bool cr = *end == 0x0D;
+		IOSkip( end - begin + 1 );
+		if( cr && IOPeek( &data ) > 0 && *data == 0x0A )
+			IOSkip( 1 );
+		return result;
+	}
+
+	// streams which don't expose their buffer are read a character at a time
 	int8_t ch;
 	while( ! isEof() ) {
 		read( &ch );
 		if( ch == 0x0A )
 			break;
 		else if( ch == 0x0D ) {
-			read( &ch );
-			if( ch != 0x0A )
-				seekRelative( -1 );
+			if( ! isEof() ) {
+				read( &ch );
+				if( ch != 0x0A )
+					seekRelative( -1 );
+			}
 			break;
 		}
 		else
@@ -145,6 +205,67 @@ void IStreamCinder::readData( void *t, size_t size )
 	IORead( t, size );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// LineReader
+bool LineReader::readLine( std::string_view *line )
+{
+	mCarry.clear();
+	bool partial = false;
+	const uint8_t *data;
+	size_t size;
+	while( ( size = mStream->IOPeek( &data ) ) > 0 ) {
+		const char *begin = reinterpret_cast<const char*>( data );
+		const char *end = findLineEnd( begin, begin + size );
+		if( end == begin + size ) { // the line continues past the buffer; keep what we have before it's refilled
+			mStream->IOSkip( size );
+			if( ! partial && mStream->isEof() ) { // unless it's the unterminated last line
+				*line = std::string_view( begin, size );
+				return true;
+			}
+			mCarry.append( begin, end );
+			partial = true;
+			continue;
+		}
+
+		if( *end == 0x0D ) {
+			if( end + 1 < begin + size ) {
+				const bool crlf = end[1] == 0x0A;
+				mStream->IOSkip( end - begin + ( crlf ? 2 : 1 ) );
+			}
+			else { // whether an '\n' follows is only known after a refill, which invalidates the buffer
+				mCarry.append( begin, end );
+				partial = true;
+				mStream->IOSkip( size );
+				if( mStream->IOPeek( &data ) > 0 && *data == 0x0A )
+					mStream->IOSkip( 1 );
+				*line = mCarry;
+				return true;
+			}
+		}
+		else
+			mStream->IOSkip( end - begin + 1 );
+
+		if( partial ) {
+			mCarry.append( begin, end );
+			*line = mCarry;
+		}
+		else
+			*line = std::string_view( begin, end - begin );
+		return true;
+	}
+
+	if( partial ) { // the last line has no terminator
+		*line = mCarry;
+		return true;
+	}
+	else if( mStream->isEof() )
+		return false;
+
+	mCarry = mStream->readLine();
+	*line = mCarry;
+	return true;
+}
+
 void OStream::write( const Buffer &buffer )
 {
 	IOWrite( buffer.getData(), buffer.getSize() );
@@ -249,7 +370,13 @@ off_t IStreamFile::size() const
 
 bool IStreamFile::isEof() const
 {
-	return ( ( mBufferOffset >= mBufferFileOffset + (off_t)mBufferSize ) && ( static_cast<bool>( feof( mFile ) != 0 ) ) );
+	// feof() is only set by a read which comes up short, so a read which ends exactly at the end of the file needs the size too
+	if( ( mBufferOffset < mBufferFileOffset + (off_t)mBufferSize ) || ( feof( mFile ) == 0 && mBufferOffset < size() ) )
+		return false;
+
+	// the file may have grown since it was measured or came up short, so measure it again before reporting its end
+	mSizeCached = false;
+	return mBufferOffset >= size();
 }
 
 void IStreamFile::IORead( void *t, size_t size )
@@ -265,6 +392,23 @@ void IStreamFile::IORead( void *t, size_t size )
 }
 
 
+size_t IStreamFile::IOPeek( const uint8_t **data )
+{
+	if( ( mBufferOffset < mBufferFileOffset ) || ( mBufferOffset >= mBufferFileOffset + (off_t)mBufferSize ) ) {
+		fseek( mFile, static_cast<long>( mBufferOffset ), SEEK_SET );
+		mBufferFileOffset = mBufferOffset;
+		mBufferSize = fread( mBuffer.get(), 1, mDefaultBufferSize, mFile );
+	}
+
+	*data = mBuffer.get() + ( mBufferOffset - mBufferFileOffset );
+	return static_cast<size_t>( mBufferFileOffset + (off_t)mBufferSize - mBufferOffset );
+}
+
+void IStreamFile::IOSkip( size_t size )
+{
+	mBufferOffset += size;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 // IStreamAndroidAsset
 #if defined( CINDER_ANDROID )
@@ -612,6 +756,17 @@ void IStreamMem::IORead( void *t, size_t size )
 	mOffset += size;
 }
 
+size_t IStreamMem::IOPeek( const uint8_t **data )
+{
+	*data = mData + mOffset;
+	return mOffset < mDataSize ? mDataSize - mOffset : 0;
+}
+
+void IStreamMem::IOSkip( size_t size )
+{
+	mOffset += size;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 // OStreamMem
 OStreamMem::OStreamMem( size_t bufferSizeHint )
@@ -652,6 +807,87 @@ void OStreamMem::IOWrite( const void *t, size_t size )
 	mOffset += size;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// MappedFile
+MappedFileRef MappedFile::create( const fs::path &path )
+{
+	return MappedFileRef( new MappedFile( path ) );
+}
+
+MappedFile::MappedFile( const fs::path &path )
+	: mFilePath( path ), mData( nullptr ), mSize( 0 )
+{
+#if defined( CINDER_MSW )
+	HANDLE file = ::CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( file == INVALID_HANDLE_VALUE )
+		throw StreamExc( "(MappedFile) couldn't open: " + path.string() );
+
+	LARGE_INTEGER fileSize;
+	if( ! ::GetFileSizeEx( file, &fileSize ) || (uint64_t)fileSize.QuadPart > std::numeric_limits<size_t>::max() ) {
+		::CloseHandle( file );
+		throw StreamExc( "(MappedFile) couldn't determine the size of: " + path.string() );
+	}
+	mSize = (size_t)fileSize.QuadPart;
+
+	if( mSize > 0 ) {
+		// the view keeps the mapping object, and the mapping the file, alive after their handles are closed
+		HANDLE mapping = ::CreateFileMappingW( file, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+		if( mapping )
+			mData = ::MapViewOfFile( mapping, FILE_MAP_COPY, 0, 0, 0 );
+		if( mapping )
+			::CloseHandle( mapping );
+	}
+	::CloseHandle( file );
+#else
+	int fd = ::open( path.string().c_str(), O_RDONLY );
+	if( fd < 0 )
+		throw StreamExc( "(MappedFile) couldn't open: " + path.string() );
+
+	struct stat fileStat;
+	if( ::fstat( fd, &fileStat ) != 0 || ! S_ISREG( fileStat.st_mode ) || (uint64_t)fileStat.st_size > std::numeric_limits<size_t>::max() ) {
+		::close( fd );
+		throw StreamExc( "(MappedFile) not a regular file: " + path.string() );
+	}
+	mSize = (size_t)fileStat.st_size;
+
+	if( mSize > 0 ) {
+		// the mapping keeps the file alive after the descriptor is closed
+		void *data = ::mmap( nullptr, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+		if( data != MAP_FAILED )
+			mData = data;
+	}
+	::close( fd );
+#endif
+
+	if( mSize > 0 && ! mData )
+		throw StreamExc( "(MappedFile) couldn't map: " + path.string() );
+}
+
+MappedFile::~MappedFile()
+{
+	if( ! mData )
+		return;
+
+#if defined( CINDER_MSW )
+	::UnmapViewOfFile( mData );
+#else
+	::munmap( mData, mSize );
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// IStreamMapped
+IStreamMappedRef IStreamMapped::create( const MappedFileRef &mappedFile )
+{
+	return IStreamMappedRef( new IStreamMapped( mappedFile ) );
+}
+
+IStreamMapped::IStreamMapped( const MappedFileRef &mappedFile )
+	: IStreamMem( mappedFile->getData(), mappedFile->getSize() ), mMappedFile( mappedFile )
+{
+	setFileName( mappedFile->getFilePath() );
+}
+
 /////////////////////////////////////////////////////////////////////
 
 IStreamFileRef loadFileStream( const fs::path &path )
@@ -712,6 +948,16 @@ IoStreamFileRef readWriteFileStream( const fs::path &path )
 		return IoStreamFileRef();
 }
 
+IStreamMappedRef loadFileStreamMapped( const fs::path &path )
+{
+	try {
+		return IStreamMapped::create( MappedFile::create( path ) );
+	}
+	catch( StreamExc & ) {
+		return IStreamMappedRef();
+	}
+}
+
 void loadStreamMemory( IStreamRef is, std::shared_ptr<uint8_t> *resultData, size_t *resultDataSize )
 {
 	// prevent crash if stream is not valid
@@ -59,6 +59,12 @@
 	#include <cxxabi.h>
 #endif
 
+#if defined( CINDER_MSW_DESKTOP )
+	#include <intrin.h>
+#elif ( defined( __clang__ ) || defined( __GNUC__ ) ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+	#define CINDER_SYSTEM_GCC_X86
+#endif
+
 #include <string>
 
 using namespace std;
@@ -253,6 +259,10 @@ bool System::hasSse2()
 		instance()->mHasSSE2 = true;
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE2 = ( instance()->mCPUID_EDX & 0x04000000 ) != 0;
+#elif defined( CINDER_SYSTEM_GCC_X86 )
+		instance()->mHasSSE2 = __builtin_cpu_supports( "sse2" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasSSE2 = false;
 #else
 	throw Exception( "Not implemented" );
 #endif
@@ -271,6 +281,10 @@ bool System::hasSse3()
 		instance()->mHasSSE3 = true;
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE3 = ( instance()->mCPUID_ECX & 0x00000001 ) != 0;
+#elif defined( CINDER_SYSTEM_GCC_X86 )
+		instance()->mHasSSE3 = __builtin_cpu_supports( "sse3" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasSSE3 = false;
 #else
 		throw Exception( "Not implemented" );
 #endif
@@ -289,6 +303,10 @@ bool System::hasSse4_1()
 		instance()->mHasSSE4_1 = true; // TODO: this is not being tested
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE4_1 = ( instance()->mCPUID_ECX & ( 1 << 19 ) ) != 0;
+#elif defined( CINDER_SYSTEM_GCC_X86 )
+		instance()->mHasSSE4_1 = __builtin_cpu_supports( "sse4.1" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasSSE4_1 = false;
 #else
 		throw Exception( "Not implemented" );
 #endif
@@ -307,6 +325,10 @@ bool System::hasSse4_2()
 		instance()->mHasSSE4_2 = true; // TODO: this is not being tested
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE4_2 = ( instance()->mCPUID_ECX & ( 1 << 20 ) ) != 0;
+#elif defined( CINDER_SYSTEM_GCC_X86 )
+		instance()->mHasSSE4_2 = __builtin_cpu_supports( "sse4.2" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasSSE4_2 = false;
 #else
 		throw Exception( "Not implemented" );
 #endif		
@@ -316,10 +338,33 @@ bool System::hasSse4_2()
 	return instance()->mHasSSE4_2;
 }
 
+bool System::hasAvx2()
+{
+	if( ! instance()->mCachedValues[HAS_AVX2] ) {
+#if defined( CINDER_COCOA )
+		instance()->mHasAVX2 = ( getSysCtlValue<int>( "hw.optional.avx2_0" ) == 1 );
+#elif defined( CINDER_MSW_DESKTOP ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+		// AVX2 needs both the CPU feature bit and the OS saving the YMM registers on context switches
+		int info[4];
+		__cpuid( info, 1 );
+		bool osSavesYmm = ( info[2] & ( 1 << 27 ) ) && ( info[2] & ( 1 << 28 ) ) && ( ( _xgetbv( 0 ) & 0x6 ) == 0x6 );
+		__cpuidex( info, 7, 0 );
+		instance()->mHasAVX2 = osSavesYmm && ( info[1] & ( 1 << 5 ) ) != 0;
+#elif defined( CINDER_SYSTEM_GCC_X86 )
+		instance()->mHasAVX2 = __builtin_cpu_supports( "avx2" ) != 0;
+#else
+		instance()->mHasAVX2 = false;
+#endif
+		instance()->mCachedValues[HAS_AVX2] = true;
+	}
+
+	return instance()->mHasAVX2;
+}
+
 bool System::hasArm()
 {
 	if( ! instance()->mCachedValues[HAS_ARM] ) {
-#if defined( CINDER_COCOA_TOUCH )
+#if defined( CINDER_COCOA_TOUCH ) || defined( __arm__ ) || defined( __aarch64__ ) || defined( _M_ARM ) || defined( _M_ARM64 )
 		instance()->mHasArm = true;
 #else
 		instance()->mHasArm = false;
@@ -338,6 +383,10 @@ bool System::hasX86_64()
 		instance()->mHasX86_64 = true;
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasX86_64 = ( instance()->mCPUID_EDX & ( 1 << 29 ) ) != 0;
+#elif defined( __x86_64__ )
+		instance()->mHasX86_64 = true;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasX86_64 = false;
 #else
 		throw Exception( "Not implemented" );
 #endif		
@@ -0,0 +1,503 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/Thread.h"
+#include "cinder/Log.h"
+#include "cinder/System.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <vector>
+
+#if defined( CINDER_LINUX ) && defined( __GLIBC__ )
+	#include <pthread.h>
+	#include <sched.h>
+#elif defined( CINDER_MSW )
+	#include <windows.h>
+#endif
+
+namespace cinder {
+
+namespace detail {
+
+struct Task;
+
+struct TaskGroupState {
+	TaskGroupState( TaskSchedulerImpl *scheduler ) : mScheduler( scheduler ), mNumPending( 0 ) {}
+
+	// Called once per task after it has run. The last task of the group wakes up any waiters and queues the continuations.
+	void finishTask();
+
+	TaskSchedulerImpl					*mScheduler;
+	std::atomic<int64_t>				mNumPending;
+	std::mutex							mMutex;
+	std::condition_variable				mCompletedCond;
+	std::exception_ptr					mException; // guarded by mMutex
+	std::vector<std::pair<std::function<void()>, TaskPriority>>	mContinuations; // guarded by mMutex
+};
+
+struct Task {
+	std::function<void()>			mFn;
+	std::shared_ptr<TaskGroupState>	mGroup; // null for spawned tasks and continuations
+};
+
+namespace {
+
+// A deque of tasks whose owner pushes and pops at the back while other threads steal from the front.
+// Each deque has its own lock, so an owner only ever contends with a thief of that same deque.
+class TaskQueue {
+  public:
+	~TaskQueue()
+	{
+		for( Task *task : mTasks )
+			delete task;
+	}
+
+	void push( Task *task )
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mTasks.push_back( task );
+	}
+
+	Task* popBack()
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		if( mTasks.empty() )
+			return nullptr;
+		Task *result = mTasks.back();
+		mTasks.pop_back();
+		return result;
+	}
+
+	Task* popFront()
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		if( mTasks.empty() )
+			return nullptr;
+		Task *result = mTasks.front();
+		mTasks.pop_front();
+		return result;
+	}
+
+  private:
+	std::mutex			mMutex;
+	std::deque<Task*>	mTasks;
+};
+
+// aligned so that workers polling neighboring queues don't share cache lines
+struct alignas( 64 ) Worker {
+	TaskQueue		mQueue;
+	std::thread		mThread;
+};
+
+thread_local TaskSchedulerImpl	*tCurrentScheduler = nullptr;
+thread_local int				tCurrentWorkerIndex = -1;
+
+void pinCurrentThread( int core )
+{
+#if defined( CINDER_LINUX ) && defined( __GLIBC__ )
+	cpu_set_t cpus;
+	CPU_ZERO( &cpus );
+	CPU_SET( core % CPU_SETSIZE, &cpus );
+	::pthread_setaffinity_np( ::pthread_self(), sizeof( cpus ), &cpus );
+#elif defined( CINDER_MSW )
+	::SetThreadAffinityMask( ::GetCurrentThread(), DWORD_PTR( 1 ) << ( core % ( sizeof( DWORD_PTR ) * 8 ) ) );
+#else
+	(void)core;
+#endif
+}
+
+} // anonymous namespace
+
+class TaskSchedulerImpl {
+  public:
+	TaskSchedulerImpl( const TaskScheduler::Options &options )
+		: mNumQueued( 0 ), mNumSleeping( 0 ), mQuit( false )
+	{
+		const int numCores = std::max<int>( 1, (int)std::thread::hardware_concurrency() );
+		const int numThreads = options.getNumThreads() > 0 ? options.getNumThreads() : std::max( 1, numCores - 1 );
+		// every Worker exists before any thread starts, since workers steal from each other
+		for( int i = 0; i < numThreads; ++i )
+			mWorkers.push_back( std::make_unique<Worker>() );
+		for( int i = 0; i < numThreads; ++i ) {
+			const int core = options.getPinThreads() ? i % numCores : -1;
+			mWorkers[i]->mThread = std::thread( &TaskSchedulerImpl::workerLoop, this, i, core );
+		}
+	}
+
+	// Runs what is still queued, including tasks queued by those tasks, before the workers exit
+	~TaskSchedulerImpl()
+	{
+		{
+			std::lock_guard<std::mutex> lock( mSleepMutex );
+			mQuit = true;
+		}
+		mWakeCond.notify_all();
+		for( auto &worker : mWorkers )
+			worker->mThread.join();
+	}
+
+	int getNumThreads() const
+	{
+		return (int)mWorkers.size();
+	}
+
+	int getCurrentWorkerIndex() const
+	{
+		return tCurrentScheduler == this ? tCurrentWorkerIndex : -1;
+	}
+
+	void push( Task *task, TaskPriority priority )
+	{
+		const int index = getCurrentWorkerIndex();
+		if( priority == TaskPriority::HIGH )
+			mHighPriorityQueue.push( task );
+		else if( index >= 0 )
+			mWorkers[index]->mQueue.push( task );
+		else
+			mSharedQueue.push( task );
+
+		// pairs with the sleeping worker incrementing mNumSleeping before checking mNumQueued, so that one of the two always sees the other
+		mNumQueued.fetch_add( 1 );
+		if( mNumSleeping.load() > 0 ) {
+			std::lock_guard<std::mutex> lock( mSleepMutex );
+			mWakeCond.notify_one();
+		}
+	}
+
+	// Returns the next task for worker \a index, or for a thread outside the scheduler when \a index is -1.
+	// High priority tasks come first, then the worker's own newest task, then tasks queued from outside the scheduler and finally the oldest task of another worker.
+	Task* findTask( int index )
+	{
+		if( mNumQueued.load( std::memory_order_relaxed ) <= 0 )
+			return nullptr;
+
+		Task *result = mHighPriorityQueue.popFront();
+		if( ! result && index >= 0 )
+			result = mWorkers[index]->mQueue.popBack();
+		if( ! result )
+			result = mSharedQueue.popFront();
+		const size_t numWorkers = mWorkers.size();
+		for( size_t i = 1; ! result && i <= numWorkers; ++i )
+			result = mWorkers[( index + i ) % numWorkers]->mQueue.popFront();
+
+		if( result )
+			mNumQueued.fetch_sub( 1 );
+		return result;
+	}
+
+	void runTask( Task *task )
+	{
+		std::unique_ptr<Task> ownedTask( task );
+		try {
+			task->mFn();
+		}
+		catch( ... ) {
+			if( task->mGroup ) {
+				std::lock_guard<std::mutex> lock( task->mGroup->mMutex );
+				if( ! task->mGroup->mException )
+					task->mGroup->mException = std::current_exception();
+			}
+			else
+				logException( std::current_exception() );
+		}
+
+		// captures may refer to the waiting thread's stack, so they're released before the group lets it return
+		task->mFn = nullptr;
+		if( task->mGroup )
+			task->mGroup->finishTask();
+	}
+
+  private:
+	void workerLoop( int index, int core )
+	{
+		tCurrentScheduler = this;
+		tCurrentWorkerIndex = index;
+		ThreadSetup threadSetup;
+		if( core >= 0 )
+			pinCurrentThread( core );
+
+		while( true ) {
+			if( Task *task = findTask( index ) ) {
+				runTask( task );
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock( mSleepMutex );
+			if( mQuit && mNumQueued.load() <= 0 )
+				return;
+			mNumSleeping.fetch_add( 1 );
+			mWakeCond.wait( lock, [this] { return mQuit || mNumQueued.load() > 0; } );
+			mNumSleeping.fetch_sub( 1 );
+		}
+	}
+
+	static void logException( std::exception_ptr exc )
+	{
+		try {
+			std::rethrow_exception( exc );
+		}
+		catch( const std::exception &exc ) {
+			CI_LOG_EXCEPTION( "uncaught exception in a spawned task", exc );
+		}
+		catch( ... ) {
+			CI_LOG_E( "uncaught exception of unknown type in a spawned task" );
+		}
+	}
+
+	std::vector<std::unique_ptr<Worker>>	mWorkers;
+	TaskQueue								mHighPriorityQueue, mSharedQueue;
+	std::atomic<int64_t>					mNumQueued; // may briefly dip below zero while a push is completing
+	std::atomic<int>						mNumSleeping;
+	std::mutex								mSleepMutex;
+	std::condition_variable					mWakeCond;
+	bool									mQuit; // guarded by mSleepMutex
+};
+
+void TaskGroupState::finishTask()
+{
+	if( mNumPending.fetch_sub( 1, std::memory_order_acq_rel ) != 1 )
+		return;
+
+	std::vector<std::pair<std::function<void()>, TaskPriority>> continuations;
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		continuations.swap( mContinuations );
+		mCompletedCond.notify_all();
+	}
+	for( auto &continuation : continuations )
+		mScheduler->push( new Task{ std::move( continuation.first ), nullptr }, continuation.second );
+}
+
+} // namespace detail
+
+namespace {
+
+// [begin, end) split evenly into chunks, which are claimed through an atomic counter so that faster threads take on more of them
+class ChunkJob {
+  public:
+	ChunkJob( int64_t begin, int64_t end, int64_t numChunks, const std::function<void( int64_t, int64_t )> &rangeFn )
+		: mBegin( begin ), mNumChunks( numChunks ), mChunkSize( ( end - begin ) / numChunks ), mRemainder( ( end - begin ) % numChunks ), mRangeFn( rangeFn ), mNextChunk( 0 )
+	{}
+
+	// Claims and runs chunks until none remain. An exception stops every thread from claiming further chunks.
+	void runChunks()
+	{
+		int64_t chunk;
+		while( ( chunk = mNextChunk.fetch_add( 1, std::memory_order_relaxed ) ) < mNumChunks ) {
+			const int64_t chunkBegin = mBegin + chunk * mChunkSize + std::min( chunk, mRemainder );
+			const int64_t chunkEnd = chunkBegin + mChunkSize + ( chunk < mRemainder ? 1 : 0 );
+			try {
+				mRangeFn( chunkBegin, chunkEnd );
+			}
+			catch( ... ) {
+				mNextChunk.store( mNumChunks, std::memory_order_relaxed );
+				throw;
+			}
+		}
+	}
+
+  private:
+	const int64_t									mBegin, mNumChunks, mChunkSize, mRemainder;
+	const std::function<void( int64_t, int64_t )>&	mRangeFn;
+	std::atomic<int64_t>							mNextChunk;
+};
+
+// Lends the calling thread a TaskGroupState for the duration of a parallelFor(), so that repeated calls don't allocate one each. Nested calls take
+// states of their own. A task may still hold a reference for a moment after its group completes, which is harmless since it has finished with the state.
+class ScopedGroupState : private Noncopyable {
+  public:
+	ScopedGroupState( detail::TaskSchedulerImpl *scheduler )
+	{
+		auto &pool = getPool();
+		if( pool.empty() )
+			mState = std::make_shared<detail::TaskGroupState>( scheduler );
+		else {
+			mState = std::move( pool.back() );
+			pool.pop_back();
+			mState->mScheduler = scheduler;
+		}
+	}
+
+	~ScopedGroupState()
+	{
+		getPool().push_back( std::move( mState ) );
+	}
+
+	const std::shared_ptr<detail::TaskGroupState>&	get() const	{ return mState; }
+
+  private:
+	static std::vector<std::shared_ptr<detail::TaskGroupState>>& getPool()
+	{
+		static thread_local std::vector<std::shared_ptr<detail::TaskGroupState>> sPool;
+		return sPool;
+	}
+
+	std::shared_ptr<detail::TaskGroupState>	mState;
+};
+
+} // anonymous namespace
+
+TaskScheduler::TaskScheduler( const Options &options )
+	: mImpl( new detail::TaskSchedulerImpl( options ) )
+{
+}
+
+TaskScheduler::~TaskScheduler()
+{
+}
+
+TaskScheduler* TaskScheduler::global()
+{
+	static TaskScheduler sInstance;
+	return &sInstance;
+}
+
+int TaskScheduler::getNumThreads() const
+{
+	return mImpl->getNumThreads();
+}
+
+int TaskScheduler::getCurrentThreadIndex() const
+{
+	return mImpl->getCurrentWorkerIndex();
+}
+
+void TaskScheduler::spawn( std::function<void()> fn, TaskPriority priority )
+{
+	mImpl->push( new detail::Task{ std::move( fn ), nullptr }, priority );
+}
+
+void TaskScheduler::parallelFor( int64_t begin, int64_t end, const std::function<void( int64_t, int64_t )> &rangeFn, int64_t grainSize, int maxThreads )
+{
+	if( end <= begin )
+		return;
+
+	const int64_t length = end - begin;
+	// a worker calling parallelFor() is one of the threads taking part already
+	int64_t numThreads = getNumThreads() + ( getCurrentThreadIndex() < 0 ? 1 : 0 );
+	if( maxThreads > 0 )
+		numThreads = std::min<int64_t>( numThreads, maxThreads );
+	// a few chunks per thread lets threads that finish early help balance out uneven chunks
+	const int64_t numChunks = grainSize > 0 ? ( length + grainSize - 1 ) / grainSize : std::min( length, numThreads * 4 );
+	if( numThreads <= 1 || numChunks <= 1 ) {
+		rangeFn( begin, end );
+		return;
+	}
+
+	ChunkJob job( begin, end, numChunks, rangeFn );
+	ScopedGroupState state( mImpl.get() );
+	TaskGroup group( this, state.get() );
+	for( int64_t i = 1; i < std::min( numThreads, numChunks ); ++i )
+		group.run( [&job] { job.runChunks(); } );
+
+	std::exception_ptr exc;
+	try {
+		job.runChunks();
+	}
+	catch( ... ) {
+		exc = std::current_exception();
+	}
+	// the helpers refer to job, so they have to complete even when the calling thread's chunk threw
+	try {
+		group.wait();
+	}
+	catch( ... ) {
+		if( ! exc )
+			exc = std::current_exception();
+	}
+	if( exc )
+		std::rethrow_exception( exc );
+}
+
+TaskGroup::TaskGroup( TaskScheduler *scheduler )
+	: mScheduler( scheduler ), mState( std::make_shared<detail::TaskGroupState>( scheduler->mImpl.get() ) )
+{
+}
+
+TaskGroup::TaskGroup( TaskScheduler *scheduler, std::shared_ptr<detail::TaskGroupState> state )
+	: mScheduler( scheduler ), mState( std::move( state ) )
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+	try {
+		wait();
+	}
+	catch( ... ) {
+	}
+}
+
+void TaskGroup::run( std::function<void()> fn, TaskPriority priority )
+{
+	mState->mNumPending.fetch_add( 1, std::memory_order_relaxed );
+	mScheduler->mImpl->push( new detail::Task{ std::move( fn ), mState }, priority );
+}
+
+void TaskGroup::wait()
+{
+	detail::TaskSchedulerImpl *impl = mScheduler->mImpl.get();
+	const int index = impl->getCurrentWorkerIndex();
+	while( mState->mNumPending.load( std::memory_order_acquire ) > 0 ) {
+		if( detail::Task *task = impl->findTask( index ) ) {
+			impl->runTask( task );
+			continue;
+		}
+
+		// woken by the last task completing, or after a moment to look for newly queued tasks to help with
+		std::unique_lock<std::mutex> lock( mState->mMutex );
+		mState->mCompletedCond.wait_for( lock, std::chrono::milliseconds( 1 ), [this] { return mState->mNumPending.load( std::memory_order_acquire ) == 0; } );
+	}
+
+	std::exception_ptr exc;
+	{
+		std::lock_guard<std::mutex> lock( mState->mMutex );
+		std::swap( exc, mState->mException );
+	}
+	if( exc )
+		std::rethrow_exception( exc );
+}
+
+void TaskGroup::then( std::function<void()> fn, TaskPriority priority )
+{
+	{
+		std::lock_guard<std::mutex> lock( mState->mMutex );
+		if( mState->mNumPending.load( std::memory_order_acquire ) > 0 ) {
+			mState->mContinuations.emplace_back( std::move( fn ), priority );
+			return;
+		}
+	}
+
+	mScheduler->mImpl->push( new detail::Task{ std::move( fn ), nullptr }, priority );
+}
+
+bool TaskGroup::isDone() const
+{
+	return mState->mNumPending.load( std::memory_order_acquire ) == 0;
+}
+
+} // namespace cinder
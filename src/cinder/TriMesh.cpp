@@ -24,8 +24,10 @@
 */
 
 #include "cinder/TriMesh.h"
+#include "cinder/TriMeshCache.h"
 #include "cinder/Exception.h"
 #include "cinder/Log.h"
+#include "cinder/Thread.h"
 #if defined( CINDER_ANDROID )
 	#include "cinder/android/CinderAndroid.h"
 #endif 
@@ -504,8 +506,11 @@ void TriMesh::read( const DataSourceRef &dataSource )
 		clear();
 		readImplV2( in );
 	}
+	else if( versionNumber == TriMeshCache::VERSION ) {
+		*this = TriMesh( TriMeshCache( dataSource ) );
+	}
 	else {
-		throw Exception( "TriMesh::read() error: wrong version number. expected version = 1 or 2, version read: " + std::to_string( versionNumber ) );
+		throw Exception( "TriMesh::read() error: wrong version number. expected version = 1, 2 or 3, version read: " + std::to_string( versionNumber ) );
 	}
 }
 
@@ -700,83 +705,7 @@ bool TriMesh::recalculateNormals( bool smooth, bool weighted )
 	if( mIndices.empty() || mPositions.empty() || mPositionsDims != 3 )
 		return false;
 
-	size_t numPositions = mPositions.size() / 3;
-	mNormals.assign( numPositions, vec3() );
-
-	// for smooth renormalization, we first find all unique vertices and keep track of them
-	std::vector<uint32_t> uniquePositions;
-	if( smooth ) {
-		uniquePositions.assign( numPositions, 0 );
-
-		for( uint32_t i = 0; i < numPositions; ++i ) {
-			if( uniquePositions[i] == 0 ) {
-				uniquePositions[i] = i + 1;
-				const vec3 &v0 = *(const vec3*)(&mPositions[i * 3]);
-				for( size_t j = i + 1; j < numPositions; ++j ) {
-					const vec3 &v1 = *(const vec3*)(&mPositions[j * 3]);
-					if( length2( v1 - v0 ) < FLT_EPSILON )
-						uniquePositions[j] = uniquePositions[i];
-				}
-			}
-		}
-	}
-
-	// perform surface normalization
-	uint32_t index0, index1, index2;
-	size_t numTriangles = getNumTriangles();
-	for( size_t i = 0; i < numTriangles; ++i ) {
-		if( smooth ) {
-			index0 = uniquePositions[mIndices[i * 3 + 0]] - 1;
-			index1 = uniquePositions[mIndices[i * 3 + 1]] - 1;
-			index2 = uniquePositions[mIndices[i * 3 + 2]] - 1;
-		}
-		else {
-			index0 = mIndices[i*3+0];
-			index1 = mIndices[i*3+1];
-			index2 = mIndices[i*3+2];
-		}
-
-		const vec3 &v0 = *(const vec3*)(&mPositions[index0 * 3]);
-		const vec3 &v1 = *(const vec3*)(&mPositions[index1 * 3]);
-		const vec3 &v2 = *(const vec3*)(&mPositions[index2 * 3]);
-
-		vec3 e0 = v1 - v0;
-		vec3 e1 = v2 - v0;
-		vec3 e2 = v2 - v1;
-
-		if( length2( e0 ) < FLT_EPSILON )
-			continue;
-		if( length2( e1 ) < FLT_EPSILON )
-			continue;
-		if( length2( e2 ) < FLT_EPSILON )
-			continue;
-
-		vec3 normal = cross( e0, e1 );
-
-		// if not weighted, every normal has an equal contribution
-		if( ! weighted )
-			normal = normalize( normal );
-
-		mNormals[ index0 ] += normal;
-		mNormals[ index1 ] += normal;
-		mNormals[ index2 ] += normal;
-	}
-
-	// now normalize the summed normals
-	for( auto &normal : mNormals ) {
-		normal = normalize( normal );
-	}
-
-	// copy normals to corresponding non-unique vertices
-	if( smooth ) {
-		for( size_t i = 0; i < numPositions; ++i ) {
-			mNormals[i] = mNormals[uniquePositions[i]-1];
-		}
-	}
-
-	mNormalsDims = 3;
-
-	return true;
+	return recalculateNormals( Adjacency( *this, smooth ), weighted );
 }
 
 bool TriMesh::recalculateTangents()
@@ -788,16 +717,7 @@ bool TriMesh::recalculateTangents()
 	if( ! hasNormals() )
 		return false;
 
-	mTangents.clear();
-
-	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
-	const vec3 *normals = reinterpret_cast<const vec3*>( mNormals.data() );
-	const vec2 *texCoords = reinterpret_cast<const vec2*>( mTexCoords0.data() );
-	geom::calculateTangents( mIndices.size(), mIndices.data(), mPositions.size() / 3, positions, normals, texCoords, &mTangents, nullptr );
-
-	mTangentsDims = 3;
-
-	return true;
+	return recalculateTangents( Adjacency( *this ) );
 }
 
 bool TriMesh::recalculateBitangents()
@@ -1064,6 +984,1354 @@ void TriMesh::subdivide( int division, bool normalize )
 	}
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Welding and reordering
+namespace {
+
+const uint32_t INVALID_VERTEX = 0xFFFFFFFF;
+
+// Returns one more than the highest index, which is how many vertices \a indices can refer to
+size_t numIndexedVertices( const std::vector<uint32_t> &indices )
+{
+	return indices.empty() ? 0 : (size_t)*std::max_element( indices.begin(), indices.end() ) + 1;
+}
+
+template<typename T>
+void remapAttrib( std::vector<T> *data, size_t elementsPerVertex, const std::vector<uint32_t> &remap, size_t numVertices )
+{
+	if( elementsPerVertex == 0 || data->size() != remap.size() * elementsPerVertex )
+		return;
+
+	std::vector<T> result( numVertices * elementsPerVertex );
+	// in reverse, so that the lowest of the vertices sharing a target is written last
+	for( size_t v = remap.size(); v-- > 0; ) {
+		if( remap[v] != INVALID_VERTEX )
+			std::copy_n( data->data() + v * elementsPerVertex, elementsPerVertex, result.data() + (size_t)remap[v] * elementsPerVertex );
+	}
+	data->swap( result );
+}
+
+// A FIFO post-transform vertex cache, which remembers when each vertex entered it
+class VertexCacheSim {
+  public:
+	VertexCacheSim( size_t numVertices, uint32_t cacheSize )
+		: mEntered( numVertices, 0 ), mTime( cacheSize + 1 ), mCacheSize( cacheSize )
+	{}
+
+	bool		isCached( uint32_t v ) const { return mTime - mEntered[v] <= mCacheSize; }
+	// returns the number of cache misses, 0 or 1
+	uint32_t	access( uint32_t v )
+	{
+		if( isCached( v ) )
+			return 0;
+		mEntered[v] = mTime++;
+		return 1;
+	}
+	uint32_t	accessTriangle( const uint32_t *indices ) { return access( indices[0] ) + access( indices[1] ) + access( indices[2] ); }
+	void		flush() { mTime += mCacheSize + 1; }
+	// returns how many vertices entered the cache after v
+	uint32_t	getAge( uint32_t v ) const { return mTime - mEntered[v]; }
+
+  private:
+	std::vector<uint32_t>	mEntered;
+	uint32_t				mTime, mCacheSize;
+};
+
+uint64_t hashCell( const int64_t cell[3] )
+{
+	uint64_t h = (uint64_t)cell[0] * 0x9E3779B97F4A7C15ull ^ (uint64_t)cell[1] * 0xC2B2AE3D27D4EB4Full ^ (uint64_t)cell[2] * 0x165667B19E3779F9ull;
+	return h ^ ( h >> 31 );
+}
+
+// Numbers the vertices in order, giving each the number of the first earlier kept vertex that \a isMatch( vertex, kept ) accepts, or else
+// keeping it under a new number. Candidates are found through a spatial hash of the positions: with a \a tolerance, they lie in the cells
+// overlapping the box of that radius around the vertex, whereas a \a tolerance of 0 only finds identical positions. Returns the number of kept vertices.
+template<typename MatchFn>
+uint32_t clusterVertices( const float *positions, uint8_t positionsDims, size_t numVertices, float tolerance, const MatchFn &isMatch, std::vector<uint32_t> *remap )
+{
+	const uint8_t hashDims = std::min<uint8_t>( positionsDims, 3 );
+	// cells of four times the tolerance, so that the box around a vertex mostly falls within a single cell per dimension; the margin covers rounding
+	const double cellSize = tolerance * 4.0, margin = tolerance * 1.001;
+
+	auto toCell = [&]( double p ) -> int64_t {
+		const double c = std::floor( p / cellSize );
+		return std::isfinite( c ) ? (int64_t)glm::clamp( c, -1e18, 1e18 ) : 0;
+	};
+	// the cells overlapping the box around \a v, or its exact bits for a tolerance of 0
+	auto getCells = [&]( uint32_t v, int64_t lo[3], int64_t hi[3] ) {
+		for( uint8_t d = 0; d < 3; ++d ) {
+			lo[d] = hi[d] = 0;
+			if( d >= hashDims )
+				continue;
+			const float p = positions[(size_t)v * positionsDims + d];
+			if( tolerance > 0 ) {
+				lo[d] = toCell( (double)p - margin );
+				hi[d] = toCell( (double)p + margin );
+			}
+			else {
+				const float q = p + 0.0f; // -0 and 0 are equal
+				uint32_t bits;
+				memcpy( &bits, &q, sizeof( bits ) );
+				lo[d] = hi[d] = bits;
+			}
+		}
+	};
+
+	// buckets of cells, each heading a list of the vertices kept so far
+	size_t numBuckets = 1;
+	while( numBuckets < numVertices * 2 )
+		numBuckets *= 2;
+	std::vector<uint32_t> buckets( numBuckets, INVALID_VERTEX ), nextInBucket( numVertices );
+	auto getBucket = [&]( const int64_t cell[3] ) { return (size_t)( hashCell( cell ) & ( numBuckets - 1 ) ); };
+
+	remap->resize( numVertices );
+	uint32_t numKept = 0;
+	for( uint32_t v = 0; v < numVertices; ++v ) {
+		int64_t lo[3], hi[3];
+		getCells( v, lo, hi );
+
+		uint32_t match = INVALID_VERTEX;
+		for( int64_t x = lo[0]; x <= hi[0] && match == INVALID_VERTEX; ++x ) {
+			for( int64_t y = lo[1]; y <= hi[1] && match == INVALID_VERTEX; ++y ) {
+				for( int64_t z = lo[2]; z <= hi[2] && match == INVALID_VERTEX; ++z ) {
+					const int64_t neighbor[3] = { x, y, z };
+					for( uint32_t kept = buckets[getBucket( neighbor )]; kept != INVALID_VERTEX; kept = nextInBucket[kept] ) {
+						if( isMatch( v, kept ) ) {
+							match = kept;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		if( match != INVALID_VERTEX )
+			(*remap)[v] = (*remap)[match];
+		else {
+			// kept in the cell of its own position
+			int64_t cell[3];
+			for( uint8_t d = 0; d < 3; ++d )
+				cell[d] = ( tolerance > 0 && d < hashDims ) ? toCell( positions[(size_t)v * positionsDims + d] ) : lo[d];
+			(*remap)[v] = numKept++;
+			const size_t bucket = getBucket( cell );
+			nextInBucket[v] = buckets[bucket];
+			buckets[bucket] = v;
+		}
+	}
+
+	return numKept;
+}
+
+} // anonymous namespace
+
+size_t TriMesh::weldVertices( float tolerance )
+{
+	const size_t numVertices = getNumVertices();
+	if( numVertices == 0 || mIndices.empty() || numIndexedVertices( mIndices ) > numVertices )
+		return 0;
+
+	// every attribute, the positions included
+	std::vector<std::pair<const float*,uint8_t>> attribs;
+	auto addAttrib = [&]( const float *data, size_t numFloats, uint8_t dims ) {
+		if( dims > 0 && numFloats == numVertices * dims )
+			attribs.emplace_back( data, dims );
+	};
+	addAttrib( mPositions.data(), mPositions.size(), mPositionsDims );
+	addAttrib( mColors.data(), mColors.size(), mColorsDims );
+	addAttrib( mTexCoords0.data(), mTexCoords0.size(), mTexCoords0Dims );
+	addAttrib( mTexCoords1.data(), mTexCoords1.size(), mTexCoords1Dims );
+	addAttrib( mTexCoords2.data(), mTexCoords2.size(), mTexCoords2Dims );
+	addAttrib( mTexCoords3.data(), mTexCoords3.size(), mTexCoords3Dims );
+	addAttrib( (const float*)mNormals.data(), mNormals.size() * 3, 3 );
+	addAttrib( (const float*)mTangents.data(), mTangents.size() * 3, 3 );
+	addAttrib( (const float*)mBitangents.data(), mBitangents.size() * 3, 3 );
+	addAttrib( (const float*)mBoneIndices.data(), mBoneIndices.size() * 4, 4 );
+	addAttrib( (const float*)mBoneWeights.data(), mBoneWeights.size() * 4, 4 );
+
+	auto withinTolerance = [&]( uint32_t a, uint32_t b ) {
+		for( auto &attrib : attribs ) {
+			const float *dataA = attrib.first + (size_t)a * attrib.second, *dataB = attrib.first + (size_t)b * attrib.second;
+			for( uint8_t d = 0; d < attrib.second; ++d ) {
+				if( ! ( std::abs( dataA[d] - dataB[d] ) <= tolerance ) )
+					return false;
+			}
+		}
+		return true;
+	};
+
+	std::vector<uint32_t> remap;
+	const uint32_t numUnique = clusterVertices( mPositions.data(), mPositionsDims, numVertices, tolerance, withinTolerance, &remap );
+	if( numUnique == numVertices )
+		return 0;
+
+	for( auto &index : mIndices )
+		index = remap[index];
+	remapVertices( remap, numUnique );
+
+	return numVertices - numUnique;
+}
+
+void TriMesh::optimizeVertexCache( uint32_t cacheSize )
+{
+	// Tipsify, from Sander, Nehab and Barczak: "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007
+	const size_t numTriangles = getNumTriangles();
+	const size_t numVertices = numIndexedVertices( mIndices );
+	if( numTriangles < 2 )
+		return;
+
+	// the triangles around each vertex, and how many of those are still to be emitted
+	std::vector<uint32_t> liveTriangles( numVertices, 0 );
+	for( size_t i = 0; i < numTriangles * 3; ++i )
+		++liveTriangles[mIndices[i]];
+	std::vector<uint32_t> adjacencyOffsets( numVertices + 1, 0 );
+	for( size_t v = 0; v < numVertices; ++v )
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+	std::vector<uint32_t> adjacency( numTriangles * 3 );
+	{
+		std::vector<uint32_t> fill( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+		for( size_t i = 0; i < numTriangles * 3; ++i )
+			adjacency[fill[mIndices[i]]++] = uint32_t( i / 3 );
+	}
+
+	VertexCacheSim cache( numVertices, cacheSize );
+	std::vector<bool> emitted( numTriangles, false );
+	std::vector<uint32_t> deadEnds, candidates;
+	std::vector<uint32_t> result;
+	result.reserve( mIndices.size() );
+	size_t nextInputVertex = 0;
+
+	auto skipDeadEnd = [&]() -> uint32_t {
+		while( ! deadEnds.empty() ) {
+			const uint32_t v = deadEnds.back();
+			deadEnds.pop_back();
+			if( liveTriangles[v] > 0 )
+				return v;
+		}
+		for( ; nextInputVertex < numVertices; ++nextInputVertex ) {
+			if( liveTriangles[nextInputVertex] > 0 )
+				return uint32_t( nextInputVertex );
+		}
+		return INVALID_VERTEX;
+	};
+
+	uint32_t fanning = skipDeadEnd();
+	while( fanning != INVALID_VERTEX ) {
+		candidates.clear();
+		for( uint32_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; ++a ) {
+			const uint32_t t = adjacency[a];
+			if( emitted[t] )
+				continue;
+			emitted[t] = true;
+			for( int k = 0; k < 3; ++k ) {
+				const uint32_t v = mIndices[t * 3 + k];
+				result.push_back( v );
+				deadEnds.push_back( v );
+				candidates.push_back( v );
+				--liveTriangles[v];
+				cache.access( v );
+			}
+		}
+
+		// fan around the candidate that entered the cache the longest ago but stays in it while its remaining triangles are emitted
+		uint32_t next = INVALID_VERTEX;
+		int64_t bestPriority = -1;
+		for( uint32_t v : candidates ) {
+			if( liveTriangles[v] == 0 )
+				continue;
+			int64_t priority = 0;
+			if( (int64_t)cache.getAge( v ) + 2 * (int64_t)liveTriangles[v] <= (int64_t)cacheSize )
+				priority = cache.getAge( v );
+			if( priority > bestPriority ) {
+				bestPriority = priority;
+				next = v;
+			}
+		}
+
+		fanning = ( next != INVALID_VERTEX ) ? next : skipDeadEnd();
+	}
+
+	// any indices past the last whole triangle stay at the end
+	result.insert( result.end(), mIndices.begin() + numTriangles * 3, mIndices.end() );
+	mIndices.swap( result );
+}
+
+bool TriMesh::optimizeOverdraw( float threshold, uint32_t cacheSize )
+{
+	const size_t numTriangles = getNumTriangles();
+	if( mPositionsDims < 3 || numIndexedVertices( mIndices ) > getNumVertices() )
+		return false;
+	if( numTriangles < 2 )
+		return true;
+
+	// hard cluster boundaries are triangles that miss the cache with all of their vertices, where Tipsify reached a dead end
+	std::vector<uint8_t> misses( numTriangles );
+	std::vector<uint32_t> hardStarts;
+	{
+		VertexCacheSim cache( getNumVertices(), cacheSize );
+		for( size_t t = 0; t < numTriangles; ++t ) {
+			misses[t] = (uint8_t)cache.accessTriangle( &mIndices[t * 3] );
+			if( t == 0 || misses[t] == 3 )
+				hardStarts.push_back( uint32_t( t ) );
+		}
+		hardStarts.push_back( uint32_t( numTriangles ) );
+	}
+
+	// soft boundaries split runs as soon as their own miss ratio, starting from an empty cache, is within threshold of the run's
+	std::vector<uint32_t> clusterStarts;
+	{
+		VertexCacheSim cache( getNumVertices(), cacheSize );
+		for( size_t h = 0; h + 1 < hardStarts.size(); ++h ) {
+			const uint32_t begin = hardStarts[h], end = hardStarts[h + 1];
+			uint32_t runMisses = 0;
+			for( uint32_t t = begin; t < end; ++t )
+				runMisses += misses[t];
+			const float targetRatio = runMisses / float( end - begin ) * threshold;
+
+			cache.flush();
+			clusterStarts.push_back( begin );
+			uint32_t clusterStart = begin, clusterMisses = 0;
+			for( uint32_t t = begin; t + 1 < end; ++t ) {
+				clusterMisses += cache.accessTriangle( &mIndices[t * 3] );
+				if( clusterMisses <= targetRatio * ( t + 1 - clusterStart ) ) {
+					clusterStarts.push_back( t + 1 );
+					clusterStart = t + 1;
+					clusterMisses = 0;
+					cache.flush();
+				}
+			}
+		}
+		clusterStarts.push_back( uint32_t( numTriangles ) );
+	}
+
+	// draw the clusters facing away from the center of the mesh first, as they are the least likely to be occluded
+	auto getPosition = [&]( uint32_t v ) { return vec3( mPositions[(size_t)v * mPositionsDims], mPositions[(size_t)v * mPositionsDims + 1], mPositions[(size_t)v * mPositionsDims + 2] ); };
+	const size_t numClusters = clusterStarts.size() - 1;
+	std::vector<vec3> clusterNormals( numClusters, vec3( 0 ) ), clusterCentroids( numClusters, vec3( 0 ) );
+	std::vector<float> clusterAreas( numClusters, 0 );
+	vec3 meshCentroid( 0 );
+	float meshArea = 0;
+	for( size_t c = 0; c < numClusters; ++c ) {
+		for( uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t ) {
+			const vec3 a = getPosition( mIndices[t * 3] ), b = getPosition( mIndices[t * 3 + 1] ), d = getPosition( mIndices[t * 3 + 2] );
+			const vec3 normal = cross( b - a, d - a );
+			const float area = length( normal );
+			clusterNormals[c] += normal;
+			clusterCentroids[c] += ( a + b + d ) * ( area / 3 );
+			clusterAreas[c] += area;
+		}
+		meshCentroid += clusterCentroids[c];
+		meshArea += clusterAreas[c];
+	}
+	if( meshArea > 0 )
+		meshCentroid /= meshArea;
+
+	std::vector<float> sortKeys( numClusters, 0 );
+	for( size_t c = 0; c < numClusters; ++c ) {
+		const float normalLength = length( clusterNormals[c] );
+		if( clusterAreas[c] > 0 && normalLength > 0 )
+			sortKeys[c] = dot( clusterCentroids[c] / clusterAreas[c] - meshCentroid, clusterNormals[c] / normalLength );
+	}
+
+	std::vector<uint32_t> order( numClusters );
+	for( size_t c = 0; c < numClusters; ++c )
+		order[c] = uint32_t( c );
+	std::stable_sort( order.begin(), order.end(), [&]( uint32_t a, uint32_t b ) { return sortKeys[a] > sortKeys[b]; } );
+
+	std::vector<uint32_t> result;
+	result.reserve( mIndices.size() );
+	for( uint32_t c : order )
+		result.insert( result.end(), mIndices.begin() + clusterStarts[c] * 3, mIndices.begin() + clusterStarts[c + 1] * 3 );
+	result.insert( result.end(), mIndices.begin() + numTriangles * 3, mIndices.end() );
+	mIndices.swap( result );
+
+	return true;
+}
+
+size_t TriMesh::optimizeVertexFetch()
+{
+	const size_t numVertices = getNumVertices();
+	if( mIndices.empty() || numIndexedVertices( mIndices ) > numVertices )
+		return 0;
+
+	std::vector<uint32_t> remap( numVertices, INVALID_VERTEX );
+	uint32_t numReferenced = 0;
+	for( auto &index : mIndices ) {
+		if( remap[index] == INVALID_VERTEX )
+			remap[index] = numReferenced++;
+		index = remap[index];
+	}
+	remapVertices( remap, numReferenced );
+
+	return numVertices - numReferenced;
+}
+
+TriMesh::VertexCacheStats TriMesh::analyzeVertexCache( uint32_t cacheSize ) const
+{
+	VertexCacheStats result = { 0, 0, 0 };
+	const size_t numTriangles = getNumTriangles();
+	if( numTriangles == 0 )
+		return result;
+
+	const size_t numVertices = numIndexedVertices( mIndices );
+	VertexCacheSim cache( numVertices, cacheSize );
+	std::vector<bool> referenced( numVertices, false );
+	size_t numReferenced = 0;
+	for( size_t i = 0; i < numTriangles * 3; ++i ) {
+		result.numTransformed += cache.access( mIndices[i] );
+		if( ! referenced[mIndices[i]] ) {
+			referenced[mIndices[i]] = true;
+			++numReferenced;
+		}
+	}
+
+	result.acmr = result.numTransformed / float( numTriangles );
+	result.atvr = result.numTransformed / float( numReferenced );
+	return result;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Normals and tangents
+namespace {
+
+// the triangles or vertices handed to a thread at a time by the parallel loops
+const int64_t PARALLEL_GRAIN_SIZE = 4096;
+const size_t FACE_BATCH_SIZE = 64;
+
+// Computes the normals of triangles [begin, end) into the SoA arrays \a faceNormals a batch at a time: the edges are gathered first,
+// so that the cross products run over contiguous floats. Degenerate triangles get a zero normal, as do those with two corners in
+// the same group when \a groupOfVertex is given.
+void calcFaceNormals( const vec3 *positions, const uint32_t *indices, const uint32_t *groupOfVertex, bool weighted, size_t begin, size_t end, float *const faceNormals[3] )
+{
+	float e0[3][FACE_BATCH_SIZE], e1[3][FACE_BATCH_SIZE], e2Length2[FACE_BATCH_SIZE];
+	bool distinctGroups[FACE_BATCH_SIZE];
+	for( size_t batch = begin; batch < end; batch += FACE_BATCH_SIZE ) {
+		const size_t n = std::min( FACE_BATCH_SIZE, end - batch );
+		for( size_t i = 0; i < n; ++i ) {
+			const uint32_t *triangle = indices + ( batch + i ) * 3;
+			const vec3 &v0 = positions[triangle[0]], &v1 = positions[triangle[1]], &v2 = positions[triangle[2]];
+			for( int d = 0; d < 3; ++d ) {
+				e0[d][i] = v1[d] - v0[d];
+				e1[d][i] = v2[d] - v0[d];
+			}
+			e2Length2[i] = length2( v2 - v1 );
+			distinctGroups[i] = ! groupOfVertex || ( groupOfVertex[triangle[0]] != groupOfVertex[triangle[1]]
+				&& groupOfVertex[triangle[0]] != groupOfVertex[triangle[2]] && groupOfVertex[triangle[1]] != groupOfVertex[triangle[2]] );
+		}
+
+		for( size_t i = 0; i < n; ++i ) {
+			const float e0Length2 = e0[0][i] * e0[0][i] + e0[1][i] * e0[1][i] + e0[2][i] * e0[2][i];
+			const float e1Length2 = e1[0][i] * e1[0][i] + e1[1][i] * e1[1][i] + e1[2][i] * e1[2][i];
+			float x = e0[1][i] * e1[2][i] - e0[2][i] * e1[1][i];
+			float y = e0[2][i] * e1[0][i] - e0[0][i] * e1[2][i];
+			float z = e0[0][i] * e1[1][i] - e0[1][i] * e1[0][i];
+			// if not weighted, every normal has an equal contribution
+			if( ! weighted ) {
+				const float scale = 1 / std::sqrt( x * x + y * y + z * z );
+				x *= scale;
+				y *= scale;
+				z *= scale;
+			}
+
+			const bool valid = distinctGroups[i] && e0Length2 >= FLT_EPSILON && e1Length2 >= FLT_EPSILON && e2Length2[i] >= FLT_EPSILON;
+			faceNormals[0][batch + i] = valid ? x : 0;
+			faceNormals[1][batch + i] = valid ? y : 0;
+			faceNormals[2][batch + i] = valid ? z : 0;
+		}
+	}
+}
+
+// Computes the unnormalized tangents of triangles [begin, end) into the SoA arrays \a faceTangents, as geom::calculateTangents() does
+void calcFaceTangents( const vec3 *positions, const vec2 *texCoords, const uint32_t *indices, size_t begin, size_t end, float *const faceTangents[3] )
+{
+	for( size_t t = begin; t < end; ++t ) {
+		const uint32_t *triangle = indices + t * 3;
+		const vec3 p1 = positions[triangle[1]] - positions[triangle[0]];
+		const vec3 p2 = positions[triangle[2]] - positions[triangle[0]];
+		const vec2 w1 = texCoords[triangle[1]] - texCoords[triangle[0]];
+		const vec2 w2 = texCoords[triangle[2]] - texCoords[triangle[0]];
+
+		float r = w1.x * w2.y - w2.x * w1.y;
+		if( r != 0.0f )
+			r = 1.0f / r;
+		for( int d = 0; d < 3; ++d )
+			faceTangents[d][t] = ( w2.y * p1[d] - w1.y * p2[d] ) * r;
+	}
+}
+
+} // anonymous namespace
+
+TriMesh::Adjacency::Adjacency( const TriMesh &mesh, bool smooth )
+	: mNumVertices( mesh.getNumVertices() ), mNumIndices( mesh.getNumIndices() ), mValid( numIndexedVertices( mesh.mIndices ) <= mNumVertices )
+{
+	if( ! mValid )
+		return;
+
+	// a counting sort of the corners by vertex keeps each vertex's triangles in increasing order
+	const size_t numCorners = mesh.getNumTriangles() * 3;
+	mOffsets.assign( mNumVertices + 1, 0 );
+	for( size_t i = 0; i < numCorners; ++i )
+		++mOffsets[mesh.mIndices[i] + 1];
+	for( size_t v = 0; v < mNumVertices; ++v )
+		mOffsets[v + 1] += mOffsets[v];
+	mTriangles.resize( numCorners );
+	{
+		std::vector<uint32_t> fill( mOffsets.begin(), mOffsets.end() - 1 );
+		for( size_t i = 0; i < numCorners; ++i )
+			mTriangles[fill[mesh.mIndices[i]]++] = uint32_t( i / 3 );
+	}
+
+	if( smooth && mesh.mPositionsDims == 3 ) {
+		// vertices within FLT_EPSILON squared distance of a group's first vertex join the group
+		const vec3 *positions = reinterpret_cast<const vec3*>( mesh.mPositions.data() );
+		auto isSamePosition = [positions]( uint32_t v, uint32_t kept ) { return length2( positions[v] - positions[kept] ) < FLT_EPSILON; };
+		const uint32_t numGroups = clusterVertices( mesh.mPositions.data(), 3, mNumVertices, std::sqrt( FLT_EPSILON ), isSamePosition, &mGroupOfVertex );
+
+		mGroupOffsets.assign( numGroups + 1, 0 );
+		for( uint32_t group : mGroupOfVertex )
+			++mGroupOffsets[group + 1];
+		for( uint32_t g = 0; g < numGroups; ++g )
+			mGroupOffsets[g + 1] += mGroupOffsets[g];
+		mGroupVertices.resize( mNumVertices );
+		std::vector<uint32_t> fill( mGroupOffsets.begin(), mGroupOffsets.end() - 1 );
+		for( uint32_t v = 0; v < mNumVertices; ++v )
+			mGroupVertices[fill[mGroupOfVertex[v]]++] = v;
+	}
+}
+
+bool TriMesh::recalculateNormals( const Adjacency &adjacency, bool weighted, int numThreads )
+{
+	// requires valid indices and 3D vertices
+	if( mIndices.empty() || mPositions.empty() || mPositionsDims != 3 || ! adjacency.matches( *this ) )
+		return false;
+
+	const size_t numVertices = getNumVertices();
+	const size_t numTriangles = getNumTriangles();
+	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
+	const bool smooth = adjacency.isSmooth();
+
+	std::unique_ptr<float[]> faceData( new float[numTriangles * 3] );
+	float *const faceNormals[3] = { faceData.get(), faceData.get() + numTriangles, faceData.get() + numTriangles * 2 };
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numTriangles, [&]( size_t begin, size_t end ) {
+		calcFaceNormals( positions, mIndices.data(), smooth ? adjacency.mGroupOfVertex.data() : nullptr, weighted, begin, end, faceNormals );
+	}, PARALLEL_GRAIN_SIZE, numThreads );
+
+	// each vertex, or group of vertices, sums its triangles in increasing order, which makes the result independent of the number of threads
+	mNormals.resize( numVertices );
+	auto sumFaceNormals = [&]( uint32_t v, vec3 *sum ) {
+		for( uint32_t a = adjacency.mOffsets[v]; a < adjacency.mOffsets[v + 1]; ++a ) {
+			const uint32_t t = adjacency.mTriangles[a];
+			*sum += vec3( faceNormals[0][t], faceNormals[1][t], faceNormals[2][t] );
+		}
+	};
+	if( smooth ) {
+		TaskScheduler::global()->parallelFor( 0, (int64_t)( adjacency.mGroupOffsets.size() - 1 ), [&]( size_t begin, size_t end ) {
+			for( size_t g = begin; g < end; ++g ) {
+				vec3 sum( 0 );
+				for( uint32_t m = adjacency.mGroupOffsets[g]; m < adjacency.mGroupOffsets[g + 1]; ++m )
+					sumFaceNormals( adjacency.mGroupVertices[m], &sum );
+				const vec3 normal = normalize( sum );
+				for( uint32_t m = adjacency.mGroupOffsets[g]; m < adjacency.mGroupOffsets[g + 1]; ++m )
+					mNormals[adjacency.mGroupVertices[m]] = normal;
+			}
+		}, PARALLEL_GRAIN_SIZE, numThreads );
+	}
+	else {
+		TaskScheduler::global()->parallelFor( 0, (int64_t)numVertices, [&]( size_t begin, size_t end ) {
+			for( size_t v = begin; v < end; ++v ) {
+				vec3 sum( 0 );
+				sumFaceNormals( uint32_t( v ), &sum );
+				mNormals[v] = normalize( sum );
+			}
+		}, PARALLEL_GRAIN_SIZE, numThreads );
+	}
+
+	mNormalsDims = 3;
+
+	return true;
+}
+
+bool TriMesh::recalculateTangents( const Adjacency &adjacency, int numThreads )
+{
+	// requires valid 2D texture coords, 3D positions and 3D normals
+	const size_t numVertices = getNumVertices();
+	if( mTexCoords0Dims != 2 || mTexCoords0.size() != numVertices * 2 || mPositionsDims != 3 || mNormals.size() != numVertices || ! adjacency.matches( *this ) )
+		return false;
+
+	const size_t numTriangles = getNumTriangles();
+	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
+	const vec2 *texCoords = reinterpret_cast<const vec2*>( mTexCoords0.data() );
+
+	std::unique_ptr<float[]> faceData( new float[numTriangles * 3] );
+	float *const faceTangents[3] = { faceData.get(), faceData.get() + numTriangles, faceData.get() + numTriangles * 2 };
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numTriangles, [&]( size_t begin, size_t end ) {
+		calcFaceTangents( positions, texCoords, mIndices.data(), begin, end, faceTangents );
+	}, PARALLEL_GRAIN_SIZE, numThreads );
+
+	mTangents.resize( numVertices );
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numVertices, [&]( size_t begin, size_t end ) {
+		for( size_t v = begin; v < end; ++v ) {
+			vec3 tangent( 0 );
+			for( uint32_t a = adjacency.mOffsets[v]; a < adjacency.mOffsets[v + 1]; ++a ) {
+				const uint32_t t = adjacency.mTriangles[a];
+				tangent += vec3( faceTangents[0][t], faceTangents[1][t], faceTangents[2][t] );
+			}
+
+			// orthogonalize against the normal
+			const vec3 &normal = mNormals[v];
+			tangent = tangent - normal * dot( normal, tangent );
+			const float len = length2( tangent );
+			if( len > 0.0f )
+				tangent /= sqrt( len );
+			mTangents[v] = tangent;
+		}
+	}, PARALLEL_GRAIN_SIZE, numThreads );
+
+	mTangentsDims = 3;
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Simplification
+namespace {
+
+// A quadric of planes, weighted by the area of the triangles or the length of the border edges they came from
+struct Quadric {
+	float	a00, a11, a22, a01, a02, a12, b0, b1, b2, c;
+	// the area of the triangles, which normalizes the error into a mean squared distance
+	float	area;
+
+	void addPlane( const vec3 &n, float d, float weight )
+	{
+		a00 += weight * n.x * n.x; a11 += weight * n.y * n.y; a22 += weight * n.z * n.z;
+		a01 += weight * n.x * n.y; a02 += weight * n.x * n.z; a12 += weight * n.y * n.z;
+		b0 += weight * n.x * d; b1 += weight * n.y * d; b2 += weight * n.z * d;
+		c += weight * d * d;
+	}
+
+	void add( const Quadric &q )
+	{
+		a00 += q.a00; a11 += q.a11; a22 += q.a22; a01 += q.a01; a02 += q.a02; a12 += q.a12;
+		b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c; area += q.area;
+	}
+
+	// the mean squared distance of \a p to the planes
+	float error( const vec3 &p ) const
+	{
+		const float sum = p.x * ( a00 * p.x + 2 * ( a01 * p.y + a02 * p.z + b0 ) ) + p.y * ( a11 * p.y + 2 * ( a12 * p.z + b1 ) ) + p.z * ( a22 * p.z + 2 * b2 ) + c;
+		return std::max( sum, 0.0f ) / std::max( area, 1e-30f );
+	}
+};
+
+struct SimplifyAttrib {
+	const float		*data;
+	uint8_t			dims;
+	float			weight;
+};
+
+// The layout of a quadric of attribute planes, after Hoppe: "New Quadric Metric for Simplifying Meshes with Appearance Attributes", 1999. Each triangle
+// fits every attribute component j with a linear function g_j . p + d_j within its plane, and the error at position p with attribute values s_j sums
+// area * ( g_j . p + d_j - s_j )^2 over the components and triangles. The terms without s_j are summed over the components.
+enum AttribQuadricLayout {
+	AQ_A00, AQ_A11, AQ_A22, AQ_A01, AQ_A02, AQ_A12,	// sum of area * g_j g_j^T
+	AQ_B0, AQ_B1, AQ_B2,							// sum of area * g_j d_j
+	AQ_C,											// sum of area * d_j^2
+	AQ_AREA,
+	AQ_COMPONENTS									// then, for each component, the sum of area * g_j and of area * d_j
+};
+
+// Quadric edge collapse simplification, after Garland and Heckbert: "Surface Simplification Using Quadric Error Metrics", 1997. Vertices that
+// share a position are collapsed together, so that attribute seams stay closed; each collapses onto a vertex of the target position that shares
+// one of its triangles, and the collapse is refused when there is none, which keeps seams collapsing along themselves. Collapses wait in a heap,
+// where entries left stale by later collapses are skipped as they come up. Positions are scaled to a unit bounding box.
+class Simplifier {
+  public:
+	Simplifier( const std::vector<uint32_t> &indices, const float *positions, size_t numVertices, const std::vector<SimplifyAttrib> &attribs, const TriMesh::SimplifyOptions &options );
+
+	//! Collapses edges until at most \a targetTriangles remain or none is within the target error
+	void		simplify( size_t targetTriangles );
+
+	size_t		getNumTriangles() const { return mNumLiveTriangles; }
+	//! Returns the largest error of a collapse so far, relative to the bounds
+	float		getError() const { return std::sqrt( mMaxCollapseCost ); }
+	//! Returns the indices of the remaining triangles in their original order, with their vertices compacted in the order of \a remap
+	void		getResult( std::vector<uint32_t> *indices, std::vector<uint32_t> *remap, size_t *numVertices ) const;
+
+  private:
+	enum Kind : uint8_t { MANIFOLD, BORDER, LOCKED, COLLAPSED };
+
+	struct Collapse {
+		float		cost;
+		uint32_t	from, to, version;
+
+	};
+
+	void		addTriangleQuadrics();
+	// finds the borders, seams and non-manifold edges
+	void		classifyEdges( bool lockBorders );
+	void		addAttribQuadrics();
+	float		getComponent( uint32_t v, size_t j ) const { return mComponents[(size_t)v * mNumComponents + j]; }
+	//! Returns the attribute error of moving \a wedge to \a p, taking the attributes of \a target
+	float		attribError( uint32_t wedge, const vec3 &p, uint32_t target ) const;
+	float		collapseCost( uint32_t from, uint32_t to ) const;
+	// fills mCandidates with the collapses of \a from onto its neighbors that are within the target error, cheapest first
+	void		gatherCandidates( uint32_t from );
+	// queues the cheapest collapse of \a from, superseding any queued before
+	void		queueCollapse( uint32_t from );
+	void		pushCollapse( const Collapse &collapse );
+	Collapse	popCollapse();
+	void		gatherCorners( uint32_t p, std::vector<uint32_t> *corners );
+	void		gatherNeighbors( const std::vector<uint32_t> &corners, uint32_t p, std::vector<uint32_t> *neighbors ) const;
+	uint32_t	findWedge( uint32_t wedge ) const;
+	bool		tryCollapse( uint32_t from, uint32_t to );
+
+	std::vector<uint32_t>			mIndices;
+	std::vector<uint8_t>			mTriangleLive;
+	size_t							mNumLiveTriangles;
+	size_t							mNumVertices;
+
+	// the weighted attribute components of each vertex, and a quadric of each vertex's attribute planes
+	size_t					mNumComponents, mAttribStride;
+	std::vector<float>		mComponents;
+	std::vector<float>		mAttribQuadrics;
+
+	// the position of each vertex, the next vertex around the ring of those that share it, and one vertex of each position
+	std::vector<uint32_t>	mPositionOf, mNextWedge, mFirstWedge;
+	// the position of each corner, which spares a lookup through its vertex
+	std::vector<uint32_t>	mCornerPositions;
+	std::vector<vec3>		mPoints;
+	std::vector<Quadric>	mQuadrics;
+	std::vector<uint8_t>	mKinds;
+	std::vector<uint32_t>	mVersions;
+	// the corners of each position's triangles, as linked lists which drop the corners of removed triangles as they are walked
+	std::vector<uint32_t>	mCornerHeads, mCornerTails, mNextCorners;
+
+	// a 4-ary min-heap, whose children share a cache line
+	std::vector<Collapse>	mHeap;
+	float					mMaxCost, mMaxCollapseCost;
+
+	std::vector<uint32_t>	mCorners, mOtherCorners, mNeighbors, mOtherNeighbors;
+	std::vector<std::pair<float,uint32_t>>	mCandidates;
+	std::vector<std::pair<uint32_t,uint32_t>>	mWedgeMap;
+};
+
+// multiplies the planes along borders and seams, so that they keep their shape
+const float BOUNDARY_WEIGHT = 10.0f;
+
+Simplifier::Simplifier( const std::vector<uint32_t> &indices, const float *positions, size_t numVertices, const std::vector<SimplifyAttrib> &attribs, const TriMesh::SimplifyOptions &options )
+	: mIndices( indices ), mNumLiveTriangles( 0 ), mNumVertices( numVertices ), mMaxCollapseCost( 0 )
+{
+	// interleaved, so that the attributes of a vertex share a cache line
+	mNumComponents = 0;
+	for( const SimplifyAttrib &attrib : attribs )
+		mNumComponents += attrib.dims;
+	mComponents.resize( numVertices * mNumComponents );
+	for( size_t v = 0, j = 0; v < numVertices; ++v ) {
+		for( const SimplifyAttrib &attrib : attribs ) {
+			for( uint8_t d = 0; d < attrib.dims; ++d )
+				mComponents[j++] = attrib.data[v * attrib.dims + d] * attrib.weight;
+		}
+	}
+	mAttribStride = mNumComponents == 0 ? 0 : AQ_COMPONENTS + mNumComponents * 4;
+
+	mIndices.resize( indices.size() / 3 * 3 );
+	const float targetError = options.getTargetError();
+	mMaxCost = targetError < std::sqrt( std::numeric_limits<float>::max() ) ? targetError * targetError : std::numeric_limits<float>::max();
+
+	// vertices at the same position collapse together
+	auto isSamePosition = [positions]( uint32_t v, uint32_t kept ) {
+		return positions[v * 3] == positions[kept * 3] && positions[v * 3 + 1] == positions[kept * 3 + 1] && positions[v * 3 + 2] == positions[kept * 3 + 2];
+	};
+	const uint32_t numPositions = clusterVertices( positions, 3, numVertices, 0, isSamePosition, &mPositionOf );
+
+	vec3 boundsMin( std::numeric_limits<float>::max() ), boundsMax( -std::numeric_limits<float>::max() );
+	for( size_t v = 0; v < numVertices; ++v ) {
+		boundsMin = glm::min( boundsMin, vec3( positions[v * 3], positions[v * 3 + 1], positions[v * 3 + 2] ) );
+		boundsMax = glm::max( boundsMax, vec3( positions[v * 3], positions[v * 3 + 1], positions[v * 3 + 2] ) );
+	}
+	const float extent = std::max( std::max( boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y ), boundsMax.z - boundsMin.z );
+	const float scale = extent > 0 ? 1 / extent : 1;
+
+	mPoints.resize( numPositions );
+	mFirstWedge.assign( numPositions, INVALID_VERTEX );
+	mNextWedge.resize( numVertices );
+	std::vector<uint32_t> lastWedge( numPositions );
+	for( uint32_t v = 0; v < numVertices; ++v ) {
+		const uint32_t p = mPositionOf[v];
+		if( mFirstWedge[p] == INVALID_VERTEX ) {
+			mFirstWedge[p] = v;
+			mPoints[p] = ( vec3( positions[v * 3], positions[v * 3 + 1], positions[v * 3 + 2] ) - boundsMin ) * scale;
+		}
+		else
+			mNextWedge[lastWedge[p]] = v;
+		lastWedge[p] = v;
+		mNextWedge[v] = mFirstWedge[p];
+	}
+
+	// triangles with two corners at the same position are dropped up front
+	const size_t numTriangles = mIndices.size() / 3;
+	mCornerPositions.resize( mIndices.size() );
+	for( size_t c = 0; c < mIndices.size(); ++c )
+		mCornerPositions[c] = mPositionOf[mIndices[c]];
+	mTriangleLive.resize( numTriangles );
+	mCornerHeads.assign( numPositions, INVALID_VERTEX );
+	mCornerTails.assign( numPositions, INVALID_VERTEX );
+	mNextCorners.assign( mIndices.size(), INVALID_VERTEX );
+	for( size_t t = 0; t < numTriangles; ++t ) {
+		const uint32_t p0 = mCornerPositions[t * 3], p1 = mCornerPositions[t * 3 + 1], p2 = mCornerPositions[t * 3 + 2];
+		mTriangleLive[t] = p0 != p1 && p0 != p2 && p1 != p2;
+		if( ! mTriangleLive[t] )
+			continue;
+
+		++mNumLiveTriangles;
+		for( uint32_t c = uint32_t( t * 3 ); c < t * 3 + 3; ++c ) {
+			const uint32_t p = mCornerPositions[c];
+			if( mCornerTails[p] == INVALID_VERTEX )
+				mCornerHeads[p] = c;
+			else
+				mNextCorners[mCornerTails[p]] = c;
+			mCornerTails[p] = c;
+		}
+	}
+
+	mQuadrics.assign( numPositions, Quadric{} );
+	mKinds.assign( numPositions, MANIFOLD );
+	mVersions.assign( numPositions, 0 );
+	addTriangleQuadrics();
+	addAttribQuadrics();
+	classifyEdges( options.getLockBorders() );
+	for( uint32_t p = 0; p < numPositions; ++p )
+		queueCollapse( p );
+}
+
+void Simplifier::addTriangleQuadrics()
+{
+	for( size_t t = 0; t < mTriangleLive.size(); ++t ) {
+		if( ! mTriangleLive[t] )
+			continue;
+
+		const uint32_t p[3] = { mCornerPositions[t * 3], mCornerPositions[t * 3 + 1], mCornerPositions[t * 3 + 2] };
+		vec3 normal = cross( mPoints[p[1]] - mPoints[p[0]], mPoints[p[2]] - mPoints[p[0]] );
+		const float length = glm::length( normal );
+		if( length > 0 )
+			normal /= length;
+		const float area = length / 2;
+		const float d = -dot( normal, mPoints[p[0]] );
+		for( int i = 0; i < 3; ++i ) {
+			mQuadrics[p[i]].addPlane( normal, d, area );
+			mQuadrics[p[i]].area += area;
+		}
+	}
+}
+
+void Simplifier::classifyEdges( bool lockBorders )
+{
+	// an edge from one position to another, as seen by one triangle
+	struct Edge {
+		uint32_t	to, wedges[2], triangle;
+
+		bool operator<( const Edge &rhs ) const { return to < rhs.to; }
+	};
+
+	// borders and seams get planes through the edge, perpendicular to the triangle
+	auto addBoundaryPlanes = [&]( const Edge &edge ) {
+		const uint32_t pa = mPositionOf[edge.wedges[0]], pb = mPositionOf[edge.wedges[1]];
+		const uint32_t *triangle = &mIndices[edge.triangle * 3];
+		const vec3 normal = cross( mPoints[mPositionOf[triangle[1]]] - mPoints[mPositionOf[triangle[0]]], mPoints[mPositionOf[triangle[2]]] - mPoints[mPositionOf[triangle[0]]] );
+		const vec3 along = mPoints[pb] - mPoints[pa];
+		vec3 planeNormal = cross( along, normal );
+		const float length = glm::length( planeNormal );
+		if( length == 0 )
+			return;
+		planeNormal /= length;
+		const float d = -dot( planeNormal, mPoints[pa] );
+		const float weight = length2( along ) * BOUNDARY_WEIGHT;
+		mQuadrics[pa].addPlane( planeNormal, d, weight );
+		mQuadrics[pb].addPlane( planeNormal, d, weight );
+	};
+
+	std::vector<Edge> edges;
+	for( uint32_t pa = 0; pa < mPoints.size(); ++pa ) {
+		// the edges to higher positions, so that each edge is seen from one end, sorted so that the triangles along each are adjacent
+		edges.clear();
+		for( uint32_t c = mCornerHeads[pa]; c != INVALID_VERTEX; c = mNextCorners[c] ) {
+			const uint32_t t = c / 3, i = c - t * 3;
+			for( uint32_t other : { t * 3 + ( i + 1 ) % 3, t * 3 + ( i + 2 ) % 3 } ) {
+				const uint32_t pb = mCornerPositions[other];
+				if( pb > pa )
+					edges.push_back( { pb, { mIndices[c], mIndices[other] }, t } );
+			}
+		}
+		std::sort( edges.begin(), edges.end() );
+
+		for( size_t begin = 0, end; begin < edges.size(); begin = end ) {
+			end = begin + 1;
+			while( end < edges.size() && edges[end].to == edges[begin].to )
+				++end;
+
+			const uint32_t pb = edges[begin].to;
+			if( end - begin == 1 ) {
+				addBoundaryPlanes( edges[begin] );
+				for( uint32_t p : { pa, pb } ) {
+					if( mKinds[p] == MANIFOLD )
+						mKinds[p] = lockBorders ? LOCKED : BORDER;
+				}
+			}
+			else if( end - begin == 2 ) {
+				if( edges[begin].wedges[0] != edges[begin + 1].wedges[0] || edges[begin].wedges[1] != edges[begin + 1].wedges[1] ) {
+					addBoundaryPlanes( edges[begin] );
+					addBoundaryPlanes( edges[begin + 1] );
+				}
+			}
+			else {
+				// edges shared by more than two triangles stay put
+				mKinds[pa] = mKinds[pb] = LOCKED;
+			}
+		}
+	}
+}
+
+void Simplifier::addAttribQuadrics()
+{
+	if( mNumComponents == 0 )
+		return;
+
+	mAttribQuadrics.assign( mNumVertices * mAttribStride, 0 );
+	std::vector<float> components( mNumComponents * 4 );
+	for( size_t t = 0; t < mTriangleLive.size(); ++t ) {
+		if( ! mTriangleLive[t] )
+			continue;
+
+		const uint32_t *triangle = &mIndices[t * 3];
+		const vec3 &p0 = mPoints[mPositionOf[triangle[0]]];
+		const vec3 e1 = mPoints[mPositionOf[triangle[1]]] - p0, e2 = mPoints[mPositionOf[triangle[2]]] - p0;
+		// the gradients lie in the plane of the triangle, as g = alpha * e1 + beta * e2
+		const float e11 = dot( e1, e1 ), e12 = dot( e1, e2 ), e22 = dot( e2, e2 );
+		const float det = e11 * e22 - e12 * e12;
+		if( ! ( det > 0 ) )
+			continue;
+		const float area = std::sqrt( det ) / 2;
+
+		float quadric[AQ_COMPONENTS] = {};
+		for( size_t j = 0; j < mNumComponents; ++j ) {
+			const float a0 = getComponent( triangle[0], j );
+			const float delta1 = getComponent( triangle[1], j ) - a0, delta2 = getComponent( triangle[2], j ) - a0;
+			const float alpha = ( delta1 * e22 - delta2 * e12 ) / det, beta = ( delta2 * e11 - delta1 * e12 ) / det;
+			const vec3 g = alpha * e1 + beta * e2;
+			const float d = a0 - dot( g, p0 );
+
+			quadric[AQ_A00] += area * g.x * g.x; quadric[AQ_A11] += area * g.y * g.y; quadric[AQ_A22] += area * g.z * g.z;
+			quadric[AQ_A01] += area * g.x * g.y; quadric[AQ_A02] += area * g.x * g.z; quadric[AQ_A12] += area * g.y * g.z;
+			quadric[AQ_B0] += area * g.x * d; quadric[AQ_B1] += area * g.y * d; quadric[AQ_B2] += area * g.z * d;
+			quadric[AQ_C] += area * d * d;
+			components[j * 4] = area * g.x;
+			components[j * 4 + 1] = area * g.y;
+			components[j * 4 + 2] = area * g.z;
+			components[j * 4 + 3] = area * d;
+		}
+		quadric[AQ_AREA] = area;
+
+		for( int i = 0; i < 3; ++i ) {
+			float *target = &mAttribQuadrics[(size_t)triangle[i] * mAttribStride];
+			for( int k = 0; k < AQ_COMPONENTS; ++k )
+				target[k] += quadric[k];
+			for( size_t k = 0; k < components.size(); ++k )
+				target[AQ_COMPONENTS + k] += components[k];
+		}
+	}
+}
+
+float Simplifier::attribError( uint32_t wedge, const vec3 &p, uint32_t target ) const
+{
+	const float *q = &mAttribQuadrics[(size_t)wedge * mAttribStride];
+	double sum = p.x * ( q[AQ_A00] * p.x + 2 * ( q[AQ_A01] * p.y + q[AQ_A02] * p.z + q[AQ_B0] ) ) + p.y * ( q[AQ_A11] * p.y + 2 * ( q[AQ_A12] * p.z + q[AQ_B1] ) )
+		+ p.z * ( q[AQ_A22] * p.z + 2 * q[AQ_B2] ) + q[AQ_C];
+	for( size_t j = 0; j < mNumComponents; ++j ) {
+		const float *g = q + AQ_COMPONENTS + j * 4;
+		const double value = getComponent( target, j );
+		sum += value * ( value * q[AQ_AREA] - 2 * ( g[0] * p.x + g[1] * p.y + g[2] * p.z + g[3] ) );
+	}
+
+	return float( std::max( sum, 0.0 ) );
+}
+
+float Simplifier::collapseCost( uint32_t from, uint32_t to ) const
+{
+	const float cost = mQuadrics[from].error( mPoints[to] );
+	if( mNumComponents == 0 )
+		return cost;
+
+	// each vertex at the position takes the attributes of the vertex at the target that fits it best
+	float error = 0, area = 0;
+	uint32_t a = mFirstWedge[from];
+	do {
+		float best = std::numeric_limits<float>::max();
+		uint32_t b = mFirstWedge[to];
+		do {
+			best = std::min( best, attribError( a, mPoints[to], b ) );
+			b = mNextWedge[b];
+		} while( b != mFirstWedge[to] );
+		error += best;
+		area += mAttribQuadrics[(size_t)a * mAttribStride + AQ_AREA];
+		a = mNextWedge[a];
+	} while( a != mFirstWedge[from] );
+
+	return cost + error / std::max( area, 1e-30f );
+}
+
+void Simplifier::gatherCandidates( uint32_t from )
+{
+	mCandidates.clear();
+	if( mKinds[from] == LOCKED || mKinds[from] == COLLAPSED )
+		return;
+
+	// each neighbor appears once for every triangle along the edge to it
+	gatherCorners( from, &mCorners );
+	mNeighbors.clear();
+	for( uint32_t c : mCorners ) {
+		const uint32_t t = c / 3;
+		for( uint32_t i = t * 3; i < t * 3 + 3; ++i ) {
+			if( mCornerPositions[i] != from )
+				mNeighbors.push_back( mCornerPositions[i] );
+		}
+	}
+	std::sort( mNeighbors.begin(), mNeighbors.end() );
+
+	for( size_t begin = 0, end; begin < mNeighbors.size(); begin = end ) {
+		end = begin + 1;
+		while( end < mNeighbors.size() && mNeighbors[end] == mNeighbors[begin] )
+			++end;
+
+		// a border vertex only collapses along a border
+		if( mKinds[from] == BORDER && end - begin != 1 )
+			continue;
+		const float cost = collapseCost( from, mNeighbors[begin] );
+		if( cost <= mMaxCost )
+			mCandidates.emplace_back( cost, mNeighbors[begin] );
+	}
+	std::sort( mCandidates.begin(), mCandidates.end() );
+}
+
+void Simplifier::queueCollapse( uint32_t from )
+{
+	++mVersions[from];
+	gatherCandidates( from );
+	if( mCandidates.empty() )
+		return;
+
+	pushCollapse( { mCandidates[0].first, from, mCandidates[0].second, mVersions[from] } );
+}
+
+void Simplifier::pushCollapse( const Collapse &collapse )
+{
+	size_t i = mHeap.size();
+	mHeap.push_back( collapse );
+	while( i > 0 && mHeap[( i - 1 ) / 4].cost > collapse.cost ) {
+		mHeap[i] = mHeap[( i - 1 ) / 4];
+		i = ( i - 1 ) / 4;
+	}
+	mHeap[i] = collapse;
+}
+
+Simplifier::Collapse Simplifier::popCollapse()
+{
+	const Collapse result = mHeap[0];
+	const Collapse last = mHeap.back();
+	mHeap.pop_back();
+	const size_t size = mHeap.size();
+	if( size == 0 )
+		return result;
+
+	size_t i = 0;
+	for( ;; ) {
+		const size_t firstChild = i * 4 + 1;
+		if( firstChild >= size )
+			break;
+		size_t smallest = firstChild;
+		for( size_t child = firstChild + 1; child < std::min( firstChild + 4, size ); ++child ) {
+			if( mHeap[child].cost < mHeap[smallest].cost )
+				smallest = child;
+		}
+		if( ! ( mHeap[smallest].cost < last.cost ) )
+			break;
+		mHeap[i] = mHeap[smallest];
+		i = smallest;
+	}
+	mHeap[i] = last;
+
+	return result;
+}
+
+void Simplifier::gatherCorners( uint32_t p, std::vector<uint32_t> *corners )
+{
+	corners->clear();
+	uint32_t last = INVALID_VERTEX;
+	for( uint32_t c = mCornerHeads[p]; c != INVALID_VERTEX; c = mNextCorners[c] ) {
+		if( ! mTriangleLive[c / 3] )
+			continue;
+		if( last == INVALID_VERTEX )
+			mCornerHeads[p] = c;
+		else
+			mNextCorners[last] = c;
+		last = c;
+		corners->push_back( c );
+	}
+
+	if( last == INVALID_VERTEX )
+		mCornerHeads[p] = INVALID_VERTEX;
+	else
+		mNextCorners[last] = INVALID_VERTEX;
+	mCornerTails[p] = last;
+}
+
+void Simplifier::gatherNeighbors( const std::vector<uint32_t> &corners, uint32_t p, std::vector<uint32_t> *neighbors ) const
+{
+	neighbors->clear();
+	for( uint32_t c : corners ) {
+		const uint32_t t = c / 3;
+		for( uint32_t i = t * 3; i < t * 3 + 3; ++i ) {
+			if( mCornerPositions[i] != p )
+				neighbors->push_back( mCornerPositions[i] );
+		}
+	}
+	std::sort( neighbors->begin(), neighbors->end() );
+	neighbors->erase( std::unique( neighbors->begin(), neighbors->end() ), neighbors->end() );
+}
+
+uint32_t Simplifier::findWedge( uint32_t wedge ) const
+{
+	for( auto &entry : mWedgeMap ) {
+		if( entry.first == wedge )
+			return entry.second;
+	}
+
+	return INVALID_VERTEX;
+}
+
+bool Simplifier::tryCollapse( uint32_t from, uint32_t to )
+{
+	gatherCorners( from, &mCorners );
+
+	// the triangles along the edge pair each vertex at \a from with one at \a to
+	mWedgeMap.clear();
+	size_t numShared = 0;
+	for( uint32_t c : mCorners ) {
+		const uint32_t t = c / 3;
+		for( uint32_t i = t * 3; i < t * 3 + 3; ++i ) {
+			if( mCornerPositions[i] != to )
+				continue;
+			++numShared;
+			const uint32_t target = findWedge( mIndices[c] );
+			if( target == INVALID_VERTEX )
+				mWedgeMap.emplace_back( mIndices[c], mIndices[i] );
+			else if( target != mIndices[i] )
+				return false;
+		}
+	}
+	if( numShared == 0 || ( mKinds[from] == BORDER && ( numShared != 1 || mKinds[to] == MANIFOLD ) ) )
+		return false;
+
+	// every other triangle needs a target for its vertex, which fails where the collapse would cross a seam
+	for( uint32_t c : mCorners ) {
+		if( findWedge( mIndices[c] ) == INVALID_VERTEX )
+			return false;
+	}
+
+	// the positions on both sides of the edge must be the only neighbors the two share, or the collapse would pinch the surface
+	gatherNeighbors( mCorners, from, &mNeighbors );
+	gatherCorners( to, &mOtherCorners );
+	gatherNeighbors( mOtherCorners, to, &mOtherNeighbors );
+	size_t numCommon = 0;
+	for( auto a = mNeighbors.begin(), b = mOtherNeighbors.begin(); a != mNeighbors.end() && b != mOtherNeighbors.end(); ) {
+		if( *a < *b )
+			++a;
+		else if( *b < *a )
+			++b;
+		else {
+			++numCommon;
+			++a;
+			++b;
+		}
+	}
+	if( numCommon != numShared )
+		return false;
+
+	// and no triangle may flip
+	for( uint32_t c : mCorners ) {
+		const uint32_t t = c / 3;
+		const uint32_t *p = &mCornerPositions[t * 3];
+		if( p[0] == to || p[1] == to || p[2] == to )
+			continue;
+		vec3 moved[3] = { mPoints[p[0]], mPoints[p[1]], mPoints[p[2]] };
+		moved[c - t * 3] = mPoints[to];
+		const vec3 before = cross( mPoints[p[1]] - mPoints[p[0]], mPoints[p[2]] - mPoints[p[0]] );
+		const vec3 after = cross( moved[1] - moved[0], moved[2] - moved[0] );
+		if( dot( before, after ) <= 0 )
+			return false;
+	}
+
+	for( uint32_t c : mCorners ) {
+		const uint32_t t = c / 3;
+		if( mCornerPositions[t * 3] == to || mCornerPositions[t * 3 + 1] == to || mCornerPositions[t * 3 + 2] == to ) {
+			mTriangleLive[t] = 0;
+			--mNumLiveTriangles;
+		}
+		else {
+			mIndices[c] = findWedge( mIndices[c] );
+			mCornerPositions[c] = to;
+		}
+	}
+
+	// hand the corners over to \a to
+	if( mCornerHeads[from] != INVALID_VERTEX ) {
+		if( mCornerTails[to] == INVALID_VERTEX )
+			mCornerHeads[to] = mCornerHeads[from];
+		else
+			mNextCorners[mCornerTails[to]] = mCornerHeads[from];
+		mCornerTails[to] = mCornerTails[from];
+	}
+	mCornerHeads[from] = mCornerTails[from] = INVALID_VERTEX;
+
+	mQuadrics[to].add( mQuadrics[from] );
+	for( auto &entry : mWedgeMap ) {
+		for( size_t k = 0; k < mAttribStride; ++k )
+			mAttribQuadrics[(size_t)entry.second * mAttribStride + k] += mAttribQuadrics[(size_t)entry.first * mAttribStride + k];
+	}
+	mKinds[from] = COLLAPSED;
+	++mVersions[to];
+
+	// only the collapses of \a to change cost; those onto \a from are requeued as they come up
+	queueCollapse( to );
+
+	return true;
+}
+
+void Simplifier::simplify( size_t targetTriangles )
+{
+	while( mNumLiveTriangles > targetTriangles && ! mHeap.empty() ) {
+		const Collapse collapse = popCollapse();
+
+		// skips collapses superseded since they were queued, and finds a new target for those whose target has gone
+		if( mKinds[collapse.from] == COLLAPSED || collapse.version != mVersions[collapse.from] )
+			continue;
+		if( mKinds[collapse.to] == COLLAPSED ) {
+			queueCollapse( collapse.from );
+			continue;
+		}
+
+		if( tryCollapse( collapse.from, collapse.to ) ) {
+			mMaxCollapseCost = std::max( mMaxCollapseCost, collapse.cost );
+			continue;
+		}
+
+		// the cheapest collapse was refused, so the others follow for as long as they stay ahead of the queue
+		gatherCandidates( collapse.from );
+		for( size_t i = 0; i < mCandidates.size(); ++i ) {
+			const float cost = mCandidates[i].first;
+			const uint32_t to = mCandidates[i].second;
+			if( to == collapse.to )
+				continue;
+			if( ! mHeap.empty() && cost > mHeap.front().cost ) {
+				pushCollapse( { cost, collapse.from, to, collapse.version } );
+				break;
+			}
+			if( tryCollapse( collapse.from, to ) ) {
+				mMaxCollapseCost = std::max( mMaxCollapseCost, cost );
+				break;
+			}
+		}
+	}
+}
+
+void Simplifier::getResult( std::vector<uint32_t> *indices, std::vector<uint32_t> *remap, size_t *numVertices ) const
+{
+	indices->clear();
+	indices->reserve( mNumLiveTriangles * 3 );
+	remap->assign( mNumVertices, INVALID_VERTEX );
+	for( size_t t = 0; t < mTriangleLive.size(); ++t ) {
+		if( mTriangleLive[t] ) {
+			for( size_t i = t * 3; i < t * 3 + 3; ++i )
+				( *remap )[mIndices[i]] = 0;
+		}
+	}
+
+	uint32_t numReferenced = 0;
+	for( auto &target : *remap ) {
+		if( target != INVALID_VERTEX )
+			target = numReferenced++;
+	}
+	for( size_t t = 0; t < mTriangleLive.size(); ++t ) {
+		if( mTriangleLive[t] ) {
+			for( size_t i = t * 3; i < t * 3 + 3; ++i )
+				indices->push_back( ( *remap )[mIndices[i]] );
+		}
+	}
+	*numVertices = numReferenced;
+}
+
+// the attributes of \a mesh that weigh on the cost of collapses
+std::vector<SimplifyAttrib> makeSimplifyAttribs( const TriMesh &mesh, const TriMesh::SimplifyOptions &options )
+{
+	std::vector<SimplifyAttrib> result;
+	const size_t numVertices = mesh.getNumVertices();
+	auto addAttrib = [&]( const float *data, size_t numFloats, uint8_t dims, float weight ) {
+		if( dims > 0 && weight > 0 && numFloats == numVertices * dims )
+			result.push_back( { data, dims, weight } );
+	};
+	addAttrib( (const float*)mesh.getNormals().data(), mesh.getNormals().size() * 3, 3, options.getNormalWeight() );
+	addAttrib( mesh.getBufferTexCoords0().data(), mesh.getBufferTexCoords0().size(), mesh.getAttribDims( geom::TEX_COORD_0 ), options.getTexCoordWeight() );
+	addAttrib( mesh.getBufferColors().data(), mesh.getBufferColors().size(), mesh.getAttribDims( geom::COLOR ), options.getColorWeight() );
+
+	return result;
+}
+
+} // anonymous namespace
+
+float TriMesh::simplify( size_t targetTriangles, const SimplifyOptions &options )
+{
+	const size_t numVertices = getNumVertices();
+	if( mPositionsDims != 3 || mIndices.empty() || numIndexedVertices( mIndices ) > numVertices )
+		return 0;
+
+	const std::vector<SimplifyAttrib> attribs = makeSimplifyAttribs( *this, options );
+	Simplifier simplifier( mIndices, mPositions.data(), numVertices, attribs, options );
+	simplifier.simplify( targetTriangles );
+
+	std::vector<uint32_t> remap;
+	size_t numReferenced;
+	simplifier.getResult( &mIndices, &remap, &numReferenced );
+	remapVertices( remap, numReferenced );
+
+	return simplifier.getError();
+}
+
+std::vector<TriMesh> TriMesh::generateLods( const std::vector<size_t> &targetTriangles, const SimplifyOptions &options, std::vector<float> *errors ) const
+{
+	std::vector<TriMesh> result;
+	if( errors )
+		errors->clear();
+	const size_t numVertices = getNumVertices();
+	if( mPositionsDims != 3 || mIndices.empty() || numIndexedVertices( mIndices ) > numVertices )
+		return result;
+
+	const std::vector<SimplifyAttrib> attribs = makeSimplifyAttribs( *this, options );
+	Simplifier simplifier( mIndices, mPositions.data(), numVertices, attribs, options );
+	for( size_t target : targetTriangles ) {
+		simplifier.simplify( target );
+
+		result.push_back( *this );
+		TriMesh &lod = result.back();
+		std::vector<uint32_t> remap;
+		size_t numReferenced;
+		simplifier.getResult( &lod.mIndices, &remap, &numReferenced );
+		lod.remapVertices( remap, numReferenced );
+		if( errors )
+			errors->push_back( simplifier.getError() );
+	}
+
+	return result;
+}
+
 uint8_t TriMesh::getAttribDims( geom::Attrib attr ) const
 {
 	switch( attr ) {
@@ -1329,6 +2597,21 @@ bool TriMesh::verticesEqual( uint32_t indexA, uint32_t indexB ) const
 	return true;
 }
 
+void TriMesh::remapVertices( const std::vector<uint32_t> &remap, size_t numVertices )
+{
+	remapAttrib( &mPositions, mPositionsDims, remap, numVertices );
+	remapAttrib( &mColors, mColorsDims, remap, numVertices );
+	remapAttrib( &mTexCoords0, mTexCoords0Dims, remap, numVertices );
+	remapAttrib( &mTexCoords1, mTexCoords1Dims, remap, numVertices );
+	remapAttrib( &mTexCoords2, mTexCoords2Dims, remap, numVertices );
+	remapAttrib( &mTexCoords3, mTexCoords3Dims, remap, numVertices );
+	remapAttrib( &mNormals, 1, remap, numVertices );
+	remapAttrib( &mTangents, 1, remap, numVertices );
+	remapAttrib( &mBitangents, 1, remap, numVertices );
+	remapAttrib( &mBoneIndices, 1, remap, numVertices );
+	remapAttrib( &mBoneWeights, 1, remap, numVertices );
+}
+
 uint32_t TriMesh::toMask( geom::Attrib attrib )
 {
 	switch( attrib ) {
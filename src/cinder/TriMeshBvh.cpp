@@ -0,0 +1,926 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/TriMeshBvh.h"
+#include "cinder/Exception.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#include <emmintrin.h>
+	#define CINDER_TRIMESH_BVH_SSE2
+#endif
+
+namespace cinder {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Build
+
+const int		NUM_BINS = 16;
+// splits deeper than this fall back to median splits, which bounds the depth of the hierarchy and so the traversal stacks
+const uint32_t	MAX_SAH_DEPTH = 64;
+const size_t	STACK_SIZE = 4 * ( MAX_SAH_DEPTH + 32 );
+// the cost of visiting a node relative to that of intersecting a triangle
+const float		TRAVERSAL_COST = 1.0f;
+
+// A node of the binary hierarchy, which is collapsed into the four-wide nodes once built
+struct BuildNode {
+	vec3		min, max;
+	uint32_t	left, right;
+	uint32_t	begin, count; // the leaf's range of the primitives, with a count of 0 for internal nodes
+};
+
+struct BuildRange {
+	uint32_t	node, begin, end, depth;
+};
+
+// Four floats, of which the build uses the first three for x, y and z, so that each bounds update is a single SIMD operation
+#if defined( CINDER_TRIMESH_BVH_SSE2 )
+typedef __m128	Lanes;
+
+Lanes	loadLanes( const float *p ) { return _mm_loadu_ps( p ); }
+void	storeLanes( float *p, Lanes a ) { _mm_storeu_ps( p, a ); }
+Lanes	splatLanes( float v ) { return _mm_set1_ps( v ); }
+Lanes	minLanes( Lanes a, Lanes b ) { return _mm_min_ps( a, b ); }
+Lanes	maxLanes( Lanes a, Lanes b ) { return _mm_max_ps( a, b ); }
+Lanes	addLanes( Lanes a, Lanes b ) { return _mm_add_ps( a, b ); }
+Lanes	subLanes( Lanes a, Lanes b ) { return _mm_sub_ps( a, b ); }
+Lanes	mulLanes( Lanes a, Lanes b ) { return _mm_mul_ps( a, b ); }
+// converts to integers in registers, as reloading stored floats one at a time stalls on the store
+void	storeTruncated( int32_t *p, Lanes a ) { _mm_storeu_si128( reinterpret_cast<__m128i*>( p ), _mm_cvttps_epi32( a ) ); }
+#else
+struct Lanes {
+	float v[4];
+};
+
+Lanes	loadLanes( const float *p ) { return { { p[0], p[1], p[2], p[3] } }; }
+void	storeLanes( float *p, Lanes a ) { std::copy( a.v, a.v + 4, p ); }
+Lanes	splatLanes( float v ) { return { { v, v, v, v } }; }
+// like minps and maxps, these return the lane of b when either is NaN
+Lanes	minLanes( Lanes a, Lanes b ) { return { { a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1], a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3] } }; }
+Lanes	maxLanes( Lanes a, Lanes b ) { return { { a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3] } }; }
+Lanes	addLanes( Lanes a, Lanes b ) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+Lanes	subLanes( Lanes a, Lanes b ) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+Lanes	mulLanes( Lanes a, Lanes b ) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+void	storeTruncated( int32_t *p, Lanes a ) { for( int i = 0; i < 4; ++i ) p[i] = int32_t( a.v[i] ); }
+#endif
+
+Lanes toLanes( const vec3 &v )
+{
+	const float p[4] = { v.x, v.y, v.z, 0 };
+	return loadLanes( p );
+}
+
+vec3 toVec3( Lanes a )
+{
+	float p[4];
+	storeLanes( p, a );
+	return vec3( p[0], p[1], p[2] );
+}
+
+// The bounds of a triangle, which the build partitions directly rather than through indices so that every pass reads them in order.
+// The unused fourth floats are kept at zero, as the denormals of anything else in them would slow every operation down.
+struct BuildPrim {
+	float		min[4], max[4];
+	uint32_t	id;
+
+	Lanes		getCentroid() const { return mulLanes( addLanes( loadLanes( min ), loadLanes( max ) ), splatLanes( 0.5f ) ); }
+	// matches the lane of getCentroid() exactly, so that partitions agree with the bins
+	float		getCentroid( int axis ) const { return ( min[axis] + max[axis] ) * 0.5f; }
+	// orders NaN centroids after every other, so that sorting by it is well defined
+	float		getCentroidKey( int axis ) const { const float c = getCentroid( axis ); return std::isnan( c ) ? std::numeric_limits<float>::infinity() : c; }
+};
+
+bool isFinite( const vec3 &v )
+{
+	return std::isfinite( v.x ) && std::isfinite( v.y ) && std::isfinite( v.z );
+}
+
+float halfArea( const vec3 &min, const vec3 &max )
+{
+	const vec3 size = max - min;
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+class Builder {
+  public:
+	Builder( BuildPrim *prims, uint32_t maxLeafTriangles )
+		: mPrims( prims ), mMaxLeafTriangles( maxLeafTriangles )
+	{}
+
+	/* Builds the subtree of \a nodes[range.node] over the primitives [range.begin, range.end). When \a deferred is given,
+		ranges of at most \a deferSize primitives are left as leaves and appended to it instead, to be built separately. */
+	void build( std::vector<BuildNode> *nodes, const BuildRange &range, std::vector<BuildRange> *deferred = nullptr, uint32_t deferSize = 0 ) const
+	{
+		std::vector<BuildRange> stack( 1, range );
+		while( ! stack.empty() ) {
+			const BuildRange r = stack.back();
+			stack.pop_back();
+			const uint32_t count = r.end - r.begin;
+
+			Lanes min = splatLanes( std::numeric_limits<float>::max() ), max = splatLanes( -std::numeric_limits<float>::max() );
+			Lanes centroidMin = min, centroidMax = max;
+			// the bounds so far come second, so that the NaNs of a degenerate triangle are left out of them
+			for( uint32_t i = r.begin; i < r.end; ++i ) {
+				min = minLanes( loadLanes( mPrims[i].min ), min );
+				max = maxLanes( loadLanes( mPrims[i].max ), max );
+				const Lanes centroid = mPrims[i].getCentroid();
+				centroidMin = minLanes( centroid, centroidMin );
+				centroidMax = maxLanes( centroid, centroidMax );
+			}
+			BuildNode &node = (*nodes)[r.node];
+			node.min = toVec3( min );
+			node.max = toVec3( max );
+			node.begin = r.begin;
+			node.count = count;
+			if( count <= 1 || ( deferred && count <= deferSize ) ) {
+				if( deferred && count > 1 )
+					deferred->push_back( r );
+				continue;
+			}
+
+			uint32_t mid = split( r, count, toVec3( min ), toVec3( max ), toVec3( centroidMin ), toVec3( centroidMax ) );
+			if( mid == r.begin )
+				continue;
+
+			const uint32_t left = (uint32_t)nodes->size();
+			nodes->resize( left + 2 );
+			BuildNode &parent = (*nodes)[r.node];
+			parent.left = left;
+			parent.right = left + 1;
+			parent.count = 0;
+			stack.push_back( { left + 1, mid, r.end, r.depth + 1 } );
+			stack.push_back( { left, r.begin, mid, r.depth + 1 } );
+		}
+	}
+
+  private:
+	// Partitions the range by the cheapest binned split and returns where the second half starts, or \a range.begin when a leaf is cheaper
+	uint32_t split( const BuildRange &range, uint32_t count, const vec3 &min, const vec3 &max, const vec3 &centroidMin, const vec3 &centroidMax ) const
+	{
+		const vec3 extent = centroidMax - centroidMin;
+		// infinite coordinates would make every cost infinite or NaN, so they're left to the median split
+		if( range.depth < MAX_SAH_DEPTH && isFinite( min ) && isFinite( max ) && isFinite( extent ) ) {
+			struct Bin {
+				Lanes		min, max;
+				uint32_t	count;
+			};
+			const Bin empty = { splatLanes( std::numeric_limits<float>::max() ), splatLanes( -std::numeric_limits<float>::max() ), 0 };
+			// small ranges, which are most of them, don't need as many bins
+			const int numBins = (int)std::min<uint32_t>( NUM_BINS, std::max<uint32_t>( 4, count ) );
+			Bin bins[3][NUM_BINS];
+			for( int a = 0; a < 3; ++a )
+				std::fill( bins[a], bins[a] + numBins, empty );
+			vec3 scale;
+			for( int a = 0; a < 3; ++a )
+				scale[a] = extent[a] > 0 ? numBins * ( 1 - 1e-6f ) / extent[a] : 0;
+			const Lanes origin = toLanes( centroidMin ), scaleLanes = toLanes( scale ), zero = splatLanes( 0 ), lastBin = splatLanes( float( numBins - 1 ) );
+			for( uint32_t i = range.begin; i < range.end; ++i ) {
+				const BuildPrim &prim = mPrims[i];
+				const Lanes primMin = loadLanes( prim.min ), primMax = loadLanes( prim.max );
+				// clamped before converting, which sends NaN centroids to the first bin as binOf() does
+				int32_t binIndices[4];
+				storeTruncated( binIndices, minLanes( maxLanes( mulLanes( subLanes( prim.getCentroid(), origin ), scaleLanes ), zero ), lastBin ) );
+				for( int a = 0; a < 3; ++a ) {
+					Bin &bin = bins[a][binIndices[a]];
+					bin.min = minLanes( bin.min, primMin );
+					bin.max = maxLanes( bin.max, primMax );
+					++bin.count;
+				}
+			}
+
+			float bestCost = std::numeric_limits<float>::max();
+			int bestAxis = -1, bestBin = 0;
+			for( int a = 0; a < 3; ++a ) {
+				if( extent[a] <= 0 )
+					continue;
+				// the cost of the right side of each split, swept from the right
+				float rightCosts[NUM_BINS];
+				Bin right = empty;
+				for( int b = numBins - 1; b > 0; --b ) {
+					right.min = minLanes( right.min, bins[a][b].min );
+					right.max = maxLanes( right.max, bins[a][b].max );
+					right.count += bins[a][b].count;
+					rightCosts[b] = right.count ? halfArea( toVec3( right.min ), toVec3( right.max ) ) * right.count : 0;
+				}
+				Bin left = empty;
+				for( int b = 1; b < numBins; ++b ) {
+					left.min = minLanes( left.min, bins[a][b - 1].min );
+					left.max = maxLanes( left.max, bins[a][b - 1].max );
+					left.count += bins[a][b - 1].count;
+					if( left.count == 0 || left.count == count )
+						continue;
+					const float cost = halfArea( toVec3( left.min ), toVec3( left.max ) ) * left.count + rightCosts[b];
+					if( cost < bestCost ) {
+						bestCost = cost;
+						bestAxis = a;
+						bestBin = b;
+					}
+				}
+			}
+
+			const float area = halfArea( min, max );
+			if( count <= mMaxLeafTriangles && area * count <= area * TRAVERSAL_COST + bestCost )
+				return range.begin;
+			if( bestAxis >= 0 ) {
+				const float s = scale[bestAxis], o = centroidMin[bestAxis];
+				return (uint32_t)( std::partition( mPrims + range.begin, mPrims + range.end, [&]( const BuildPrim &prim ) {
+					return binOf( ( prim.getCentroid( bestAxis ) - o ) * s, numBins ) < bestBin;
+				} ) - mPrims );
+			}
+		}
+
+		if( count <= mMaxLeafTriangles )
+			return range.begin;
+
+		// too deep, or no split separates the centroids: halve the range along the longest axis
+		const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : ( extent.y >= extent.z ? 1 : 2 );
+		const uint32_t mid = range.begin + count / 2;
+		std::nth_element( mPrims + range.begin, mPrims + mid, mPrims + range.end, [&]( const BuildPrim &a, const BuildPrim &b ) {
+			return a.getCentroidKey( axis ) < b.getCentroidKey( axis ) || ( a.getCentroidKey( axis ) == b.getCentroidKey( axis ) && a.id < b.id );
+		} );
+		return mid;
+	}
+
+	// The bin of a centroid's offset, already scaled to the bins, clamped in the same order as the lanes of split()
+	static int binOf( float offset, int numBins )
+	{
+		const float clamped = offset > 0 ? offset : 0;
+		return int( clamped < float( numBins - 1 ) ? clamped : float( numBins - 1 ) );
+	}
+
+	BuildPrim		*mPrims;
+	uint32_t		mMaxLeafTriangles;
+};
+
+bool isUnused( const TriMeshBvh::Node &node, int child )
+{
+	return node.numTriangles[child] == 0 && node.children[child] == 0;
+}
+
+void setChildBounds( TriMeshBvh::Node *node, int child, const vec3 &min, const vec3 &max )
+{
+	for( int a = 0; a < 3; ++a ) {
+		node->min[a][child] = min[a];
+		node->max[a][child] = max[a];
+	}
+}
+
+// Appends the four-wide node collapsed from the internal binary node \a b and its descendants to \a nodes, returning its index
+uint32_t collapse( const std::vector<BuildNode> &buildNodes, uint32_t b, std::vector<TriMeshBvh::Node> *nodes )
+{
+	const uint32_t index = (uint32_t)nodes->size();
+	nodes->emplace_back();
+
+	// open the largest internal child until there are four
+	uint32_t children[4] = { buildNodes[b].left, buildNodes[b].right };
+	int numChildren = 2;
+	while( numChildren < 4 ) {
+		int largest = -1;
+		float largestArea = -1;
+		for( int c = 0; c < numChildren; ++c ) {
+			const BuildNode &child = buildNodes[children[c]];
+			const float area = halfArea( child.min, child.max );
+			if( child.count == 0 && area > largestArea ) {
+				largest = c;
+				largestArea = area;
+			}
+		}
+		if( largest < 0 )
+			break;
+		const BuildNode &opened = buildNodes[children[largest]];
+		children[largest] = opened.left;
+		children[numChildren++] = opened.right;
+	}
+
+	TriMeshBvh::Node node;
+	for( int c = 0; c < 4; ++c ) {
+		if( c < numChildren ) {
+			const BuildNode &child = buildNodes[children[c]];
+			setChildBounds( &node, c, child.min, child.max );
+			node.children[c] = child.count ? child.begin : collapse( buildNodes, children[c], nodes );
+			node.numTriangles[c] = child.count;
+		}
+		else {
+			setChildBounds( &node, c, vec3( std::numeric_limits<float>::max() ), vec3( -std::numeric_limits<float>::max() ) );
+			node.children[c] = 0;
+			node.numTriangles[c] = 0;
+		}
+	}
+	(*nodes)[index] = node;
+
+	return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Queries
+
+// Intersects a ray with a triangle from both sides as Ray::calcTriangleIntersection() does, returning the distance and the barycentric coordinates
+bool intersectTriangle( const vec3 &origin, const vec3 &direction, const vec3 *v, float *distance, vec2 *barycentric )
+{
+	const vec3 edge1 = v[1] - v[0], edge2 = v[2] - v[0];
+	const vec3 pvec = cross( direction, edge2 );
+	const float det = dot( edge1, pvec );
+	if( det > -0.000001f && det < 0.000001f )
+		return false;
+
+	const float invDet = 1.0f / det;
+	const vec3 tvec = origin - v[0];
+	const float u = dot( tvec, pvec ) * invDet;
+	if( u < 0.0f || u > 1.0f )
+		return false;
+
+	const vec3 qvec = cross( tvec, edge1 );
+	const float w = dot( direction, qvec ) * invDet;
+	if( w < 0.0f || u + w > 1.0f )
+		return false;
+
+	*distance = dot( edge2, qvec ) * invDet;
+	*barycentric = vec2( u, w );
+	return true;
+}
+
+// Returns the point of triangle \a v closest to \a p, and its barycentric coordinates for the second and third vertices. From Ericson, "Real-Time Collision Detection".
+vec3 closestPointOnTriangle( const vec3 &p, const vec3 *v, vec2 *barycentric )
+{
+	const vec3 ab = v[1] - v[0], ac = v[2] - v[0], ap = p - v[0];
+	if( length2( cross( ab, ac ) ) == 0 ) {
+		// degenerate triangles have no interior, and would divide by zero below, so the closest of their edges is used instead
+		const vec3 *ends[3][2] = { { &v[0], &v[1] }, { &v[0], &v[2] }, { &v[1], &v[2] } };
+		vec3 result;
+		float closest = std::numeric_limits<float>::max();
+		for( int e = 0; e < 3; ++e ) {
+			const vec3 edge = *ends[e][1] - *ends[e][0];
+			const float edgeLength2 = length2( edge );
+			const float t = edgeLength2 > 0 ? glm::clamp( dot( p - *ends[e][0], edge ) / edgeLength2, 0.0f, 1.0f ) : 0;
+			const vec3 q = *ends[e][0] + edge * t;
+			if( distance2( p, q ) < closest ) {
+				closest = distance2( p, q );
+				result = q;
+				*barycentric = e == 0 ? vec2( t, 0 ) : ( e == 1 ? vec2( 0, t ) : vec2( 1 - t, t ) );
+			}
+		}
+		return result;
+	}
+
+	const float d1 = dot( ab, ap ), d2 = dot( ac, ap );
+	if( d1 <= 0 && d2 <= 0 ) {
+		*barycentric = vec2( 0 );
+		return v[0];
+	}
+
+	const vec3 bp = p - v[1];
+	const float d3 = dot( ab, bp ), d4 = dot( ac, bp );
+	if( d3 >= 0 && d4 <= d3 ) {
+		*barycentric = vec2( 1, 0 );
+		return v[1];
+	}
+
+	const float vc = d1 * d4 - d3 * d2;
+	if( vc <= 0 && d1 >= 0 && d3 <= 0 ) {
+		const float t = d1 / ( d1 - d3 );
+		*barycentric = vec2( t, 0 );
+		return v[0] + t * ab;
+	}
+
+	const vec3 cp = p - v[2];
+	const float d5 = dot( ab, cp ), d6 = dot( ac, cp );
+	if( d6 >= 0 && d5 <= d6 ) {
+		*barycentric = vec2( 0, 1 );
+		return v[2];
+	}
+
+	const float vb = d5 * d2 - d1 * d6;
+	if( vb <= 0 && d2 >= 0 && d6 <= 0 ) {
+		const float t = d2 / ( d2 - d6 );
+		*barycentric = vec2( 0, t );
+		return v[0] + t * ac;
+	}
+
+	const float va = d3 * d6 - d5 * d4;
+	if( va <= 0 && ( d4 - d3 ) >= 0 && ( d5 - d6 ) >= 0 ) {
+		const float t = ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) );
+		*barycentric = vec2( 1 - t, t );
+		return v[1] + t * ( v[2] - v[1] );
+	}
+
+	const float denom = 1 / ( va + vb + vc );
+	*barycentric = vec2( vb * denom, vc * denom );
+	return v[0] + ab * barycentric->x + ac * barycentric->y;
+}
+
+// Returns whether the triangle \a v overlaps the box of \a center and \a extents, by the separating axis test of Akenine-Möller
+bool triangleOverlapsBox( const vec3 &center, const vec3 &extents, const vec3 *v )
+{
+	const vec3 p[3] = { v[0] - center, v[1] - center, v[2] - center };
+	auto separates = [&]( const vec3 &axis ) {
+		const float p0 = dot( p[0], axis ), p1 = dot( p[1], axis ), p2 = dot( p[2], axis );
+		const float r = dot( extents, glm::abs( axis ) );
+		return std::min( p0, std::min( p1, p2 ) ) > r || std::max( p0, std::max( p1, p2 ) ) < -r;
+	};
+
+	for( int a = 0; a < 3; ++a ) {
+		if( std::min( p[0][a], std::min( p[1][a], p[2][a] ) ) > extents[a] || std::max( p[0][a], std::max( p[1][a], p[2][a] ) ) < -extents[a] )
+			return false;
+	}
+
+	const vec3 edges[3] = { p[1] - p[0], p[2] - p[1], p[0] - p[2] };
+	if( separates( cross( edges[0], edges[1] ) ) )
+		return false;
+	for( const vec3 &edge : edges ) {
+		if( separates( vec3( 0, -edge.z, edge.y ) ) || separates( vec3( edge.z, 0, -edge.x ) ) || separates( vec3( -edge.y, edge.x, 0 ) ) )
+			return false;
+	}
+
+	return true;
+}
+
+// The ray in the form the slab tests use, with the planes each axis enters and leaves a box through chosen by the sign of the direction.
+// Empty bounds, whose minimum is above their maximum, are then never entered.
+struct RaySlabs {
+	RaySlabs( const Ray &ray )
+		: origin( ray.getOrigin() ), direction( ray.getDirection() ), invDirection( ray.getInverseDirection() )
+	{
+		// from the inverse rather than Ray::getSignX() and co, which leave -0 positive though its inverse is -inf
+		for( int a = 0; a < 3; ++a )
+			negative[a] = invDirection[a] < 0;
+	}
+
+	vec3	origin, direction, invDirection;
+	bool	negative[3];
+};
+
+// Returns a mask of the children of \a node the ray enters within [0, \a maxDistance], with the distances at which it enters them in \a entries.
+// The NaN of a ray lying in a slab's plane leaves the distances unchanged.
+int intersectChildren( const TriMeshBvh::Node &node, const RaySlabs &ray, float maxDistance, float entries[4] )
+{
+#if defined( CINDER_TRIMESH_BVH_SSE2 )
+	__m128 near = _mm_setzero_ps(), far = _mm_set1_ps( maxDistance );
+	for( int a = 0; a < 3; ++a ) {
+		const __m128 origin = _mm_set1_ps( ray.origin[a] ), invDirection = _mm_set1_ps( ray.invDirection[a] );
+		const __m128 enter = _mm_load_ps( ray.negative[a] ? node.max[a] : node.min[a] ), leave = _mm_load_ps( ray.negative[a] ? node.min[a] : node.max[a] );
+		near = _mm_max_ps( _mm_mul_ps( _mm_sub_ps( enter, origin ), invDirection ), near );
+		far = _mm_min_ps( _mm_mul_ps( _mm_sub_ps( leave, origin ), invDirection ), far );
+	}
+	_mm_storeu_ps( entries, near );
+	return _mm_movemask_ps( _mm_cmple_ps( near, far ) );
+#else
+	int result = 0;
+	for( int c = 0; c < 4; ++c ) {
+		float near = 0, far = maxDistance;
+		for( int a = 0; a < 3; ++a ) {
+			const float enter = ray.negative[a] ? node.max[a][c] : node.min[a][c], leave = ray.negative[a] ? node.min[a][c] : node.max[a][c];
+			near = std::max( near, ( enter - ray.origin[a] ) * ray.invDirection[a] );
+			far = std::min( far, ( leave - ray.origin[a] ) * ray.invDirection[a] );
+		}
+		entries[c] = near;
+		result |= ( near <= far ) << c;
+	}
+	return result;
+#endif
+}
+
+// Returns a mask of the children of \a node whose bounds overlap [\a min, \a max]
+int overlapChildren( const TriMeshBvh::Node &node, const vec3 &min, const vec3 &max )
+{
+#if defined( CINDER_TRIMESH_BVH_SSE2 )
+	__m128 overlap = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+	for( int a = 0; a < 3; ++a ) {
+		overlap = _mm_and_ps( overlap, _mm_cmple_ps( _mm_load_ps( node.min[a] ), _mm_set1_ps( max[a] ) ) );
+		overlap = _mm_and_ps( overlap, _mm_cmpge_ps( _mm_load_ps( node.max[a] ), _mm_set1_ps( min[a] ) ) );
+	}
+	return _mm_movemask_ps( overlap );
+#else
+	int result = 0;
+	for( int c = 0; c < 4; ++c ) {
+		bool overlap = true;
+		for( int a = 0; a < 3; ++a )
+			overlap = overlap && node.min[a][c] <= max[a] && node.max[a][c] >= min[a];
+		result |= overlap << c;
+	}
+	return result;
+#endif
+}
+
+// Stores the squared distances from \a point to the bounds of the children of \a node in \a distances2
+void distanceToChildren( const TriMeshBvh::Node &node, const vec3 &point, float distances2[4] )
+{
+#if defined( CINDER_TRIMESH_BVH_SSE2 )
+	__m128 sum = _mm_setzero_ps();
+	for( int a = 0; a < 3; ++a ) {
+		const __m128 p = _mm_set1_ps( point[a] );
+		const __m128 d = _mm_max_ps( _mm_max_ps( _mm_sub_ps( _mm_load_ps( node.min[a] ), p ), _mm_sub_ps( p, _mm_load_ps( node.max[a] ) ) ), _mm_setzero_ps() );
+		sum = _mm_add_ps( sum, _mm_mul_ps( d, d ) );
+	}
+	_mm_storeu_ps( distances2, sum );
+#else
+	for( int c = 0; c < 4; ++c ) {
+		float sum = 0;
+		for( int a = 0; a < 3; ++a ) {
+			const float d = std::max( std::max( node.min[a][c] - point[a], point[a] - node.max[a][c] ), 0.0f );
+			sum += d * d;
+		}
+		distances2[c] = sum;
+	}
+#endif
+}
+
+// A child waiting on a traversal stack: a node, or a leaf when \a numTriangles isn't 0, with the distance it's ordered by
+struct StackEntry {
+	uint32_t	index, numTriangles;
+	float		distance;
+};
+
+// Pushes the children of \a node in \a mask onto \a stack, farthest first so that the nearest is visited next
+void pushChildren( const TriMeshBvh::Node &node, int mask, const float distances[4], StackEntry *stack, size_t *stackSize )
+{
+	const size_t first = *stackSize;
+	for( int c = 0; c < 4; ++c ) {
+		if( ! ( mask & ( 1 << c ) ) )
+			continue;
+		const StackEntry entry = { node.children[c], node.numTriangles[c], distances[c] };
+		size_t i = (*stackSize)++;
+		for( ; i > first && stack[i - 1].distance < entry.distance; --i )
+			stack[i] = stack[i - 1];
+		stack[i] = entry;
+	}
+}
+
+} // anonymous namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TriMeshBvh
+
+TriMeshBvh::TriMeshBvh( const TriMesh &mesh, const Options &options )
+{
+	if( mesh.getAttribDims( geom::Attrib::POSITION ) == 3 )
+		build( mesh.getPositions<3>(), mesh.getNumVertices(), mesh.getIndices().data(), mesh.getNumTriangles(), options );
+}
+
+TriMeshBvh::TriMeshBvh( const vec3 *positions, size_t numPositions, const uint32_t *indices, size_t numTriangles, const Options &options )
+{
+	build( positions, numPositions, indices, numTriangles, options );
+}
+
+void TriMeshBvh::build( const vec3 *positions, size_t numPositions, const uint32_t *indices, size_t numTriangles, const Options &options )
+{
+	if( numTriangles == 0 )
+		return;
+	if( numTriangles > std::numeric_limits<uint32_t>::max() / 3 )
+		throw Exception( "TriMeshBvh error: too many triangles" );
+	for( size_t i = 0; i < numTriangles * 3; ++i ) {
+		if( indices[i] >= numPositions )
+			throw Exception( "TriMeshBvh error: index " + std::to_string( indices[i] ) + " is out of range" );
+	}
+
+	const int numThreads = options.getNumThreads();
+	std::vector<BuildPrim> prims( numTriangles );
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numTriangles, [&]( size_t begin, size_t end ) {
+		for( size_t t = begin; t < end; ++t ) {
+			const vec3 &v0 = positions[indices[t * 3]], &v1 = positions[indices[t * 3 + 1]], &v2 = positions[indices[t * 3 + 2]];
+			const vec3 min = glm::min( v0, glm::min( v1, v2 ) ), max = glm::max( v0, glm::max( v1, v2 ) );
+			std::copy( &min.x, &min.x + 3, prims[t].min );
+			std::copy( &max.x, &max.x + 3, prims[t].max );
+			prims[t].min[3] = prims[t].max[3] = 0;
+			prims[t].id = uint32_t( t );
+		}
+	}, 4096, numThreads );
+
+	// the top of the hierarchy is built on this thread, leaving subtrees that are then built in parallel. Their size depends only on
+	// the number of triangles, so that the hierarchy doesn't depend on the number of threads.
+	const Builder builder( prims.data(), options.getMaxLeafTriangles() );
+	std::vector<BuildNode> nodes( 1 );
+	std::vector<BuildRange> deferred;
+	builder.build( &nodes, { 0, 0, uint32_t( numTriangles ), 0 }, &deferred, std::max<uint32_t>( uint32_t( numTriangles / 64 ), 2048 ) );
+
+	std::vector<std::vector<BuildNode>> subtrees( deferred.size() );
+	TaskScheduler::global()->parallelFor( 0, (int64_t)deferred.size(), [&]( size_t begin, size_t end ) {
+		for( size_t s = begin; s < end; ++s ) {
+			subtrees[s].resize( 1 );
+			builder.build( &subtrees[s], { 0, deferred[s].begin, deferred[s].end, deferred[s].depth } );
+		}
+	}, 0, numThreads );
+
+	// splice each subtree in place of its leaf, its root taking the leaf's place and the rest appended
+	for( size_t s = 0; s < subtrees.size(); ++s ) {
+		const uint32_t rootIndex = deferred[s].node, base = uint32_t( nodes.size() ) - 1;
+		for( BuildNode &node : subtrees[s] ) {
+			if( node.count == 0 ) {
+				node.left += base;
+				node.right += base;
+			}
+		}
+		nodes[rootIndex] = subtrees[s][0];
+		nodes.insert( nodes.end(), subtrees[s].begin() + 1, subtrees[s].end() );
+	}
+
+	mNodes.clear();
+	if( nodes[0].count ) {
+		// a single leaf still needs a node to hold its bounds
+		Node root;
+		for( int c = 0; c < 4; ++c ) {
+			setChildBounds( &root, c, vec3( std::numeric_limits<float>::max() ), vec3( -std::numeric_limits<float>::max() ) );
+			root.children[c] = 0;
+			root.numTriangles[c] = 0;
+		}
+		setChildBounds( &root, 0, nodes[0].min, nodes[0].max );
+		root.numTriangles[0] = nodes[0].count;
+		mNodes.push_back( root );
+	}
+	else {
+		mNodes.reserve( nodes.size() / 2 );
+		collapse( nodes, 0, &mNodes );
+	}
+
+	mTriangleIds.resize( numTriangles );
+	mIndices.resize( numTriangles * 3 );
+	mVertices.resize( numTriangles * 3 );
+	TaskScheduler::global()->parallelFor( 0, (int64_t)numTriangles, [&]( size_t begin, size_t end ) {
+		for( size_t t = begin; t < end; ++t ) {
+			mTriangleIds[t] = prims[t].id;
+			for( int k = 0; k < 3; ++k ) {
+				mIndices[t * 3 + k] = indices[mTriangleIds[t] * 3 + k];
+				mVertices[t * 3 + k] = positions[mIndices[t * 3 + k]];
+			}
+		}
+	}, 4096, numThreads );
+}
+
+bool TriMeshBvh::calcIntersection( const Ray &ray, Hit *hit, float maxDistance ) const
+{
+	if( mNodes.empty() )
+		return false;
+
+	const RaySlabs slabs( ray );
+	StackEntry stack[STACK_SIZE];
+	size_t stackSize = 1;
+	stack[0] = { 0, 0, 0 };
+	float closest = maxDistance;
+	uint32_t closestTriangle = 0;
+	vec2 closestBarycentric;
+	bool found = false;
+	while( stackSize ) {
+		const StackEntry entry = stack[--stackSize];
+		if( entry.distance > closest )
+			continue;
+
+		if( entry.numTriangles ) {
+			for( uint32_t t = entry.index; t < entry.index + entry.numTriangles; ++t ) {
+				float distance;
+				vec2 barycentric;
+				if( intersectTriangle( slabs.origin, slabs.direction, &mVertices[t * 3], &distance, &barycentric ) && distance >= 0 && distance <= closest ) {
+					closest = distance;
+					closestTriangle = t;
+					closestBarycentric = barycentric;
+					found = true;
+				}
+			}
+		}
+		else {
+			float entries[4];
+			const TriMeshBvh::Node &node = mNodes[entry.index];
+			pushChildren( node, intersectChildren( node, slabs, closest, entries ), entries, stack, &stackSize );
+		}
+	}
+
+	if( found && hit ) {
+		hit->triangle = mTriangleIds[closestTriangle];
+		hit->distance = closest;
+		hit->position = ray.calcPosition( closest );
+		hit->barycentric = closestBarycentric;
+	}
+
+	return found;
+}
+
+bool TriMeshBvh::intersects( const Ray &ray, float maxDistance ) const
+{
+	if( mNodes.empty() )
+		return false;
+
+	const RaySlabs slabs( ray );
+	uint32_t stack[STACK_SIZE];
+	size_t stackSize = 1;
+	stack[0] = 0;
+	while( stackSize ) {
+		const TriMeshBvh::Node &node = mNodes[stack[--stackSize]];
+		float entries[4];
+		const int mask = intersectChildren( node, slabs, maxDistance, entries );
+		for( int c = 0; c < 4; ++c ) {
+			if( ! ( mask & ( 1 << c ) ) )
+				continue;
+			if( node.numTriangles[c] == 0 ) {
+				stack[stackSize++] = node.children[c];
+				continue;
+			}
+			for( uint32_t t = node.children[c]; t < node.children[c] + node.numTriangles[c]; ++t ) {
+				float distance;
+				vec2 barycentric;
+				if( intersectTriangle( slabs.origin, slabs.direction, &mVertices[t * 3], &distance, &barycentric ) && distance >= 0 && distance <= maxDistance )
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void TriMeshBvh::calcOverlaps( const AxisAlignedBox &box, std::vector<uint32_t> *triangles ) const
+{
+	triangles->clear();
+	if( mNodes.empty() )
+		return;
+
+	const vec3 min = box.getMin(), max = box.getMax();
+	uint32_t stack[STACK_SIZE];
+	size_t stackSize = 1;
+	stack[0] = 0;
+	while( stackSize ) {
+		const TriMeshBvh::Node &node = mNodes[stack[--stackSize]];
+		const int mask = overlapChildren( node, min, max );
+		for( int c = 0; c < 4; ++c ) {
+			if( ! ( mask & ( 1 << c ) ) || isUnused( node, c ) )
+				continue;
+			if( node.numTriangles[c] == 0 ) {
+				stack[stackSize++] = node.children[c];
+				continue;
+			}
+			for( uint32_t t = node.children[c]; t < node.children[c] + node.numTriangles[c]; ++t ) {
+				if( triangleOverlapsBox( box.getCenter(), box.getExtents(), &mVertices[t * 3] ) )
+					triangles->push_back( mTriangleIds[t] );
+			}
+		}
+	}
+}
+
+void TriMeshBvh::calcOverlaps( const Sphere &sphere, std::vector<uint32_t> *triangles ) const
+{
+	triangles->clear();
+	if( mNodes.empty() )
+		return;
+
+	const vec3 center = sphere.getCenter();
+	const float radius2 = sphere.getRadius() * sphere.getRadius();
+	uint32_t stack[STACK_SIZE];
+	size_t stackSize = 1;
+	stack[0] = 0;
+	while( stackSize ) {
+		const TriMeshBvh::Node &node = mNodes[stack[--stackSize]];
+		float distances2[4];
+		distanceToChildren( node, center, distances2 );
+		for( int c = 0; c < 4; ++c ) {
+			if( distances2[c] > radius2 || isUnused( node, c ) )
+				continue;
+			if( node.numTriangles[c] == 0 ) {
+				stack[stackSize++] = node.children[c];
+				continue;
+			}
+			for( uint32_t t = node.children[c]; t < node.children[c] + node.numTriangles[c]; ++t ) {
+				vec2 barycentric;
+				if( distance2( closestPointOnTriangle( center, &mVertices[t * 3], &barycentric ), center ) <= radius2 )
+					triangles->push_back( mTriangleIds[t] );
+			}
+		}
+	}
+}
+
+bool TriMeshBvh::calcClosestPoint( const vec3 &point, Hit *hit, float maxDistance ) const
+{
+	if( mNodes.empty() )
+		return false;
+
+	StackEntry stack[STACK_SIZE];
+	size_t stackSize = 1;
+	stack[0] = { 0, 0, 0 };
+	float closest2 = maxDistance < std::sqrt( std::numeric_limits<float>::max() ) ? maxDistance * maxDistance : std::numeric_limits<float>::max();
+	Hit closest = {};
+	bool found = false;
+	while( stackSize ) {
+		const StackEntry entry = stack[--stackSize];
+		if( entry.distance > closest2 )
+			continue;
+
+		if( entry.numTriangles ) {
+			for( uint32_t t = entry.index; t < entry.index + entry.numTriangles; ++t ) {
+				vec2 barycentric;
+				const vec3 p = closestPointOnTriangle( point, &mVertices[t * 3], &barycentric );
+				const float d2 = distance2( p, point );
+				if( d2 <= closest2 ) {
+					closest2 = d2;
+					closest.triangle = mTriangleIds[t];
+					closest.position = p;
+					closest.barycentric = barycentric;
+					found = true;
+				}
+			}
+		}
+		else {
+			const TriMeshBvh::Node &node = mNodes[entry.index];
+			float distances2[4];
+			distanceToChildren( node, point, distances2 );
+			int mask = 0;
+			for( int c = 0; c < 4; ++c )
+				mask |= ( distances2[c] <= closest2 && ! isUnused( node, c ) ) << c;
+			pushChildren( node, mask, distances2, stack, &stackSize );
+		}
+	}
+
+	if( found && hit ) {
+		closest.distance = std::sqrt( closest2 );
+		*hit = closest;
+	}
+
+	return found;
+}
+
+void TriMeshBvh::refit( const TriMesh &mesh, int numThreads )
+{
+	if( mesh.getAttribDims( geom::Attrib::POSITION ) == 3 )
+		refit( mesh.getPositions<3>(), mesh.getNumVertices(), numThreads );
+	else if( ! mNodes.empty() )
+		throw Exception( "TriMeshBvh::refit() error: the mesh doesn't have 3D positions" );
+}
+
+void TriMeshBvh::refit( const vec3 *positions, size_t numPositions, int numThreads )
+{
+	for( uint32_t index : mIndices ) {
+		if( index >= numPositions )
+			throw Exception( "TriMeshBvh::refit() error: index " + std::to_string( index ) + " is out of range" );
+	}
+
+	TaskScheduler::global()->parallelFor( 0, (int64_t)mVertices.size(), [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			mVertices[i] = positions[mIndices[i]];
+	}, 4096, numThreads );
+
+	// leaves first, in parallel, and then the internal children bottom-up; every node comes after its parent
+	TaskScheduler::global()->parallelFor( 0, (int64_t)mNodes.size(), [&]( size_t begin, size_t end ) {
+		for( size_t n = begin; n < end; ++n ) {
+			Node &node = mNodes[n];
+			for( int c = 0; c < 4; ++c ) {
+				if( ! node.numTriangles[c] )
+					continue;
+				vec3 min( std::numeric_limits<float>::max() ), max( -std::numeric_limits<float>::max() );
+				for( uint32_t i = node.children[c] * 3; i < ( node.children[c] + node.numTriangles[c] ) * 3; ++i ) {
+					min = glm::min( min, mVertices[i] );
+					max = glm::max( max, mVertices[i] );
+				}
+				setChildBounds( &node, c, min, max );
+			}
+		}
+	}, 256, numThreads );
+	for( size_t n = mNodes.size(); n-- > 0; ) {
+		Node &node = mNodes[n];
+		for( int c = 0; c < 4; ++c ) {
+			if( node.numTriangles[c] || ! node.children[c] )
+				continue;
+			const Node &child = mNodes[node.children[c]];
+			for( int a = 0; a < 3; ++a ) {
+				node.min[a][c] = std::min( std::min( child.min[a][0], child.min[a][1] ), std::min( child.min[a][2], child.min[a][3] ) );
+				node.max[a][c] = std::max( std::max( child.max[a][0], child.max[a][1] ), std::max( child.max[a][2], child.max[a][3] ) );
+			}
+		}
+	}
+}
+
+AxisAlignedBox TriMeshBvh::getBounds() const
+{
+	if( mNodes.empty() )
+		return AxisAlignedBox();
+
+	vec3 min( std::numeric_limits<float>::max() ), max( -std::numeric_limits<float>::max() );
+	for( int c = 0; c < 4; ++c ) {
+		if( isUnused( mNodes[0], c ) )
+			continue;
+		min = glm::min( min, vec3( mNodes[0].min[0][c], mNodes[0].min[1][c], mNodes[0].min[2][c] ) );
+		max = glm::max( max, vec3( mNodes[0].max[0][c], mNodes[0].max[1][c], mNodes[0].max[2][c] ) );
+	}
+
+	return AxisAlignedBox( min, max );
+}
+
+} // namespace cinder
@@ -0,0 +1,307 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/TriMeshCache.h"
+
+#include <bit>
+#include <cstring>
+#include <zlib.h>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const char		FILE_MAGIC[7] = { 'T', 'r', 'i', 'M', 'e', 's', 'h' };
+const size_t	BLOCK_ALIGNMENT = 64;
+// block id of the indices; attribute blocks use their geom::Attrib
+const uint32_t	INDICES_BLOCK = 0xFFFFFFFF;
+// deflate can't shrink data by more than this, which bounds the size a compressed block can claim to inflate to
+const uint64_t	MAX_COMPRESSION_RATIO = 1032;
+
+enum BlockCompression : uint8_t { COMPRESSION_NONE, COMPRESSION_ZLIB };
+
+struct FileHeader {
+	uint8_t		version;
+	char		magic[7];
+	uint32_t	primitive;
+	uint32_t	numBlocks;
+	uint64_t	numVertices;
+	uint64_t	numIndices;
+	uint8_t		reserved[32];
+};
+
+struct BlockEntry {
+	uint32_t	id;
+	uint8_t		dims;
+	uint8_t		compression;
+	uint16_t	reserved;
+	uint64_t	offset;
+	uint64_t	storedBytes;
+	uint64_t	bytes;
+};
+
+static_assert( sizeof( FileHeader ) == 64 && sizeof( BlockEntry ) == 32, "TriMeshCache file layout must not be padded" );
+
+size_t alignBlock( size_t offset )
+{
+	return ( offset + BLOCK_ALIGNMENT - 1 ) & ~( BLOCK_ALIGNMENT - 1 );
+}
+
+// Captures a geom::Source's attributes and indices as tightly packed arrays
+class TriMeshCacheTarget : public geom::Target {
+  public:
+	TriMeshCacheTarget( const geom::Source &source, const geom::AttribSet &attribs )
+		: mSource( source ), mAttribs( attribs ), mPrimitive( source.getPrimitive() )
+	{}
+
+	uint8_t	getAttribDims( geom::Attrib attr ) const override
+	{
+		return mAttribs.count( attr ) ? mSource.getAttribDims( attr ) : 0;
+	}
+
+	void copyAttrib( geom::Attrib attr, uint8_t dims, size_t strideBytes, const float *srcData, size_t count ) override
+	{
+		if( ! mAttribs.count( attr ) || dims == 0 )
+			return;
+		if( count != mSource.getNumVertices() )
+			throw TriMeshCacheExc( "TriMeshCache::write() error: source provided " + to_string( count ) + " elements of an attribute for " + to_string( mSource.getNumVertices() ) + " vertices." );
+
+		auto &attrib = mAttribData[attr];
+		attrib.first = dims;
+		attrib.second.resize( count * dims );
+		geom::copyData( dims, strideBytes, srcData, count, dims, 0, attrib.second.data() );
+	}
+
+	void copyIndices( geom::Primitive primitive, const uint32_t *source, size_t numIndices, uint8_t /*requiredBytesPerIndex*/ ) override
+	{
+		mPrimitive = primitive;
+		mIndices.assign( source, source + numIndices );
+	}
+
+	const geom::Source			&mSource;
+	const geom::AttribSet		&mAttribs;
+	geom::Primitive				mPrimitive;
+	map<geom::Attrib,pair<uint8_t,vector<float>>>	mAttribData;
+	vector<uint32_t>			mIndices;
+};
+
+// a block on its way to the file, pointing at either the captured data or its compressed form
+struct OutputBlock {
+	BlockEntry			entry;
+	const void			*data;
+	unique_ptr<Bytef[]>	compressed;
+};
+
+void compressBlock( OutputBlock *block, int8_t level )
+{
+	uLongf compressedSize = compressBound( (uLong)block->entry.bytes );
+	unique_ptr<Bytef[]> compressed( new Bytef[compressedSize] );
+	if( compress2( compressed.get(), &compressedSize, (const Bytef*)block->data, (uLong)block->entry.bytes, level ) != Z_OK )
+		throw TriMeshCacheExc( "TriMeshCache::write() error: failed to compress a block." );
+
+	// keep the block uncompressed, and usable in place, unless that saves space
+	if( compressedSize < block->entry.bytes ) {
+		block->entry.compression = COMPRESSION_ZLIB;
+		block->entry.storedBytes = compressedSize;
+		block->compressed = std::move( compressed );
+		block->data = block->compressed.get();
+	}
+}
+
+} // anonymous namespace
+
+void TriMeshCache::write( const DataTargetRef &dataTarget, const geom::Source &source, const Options &options )
+{
+	if constexpr( std::endian::native != std::endian::little )
+		throw TriMeshCacheExc( "TriMeshCache::write() error: only little-endian platforms are supported." );
+
+	geom::AttribSet attribs;
+	for( geom::Attrib attrib : source.getAvailableAttribs() ) {
+		if( attrib < geom::NUM_ATTRIBS && ( options.getAllAttribs() || options.getAttribs().count( attrib ) ) )
+			attribs.insert( attrib );
+	}
+
+	TriMeshCacheTarget target( source, attribs );
+	source.loadInto( &target, attribs );
+	if( target.mIndices.size() > numeric_limits<uint32_t>::max() )
+		throw TriMeshCacheExc( "TriMeshCache::write() error: too many indices." );
+
+	vector<OutputBlock> blocks;
+	blocks.reserve( target.mAttribData.size() + 1 );
+	auto addBlock = [&]( uint32_t id, uint8_t dims, const void *data, size_t bytes ) {
+		blocks.emplace_back();
+		OutputBlock &block = blocks.back();
+		memset( &block.entry, 0, sizeof( BlockEntry ) );
+		block.entry.id = id;
+		block.entry.dims = dims;
+		block.entry.compression = COMPRESSION_NONE;
+		block.entry.storedBytes = block.entry.bytes = bytes;
+		block.data = data;
+		if( options.getCompressionLevel() > 0 && bytes > 0 )
+			compressBlock( &block, options.getCompressionLevel() );
+	};
+
+	if( ! target.mIndices.empty() )
+		addBlock( INDICES_BLOCK, 1, target.mIndices.data(), target.mIndices.size() * sizeof( uint32_t ) );
+	for( auto &attrib : target.mAttribData )
+		addBlock( attrib.first, attrib.second.first, attrib.second.second.data(), attrib.second.second.size() * sizeof( float ) );
+
+	FileHeader header;
+	memset( &header, 0, sizeof( header ) );
+	header.version = VERSION;
+	memcpy( header.magic, FILE_MAGIC, sizeof( FILE_MAGIC ) );
+	header.primitive = (uint32_t)target.mPrimitive;
+	header.numBlocks = (uint32_t)blocks.size();
+	header.numVertices = source.getNumVertices();
+	header.numIndices = target.mIndices.size();
+
+	size_t offset = sizeof( FileHeader ) + blocks.size() * sizeof( BlockEntry );
+	for( auto &block : blocks ) {
+		offset = alignBlock( offset );
+		block.entry.offset = offset;
+		offset += block.entry.storedBytes;
+	}
+
+	OStreamRef out = dataTarget->getStream();
+	out->writeData( &header, sizeof( header ) );
+	for( auto &block : blocks )
+		out->writeData( &block.entry, sizeof( BlockEntry ) );
+
+	const uint8_t padding[BLOCK_ALIGNMENT] = {};
+	offset = sizeof( FileHeader ) + blocks.size() * sizeof( BlockEntry );
+	for( auto &block : blocks ) {
+		// OStream treats writing 0 bytes as a failure
+		if( block.entry.offset > offset )
+			out->writeData( padding, block.entry.offset - offset );
+		if( block.entry.storedBytes > 0 )
+			out->writeData( block.data, block.entry.storedBytes );
+		offset = block.entry.offset + block.entry.storedBytes;
+	}
+}
+
+TriMeshCache::TriMeshCache( const DataSourceRef &dataSource )
+	: mNumVertices( 0 ), mNumIndices( 0 ), mPrimitive( geom::Primitive::TRIANGLES ), mIndices( nullptr )
+{
+	for( size_t a = 0; a < geom::NUM_ATTRIBS; ++a ) {
+		mAttribDims[a] = 0;
+		mAttribData[a] = nullptr;
+	}
+
+	if constexpr( std::endian::native != std::endian::little )
+		throw TriMeshCacheExc( "TriMeshCache error: only little-endian platforms are supported." );
+
+	mBuffer = dataSource->getBuffer();
+	const uint8_t *data = (const uint8_t*)mBuffer->getData();
+	const size_t size = mBuffer->getSize();
+
+	FileHeader header;
+	if( size < sizeof( header ) )
+		throw TriMeshCacheExc( "TriMeshCache error: file is too small." );
+	memcpy( &header, data, sizeof( header ) );
+	if( header.version != VERSION || memcmp( header.magic, FILE_MAGIC, sizeof( FILE_MAGIC ) ) != 0 )
+		throw TriMeshCacheExc( "TriMeshCache error: not a version " + to_string( VERSION ) + " TriMesh file." );
+	if( header.primitive >= (uint32_t)geom::Primitive::NUM_PRIMITIVES )
+		throw TriMeshCacheExc( "TriMeshCache error: invalid primitive." );
+	if( header.numBlocks > ( size - sizeof( header ) ) / sizeof( BlockEntry ) )
+		throw TriMeshCacheExc( "TriMeshCache error: block table exceeds the file." );
+	// every vertex and index takes at least a float in some block, so neither count can exceed what the file inflates to
+	if( header.numVertices > size * MAX_COMPRESSION_RATIO || header.numIndices > size * MAX_COMPRESSION_RATIO )
+		throw TriMeshCacheExc( "TriMeshCache error: mesh size exceeds the file." );
+
+	mPrimitive = (geom::Primitive)header.primitive;
+	mNumVertices = (size_t)header.numVertices;
+	mNumIndices = (size_t)header.numIndices;
+
+	for( uint32_t b = 0; b < header.numBlocks; ++b ) {
+		BlockEntry entry;
+		memcpy( &entry, data + sizeof( header ) + b * sizeof( BlockEntry ), sizeof( entry ) );
+
+		const bool isIndices = entry.id == INDICES_BLOCK;
+		if( ! isIndices && ( entry.id >= geom::NUM_ATTRIBS || entry.dims < 1 || entry.dims > 4 ) )
+			throw TriMeshCacheExc( "TriMeshCache error: invalid attribute block." );
+		if( isIndices ? mIndices != nullptr : mAttribData[entry.id] != nullptr )
+			throw TriMeshCacheExc( "TriMeshCache error: duplicate block." );
+		const uint64_t expectedBytes = isIndices ? header.numIndices * sizeof( uint32_t ) : header.numVertices * entry.dims * sizeof( float );
+		if( entry.bytes != expectedBytes || entry.offset % BLOCK_ALIGNMENT != 0 || entry.offset > size || entry.storedBytes > size - entry.offset )
+			throw TriMeshCacheExc( "TriMeshCache error: block exceeds the file or doesn't match the mesh size." );
+
+		const void *blockData;
+		if( entry.compression == COMPRESSION_NONE ) {
+			if( entry.storedBytes != entry.bytes )
+				throw TriMeshCacheExc( "TriMeshCache error: invalid block size." );
+			blockData = data + entry.offset;
+		}
+		else if( entry.compression == COMPRESSION_ZLIB ) {
+			if( entry.bytes / MAX_COMPRESSION_RATIO > entry.storedBytes )
+				throw TriMeshCacheExc( "TriMeshCache error: invalid compressed block size." );
+			shared_ptr<uint32_t[]> inflated( new uint32_t[entry.bytes / sizeof( uint32_t )] );
+			uLongf inflatedSize = (uLongf)entry.bytes;
+			if( uncompress( (Bytef*)inflated.get(), &inflatedSize, data + entry.offset, (uLong)entry.storedBytes ) != Z_OK || inflatedSize != entry.bytes )
+				throw TriMeshCacheExc( "TriMeshCache error: failed to decompress a block." );
+			blockData = inflated.get();
+			mInflatedBlocks.push_back( std::move( inflated ) );
+		}
+		else
+			throw TriMeshCacheExc( "TriMeshCache error: unknown block compression." );
+
+		if( isIndices )
+			mIndices = (const uint32_t*)blockData;
+		else {
+			mAttribDims[entry.id] = entry.dims;
+			mAttribData[entry.id] = (const float*)blockData;
+		}
+	}
+
+	if( mNumIndices > 0 && ! mIndices )
+		throw TriMeshCacheExc( "TriMeshCache error: missing indices." );
+	for( size_t i = 0; i < mNumIndices; ++i ) {
+		if( mIndices[i] >= mNumVertices )
+			throw TriMeshCacheExc( "TriMeshCache error: index out of range." );
+	}
+}
+
+geom::AttribSet TriMeshCache::getAvailableAttribs() const
+{
+	geom::AttribSet result;
+	for( size_t a = 0; a < geom::NUM_ATTRIBS; ++a ) {
+		if( mAttribData[a] )
+			result.insert( (geom::Attrib)a );
+	}
+
+	return result;
+}
+
+void TriMeshCache::loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const
+{
+	for( geom::Attrib attrib : requestedAttribs ) {
+		if( getAttribData( attrib ) )
+			target->copyAttrib( attrib, mAttribDims[attrib], 0, mAttribData[attrib], mNumVertices );
+	}
+
+	if( mNumIndices > 0 )
+		target->copyIndices( mPrimitive, mIndices, mNumIndices, mNumVertices <= 256 ? 1 : ( mNumVertices <= 65536 ? 2 : 4 ) );
+}
+
+} // namespace cinder
@@ -22,12 +22,165 @@
 */
 
 #include "cinder/ip/Blend.h"
+#include "cinder/ip/ExecutionPolicy.h"
 #include "cinder/ip/Fill.h"
+#include "Simd.h"
+
+#if defined( CINDER_IP_SIMD_X86 )
+	#include <immintrin.h>
+#endif
 
 using namespace std;
 
 namespace cinder { namespace ip {
 
+namespace {
+
+// The SSE2 row kernels below blend as many whole vectors of 4-channel pixels as fit in a row and return the number of pixels they processed,
+// leaving the remainder of the row to the scalar code. They require matching red, green and blue offsets in the foreground and background,
+// and cover the blends whose result is not divided by the background alpha: a background without alpha, or a premultiplied one.
+// With a premultiplied background the scalar formulas reduce to the same color terms as without one, since αd + (1–αd) = 1.
+// The 8-bit kernel produces exactly the same results as the scalar code.
+
+#if defined( CINDER_IP_SIMD_X86 )
+
+// Divides 16-bit lanes holding at most 255 * 255 by 255, truncating exactly like integer division
+CINDER_IP_TARGET_SSE2 inline __m128i div255Sse2( __m128i v )
+{
+	return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( v, _mm_set1_epi16( 1 ) ), _mm_srli_epi16( v, 8 ) ), 8 );
+}
+
+// Replicates the alpha byte of every 4-byte pixel across the whole pixel
+CINDER_IP_TARGET_SSE2 inline __m128i broadcastAlphaSse2( __m128i px, __m128i alphaShift )
+{
+	__m128i alpha = _mm_and_si128( _mm_srl_epi32( px, alphaShift ), _mm_set1_epi32( 0xFF ) );
+	alpha = _mm_or_si128( alpha, _mm_slli_epi32( alpha, 8 ) );
+	return _mm_or_si128( alpha, _mm_slli_epi32( alpha, 16 ) );
+}
+
+CINDER_IP_TARGET_SSE2 inline __m128i selectSse2( __m128i mask, __m128i a, __m128i b )
+{
+	return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+}
+
+// Blends the colors of 8 channels held in 16-bit lanes
+template<bool SRCPREMULT>
+CINDER_IP_TARGET_SSE2 inline __m128i blendColors8Sse2( __m128i src, __m128i dst, __m128i alphaS, __m128i invAlphaS )
+{
+	if( SRCPREMULT ) // the scalar code stores the sum to a uint8_t, which wraps rather than saturates
+		return _mm_and_si128( _mm_add_epi16( div255Sse2( _mm_mullo_epi16( invAlphaS, dst ) ), src ), _mm_set1_epi16( 0xFF ) );
+	else
+		return div255Sse2( _mm_add_epi16( _mm_mullo_epi16( invAlphaS, dst ), _mm_mullo_epi16( alphaS, src ) ) );
+}
+
+template<bool DSTALPHA, bool SRCPREMULT>
+CINDER_IP_TARGET_SSE2 int32_t blendRowSse2( const uint8_t *src, uint8_t *dst, int32_t width, uint8_t alphaOffset )
+{
+	const __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi8( -1 );
+	const __m128i alphaShift = _mm_cvtsi32_si128( alphaOffset * 8 );
+	const __m128i alphaMask = _mm_sll_epi32( _mm_set1_epi32( 0xFF ), alphaShift );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, src += 16, dst += 16 ) {
+		__m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+		__m128i d = _mm_loadu_si128( reinterpret_cast<const __m128i*>( dst ) );
+		__m128i alphaS = broadcastAlphaSse2( s, alphaShift );
+		__m128i invAlphaS = _mm_xor_si128( alphaS, ones );
+		__m128i lo = blendColors8Sse2<SRCPREMULT>( _mm_unpacklo_epi8( s, zero ), _mm_unpacklo_epi8( d, zero ), _mm_unpacklo_epi8( alphaS, zero ), _mm_unpacklo_epi8( invAlphaS, zero ) );
+		__m128i hi = blendColors8Sse2<SRCPREMULT>( _mm_unpackhi_epi8( s, zero ), _mm_unpackhi_epi8( d, zero ), _mm_unpackhi_epi8( alphaS, zero ), _mm_unpackhi_epi8( invAlphaS, zero ) );
+		__m128i result = _mm_packus_epi16( lo, hi );
+		if( DSTALPHA ) {
+			// αr = 1 – [(1–αd)×(1–αs)], and pixels whose resulting alpha is zero keep their color
+			__m128i invAlphaD = _mm_xor_si128( broadcastAlphaSse2( d, alphaShift ), ones );
+			__m128i invAlphaRLo = div255Sse2( _mm_mullo_epi16( _mm_unpacklo_epi8( invAlphaS, zero ), _mm_unpacklo_epi8( invAlphaD, zero ) ) );
+			__m128i invAlphaRHi = div255Sse2( _mm_mullo_epi16( _mm_unpackhi_epi8( invAlphaS, zero ), _mm_unpackhi_epi8( invAlphaD, zero ) ) );
+			__m128i alphaR = _mm_xor_si128( _mm_packus_epi16( invAlphaRLo, invAlphaRHi ), ones );
+			result = selectSse2( _mm_cmpeq_epi8( alphaR, zero ), d, result );
+			result = selectSse2( alphaMask, alphaR, result );
+		}
+		else // leave the unused fourth byte of the background untouched
+			result = selectSse2( alphaMask, d, result );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), result );
+	}
+	return x;
+}
+
+template<int ALPHA, bool DSTALPHA, bool SRCPREMULT>
+CINDER_IP_TARGET_SSE2 int32_t blendRowSse2( const float *src, float *dst, int32_t width )
+{
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 alphaMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? -1 : 0, ALPHA == 1 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 3 ? -1 : 0 ) );
+	for( int32_t x = 0; x < width; ++x, src += 4, dst += 4 ) {
+		__m128 s = _mm_loadu_ps( src ), d = _mm_loadu_ps( dst );
+		__m128 alphaS = _mm_shuffle_ps( s, s, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		__m128 invAlphaS = _mm_sub_ps( one, alphaS );
+		__m128 result;
+		if( DSTALPHA ) { // premult background, written in the same order of operations as the scalar code
+			__m128 alphaD = _mm_shuffle_ps( d, d, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+			__m128 invAlphaD = _mm_sub_ps( one, alphaD );
+			__m128 alphaR = _mm_sub_ps( one, _mm_mul_ps( invAlphaS, invAlphaD ) );
+			if( SRCPREMULT )
+				result = _mm_add_ps( _mm_add_ps( _mm_mul_ps( invAlphaS, d ), _mm_mul_ps( invAlphaD, s ) ), _mm_mul_ps( alphaD, s ) );
+			else
+				result = _mm_add_ps( _mm_add_ps( _mm_mul_ps( invAlphaS, d ), _mm_mul_ps( _mm_mul_ps( invAlphaD, alphaS ), s ) ), _mm_mul_ps( _mm_mul_ps( alphaD, alphaS ), s ) );
+			__m128 keep = _mm_cmpeq_ps( alphaR, _mm_setzero_ps() );
+			result = _mm_or_ps( _mm_and_ps( keep, d ), _mm_andnot_ps( keep, result ) );
+			result = _mm_or_ps( _mm_and_ps( alphaMask, alphaR ), _mm_andnot_ps( alphaMask, result ) );
+		}
+		else {
+			if( SRCPREMULT )
+				result = _mm_add_ps( _mm_mul_ps( invAlphaS, d ), s );
+			else
+				result = _mm_add_ps( _mm_mul_ps( invAlphaS, d ), _mm_mul_ps( alphaS, s ) );
+			result = _mm_or_ps( _mm_and_ps( alphaMask, d ), _mm_andnot_ps( alphaMask, result ) );
+		}
+		_mm_storeu_ps( dst, result );
+	}
+	return width;
+}
+
+#endif
+
+// Returns the number of pixels at the start of the row that were blended with SIMD instructions, which is zero when simd is false
+template<bool DSTALPHA, bool DSTPREMULT, bool SRCPREMULT>
+int32_t blendRowSimd( const uint8_t *src, uint8_t *dst, int32_t width, uint8_t alphaOffset, bool simd )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	if constexpr( ! DSTALPHA || DSTPREMULT ) {
+		if( simd )
+			return blendRowSse2<DSTALPHA, SRCPREMULT>( src, dst, width, alphaOffset );
+	}
+#endif
+	return 0;
+}
+
+template<bool DSTALPHA, bool DSTPREMULT, bool SRCPREMULT>
+int32_t blendRowSimd( const float *src, float *dst, int32_t width, uint8_t alphaOffset, bool simd )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	if constexpr( ! DSTALPHA || DSTPREMULT ) {
+		if( simd ) {
+			switch( alphaOffset ) {
+				case 0: return blendRowSse2<0, DSTALPHA, SRCPREMULT>( src, dst, width );
+				case 1: return blendRowSse2<1, DSTALPHA, SRCPREMULT>( src, dst, width );
+				case 2: return blendRowSse2<2, DSTALPHA, SRCPREMULT>( src, dst, width );
+				default: return blendRowSse2<3, DSTALPHA, SRCPREMULT>( src, dst, width );
+			}
+		}
+	}
+#endif
+	return 0;
+}
+
+// SIMD blending requires 4-channel pixels with the same color channel order in the foreground and background
+template<typename T>
+bool canBlendSimd( const SurfaceT<T> &background, const SurfaceT<T> &foreground )
+{
+	return detail::getSimdLevel() != detail::SimdLevel::NONE && background.getPixelInc() == 4 && foreground.getPixelInc() == 4 && foreground.hasAlpha()
+		&& background.getRedOffset() == foreground.getRedOffset() && background.getGreenOffset() == foreground.getGreenOffset() && background.getBlueOffset() == foreground.getBlueOffset();
+}
+
+} // anonymous namespace
+
 /*	
 	   αr = 1 – [(1–αd)×(1–αs)] = αd+αs–(αd×αs)
 	αr×Cr =  [(1–αs)×αd×Cd]+[(1–αd)×αs×Cs]+[αd×αs×B(Cd,Cs)]			Unpremult * Unpremult
@@ -52,6 +205,7 @@ void blendImpl_u8( Surface8u *background, const Surface8u &foreground, const Are
 	const uint8_t dA = DSTALPHA ? (background->getChannelOrder().getAlphaOffset()) : 0;
 	const uint8_t dstInc = background->getPixelInc();
 	const int32_t width = srcArea.getWidth();
+	const bool simd = canBlendSimd( *background, foreground );
 	
 	if( ! SRCALPHA ) {// normal blend with no src alpha is a copy
 		ivec2 relativeOffset = absOffset - srcArea.getUL();
@@ -61,52 +215,57 @@ void blendImpl_u8( Surface8u *background, const Surface8u &foreground, const Are
 		return;
 	}
 	
-	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
-		const uint8_t *src = reinterpret_cast<const uint8_t*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
-		uint8_t *dst = reinterpret_cast<uint8_t*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * 4 ) + ( y + absOffset.y ) * dstRowBytes );
-		for( int32_t x = 0; x < width; ++x ) {
-			const uint8_t alphaS = (SRCALPHA) ? src[sA] : 255;
-			const uint8_t invAlphaS = (SRCALPHA) ? CHANTRAIT<uint8_t>::inverse(src[sA]) : 0;
-			const uint8_t alphaD = (DSTALPHA) ? dst[dA] : CHANTRAIT<uint8_t>::max();
-			const uint8_t invAlphaD = (DSTALPHA) ? CHANTRAIT<uint8_t>::inverse(dst[dA]) : 0;
-			if( DSTALPHA )
-				dst[dA] = 255 - invAlphaS * invAlphaD / 255;			
-			if( ( ! DSTALPHA ) || dst[dA] ) {
-				if( ! DSTALPHA && ! SRCPREMULT ) { // none * unpremult -> none
-					dst[dR] = ( invAlphaS * dst[dR] + alphaS * src[sR] ) / 255;
-					dst[dG] = ( invAlphaS * dst[dG] + alphaS * src[sG] ) / 255;
-					dst[dB] = ( invAlphaS * dst[dB] + alphaS * src[sB] ) / 255;
-				}			
-				else if( ! DSTALPHA && SRCPREMULT ) { // none * premult -> none
-					dst[dR] = invAlphaS * dst[dR] / 255 + src[sR];
-					dst[dG] = invAlphaS * dst[dG] / 255 + src[sG];
-					dst[dB] = invAlphaS * dst[dB] / 255 + src[sB];
-				}
-				else if( ! DSTPREMULT && ! SRCPREMULT ) { // unpremult * unpremult -> unpremult
-					dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) / ( 255 * dst[dA] );
-					dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) / ( 255 * dst[dA] );
-					dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) / ( 255 * dst[dA] );
-				}
-				else if( ! DSTPREMULT && SRCPREMULT ) { // unpremult * premult -> unpremult
-					dst[dR] = ( invAlphaS * alphaD * dst[dR] / 255 + invAlphaD * src[sR] + alphaD * src[sR] ) / dst[dA];
-					dst[dG] = ( invAlphaS * alphaD * dst[dG] / 255 + invAlphaD * src[sG] + alphaD * src[sG] ) / dst[dA];
-					dst[dB] = ( invAlphaS * alphaD * dst[dB] / 255 + invAlphaD * src[sB] + alphaD * src[sB] ) / dst[dA];
-				}
-				else if( DSTPREMULT && SRCPREMULT ) { // premult * premult -> premult
-					dst[dR] = ( invAlphaS * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR] ) / 255;
-					dst[dG] = ( invAlphaS * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG] ) / 255;
-					dst[dB] = ( invAlphaS * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB] ) / 255;
-				}
-				else if( DSTPREMULT && ! SRCPREMULT ) { // premult * unpremult -> premult
-					dst[dR] = ( invAlphaS * dst[dR] + ( invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) / 255 ) / 255;
-					dst[dG] = ( invAlphaS * dst[dG] + ( invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) / 255 ) / 255;
-					dst[dB] = ( invAlphaS * dst[dB] + ( invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) / 255 ) / 255;
+	detail::parallelBands( 0, srcArea.getHeight(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			const uint8_t *src = reinterpret_cast<const uint8_t*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
+			uint8_t *dst = reinterpret_cast<uint8_t*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * 4 ) + ( y + absOffset.y ) * dstRowBytes );
+			const int32_t simdWidth = blendRowSimd<DSTALPHA, DSTPREMULT, SRCPREMULT>( src, dst, width, sA, simd );
+			src += simdWidth * srcInc;
+			dst += simdWidth * dstInc;
+			for( int32_t x = simdWidth; x < width; ++x ) {
+				const uint8_t alphaS = (SRCALPHA) ? src[sA] : 255;
+				const uint8_t invAlphaS = (SRCALPHA) ? CHANTRAIT<uint8_t>::inverse(src[sA]) : 0;
+				const uint8_t alphaD = (DSTALPHA) ? dst[dA] : CHANTRAIT<uint8_t>::max();
+				const uint8_t invAlphaD = (DSTALPHA) ? CHANTRAIT<uint8_t>::inverse(dst[dA]) : 0;
+				if( DSTALPHA )
+					dst[dA] = 255 - invAlphaS * invAlphaD / 255;			
+				if( ( ! DSTALPHA ) || dst[dA] ) {
+					if( ! DSTALPHA && ! SRCPREMULT ) { // none * unpremult -> none
+						dst[dR] = ( invAlphaS * dst[dR] + alphaS * src[sR] ) / 255;
+						dst[dG] = ( invAlphaS * dst[dG] + alphaS * src[sG] ) / 255;
+						dst[dB] = ( invAlphaS * dst[dB] + alphaS * src[sB] ) / 255;
+					}			
+					else if( ! DSTALPHA && SRCPREMULT ) { // none * premult -> none
+						dst[dR] = invAlphaS * dst[dR] / 255 + src[sR];
+						dst[dG] = invAlphaS * dst[dG] / 255 + src[sG];
+						dst[dB] = invAlphaS * dst[dB] / 255 + src[sB];
+					}
+					else if( ! DSTPREMULT && ! SRCPREMULT ) { // unpremult * unpremult -> unpremult
+						dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) / ( 255 * dst[dA] );
+						dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) / ( 255 * dst[dA] );
+						dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) / ( 255 * dst[dA] );
+					}
+					else if( ! DSTPREMULT && SRCPREMULT ) { // unpremult * premult -> unpremult
+						dst[dR] = ( invAlphaS * alphaD * dst[dR] / 255 + invAlphaD * src[sR] + alphaD * src[sR] ) / dst[dA];
+						dst[dG] = ( invAlphaS * alphaD * dst[dG] / 255 + invAlphaD * src[sG] + alphaD * src[sG] ) / dst[dA];
+						dst[dB] = ( invAlphaS * alphaD * dst[dB] / 255 + invAlphaD * src[sB] + alphaD * src[sB] ) / dst[dA];
+					}
+					else if( DSTPREMULT && SRCPREMULT ) { // premult * premult -> premult
+						dst[dR] = ( invAlphaS * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR] ) / 255;
+						dst[dG] = ( invAlphaS * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG] ) / 255;
+						dst[dB] = ( invAlphaS * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB] ) / 255;
+					}
+					else if( DSTPREMULT && ! SRCPREMULT ) { // premult * unpremult -> premult
+						dst[dR] = ( invAlphaS * dst[dR] + ( invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) / 255 ) / 255;
+						dst[dG] = ( invAlphaS * dst[dG] + ( invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) / 255 ) / 255;
+						dst[dB] = ( invAlphaS * dst[dB] + ( invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) / 255 ) / 255;
+					}
 				}
+				src += srcInc;
+				dst += dstInc;
 			}
-			src += srcInc;
-			dst += dstInc;
 		}
-	}
+	} );
 }
 
 template<bool DSTALPHA, bool DSTPREMULT, bool SRCPREMULT>
@@ -126,6 +285,7 @@ void blendImpl_float( Surface32f *background, const Surface32f &foreground, cons
 	const uint8_t dA = DSTALPHA ? (background->getChannelOrder().getAlphaOffset()) : 0;
 	const uint8_t dstInc = background->getPixelInc();	
 	const int32_t width = srcArea.getWidth();
+	const bool simd = canBlendSimd( *background, foreground );
 	
 	if( ! SRCALPHA ) {// normal blend with no src alpha is a copy
 		ivec2 relativeOffset = absOffset - srcArea.getUL();
@@ -135,54 +295,59 @@ void blendImpl_float( Surface32f *background, const Surface32f &foreground, cons
 		return;
 	}
 	
-	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
-		const float *src = reinterpret_cast<const float*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
-		float *dst = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * 4 ) + ( y + absOffset.y ) * dstRowBytes );
-		for( int32_t x = 0; x < width; ++x ) {
-			const float alphaS = (SRCALPHA) ? src[sA] : 1;
-			const float invAlphaS = (SRCALPHA) ? CHANTRAIT<float>::inverse(src[sA]) : 0;
-			const float alphaD = (DSTALPHA) ? dst[dA] : CHANTRAIT<float>::max();
-			const float invAlphaD = (DSTALPHA) ? CHANTRAIT<float>::inverse(dst[dA]) : 0;
-			if( DSTALPHA )
-				dst[dA] = 1 - invAlphaS * invAlphaD;
-			if( ( ! DSTALPHA ) || dst[dA] ) {
-				if( ! DSTALPHA && ! SRCPREMULT ) { // none * unpremult -> none
-					dst[dR] = invAlphaS * dst[dR] + alphaS * src[sR];
-					dst[dG] = invAlphaS * dst[dG] + alphaS * src[sG];
-					dst[dB] = invAlphaS * dst[dB] + alphaS * src[sB];
-				}			
-				else if( ! DSTALPHA && SRCPREMULT ) { // none * premult -> none
-					dst[dR] = invAlphaS * dst[dR] + src[sR];
-					dst[dG] = invAlphaS * dst[dG] + src[sG];
-					dst[dB] = invAlphaS * dst[dB] + src[sB];
-				}
-				else if( ! DSTPREMULT && ! SRCPREMULT ) { // unpremult * unpremult -> unpremult
-					float invDstA = 1.0f / dst[dA];
-					dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) * invDstA;
-					dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) * invDstA;
-					dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) * invDstA;
-				}
-				else if( ! DSTPREMULT && SRCPREMULT ) { // unpremult * premult -> unpremult
-					float invDstA = 1.0f / dst[dA];
-					dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR] ) * invDstA;
-					dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG] ) * invDstA;
-					dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB] ) * invDstA;
-				}
-				else if( DSTPREMULT && SRCPREMULT ) { // premult * premult -> premult
-					dst[dR] = invAlphaS * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR];
-					dst[dG] = invAlphaS * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG];
-					dst[dB] = invAlphaS * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB];
-				}
-				else if( DSTPREMULT && ! SRCPREMULT ) { // premult * unpremult -> premult
-					dst[dR] = invAlphaS * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR];
-					dst[dG] = invAlphaS * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG];
-					dst[dB] = invAlphaS * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB];
+	detail::parallelBands( 0, srcArea.getHeight(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			const float *src = reinterpret_cast<const float*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
+			float *dst = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * 4 ) + ( y + absOffset.y ) * dstRowBytes );
+			const int32_t simdWidth = blendRowSimd<DSTALPHA, DSTPREMULT, SRCPREMULT>( src, dst, width, sA, simd );
+			src += simdWidth * srcInc;
+			dst += simdWidth * dstInc;
+			for( int32_t x = simdWidth; x < width; ++x ) {
+				const float alphaS = (SRCALPHA) ? src[sA] : 1;
+				const float invAlphaS = (SRCALPHA) ? CHANTRAIT<float>::inverse(src[sA]) : 0;
+				const float alphaD = (DSTALPHA) ? dst[dA] : CHANTRAIT<float>::max();
+				const float invAlphaD = (DSTALPHA) ? CHANTRAIT<float>::inverse(dst[dA]) : 0;
+				if( DSTALPHA )
+					dst[dA] = 1 - invAlphaS * invAlphaD;
+				if( ( ! DSTALPHA ) || dst[dA] ) {
+					if( ! DSTALPHA && ! SRCPREMULT ) { // none * unpremult -> none
+						dst[dR] = invAlphaS * dst[dR] + alphaS * src[sR];
+						dst[dG] = invAlphaS * dst[dG] + alphaS * src[sG];
+						dst[dB] = invAlphaS * dst[dB] + alphaS * src[sB];
+					}			
+					else if( ! DSTALPHA && SRCPREMULT ) { // none * premult -> none
+						dst[dR] = invAlphaS * dst[dR] + src[sR];
+						dst[dG] = invAlphaS * dst[dG] + src[sG];
+						dst[dB] = invAlphaS * dst[dB] + src[sB];
+					}
+					else if( ! DSTPREMULT && ! SRCPREMULT ) { // unpremult * unpremult -> unpremult
+						float invDstA = 1.0f / dst[dA];
+						dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) * invDstA;
+						dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) * invDstA;
+						dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) * invDstA;
+					}
+					else if( ! DSTPREMULT && SRCPREMULT ) { // unpremult * premult -> unpremult
+						float invDstA = 1.0f / dst[dA];
+						dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR] ) * invDstA;
+						dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG] ) * invDstA;
+						dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB] ) * invDstA;
+					}
+					else if( DSTPREMULT && SRCPREMULT ) { // premult * premult -> premult
+						dst[dR] = invAlphaS * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR];
+						dst[dG] = invAlphaS * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG];
+						dst[dB] = invAlphaS * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB];
+					}
+					else if( DSTPREMULT && ! SRCPREMULT ) { // premult * unpremult -> premult
+						dst[dR] = invAlphaS * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR];
+						dst[dG] = invAlphaS * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG];
+						dst[dB] = invAlphaS * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB];
+					}
 				}
+				src += srcInc;
+				dst += dstInc;
 			}
-			src += srcInc;
-			dst += dstInc;
 		}
-	}
+	} );
 }
 
 void blend( Surface8u *background, const Surface8u &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset )
@@ -21,6 +21,11 @@
 */
 
 #include "cinder/ip/Blur.h"
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/ChanTraits.h"
+
+#include <cmath>
+#include <vector>
 
 namespace cinder { namespace ip { 
 
@@ -54,6 +59,8 @@ uint8_t getPixelDataOffset( const ChannelT<T> & /*surface*/ )
 
 // Core implementation of stackBlur algorithm due to Mario Klingemann.
 // http://incubator.quasimondo.com/processing/fast_blur_deluxe.php
+// The horizontal pass blurs rows into a temporary buffer and the vertical pass blurs its columns into the destination.
+// Each pass is split into bands of rows (resp. columns) which carry their own stack, so bands can run concurrently.
 template<typename T, typename SUMT, typename IMAGET, uint8_t CHANNELS>
 void stackBlur_impl( const IMAGET &srcSurface, IMAGET *dstSurface, const Area &area, int radius )
 {
@@ -75,139 +82,341 @@ void stackBlur_impl( const IMAGET &srcSurface, IMAGET *dstSurface, const Area &a
 	srcPixelData += getPixelDataOffset( srcSurface );
 	dstPixelData += getPixelDataOffset( *dstSurface );
 
-	std::unique_ptr<SUMT[]> stack( new SUMT[div*CHANNELS] );
 	SUMT *tempPixelData = (SUMT*)malloc(width * height * sizeof(SUMT) * CHANNELS);
 	SUMT *channelData = tempPixelData;
 
-	SUMT *sir;
-	SUMT inSum[CHANNELS], outSum[CHANNELS], sum[CHANNELS];
-	int32_t p, yp;
-	int stackPointer, rbs;
-    
-	int yi = 0;
-	for( int32_t y = 0; y < height; y++ ) {
-		for( int c = 0; c < CHANNELS; ++c )
-			inSum[c] = outSum[c] = sum[c] = 0;
-		
-		for( int32_t i = -radius;i <= radius; i++ ) {
-			sir = &stack[(i + radius)*CHANNELS];
-			size_t offset = y * srcRowInc + std::min(widthMinusOne, std::max(i, 0)) * srcPixelInc;
-			rbs = radiusPlusOne - abs(i);
+	detail::parallelBands( 0, height, [&]( int32_t y1, int32_t y2 ) {
+		std::unique_ptr<SUMT[]> stack( new SUMT[div*CHANNELS] );
+		SUMT *sir;
+		SUMT inSum[CHANNELS], outSum[CHANNELS], sum[CHANNELS];
+		int stackPointer, rbs;
+
+		int yi = y1 * width;
+		for( int32_t y = y1; y < y2; y++ ) {
 			for( int c = 0; c < CHANNELS; ++c )
-				sir[c] = srcPixelData[offset + c];
+				inSum[c] = outSum[c] = sum[c] = 0;
 		
-			for( int c = 0; c < CHANNELS; ++c )
-				sum[c] += sir[c] * rbs;
-			if( i > 0 )
+			for( int32_t i = -radius;i <= radius; i++ ) {
+				sir = &stack[(i + radius)*CHANNELS];
+				size_t offset = y * srcRowInc + std::min(widthMinusOne, std::max(i, 0)) * srcPixelInc;
+				rbs = radiusPlusOne - abs(i);
 				for( int c = 0; c < CHANNELS; ++c )
-					inSum[c] += sir[c];
-			else
-				for( int c = 0; c < CHANNELS; ++c )
-					outSum[c] += sir[c];
-		}
-		stackPointer = radius;
+					sir[c] = srcPixelData[offset + c];
 		
-		for( int32_t x = 0; x < width; x++ ) {
-			for( int c = 0; c < CHANNELS; ++c ) {
-				if( std::is_integral<SUMT>::value )
-					channelData[c+yi*CHANNELS] = sum[c] / divisor;
+				for( int c = 0; c < CHANNELS; ++c )
+					sum[c] += sir[c] * rbs;
+				if( i > 0 )
+					for( int c = 0; c < CHANNELS; ++c )
+						inSum[c] += sir[c];
 				else
-					channelData[c+yi*CHANNELS] = sum[c] * invDivisor;
-				sum[c] -= outSum[c];
+					for( int c = 0; c < CHANNELS; ++c )
+						outSum[c] += sir[c];
 			}
+			stackPointer = radius;
+		
+			for( int32_t x = 0; x < width; x++ ) {
+				for( int c = 0; c < CHANNELS; ++c ) {
+					if( std::is_integral<SUMT>::value )
+						channelData[c+yi*CHANNELS] = sum[c] / divisor;
+					else
+						channelData[c+yi*CHANNELS] = sum[c] * invDivisor;
+					sum[c] -= outSum[c];
+				}
 			
-			int stackStart = stackPointer - radius + div;
-			sir = &stack[(stackStart % div)*CHANNELS];
+				int stackStart = stackPointer - radius + div;
+				sir = &stack[(stackStart % div)*CHANNELS];
 			
-			for( int c = 0; c < CHANNELS; ++c )
-				outSum[c] -= sir[c];
+				for( int c = 0; c < CHANNELS; ++c )
+					outSum[c] -= sir[c];
 			
-			size_t offset = y * srcRowInc + std::min(x + radius + 1, widthMinusOne) * srcPixelInc;
-			for( int c = 0; c < CHANNELS; ++c ) {
-				sir[c] = srcPixelData[offset+c];
-				inSum[c] += sir[c];
-				sum[c] += inSum[c];
-			}
+				size_t offset = y * srcRowInc + std::min(x + radius + 1, widthMinusOne) * srcPixelInc;
+				for( int c = 0; c < CHANNELS; ++c ) {
+					sir[c] = srcPixelData[offset+c];
+					inSum[c] += sir[c];
+					sum[c] += inSum[c];
+				}
 			
-			stackPointer = (stackPointer + 1) % div;
-			sir = &stack[stackPointer*CHANNELS];
+				stackPointer = (stackPointer + 1) % div;
+				sir = &stack[stackPointer*CHANNELS];
 
-			for( int c = 0; c < CHANNELS; ++c ) {
-				outSum[c] += sir[c];
-				inSum[c] -= sir[c];
-			}
+				for( int c = 0; c < CHANNELS; ++c ) {
+					outSum[c] += sir[c];
+					inSum[c] -= sir[c];
+				}
 			
-			yi++;
+				yi++;
+			}
 		}
-	}
-    
-	for( int32_t x = 0; x < width; x++ ) {
-		for( int c = 0; c < CHANNELS; ++c )
-			inSum[c] = outSum[c] = sum[c] = 0;
+	} );
 
-		yp = -radius * width;
-		for( int i = -radius; i <= radius; i++ ) {
-			yi = std::max(0, yp) + x;
-			
-			sir = &stack[(i + radius)*CHANNELS];
-			
+	detail::parallelBands( 0, width, [&]( int32_t x1, int32_t x2 ) {
+		std::unique_ptr<SUMT[]> stack( new SUMT[div*CHANNELS] );
+		SUMT *sir;
+		SUMT inSum[CHANNELS], outSum[CHANNELS], sum[CHANNELS];
+		int32_t p, yp;
+		int stackPointer, rbs;
+		int yi;
+
+		for( int32_t x = x1; x < x2; x++ ) {
 			for( int c = 0; c < CHANNELS; ++c )
-				sir[c] = channelData[c+yi*CHANNELS];
-			
-			rbs = radiusPlusOne - abs(i);
+				inSum[c] = outSum[c] = sum[c] = 0;
+
+			yp = -radius * width;
+			for( int i = -radius; i <= radius; i++ ) {
+				yi = std::max(0, yp) + x;
 			
-			for( int c = 0; c < CHANNELS; ++c )
-				sum[c] += channelData[c+yi*CHANNELS] * rbs;
+				sir = &stack[(i + radius)*CHANNELS];
 			
-			if( i > 0 )
 				for( int c = 0; c < CHANNELS; ++c )
-					inSum[c] += sir[c];
-			else
+					sir[c] = channelData[c+yi*CHANNELS];
+			
+				rbs = radiusPlusOne - abs(i);
+			
 				for( int c = 0; c < CHANNELS; ++c )
-					outSum[c] += sir[c];
+					sum[c] += channelData[c+yi*CHANNELS] * rbs;
 			
-			if( i < heightMinusOne )
-				yp += width;
-		}
-		size_t offset = x * dstPixelInc;
-		stackPointer = radius;
-		for( int32_t y = 0; y < height; y++) {
-			for( int c = 0; c < CHANNELS; ++c ) {
-				if( std::is_integral<SUMT>::value )
-					dstPixelData[offset + c] = (T)(sum[c] / divisor);
+				if( i > 0 )
+					for( int c = 0; c < CHANNELS; ++c )
+						inSum[c] += sir[c];
 				else
-					dstPixelData[offset + c] = (T)(sum[c] * invDivisor);
-				sum[c] -= outSum[c];
+					for( int c = 0; c < CHANNELS; ++c )
+						outSum[c] += sir[c];
+			
+				if( i < heightMinusOne )
+					yp += width;
 			}
+			size_t offset = x * dstPixelInc;
+			stackPointer = radius;
+			for( int32_t y = 0; y < height; y++) {
+				for( int c = 0; c < CHANNELS; ++c ) {
+					if( std::is_integral<SUMT>::value )
+						dstPixelData[offset + c] = (T)(sum[c] / divisor);
+					else
+						dstPixelData[offset + c] = (T)(sum[c] * invDivisor);
+					sum[c] -= outSum[c];
+				}
 			
-			int stackStart = stackPointer - radius + div;
-			sir = &stack[(stackStart % div)*CHANNELS];
+				int stackStart = stackPointer - radius + div;
+				sir = &stack[(stackStart % div)*CHANNELS];
 			
-			for( int c = 0; c < CHANNELS; ++c )
-				outSum[c] -= sir[c];
+				for( int c = 0; c < CHANNELS; ++c )
+					outSum[c] -= sir[c];
 			
-			p = x + std::min( y + radiusPlusOne, heightMinusOne ) * width;
+				p = x + std::min( y + radiusPlusOne, heightMinusOne ) * width;
 			
-			for( int c = 0; c < CHANNELS; ++c ) {
-				sir[c] = channelData[c+p*CHANNELS];
-				inSum[c] += sir[c];
-				sum[c] += inSum[c];
-			}
+				for( int c = 0; c < CHANNELS; ++c ) {
+					sir[c] = channelData[c+p*CHANNELS];
+					inSum[c] += sir[c];
+					sum[c] += inSum[c];
+				}
 			
-			stackPointer = (stackPointer + 1) % div;
-			sir = &stack[stackPointer*CHANNELS];
-
-			for( int c = 0; c < CHANNELS; ++c ) {
-				outSum[c] += sir[c];
-				inSum[c] -= sir[c];
-			}			
-			offset += dstRowInc;
+				stackPointer = (stackPointer + 1) % div;
+				sir = &stack[stackPointer*CHANNELS];
+
+				for( int c = 0; c < CHANNELS; ++c ) {
+					outSum[c] += sir[c];
+					inSum[c] -= sir[c];
+				}			
+				offset += dstRowInc;
+			}
 		}
-	}
+	} );
 
 	free( tempPixelData );
 }
 
+// An extended box filter covers mRadius samples to either side of the center fully and the next sample on each side with weight mFraction.
+// See Gwosdek et al., "Theoretical Foundations of Gaussian Convolution by Extended Box Filtering", SSVM 2011.
+struct BoxPass {
+	int32_t		mRadius;
+	float		mFraction;
+};
+
+BoxPass boxPassFromRadius( float radius )
+{
+	BoxPass result;
+	result.mRadius = (int32_t)radius;
+	result.mFraction = radius - result.mRadius;
+	return result;
+}
+
+// Returns the extended box filter whose variance is one third of sigma^2, so that three successive passes have the variance of the Gaussian
+BoxPass boxPassFromSigma( float sigma )
+{
+	const double variance = (double)sigma * sigma / 3;
+	BoxPass result;
+	result.mRadius = (int32_t)std::floor( 0.5 * std::sqrt( 12 * variance + 1 ) - 0.5 );
+	const double l = result.mRadius;
+	result.mFraction = (float)( ( 2 * l + 1 ) * ( l * ( l + 1 ) - 3 * variance ) / ( 6 * ( variance - ( l + 1 ) * ( l + 1 ) ) ) );
+	return result;
+}
+
+// Filters a line of interleaved CHANNELS-channel pixels, clamping at both ends, with a running sum so the cost per pixel is independent of the radius
+template<uint8_t CHANNELS>
+void boxBlurLine( const float *src, float *dst, int32_t length, const BoxPass &pass )
+{
+	const int32_t radius = pass.mRadius;
+	const int32_t last = length - 1;
+	const double norm = 1.0 / ( 2 * radius + 1 + 2 * pass.mFraction );
+	auto sample = [=]( int32_t i ) { return src + std::min( std::max( i, 0 ), last ) * CHANNELS; };
+
+	// the window around the first pixel, where every sample beyond either end is a copy of the end sample
+	double sum[CHANNELS];
+	for( int c = 0; c < CHANNELS; ++c )
+		sum[c] = radius * (double)src[c] + std::max( 0, radius - last ) * (double)src[last * CHANNELS + c];
+	for( int32_t i = 0; i <= std::min( radius, last ); ++i ) {
+		for( int c = 0; c < CHANNELS; ++c )
+			sum[c] += src[i * CHANNELS + c];
+	}
+
+	for( int32_t x = 0; x < length; ++x ) {
+		const float *before = sample( x - radius - 1 ), *after = sample( x + radius + 1 ), *first = sample( x - radius );
+		for( int c = 0; c < CHANNELS; ++c ) {
+			dst[x * CHANNELS + c] = (float)( ( sum[c] + pass.mFraction * ( (double)before[c] + after[c] ) ) * norm );
+			sum[c] += (double)after[c] - first[c];
+		}
+	}
+}
+
+// Applies each of the passes to \a line in turn, using \a scratch as the ping-pong buffer. The result is left in \a line.
+template<uint8_t CHANNELS>
+void boxBlurLine( float *line, float *scratch, int32_t length, const std::vector<BoxPass> &passes )
+{
+	float *src = line, *dst = scratch;
+	for( const auto &pass : passes ) {
+		boxBlurLine<CHANNELS>( src, dst, length, pass );
+		std::swap( src, dst );
+	}
+	if( src != line )
+		std::copy( src, src + length * CHANNELS, line );
+}
+
+template<typename T>
+T fromFloat( float value )
+{
+	if( std::is_integral<T>::value )
+		return (T)std::min<float>( value + 0.5f, CHANTRAIT<T>::max() );
+	else
+		return (T)value;
+}
+
+// The rows are filtered into a float buffer, whose columns are then filtered into the destination. Columns are copied in blocks into
+// contiguous lines, so the vertical passes read memory sequentially rather than striding down the rows.
+template<typename T, typename IMAGET, uint8_t CHANNELS>
+void boxBlur_impl( const IMAGET &srcImage, IMAGET *dstImage, const Area &area, const std::vector<BoxPass> &passes )
+{
+	const int32_t kBlockColumns = 16;
+	const int32_t width = area.getWidth();
+	const int32_t height = area.getHeight();
+	if( width <= 0 || height <= 0 )
+		return;
+
+	const uint8_t srcPixelInc = getPixelIncrement( srcImage );
+	const uint8_t dstPixelInc = getPixelIncrement( *dstImage );
+	const ptrdiff_t srcRowInc = srcImage.getRowBytes() / sizeof(T);
+	const ptrdiff_t dstRowInc = dstImage->getRowBytes() / sizeof(T);
+	const T *srcPixelData = srcImage.getData( area.getUL() ) + getPixelDataOffset( srcImage );
+	T *dstPixelData = dstImage->getData( area.getUL() ) + getPixelDataOffset( *dstImage );
+
+	std::unique_ptr<float[]> tempPixelData( new float[(size_t)width * height * CHANNELS] );
+
+	detail::parallelBands( 0, height, [&]( int32_t y1, int32_t y2 ) {
+		std::unique_ptr<float[]> line( new float[width * CHANNELS * 2] );
+		for( int32_t y = y1; y < y2; ++y ) {
+			const T *src = srcPixelData + y * srcRowInc;
+			for( int32_t x = 0; x < width; ++x ) {
+				for( int c = 0; c < CHANNELS; ++c )
+					line[x * CHANNELS + c] = src[x * srcPixelInc + c];
+			}
+			boxBlurLine<CHANNELS>( line.get(), line.get() + width * CHANNELS, width, passes );
+			std::copy( line.get(), line.get() + width * CHANNELS, &tempPixelData[(size_t)y * width * CHANNELS] );
+		}
+	} );
+
+	detail::parallelBands( 0, width, [&]( int32_t x1, int32_t x2 ) {
+		std::unique_ptr<float[]> block( new float[(size_t)kBlockColumns * height * CHANNELS] );
+		std::unique_ptr<float[]> scratch( new float[(size_t)height * CHANNELS] );
+		for( int32_t blockX = x1; blockX < x2; blockX += kBlockColumns ) {
+			const int32_t blockWidth = std::min( kBlockColumns, x2 - blockX );
+			for( int32_t y = 0; y < height; ++y ) {
+				const float *row = &tempPixelData[( (size_t)y * width + blockX ) * CHANNELS];
+				for( int32_t i = 0; i < blockWidth; ++i ) {
+					for( int c = 0; c < CHANNELS; ++c )
+						block[( (size_t)i * height + y ) * CHANNELS + c] = row[i * CHANNELS + c];
+				}
+			}
+
+			for( int32_t i = 0; i < blockWidth; ++i )
+				boxBlurLine<CHANNELS>( &block[(size_t)i * height * CHANNELS], scratch.get(), height, passes );
+
+			for( int32_t y = 0; y < height; ++y ) {
+				T *dst = dstPixelData + y * dstRowInc + blockX * dstPixelInc;
+				for( int32_t i = 0; i < blockWidth; ++i ) {
+					for( int c = 0; c < CHANNELS; ++c )
+						dst[i * dstPixelInc + c] = fromFloat<T>( block[( (size_t)i * height + y ) * CHANNELS + c] );
+				}
+			}
+		}
+	} );
+}
+
+template<typename T>
+void boxBlur_impl( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const Area &area, const std::vector<BoxPass> &passes )
+{
+	if( srcSurface.hasAlpha() )
+		boxBlur_impl<T,SurfaceT<T>,4>( srcSurface, dstSurface, area, passes );
+	else
+		boxBlur_impl<T,SurfaceT<T>,3>( srcSurface, dstSurface, area, passes );
+}
+
+template<typename T>
+void boxBlur_impl( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const Area &area, const std::vector<BoxPass> &passes )
+{
+	boxBlur_impl<T,ChannelT<T>,1>( srcChannel, dstChannel, area, passes );
+}
+
+template<typename IMAGET>
+void boxBlur_impl( IMAGET *image, const Area &area, float radius )
+{
+	if( radius <= 0 )
+		return;
+
+	boxBlur_impl( *image, image, area.getClipBy( image->getBounds() ), { boxPassFromRadius( radius ) } );
+}
+
+template<typename IMAGET>
+IMAGET boxBlurCopy_impl( const IMAGET &image, float radius )
+{
+	if( radius <= 0 )
+		return image.clone();
+
+	IMAGET result = image.clone( false );
+	boxBlur_impl( image, &result, image.getBounds(), { boxPassFromRadius( radius ) } );
+	return result;
+}
+
+template<typename IMAGET>
+void gaussianBlur_impl( IMAGET *image, const Area &area, float sigma )
+{
+	if( sigma <= 0 )
+		return;
+
+	const BoxPass pass = boxPassFromSigma( sigma );
+	boxBlur_impl( *image, image, area.getClipBy( image->getBounds() ), { pass, pass, pass } );
+}
+
+template<typename IMAGET>
+IMAGET gaussianBlurCopy_impl( const IMAGET &image, float sigma )
+{
+	if( sigma <= 0 )
+		return image.clone();
+
+	const BoxPass pass = boxPassFromSigma( sigma );
+	IMAGET result = image.clone( false );
+	boxBlur_impl( image, &result, image.getBounds(), { pass, pass, pass } );
+	return result;
+}
+
 } // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////////
@@ -405,4 +614,96 @@ Channel32f stackBlurCopy( const Channel32f &channel, int radius )
 	return result;
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+// boxBlur / gaussianBlur
+template<typename T>
+void boxBlur( SurfaceT<T> *surface, float radius )
+{
+	boxBlur_impl( surface, surface->getBounds(), radius );
+}
+
+template<typename T>
+void boxBlur( SurfaceT<T> *surface, const Area &area, float radius )
+{
+	boxBlur_impl( surface, area, radius );
+}
+
+template<typename T>
+SurfaceT<T> boxBlurCopy( const SurfaceT<T> &surface, float radius )
+{
+	return boxBlurCopy_impl( surface, radius );
+}
+
+template<typename T>
+void boxBlur( ChannelT<T> *channel, float radius )
+{
+	boxBlur_impl( channel, channel->getBounds(), radius );
+}
+
+template<typename T>
+void boxBlur( ChannelT<T> *channel, const Area &area, float radius )
+{
+	boxBlur_impl( channel, area, radius );
+}
+
+template<typename T>
+ChannelT<T> boxBlurCopy( const ChannelT<T> &channel, float radius )
+{
+	return boxBlurCopy_impl( channel, radius );
+}
+
+template<typename T>
+void gaussianBlur( SurfaceT<T> *surface, float sigma )
+{
+	gaussianBlur_impl( surface, surface->getBounds(), sigma );
+}
+
+template<typename T>
+void gaussianBlur( SurfaceT<T> *surface, const Area &area, float sigma )
+{
+	gaussianBlur_impl( surface, area, sigma );
+}
+
+template<typename T>
+SurfaceT<T> gaussianBlurCopy( const SurfaceT<T> &surface, float sigma )
+{
+	return gaussianBlurCopy_impl( surface, sigma );
+}
+
+template<typename T>
+void gaussianBlur( ChannelT<T> *channel, float sigma )
+{
+	gaussianBlur_impl( channel, channel->getBounds(), sigma );
+}
+
+template<typename T>
+void gaussianBlur( ChannelT<T> *channel, const Area &area, float sigma )
+{
+	gaussianBlur_impl( channel, area, sigma );
+}
+
+template<typename T>
+ChannelT<T> gaussianBlurCopy( const ChannelT<T> &channel, float sigma )
+{
+	return gaussianBlurCopy_impl( channel, sigma );
+}
+
+#define boxBlur_PROTOTYPES(T)\
+	template CI_API void boxBlur( SurfaceT<T> *surface, float radius ); \
+	template CI_API void boxBlur( SurfaceT<T> *surface, const Area &area, float radius ); \
+	template CI_API SurfaceT<T> boxBlurCopy( const SurfaceT<T> &surface, float radius ); \
+	template CI_API void boxBlur( ChannelT<T> *channel, float radius ); \
+	template CI_API void boxBlur( ChannelT<T> *channel, const Area &area, float radius ); \
+	template CI_API ChannelT<T> boxBlurCopy( const ChannelT<T> &channel, float radius ); \
+	template CI_API void gaussianBlur( SurfaceT<T> *surface, float sigma ); \
+	template CI_API void gaussianBlur( SurfaceT<T> *surface, const Area &area, float sigma ); \
+	template CI_API SurfaceT<T> gaussianBlurCopy( const SurfaceT<T> &surface, float sigma ); \
+	template CI_API void gaussianBlur( ChannelT<T> *channel, float sigma ); \
+	template CI_API void gaussianBlur( ChannelT<T> *channel, const Area &area, float sigma ); \
+	template CI_API ChannelT<T> gaussianBlurCopy( const ChannelT<T> &channel, float sigma );
+
+boxBlur_PROTOTYPES(uint8_t)
+boxBlur_PROTOTYPES(uint16_t)
+boxBlur_PROTOTYPES(float)
+
 } } // namespace cinder::ip
@@ -0,0 +1,113 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/System.h"
+#include "cinder/Thread.h"
+#include "Simd.h"
+
+#include <algorithm>
+
+namespace cinder { namespace ip {
+
+namespace {
+
+thread_local ExecutionPolicy sExecutionPolicy;
+
+} // anonymous namespace
+
+int ExecutionPolicy::getNumThreads() const
+{
+	if( mNumThreads > 0 )
+		return mNumThreads;
+
+	return std::max<int>( 1, (int)std::thread::hardware_concurrency() );
+}
+
+const ExecutionPolicy& getExecutionPolicy()
+{
+	return sExecutionPolicy;
+}
+
+void setExecutionPolicy( const ExecutionPolicy &policy )
+{
+	sExecutionPolicy = policy;
+}
+
+ScopedExecutionPolicy::ScopedExecutionPolicy( const ExecutionPolicy &policy )
+	: mPreviousPolicy( getExecutionPolicy() )
+{
+	setExecutionPolicy( policy );
+}
+
+ScopedExecutionPolicy::~ScopedExecutionPolicy()
+{
+	setExecutionPolicy( mPreviousPolicy );
+}
+
+namespace detail {
+
+void parallelBands( int32_t begin, int32_t end, const std::function<void( int32_t, int32_t )> &bandFn )
+{
+	if( end <= begin )
+		return;
+
+	const ExecutionPolicy &policy = getExecutionPolicy();
+	const int32_t numThreads = policy.getNumThreads();
+	const int32_t maxBands = std::max<int32_t>( 1, ( end - begin ) / std::max( 1, policy.getMinRowsPerTask() ) );
+	// a few bands per thread lets threads that finish early help balance out uneven bands
+	const int32_t numBands = std::min( numThreads * 4, maxBands );
+	if( numThreads <= 1 || numBands <= 1 ) {
+		bandFn( begin, end );
+		return;
+	}
+
+	const int32_t bandSize = ( end - begin + numBands - 1 ) / numBands;
+	TaskScheduler::global()->parallelFor( begin, end, [&bandFn]( int64_t bandBegin, int64_t bandEnd ) { bandFn( (int32_t)bandBegin, (int32_t)bandEnd ); }, bandSize, numThreads );
+}
+
+SimdLevel getSimdLevel()
+{
+	static const SimdLevel sSupportedLevel = [] {
+#if defined( CINDER_IP_SIMD_X86 )
+		try {
+			if( System::hasAvx2() )
+				return SimdLevel::AVX2;
+			if( System::hasSse2() )
+				return SimdLevel::SSE2;
+		}
+		catch( const Exception & ) {} // feature query not implemented on this platform
+		return SimdLevel::NONE;
+#elif defined( CINDER_IP_SIMD_NEON )
+		return SimdLevel::NEON;
+#else
+		return SimdLevel::NONE;
+#endif
+	}();
+
+	return getExecutionPolicy().isSimdEnabled() ? sSupportedLevel : SimdLevel::NONE;
+}
+
+} // namespace detail
+
+} } // namespace cinder::ip
@@ -21,10 +21,209 @@
 */
 
 #include "cinder/ip/Grayscale.h"
+#include "cinder/ip/ExecutionPolicy.h"
 #include "cinder/ChanTraits.h"
+#include "Simd.h"
+
+#include <type_traits>
+
+#if defined( CINDER_IP_SIMD_X86 )
+	#include <immintrin.h>
+#elif defined( CINDER_IP_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
 
 namespace cinder { namespace ip {
 
+namespace {
+
+// The SIMD row kernels below process as many whole vectors of pixels as fit in a row and return the number of pixels they processed,
+// leaving the remainder of the row to the scalar code. The 8-bit kernels produce exactly the same results as the scalar code.
+
+#if defined( CINDER_IP_SIMD_X86 )
+
+// Rec. 709 luma weights used by CHANTRAIT<uint8_t>::grayscale() and CHANTRAIT<float>::grayscale()
+const int	kRedWeight8u = 54, kGreenWeight8u = 183, kBlueWeight8u = 19;
+const float	kRedWeight32f = 0.2126f, kGreenWeight32f = 0.7152f, kBlueWeight32f = 0.0722f;
+
+// Returns ( r * rWeight + g * gWeight + b * bWeight ) >> 8 of four 4-byte pixels in 32-bit lanes. The weights must sum to at most 256.
+CINDER_IP_TARGET_SSE2 inline __m128i grayscale4Sse2( const uint8_t *src, __m128i rShift, __m128i gShift, __m128i bShift, __m128i rWeight, __m128i gWeight, __m128i bWeight )
+{
+	const __m128i byteMask = _mm_set1_epi32( 0xFF );
+	__m128i px = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+	__m128i sum = _mm_mullo_epi16( _mm_and_si128( _mm_srl_epi32( px, rShift ), byteMask ), rWeight );
+	sum = _mm_add_epi16( sum, _mm_mullo_epi16( _mm_and_si128( _mm_srl_epi32( px, gShift ), byteMask ), gWeight ) );
+	sum = _mm_add_epi16( sum, _mm_mullo_epi16( _mm_and_si128( _mm_srl_epi32( px, bShift ), byteMask ), bWeight ) );
+	return _mm_srli_epi32( sum, 8 );
+}
+
+CINDER_IP_TARGET_SSE2 int32_t grayscaleToChannelRowSse2( const uint8_t *src, uint8_t *dst, int32_t width, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset, int rWeight, int gWeight, int bWeight )
+{
+	const __m128i rShift = _mm_cvtsi32_si128( rOffset * 8 ), gShift = _mm_cvtsi32_si128( gOffset * 8 ), bShift = _mm_cvtsi32_si128( bOffset * 8 );
+	const __m128i rW = _mm_set1_epi32( rWeight ), gW = _mm_set1_epi32( gWeight ), bW = _mm_set1_epi32( bWeight );
+	int32_t x = 0;
+	for( ; x + 16 <= width; x += 16, src += 64, dst += 16 ) {
+		__m128i g0 = grayscale4Sse2( src, rShift, gShift, bShift, rW, gW, bW );
+		__m128i g1 = grayscale4Sse2( src + 16, rShift, gShift, bShift, rW, gW, bW );
+		__m128i g2 = grayscale4Sse2( src + 32, rShift, gShift, bShift, rW, gW, bW );
+		__m128i g3 = grayscale4Sse2( src + 48, rShift, gShift, bShift, rW, gW, bW );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), _mm_packus_epi16( _mm_packs_epi32( g0, g1 ), _mm_packs_epi32( g2, g3 ) ) );
+	}
+	return x;
+}
+
+// Writes the gray value to the red, green and blue bytes of 4-byte destination pixels, leaving their remaining byte untouched
+CINDER_IP_TARGET_SSE2 int32_t grayscaleToSurfaceRowSse2( const uint8_t *src, uint8_t *dst, int32_t width, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset, uint8_t dstKeepOffset )
+{
+	const __m128i rShift = _mm_cvtsi32_si128( rOffset * 8 ), gShift = _mm_cvtsi32_si128( gOffset * 8 ), bShift = _mm_cvtsi32_si128( bOffset * 8 );
+	const __m128i rW = _mm_set1_epi32( kRedWeight8u ), gW = _mm_set1_epi32( kGreenWeight8u ), bW = _mm_set1_epi32( kBlueWeight8u );
+	const __m128i keepMask = _mm_sll_epi32( _mm_set1_epi32( 0xFF ), _mm_cvtsi32_si128( dstKeepOffset * 8 ) );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, src += 16, dst += 16 ) {
+		__m128i gray = grayscale4Sse2( src, rShift, gShift, bShift, rW, gW, bW );
+		gray = _mm_or_si128( gray, _mm_slli_epi32( gray, 8 ) );
+		gray = _mm_or_si128( gray, _mm_slli_epi32( gray, 16 ) );
+		__m128i d = _mm_loadu_si128( reinterpret_cast<const __m128i*>( dst ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), _mm_or_si128( _mm_and_si128( keepMask, d ), _mm_andnot_si128( keepMask, gray ) ) );
+	}
+	return x;
+}
+
+// Transposes four 4-channel float pixels into channel planes and returns their gray values
+CINDER_IP_TARGET_SSE2 inline __m128 grayscale4Sse2( const float *src, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset )
+{
+	__m128 planes[4] = { _mm_loadu_ps( src ), _mm_loadu_ps( src + 4 ), _mm_loadu_ps( src + 8 ), _mm_loadu_ps( src + 12 ) };
+	_MM_TRANSPOSE4_PS( planes[0], planes[1], planes[2], planes[3] );
+	__m128 sum = _mm_add_ps( _mm_mul_ps( planes[rOffset], _mm_set1_ps( kRedWeight32f ) ), _mm_mul_ps( planes[gOffset], _mm_set1_ps( kGreenWeight32f ) ) );
+	return _mm_add_ps( sum, _mm_mul_ps( planes[bOffset], _mm_set1_ps( kBlueWeight32f ) ) );
+}
+
+CINDER_IP_TARGET_SSE2 int32_t grayscaleToChannelRowSse2( const float *src, float *dst, int32_t width, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, src += 16, dst += 4 )
+		_mm_storeu_ps( dst, grayscale4Sse2( src, rOffset, gOffset, bOffset ) );
+	return x;
+}
+
+CINDER_IP_TARGET_SSE2 int32_t grayscaleToSurfaceRowSse2( const float *src, float *dst, int32_t width, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset, uint8_t dstRedOffset, uint8_t dstGreenOffset, uint8_t dstBlueOffset )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, src += 16, dst += 16 ) {
+		__m128 gray = grayscale4Sse2( src, rOffset, gOffset, bOffset );
+		__m128 planes[4] = { _mm_loadu_ps( dst ), _mm_loadu_ps( dst + 4 ), _mm_loadu_ps( dst + 8 ), _mm_loadu_ps( dst + 12 ) };
+		_MM_TRANSPOSE4_PS( planes[0], planes[1], planes[2], planes[3] );
+		planes[dstRedOffset] = planes[dstGreenOffset] = planes[dstBlueOffset] = gray;
+		_MM_TRANSPOSE4_PS( planes[0], planes[1], planes[2], planes[3] );
+		for( int i = 0; i < 4; ++i )
+			_mm_storeu_ps( dst + i * 4, planes[i] );
+	}
+	return x;
+}
+
+CINDER_IP_TARGET_AVX2 inline __m256i grayscale8Avx2( const uint8_t *src, __m128i rShift, __m128i gShift, __m128i bShift, __m256i rWeight, __m256i gWeight, __m256i bWeight )
+{
+	const __m256i byteMask = _mm256_set1_epi32( 0xFF );
+	__m256i px = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src ) );
+	__m256i sum = _mm256_mullo_epi16( _mm256_and_si256( _mm256_srl_epi32( px, rShift ), byteMask ), rWeight );
+	sum = _mm256_add_epi16( sum, _mm256_mullo_epi16( _mm256_and_si256( _mm256_srl_epi32( px, gShift ), byteMask ), gWeight ) );
+	sum = _mm256_add_epi16( sum, _mm256_mullo_epi16( _mm256_and_si256( _mm256_srl_epi32( px, bShift ), byteMask ), bWeight ) );
+	return _mm256_srli_epi32( sum, 8 );
+}
+
+CINDER_IP_TARGET_AVX2 int32_t grayscaleToChannelRowAvx2( const uint8_t *src, uint8_t *dst, int32_t width, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset, int rWeight, int gWeight, int bWeight )
+{
+	const __m128i rShift = _mm_cvtsi32_si128( rOffset * 8 ), gShift = _mm_cvtsi32_si128( gOffset * 8 ), bShift = _mm_cvtsi32_si128( bOffset * 8 );
+	const __m256i rW = _mm256_set1_epi32( rWeight ), gW = _mm256_set1_epi32( gWeight ), bW = _mm256_set1_epi32( bWeight );
+	// the packs below operate within 128-bit lanes, leaving groups of 4 pixels in the order 0, 2, 4, 6, 1, 3, 5, 7
+	const __m256i pixelOrder = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+	int32_t x = 0;
+	for( ; x + 32 <= width; x += 32, src += 128, dst += 32 ) {
+		__m256i g0 = grayscale8Avx2( src, rShift, gShift, bShift, rW, gW, bW );
+		__m256i g1 = grayscale8Avx2( src + 32, rShift, gShift, bShift, rW, gW, bW );
+		__m256i g2 = grayscale8Avx2( src + 64, rShift, gShift, bShift, rW, gW, bW );
+		__m256i g3 = grayscale8Avx2( src + 96, rShift, gShift, bShift, rW, gW, bW );
+		__m256i packed = _mm256_packus_epi16( _mm256_packs_epi32( g0, g1 ), _mm256_packs_epi32( g2, g3 ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>( dst ), _mm256_permutevar8x32_epi32( packed, pixelOrder ) );
+	}
+	return x;
+}
+
+#elif defined( CINDER_IP_SIMD_NEON )
+
+int32_t grayscaleToChannelRowNeon( const uint8_t *src, uint8_t *dst, int32_t width, uint8_t pixelInc, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset, int rWeight, int gWeight, int bWeight )
+{
+	const uint8x8_t rW = vdup_n_u8( (uint8_t)rWeight ), gW = vdup_n_u8( (uint8_t)gWeight ), bW = vdup_n_u8( (uint8_t)bWeight );
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8, src += 8 * pixelInc, dst += 8 ) {
+		uint8x8_t r, g, b;
+		if( pixelInc == 4 ) {
+			uint8x8x4_t px = vld4_u8( src );
+			r = px.val[rOffset]; g = px.val[gOffset]; b = px.val[bOffset];
+		}
+		else {
+			uint8x8x3_t px = vld3_u8( src );
+			r = px.val[rOffset]; g = px.val[gOffset]; b = px.val[bOffset];
+		}
+		uint16x8_t sum = vmlal_u8( vmlal_u8( vmull_u8( r, rW ), g, gW ), b, bW );
+		vst1_u8( dst, vshrn_n_u16( sum, 8 ) );
+	}
+	return x;
+}
+
+#endif
+
+// Each of these returns the number of pixels at the start of the row that were processed with SIMD instructions, which is zero for SimdLevel::NONE
+
+int32_t grayscaleToChannelRowSimd( const uint8_t *src, uint8_t *dst, int32_t width, uint8_t pixelInc, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset, int rWeight, int gWeight, int bWeight, detail::SimdLevel simdLevel )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	int32_t x = 0;
+	if( pixelInc != 4 )
+		return 0;
+	if( simdLevel == detail::SimdLevel::AVX2 )
+		x = grayscaleToChannelRowAvx2( src, dst, width, rOffset, gOffset, bOffset, rWeight, gWeight, bWeight );
+	if( simdLevel != detail::SimdLevel::NONE )
+		x += grayscaleToChannelRowSse2( src + x * 4, dst + x, width - x, rOffset, gOffset, bOffset, rWeight, gWeight, bWeight );
+	return x;
+#elif defined( CINDER_IP_SIMD_NEON )
+	return ( simdLevel == detail::SimdLevel::NEON ) ? grayscaleToChannelRowNeon( src, dst, width, pixelInc, rOffset, gOffset, bOffset, rWeight, gWeight, bWeight ) : 0;
+#else
+	return 0;
+#endif
+}
+
+int32_t grayscaleToChannelRowSimd( const float *src, float *dst, int32_t width, uint8_t pixelInc, uint8_t rOffset, uint8_t gOffset, uint8_t bOffset, detail::SimdLevel simdLevel )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	return ( simdLevel != detail::SimdLevel::NONE && pixelInc == 4 ) ? grayscaleToChannelRowSse2( src, dst, width, rOffset, gOffset, bOffset ) : 0;
+#else
+	return 0;
+#endif
+}
+
+template<typename T>
+int32_t grayscaleToSurfaceRowSimd( const SurfaceT<T> &srcSurface, const T *src, SurfaceT<T> *dstSurface, T *dst, int32_t width, detail::SimdLevel simdLevel )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	if( simdLevel == detail::SimdLevel::NONE || srcSurface.getPixelInc() != 4 || dstSurface->getPixelInc() != 4 )
+		return 0;
+
+	if constexpr( std::is_same_v<T, uint8_t> ) {
+		// the offsets of a 4-channel pixel sum to 6, which leaves the byte not written to
+		const uint8_t dstKeepOffset = 6 - dstSurface->getRedOffset() - dstSurface->getGreenOffset() - dstSurface->getBlueOffset();
+		return grayscaleToSurfaceRowSse2( src, dst, width, srcSurface.getRedOffset(), srcSurface.getGreenOffset(), srcSurface.getBlueOffset(), dstKeepOffset );
+	}
+	else
+		return grayscaleToSurfaceRowSse2( src, dst, width, srcSurface.getRedOffset(), srcSurface.getGreenOffset(), srcSurface.getBlueOffset(),
+							dstSurface->getRedOffset(), dstSurface->getGreenOffset(), dstSurface->getBlueOffset() );
+#else
+	return 0;
+#endif
+}
+
+} // anonymous namespace
+
 template<typename T>
 void grayscale( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface )
 {
@@ -34,18 +233,24 @@ void grayscale( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface )
 	uint8_t srcRedOffset = srcSurface.getRedOffset(), srcGreenOffset = srcSurface.getGreenOffset(), srcBlueOffset = srcSurface.getBlueOffset();
 	uint8_t dstRedOffset = dstSurface->getRedOffset(), dstGreenOffset = dstSurface->getGreenOffset(), dstBlueOffset = dstSurface->getBlueOffset();	
 	int8_t dstPixelInc = dstSurface->getPixelInc();
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		T *dstPtr = dstSurface->getData( ivec2( area.getX1(), y ) );
-		const T *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			T gray = CHANTRAIT<T>::grayscale( srcPtr[srcRedOffset], srcPtr[srcGreenOffset], srcPtr[srcBlueOffset] );
-			dstPtr[dstRedOffset] = gray;
-			dstPtr[dstGreenOffset] = gray;
-			dstPtr[dstBlueOffset] = gray;
-			dstPtr += dstPixelInc;
-			srcPtr += srcPixelInc;
+	const detail::SimdLevel simdLevel = detail::getSimdLevel();
+	detail::parallelBands( 0, area.getHeight(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			T *dstPtr = dstSurface->getData( ivec2( area.getX1(), y ) );
+			const T *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
+			const int32_t simdWidth = grayscaleToSurfaceRowSimd( srcSurface, srcPtr, dstSurface, dstPtr, area.getWidth(), simdLevel );
+			dstPtr += simdWidth * dstPixelInc;
+			srcPtr += simdWidth * srcPixelInc;
+			for( int32_t x = area.getX1() + simdWidth; x < area.getX2(); ++x ) {
+				T gray = CHANTRAIT<T>::grayscale( srcPtr[srcRedOffset], srcPtr[srcGreenOffset], srcPtr[srcBlueOffset] );
+				dstPtr[dstRedOffset] = gray;
+				dstPtr[dstGreenOffset] = gray;
+				dstPtr[dstBlueOffset] = gray;
+				dstPtr += dstPixelInc;
+				srcPtr += srcPixelInc;
+			}
 		}
-	}
+	} );
 }
 
 template<typename T>
@@ -56,15 +261,21 @@ void grayscale( const SurfaceT<T> &srcSurface, ChannelT<T> *dstChannel )
 	int8_t srcPixelInc = srcSurface.getPixelInc();
 	uint8_t srcRedOffset = srcSurface.getRedOffset(), srcGreenOffset = srcSurface.getGreenOffset(), srcBlueOffset = srcSurface.getBlueOffset();
 	int8_t dstPixelInc = dstChannel->getIncrement();
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		T *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) );
-		const T *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			*dstPtr = CHANTRAIT<T>::grayscale( srcPtr[srcRedOffset], srcPtr[srcGreenOffset], srcPtr[srcBlueOffset] );
-			dstPtr += dstPixelInc;
-			srcPtr += srcPixelInc;
+	const detail::SimdLevel simdLevel = ( dstPixelInc == 1 ) ? detail::getSimdLevel() : detail::SimdLevel::NONE;
+	detail::parallelBands( 0, area.getHeight(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			T *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) );
+			const T *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
+			const int32_t simdWidth = grayscaleToChannelRowSimd( srcPtr, dstPtr, area.getWidth(), srcPixelInc, srcRedOffset, srcGreenOffset, srcBlueOffset, simdLevel );
+			dstPtr += simdWidth * dstPixelInc;
+			srcPtr += simdWidth * srcPixelInc;
+			for( int32_t x = area.getX1() + simdWidth; x < area.getX2(); ++x ) {
+				*dstPtr = CHANTRAIT<T>::grayscale( srcPtr[srcRedOffset], srcPtr[srcGreenOffset], srcPtr[srcBlueOffset] );
+				dstPtr += dstPixelInc;
+				srcPtr += srcPixelInc;
+			}
 		}
-	}
+	} );
 }
 
 template<>
@@ -76,16 +287,22 @@ void grayscale( const Surface8u &srcSurface, Channel8u *dstChannel )
 	uint8_t srcRedOffset = srcSurface.getRedOffset(), srcGreenOffset = srcSurface.getGreenOffset(), srcBlueOffset = srcSurface.getBlueOffset();
 	int8_t dstPixelInc = dstChannel->getIncrement();
 	const uint8_t redWeight = 74, greenWeight = 147, blueWeight = 35;
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		uint8_t *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) );
-		const uint8_t *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			uint32_t sum = srcPtr[srcRedOffset] * redWeight + srcPtr[srcGreenOffset] * greenWeight + srcPtr[srcBlueOffset] * blueWeight;
-			*dstPtr = static_cast<uint8_t>( sum >> 8 );
-			dstPtr += dstPixelInc;
-			srcPtr += srcPixelInc;
+	const detail::SimdLevel simdLevel = ( dstPixelInc == 1 ) ? detail::getSimdLevel() : detail::SimdLevel::NONE;
+	detail::parallelBands( 0, area.getHeight(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			uint8_t *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) );
+			const uint8_t *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
+			const int32_t simdWidth = grayscaleToChannelRowSimd( srcPtr, dstPtr, area.getWidth(), srcPixelInc, srcRedOffset, srcGreenOffset, srcBlueOffset, redWeight, greenWeight, blueWeight, simdLevel );
+			dstPtr += simdWidth * dstPixelInc;
+			srcPtr += simdWidth * srcPixelInc;
+			for( int32_t x = area.getX1() + simdWidth; x < area.getX2(); ++x ) {
+				uint32_t sum = srcPtr[srcRedOffset] * redWeight + srcPtr[srcGreenOffset] * greenWeight + srcPtr[srcBlueOffset] * blueWeight;
+				*dstPtr = static_cast<uint8_t>( sum >> 8 );
+				dstPtr += dstPixelInc;
+				srcPtr += srcPixelInc;
+			}
 		}
-	}
+	} );
 }
 
 #define grayscale_PROTOTYPES(T)\
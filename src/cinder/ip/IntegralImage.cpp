@@ -0,0 +1,234 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/Exception.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cinder { namespace ip {
+
+template<typename T>
+IntegralImageT<T>::IntegralImageT( const ChannelT<T> &channel, bool squares )
+	: mWidth( 0 ), mHeight( 0 ), mHasSquares( squares )
+{
+	update( channel );
+}
+
+template<typename T>
+void IntegralImageT<T>::update( const ChannelT<T> &channel )
+{
+	mWidth = channel.getWidth();
+	mHeight = channel.getHeight();
+	// the first row and column stay zero, so that queries need no special cases at the edges
+	mSums.assign( getStride() * ( mHeight + 1 ), 0 );
+	if( mHasSquares )
+		mSquares.assign( getStride() * ( mHeight + 1 ), 0 );
+
+	accumulate( channel, 0, 0 );
+}
+
+template<typename T>
+void IntegralImageT<T>::update( const ChannelT<T> &channel, const Area &area )
+{
+	if( channel.getSize() != getSize() ) {
+		update( channel );
+		return;
+	}
+
+	const Area clipped = area.getClipBy( getBounds() );
+	if( clipped.getWidth() > 0 && clipped.getHeight() > 0 )
+		accumulate( channel, clipped.getX1(), clipped.getY1() );
+}
+
+// Recomputes the entries for [x1,width] x [y1,height] in a single pass over the pixels they depend on, carrying the running sum of each row
+template<typename T>
+void IntegralImageT<T>::accumulate( const ChannelT<T> &channel, int32_t x1, int32_t y1 )
+{
+	const size_t stride = getStride();
+	const uint8_t inc = channel.getIncrement();
+	for( int32_t y = y1; y < mHeight; ++y ) {
+		const T *src = channel.getData( x1, y );
+		SumT *sumsAbove = &mSums[y * stride], *sums = &mSums[( y + 1 ) * stride];
+		// the sum of the row left of x1 is unaffected
+		SumT rowSum = sums[x1] - sumsAbove[x1];
+		if( mHasSquares ) {
+			SumSquaresT *squaresAbove = &mSquares[y * stride], *squares = &mSquares[( y + 1 ) * stride];
+			SumSquaresT rowSquares = squares[x1] - squaresAbove[x1];
+			for( int32_t x = x1; x < mWidth; ++x ) {
+				const T v = *src;
+				rowSum += v;
+				rowSquares += (SumSquaresT)v * v;
+				sums[x + 1] = sumsAbove[x + 1] + rowSum;
+				squares[x + 1] = squaresAbove[x + 1] + rowSquares;
+				src += inc;
+			}
+		}
+		else {
+			for( int32_t x = x1; x < mWidth; ++x ) {
+				rowSum += *src;
+				sums[x + 1] = sumsAbove[x + 1] + rowSum;
+				src += inc;
+			}
+		}
+	}
+}
+
+template<typename T>
+typename IntegralImageT<T>::SumT IntegralImageT<T>::getSum( const Area &area ) const
+{
+	const Area a = area.getClipBy( getBounds() );
+	if( a.getWidth() <= 0 || a.getHeight() <= 0 )
+		return 0;
+
+	const size_t stride = getStride();
+	return mSums[a.getY2() * stride + a.getX2()] - mSums[a.getY1() * stride + a.getX2()] - mSums[a.getY2() * stride + a.getX1()] + mSums[a.getY1() * stride + a.getX1()];
+}
+
+template<typename T>
+typename IntegralImageT<T>::SumSquaresT IntegralImageT<T>::getSumSquares( const Area &area ) const
+{
+	CI_ASSERT_MSG( mHasSquares, "IntegralImage was built without squares" );
+	const Area a = area.getClipBy( getBounds() );
+	if( ! mHasSquares || a.getWidth() <= 0 || a.getHeight() <= 0 )
+		return 0;
+
+	const size_t stride = getStride();
+	return mSquares[a.getY2() * stride + a.getX2()] - mSquares[a.getY1() * stride + a.getX2()] - mSquares[a.getY2() * stride + a.getX1()] + mSquares[a.getY1() * stride + a.getX1()];
+}
+
+template<typename T>
+double IntegralImageT<T>::getMean( const Area &area ) const
+{
+	const int32_t count = area.getClipBy( getBounds() ).calcArea();
+	return ( count > 0 ) ? (double)getSum( area ) / count : 0;
+}
+
+template<typename T>
+double IntegralImageT<T>::getVariance( const Area &area ) const
+{
+	const int32_t count = area.getClipBy( getBounds() ).calcArea();
+	if( count <= 0 )
+		return 0;
+
+	const double mean = (double)getSum( area ) / count;
+	return std::max( 0.0, (double)getSumSquares( area ) / count - mean * mean );
+}
+
+namespace {
+
+// Calls fn( x, y, window ) for every pixel with its window of radius windowSize / 2 clipped to the image, in bands of rows per the ExecutionPolicy
+template<typename FN>
+void forEachWindow( int32_t width, int32_t height, int32_t windowSize, const FN &fn )
+{
+	const int32_t radius = std::max( 0, windowSize / 2 );
+	detail::parallelBands( 0, height, [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			const int32_t top = std::max( 0, y - radius ), bottom = std::min( height, y + radius + 1 );
+			for( int32_t x = 0; x < width; ++x )
+				fn( x, y, Area( std::max( 0, x - radius ), top, std::min( width, x + radius + 1 ), bottom ) );
+		}
+	} );
+}
+
+template<typename T>
+T meanToChannel( double mean )
+{
+	if( std::is_integral<T>::value )
+		return (T)( mean + 0.5 );
+	else
+		return (T)mean;
+}
+
+} // anonymous namespace
+
+template<typename T>
+void boxFilter( const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel )
+{
+	const int32_t width = std::min( integralImage.getWidth(), dstChannel->getWidth() );
+	const int32_t height = std::min( integralImage.getHeight(), dstChannel->getHeight() );
+	const uint8_t dstInc = dstChannel->getIncrement();
+	const typename IntegralImageT<T>::SumT *sums = integralImage.getSums();
+	const size_t stride = integralImage.getStride();
+
+	forEachWindow( width, height, windowSize, [&]( int32_t x, int32_t y, const Area &w ) {
+		const typename IntegralImageT<T>::SumT sum = sums[w.y2 * stride + w.x2] - sums[w.y1 * stride + w.x2] - sums[w.y2 * stride + w.x1] + sums[w.y1 * stride + w.x1];
+		dstChannel->getData( 0, y )[x * dstInc] = meanToChannel<T>( (double)sum / ( w.getWidth() * w.getHeight() ) );
+	} );
+}
+
+template<typename T>
+void boxFilter( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel )
+{
+	boxFilter( IntegralImageT<T>( srcChannel ), windowSize, dstChannel );
+}
+
+template<typename T>
+void localContrastNormalize( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, Channel32f *dstChannel, float minStdDev )
+{
+	if( ! integralImage.hasSquares() )
+		throw Exception( "localContrastNormalize() requires an IntegralImage built with squares" );
+
+	const int32_t width = std::min( { srcChannel.getWidth(), integralImage.getWidth(), dstChannel->getWidth() } );
+	const int32_t height = std::min( { srcChannel.getHeight(), integralImage.getHeight(), dstChannel->getHeight() } );
+	const uint8_t srcInc = srcChannel.getIncrement();
+	const uint8_t dstInc = dstChannel->getIncrement();
+	const double minVariance = (double)minStdDev * CHANTRAIT<T>::max() * minStdDev * CHANTRAIT<T>::max();
+	const typename IntegralImageT<T>::SumT *sums = integralImage.getSums();
+	const typename IntegralImageT<T>::SumSquaresT *squares = integralImage.getSumsSquares();
+	const size_t stride = integralImage.getStride();
+
+	forEachWindow( width, height, windowSize, [&]( int32_t x, int32_t y, const Area &w ) {
+		const size_t i11 = w.y1 * stride + w.x1, i12 = w.y1 * stride + w.x2, i21 = w.y2 * stride + w.x1, i22 = w.y2 * stride + w.x2;
+		const double count = w.getWidth() * w.getHeight();
+		const double mean = (double)(typename IntegralImageT<T>::SumT)( sums[i22] - sums[i12] - sums[i21] + sums[i11] ) / count;
+		const double variance = (double)(typename IntegralImageT<T>::SumSquaresT)( squares[i22] - squares[i12] - squares[i21] + squares[i11] ) / count - mean * mean;
+		const double v = srcChannel.getData( 0, y )[x * srcInc];
+		dstChannel->getData( 0, y )[x * dstInc] = (float)( ( v - mean ) / std::sqrt( std::max( variance, minVariance ) ) );
+	} );
+}
+
+template<typename T>
+void localContrastNormalize( const ChannelT<T> &srcChannel, int32_t windowSize, Channel32f *dstChannel, float minStdDev )
+{
+	localContrastNormalize( srcChannel, IntegralImageT<T>( srcChannel, true ), windowSize, dstChannel, minStdDev );
+}
+
+template class CI_API IntegralImageT<uint8_t>;
+template class CI_API IntegralImageT<uint16_t>;
+template class CI_API IntegralImageT<float>;
+
+#define integralImage_PROTOTYPES(T)\
+	template CI_API void boxFilter( const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel ); \
+	template CI_API void boxFilter( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel ); \
+	template CI_API void localContrastNormalize( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, Channel32f *dstChannel, float minStdDev ); \
+	template CI_API void localContrastNormalize( const ChannelT<T> &srcChannel, int32_t windowSize, Channel32f *dstChannel, float minStdDev );
+
+integralImage_PROTOTYPES(uint8_t)
+integralImage_PROTOTYPES(uint16_t)
+integralImage_PROTOTYPES(float)
+
+} } // namespace cinder::ip
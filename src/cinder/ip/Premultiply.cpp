@@ -21,13 +21,340 @@
 */
 
 #include "cinder/ip/Premultiply.h"
+#include "cinder/ip/ExecutionPolicy.h"
 #include "cinder/ChanTraits.h"
+#include "Simd.h"
 
 #include <algorithm>
 
+#if defined( CINDER_IP_SIMD_X86 )
+	#include <immintrin.h>
+#elif defined( CINDER_IP_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
+
 namespace cinder { namespace ip {
 
-// this is a candidate for sse2
+namespace {
+
+// The SIMD row kernels below process as many whole vectors of 4-channel pixels as fit in a row and return the number of pixels they
+// processed, leaving the remainder of the row to the scalar code. The 8-bit kernels produce exactly the same results as the scalar code.
+
+#if defined( CINDER_IP_SIMD_X86 )
+
+// Divides 16-bit lanes holding at most 255 * 255 by 255, truncating exactly like integer division
+CINDER_IP_TARGET_SSE2 inline __m128i div255Sse2( __m128i v )
+{
+	return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( v, _mm_set1_epi16( 1 ) ), _mm_srli_epi16( v, 8 ) ), 8 );
+}
+
+// Replicates the alpha byte of every 4-byte pixel across the whole pixel
+CINDER_IP_TARGET_SSE2 inline __m128i broadcastAlphaSse2( __m128i px, __m128i alphaShift )
+{
+	__m128i alpha = _mm_and_si128( _mm_srl_epi32( px, alphaShift ), _mm_set1_epi32( 0xFF ) );
+	alpha = _mm_or_si128( alpha, _mm_slli_epi32( alpha, 8 ) );
+	return _mm_or_si128( alpha, _mm_slli_epi32( alpha, 16 ) );
+}
+
+// Computes min( c * 255 / a, 255 ) on 32-bit lanes. Single precision division is exact here since c * 255 < 2^24
+CINDER_IP_TARGET_SSE2 inline __m128i unpremultiply4Sse2( __m128i c, __m128i a )
+{
+	__m128 q = _mm_div_ps( _mm_mul_ps( _mm_cvtepi32_ps( c ), _mm_set1_ps( 255.0f ) ), _mm_max_ps( _mm_cvtepi32_ps( a ), _mm_set1_ps( 1.0f ) ) );
+	return _mm_cvttps_epi32( q );
+}
+
+CINDER_IP_TARGET_SSE2 int32_t premultiplyRowSse2( uint8_t *ptr, int32_t width, uint8_t alphaOffset )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaShift = _mm_cvtsi32_si128( alphaOffset * 8 );
+	const __m128i alphaMask = _mm_sll_epi32( _mm_set1_epi32( 0xFF ), alphaShift );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, ptr += 16 ) {
+		__m128i px = _mm_loadu_si128( reinterpret_cast<const __m128i*>( ptr ) );
+		__m128i alpha = broadcastAlphaSse2( px, alphaShift );
+		__m128i lo = div255Sse2( _mm_mullo_epi16( _mm_unpacklo_epi8( px, zero ), _mm_unpacklo_epi8( alpha, zero ) ) );
+		__m128i hi = div255Sse2( _mm_mullo_epi16( _mm_unpackhi_epi8( px, zero ), _mm_unpackhi_epi8( alpha, zero ) ) );
+		__m128i result = _mm_packus_epi16( lo, hi );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( ptr ), _mm_or_si128( _mm_and_si128( alphaMask, px ), _mm_andnot_si128( alphaMask, result ) ) );
+	}
+	return x;
+}
+
+CINDER_IP_TARGET_SSE2 int32_t unpremultiplyRowSse2( uint8_t *ptr, int32_t width, uint8_t alphaOffset )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaShift = _mm_cvtsi32_si128( alphaOffset * 8 );
+	const __m128i alphaMask = _mm_sll_epi32( _mm_set1_epi32( 0xFF ), alphaShift );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, ptr += 16 ) {
+		__m128i px = _mm_loadu_si128( reinterpret_cast<const __m128i*>( ptr ) );
+		__m128i alpha = broadcastAlphaSse2( px, alphaShift );
+		// the alpha channel and pixels with zero alpha are left untouched
+		__m128i keep = _mm_or_si128( alphaMask, _mm_cmpeq_epi8( alpha, zero ) );
+		__m128i pxLo = _mm_unpacklo_epi8( px, zero ), pxHi = _mm_unpackhi_epi8( px, zero );
+		__m128i alphaLo = _mm_unpacklo_epi8( alpha, zero ), alphaHi = _mm_unpackhi_epi8( alpha, zero );
+		__m128i q0 = unpremultiply4Sse2( _mm_unpacklo_epi16( pxLo, zero ), _mm_unpacklo_epi16( alphaLo, zero ) );
+		__m128i q1 = unpremultiply4Sse2( _mm_unpackhi_epi16( pxLo, zero ), _mm_unpackhi_epi16( alphaLo, zero ) );
+		__m128i q2 = unpremultiply4Sse2( _mm_unpacklo_epi16( pxHi, zero ), _mm_unpacklo_epi16( alphaHi, zero ) );
+		__m128i q3 = unpremultiply4Sse2( _mm_unpackhi_epi16( pxHi, zero ), _mm_unpackhi_epi16( alphaHi, zero ) );
+		// saturating packs clamp the quotients to 255
+		__m128i result = _mm_packus_epi16( _mm_packs_epi32( q0, q1 ), _mm_packs_epi32( q2, q3 ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( ptr ), _mm_or_si128( _mm_and_si128( keep, px ), _mm_andnot_si128( keep, result ) ) );
+	}
+	return x;
+}
+
+template<int ALPHA>
+CINDER_IP_TARGET_SSE2 int32_t premultiplyRowSse2( float *ptr, int32_t width )
+{
+	const __m128 alphaMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? -1 : 0, ALPHA == 1 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 3 ? -1 : 0 ) );
+	for( int32_t x = 0; x < width; ++x, ptr += 4 ) {
+		__m128 px = _mm_loadu_ps( ptr );
+		__m128 alpha = _mm_shuffle_ps( px, px, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		_mm_storeu_ps( ptr, _mm_or_ps( _mm_and_ps( alphaMask, px ), _mm_andnot_ps( alphaMask, _mm_mul_ps( px, alpha ) ) ) );
+	}
+	return width;
+}
+
+template<int ALPHA>
+CINDER_IP_TARGET_SSE2 int32_t unpremultiplyRowSse2( float *ptr, int32_t width )
+{
+	const __m128 alphaMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? -1 : 0, ALPHA == 1 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 3 ? -1 : 0 ) );
+	for( int32_t x = 0; x < width; ++x, ptr += 4 ) {
+		__m128 px = _mm_loadu_ps( ptr );
+		__m128 alpha = _mm_shuffle_ps( px, px, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		__m128 keep = _mm_or_ps( alphaMask, _mm_cmpeq_ps( alpha, _mm_setzero_ps() ) );
+		__m128 result = _mm_mul_ps( px, _mm_div_ps( _mm_set1_ps( 1.0f ), alpha ) );
+		_mm_storeu_ps( ptr, _mm_or_ps( _mm_and_ps( keep, px ), _mm_andnot_ps( keep, result ) ) );
+	}
+	return width;
+}
+
+CINDER_IP_TARGET_AVX2 inline __m256i div255Avx2( __m256i v )
+{
+	return _mm256_srli_epi16( _mm256_add_epi16( _mm256_add_epi16( v, _mm256_set1_epi16( 1 ) ), _mm256_srli_epi16( v, 8 ) ), 8 );
+}
+
+CINDER_IP_TARGET_AVX2 inline __m256i broadcastAlphaAvx2( __m256i px, __m128i alphaShift )
+{
+	__m256i alpha = _mm256_and_si256( _mm256_srl_epi32( px, alphaShift ), _mm256_set1_epi32( 0xFF ) );
+	alpha = _mm256_or_si256( alpha, _mm256_slli_epi32( alpha, 8 ) );
+	return _mm256_or_si256( alpha, _mm256_slli_epi32( alpha, 16 ) );
+}
+
+CINDER_IP_TARGET_AVX2 inline __m256i unpremultiply8Avx2( __m256i c, __m256i a )
+{
+	__m256 q = _mm256_div_ps( _mm256_mul_ps( _mm256_cvtepi32_ps( c ), _mm256_set1_ps( 255.0f ) ), _mm256_max_ps( _mm256_cvtepi32_ps( a ), _mm256_set1_ps( 1.0f ) ) );
+	return _mm256_cvttps_epi32( q );
+}
+
+// The unpack and pack instructions operate within 128-bit lanes, so pairing them keeps every pixel in place
+CINDER_IP_TARGET_AVX2 int32_t premultiplyRowAvx2( uint8_t *ptr, int32_t width, uint8_t alphaOffset )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m128i alphaShift = _mm_cvtsi32_si128( alphaOffset * 8 );
+	const __m256i alphaMask = _mm256_sll_epi32( _mm256_set1_epi32( 0xFF ), alphaShift );
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8, ptr += 32 ) {
+		__m256i px = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( ptr ) );
+		__m256i alpha = broadcastAlphaAvx2( px, alphaShift );
+		__m256i lo = div255Avx2( _mm256_mullo_epi16( _mm256_unpacklo_epi8( px, zero ), _mm256_unpacklo_epi8( alpha, zero ) ) );
+		__m256i hi = div255Avx2( _mm256_mullo_epi16( _mm256_unpackhi_epi8( px, zero ), _mm256_unpackhi_epi8( alpha, zero ) ) );
+		__m256i result = _mm256_packus_epi16( lo, hi );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>( ptr ), _mm256_blendv_epi8( result, px, alphaMask ) );
+	}
+	return x;
+}
+
+CINDER_IP_TARGET_AVX2 int32_t unpremultiplyRowAvx2( uint8_t *ptr, int32_t width, uint8_t alphaOffset )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m128i alphaShift = _mm_cvtsi32_si128( alphaOffset * 8 );
+	const __m256i alphaMask = _mm256_sll_epi32( _mm256_set1_epi32( 0xFF ), alphaShift );
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8, ptr += 32 ) {
+		__m256i px = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( ptr ) );
+		__m256i alpha = broadcastAlphaAvx2( px, alphaShift );
+		__m256i keep = _mm256_or_si256( alphaMask, _mm256_cmpeq_epi8( alpha, zero ) );
+		__m256i pxLo = _mm256_unpacklo_epi8( px, zero ), pxHi = _mm256_unpackhi_epi8( px, zero );
+		__m256i alphaLo = _mm256_unpacklo_epi8( alpha, zero ), alphaHi = _mm256_unpackhi_epi8( alpha, zero );
+		__m256i q0 = unpremultiply8Avx2( _mm256_unpacklo_epi16( pxLo, zero ), _mm256_unpacklo_epi16( alphaLo, zero ) );
+		__m256i q1 = unpremultiply8Avx2( _mm256_unpackhi_epi16( pxLo, zero ), _mm256_unpackhi_epi16( alphaLo, zero ) );
+		__m256i q2 = unpremultiply8Avx2( _mm256_unpacklo_epi16( pxHi, zero ), _mm256_unpacklo_epi16( alphaHi, zero ) );
+		__m256i q3 = unpremultiply8Avx2( _mm256_unpackhi_epi16( pxHi, zero ), _mm256_unpackhi_epi16( alphaHi, zero ) );
+		__m256i result = _mm256_packus_epi16( _mm256_packs_epi32( q0, q1 ), _mm256_packs_epi32( q2, q3 ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>( ptr ), _mm256_blendv_epi8( result, px, keep ) );
+	}
+	return x;
+}
+
+template<int ALPHA>
+CINDER_IP_TARGET_AVX2 int32_t premultiplyRowAvx2( float *ptr, int32_t width )
+{
+	const __m256 alphaMask = _mm256_castsi256_ps( _mm256_setr_epi32( ALPHA == 0 ? -1 : 0, ALPHA == 1 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 3 ? -1 : 0,
+																	 ALPHA == 0 ? -1 : 0, ALPHA == 1 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 3 ? -1 : 0 ) );
+	int32_t x = 0;
+	for( ; x + 2 <= width; x += 2, ptr += 8 ) {
+		__m256 px = _mm256_loadu_ps( ptr );
+		__m256 alpha = _mm256_permute_ps( px, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		_mm256_storeu_ps( ptr, _mm256_blendv_ps( _mm256_mul_ps( px, alpha ), px, alphaMask ) );
+	}
+	return x;
+}
+
+template<int ALPHA>
+CINDER_IP_TARGET_AVX2 int32_t unpremultiplyRowAvx2( float *ptr, int32_t width )
+{
+	const __m256 alphaMask = _mm256_castsi256_ps( _mm256_setr_epi32( ALPHA == 0 ? -1 : 0, ALPHA == 1 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 3 ? -1 : 0,
+																	 ALPHA == 0 ? -1 : 0, ALPHA == 1 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 3 ? -1 : 0 ) );
+	int32_t x = 0;
+	for( ; x + 2 <= width; x += 2, ptr += 8 ) {
+		__m256 px = _mm256_loadu_ps( ptr );
+		__m256 alpha = _mm256_permute_ps( px, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		__m256 keep = _mm256_or_ps( alphaMask, _mm256_cmp_ps( alpha, _mm256_setzero_ps(), _CMP_EQ_OQ ) );
+		__m256 result = _mm256_mul_ps( px, _mm256_div_ps( _mm256_set1_ps( 1.0f ), alpha ) );
+		_mm256_storeu_ps( ptr, _mm256_blendv_ps( result, px, keep ) );
+	}
+	return x;
+}
+
+#elif defined( CINDER_IP_SIMD_NEON )
+
+// Computes c * a / 255 on 16 bytes, truncating exactly like integer division
+inline uint8x16_t premultiply16Neon( uint8x16_t c, uint8x16_t a )
+{
+	uint16x8_t lo = vmull_u8( vget_low_u8( c ), vget_low_u8( a ) );
+	uint16x8_t hi = vmull_u8( vget_high_u8( c ), vget_high_u8( a ) );
+	lo = vaddq_u16( vaddq_u16( lo, vdupq_n_u16( 1 ) ), vshrq_n_u16( lo, 8 ) );
+	hi = vaddq_u16( vaddq_u16( hi, vdupq_n_u16( 1 ) ), vshrq_n_u16( hi, 8 ) );
+	return vcombine_u8( vshrn_n_u16( lo, 8 ), vshrn_n_u16( hi, 8 ) );
+}
+
+int32_t premultiplyRowNeon( uint8_t *ptr, int32_t width, uint8_t alphaOffset )
+{
+	int32_t x = 0;
+	for( ; x + 16 <= width; x += 16, ptr += 64 ) {
+		uint8x16x4_t px = vld4q_u8( ptr );
+		const uint8x16_t alpha = px.val[alphaOffset];
+		for( int c = 0; c < 4; ++c ) {
+			if( c != alphaOffset )
+				px.val[c] = premultiply16Neon( px.val[c], alpha );
+		}
+		vst4q_u8( ptr, px );
+	}
+	return x;
+}
+
+int32_t premultiplyRowNeon( float *ptr, int32_t width, uint8_t alphaOffset )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, ptr += 16 ) {
+		float32x4x4_t px = vld4q_f32( ptr );
+		const float32x4_t alpha = px.val[alphaOffset];
+		for( int c = 0; c < 4; ++c ) {
+			if( c != alphaOffset )
+				px.val[c] = vmulq_f32( px.val[c], alpha );
+		}
+		vst4q_f32( ptr, px );
+	}
+	return x;
+}
+
+#endif
+
+// Returns the number of pixels at the start of the row that were processed with SIMD instructions, which is zero for SimdLevel::NONE
+int32_t premultiplyRowSimd( uint8_t *ptr, int32_t width, uint8_t alphaOffset, detail::SimdLevel simdLevel )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	int32_t x = 0;
+	if( simdLevel == detail::SimdLevel::AVX2 )
+		x = premultiplyRowAvx2( ptr, width, alphaOffset );
+	if( simdLevel != detail::SimdLevel::NONE )
+		x += premultiplyRowSse2( ptr + x * 4, width - x, alphaOffset );
+	return x;
+#elif defined( CINDER_IP_SIMD_NEON )
+	return ( simdLevel == detail::SimdLevel::NEON ) ? premultiplyRowNeon( ptr, width, alphaOffset ) : 0;
+#else
+	return 0;
+#endif
+}
+
+int32_t unpremultiplyRowSimd( uint8_t *ptr, int32_t width, uint8_t alphaOffset, detail::SimdLevel simdLevel )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	int32_t x = 0;
+	if( simdLevel == detail::SimdLevel::AVX2 )
+		x = unpremultiplyRowAvx2( ptr, width, alphaOffset );
+	if( simdLevel != detail::SimdLevel::NONE )
+		x += unpremultiplyRowSse2( ptr + x * 4, width - x, alphaOffset );
+	return x;
+#else
+	return 0;
+#endif
+}
+
+#if defined( CINDER_IP_SIMD_X86 )
+template<int ALPHA>
+int32_t premultiplyRowSimd( float *ptr, int32_t width, detail::SimdLevel simdLevel )
+{
+	int32_t x = 0;
+	if( simdLevel == detail::SimdLevel::AVX2 )
+		x = premultiplyRowAvx2<ALPHA>( ptr, width );
+	if( simdLevel != detail::SimdLevel::NONE )
+		x += premultiplyRowSse2<ALPHA>( ptr + x * 4, width - x );
+	return x;
+}
+
+template<int ALPHA>
+int32_t unpremultiplyRowSimd( float *ptr, int32_t width, detail::SimdLevel simdLevel )
+{
+	int32_t x = 0;
+	if( simdLevel == detail::SimdLevel::AVX2 )
+		x = unpremultiplyRowAvx2<ALPHA>( ptr, width );
+	if( simdLevel != detail::SimdLevel::NONE )
+		x += unpremultiplyRowSse2<ALPHA>( ptr + x * 4, width - x );
+	return x;
+}
+#endif
+
+int32_t premultiplyRowSimd( float *ptr, int32_t width, uint8_t alphaOffset, detail::SimdLevel simdLevel )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	switch( alphaOffset ) {
+		case 0: return premultiplyRowSimd<0>( ptr, width, simdLevel );
+		case 1: return premultiplyRowSimd<1>( ptr, width, simdLevel );
+		case 2: return premultiplyRowSimd<2>( ptr, width, simdLevel );
+		default: return premultiplyRowSimd<3>( ptr, width, simdLevel );
+	}
+#elif defined( CINDER_IP_SIMD_NEON )
+	return ( simdLevel == detail::SimdLevel::NEON ) ? premultiplyRowNeon( ptr, width, alphaOffset ) : 0;
+#else
+	return 0;
+#endif
+}
+
+int32_t unpremultiplyRowSimd( float *ptr, int32_t width, uint8_t alphaOffset, detail::SimdLevel simdLevel )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	switch( alphaOffset ) {
+		case 0: return unpremultiplyRowSimd<0>( ptr, width, simdLevel );
+		case 1: return unpremultiplyRowSimd<1>( ptr, width, simdLevel );
+		case 2: return unpremultiplyRowSimd<2>( ptr, width, simdLevel );
+		default: return unpremultiplyRowSimd<3>( ptr, width, simdLevel );
+	}
+#else
+	return 0;
+#endif
+}
+
+// there are no SIMD kernels for 16-bit surfaces
+int32_t premultiplyRowSimd( uint16_t * /*ptr*/, int32_t /*width*/, uint8_t /*alphaOffset*/, detail::SimdLevel /*simdLevel*/ )
+{
+	return 0;
+}
+
+} // anonymous namespace
+
 template<typename T>
 void premultiply( SurfaceT<T> *surface )
 {
@@ -41,21 +368,25 @@ void premultiply( SurfaceT<T> *surface )
 	ptrdiff_t rowBytes = surface->getRowBytes();
 	uint8_t pixelInc = surface->getPixelInc();
 	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset(), alphaOffset = surface->getAlphaOffset();
-	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
-		T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
-			// The basic formula for unpremultiplication is to divide by the alpha
-			T alpha = dstPtr[alphaOffset];
-			
-			dstPtr[redOffset] = CHANTRAIT<T>::premultiply( dstPtr[redOffset], alpha );
-			dstPtr[greenOffset] = CHANTRAIT<T>::premultiply( dstPtr[greenOffset], alpha );
-			dstPtr[blueOffset] = CHANTRAIT<T>::premultiply( dstPtr[blueOffset], alpha );
-			dstPtr += pixelInc;
+	const detail::SimdLevel simdLevel = ( pixelInc == 4 ) ? detail::getSimdLevel() : detail::SimdLevel::NONE;
+	detail::parallelBands( clippedArea.getY1(), clippedArea.getY2(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
+			const int32_t simdWidth = premultiplyRowSimd( dstPtr, clippedArea.getWidth(), alphaOffset, simdLevel );
+			dstPtr += simdWidth * pixelInc;
+			for( int32_t x = simdWidth; x < clippedArea.getWidth(); ++x ) {
+				// The basic formula for unpremultiplication is to divide by the alpha
+				T alpha = dstPtr[alphaOffset];
+				
+				dstPtr[redOffset] = CHANTRAIT<T>::premultiply( dstPtr[redOffset], alpha );
+				dstPtr[greenOffset] = CHANTRAIT<T>::premultiply( dstPtr[greenOffset], alpha );
+				dstPtr[blueOffset] = CHANTRAIT<T>::premultiply( dstPtr[blueOffset], alpha );
+				dstPtr += pixelInc;
+			}
 		}
-	}
+	} );
 }
 
-// this is a candidate for sse2
 template<>
 void unpremultiply<uint8_t>( SurfaceT<uint8_t> *surface )
 {
@@ -69,20 +400,25 @@ void unpremultiply<uint8_t>( SurfaceT<uint8_t> *surface )
 	ptrdiff_t rowBytes = surface->getRowBytes();
 	uint8_t pixelInc = surface->getPixelInc();
 	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset(), alphaOffset = surface->getAlphaOffset();
-	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
-		uint8_t *dstPtr = reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes;
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
-			// The basic formula for unpremultiplication is to divide by the alpha
-			// which in 8bit pixel arithmetic is to multiply by 255 and divide by the alpha
-			uint8_t alpha = dstPtr[alphaOffset];
-			if( alpha ) {
-				dstPtr[redOffset] = std::min<int>( dstPtr[redOffset] * 255 / alpha, 255 );
-				dstPtr[greenOffset] = std::min<int>( dstPtr[greenOffset] * 255 / alpha, 255 );
-				dstPtr[blueOffset] = std::min<int>( dstPtr[blueOffset] * 255 / alpha, 255 );
+	const detail::SimdLevel simdLevel = ( pixelInc == 4 ) ? detail::getSimdLevel() : detail::SimdLevel::NONE;
+	detail::parallelBands( clippedArea.getY1(), clippedArea.getY2(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			uint8_t *dstPtr = reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes;
+			const int32_t simdWidth = unpremultiplyRowSimd( dstPtr, clippedArea.getWidth(), alphaOffset, simdLevel );
+			dstPtr += simdWidth * pixelInc;
+			for( int32_t x = simdWidth; x < clippedArea.getWidth(); ++x ) {
+				// The basic formula for unpremultiplication is to divide by the alpha
+				// which in 8bit pixel arithmetic is to multiply by 255 and divide by the alpha
+				uint8_t alpha = dstPtr[alphaOffset];
+				if( alpha ) {
+					dstPtr[redOffset] = std::min<int>( dstPtr[redOffset] * 255 / alpha, 255 );
+					dstPtr[greenOffset] = std::min<int>( dstPtr[greenOffset] * 255 / alpha, 255 );
+					dstPtr[blueOffset] = std::min<int>( dstPtr[blueOffset] * 255 / alpha, 255 );
+				}
+				dstPtr += pixelInc;
 			}
-			dstPtr += pixelInc;
 		}
-	}	
+	} );
 }
 
 template<>
@@ -98,19 +434,24 @@ void unpremultiply<float>( SurfaceT<float> *surface )
 	ptrdiff_t rowBytes = surface->getRowBytes();
 	uint8_t pixelInc = surface->getPixelInc();
 	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset(), alphaOffset = surface->getAlphaOffset();
-	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
-		float *dstPtr = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
-			// The basic formula for unpremultiplication is to divide by the alpha
-			if( dstPtr[alphaOffset] != 0 ) {
-				float invAlpha = 1.0f / dstPtr[alphaOffset];
-				dstPtr[redOffset] *= invAlpha;
-				dstPtr[greenOffset] *= invAlpha;
-				dstPtr[blueOffset] *= invAlpha;
+	const detail::SimdLevel simdLevel = ( pixelInc == 4 ) ? detail::getSimdLevel() : detail::SimdLevel::NONE;
+	detail::parallelBands( clippedArea.getY1(), clippedArea.getY2(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			float *dstPtr = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
+			const int32_t simdWidth = unpremultiplyRowSimd( dstPtr, clippedArea.getWidth(), alphaOffset, simdLevel );
+			dstPtr += simdWidth * pixelInc;
+			for( int32_t x = simdWidth; x < clippedArea.getWidth(); ++x ) {
+				// The basic formula for unpremultiplication is to divide by the alpha
+				if( dstPtr[alphaOffset] != 0 ) {
+					float invAlpha = 1.0f / dstPtr[alphaOffset];
+					dstPtr[redOffset] *= invAlpha;
+					dstPtr[greenOffset] *= invAlpha;
+					dstPtr[blueOffset] *= invAlpha;
+				}
+				dstPtr += pixelInc;
 			}
-			dstPtr += pixelInc;
 		}
-	}	
+	} );
 }
 
 template CI_API void premultiply( SurfaceT<uint8_t> *Surface );
@@ -22,9 +22,11 @@
 
 #include "cinder/Surface.h"
 #include "cinder/ip/Resize.h"
+#include "cinder/ip/ExecutionPolicy.h"
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
 #include "cinder/ChanTraits.h"
+#include "Simd.h"
 
 #include <math.h>
 #include <vector>
@@ -34,6 +36,15 @@ using std::unique_ptr;
 #include <limits>
 #include <fstream>
 #include <algorithm>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#if defined( CINDER_IP_SIMD_X86 )
+	#include <immintrin.h>
+#elif defined( CINDER_IP_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
 
 namespace cinder { namespace ip {
 
@@ -92,143 +103,199 @@ class WeightTable {		/* SAMPLED FILTER WEIGHT TABLE */
     T		*weight;		/* weight[i] goes with pixel at start+i */
 };
 
-template<typename LT, typename AT>
-void scanlineAccumulate( LT weight, LT *lineBuffer, int32_t lineBufferWidth, AT *accum );
 template<typename T, typename WT>
 void makeWeightTable( int32_t b, float cen, const FilterBase &filter, const FilterParams *params, int32_t len, bool trimzeros, WeightTable<WT> *wtab );
 
+// Writes numChannels interleaved accumulators per pixel to the dest scanlines of each channel
 template<typename AT, typename T>
-void scanlineShiftAccumToChannel( AT *accum, int32_t x1, int32_t y, int32_t width, ChannelT<T> *channel )
+void scanlineShiftAccumToChannels( const AT *accum, T * const *dstLines, int8_t pixelStride, size_t numChannels, int32_t width )
 {
-	AT result;
-	T *dst;
-
-	dst = channel->getData( x1, y );
-	int8_t pixelStride = channel->getIncrement();
-
 	for( int32_t i = 0; i < width; i++ ) {
-		result = SCALETRAIT<T>::ACCUMTOCHANNEL( *accum++ );
-		*dst = static_cast<T>( result );
-		dst += pixelStride;
+		for( size_t c = 0; c < numChannels; ++c )
+			dstLines[c][i * pixelStride] = static_cast<T>( SCALETRAIT<T>::ACCUMTOCHANNEL( *accum++ ) );
 	}
 }
 
+// Filters the source scanline of each channel horizontally, interleaving the numChannels results per dest pixel into lineBuffer
 template<typename T, typename WT, typename AT>
-void scanlineFilterChannelToBuffer( WeightTable<WT> *weights, int32_t x, int32_t y, const ChannelT<T> &channel, AT *lineBuffer, int32_t width )
+void scanlineFilterChannelsToBuffer( const WeightTable<WT> *weights, const T * const *srcLines, int8_t pixelStride, size_t numChannels, AT *lineBuffer, int32_t width )
 {
-	int32_t b, af;
-	AT sum;
-	AT *wp;
-	const T *srcLine, *src;
-
-	srcLine = channel.getData( x, y );
-
-	int8_t pixelStride = channel.getIncrement();
-	for ( b = 0; b < width; b++ ) {
-		if( std::numeric_limits<AT>::is_integer )
-			sum = 1 << 7;
-		else
-			sum = 0;
-		src = srcLine + weights->start * pixelStride;
-		wp = weights->weight;
-		for ( af = weights->start; af < weights->end; af++ ) {
-			sum += *wp++ * *src;
-			src += pixelStride;
+	for ( int32_t b = 0; b < width; b++, weights++ ) {
+		for( size_t c = 0; c < numChannels; ++c ) {
+			AT sum;
+			if( std::numeric_limits<AT>::is_integer )
+				sum = 1 << 7;
+			else
+				sum = 0;
+			const T *src = srcLines[c] + weights->start * pixelStride;
+			const WT *wp = weights->weight;
+			for ( int32_t af = weights->start; af < weights->end; af++ ) {
+				sum += *wp++ * *src;
+				src += pixelStride;
+			}
+			*lineBuffer++ = SCALETRAIT<T>::CHANNELTOBUFFER( sum );
 		}
-		*lineBuffer++ = SCALETRAIT<T>::CHANNELTOBUFFER( sum );
-		weights++;
-	}	
+	}
 }
 
-// assumes channels are of same dimensions
-template<typename T>
-void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &filter, const Area &srcArea, const Area &dstArea, const vector<ChannelT<T>*> &dstChannels )
+// The SIMD kernels below filter all four channels of interleaved pixels at once, producing the same results as scanlineFilterChannelsToBuffer()
+#if defined( CINDER_IP_SIMD_X86 )
+// Requires every weight to fit in 16 bits, so that _mm_madd_epi16 can apply the weights of two source pixels per instruction
+CINDER_IP_TARGET_SSE2 void scanlineFilterPixelsToBufferSse2( const WeightTable<int32_t> *weights, const uint8_t *srcLine, int32_t *lineBuffer, int32_t width )
 {
-	Rectf clippedSrcRect;
-	Area clippedDstArea;
-	getClippedScaledRects( srcChannels[0]->getBounds(), Rectf( srcArea ), dstChannels[0]->getBounds(), dstArea, &clippedSrcRect, &clippedDstArea );
-	
-	if ( ( clippedSrcRect.getWidth() <= 0 ) || ( clippedDstArea.getWidth() <= 0 ) 
-		|| ( clippedSrcRect.getHeight() <= 0 ) || ( clippedDstArea.getHeight() <= 0 ) )
-		return;
-	
-	FilterParams filterParamsX, filterParamsY;
-	Mapping m;
-	int32_t dstWidth = (int32_t)clippedDstArea.getWidth(), dstHeight = (int32_t)clippedDstArea.getHeight();
-	int32_t srcWidth = (int32_t)clippedSrcRect.getWidth(), srcHeight = (int32_t)clippedSrcRect.getHeight();
-	int32_t srcOffsetX = static_cast<int32_t>( floor( clippedSrcRect.getX1() ) );
-	int32_t srcOffsetY = static_cast<int32_t>( floor( clippedSrcRect.getY1() ) );
-	vector<pair<int32_t,unique_ptr<typename SCALETRAIT<T>::SUMT[]>>> linesBuffer;
-
-	m.sx = dstWidth / (float)srcWidth;
-	m.sy = dstHeight / (float)srcHeight;
-	m.tx = clippedDstArea.getX1() - 0.5f - m.sx * ( clippedSrcRect.getX1() - 0.5f );
-	m.ty = clippedDstArea.getY1() - 0.5f - m.sy * ( clippedSrcRect.getY1() - 0.5f );
-	m.ux = clippedDstArea.getX1() - m.sx * ( clippedSrcRect.getX1()- 0.5f ) - m.tx;
-	m.uy = clippedDstArea.getY1() - m.sy * ( clippedSrcRect.getY1()- 0.5f ) - m.ty;
-
-	filterParamsX.scale = std::max( 1.0f, 1.0f / m.sx );
-	filterParamsX.supp = std::max( 0.5f, filterParamsX.scale * filter.getSupport() );
-	filterParamsX.width = (int32_t)ceil( 2.0f * filterParamsX.supp );
-
-	filterParamsY.scale = std::max( 1.0f, 1.0f / m.sy );
-	filterParamsY.supp = std::max( 0.5f, filterParamsY.scale * filter.getSupport() );
-	filterParamsY.width = (int32_t)ceil( 2.0f * filterParamsY.supp );
-
-	for( int32_t i = 0; i < filterParamsY.width; i++ )
-		linesBuffer.push_back( std::make_pair( -1, unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] ) ) );
-
-	WeightTable<typename SCALETRAIT<T>::SUMT> *xWeights, yWeights;
-	typename SCALETRAIT<T>::SUMT *xWeightBuffer, *xWeightPtr;
-	xWeights = (WeightTable<typename SCALETRAIT<T>::SUMT>*)malloc( sizeof(WeightTable<int32_t>) * dstWidth );
-	xWeightBuffer = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * dstWidth * filterParamsX.width );
-	yWeights.weight = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * filterParamsY.width );
-	unique_ptr<typename SCALETRAIT<T>::SUMT[]> accum = unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] );
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi32( 1 << 7 );
+	for( int32_t b = 0; b < width; b++, weights++ ) {
+		const uint8_t *src = srcLine + weights->start * 4;
+		const int32_t *wp = weights->weight;
+		const int32_t numTaps = weights->end - weights->start;
+		__m128i sum = round;
+		int32_t i = 0;
+		for( ; i + 2 <= numTaps; i += 2 ) {
+			// r0 r1 g0 g1 b0 b1 a0 a1 as 16-bit values, paired with w0 w1
+			__m128i pixels = _mm_loadl_epi64( (const __m128i*)( src + i * 4 ) );
+			pixels = _mm_unpacklo_epi8( _mm_unpacklo_epi8( pixels, _mm_srli_si128( pixels, 4 ) ), zero );
+			__m128i w = _mm_set1_epi32( ( wp[i] & 0xFFFF ) | ( wp[i + 1] << 16 ) );
+			sum = _mm_add_epi32( sum, _mm_madd_epi16( pixels, w ) );
+		}
+		if( i < numTaps ) {
+			int32_t pixel;
+			memcpy( &pixel, src + i * 4, sizeof(pixel) );
+			__m128i pixels = _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( pixel ), zero ), zero );
+			sum = _mm_add_epi32( sum, _mm_madd_epi16( pixels, _mm_set1_epi32( wp[i] & 0xFFFF ) ) );
+		}
+		_mm_storeu_si128( (__m128i*)( lineBuffer + b * 4 ), _mm_srai_epi32( sum, 8 ) );
+	}
+}
 
-	xWeightPtr = xWeightBuffer;
-	for ( int32_t bx = 0; bx < dstWidth; bx++, xWeightPtr += filterParamsX.width ) {
-		xWeights[bx].weight = xWeightPtr;
-		makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &xWeights[bx] );
+CINDER_IP_TARGET_SSE2 void scanlineFilterPixelsToBufferSse2( const WeightTable<float> *weights, const float *srcLine, float *lineBuffer, int32_t width )
+{
+	for( int32_t b = 0; b < width; b++, weights++ ) {
+		const float *src = srcLine + weights->start * 4;
+		const float *wp = weights->weight;
+		__m128 sum = _mm_setzero_ps();
+		for( int32_t i = 0; i < weights->end - weights->start; i++ )
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_set1_ps( wp[i] ), _mm_loadu_ps( src + i * 4 ) ) );
+		_mm_storeu_ps( lineBuffer + b * 4, sum );
 	}
+}
+#elif defined( CINDER_IP_SIMD_NEON )
+void scanlineFilterPixelsToBufferNeon( const WeightTable<int32_t> *weights, const uint8_t *srcLine, int32_t *lineBuffer, int32_t width )
+{
+	for( int32_t b = 0; b < width; b++, weights++ ) {
+		const uint8_t *src = srcLine + weights->start * 4;
+		const int32_t *wp = weights->weight;
+		int32x4_t sum = vdupq_n_s32( 1 << 7 );
+		for( int32_t i = 0; i < weights->end - weights->start; i++ ) {
+			uint32_t pixel;
+			memcpy( &pixel, src + i * 4, sizeof(pixel) );
+			int32x4_t channels = vreinterpretq_s32_u32( vmovl_u16( vget_low_u16( vmovl_u8( vcreate_u8( pixel ) ) ) ) );
+			sum = vmlaq_n_s32( sum, channels, wp[i] );
+		}
+		vst1q_s32( lineBuffer + b * 4, vshrq_n_s32( sum, 8 ) );
+	}
+}
 
-	for( size_t chan = 0; chan < srcChannels.size(); ++chan ) {
-		for ( int32_t dstY = 0; dstY < dstHeight; ++dstY ) {     // loop over dest scanlines
-			// prepare a weight table for dest y position by
-			makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( MAP(dstY, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &yWeights );
+void scanlineFilterPixelsToBufferNeon( const WeightTable<float> *weights, const float *srcLine, float *lineBuffer, int32_t width )
+{
+	for( int32_t b = 0; b < width; b++, weights++ ) {
+		const float *src = srcLine + weights->start * 4;
+		const float *wp = weights->weight;
+		float32x4_t sum = vdupq_n_f32( 0 );
+		for( int32_t i = 0; i < weights->end - weights->start; i++ )
+			sum = vaddq_f32( sum, vmulq_n_f32( vld1q_f32( src + i * 4 ), wp[i] ) );
+		vst1q_f32( lineBuffer + b * 4, sum );
+	}
+}
+#endif
 
-			memset( accum.get(), 0, sizeof(int32_t) * dstWidth );
+#if defined( CINDER_IP_SIMD_X86 )
+CINDER_IP_TARGET_AVX2 void scanlineAccumulateAvx2( int32_t weight, const int32_t *lineBuffer, int32_t width, int32_t *accum )
+{
+	const __m256i w = _mm256_set1_epi32( weight );
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8 ) {
+		__m256i a = _mm256_loadu_si256( (const __m256i*)( accum + x ) );
+		__m256i l = _mm256_loadu_si256( (const __m256i*)( lineBuffer + x ) );
+		_mm256_storeu_si256( (__m256i*)( accum + x ), _mm256_add_epi32( a, _mm256_mullo_epi32( l, w ) ) );
+	}
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
 
-			// loop over source scanlines that influence this dest scanline
-			for ( int32_t ayf = yWeights.start; ayf < yWeights.end; ayf++ ) {
-				typename SCALETRAIT<T>::SUMT *line = linesBuffer[ayf % filterParamsY.width].second.get();
-				if( linesBuffer[ayf % filterParamsY.width].first != ayf ) {
-					scanlineFilterChannelToBuffer( xWeights, srcOffsetX, srcOffsetY + ayf, *(srcChannels[chan]), line, dstWidth );
-					linesBuffer[ayf % filterParamsY.width].first = ayf;
-				}
-				scanlineAccumulate<typename SCALETRAIT<T>::SUMT,typename SCALETRAIT<T>::SUMT>( yWeights.weight[ayf - yWeights.start], line, dstWidth, accum.get() );
-			}
+CINDER_IP_TARGET_AVX2 void scanlineAccumulateAvx2( float weight, const float *lineBuffer, int32_t width, float *accum )
+{
+	const __m256 w = _mm256_set1_ps( weight );
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8 )
+		_mm256_storeu_ps( accum + x, _mm256_add_ps( _mm256_loadu_ps( accum + x ), _mm256_mul_ps( _mm256_loadu_ps( lineBuffer + x ), w ) ) );
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
 
-			scanlineShiftAccumToChannel( accum.get(), clippedDstArea.getX1(), clippedDstArea.getY1() + dstY, dstWidth, dstChannels[chan] );
-		}
-	}
+CINDER_IP_TARGET_SSE2 void scanlineAccumulateSse2( float weight, const float *lineBuffer, int32_t width, float *accum )
+{
+	const __m128 w = _mm_set1_ps( weight );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 )
+		_mm_storeu_ps( accum + x, _mm_add_ps( _mm_loadu_ps( accum + x ), _mm_mul_ps( _mm_loadu_ps( lineBuffer + x ), w ) ) );
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
+#elif defined( CINDER_IP_SIMD_NEON )
+void scanlineAccumulateNeon( int32_t weight, const int32_t *lineBuffer, int32_t width, int32_t *accum )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 )
+		vst1q_s32( accum + x, vmlaq_n_s32( vld1q_s32( accum + x ), vld1q_s32( lineBuffer + x ), weight ) );
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
 
-	free( xWeights );
-	free( xWeightBuffer );
-	free( yWeights.weight );
+void scanlineAccumulateNeon( float weight, const float *lineBuffer, int32_t width, float *accum )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 )
+		vst1q_f32( accum + x, vmlaq_n_f32( vld1q_f32( accum + x ), vld1q_f32( lineBuffer + x ), weight ) );
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
 }
+#endif
 
-template<typename LT, typename AT>
-void scanlineAccumulate( LT weight, LT *lineBuffer, int32_t width, AT *accum )
+// SSE2 has no 32-bit multiply, so the fixed point path needs AVX2 on x86
+void scanlineAccumulate( int32_t weight, const int32_t *lineBuffer, int32_t width, int32_t *accum, detail::SimdLevel simdLevel )
 {
-	AT *dest = accum;
-	int32_t x;
+#if defined( CINDER_IP_SIMD_X86 )
+	if( simdLevel == detail::SimdLevel::AVX2 )
+		return scanlineAccumulateAvx2( weight, lineBuffer, width, accum );
+#elif defined( CINDER_IP_SIMD_NEON )
+	if( simdLevel == detail::SimdLevel::NEON )
+		return scanlineAccumulateNeon( weight, lineBuffer, width, accum );
+#endif
+
+	for( int32_t x = 0; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
 
-	for ( x = 0; x < width; x++ )
-		*dest++ += *lineBuffer++ * weight;
+void scanlineAccumulate( float weight, const float *lineBuffer, int32_t width, float *accum, detail::SimdLevel simdLevel )
+{
+#if defined( CINDER_IP_SIMD_X86 )
+	if( simdLevel == detail::SimdLevel::AVX2 )
+		return scanlineAccumulateAvx2( weight, lineBuffer, width, accum );
+	else if( simdLevel == detail::SimdLevel::SSE2 )
+		return scanlineAccumulateSse2( weight, lineBuffer, width, accum );
+#elif defined( CINDER_IP_SIMD_NEON )
+	if( simdLevel == detail::SimdLevel::NEON )
+		return scanlineAccumulateNeon( weight, lineBuffer, width, accum );
+#endif
+
+	for( int32_t x = 0; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
 }
 
+// samples[i] is the filter evaluated at source sample start + i, where start is the first sample of [0, len) within the filter's support
 template<typename T, typename WT>
-void makeWeightTable( float cen, const FilterBase &filter, const FilterParams *params, int32_t len, bool trimzeros, WeightTable<WT> *wtab )
+void makeWeightTable( float cen, const float *samples, const FilterParams *params, int32_t len, bool trimzeros, WeightTable<WT> *wtab )
 {
 	int32_t start, end, i, stillzero, lastnonzero, nz;
 	WT *wp, t, sum;
@@ -248,7 +315,7 @@ void makeWeightTable( float cen, const FilterBase &filter, const FilterParams *p
 
 	// find scale factor sc to normalize the filter
 	for ( den = 0, i=start; i < end; i++ )
-		den += filter( ( i + 0.5f - cen ) / params->scale );
+		den += samples[i - wtab->start];
 
 	// set sc so that sum of sc*func() is approximately WEIGHTONE
 	sc = ( den == 0.0f ) ? ( SCALETRAIT<T>::WEIGHTONE ) : ( SCALETRAIT<T>::WEIGHTONE / den );
@@ -257,7 +324,7 @@ void makeWeightTable( float cen, const FilterBase &filter, const FilterParams *p
 	stillzero = trimzeros;
 	for ( sum = 0, wp = wtab->weight, i = start; i < end; i++ ) {
 		// evaluate the filter function:
-		tr = sc * filter( ( i + 0.5f - cen ) / params->scale );
+		tr = sc * samples[i - wtab->start];
 
 		if( std::numeric_limits<WT>::is_integer )
 			t = (WT)floor( tr + 0.5f );
@@ -307,36 +374,292 @@ void makeWeightTable( float cen, const FilterBase &filter, const FilterParams *p
 	}   
 }
 
+// The filter sampled once for every dest sample of one axis, from which the weight tables of either channel type are built
+struct AxisSamples {
+	void	make( const FilterBase &filter, int32_t dstLen, float scale, float offset, const FilterParams &params, int32_t srcLen )
+	{
+		mDstLen = dstLen;
+		mSrcLen = srcLen;
+		mScale = scale;
+		mOffset = offset;
+		mParams = params;
+		mValues.resize( (size_t)dstLen * params.width );
+		for( int32_t b = 0; b < dstLen; ++b ) {
+			// the same range makeWeightTable() starts from
+			const float cen = MAP(b, scale, offset);
+			const int32_t start = std::max( 0, (int32_t)( cen - params.supp + 0.5f ) );
+			const int32_t end = std::min( srcLen, (int32_t)( cen + params.supp + 0.5f ) );
+			for( int32_t i = start; i < end; ++i )
+				mValues[(size_t)b * params.width + ( i - start )] = filter( ( i + 0.5f - cen ) / params.scale );
+		}
+	}
+
+	int32_t			mDstLen, mSrcLen;
+	float			mScale, mOffset;
+	FilterParams	mParams;
+	vector<float>	mValues;
+};
+
+// The weight tables of one axis, one WeightTable per dest sample pointing into a shared buffer
+template<typename WT>
+struct AxisWeights {
+	void	make( const AxisSamples &samples, bool trimzeros )
+	{
+		const int32_t width = samples.mParams.width;
+		mFilterWidth = width;
+		mWeights.resize( (size_t)samples.mDstLen * width );
+		mTables.resize( samples.mDstLen );
+		for( int32_t b = 0; b < samples.mDstLen; ++b ) {
+			mTables[b].weight = &mWeights[(size_t)b * width];
+			makeWeightTable<typename std::conditional<std::is_integral<WT>::value,uint8_t,float>::type,WT>( MAP(b, samples.mScale, samples.mOffset),
+				&samples.mValues[(size_t)b * width], &samples.mParams, samples.mSrcLen, trimzeros, &mTables[b] );
+		}
+	}
+
+	int32_t						mFilterWidth;
+	vector<WeightTable<WT>>		mTables;
+	vector<WT>					mWeights;
+};
+
+void scanlineAccumulate( int32_t weight, const int32_t *lineBuffer, int32_t width, int32_t *accum, detail::SimdLevel simdLevel );
+void scanlineAccumulate( float weight, const float *lineBuffer, int32_t width, float *accum, detail::SimdLevel simdLevel );
+
+struct ResizePlan::Obj {
+	ivec2					mSrcSize, mDstSize;
+	Area					mDstArea;
+	int32_t					mSrcOffsetX, mSrcOffsetY;
+	AxisSamples				mSamplesX, mSamplesY;
+
+	// 8-bit images use fixed point weights, float images use float weights; each pair is built the first time a plan executes with that channel type
+	template<typename WT>
+	std::pair<const AxisWeights<WT>*,const AxisWeights<WT>*>	getWeights() const
+	{
+		if constexpr( std::is_integral_v<WT> ) {
+			std::call_once( mFixedOnce, [this] {
+				mFixedX.make( mSamplesX, true );
+				mFixedY.make( mSamplesY, false );
+				mFixedXFitsInt16 = std::all_of( mFixedX.mWeights.begin(), mFixedX.mWeights.end(), []( int32_t w ) {
+					return w >= std::numeric_limits<int16_t>::min() && w <= std::numeric_limits<int16_t>::max();
+				} );
+			} );
+			return std::make_pair( &mFixedX, &mFixedY );
+		}
+		else {
+			std::call_once( mFloatOnce, [this] {
+				mFloatX.make( mSamplesX, true );
+				mFloatY.make( mSamplesY, false );
+			} );
+			return std::make_pair( &mFloatX, &mFloatY );
+		}
+	}
+
+	mutable std::once_flag			mFixedOnce, mFloatOnce;
+	mutable AxisWeights<int32_t>	mFixedX, mFixedY;
+	mutable AxisWeights<float>		mFloatX, mFloatY;
+	mutable bool					mFixedXFitsInt16;
+};
+
+ResizePlan::ResizePlan( const ivec2 &srcSize, const ivec2 &dstSize, const FilterBase &filter )
+	: ResizePlan( srcSize, Area( ivec2( 0 ), srcSize ), dstSize, Area( ivec2( 0 ), dstSize ), filter )
+{
+}
+
+ResizePlan::ResizePlan( const ivec2 &srcSize, const Area &srcArea, const ivec2 &dstSize, const Area &dstArea, const FilterBase &filter )
+{
+	auto obj = std::make_shared<Obj>();
+	obj->mSrcSize = srcSize;
+	obj->mDstSize = dstSize;
+
+	Rectf clippedSrcRect;
+	getClippedScaledRects( Area( ivec2( 0 ), srcSize ), Rectf( srcArea ), Area( ivec2( 0 ), dstSize ), dstArea, &clippedSrcRect, &obj->mDstArea );
+
+	if ( ( clippedSrcRect.getWidth() <= 0 ) || ( obj->mDstArea.getWidth() <= 0 )
+		|| ( clippedSrcRect.getHeight() <= 0 ) || ( obj->mDstArea.getHeight() <= 0 ) ) {
+		obj->mDstArea = Area( 0, 0, 0, 0 );
+		mObj = obj;
+		return;
+	}
+
+	const Area &clippedDstArea = obj->mDstArea;
+	FilterParams filterParamsX, filterParamsY;
+	Mapping m;
+	int32_t dstWidth = (int32_t)clippedDstArea.getWidth(), dstHeight = (int32_t)clippedDstArea.getHeight();
+	int32_t srcWidth = (int32_t)clippedSrcRect.getWidth(), srcHeight = (int32_t)clippedSrcRect.getHeight();
+	obj->mSrcOffsetX = static_cast<int32_t>( floor( clippedSrcRect.getX1() ) );
+	obj->mSrcOffsetY = static_cast<int32_t>( floor( clippedSrcRect.getY1() ) );
+
+	m.sx = dstWidth / (float)srcWidth;
+	m.sy = dstHeight / (float)srcHeight;
+	m.tx = clippedDstArea.getX1() - 0.5f - m.sx * ( clippedSrcRect.getX1() - 0.5f );
+	m.ty = clippedDstArea.getY1() - 0.5f - m.sy * ( clippedSrcRect.getY1() - 0.5f );
+	m.ux = clippedDstArea.getX1() - m.sx * ( clippedSrcRect.getX1()- 0.5f ) - m.tx;
+	m.uy = clippedDstArea.getY1() - m.sy * ( clippedSrcRect.getY1()- 0.5f ) - m.ty;
+
+	filterParamsX.scale = std::max( 1.0f, 1.0f / m.sx );
+	filterParamsX.supp = std::max( 0.5f, filterParamsX.scale * filter.getSupport() );
+	filterParamsX.width = (int32_t)ceil( 2.0f * filterParamsX.supp );
+
+	filterParamsY.scale = std::max( 1.0f, 1.0f / m.sy );
+	filterParamsY.supp = std::max( 0.5f, filterParamsY.scale * filter.getSupport() );
+	filterParamsY.width = (int32_t)ceil( 2.0f * filterParamsY.supp );
+
+	obj->mSamplesX.make( filter, dstWidth, m.sx, m.ux, filterParamsX, srcWidth );
+	obj->mSamplesY.make( filter, dstHeight, m.sy, m.uy, filterParamsY, srcHeight );
+
+	mObj = obj;
+}
+
+ivec2 ResizePlan::getSrcSize() const
+{
+	return mObj ? mObj->mSrcSize : ivec2( 0 );
+}
+
+ivec2 ResizePlan::getDstSize() const
+{
+	return mObj ? mObj->mDstSize : ivec2( 0 );
+}
+
+Area ResizePlan::getDstArea() const
+{
+	return mObj ? mObj->mDstArea : Area( 0, 0, 0, 0 );
+}
+
+bool ResizePlan::isEmpty() const
+{
+	return ( ! mObj ) || mObj->mDstArea.calcArea() == 0;
+}
+
+void ResizePlan::checkSizes( const ivec2 &srcSize, const ivec2 &dstSize ) const
+{
+	if( srcSize != getSrcSize() || dstSize != getDstSize() )
+		throw Exception( "ResizePlan created for " + std::to_string( getSrcSize().x ) + "x" + std::to_string( getSrcSize().y ) + " -> "
+			+ std::to_string( getDstSize().x ) + "x" + std::to_string( getDstSize().y ) + " executed with " + std::to_string( srcSize.x ) + "x"
+			+ std::to_string( srcSize.y ) + " -> " + std::to_string( dstSize.x ) + "x" + std::to_string( dstSize.y ) );
+}
+
 template<typename T>
-void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter )
+void ResizePlan::resample( const ChannelT<T> * const *srcChannels, ChannelT<T> * const *dstChannels, size_t numChannels ) const
 {
-	vector<const ChannelT<T>*> srcChannels;
-	vector<ChannelT<T>*> dstChannels;
-
-	srcChannels.push_back( &srcSurface.getChannelRed() );
-	dstChannels.push_back( &dstSurface->getChannelRed() );
-	srcChannels.push_back( &srcSurface.getChannelGreen() );
-	dstChannels.push_back( &dstSurface->getChannelGreen() );
-	srcChannels.push_back( &srcSurface.getChannelBlue() );
-	dstChannels.push_back( &dstSurface->getChannelBlue() );
-	if ( srcSurface.hasAlpha() && dstSurface->hasAlpha() ) {
-		srcChannels.push_back( &srcSurface.getChannelAlpha() );
-		dstChannels.push_back( &dstSurface->getChannelAlpha() );	
+	typedef typename SCALETRAIT<T>::SUMT SUMT;
+
+	if( isEmpty() )
+		return;
+
+	// the band function captures a single pointer so that std::function can store it without allocating
+	struct Context {
+		const Obj					*obj;
+		const AxisWeights<SUMT>		*xWeights, *yWeights;
+		const ChannelT<T>			*srcChannels[4];
+		ChannelT<T>					*dstChannels[4];
+		size_t						numChannels;
+		bool						interleaved;
+		detail::SimdLevel			simdLevel;
+	} ctx;
+	ctx.obj = mObj.get();
+	std::tie( ctx.xWeights, ctx.yWeights ) = mObj->template getWeights<SUMT>();
+	ctx.numChannels = numChannels;
+	ctx.simdLevel = detail::getSimdLevel();
+
+	// order the channels as they are laid out in memory, so that the four channels of an interleaved Surface can be filtered as whole pixels
+	size_t order[4] = { 0, 1, 2, 3 };
+	for( size_t i = 1; i < numChannels; ++i ) {
+		for( size_t j = i; j > 0 && srcChannels[order[j]]->getData() < srcChannels[order[j - 1]]->getData(); --j )
+			std::swap( order[j], order[j - 1] );
+	}
+	for( size_t c = 0; c < numChannels; ++c ) {
+		ctx.srcChannels[c] = srcChannels[order[c]];
+		ctx.dstChannels[c] = dstChannels[order[c]];
 	}
+	ctx.interleaved = ( numChannels == 4 ) && ( srcChannels[0]->getIncrement() == 4 ) && ( dstChannels[0]->getIncrement() == 4 );
+	for( size_t c = 0; c < numChannels; ++c )
+		ctx.interleaved = ctx.interleaved && ( ctx.srcChannels[c]->getData() == ctx.srcChannels[0]->getData() + c ) && ( ctx.dstChannels[c]->getData() == ctx.dstChannels[0]->getData() + c );
+	if( std::is_integral<SUMT>::value && ! mObj->mFixedXFitsInt16 )
+		ctx.interleaved = false;
+
+	// Bands of dest scanlines are independent; each one filters the source scanlines it needs into its own line cache,
+	// so source lines that straddle two bands are simply filtered by both.
+	detail::parallelBands( 0, mObj->mDstArea.getHeight(), [&ctx]( int32_t bandY1, int32_t bandY2 ) {
+		const int32_t dstWidth = ctx.obj->mDstArea.getWidth();
+		const int32_t lineLength = dstWidth * (int32_t)ctx.numChannels;
+		const int32_t numLines = ctx.yWeights->mFilterWidth;
+		const bool simdPixels = ctx.interleaved && ctx.simdLevel != detail::SimdLevel::NONE;
+
+		// scratch is reused by every later execution on this thread
+		static thread_local vector<SUMT> tBuffer;
+		static thread_local vector<int32_t> tLineRows;
+		if( tBuffer.size() < (size_t)lineLength * ( numLines + 1 ) )
+			tBuffer.resize( (size_t)lineLength * ( numLines + 1 ) );
+		if( tLineRows.size() < (size_t)numLines )
+			tLineRows.resize( numLines );
+		SUMT *accum = tBuffer.data();
+		SUMT *lines = accum + lineLength;
+		std::fill( tLineRows.begin(), tLineRows.begin() + numLines, -1 );
+
+		const T *srcLines[4];
+		T *dstLines[4];
+		for ( int32_t dstY = bandY1; dstY < bandY2; ++dstY ) {     // loop over dest scanlines
+			const WeightTable<SUMT> &yWeights = ctx.yWeights->mTables[dstY];
+
+			memset( accum, 0, sizeof(SUMT) * lineLength );
+
+			// loop over source scanlines that influence this dest scanline
+			for ( int32_t ayf = yWeights.start; ayf < yWeights.end; ayf++ ) {
+				SUMT *line = lines + (size_t)( ayf % numLines ) * lineLength;
+				if( tLineRows[ayf % numLines] != ayf ) {
+					for( size_t c = 0; c < ctx.numChannels; ++c )
+						srcLines[c] = ctx.srcChannels[c]->getData( ctx.obj->mSrcOffsetX, ctx.obj->mSrcOffsetY + ayf );
+#if defined( CINDER_IP_SIMD_X86 )
+					if( simdPixels )
+						scanlineFilterPixelsToBufferSse2( ctx.xWeights->mTables.data(), srcLines[0], line, dstWidth );
+					else
+#elif defined( CINDER_IP_SIMD_NEON )
+					if( simdPixels )
+						scanlineFilterPixelsToBufferNeon( ctx.xWeights->mTables.data(), srcLines[0], line, dstWidth );
+					else
+#endif
+						scanlineFilterChannelsToBuffer( ctx.xWeights->mTables.data(), srcLines, ctx.srcChannels[0]->getIncrement(), ctx.numChannels, line, dstWidth );
+					tLineRows[ayf % numLines] = ayf;
+				}
+				scanlineAccumulate( yWeights.weight[ayf - yWeights.start], line, lineLength, accum, ctx.simdLevel );
+			}
+
+			for( size_t c = 0; c < ctx.numChannels; ++c )
+				dstLines[c] = ctx.dstChannels[c]->getData( ctx.obj->mDstArea.getX1(), ctx.obj->mDstArea.getY1() + dstY );
+			scanlineShiftAccumToChannels( accum, dstLines, ctx.dstChannels[0]->getIncrement(), ctx.numChannels, dstWidth );
+		}
+	} );
+}
 
-	resample( srcChannels, filter, srcArea, dstArea, dstChannels );
+template<typename T>
+void ResizePlan::execute( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const
+{
+	checkSizes( srcSurface.getSize(), dstSurface->getSize() );
+
+	const ChannelT<T> *srcChannels[4] = { &srcSurface.getChannelRed(), &srcSurface.getChannelGreen(), &srcSurface.getChannelBlue(), &srcSurface.getChannelAlpha() };
+	ChannelT<T> *dstChannels[4] = { &dstSurface->getChannelRed(), &dstSurface->getChannelGreen(), &dstSurface->getChannelBlue(), &dstSurface->getChannelAlpha() };
+	resample( srcChannels, dstChannels, ( srcSurface.hasAlpha() && dstSurface->hasAlpha() ) ? 4 : 3 );
+}
+
+template<typename T>
+void ResizePlan::execute( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel ) const
+{
+	checkSizes( srcChannel.getSize(), dstChannel->getSize() );
+
+	const ChannelT<T> *srcChannels[1] = { &srcChannel };
+	ChannelT<T> *dstChannels[1] = { dstChannel };
+	resample( srcChannels, dstChannels, 1 );
+}
+
+template<typename T>
+void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter )
+{
+	ResizePlan( srcSurface.getSize(), srcArea, dstSurface->getSize(), dstArea, filter ).execute( srcSurface, dstSurface );
 }
 
 template<typename T>
 void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter )
 {
-	vector<const ChannelT<T>*> srcChannels;
-	vector<ChannelT<T>*> dstChannels;
-	
-	srcChannels.push_back( &srcChannel );
-	dstChannels.push_back( dstChannel );
-	
-	resample( srcChannels, filter, srcArea, dstArea, dstChannels );
+	ResizePlan( srcChannel.getSize(), srcArea, dstChannel->getSize(), dstArea, filter ).execute( srcChannel, dstChannel );
 }
 
 template<typename T>
@@ -364,7 +687,9 @@ void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const Filte
 	template CI_API void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter ); \
 	template CI_API void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const FilterBase &filter ); \
 	template CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstSize, const FilterBase &filter ); \
-	template CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter );
+	template CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter ); \
+	template void ResizePlan::execute( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const; \
+	template void ResizePlan::execute( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel ) const;
 
 // These should match CHANNEL_TYPES
 resize_PROTOTYPES(uint8_t)
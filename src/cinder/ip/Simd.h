@@ -0,0 +1,51 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+
+// Build-time SIMD support of the ip:: kernels, shared by the translation units that implement them; not part of the public API.
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+	#define CINDER_IP_SIMD_X86
+	#if defined( _MSC_VER ) && ! defined( __clang__ )
+		#define CINDER_IP_TARGET_SSE2
+		#define CINDER_IP_TARGET_AVX2
+	#else
+		#define CINDER_IP_TARGET_SSE2 __attribute__(( target( "sse2" ) ))
+		#define CINDER_IP_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+	#endif
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+	#define CINDER_IP_SIMD_NEON
+#endif
+
+namespace cinder { namespace ip { namespace detail {
+
+//! Instruction sets the ip:: SIMD kernels are written for, from narrowest to widest.
+enum class SimdLevel { NONE, SSE2, AVX2, NEON };
+
+//! Returns the widest SIMD instruction set supported by both the build and the CPU, or SimdLevel::NONE when the current ExecutionPolicy disables SIMD.
+CI_API SimdLevel getSimdLevel();
+
+} } } // namespace cinder::ip::detail
@@ -21,10 +21,9 @@
 */
 
 #include "cinder/ip/Threshold.h"
+#include "cinder/ip/ExecutionPolicy.h"
 #include "cinder/ChanTraits.h"
 
-#include <stdlib.h>
-
 namespace cinder { namespace ip {
 
 template<typename T>
@@ -35,15 +34,17 @@ void thresholdImpl( SurfaceT<T> *surface, T value, const Area &area )
 	uint8_t pixelInc = surface->getPixelInc();
 	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset();
 	T maxValue = CHANTRAIT<T>::max();
-	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
-		T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
-			dstPtr[redOffset] = ( dstPtr[redOffset] > value ) ? maxValue : 0;
-			dstPtr[greenOffset] = ( dstPtr[greenOffset] > value ) ? maxValue : 0;
-			dstPtr[blueOffset] = ( dstPtr[blueOffset] > value ) ? maxValue : 0;;
-			dstPtr += pixelInc;
+	detail::parallelBands( clippedArea.getY1(), clippedArea.getY2(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
+			for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
+				dstPtr[redOffset] = ( dstPtr[redOffset] > value ) ? maxValue : 0;
+				dstPtr[greenOffset] = ( dstPtr[greenOffset] > value ) ? maxValue : 0;
+				dstPtr[blueOffset] = ( dstPtr[blueOffset] > value ) ? maxValue : 0;;
+				dstPtr += pixelInc;
+			}
 		}
-	}	
+	} );
 }
 
 template<typename T>
@@ -60,17 +61,19 @@ void thresholdImpl( const SurfaceT<T> &srcSurface, T value, const Area &srcArea,
 	uint8_t dstPixelInc = dstSurface->getPixelInc();
 	uint8_t dstRedOffset = dstSurface->getRedOffset(), dstGreenOffset = dstSurface->getGreenOffset(), dstBlueOffset = dstSurface->getBlueOffset();
 	const T maxValue = CHANTRAIT<T>::max();
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( dstSurface->getData() + ( dstOffset.x + area.getX1() ) * dstPixelInc ) + ( y + dstOffset.y ) * dstRowBytes );
-		const T *srcPtr = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( srcSurface.getData() + area.getX1() * srcPixelInc ) + ( y + area.getY1() ) * srcRowBytes );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			dstPtr[dstRedOffset] = ( srcPtr[srcRedOffset] > value ) ? maxValue : 0;
-			dstPtr[dstGreenOffset] = ( srcPtr[srcGreenOffset] > value ) ? maxValue : 0;
-			dstPtr[dstBlueOffset] = ( srcPtr[srcBlueOffset] > value ) ? maxValue : 0;;			
-			dstPtr += dstPixelInc;
-			srcPtr += srcPixelInc;
+	detail::parallelBands( 0, area.getHeight(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( dstSurface->getData() + ( dstOffset.x + area.getX1() ) * dstPixelInc ) + ( y + dstOffset.y ) * dstRowBytes );
+			const T *srcPtr = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( srcSurface.getData() + area.getX1() * srcPixelInc ) + ( y + area.getY1() ) * srcRowBytes );
+			for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
+				dstPtr[dstRedOffset] = ( srcPtr[srcRedOffset] > value ) ? maxValue : 0;
+				dstPtr[dstGreenOffset] = ( srcPtr[srcGreenOffset] > value ) ? maxValue : 0;
+				dstPtr[dstBlueOffset] = ( srcPtr[srcBlueOffset] > value ) ? maxValue : 0;;			
+				dstPtr += dstPixelInc;
+				srcPtr += srcPixelInc;
+			}
 		}
-	}
+	} );
 }
 
 template<typename T>
@@ -83,15 +86,17 @@ void thresholdImpl( const ChannelT<T> &srcChannel, T value, const Area &srcArea,
 	uint8_t srcInc = srcChannel.getIncrement();
 	uint8_t dstInc = dstChannel->getIncrement();
 	const T maxValue = CHANTRAIT<T>::max();
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		T *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) + dstOffset );
-		const T *srcPtr = srcChannel.getData( ivec2( area.getX1(), y ) );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			*dstPtr = ( *srcPtr > value ) ? maxValue : 0;
-			dstPtr += dstInc;
-			srcPtr += srcInc;
+	detail::parallelBands( 0, area.getHeight(), [&]( int32_t y1, int32_t y2 ) {
+		for( int32_t y = y1; y < y2; ++y ) {
+			T *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) + dstOffset );
+			const T *srcPtr = srcChannel.getData( ivec2( area.getX1(), y ) );
+			for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
+				*dstPtr = ( *srcPtr > value ) ? maxValue : 0;
+				dstPtr += dstInc;
+				srcPtr += srcInc;
+			}
 		}
-	}
+	} );
 }
 
 template<typename T>
@@ -119,9 +124,9 @@ void threshold( const ChannelT<T> &srcChannel, T value, ChannelT<T> *dstChannel
 }
 
 template<typename T>
-void calculateAdaptiveThreshold( const ChannelT<T> *srcChannel, typename CHANTRAIT<T>::Accum *integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
+void calculateAdaptiveThreshold( const ChannelT<T> *srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
+	typedef typename IntegralImageT<T>::SumT SUMT;
 
 	int32_t imageWidth = srcChannel->getWidth();
 	int32_t imageHeight = srcChannel->getHeight();
@@ -129,220 +134,148 @@ void calculateAdaptiveThreshold( const ChannelT<T> *srcChannel, typename CHANTRA
 	int s2 = windowSize / 2;
 	uint8_t srcInc = srcChannel->getIncrement();
 	uint8_t dstInc = dstChannel->getIncrement();
+	const SUMT *sums = integralImage.getSums();
+	const size_t stride = integralImage.getStride();
 
 	SUMT comparisonMult = static_cast<SUMT>( ( 1.0f - percentageDelta ) * 256 );
 	const T maxValue = CHANTRAIT<T>::max();
 
 	// perform thresholding
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		T *dstLine = dstChannel->getData( 0, j );
-		T *dst = dstLine;
-		const T *srcLine = srcChannel->getData( 0, j );
-		const T *src = srcLine;
-		for( int32_t i = 0; i< imageWidth; i++ ) {
-
-			// set the SxS region
-			int32_t x1 = i - s2, x2 = i + s2;
-			int32_t y1 = j - s2, y2 = j + s2;
-
-			// check the border
-			if( x1 < 0 ) x1 = 0;
-			if( x2 >= imageWidth ) x2 = imageWidth - 1;
-			if( y1 < 0 ) y1 = 0;
-			if( y2 >= imageHeight ) y2 = imageHeight - 1;
-			
-			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
-
-			// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1)
-			SUMT sum =	integralImage[y2 * imageWidth + x2] -
-						integralImage[y1 * imageWidth + x2] -
-						integralImage[y2 * imageWidth + x1] +
-						integralImage[y1 * imageWidth + x1];
-
-			*dst = ( (SUMT)(*src * count) < (sum * comparisonMult / 256) ) ? 0 : maxValue;
-			dst += dstInc;
-			src += srcInc;
+	detail::parallelBands( 0, imageHeight, [&]( int32_t j1, int32_t j2 ) {
+		for( int32_t j = j1; j < j2; j++ ) {
+			T *dstLine = dstChannel->getData( 0, j );
+			T *dst = dstLine;
+			const T *srcLine = srcChannel->getData( 0, j );
+			const T *src = srcLine;
+			for( int32_t i = 0; i< imageWidth; i++ ) {
+
+				// set the SxS region
+				int32_t x1 = i - s2, x2 = i + s2;
+				int32_t y1 = j - s2, y2 = j + s2;
+
+				// check the border
+				if( x1 < 0 ) x1 = 0;
+				if( x2 >= imageWidth ) x2 = imageWidth - 1;
+				if( y1 < 0 ) y1 = 0;
+				if( y2 >= imageHeight ) y2 = imageHeight - 1;
+				
+				int32_t count = ( x2 - x1 ) * ( y2 - y1 );
+
+				// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1), where the table is offset by one entry in each direction
+				SUMT sum =	sums[( y2 + 1 ) * stride + x2 + 1] -
+							sums[( y1 + 1 ) * stride + x2 + 1] -
+							sums[( y2 + 1 ) * stride + x1 + 1] +
+							sums[( y1 + 1 ) * stride + x1 + 1];
+
+				*dst = ( (SUMT)(*src * count) < (sum * comparisonMult / 256) ) ? 0 : maxValue;
+				dst += dstInc;
+				src += srcInc;
+			}
 		}
-	}
+	} );
 }
 
 template<typename T>
-void calculateAdaptiveThresholdZero( const ChannelT<T> *srcChannel, typename CHANTRAIT<T>::Accum *integralImage, int32_t windowSize, ChannelT<T> *dstChannel )
+void calculateAdaptiveThresholdZero( const ChannelT<T> *srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
+	typedef typename IntegralImageT<T>::SumT SUMT;
 
 	int32_t imageWidth = srcChannel->getWidth();
 	int32_t imageHeight = srcChannel->getHeight();
 	int s2 = windowSize / 2;
 	uint8_t srcInc = srcChannel->getIncrement();
 	uint8_t dstInc = dstChannel->getIncrement();
+	const SUMT *sums = integralImage.getSums();
+	const size_t stride = integralImage.getStride();
 
 	// perform thresholding
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		T *dstLine = dstChannel->getData( 0, j );
-		T *dst = dstLine;
-		const T *srcLine = srcChannel->getData( 0, j );
-		const T *src = srcLine;
-		for( int32_t i = 0; i< imageWidth; i++ ) {
-
-			// set the SxS region
-			int32_t x1 = i - s2, x2 = i + s2;
-			int32_t y1 = j - s2, y2 = j + s2;
-
-			// check the border
-			if( x1 < 0 ) x1 = 0;
-			if( x2 >= imageWidth ) x2 = imageWidth - 1;
-			if( y1 < 0 ) y1 = 0;
-			if( y2 >= imageHeight ) y2 = imageHeight - 1;
-			
-			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
-
-			// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1)
-			SUMT sum =	integralImage[y2 * imageWidth + x2] -
-						integralImage[y1 * imageWidth + x2] -
-						integralImage[y2 * imageWidth + x1] +
-						integralImage[y1 * imageWidth + x1];
-
-			//*dst = ( (*dst * count) < sum ) ? 0 : maxValue;
-			int32_t diffSignExtended = (int32_t)( sum - *src * count );
-			diffSignExtended >>= 31;
-			*dst = (T)(diffSignExtended & 0xFF);
-			dst += dstInc;
-			src += srcInc;
+	detail::parallelBands( 0, imageHeight, [&]( int32_t j1, int32_t j2 ) {
+		for( int32_t j = j1; j < j2; j++ ) {
+			T *dstLine = dstChannel->getData( 0, j );
+			T *dst = dstLine;
+			const T *srcLine = srcChannel->getData( 0, j );
+			const T *src = srcLine;
+			for( int32_t i = 0; i< imageWidth; i++ ) {
+
+				// set the SxS region
+				int32_t x1 = i - s2, x2 = i + s2;
+				int32_t y1 = j - s2, y2 = j + s2;
+
+				// check the border
+				if( x1 < 0 ) x1 = 0;
+				if( x2 >= imageWidth ) x2 = imageWidth - 1;
+				if( y1 < 0 ) y1 = 0;
+				if( y2 >= imageHeight ) y2 = imageHeight - 1;
+				
+				int32_t count = ( x2 - x1 ) * ( y2 - y1 );
+
+				// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1), where the table is offset by one entry in each direction
+				SUMT sum =	sums[( y2 + 1 ) * stride + x2 + 1] -
+							sums[( y1 + 1 ) * stride + x2 + 1] -
+							sums[( y2 + 1 ) * stride + x1 + 1] +
+							sums[( y1 + 1 ) * stride + x1 + 1];
+
+				//*dst = ( (*dst * count) < sum ) ? 0 : maxValue;
+				int32_t diffSignExtended = (int32_t)( sum - *src * count );
+				diffSignExtended >>= 31;
+				*dst = (T)(diffSignExtended & 0xFF);
+				dst += dstInc;
+				src += srcInc;
+			}
 		}
-	}
+	} );
 
 }
 
 template<typename T>
-void calculateIntegralImage( const ChannelT<T> &channel, typename CHANTRAIT<T>::Accum *integralImage )
+void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
-	int32_t imageWidth = channel.getWidth(), imageHeight = channel.getHeight();
-	ptrdiff_t srcRowBytes = channel.getRowBytes();
-	uint8_t srcInc = channel.getIncrement();
-	const T *src = channel.getData();
-	/*for( int32_t i = 0; i < imageWidth; i++ ) {
-		// reset this column sum
-		typename CHANTRAIT<T>::Accum sum = 0;
-
-		for( int32_t j = 0; j < imageHeight; j++ ) {
-			uint32_t index = j * imageWidth + i;
-
-			sum += src[j*srcRowBytes+i*srcInc];
-			if( i == 0 )
-				integralImage[index] = sum;
-			else
-				integralImage[index] = integralImage[index-1] + sum;
-		}
-	}*/
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		// reset this column sum
-		typename CHANTRAIT<T>::Accum sum = 0;
-
-		for( int32_t i = 0; i < imageWidth; i++ ) {		
-			uint32_t index = j * imageWidth + i;
-
-			sum += src[j*srcRowBytes+i*srcInc];
-			if( j == 0 )
-				integralImage[index] = sum;
-			else
-				integralImage[index] = integralImage[index-imageWidth] + sum;
-		}
-	}
+	calculateAdaptiveThreshold( &srcChannel, IntegralImageT<T>( srcChannel ), windowSize, percentageDelta, dstChannel );
 }
 
 template<typename T>
-void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
+void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel.getWidth();
-	int32_t imageHeight = srcChannel.getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( srcChannel, integralImage );
-	
-	calculateAdaptiveThreshold( &srcChannel, integralImage, windowSize, percentageDelta, dstChannel );
-
-	free( integralImage );	
+	calculateAdaptiveThreshold( channel, IntegralImageT<T>( *channel ), windowSize, percentageDelta, channel );
 }
 
 template<typename T>
-void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta )
+void adaptiveThreshold( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = channel->getWidth();
-	int32_t imageHeight = channel->getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( *channel, integralImage );
-
-	calculateAdaptiveThreshold( channel, integralImage, windowSize, percentageDelta, channel );
-
-	free( integralImage );	
+	calculateAdaptiveThreshold( &srcChannel, integralImage, windowSize, percentageDelta, dstChannel );
 }
 
 template<typename T>
 void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = channel->getWidth();
-	int32_t imageHeight = channel->getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( *channel, integralImage );
-	
-	calculateAdaptiveThresholdZero( channel, integralImage, windowSize, channel );
-
-	free( integralImage );	
+	calculateAdaptiveThresholdZero( channel, IntegralImageT<T>( *channel ), windowSize, channel );
 }
 
 template<typename T>
 void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel.getWidth();
-	int32_t imageHeight = srcChannel.getHeight();
-	SUMT *integralImage;
+	calculateAdaptiveThresholdZero( &srcChannel, IntegralImageT<T>( srcChannel ), windowSize, dstChannel );
+}
 
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( srcChannel, integralImage );
-	
+template<typename T>
+void adaptiveThresholdZero( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel )
+{
 	calculateAdaptiveThresholdZero( &srcChannel, integralImage, windowSize, dstChannel );
-
-	free( integralImage );	
 }
 
 template<typename T>
 AdaptiveThresholdT<T>::AdaptiveThresholdT( const ChannelT<T> *channel )
-	: mChannel( channel )
+	: mChannel( channel ), mIntegralImage( *channel )
 {
-	mImageWidth = mChannel->getWidth();
-	mImageHeight = mChannel->getHeight();
-	mIncrement = mChannel->getIncrement();
-
-	// create the integral image
-	mIntegralImage.resize( mImageWidth * mImageHeight );
-	calculateIntegralImage( *channel, mIntegralImage.data() );
 }
 
 template<typename T>
 void AdaptiveThresholdT<T>::calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
 	if( percentageDelta < 0.0001f ) {
-		calculateAdaptiveThresholdZero( mChannel, mIntegralImage.data(), windowSize, dstChannel );
+		calculateAdaptiveThresholdZero( mChannel, mIntegralImage, windowSize, dstChannel );
 	} else {
-		calculateAdaptiveThreshold( mChannel, mIntegralImage.data(), windowSize, percentageDelta, dstChannel );
+		calculateAdaptiveThreshold( mChannel, mIntegralImage, windowSize, percentageDelta, dstChannel );
 	}
 }
 
@@ -357,7 +290,9 @@ template class CI_API AdaptiveThresholdT<float>;
 	template CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel ); \
 	template CI_API void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta ); \
 	template CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize ); \
-	template CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel );
+	template CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel ); \
+	template CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel ); \
+	template CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel );
 
 threshold_PROTOTYPES(uint8_t)
 
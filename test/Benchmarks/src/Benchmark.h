@@ -0,0 +1,141 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! Minimal harness shared by the benchmark suites. Each suite registers itself with BENCHMARK_SUITE() and is run by BenchmarkMain.cpp,
+//! optionally filtered by name: `Benchmarks ip` runs every suite whose name contains "ip".
+
+#pragma once
+
+#include "cinder/Timer.h"
+#include "cinder/TriMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+struct Suite {
+	std::string				mName;
+	std::function<void()>	mFn;
+};
+
+inline std::vector<Suite>& getSuites()
+{
+	static std::vector<Suite> sSuites;
+	return sSuites;
+}
+
+struct SuiteRegistrar {
+	SuiteRegistrar( const char *name, void (*fn)() ) { getSuites().push_back( { name, fn } ); }
+};
+
+//! Returns the best wall-clock time in seconds of a single call to \a fn, taken over at least \a minIterations calls and \a minSeconds total.
+inline double timeIt( const std::function<void()> &fn, int minIterations = 3, double minSeconds = 0.25 )
+{
+	fn(); // warm up caches and any lazily created worker threads
+
+	double best = 1e30, total = 0;
+	for( int i = 0; i < minIterations || total < minSeconds; ++i ) {
+		ci::Timer timer( true );
+		fn();
+		double elapsed = timer.getSeconds();
+		best = std::min( best, elapsed );
+		total += elapsed;
+	}
+	return best;
+}
+
+//! Returns the thread counts every parallel benchmark is measured at: 1, 2, 4 and the number of hardware threads.
+inline std::vector<int> getThreadCounts()
+{
+	std::vector<int> result = { 1, 2, 4 };
+	int hw = (int)std::max( 1u, std::thread::hardware_concurrency() );
+	if( std::find( result.begin(), result.end(), hw ) == result.end() )
+		result.push_back( hw );
+	return result;
+}
+
+//! Prints one result line as throughput in megapixels per second.
+inline void reportMpix( const std::string &name, int numThreads, double pixels, double seconds )
+{
+	std::printf( "  %-36s threads: %2d  %10.2f Mpix/s  (%8.3f ms)\n", name.c_str(), numThreads, pixels / seconds / 1e6, seconds * 1000 );
+}
+
+//! Prints one result line as throughput in gigabytes per second.
+inline void reportGBs( const std::string &name, double bytes, double seconds )
+{
+	std::printf( "  %-48s %10.2f GB/s  (%8.3f ms)\n", name.c_str(), bytes / seconds / 1e9, seconds * 1000 );
+}
+
+//! Prints one result line as throughput in millions of triangles per second.
+inline void reportMtris( const std::string &name, double triangles, double seconds )
+{
+	std::printf( "  %-48s %10.2f Mtri/s  (%8.3f ms)\n", name.c_str(), triangles / seconds / 1e6, seconds * 1000 );
+}
+
+//! Returns an indexed grid of about \a numTriangles triangles over [0, 10] in x and z, displaced in y by a wave offset by \a phase, with exact normals and tex coords on request.
+inline ci::TriMesh makeGrid( size_t numTriangles, bool normals = false, bool texCoords = false, float phase = 0 )
+{
+	ci::TriMesh::Format format = ci::TriMesh::Format().positions();
+	if( normals )
+		format.normals();
+	if( texCoords )
+		format.texCoords();
+
+	const int n = std::max( 2, (int)std::sqrt( numTriangles / 2.0 ) + 1 );
+	ci::TriMesh result( format );
+	for( int y = 0; y < n; ++y ) {
+		for( int x = 0; x < n; ++x ) {
+			const float u = x / float( n - 1 ), v = y / float( n - 1 );
+			result.appendPosition( ci::vec3( u * 10, std::sin( u * 20 + phase ) * std::cos( v * 20 ), v * 10 ) );
+			if( normals ) {
+				// the height's slopes along x and z, which run 10 units for each unit of u and v
+				const float dx = 2 * std::cos( u * 20 + phase ) * std::cos( v * 20 ), dz = -2 * std::sin( u * 20 + phase ) * std::sin( v * 20 );
+				result.appendNormal( ci::normalize( ci::vec3( -dx, 1, -dz ) ) );
+			}
+			if( texCoords )
+				result.appendTexCoord( ci::vec2( u, v ) );
+		}
+	}
+	for( int y = 0; y + 1 < n; ++y ) {
+		for( int x = 0; x + 1 < n; ++x ) {
+			const uint32_t a = y * n + x, b = a + 1, c = a + n, d = c + 1;
+			result.appendTriangle( a, d, b );
+			result.appendTriangle( a, c, d );
+		}
+	}
+
+	return result;
+}
+
+} // namespace bench
+
+#define BENCHMARK_SUITE( NAME ) \
+	static void NAME##_suite(); \
+	static bench::SuiteRegistrar NAME##_registrar( #NAME, &NAME##_suite ); \
+	static void NAME##_suite()
@@ -0,0 +1,160 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/ConcurrentCircularBuffer.h"
+
+#include <atomic>
+#include <chrono>
+
+using namespace ci;
+
+namespace {
+
+int64_t nowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// Moves \a numItems items per producer from \a numProducers to \a numConsumers threads, \a batchSize at a time where the buffer supports batches,
+// returning items per second
+template<typename BufferT>
+double measureThroughput( BufferT &buffer, int numProducers, int numConsumers, int64_t numItems, size_t batchSize )
+{
+	std::atomic<int64_t> numPopped( 0 );
+	const int64_t total = numItems * numProducers;
+	std::vector<std::thread> threads;
+	ci::Timer timer( true );
+	for( int p = 0; p < numProducers; ++p ) {
+		threads.emplace_back( [&] {
+			std::vector<int64_t> batch( batchSize );
+			for( int64_t i = 0; i < numItems; i += (int64_t)batchSize ) {
+				if constexpr( std::is_same_v<BufferT, ConcurrentCircularBuffer<int64_t>> ) {
+					for( size_t b = 0; b < batchSize; ++b )
+						buffer.pushFront( i + b );
+				}
+				else {
+					for( size_t b = 0; b < batchSize; ++b )
+						batch[b] = i + b;
+					if( batchSize == 1 )
+						buffer.pushFront( i );
+					else
+						buffer.pushFront( batch.begin(), batch.end() );
+				}
+			}
+		} );
+	}
+	for( int c = 0; c < numConsumers; ++c ) {
+		threads.emplace_back( [&] {
+			std::vector<int64_t> batch( batchSize );
+			while( numPopped.load( std::memory_order_relaxed ) < total ) {
+				// consumers still waiting once everything has been popped are released by cancel(), after the timing
+				size_t count = 1;
+				if constexpr( std::is_same_v<BufferT, ConcurrentCircularBuffer<int64_t>> )
+					buffer.popBack( batch.data() );
+				else if( batchSize == 1 )
+					buffer.popBack( batch.data() );
+				else
+					count = buffer.popBack( batch.data(), batchSize );
+				numPopped.fetch_add( (int64_t)count, std::memory_order_relaxed );
+			}
+		} );
+	}
+	for( int p = 0; p < numProducers; ++p )
+		threads[p].join();
+	while( numPopped.load() < total )
+		std::this_thread::yield();
+	const double seconds = timer.getSeconds();
+	buffer.cancel();
+	for( auto &thread : threads )
+		if( thread.joinable() )
+			thread.join();
+	buffer.uncancel();
+
+	return total / seconds;
+}
+
+// Hands over single items spaced out in time, so that the consumer has usually gone to sleep, and returns the sorted delays between push and pop in nanoseconds
+template<typename BufferT>
+std::vector<float> measureLatency( BufferT &buffer, int numItems )
+{
+	std::vector<float> result;
+	result.reserve( numItems );
+	std::thread consumer( [&] {
+		int64_t pushedNs = 0;
+		for( int i = 0; i < numItems; ++i ) {
+			buffer.popBack( &pushedNs );
+			result.push_back( float( nowNs() - pushedNs ) );
+		}
+	} );
+	for( int i = 0; i < numItems; ++i ) {
+		std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+		buffer.pushFront( nowNs() );
+	}
+	consumer.join();
+
+	std::sort( result.begin(), result.end() );
+	return result;
+}
+
+template<typename BufferT>
+void report( const std::string &name, BufferT &buffer, int numProducers, int numConsumers, int64_t numItems, size_t batchSize, bool latency )
+{
+	const double itemsPerSecond = measureThroughput( buffer, numProducers, numConsumers, numItems, batchSize );
+	std::printf( "  %-44s %8.2f M items/s", name.c_str(), itemsPerSecond / 1e6 );
+	if( latency ) {
+		const std::vector<float> l = measureLatency( buffer, 4000 );
+		std::printf( "   handoff p50 %7.0f ns  p99 %8.0f ns  max %8.0f ns", l[l.size() / 2], l[l.size() * 99 / 100], l.back() );
+	}
+	std::printf( "\n" );
+}
+
+} // anonymous namespace
+
+// Throughput with every thread pushing or popping as fast as it can through a buffer of 1024 items, and the push to pop delay of sparse items
+BENCHMARK_SUITE( circularBuffer )
+{
+	const size_t capacity = 1024;
+	const int64_t numItems = 1000000;
+
+	std::printf( "  1 producer, 1 consumer\n" );
+	ConcurrentCircularBuffer<int64_t> mutexBuffer( capacity );
+	report( "ConcurrentCircularBuffer", mutexBuffer, 1, 1, numItems, 1, true );
+	for( uint32_t spinCount : { 0u, detail::CIRCULAR_BUFFER_DEFAULT_SPIN_COUNT } ) {
+		SpscCircularBuffer<int64_t> spsc( capacity, spinCount );
+		MpmcCircularBuffer<int64_t> mpmc( capacity, spinCount );
+		const std::string spin = ", spin " + std::to_string( spinCount );
+		report( "SpscCircularBuffer" + spin, spsc, 1, 1, numItems, 1, true );
+		report( "SpscCircularBuffer, batches of 32" + spin, spsc, 1, 1, numItems, 32, false );
+		report( "MpmcCircularBuffer" + spin, mpmc, 1, 1, numItems, 1, true );
+	}
+
+	for( int numThreads : { 2, 4 } ) {
+		std::printf( "  %d producers, %d consumers\n", numThreads, numThreads );
+		report( "ConcurrentCircularBuffer", mutexBuffer, numThreads, numThreads, numItems / numThreads, 1, false );
+		MpmcCircularBuffer<int64_t> mpmc( capacity );
+		report( "MpmcCircularBuffer", mpmc, numThreads, numThreads, numItems / numThreads, 1, false );
+		report( "MpmcCircularBuffer, batches of 32", mpmc, numThreads, numThreads, numItems / numThreads, 32, false );
+	}
+}
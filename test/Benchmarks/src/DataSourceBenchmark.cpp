@@ -0,0 +1,93 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/DataSource.h"
+#include "cinder/Filesystem.h"
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace ci;
+
+namespace {
+
+// Reads one byte of every page, so that the mapped variants pay for faulting the file in just like the copying ones do
+uint64_t touchPages( const Buffer &buffer )
+{
+	const uint8_t *data = static_cast<const uint8_t*>( buffer.getData() );
+	uint64_t sum = 0;
+	for( size_t i = 0; i < buffer.getSize(); i += 4096 )
+		sum += data[i];
+	return sum;
+}
+
+uint64_t readStream( const IStreamRef &stream )
+{
+	std::vector<uint8_t> chunk( 64 * 1024 );
+	uint64_t sum = 0;
+	while( ! stream->isEof() ) {
+		size_t bytes = stream->readDataAvailable( chunk.data(), chunk.size() );
+		if( bytes == 0 )
+			break;
+		sum += chunk[0];
+	}
+	return sum;
+}
+
+} // anonymous namespace
+
+// Set CINDER_BENCHMARK_FILE_MB to change the size of the file, which defaults to 2GB
+BENCHMARK_SUITE( dataSource )
+{
+	const char *sizeEnv = std::getenv( "CINDER_BENCHMARK_FILE_MB" );
+	const size_t size = size_t( sizeEnv ? std::atoll( sizeEnv ) : 2048 ) * 1024 * 1024;
+	const fs::path path = fs::temp_directory_path() / "cinder_benchmark_data_source.bin";
+	{
+		std::ofstream out( path.string(), std::ios::binary );
+		std::vector<char> block( 1024 * 1024, 'x' );
+		for( size_t written = 0; written < size; written += block.size() )
+			out.write( block.data(), block.size() );
+	}
+	std::printf( "  %zu MB file, warm page cache\n", size / ( 1024 * 1024 ) );
+
+	volatile uint64_t sink = 0;
+	bench::reportGBs( "loadFile()->getBuffer() read into memory", (double)size, bench::timeIt( [&] {
+		sink = sink + touchPages( *DataSourcePath::create( path, false )->getBuffer() );
+	} ) );
+	bench::reportGBs( "loadFile()->getBuffer() mapped, every page", (double)size, bench::timeIt( [&] {
+		sink = sink + touchPages( *DataSourcePath::create( path )->getBuffer() );
+	} ) );
+	bench::reportGBs( "loadFile()->getBuffer() mapped, untouched", (double)size, bench::timeIt( [&] {
+		sink = sink + DataSourcePath::create( path )->getBuffer()->getSize();
+	} ) );
+	bench::reportGBs( "createStream() IStreamFile 64KB reads", (double)size, bench::timeIt( [&] {
+		sink = sink + readStream( DataSourcePath::create( path, false )->createStream() );
+	} ) );
+	bench::reportGBs( "createStream() IStreamMapped 64KB reads", (double)size, bench::timeIt( [&] {
+		sink = sink + readStream( DataSourcePath::create( path )->createStream() );
+	} ) );
+
+	fs::remove( path );
+}
@@ -0,0 +1,128 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/Rand.h"
+#include "cinder/Surface.h"
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/ip/Flip.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/Resize.h"
+#include "cinder/ip/Threshold.h"
+
+using namespace ci;
+
+namespace {
+
+const int32_t kWidth = 2048, kHeight = 2048;
+
+Surface8u makeNoiseSurface( bool alpha )
+{
+	Surface8u result( kWidth, kHeight, alpha );
+	Rand rnd( 1234 );
+	uint8_t *data = result.getData();
+	size_t size = result.getRowBytes() * result.getHeight();
+	for( size_t i = 0; i < size; ++i )
+		data[i] = (uint8_t)rnd.nextUint( 256 );
+	return result;
+}
+
+// Runs fn once per thread count under a matching ExecutionPolicy and reports its throughput over pixels.
+void measure( const std::string &name, double pixels, const std::function<void()> &fn )
+{
+	for( int numThreads : bench::getThreadCounts() ) {
+		ip::ScopedExecutionPolicy policy( ip::ExecutionPolicy::parallel( numThreads ) );
+		bench::reportMpix( name, numThreads, pixels, bench::timeIt( fn ) );
+	}
+}
+
+// Reports the serial throughput of fn with the SIMD kernels disabled, as a baseline for measure()
+void measureScalar( const std::string &name, double pixels, const std::function<void()> &fn )
+{
+	ip::ScopedExecutionPolicy policy( ip::ExecutionPolicy::serial().simd( false ) );
+	bench::reportMpix( name + " (scalar)", 1, pixels, bench::timeIt( fn ) );
+}
+
+} // anonymous namespace
+
+BENCHMARK_SUITE( ip )
+{
+	const double pixels = (double)kWidth * kHeight;
+
+	Surface8u rgba = makeNoiseSurface( true );
+	Surface8u rgb = makeNoiseSurface( false );
+	Surface8u dst( kWidth, kHeight, true );
+	Channel8u gray( rgb );
+	Channel8u grayDst( kWidth, kHeight );
+	Surface32f rgba32f( rgba );
+	Channel32f gray32f( rgba32f );
+
+	measure( "stackBlur Surface8u r=8", pixels, [&] { ip::stackBlur( &rgba, 8 ); } );
+	measure( "stackBlur Channel8u r=8", pixels, [&] { ip::stackBlur( &gray, 8 ); } );
+	measure( "stackBlur Surface32f r=8", pixels, [&] { ip::stackBlur( &rgba32f, 8 ); } );
+	measure( "boxBlur Surface8u r=8", pixels, [&] { ip::boxBlur( &rgba, 8 ); } );
+	measure( "gaussianBlur Surface8u sigma=2", pixels, [&] { ip::gaussianBlur( &rgba, 2 ); } );
+	measure( "gaussianBlur Surface8u sigma=20", pixels, [&] { ip::gaussianBlur( &rgba, 20 ); } );
+	measure( "gaussianBlur Surface8u sigma=100", pixels, [&] { ip::gaussianBlur( &rgba, 100 ); } );
+	measure( "gaussianBlur Channel32f sigma=20", pixels, [&] { ip::gaussianBlur( &gray32f, 20 ); } );
+
+	Surface8u half( kWidth / 2, kHeight / 2, true );
+	measure( "resize Surface8u 1/2 triangle", pixels, [&] { ip::resize( rgba, &half ); } );
+	measure( "resize Surface8u 1/2 cubic", pixels, [&] { ip::resize( rgba, &half, FilterCubic() ); } );
+
+	// the same camera frame size resized repeatedly, rebuilding the weights on every call versus reusing a ResizePlan
+	Surface8u frame = rgba.clone( Area( 0, 0, 1920, 1080 ) );
+	Surface8u frameSmall( 640, 360, true );
+	ip::ResizePlan framePlan( frame.getSize(), frameSmall.getSize(), FilterCubic() );
+	const double framePixels = 1920.0 * 1080.0;
+	measure( "resize Surface8u 1080p -> 360p cubic", framePixels, [&] { ip::resize( frame, &frameSmall, FilterCubic() ); } );
+	measure( "ResizePlan Surface8u 1080p -> 360p cubic", framePixels, [&] { framePlan.execute( frame, &frameSmall ); } );
+	measureScalar( "ResizePlan Surface8u 1080p -> 360p cubic", framePixels, [&] { framePlan.execute( frame, &frameSmall ); } );
+
+	measure( "edgeDetectSobel Channel8u", pixels, [&] { ip::edgeDetectSobel( gray, &grayDst ); } );
+	measure( "threshold Surface8u", pixels, [&] { ip::threshold( rgba, (uint8_t)128, &dst ); } );
+	measure( "adaptiveThreshold Channel8u w=15", pixels, [&] { ip::adaptiveThreshold( gray, 15, 0.1f, &grayDst ); } );
+	ip::IntegralImage8u integral( gray, true );
+	measure( "IntegralImage8u build with squares", pixels, [&] { integral.update( gray ); } );
+	measure( "adaptiveThreshold Channel8u w=15 shared IntegralImage", pixels, [&] { ip::adaptiveThreshold( gray, integral, 15, 0.1f, &grayDst ); } );
+	measure( "boxFilter Channel8u w=31 shared IntegralImage", pixels, [&] { ip::boxFilter( integral, 31, &grayDst ); } );
+	measure( "localContrastNormalize Channel8u w=31 shared IntegralImage", pixels, [&] { ip::localContrastNormalize( gray, integral, 31, &gray32f ); } );
+	measure( "blend Surface8u", pixels, [&] { ip::blend( &dst, rgba ); } );
+	Surface8u premultDst = dst.clone();
+	premultDst.setPremultiplied( true );
+	measure( "blend Surface8u premult dst", pixels, [&] { ip::blend( &premultDst, rgba ); } );
+	measureScalar( "blend Surface8u premult dst", pixels, [&] { ip::blend( &premultDst, rgba ); } );
+	measure( "blend Surface32f", pixels, [&] { ip::blend( &rgba32f, rgba32f ); } );
+	measureScalar( "blend Surface32f", pixels, [&] { ip::blend( &rgba32f, rgba32f ); } );
+	measure( "grayscale Surface8u -> Channel8u", pixels, [&] { ip::grayscale( rgba, &grayDst ); } );
+	measureScalar( "grayscale Surface8u -> Channel8u", pixels, [&] { ip::grayscale( rgba, &grayDst ); } );
+	measure( "premultiply+unpremultiply Surface8u", pixels, [&] { ip::premultiply( &rgba ); ip::unpremultiply( &rgba ); } );
+	measureScalar( "premultiply+unpremultiply Surface8u", pixels, [&] { ip::premultiply( &rgba ); ip::unpremultiply( &rgba ); } );
+	measure( "flipVertical Surface8u in-place", pixels, [&] { ip::flipVertical( &rgba ); } );
+}
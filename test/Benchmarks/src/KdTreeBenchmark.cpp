@@ -0,0 +1,94 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/KdTree.h"
+#include "cinder/Rand.h"
+
+#include <cstdlib>
+
+using namespace ci;
+
+namespace {
+
+void reportQueries( const std::string &name, size_t numQueries, double seconds )
+{
+	std::printf( "  %-48s %10.3f us/query  (%8.3f ms)\n", name.c_str(), seconds / numQueries * 1e6, seconds * 1000 );
+}
+
+} // anonymous namespace
+
+// Set CINDER_BENCHMARK_KDTREE_POINTS to change the number of points, which defaults to 1M
+BENCHMARK_SUITE( kdTree )
+{
+	const char *pointsEnv = std::getenv( "CINDER_BENCHMARK_KDTREE_POINTS" );
+	const size_t numPoints = pointsEnv ? (size_t)std::atoll( pointsEnv ) : 1000000;
+
+	// a flock in a unit cube, whose members each query their neighborhood
+	std::vector<vec3> points( numPoints );
+	Rand rnd( 1 );
+	for( vec3 &p : points )
+		p = vec3( rnd.nextFloat(), rnd.nextFloat(), rnd.nextFloat() );
+	std::printf( "  %zu random points in a unit cube\n", numPoints );
+
+	KdTree<vec3> tree;
+	for( int numThreads : bench::getThreadCounts() ) {
+		const double seconds = bench::timeIt( [&] { tree.initialize( points, KdTree<vec3>::DEFAULT_LEAF_SIZE, numThreads ); }, 1, 0 );
+		std::printf( "  %-48s %10.1f Mpoints/s  (%8.3f ms)\n", ( "build, threads: " + std::to_string( numThreads ) ).c_str(), numPoints / seconds * 1e-6, seconds * 1000 );
+	}
+
+	const size_t k = 8, maxResults = 32;
+	// about 16 neighbors per point
+	const float radius = std::cbrt( 16 / ( numPoints * 4.18879f ) );
+	std::vector<uint32_t> indices( numPoints * maxResults ), counts( numPoints );
+	std::vector<float> distancesSqrd( numPoints * k );
+	for( int numThreads : bench::getThreadCounts() ) {
+		reportQueries( "findNearest() batch of k = 8, threads: " + std::to_string( numThreads ), numPoints, bench::timeIt( [&] {
+			tree.findNearest( points.data(), numPoints, k, indices.data(), distancesSqrd.data(), FLT_MAX, numThreads );
+		}, 1, 0 ) );
+		reportQueries( "findInRadius() batch, threads: " + std::to_string( numThreads ), numPoints, bench::timeIt( [&] {
+			tree.findInRadius( points.data(), numPoints, radius, maxResults, indices.data(), counts.data(), nullptr, numThreads );
+		}, 1, 0 ) );
+	}
+	size_t numFound = 0;
+	for( uint32_t count : counts )
+		numFound += count;
+	std::printf( "    %.1f points per radius\n", numFound / double( numPoints ) );
+
+	// single queries, through the k-nearest and the legacy interfaces
+	const size_t numQueries = 100000;
+	reportQueries( "findNearest() of k = 1", numQueries, bench::timeIt( [&] {
+		uint32_t index;
+		for( size_t i = 0; i < numQueries; ++i )
+			tree.findNearest( points[i], 1, &index );
+	} ) );
+	reportQueries( "legacy findNearest()", numQueries, bench::timeIt( [&] {
+		float result[3];
+		uint32_t index;
+		for( size_t i = 0; i < numQueries; ++i ) {
+			float p[3] = { points[i].x, points[i].y, points[i].z };
+			tree.findNearest( p, result, &index );
+		}
+	} ) );
+}
@@ -0,0 +1,113 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/DataSource.h"
+#include "cinder/Filesystem.h"
+#include "cinder/Rand.h"
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace ci;
+
+namespace {
+
+// IStreamCinder::readLine() as it was before it scanned the stream's buffer, reading a character at a time
+std::string readLineCharacterwise( IStreamCinder &stream )
+{
+	std::string result;
+	int8_t ch;
+	while( ! stream.isEof() ) {
+		stream.read( &ch );
+		if( ch == 0x0A )
+			break;
+		else if( ch == 0x0D ) {
+			stream.read( &ch );
+			if( ch != 0x0A )
+				stream.seekRelative( -1 );
+			break;
+		}
+		else
+			result += ch;
+	}
+
+	return result;
+}
+
+} // anonymous namespace
+
+// Set CINDER_BENCHMARK_TEXT_MB to change the size of the text file, which defaults to 500MB
+BENCHMARK_SUITE( lineReader )
+{
+	const char *sizeEnv = std::getenv( "CINDER_BENCHMARK_TEXT_MB" );
+	const size_t size = size_t( sizeEnv ? std::atoll( sizeEnv ) : 500 ) * 1024 * 1024;
+	const fs::path path = fs::temp_directory_path() / "cinder_benchmark_line_reader.txt";
+	size_t numLines = 0;
+	{
+		// OBJ style vertex lines with the occasional long comment
+		std::ofstream out( path.string(), std::ios::binary );
+		Rand rnd( 1 );
+		char line[256];
+		for( size_t written = 0; written < size; ++numLines ) {
+			int length = ( numLines % 100 == 99 ) ? std::snprintf( line, sizeof( line ), "# %0200u\n", rnd.nextUint() )
+				: std::snprintf( line, sizeof( line ), "v %f %f %f\n", rnd.nextFloat(), rnd.nextFloat(), rnd.nextFloat() );
+			out.write( line, length );
+			written += length;
+		}
+	}
+	std::printf( "  %zu MB file of %zu lines, warm page cache\n", size / ( 1024 * 1024 ), numLines );
+
+	volatile size_t sink = 0;
+	bench::reportGBs( "character at a time readLine() IStreamFile", (double)size, bench::timeIt( [&] {
+		IStreamRef stream = DataSourcePath::create( path, false )->createStream();
+		while( ! stream->isEof() )
+			sink = sink + readLineCharacterwise( *stream ).size();
+	}, 1, 0 ) );
+	bench::reportGBs( "character at a time readLine() IStreamMapped", (double)size, bench::timeIt( [&] {
+		IStreamRef stream = DataSourcePath::create( path )->createStream();
+		while( ! stream->isEof() )
+			sink = sink + readLineCharacterwise( *stream ).size();
+	}, 1, 0 ) );
+	bench::reportGBs( "readLine() IStreamFile", (double)size, bench::timeIt( [&] {
+		IStreamRef stream = DataSourcePath::create( path, false )->createStream();
+		while( ! stream->isEof() )
+			sink = sink + stream->readLine().size();
+	}, 1, 0 ) );
+	bench::reportGBs( "readLine() IStreamMapped", (double)size, bench::timeIt( [&] {
+		IStreamRef stream = DataSourcePath::create( path )->createStream();
+		while( ! stream->isEof() )
+			sink = sink + stream->readLine().size();
+	}, 1, 0 ) );
+	bench::reportGBs( "LineReader IStreamFile", (double)size, bench::timeIt( [&] {
+		for( std::string_view line : LineReader( DataSourcePath::create( path, false )->createStream() ) )
+			sink = sink + line.size();
+	}, 1, 0 ) );
+	bench::reportGBs( "LineReader IStreamMapped", (double)size, bench::timeIt( [&] {
+		for( std::string_view line : LineReader( DataSourcePath::create( path )->createStream() ) )
+			sink = sink + line.size();
+	}, 1, 0 ) );
+
+	fs::remove( path );
+}
@@ -0,0 +1,124 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/LogDeferred.h"
+
+#include <chrono>
+
+using namespace ci;
+
+namespace {
+
+struct Result {
+	double					mSeconds;
+	std::vector<float>		mLatencies; // nanoseconds, sorted
+};
+
+// Logs \a numEntries entries from each of \a numThreads threads to \a logger, returning the time until every entry has been written
+// and the time each CI_LOG_I, or CI_LOG_DEFERRED_I when \a deferred, statement took for its caller.
+Result logFromThreads( const log::LoggerRef &logger, int numThreads, int numEntries, bool deferred )
+{
+	log::manager()->resetLogger( logger );
+
+	std::vector<std::vector<float>> latencies( numThreads );
+	std::vector<std::thread> threads;
+	ci::Timer timer( true );
+	for( int t = 0; t < numThreads; ++t ) {
+		threads.emplace_back( [&, t] {
+			latencies[t].reserve( numEntries );
+			for( int i = 0; i < numEntries; ++i ) {
+				auto start = std::chrono::steady_clock::now();
+				if( deferred )
+					CI_LOG_DEFERRED_I( "thread {} entry {} value {}", t, i, i * 0.5f );
+				else
+					CI_LOG_I( "thread " << t << " entry " << i << " value " << i * 0.5f );
+				latencies[t].push_back( std::chrono::duration<float, std::nano>( std::chrono::steady_clock::now() - start ).count() );
+			}
+		} );
+	}
+	for( auto &thread : threads )
+		thread.join();
+	if( deferred )
+		log::deferredManager()->flush();
+	log::manager()->flush();
+
+	Result result;
+	result.mSeconds = timer.getSeconds();
+	for( const auto &threadLatencies : latencies )
+		result.mLatencies.insert( result.mLatencies.end(), threadLatencies.begin(), threadLatencies.end() );
+	std::sort( result.mLatencies.begin(), result.mLatencies.end() );
+	return result;
+}
+
+void report( const std::string &name, int numThreads, double numEntries, const Result &result )
+{
+	const auto &l = result.mLatencies;
+	std::printf( "  %-28s threads: %d  %7.2f M entries/s   caller p50 %7.0f ns  p99 %8.0f ns  max %8.2f ms\n", name.c_str(), numThreads, numEntries / result.mSeconds / 1e6,
+		l[l.size() / 2], l[l.size() * 99 / 100], l.back() / 1e6 );
+}
+
+} // anonymous namespace
+
+// Every producer thread logs short formatted entries to a LoggerFile as fast as it can.
+// Async and deferred entries are counted once flush() returns. Deferred entries block on a full buffer, like "async, block",
+// and in binary mode are only written to the binary file.
+BENCHMARK_SUITE( log )
+{
+	const fs::path path = fs::temp_directory_path() / "cinder_benchmark_log.txt";
+	const fs::path binaryPath = fs::temp_directory_path() / "cinder_benchmark_log.bin";
+	const int numEntries = 50000;
+	log::DeferredLogManager *deferred = log::deferredManager();
+	deferred->setOverflowPolicy( log::OVERFLOW_BLOCK );
+
+	for( int numThreads : { 1, 2, 4, 8 } ) {
+		for( int mode = 0; mode < 5; ++mode ) {
+			if( mode == 1 || mode == 2 )
+				log::manager()->enableAsync( 8192, mode == 1 ? log::OVERFLOW_BLOCK : log::OVERFLOW_DROP );
+			if( mode == 4 ) {
+				fs::remove( binaryPath );
+				deferred->setBinaryFile( binaryPath );
+				deferred->setFormatToLoggers( false );
+			}
+
+			fs::remove( path );
+			const uint64_t numDroppedBefore = deferred->getNumDropped();
+			Result result = logFromThreads( std::make_shared<log::LoggerFile>( path, false ), numThreads, numEntries, mode >= 3 );
+			const uint64_t numDropped = mode >= 3 ? deferred->getNumDropped() - numDroppedBefore : log::manager()->getNumDropped();
+			const char *modes[] = { "sync", "async, block", "async, drop", "deferred, text", "deferred, binary" };
+			report( std::string( "LoggerFile " ) + modes[mode], numThreads, double( numThreads ) * numEntries - numDropped, result );
+			if( mode == 2 )
+				std::printf( "    %llu entries dropped\n", (unsigned long long)numDropped );
+
+			log::manager()->disableAsync();
+			deferred->setBinaryFile( fs::path() );
+			deferred->setFormatToLoggers( true );
+		}
+	}
+
+	deferred->setOverflowPolicy( log::OVERFLOW_DROP );
+	log::manager()->restoreToDefault();
+	fs::remove( path );
+	fs::remove( binaryPath );
+}
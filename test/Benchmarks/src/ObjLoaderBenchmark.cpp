@@ -0,0 +1,83 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/ObjLoader.h"
+#include "cinder/TriMesh.h"
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace ci;
+
+namespace {
+
+// Writes a wavy grid of about \a numTriangles triangles, with a position, tex coord and normal per grid vertex
+void writeGridObj( const fs::path &path, size_t numTriangles )
+{
+	const int n = std::max( 2, (int)std::sqrt( numTriangles / 2.0 ) + 1 );
+	std::ofstream out( path.string(), std::ios::binary );
+	char line[128];
+	for( int y = 0; y < n; ++y ) {
+		for( int x = 0; x < n; ++x ) {
+			const float u = x / float( n - 1 ), v = y / float( n - 1 );
+			out.write( line, std::snprintf( line, sizeof( line ), "v %f %f %f\n", u * 10, std::sin( u * 20 ) * std::cos( v * 20 ), v * 10 ) );
+			out.write( line, std::snprintf( line, sizeof( line ), "vt %f %f\n", u, v ) );
+			out.write( line, std::snprintf( line, sizeof( line ), "vn %f %f %f\n", -std::cos( u * 20 ), 1.0f, std::sin( v * 20 ) ) );
+		}
+	}
+	for( int y = 0; y + 1 < n; ++y ) {
+		for( int x = 0; x + 1 < n; ++x ) {
+			const int a = y * n + x + 1, b = a + 1, c = a + n, d = c + 1;
+			out.write( line, std::snprintf( line, sizeof( line ), "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, d, d, d ) );
+			out.write( line, std::snprintf( line, sizeof( line ), "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, d, d, d, c, c, c ) );
+		}
+	}
+}
+
+} // anonymous namespace
+
+// Set CINDER_BENCHMARK_OBJ_TRIANGLES to change the size of the mesh, which defaults to 5M triangles
+BENCHMARK_SUITE( objLoader )
+{
+	const char *trianglesEnv = std::getenv( "CINDER_BENCHMARK_OBJ_TRIANGLES" );
+	const size_t numTriangles = trianglesEnv ? (size_t)std::atoll( trianglesEnv ) : 5000000;
+	const fs::path path = fs::temp_directory_path() / "cinder_benchmark_obj_loader.obj";
+	writeGridObj( path, numTriangles );
+	const double size = (double)fs::file_size( path );
+	std::printf( "  %.0f MB file of about %zu triangles, warm page cache\n", size / ( 1024 * 1024 ), numTriangles );
+
+	volatile size_t sink = 0;
+	bench::reportGBs( "ObjLoader() parse, mapped", size, bench::timeIt( [&] {
+		sink = sink + ObjLoader( DataSourcePath::create( path ) ).getGroups().size();
+	}, 1, 0 ) );
+	bench::reportGBs( "ObjLoader() parse, IStreamFile", size, bench::timeIt( [&] {
+		sink = sink + ObjLoader( loadFileStream( path ) ).getGroups().size();
+	}, 1, 0 ) );
+	bench::reportGBs( "ObjLoader() parse + TriMesh, mapped", size, bench::timeIt( [&] {
+		sink = sink + TriMesh( ObjLoader( DataSourcePath::create( path ) ) ).getNumIndices();
+	}, 1, 0 ) );
+
+	fs::remove( path );
+}
@@ -0,0 +1,87 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/Path2d.h"
+#include "cinder/Rand.h"
+
+using namespace ci;
+
+namespace {
+
+// A closed outline of \a numSegments lines, quadratics and cubics around a circle, whose jitter makes segments cross a few of their neighbors, like a traced map border
+Path2d makeOutline( size_t numSegments, float phase, uint32_t seed )
+{
+	Rand rnd( seed );
+	const float radius = 500, spacing = 2 * float( M_PI ) * radius / numSegments;
+	auto pointAt = [&]( float i ) {
+		const float angle = phase + 2 * float( M_PI ) * ( i + rnd.nextFloat( -1, 1 ) ) / numSegments;
+		return vec2( std::cos( angle ), std::sin( angle ) ) * ( radius + rnd.nextFloat( -2, 2 ) * spacing );
+	};
+
+	Path2d result;
+	result.moveTo( pointAt( 0 ) );
+	for( size_t s = 1; s < numSegments; ++s ) {
+		if( s % 8 == 0 )
+			result.curveTo( pointAt( s - 0.66f ), pointAt( s - 0.33f ), pointAt( float( s ) ) );
+		else if( s % 4 == 0 )
+			result.quadTo( pointAt( s - 0.5f ), pointAt( float( s ) ) );
+		else
+			result.lineTo( pointAt( float( s ) ) );
+	}
+	result.close();
+
+	return result;
+}
+
+void reportPath( const std::string &name, size_t numSegments, double seconds )
+{
+	std::printf( "  %-48s %10.3f ms  (%8.3f us/segment)\n", name.c_str(), seconds * 1000, seconds / numSegments * 1e6 );
+}
+
+} // anonymous namespace
+
+BENCHMARK_SUITE( path2dIntersect )
+{
+	for( size_t numSegments : { 1000, 4000, 16000, 64000 } ) {
+		const Path2d outline = makeOutline( numSegments, 0, 1 ), rotated = makeOutline( numSegments, 0.001f, 2 );
+		std::printf( "  %zu segments\n", numSegments );
+
+		for( int numThreads : bench::getThreadCounts() ) {
+			const std::string threads = ", threads: " + std::to_string( numThreads );
+			size_t numIntersections = 0;
+			reportPath( "findSelfIntersections()" + threads, numSegments, bench::timeIt( [&] {
+				numIntersections = outline.findSelfIntersections( 1e-4f, numThreads ).size();
+			} ) );
+			if( numThreads == 1 )
+				std::printf( "    %zu self-intersections\n", numIntersections );
+			reportPath( "findIntersections() with another outline" + threads, numSegments, bench::timeIt( [&] {
+				numIntersections = outline.findIntersections( rotated, 1e-4f, numThreads ).size();
+			} ) );
+			if( numThreads == 1 )
+				std::printf( "    %zu intersections\n", numIntersections );
+		}
+		reportPath( "removeSelfIntersections()", numSegments, bench::timeIt( [&] { outline.removeSelfIntersections(); } ) );
+	}
+}
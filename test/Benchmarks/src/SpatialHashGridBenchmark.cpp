@@ -0,0 +1,89 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/KdTree.h"
+#include "cinder/SpatialHashGrid.h"
+#include "cinder/Rand.h"
+
+using namespace ci;
+
+namespace {
+
+void reportFrame( const std::string &name, double seconds )
+{
+	std::printf( "  %-48s %10.3f ms/frame\n", name.c_str(), seconds * 1000 );
+}
+
+} // anonymous namespace
+
+BENCHMARK_SUITE( spatialHashGrid )
+{
+	for( size_t numPoints : { 100000, 1000000 } ) {
+		// particles in a unit cube with about 16 neighbors each, drifting by a fiftieth of the radius per frame
+		const float radius = std::cbrt( 16 / ( numPoints * 4.18879f ) );
+		std::vector<vec3> points( numPoints ), velocities( numPoints );
+		Rand rnd( 1 );
+		for( size_t i = 0; i < numPoints; ++i ) {
+			points[i] = vec3( rnd.nextFloat(), rnd.nextFloat(), rnd.nextFloat() );
+			velocities[i] = rnd.randVec3() * radius * 0.02f;
+		}
+		auto step = [&] {
+			for( size_t i = 0; i < numPoints; ++i )
+				points[i] += velocities[i];
+		};
+		std::printf( "  %zu moving points, radius %f\n", numPoints, radius );
+
+		const size_t maxResults = 32;
+		std::vector<uint32_t> indices( numPoints * maxResults ), counts( numPoints );
+		for( int numThreads : bench::getThreadCounts() ) {
+			const std::string threads = ", threads: " + std::to_string( numThreads );
+			SpatialHashGrid<> grid( radius );
+			grid.build( points, numThreads );
+			reportFrame( "SpatialHashGrid::build()" + threads, bench::timeIt( [&] { grid.build( points, numThreads ); } ) );
+			// the frames after a build, until enough points leave their buckets for update() to rebuild
+			double updateSeconds = 0;
+			int numFrames = 0;
+			bool incremental = true;
+			for( ; numFrames < 10 && incremental; ++numFrames ) {
+				step();
+				// timed once, as a repeated update() would see no motion
+				Timer timer( true );
+				incremental = grid.update( points, numThreads );
+				updateSeconds += timer.getSeconds();
+			}
+			reportFrame( "SpatialHashGrid::update()" + threads, updateSeconds / numFrames );
+			std::printf( "    %zu points out of their bucket after %d frames%s\n", grid.getNumMoved(), numFrames, incremental ? "" : ", then rebuilt" );
+			reportFrame( "SpatialHashGrid::findInRadius() batch" + threads, bench::timeIt( [&] {
+				grid.findInRadius( points.data(), numPoints, radius, maxResults, indices.data(), counts.data(), nullptr, numThreads );
+			} ) );
+
+			KdTree<vec3> tree;
+			reportFrame( "KdTree::initialize()" + threads, bench::timeIt( [&] { tree.initialize( points, KdTree<vec3>::DEFAULT_LEAF_SIZE, numThreads ); } ) );
+			reportFrame( "KdTree::findInRadius() batch" + threads, bench::timeIt( [&] {
+				tree.findInRadius( points.data(), numPoints, radius, maxResults, indices.data(), counts.data(), nullptr, numThreads );
+			} ) );
+		}
+	}
+}
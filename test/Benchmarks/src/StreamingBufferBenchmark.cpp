@@ -0,0 +1,153 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/Buffer.h"
+
+#include <atomic>
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+// stands in for a decoder writing its output
+void produce( uint8_t *dest, size_t size, size_t position )
+{
+	memset( dest, int( position >> 12 ), size );
+}
+
+// stands in for a parser reading its input
+uint64_t parse( const uint8_t *data, size_t size )
+{
+	uint64_t result = 0;
+	for( size_t i = 0; i + 8 <= size; i += 8 ) {
+		uint64_t word;
+		memcpy( &word, data + i, 8 );
+		result += word;
+	}
+	return result;
+}
+
+// Streams \a total bytes, \a chunkSize at a time, from a producer to a consumer thread, or through a single thread when \a threaded is false.
+// With \a zeroCopy the producer writes through reserve() and the consumer parses through peek(), otherwise both go through an intermediate chunk.
+// Returns the elapsed seconds.
+double measure( size_t blockSize, size_t chunkSize, size_t total, bool zeroCopy, bool threaded )
+{
+	StreamingBuffer sb( blockSize );
+	std::atomic<uint64_t> checksum( 0 );
+	// bounds the buffer like a real consumer's backpressure would, and keeps the working set in cache
+	const size_t maxQueued = std::max<size_t>( 1024 * 1024, chunkSize * 4 );
+
+	auto producerStep = [&]( size_t position, std::vector<uint8_t> &chunk ) {
+		const size_t size = std::min( chunkSize, total - position );
+		if( zeroCopy ) {
+			for( size_t written = 0; written < size; ) {
+				size_t reserved;
+				uint8_t *dest = sb.reserve( size - written, &reserved );
+				produce( dest, reserved, position + written );
+				sb.commit( reserved );
+				written += reserved;
+			}
+		}
+		else {
+			produce( chunk.data(), size, position );
+			sb.pushFront( chunk.data(), size );
+		}
+		return size;
+	};
+	auto consumerStep = [&]( std::vector<uint8_t> &chunk, uint64_t *sum ) {
+		if( zeroCopy ) {
+			StreamingBuffer::Region regions[8];
+			const size_t numRegions = sb.peek( regions, 8, chunkSize );
+			size_t count = 0;
+			for( size_t r = 0; r < numRegions; ++r ) {
+				*sum += parse( regions[r].mData, regions[r].mSize );
+				count += regions[r].mSize;
+			}
+			sb.consume( count );
+			return count;
+		}
+		else {
+			const size_t count = sb.popBack( chunk.data(), chunkSize );
+			*sum += parse( chunk.data(), count );
+			return count;
+		}
+	};
+
+	ci::Timer timer( true );
+	if( threaded ) {
+		std::thread consumer( [&] {
+			std::vector<uint8_t> chunk( chunkSize );
+			uint64_t sum = 0;
+			for( size_t received = 0; received < total; ) {
+				const size_t count = consumerStep( chunk, &sum );
+				if( count == 0 )
+					std::this_thread::yield();
+				received += count;
+			}
+			checksum = sum;
+		} );
+		std::vector<uint8_t> chunk( chunkSize );
+		for( size_t position = 0; position < total; ) {
+			position += producerStep( position, chunk );
+			while( sb.getSize() > maxQueued )
+				std::this_thread::yield();
+		}
+		consumer.join();
+	}
+	else {
+		std::vector<uint8_t> producerChunk( chunkSize ), consumerChunk( chunkSize );
+		uint64_t sum = 0;
+		for( size_t position = 0; position < total; ) {
+			position += producerStep( position, producerChunk );
+			while( consumerStep( consumerChunk, &sum ) > 0 )
+				;
+		}
+		checksum = sum;
+	}
+	const double seconds = timer.getSeconds();
+
+	// keeps the parsing from being optimized away
+	if( checksum.load() == 1 )
+		std::printf( "  (checksum collision)\n" );
+	return seconds;
+}
+
+} // anonymous namespace
+
+// Bytes per second streamed through a StreamingBuffer of 64KB blocks, copying through pushFront() / popBack() or in place through reserve() / commit() and peek() / consume()
+BENCHMARK_SUITE( streamingBuffer )
+{
+	const size_t blockSize = 65536, total = 1024 * 1024 * 1024;
+	for( bool threaded : { false, true } ) {
+		std::printf( "  %s\n", threaded ? "producer and consumer threads" : "single thread" );
+		for( size_t chunkSize : { (size_t)4096, (size_t)65536, (size_t)1024 * 1024 } ) {
+			for( bool zeroCopy : { false, true } ) {
+				const std::string name = std::to_string( chunkSize / 1024 ) + "KB chunks, " + ( zeroCopy ? "reserve / commit, peek / consume" : "pushFront / popBack" );
+				bench::reportGBs( name, (double)total, measure( blockSize, chunkSize, total, zeroCopy, threaded ) );
+			}
+		}
+	}
+}
@@ -0,0 +1,127 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/Thread.h"
+
+#include <atomic>
+#include <cmath>
+#include <future>
+
+using namespace ci;
+
+namespace {
+
+void reportTasks( const std::string &name, double numTasks, double seconds )
+{
+	std::printf( "  %-48s %10.1f ns/task  (%8.3f ms)\n", name.c_str(), seconds / numTasks * 1e9, seconds * 1000 );
+}
+
+int64_t forkJoin( int depth, TaskScheduler *scheduler )
+{
+	if( depth == 0 )
+		return 1;
+
+	int64_t left, right;
+	TaskGroup group( scheduler );
+	group.run( [&] { left = forkJoin( depth - 1, scheduler ); } );
+	right = forkJoin( depth - 1, scheduler );
+	group.wait();
+	return left + right;
+}
+
+} // anonymous namespace
+
+// Spawn overhead and fork/join use empty tasks, so they measure the scheduler alone. std::async launches a thread per task,
+// which is what subsystems spinning up their own threads pay. parallelFor sums square roots over 16M floats.
+BENCHMARK_SUITE( taskScheduler )
+{
+	const std::vector<int> threadCounts = bench::getThreadCounts();
+	TaskScheduler scheduler( TaskScheduler::Options().numThreads( std::max( 1, threadCounts.back() - 1 ) ) );
+	std::printf( "  %d worker threads\n", scheduler.getNumThreads() );
+
+	const int numTasks = 100000;
+	std::atomic<int> counter( 0 );
+	reportTasks( "TaskGroup::run() and wait()", numTasks, bench::timeIt( [&] {
+		TaskGroup group( &scheduler );
+		for( int i = 0; i < numTasks; ++i )
+			group.run( [&] { counter.fetch_add( 1, std::memory_order_relaxed ); } );
+		group.wait();
+	} ) );
+	reportTasks( "TaskGroup::run() and wait(), high priority", numTasks, bench::timeIt( [&] {
+		TaskGroup group( &scheduler );
+		for( int i = 0; i < numTasks; ++i )
+			group.run( [&] { counter.fetch_add( 1, std::memory_order_relaxed ); }, TaskPriority::HIGH );
+		group.wait();
+	} ) );
+	reportTasks( "TaskGroup::run() from a worker", numTasks, bench::timeIt( [&] {
+		TaskGroup outer( &scheduler );
+		outer.run( [&] {
+			TaskGroup group( &scheduler );
+			for( int i = 0; i < numTasks; ++i )
+				group.run( [&] { counter.fetch_add( 1, std::memory_order_relaxed ); } );
+			group.wait();
+		} );
+		outer.wait();
+	} ) );
+	const int numAsyncTasks = 2000;
+	reportTasks( "std::async( std::launch::async ) baseline", numAsyncTasks, bench::timeIt( [&] {
+		std::vector<std::future<void>> futures;
+		futures.reserve( numAsyncTasks );
+		for( int i = 0; i < numAsyncTasks; ++i )
+			futures.push_back( std::async( std::launch::async, [&] { counter.fetch_add( 1, std::memory_order_relaxed ); } ) );
+		for( auto &future : futures )
+			future.wait();
+	} ) );
+
+	for( int depth : { 10, 16 } ) {
+		int64_t numLeaves = 0;
+		const double seconds = bench::timeIt( [&] { numLeaves = forkJoin( depth, &scheduler ); } );
+		reportTasks( "fork/join, depth " + std::to_string( depth ), double( numLeaves - 1 ), seconds );
+	}
+
+	std::vector<float> values( 16 * 1024 * 1024 );
+	for( size_t i = 0; i < values.size(); ++i )
+		values[i] = float( i % 1000 );
+	for( int64_t grainSize : { 0, 1024 } ) {
+		double serialSeconds = 0;
+		for( int numThreads : threadCounts ) {
+			std::atomic<double> sum( 0 );
+			const double seconds = bench::timeIt( [&] {
+				sum = 0;
+				scheduler.parallelFor( 0, (int64_t)values.size(), [&]( int64_t begin, int64_t end ) {
+					double partial = 0;
+					for( int64_t i = begin; i < end; ++i )
+						partial += std::sqrt( values[i] );
+					double expected = sum.load();
+					while( ! sum.compare_exchange_weak( expected, expected + partial ) );
+				}, grainSize, numThreads );
+			} );
+			if( numThreads == 1 )
+				serialSeconds = seconds;
+			const std::string name = "parallelFor(), grain " + ( grainSize ? std::to_string( grainSize ) : std::string( "auto" ) ) + ", threads: " + std::to_string( numThreads );
+			std::printf( "  %-48s %10.2f x serial  (%8.3f ms)\n", name.c_str(), serialSeconds / seconds, seconds * 1000 );
+		}
+	}
+}
@@ -0,0 +1,116 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/TriMeshBvh.h"
+#include "cinder/Rand.h"
+
+#include <cstdlib>
+
+using namespace ci;
+
+namespace {
+
+void reportQueries( const std::string &name, size_t numQueries, double seconds )
+{
+	std::printf( "  %-48s %10.3f us/query  (%8.3f ms)\n", name.c_str(), seconds / numQueries * 1e6, seconds * 1000 );
+}
+
+} // anonymous namespace
+
+// Set CINDER_BENCHMARK_TRIMESH_TRIANGLES to change the size of the mesh, which defaults to 2M triangles
+BENCHMARK_SUITE( triMeshBvh )
+{
+	const char *trianglesEnv = std::getenv( "CINDER_BENCHMARK_TRIMESH_TRIANGLES" );
+	const size_t numTriangles = trianglesEnv ? (size_t)std::atoll( trianglesEnv ) : 2000000;
+	const TriMesh mesh = bench::makeGrid( numTriangles );
+	const double triangles = (double)mesh.getNumTriangles();
+	std::printf( "  wavy grid of %zu triangles\n", mesh.getNumTriangles() );
+
+	TriMeshBvh bvh;
+	for( int numThreads : bench::getThreadCounts() ) {
+		const double seconds = bench::timeIt( [&] { bvh = TriMeshBvh( mesh, TriMeshBvh::Options().numThreads( numThreads ) ); }, 1, 0 );
+		bench::reportMtris( "build, threads: " + std::to_string( numThreads ), triangles, seconds );
+	}
+	std::printf( "    %zu nodes\n", bvh.getNodes().size() );
+
+	const TriMesh deformed = bench::makeGrid( numTriangles, false, false, 1.0f );
+	bench::reportMtris( "refit()", triangles, bench::timeIt( [&] { bvh.refit( deformed ); } ) );
+	bvh.refit( mesh );
+
+	// picking rays from above towards random points of the grid, and random points around it
+	const size_t numQueries = 100000;
+	std::vector<Ray> rays;
+	std::vector<vec3> points;
+	Rand rnd( 1 );
+	for( size_t i = 0; i < numQueries; ++i ) {
+		const vec3 target( rnd.nextFloat( 0, 10 ), 0, rnd.nextFloat( 0, 10 ) );
+		const vec3 origin = target + vec3( rnd.nextFloat( -5, 5 ), 20, rnd.nextFloat( -5, 5 ) );
+		rays.push_back( Ray( origin, target - origin ) );
+		points.push_back( vec3( rnd.nextFloat( -1, 11 ), rnd.nextFloat( -2, 2 ), rnd.nextFloat( -1, 11 ) ) );
+	}
+
+	size_t numHits = 0;
+	reportQueries( "calcIntersection()", numQueries, bench::timeIt( [&] {
+		numHits = 0;
+		TriMeshBvh::Hit hit;
+		for( const Ray &ray : rays )
+			numHits += bvh.calcIntersection( ray, &hit );
+	} ) );
+	std::printf( "    %zu of %zu rays hit\n", numHits, numQueries );
+	reportQueries( "intersects()", numQueries, bench::timeIt( [&] {
+		numHits = 0;
+		for( const Ray &ray : rays )
+			numHits += bvh.intersects( ray );
+	} ) );
+	reportQueries( "calcClosestPoint()", numQueries, bench::timeIt( [&] {
+		TriMeshBvh::Hit hit;
+		for( const vec3 &point : points )
+			bvh.calcClosestPoint( point, &hit );
+	} ) );
+	size_t numOverlaps = 0;
+	reportQueries( "calcOverlaps() of a sphere of radius 0.1", numQueries, bench::timeIt( [&] {
+		numOverlaps = 0;
+		std::vector<uint32_t> found;
+		for( const vec3 &point : points ) {
+			bvh.calcOverlaps( Sphere( point, 0.1f ), &found );
+			numOverlaps += found.size();
+		}
+	} ) );
+	std::printf( "    %.1f triangles per sphere\n", numOverlaps / double( numQueries ) );
+
+	// the loop over every triangle that the hierarchy replaces
+	reportQueries( "Ray::calcTriangleIntersection() of every triangle", 10, bench::timeIt( [&] {
+		for( size_t r = 0; r < 10; ++r ) {
+			float closest = std::numeric_limits<float>::max(), distance;
+			for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+				vec3 a, b, c;
+				mesh.getTriangleVertices( t, &a, &b, &c );
+				if( rays[r].calcTriangleIntersection( a, b, c, &distance ) && distance >= 0 )
+					closest = std::min( closest, distance );
+			}
+			numHits += closest < std::numeric_limits<float>::max();
+		}
+	}, 1, 0 ) );
+}
@@ -0,0 +1,91 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/TriMesh.h"
+#include "cinder/TriMeshCache.h"
+
+#include <cstdlib>
+
+using namespace ci;
+
+namespace {
+
+// Reads one float of every page of the cache's attributes, as an upload to the GPU would
+float touchPages( const TriMeshCache &cache )
+{
+	float sum = 0;
+	for( geom::Attrib attrib : cache.getAvailableAttribs() ) {
+		const float *data = cache.getAttribData( attrib );
+		for( size_t i = 0; i < cache.getNumVertices() * cache.getAttribDims( attrib ); i += 1024 )
+			sum += data[i];
+	}
+	return sum;
+}
+
+} // anonymous namespace
+
+// Set CINDER_BENCHMARK_TRIMESH_VERTICES to change the size of the mesh, which defaults to 4M vertices
+BENCHMARK_SUITE( triMeshCache )
+{
+	const char *verticesEnv = std::getenv( "CINDER_BENCHMARK_TRIMESH_VERTICES" );
+	const size_t numVertices = verticesEnv ? (size_t)std::atoll( verticesEnv ) : 4000000;
+	const fs::path pathV2 = fs::temp_directory_path() / "cinder_benchmark_trimesh_v2.bin";
+	const fs::path pathCache = fs::temp_directory_path() / "cinder_benchmark_trimesh_cache.bin";
+	const fs::path pathCompressed = fs::temp_directory_path() / "cinder_benchmark_trimesh_cache_z.bin";
+	{
+		const TriMesh mesh = bench::makeGrid( numVertices * 2, true, true );
+		mesh.write( DataTargetPath::createRef( pathV2 ) );
+		TriMeshCache::write( DataTargetPath::createRef( pathCache ), mesh );
+		TriMeshCache::write( DataTargetPath::createRef( pathCompressed ), mesh, TriMeshCache::Options().compressionLevel( 1 ) );
+	}
+	const double size = (double)fs::file_size( pathCache );
+	std::printf( "  %.0f MB mesh of %zu vertices (%.0f MB compressed), warm page cache\n", size / ( 1024 * 1024 ), numVertices,
+		fs::file_size( pathCompressed ) / ( 1024.0 * 1024 ) );
+
+	volatile float sink = 0;
+	bench::reportGBs( "TriMesh::read() version 2, mapped", size, bench::timeIt( [&] {
+		TriMesh mesh;
+		mesh.read( DataSourcePath::create( pathV2 ) );
+		sink = sink + mesh.getBufferPositions()[0];
+	} ) );
+	bench::reportGBs( "TriMesh::read() cache, mapped", size, bench::timeIt( [&] {
+		TriMesh mesh;
+		mesh.read( DataSourcePath::create( pathCache ) );
+		sink = sink + mesh.getBufferPositions()[0];
+	} ) );
+	bench::reportGBs( "TriMeshCache::create(), mapped", size, bench::timeIt( [&] {
+		sink = sink + TriMeshCache::create( DataSourcePath::create( pathCache ) )->getAttribData( geom::POSITION )[0];
+	} ) );
+	bench::reportGBs( "TriMeshCache::create(), mapped, every page", size, bench::timeIt( [&] {
+		sink = sink + touchPages( *TriMeshCache::create( DataSourcePath::create( pathCache ) ) );
+	} ) );
+	bench::reportGBs( "TriMeshCache::create(), compressed", size, bench::timeIt( [&] {
+		sink = sink + TriMeshCache::create( DataSourcePath::create( pathCompressed ) )->getAttribData( geom::POSITION )[0];
+	} ) );
+
+	fs::remove( pathV2 );
+	fs::remove( pathCache );
+	fs::remove( pathCompressed );
+}
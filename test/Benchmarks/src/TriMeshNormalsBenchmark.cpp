@@ -0,0 +1,54 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/TriMesh.h"
+
+#include <cstdlib>
+#include <thread>
+
+using namespace ci;
+
+// Set CINDER_BENCHMARK_TRIMESH_VERTICES to change the size of the mesh, which defaults to 2M vertices
+BENCHMARK_SUITE( triMeshNormals )
+{
+	const char *verticesEnv = std::getenv( "CINDER_BENCHMARK_TRIMESH_VERTICES" );
+	const size_t numVertices = verticesEnv ? (size_t)std::atoll( verticesEnv ) : 2000000;
+	TriMesh mesh = bench::makeGrid( numVertices * 2, false, true );
+	const double triangles = (double)mesh.getNumTriangles();
+	std::printf( "  grid of %zu vertices and %zu triangles, %u hardware threads\n", mesh.getNumVertices(), mesh.getNumTriangles(), std::thread::hardware_concurrency() );
+
+	bench::reportMtris( "Adjacency construction", triangles, bench::timeIt( [&] { TriMesh::Adjacency adjacency( mesh ); } ) );
+	bench::reportMtris( "Adjacency construction, smooth", triangles, bench::timeIt( [&] { TriMesh::Adjacency adjacency( mesh, true ); } ) );
+
+	// a deforming mesh reuses its adjacency every frame
+	const TriMesh::Adjacency adjacency( mesh );
+	for( int numThreads : { 1, 0 } ) {
+		const std::string threads = numThreads == 1 ? ", 1 thread" : ", all cores";
+		bench::reportMtris( "recalculateNormals()" + threads, triangles, bench::timeIt( [&] { mesh.recalculateNormals( adjacency, false, numThreads ); } ) );
+		bench::reportMtris( "recalculateTangents()" + threads, triangles, bench::timeIt( [&] { mesh.recalculateTangents( adjacency, numThreads ); } ) );
+	}
+	bench::reportMtris( "recalculateNormals() with a new Adjacency", triangles, bench::timeIt( [&] { mesh.recalculateNormals(); } ) );
+	bench::reportMtris( "recalculateNormals( true ) with a new Adjacency", triangles, bench::timeIt( [&] { mesh.recalculateNormals( true ); } ) );
+}
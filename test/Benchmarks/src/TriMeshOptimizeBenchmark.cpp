@@ -0,0 +1,97 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/TriMesh.h"
+#include "cinder/Rand.h"
+
+#include <array>
+#include <cstdlib>
+
+using namespace ci;
+
+namespace {
+
+// A wavy grid of about \a numTriangles triangles in random order, where every triangle has its own three vertices, like a mesh from a scanner or an STL file
+TriMesh makeTriangleSoup( size_t numTriangles )
+{
+	const int n = std::max( 2, (int)std::sqrt( numTriangles / 2.0 ) + 1 );
+	auto position = [n]( int x, int y ) {
+		const float u = x / float( n - 1 ), v = y / float( n - 1 );
+		return vec3( u * 10, std::sin( u * 20 ) * std::cos( v * 20 ), v * 10 );
+	};
+
+	std::vector<std::array<ivec2,3>> triangles;
+	for( int y = 0; y + 1 < n; ++y ) {
+		for( int x = 0; x + 1 < n; ++x ) {
+			triangles.push_back( { ivec2( x, y ), ivec2( x + 1, y ), ivec2( x + 1, y + 1 ) } );
+			triangles.push_back( { ivec2( x, y ), ivec2( x + 1, y + 1 ), ivec2( x, y + 1 ) } );
+		}
+	}
+	Rand rnd( 1 );
+	for( size_t i = triangles.size(); i > 1; --i )
+		std::swap( triangles[i - 1], triangles[rnd.nextUint( uint32_t( i ) )] );
+
+	TriMesh result( TriMesh::Format().positions().normals().texCoords() );
+	for( auto &triangle : triangles ) {
+		for( const ivec2 &corner : triangle ) {
+			result.appendPosition( position( corner.x, corner.y ) );
+			result.appendNormal( vec3( 0, 1, 0 ) );
+			result.appendTexCoord( vec2( corner ) / float( n ) );
+		}
+		const uint32_t base = uint32_t( result.getNumVertices() - 3 );
+		result.appendTriangle( base, base + 1, base + 2 );
+	}
+
+	return result;
+}
+
+void printStats( const char *name, const TriMesh &mesh )
+{
+	const TriMesh::VertexCacheStats stats = mesh.analyzeVertexCache();
+	std::printf( "  %-48s ACMR %.3f  ATVR %.3f  (%zu vertices)\n", name, stats.acmr, stats.atvr, mesh.getNumVertices() );
+}
+
+} // anonymous namespace
+
+// Set CINDER_BENCHMARK_TRIMESH_TRIANGLES to change the size of the mesh, which defaults to 2M triangles
+BENCHMARK_SUITE( triMeshOptimize )
+{
+	const char *trianglesEnv = std::getenv( "CINDER_BENCHMARK_TRIMESH_TRIANGLES" );
+	const size_t numTriangles = trianglesEnv ? (size_t)std::atoll( trianglesEnv ) : 2000000;
+	TriMesh mesh = makeTriangleSoup( numTriangles );
+	const double triangles = (double)mesh.getNumTriangles();
+	std::printf( "  triangle soup of %zu triangles, FIFO cache of 16 vertices\n", mesh.getNumTriangles() );
+	printStats( "before", mesh );
+
+	// each step runs once, on the result of the previous one
+	bench::reportMtris( "weldVertices()", triangles, bench::timeIt( [&] { mesh.weldVertices(); }, 1, 0 ) );
+	printStats( "welded", mesh );
+	bench::reportMtris( "optimizeVertexCache()", triangles, bench::timeIt( [&] { mesh.optimizeVertexCache(); }, 1, 0 ) );
+	printStats( "vertex cache optimized", mesh );
+	bench::reportMtris( "optimizeOverdraw()", triangles, bench::timeIt( [&] { mesh.optimizeOverdraw(); }, 1, 0 ) );
+	printStats( "overdraw optimized", mesh );
+	bench::reportMtris( "optimizeVertexFetch()", triangles, bench::timeIt( [&] { mesh.optimizeVertexFetch(); }, 1, 0 ) );
+	printStats( "vertex fetch optimized", mesh );
+}
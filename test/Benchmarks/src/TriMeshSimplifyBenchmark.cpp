@@ -0,0 +1,62 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Benchmark.h"
+
+#include "cinder/TriMesh.h"
+
+#include <cstdlib>
+
+using namespace ci;
+
+// Set CINDER_BENCHMARK_TRIMESH_TRIANGLES to change the size of the mesh, which defaults to 2M triangles
+BENCHMARK_SUITE( triMeshSimplify )
+{
+	const char *trianglesEnv = std::getenv( "CINDER_BENCHMARK_TRIMESH_TRIANGLES" );
+	const size_t numTriangles = trianglesEnv ? (size_t)std::atoll( trianglesEnv ) : 2000000;
+	const TriMesh mesh = bench::makeGrid( numTriangles, true, true );
+	const double triangles = (double)mesh.getNumTriangles();
+	std::printf( "  wavy grid of %zu triangles with normals and tex coords\n", mesh.getNumTriangles() );
+
+	for( size_t divisor : { 10, 100 } ) {
+		TriMesh simplified;
+		float error = 0;
+		const double seconds = bench::timeIt( [&] {
+			simplified = mesh;
+			error = simplified.simplify( mesh.getNumTriangles() / divisor );
+		}, 1, 0 );
+		bench::reportMtris( "simplify() to 1/" + std::to_string( divisor ), triangles, seconds );
+		std::printf( "    %zu triangles, error %.5f\n", simplified.getNumTriangles(), error );
+	}
+
+	std::vector<float> errors;
+	std::vector<TriMesh> lods;
+	const std::vector<size_t> targets = { mesh.getNumTriangles() / 2, mesh.getNumTriangles() / 10, mesh.getNumTriangles() / 100, mesh.getNumTriangles() / 1000 };
+	bench::reportMtris( "generateLods() of 4 levels", triangles, bench::timeIt( [&] { lods = mesh.generateLods( targets, TriMesh::SimplifyOptions(), &errors ); }, 1, 0 ) );
+	for( size_t level = 0; level < lods.size(); ++level )
+		std::printf( "    level %zu: %zu triangles, error %.5f\n", level, lods[level].getNumTriangles(), errors[level] );
+
+	TriMesh bounded = mesh;
+	bench::reportMtris( "simplify() within an error of 0.001", triangles, bench::timeIt( [&] { bounded = mesh; bounded.simplify( 0, TriMesh::SimplifyOptions().targetError( 0.001f ) ); }, 1, 0 ) );
+	std::printf( "    %zu triangles\n", bounded.getNumTriangles() );
+}
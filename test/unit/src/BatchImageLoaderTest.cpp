@@ -0,0 +1,165 @@
+#include "catch.hpp"
+#include "Utilities.h"
+
+#include "cinder/BatchImageLoader.h"
+#include "cinder/app/Platform.h"
+
+#include <atomic>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// writes \a count images of varying size to the temp directory, returning their paths
+vector<fs::path> writeTestImages( const string &prefix, int count, int32_t size )
+{
+	vector<fs::path> result;
+	for( int i = 0; i < count; ++i ) {
+		result.push_back( fs::temp_directory_path() / ( prefix + to_string( i ) + ( i % 2 ? ".png" : ".qoi" ) ) );
+		writeImage( result.back(), makeTestSurface( size + i, size, i % 3 == 0, i ) );
+	}
+
+	return result;
+}
+
+void removeTestImages( const vector<fs::path> &paths )
+{
+	for( const auto &path : paths )
+		fs::remove( path );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "BatchImageLoader" )
+{
+	// make sure the platform's image codecs are registered
+	app::Platform::get();
+
+	SECTION( "Every image is delivered once, through both the callback and its future" )
+	{
+		const auto paths = writeTestImages( "cinder_batch_loader_", 12, 33 );
+		mutex resultsMutex;
+		map<BatchImageLoader::RequestId, BatchImageLoader::Result> results;
+		auto loader = BatchImageLoader::create( BatchImageLoader::Options().numThreads( 3 ).completionFn( [&]( const BatchImageLoader::Result &result ) {
+			lock_guard<mutex> lock( resultsMutex );
+			REQUIRE( results.count( result.getId() ) == 0 );
+			results[result.getId()] = result;
+		} ) );
+		REQUIRE( loader->getNumThreads() == 3 );
+
+		auto requests = loader->load( paths );
+		auto missing = loader->load( fs::temp_directory_path() / "cinder_batch_loader_missing.png" );
+		loader->waitAll();
+
+		REQUIRE( results.size() == paths.size() + 1 );
+		REQUIRE( loader->getNumQueued() == 0 );
+		REQUIRE( loader->getBytesInFlight() == 0 );
+		for( size_t i = 0; i < paths.size(); ++i ) {
+			const BatchImageLoader::Result &result = requests[i].getFuture().get();
+			REQUIRE( result.getId() == requests[i].getId() );
+			REQUIRE( result.getPath() == paths[i] );
+			REQUIRE( ! result.isCancelled() );
+			REQUIRE( ! result.hasError() );
+			REQUIRE( result.getOpenSeconds() >= 0 );
+			REQUIRE( result.getDecodeSeconds() >= 0 );
+			REQUIRE( surfacesEqual( *result.getSurface(), Surface8u( loadImage( paths[i] ) ) ) );
+			REQUIRE( results[result.getId()].getSurface() == result.getSurface() );
+		}
+
+		REQUIRE( missing.getFuture().get().hasError() );
+		REQUIRE( ! missing.getFuture().get().getSurface() );
+		removeTestImages( paths );
+	}
+
+	SECTION( "Decoded bytes in flight stay within the budget" )
+	{
+		const auto paths = writeTestImages( "cinder_batch_loader_budget_", 16, 64 );
+		const size_t budget = 40 * 1024;
+		atomic<size_t> maxBytesInFlight( 0 );
+		BatchImageLoaderRef loader;
+		loader = BatchImageLoader::create( BatchImageLoader::Options().numThreads( 4 ).maxBytesInFlight( budget ).completionFn( [&]( const BatchImageLoader::Result & ) {
+			size_t bytes = loader->getBytesInFlight();
+			size_t prev = maxBytesInFlight;
+			while( bytes > prev && ! maxBytesInFlight.compare_exchange_weak( prev, bytes ) )
+				;
+		} ) );
+
+		auto requests = loader->load( paths );
+		loader->waitAll();
+		REQUIRE( maxBytesInFlight > 0 );
+		REQUIRE( maxBytesInFlight <= budget );
+		for( auto &request : requests )
+			REQUIRE( request.getFuture().get().getSurface() );
+
+		// images larger than the budget are still decoded, one at a time
+		auto tinyBudget = BatchImageLoader::create( BatchImageLoader::Options().numThreads( 2 ).maxBytesInFlight( 1 ) );
+		auto large = tinyBudget->load( paths );
+		for( auto &request : large )
+			REQUIRE( request.getFuture().get().getSurface() );
+
+		removeTestImages( paths );
+	}
+
+	SECTION( "Priorities reorder and cancellation removes queued images" )
+	{
+		const auto paths = writeTestImages( "cinder_batch_loader_order_", 5, 16 );
+		mutex orderMutex;
+		vector<BatchImageLoader::RequestId> order;
+		promise<void> entered, release;
+		shared_future<void> releaseFuture = release.get_future().share();
+		atomic<bool> first( true );
+		auto loader = BatchImageLoader::create( BatchImageLoader::Options().numThreads( 1 ).completionFn( [&]( const BatchImageLoader::Result &result ) {
+			{
+				lock_guard<mutex> lock( orderMutex );
+				order.push_back( result.getId() );
+			}
+			// holds the only worker inside the first image's callback while the test rearranges the queue
+			if( first.exchange( false ) ) {
+				entered.set_value();
+				releaseFuture.wait();
+			}
+		} ) );
+
+		auto blocker = loader->load( paths[0] );
+		entered.get_future().wait();
+		auto a = loader->load( paths[1] );
+		auto b = loader->load( paths[2] );
+		auto c = loader->load( paths[3] );
+		auto d = loader->load( paths[4] );
+		REQUIRE( loader->getNumQueued() == 4 );
+
+		REQUIRE( loader->setPriority( d.getId(), 10 ) );
+		REQUIRE( loader->cancel( b.getId() ) );
+		REQUIRE( b.getFuture().get().isCancelled() );
+		REQUIRE( ! b.getFuture().get().getSurface() );
+		REQUIRE( loader->getNumQueued() == 3 );
+		REQUIRE( ! loader->setPriority( blocker.getId(), 10 ) );
+
+		release.set_value();
+		loader->waitAll();
+		REQUIRE( order == vector<BatchImageLoader::RequestId>( { blocker.getId(), b.getId(), d.getId(), a.getId(), c.getId() } ) );
+		REQUIRE( ! loader->cancel( a.getId() ) );
+		REQUIRE( ! loader->setPriority( c.getId(), 1 ) );
+		REQUIRE( a.getFuture().get().getSurface() );
+
+		removeTestImages( paths );
+	}
+
+	SECTION( "Destroying the loader cancels queued images" )
+	{
+		const auto paths = writeTestImages( "cinder_batch_loader_destroy_", 8, 32 );
+		vector<BatchImageLoader::Request> requests;
+		{
+			auto loader = BatchImageLoader::create( BatchImageLoader::Options().numThreads( 1 ) );
+			requests = loader->load( paths );
+		}
+
+		for( auto &request : requests ) {
+			const auto &result = request.getFuture().get();
+			REQUIRE( result.isCancelled() != (bool)result.getSurface() );
+		}
+
+		removeTestImages( paths );
+	}
+}
@@ -0,0 +1,292 @@
+#include "catch.hpp"
+
+#include "cinder/ConcurrentCircularBuffer.h"
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// counts live instances, so that the buffers can be checked for destroying what they hold
+struct Tracked {
+	Tracked( int value = 0 ) : mValue( value ) { ++sNumLive; }
+	Tracked( const Tracked &rhs ) : mValue( rhs.mValue ) { ++sNumLive; }
+	Tracked& operator=( const Tracked &rhs ) = default;
+	~Tracked() { --sNumLive; }
+
+	int					mValue;
+	static atomic<int>	sNumLive;
+};
+
+atomic<int> Tracked::sNumLive( 0 );
+
+// the single-threaded behavior ConcurrentCircularBuffer is tested for, plus move-only items and batches
+template<typename BufferT>
+void testSingleThreaded()
+{
+	{
+		BufferT buffer( 10 );
+		REQUIRE( buffer.getCapacity() == 10 );
+		for( int i = 0; i < 10; ++i )
+			REQUIRE( buffer.pushFront( i ) );
+		REQUIRE( buffer.getSize() == 10 );
+		REQUIRE( buffer.isNotEmpty() );
+		REQUIRE( ! buffer.isNotFull() );
+		REQUIRE( ! buffer.tryPushFront( 11 ) );
+		int temp;
+		for( int i = 0; i < 10; ++i ) {
+			REQUIRE( buffer.popBack( &temp ) );
+			REQUIRE( temp == i );
+		}
+		REQUIRE( ! buffer.tryPopBack( &temp ) );
+		REQUIRE( ! buffer.isNotEmpty() );
+		REQUIRE( buffer.isNotFull() );
+
+		// batches stop at the capacity, and wrap around the end of the storage
+		vector<int> values( 25 );
+		for( int i = 0; i < 25; ++i )
+			values[i] = 100 + i;
+		REQUIRE( buffer.tryPushFront( values.begin(), values.end() ) == 10 );
+		vector<int> popped( 25, -1 );
+		REQUIRE( buffer.tryPopBack( popped.data(), 4 ) == 4 );
+		REQUIRE( buffer.tryPushFront( values.begin() + 10, values.end() ) == 4 );
+		REQUIRE( buffer.popBack( popped.data() + 4, 25 ) == 10 );
+		for( int i = 0; i < 14; ++i )
+			REQUIRE( popped[i] == 100 + i );
+		REQUIRE( buffer.tryPopBack( popped.data(), 25 ) == 0 );
+	}
+
+	{
+		using MoveOnlyBuffer = typename BufferT::template Rebind<unique_ptr<int>>;
+		MoveOnlyBuffer buffer( 3 );
+		REQUIRE( buffer.pushFront( make_unique<int>( 1 ) ) );
+		vector<unique_ptr<int>> items;
+		items.push_back( make_unique<int>( 2 ) );
+		items.push_back( make_unique<int>( 3 ) );
+		REQUIRE( buffer.pushFront( make_move_iterator( items.begin() ), make_move_iterator( items.end() ) ) == 2 );
+		REQUIRE( ! items[0] );
+		unique_ptr<int> item = make_unique<int>( 4 );
+		REQUIRE( ! buffer.tryPushFront( std::move( item ) ) );
+		// a failed push leaves the item with the caller
+		REQUIRE( item );
+		for( int i = 1; i <= 3; ++i ) {
+			REQUIRE( buffer.popBack( &item ) );
+			REQUIRE( *item == i );
+		}
+	}
+
+	{
+		using TrackedBuffer = typename BufferT::template Rebind<Tracked>;
+		{
+			TrackedBuffer buffer( 5 );
+			for( int i = 0; i < 8; ++i ) {
+				Tracked item( i );
+				buffer.tryPushFront( item );
+				if( i % 3 == 2 )
+					buffer.tryPopBack( &item );
+			}
+			REQUIRE( Tracked::sNumLive == 5 );
+			buffer.clear();
+			REQUIRE( Tracked::sNumLive == 0 );
+			REQUIRE( ! buffer.isNotEmpty() );
+			buffer.pushFront( Tracked( 1 ) );
+			buffer.pushFront( Tracked( 2 ) );
+		}
+		REQUIRE( Tracked::sNumLive == 0 );
+	}
+}
+
+// A buffer of capacity 1 holds exactly one item at a time, however often it wraps around
+template<typename BufferT>
+void testCapacityOne()
+{
+	BufferT buffer( 1 );
+	REQUIRE( buffer.getCapacity() == 1 );
+	int temp;
+	for( int i = 0; i < 5; ++i ) {
+		REQUIRE( buffer.tryPushFront( i ) );
+		REQUIRE( ! buffer.tryPushFront( 100 ) );
+		REQUIRE( ! buffer.isNotFull() );
+		REQUIRE( buffer.getSize() == 1 );
+		REQUIRE( buffer.tryPopBack( &temp ) );
+		REQUIRE( temp == i );
+		REQUIRE( ! buffer.tryPopBack( &temp ) );
+		REQUIRE( buffer.isNotFull() );
+	}
+
+	vector<int> values = { 1, 2, 3 };
+	REQUIRE( buffer.tryPushFront( values.begin(), values.end() ) == 1 );
+	REQUIRE( buffer.tryPopBack( values.data(), 3 ) == 1 );
+	REQUIRE( values[0] == 1 );
+}
+
+// Cancelling wakes up a consumer parked on an empty buffer and a producer parked on a full one
+template<typename BufferT>
+void testCancel()
+{
+	BufferT buffer( 2, 0 );
+	atomic<int> numReturned( 0 );
+	atomic<bool> succeeded( false );
+	// Catch's assertions are only used on the main thread
+	thread consumer( [&] {
+		int item;
+		succeeded = buffer.popBack( &item );
+		++numReturned;
+	} );
+	// gives the consumer a chance to park, though the test holds either way
+	this_thread::sleep_for( chrono::milliseconds( 10 ) );
+	buffer.cancel();
+	consumer.join();
+	REQUIRE( numReturned == 1 );
+	REQUIRE( ! succeeded );
+
+	buffer.uncancel();
+	REQUIRE( buffer.pushFront( 1 ) );
+	REQUIRE( buffer.pushFront( 2 ) );
+	thread producer( [&] {
+		succeeded = buffer.pushFront( 3 );
+		++numReturned;
+	} );
+	this_thread::sleep_for( chrono::milliseconds( 10 ) );
+	buffer.cancel();
+	producer.join();
+	REQUIRE( numReturned == 2 );
+	REQUIRE( ! succeeded );
+	REQUIRE( buffer.getSize() == 2 );
+}
+
+// Every item pushed by \a numProducers threads is popped exactly once by \a numConsumers threads, and each consumer sees each producer's items in order
+template<typename BufferT>
+void testThreaded( int numProducers, int numConsumers, uint32_t spinCount, size_t capacity = 64 )
+{
+	const int numItems = 40000;
+	BufferT buffer( capacity, spinCount );
+	vector<vector<int>> received( numConsumers );
+	atomic<int> numFailedPushes( 0 );
+	vector<thread> threads;
+	for( int p = 0; p < numProducers; ++p ) {
+		threads.emplace_back( [&, p] {
+			int next = 0;
+			while( next < numItems ) {
+				// alternates between single items and batches
+				if( next % 7 == 0 ) {
+					if( ! buffer.pushFront( p * numItems + next ) )
+						++numFailedPushes;
+					++next;
+				}
+				else {
+					int batch[5];
+					const int count = std::min( 5, numItems - next );
+					for( int i = 0; i < count; ++i )
+						batch[i] = p * numItems + next + i;
+					if( buffer.pushFront( batch, batch + count ) != size_t( count ) )
+						++numFailedPushes;
+					next += count;
+				}
+			}
+		} );
+	}
+
+	atomic<int> numPopped( 0 );
+	const int total = numItems * numProducers;
+	for( int c = 0; c < numConsumers; ++c ) {
+		threads.emplace_back( [&, c] {
+			int batch[8];
+			while( numPopped.load() < total ) {
+				if( c % 2 == 0 ) {
+					const size_t count = buffer.popBack( batch, 8 );
+					received[c].insert( received[c].end(), batch, batch + count );
+					numPopped += int( count );
+				}
+				else if( buffer.tryPopBack( batch ) ) {
+					received[c].push_back( batch[0] );
+					++numPopped;
+				}
+				else
+					this_thread::yield();
+			}
+		} );
+	}
+
+	// the consumers that block are woken by cancel() once everything has been popped
+	for( int p = 0; p < numProducers; ++p )
+		threads[p].join();
+	while( numPopped.load() < total )
+		this_thread::yield();
+	buffer.cancel();
+	for( size_t t = numProducers; t < threads.size(); ++t )
+		threads[t].join();
+
+	REQUIRE( numFailedPushes == 0 );
+	vector<int> counts( total, 0 );
+	for( const auto &items : received ) {
+		vector<int> last( numProducers, -1 );
+		for( int item : items ) {
+			++counts[item];
+			REQUIRE( item > last[item / numItems] );
+			last[item / numItems] = item;
+		}
+	}
+	for( int count : counts )
+		REQUIRE( count == 1 );
+}
+
+template<typename T>
+struct Spsc : public SpscCircularBuffer<T> {
+	template<typename U>
+	using Rebind = Spsc<U>;
+	using SpscCircularBuffer<T>::SpscCircularBuffer;
+};
+
+template<typename T>
+struct Mpmc : public MpmcCircularBuffer<T> {
+	template<typename U>
+	using Rebind = Mpmc<U>;
+	using MpmcCircularBuffer<T>::MpmcCircularBuffer;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "ConcurrentCircularBuffer" )
+{
+	SECTION( "SpscCircularBuffer behaves like ConcurrentCircularBuffer" )
+	{
+		testSingleThreaded<Spsc<int>>();
+		testCapacityOne<Spsc<int>>();
+		testCancel<Spsc<int>>();
+	}
+
+	SECTION( "MpmcCircularBuffer behaves like ConcurrentCircularBuffer" )
+	{
+		testSingleThreaded<Mpmc<int>>();
+		testCapacityOne<Mpmc<int>>();
+		testCancel<Mpmc<int>>();
+	}
+
+	SECTION( "SpscCircularBuffer hands every item over in order" )
+	{
+		for( uint32_t spinCount : { 0u, 128u } ) {
+			INFO( "spin count " << spinCount );
+			testThreaded<Spsc<int>>( 1, 1, spinCount );
+			testThreaded<Spsc<int>>( 1, 1, spinCount, 1 );
+		}
+	}
+
+	SECTION( "MpmcCircularBuffer hands every item over exactly once" )
+	{
+		for( uint32_t spinCount : { 0u, 128u } ) {
+			INFO( "spin count " << spinCount );
+			testThreaded<Mpmc<int>>( 3, 3, spinCount );
+			testThreaded<Mpmc<int>>( 1, 4, spinCount );
+			testThreaded<Mpmc<int>>( 2, 2, spinCount, 1 );
+			// more cells than the capacity, which is rounded up to a power of two
+			testThreaded<Mpmc<int>>( 2, 2, spinCount, 5 );
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#include "catch.hpp"
+
+#include "cinder/DataSource.h"
+#include "cinder/Rand.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+vector<uint8_t> writeTestFile( const fs::path &path, size_t size )
+{
+	vector<uint8_t> result( size );
+	Rand rnd( (uint32_t)size );
+	for( auto &byte : result )
+		byte = uint8_t( rnd.nextUint( 256 ) );
+
+	ofstream out( path.string(), ios::binary );
+	out.write( reinterpret_cast<const char*>( result.data() ), result.size() );
+	return result;
+}
+
+vector<uint8_t> readWholeFile( const fs::path &path )
+{
+	ifstream in( path.string(), ios::binary );
+	return vector<uint8_t>( istreambuf_iterator<char>( in ), istreambuf_iterator<char>() );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "DataSource" )
+{
+	const fs::path path = fs::temp_directory_path() / "cinder_data_source_test.bin";
+
+	SECTION( "Large files are memory mapped" )
+	{
+		const vector<uint8_t> contents = writeTestFile( path, DataSourcePath::MIN_MAPPED_FILE_SIZE * 3 + 17 );
+		DataSourcePathRef source = DataSourcePath::create( path );
+
+		BufferRef buffer = source->getBuffer();
+		REQUIRE( source->isMemoryMapped() );
+		REQUIRE( buffer->getSize() == contents.size() );
+		REQUIRE( memcmp( buffer->getData(), contents.data(), contents.size() ) == 0 );
+
+		IStreamRef stream = source->createStream();
+		REQUIRE( dynamic_pointer_cast<IStreamMapped>( stream ) );
+		REQUIRE( stream->size() == (off_t)contents.size() );
+		vector<uint8_t> read( 1000 );
+		stream->seekAbsolute( 5000 );
+		stream->readData( read.data(), read.size() );
+		REQUIRE( memcmp( read.data(), contents.data() + 5000, read.size() ) == 0 );
+		stream->seekAbsolute( -10 );
+		REQUIRE( stream->readDataAvailable( read.data(), read.size() ) == 10 );
+		REQUIRE( stream->isEof() );
+
+		// the mapping is copy-on-write and outlives the DataSource through the Buffer
+		source.reset();
+		static_cast<uint8_t*>( buffer->getData() )[0] ^= 0xff;
+		REQUIRE( readWholeFile( path ) == contents );
+		buffer->resize( 10 );
+		REQUIRE( memcmp( static_cast<uint8_t*>( buffer->getData() ) + 1, contents.data() + 1, 9 ) == 0 );
+	}
+
+	SECTION( "Small files and opting out read the file" )
+	{
+		const vector<uint8_t> small = writeTestFile( path, 100 );
+		DataSourcePathRef source = DataSourcePath::create( path );
+		REQUIRE( source->getBuffer()->getSize() == small.size() );
+		REQUIRE( memcmp( source->getBuffer()->getData(), small.data(), small.size() ) == 0 );
+		REQUIRE( ! source->isMemoryMapped() );
+		REQUIRE( ! dynamic_pointer_cast<IStreamMapped>( source->createStream() ) );
+
+		const vector<uint8_t> large = writeTestFile( path, DataSourcePath::MIN_MAPPED_FILE_SIZE * 2 );
+		DataSourcePathRef unmapped = DataSourcePath::create( path, false );
+		REQUIRE( memcmp( unmapped->getBuffer()->getData(), large.data(), large.size() ) == 0 );
+		REQUIRE( ! unmapped->isMemoryMapped() );
+	}
+
+	SECTION( "Missing files" )
+	{
+		fs::remove( path );
+		REQUIRE( ! loadFile( path )->createStream() );
+		REQUIRE( ! loadFileStreamMapped( path ) );
+		REQUIRE_THROWS_AS( MappedFile::create( path ), StreamExc );
+
+		// empty files map to no data
+		writeTestFile( path, 0 );
+		MappedFileRef empty = MappedFile::create( path );
+		REQUIRE( empty->getSize() == 0 );
+		REQUIRE( loadFileStreamMapped( path )->isEof() );
+	}
+
+	fs::remove( path );
+}
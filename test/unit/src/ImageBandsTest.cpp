@@ -0,0 +1,207 @@
+#include "catch.hpp"
+#include "Utilities.h"
+
+#include "cinder/ImageIo.h"
+#include "cinder/app/Platform.h"
+
+#include <fstream>
+
+#if defined( __GLIBC__ )
+	#include <malloc.h>
+#endif
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// loads \a source through loadImageBands() and stitches the bands back together, checking their order and size along the way
+template<typename T>
+SurfaceT<T> assembleBands( const ImageSourceRef &source, int32_t bandHeight, int *numBands )
+{
+	SurfaceT<T> result( source->getWidth(), source->getHeight(), source->hasAlpha() );
+	int32_t nextRow = 0;
+	*numBands = 0;
+	loadImageBands<T>( source, bandHeight, [&]( const SurfaceT<T> &band, int32_t firstRow ) {
+		REQUIRE( firstRow == nextRow );
+		REQUIRE( band.getWidth() == source->getWidth() );
+		REQUIRE( band.getHeight() <= bandHeight );
+		REQUIRE( band.getHeight() > 0 );
+		result.copyFrom( band, band.getBounds(), ivec2( 0, firstRow ) );
+		nextRow += band.getHeight();
+		++*numBands;
+	} );
+	REQUIRE( nextRow == source->getHeight() );
+
+	return result;
+}
+
+// Writes a run-length encoded Radiance file of literal runs, where every pixel has exponent 128 so that a channel value v decodes to v / 256. Requires 8 <= width <= 128.
+void writeRadiance( const fs::path &path, int32_t width, int32_t height )
+{
+	ofstream out( path.string(), ios::binary );
+	out << "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y " << height << " +X " << width << "\n";
+	for( int32_t y = 0; y < height; ++y ) {
+		const char scanlineHeader[4] = { 2, 2, char( width >> 8 ), char( width & 0xff ) };
+		out.write( scanlineHeader, 4 );
+		for( int component = 0; component < 4; ++component ) {
+			out.put( char( width ) );
+			for( int32_t x = 0; x < width; ++x ) {
+				const char rgbe[4] = { char( 4 + x ), char( 8 + y ), char( 100 ), char( 128 ) };
+				out.put( rgbe[component] );
+			}
+		}
+	}
+}
+
+#if defined( CINDER_LINUX )
+// resets the peak resident set size to the current one, returning -1 if unsupported
+long resetPeakRss()
+{
+#if defined( __GLIBC__ )
+	// hand memory freed by earlier allocations back to the OS, so it cannot hide the growth being measured
+	malloc_trim( 0 );
+#endif
+	ofstream clearRefs( "/proc/self/clear_refs" );
+	clearRefs << "5";
+	clearRefs.close();
+	return clearRefs.fail() ? -1 : 0;
+}
+
+long getPeakRss()
+{
+	ifstream status( "/proc/self/status" );
+	string line;
+	while( getline( status, line ) ) {
+		if( line.compare( 0, 6, "VmHWM:" ) == 0 )
+			return stol( line.substr( 6 ) );
+	}
+	return -1;
+}
+
+long getCurrentRss()
+{
+	ifstream status( "/proc/self/status" );
+	string line;
+	while( getline( status, line ) ) {
+		if( line.compare( 0, 6, "VmRSS:" ) == 0 )
+			return stol( line.substr( 6 ) );
+	}
+	return -1;
+}
+#endif
+
+} // anonymous namespace
+
+TEST_CASE( "ImageBands" )
+{
+	// make sure the platform's image codecs are registered
+	app::Platform::get();
+
+	const fs::path tempDir = fs::temp_directory_path();
+
+	SECTION( "PNG and QOI bands reassemble into the full image, which PNGs decode through stb_image" )
+	{
+		for( string extension : { "png", "qoi" } ) {
+			for( bool alpha : { false, true } ) {
+				INFO( extension << ( alpha ? " with alpha" : " without alpha" ) );
+				const Surface8u original = makeTestSurface( 301, 197, alpha, 3 );
+				const fs::path path = tempDir / ( "cinder_image_bands." + extension );
+				writeImage( path, original );
+
+				Surface8u full( loadImage( path ) );
+				REQUIRE( surfacesEqual( full, original ) );
+
+				int numBands;
+				Surface8u assembled = assembleBands<uint8_t>( loadImage( path ), 64, &numBands );
+				REQUIRE( numBands == 4 );
+				REQUIRE( surfacesEqual( assembled, original ) );
+
+				// the same source can be loaded more than once
+				ImageSourceRef source = loadImage( path );
+				Surface8u first( source );
+				Surface8u second( source );
+				REQUIRE( surfacesEqual( first, second ) );
+
+				Surface32f full32f( loadImage( path ) );
+				Surface32f assembled32f = assembleBands<float>( loadImage( path ), 50, &numBands );
+				REQUIRE( numBands == 4 );
+				REQUIRE( surfacesEqual( assembled32f, full32f ) );
+
+				fs::remove( path );
+			}
+		}
+	}
+
+	SECTION( "Radiance bands match the decoded values" )
+	{
+		const fs::path path = tempDir / "cinder_image_bands.hdr";
+		writeRadiance( path, 13, 9 );
+
+		int numBands;
+		Surface32f assembled = assembleBands<float>( loadImage( path ), 4, &numBands );
+		REQUIRE( numBands == 3 );
+		REQUIRE( ! assembled.hasAlpha() );
+		for( int32_t y = 0; y < 9; ++y ) {
+			for( int32_t x = 0; x < 13; ++x ) {
+				const ColorA c = assembled.getPixel( ivec2( x, y ) );
+				REQUIRE( c.r == ( 4 + x ) / 256.0f );
+				REQUIRE( c.g == ( 8 + y ) / 256.0f );
+				REQUIRE( c.b == 100 / 256.0f );
+			}
+		}
+
+		REQUIRE( surfacesEqual( assembled, Surface32f( loadImage( path ) ) ) );
+		fs::remove( path );
+	}
+
+	SECTION( "Bands gain opaque alpha on request" )
+	{
+		const Surface8u original = makeTestSurface( 40, 30, false, 5 );
+		ImageSourceRef source = original;
+		int32_t rows = 0;
+		writeImage( ImageTargetBands8u::create( source, 7, [&]( const Surface8u &band, int32_t ) {
+			REQUIRE( band.hasAlpha() );
+			auto iter = const_cast<Surface8u&>( band ).getIter();
+			while( iter.line() ) {
+				while( iter.pixel() )
+					REQUIRE( iter.a() == 255 );
+			}
+			rows += band.getHeight();
+		}, true ), source );
+		REQUIRE( rows == 30 );
+
+		REQUIRE_THROWS_AS( ImageTargetBands8u::create( source, 0, []( const Surface8u &, int32_t ) {} ), ImageIoException );
+	}
+
+#if defined( CINDER_LINUX )
+	SECTION( "Peak memory while streaming a large image stays well below the image size" )
+	{
+		const int32_t width = 4096, height = 2048;
+		for( string extension : { "png", "qoi" } ) {
+			INFO( extension );
+			const fs::path path = tempDir / ( "cinder_image_bands_large." + extension );
+			{
+				Surface8u large = makeTestSurface( width, height, false, 7 );
+				writeImage( path, large );
+			}
+
+			if( resetPeakRss() < 0 ) {
+				WARN( "Resetting the peak RSS is unsupported; skipping the measurement" );
+			}
+			else {
+				// reads the file rather than mapping it, whose page cache pages would otherwise count towards the RSS
+				const long baselineKb = getCurrentRss();
+				loadImageBands<uint8_t>( loadImage( DataSourcePath::create( path, false ) ), 64, []( const Surface8u &, int32_t ) {} );
+				const long peakKb = getPeakRss();
+				const long fullImageKb = (long)width * height * 3 / 1024;
+				// the process' peak RSS also depends on the allocator and whatever else is running, so it's only reported
+				if( peakKb - baselineKb >= fullImageKb / 8 )
+					WARN( "peak growth of " << ( peakKb - baselineKb ) << "KB while streaming " << extension << ", vs " << fullImageKb << "KB for the whole image" );
+			}
+
+			fs::remove( path );
+		}
+	}
+#endif
+}
@@ -0,0 +1,212 @@
+#include "catch.hpp"
+
+#include "cinder/ImageIo.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/Rand.h"
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/app/Platform.h"
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+const int sChannelOrders[] = { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR,
+	SurfaceChannelOrder::RGBX, SurfaceChannelOrder::BGRX, SurfaceChannelOrder::XRGB, SurfaceChannelOrder::XBGR, SurfaceChannelOrder::RGB, SurfaceChannelOrder::BGR };
+
+template<typename T>
+T randomValue( Rand &rnd )
+{
+	if constexpr( std::is_same<T,float>::value )
+		return rnd.nextFloat( -0.25f, 1.25f ); // exercises the clamping of float to integer conversions
+	else
+		return T( rnd.nextUint( CHANTRAIT<T>::max() + 1 ) );
+}
+
+template<typename T>
+SurfaceT<T> makeSurface( int32_t width, int32_t height, SurfaceChannelOrder channelOrder, uint32_t seed )
+{
+	SurfaceT<T> result( width, height, channelOrder.hasAlpha(), channelOrder );
+	Rand rnd( seed );
+	for( int32_t y = 0; y < height; ++y ) {
+		T *row = result.getData( ivec2( 0, y ) );
+		for( int32_t i = 0; i < width * result.getPixelInc(); ++i )
+			row[i] = randomValue<T>( rnd );
+	}
+
+	return result;
+}
+
+// verifies \a target against the per-channel CHANTRAIT conversion of \a source, ignoring padding channels
+template<typename SD, typename TD>
+bool matchesReference( const SurfaceT<SD> &source, const SurfaceT<TD> &target )
+{
+	for( int32_t y = 0; y < source.getHeight(); ++y ) {
+		for( int32_t x = 0; x < source.getWidth(); ++x ) {
+			const ColorAT<SD> s = source.getPixel( ivec2( x, y ) );
+			const ColorAT<TD> t = target.getPixel( ivec2( x, y ) );
+			if( t.r != CHANTRAIT<TD>::convert( s.r ) || t.g != CHANTRAIT<TD>::convert( s.g ) || t.b != CHANTRAIT<TD>::convert( s.b ) )
+				return false;
+			if( target.hasAlpha() && t.a != ( source.hasAlpha() ? CHANTRAIT<TD>::convert( s.a ) : CHANTRAIT<TD>::max() ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename SD, typename TD>
+void checkAllChannelOrders()
+{
+	// widths below, at and above the SIMD vector sizes, with SIMD kernels enabled and disabled
+	for( int32_t width : { 1, 7, 8, 17, 37 } ) {
+		for( auto sourceOrder : sChannelOrders ) {
+			const SurfaceT<SD> source = makeSurface<SD>( width, 3, sourceOrder, width * 100 + sourceOrder );
+			for( auto targetOrder : sChannelOrders ) {
+				for( bool simd : { true, false } ) {
+					INFO( "width " << width << " source order " << sourceOrder << " target order " << targetOrder << ( simd ? " SIMD" : " scalar" ) );
+					ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy().simd( simd ) );
+					SurfaceT<TD> target( width, 3, SurfaceChannelOrder( targetOrder ).hasAlpha(), targetOrder );
+					writeImage( (ImageTargetRef)target, (ImageSourceRef)source );
+					REQUIRE( matchesReference( source, target ) );
+				}
+			}
+		}
+	}
+}
+
+// box-filters \a full by \a factor, rounding to nearest, as the reduced decodes are expected to
+template<typename T>
+SurfaceT<T> reduceReference( const SurfaceT<T> &full, int32_t factor )
+{
+	SurfaceT<T> result( ( full.getWidth() + factor - 1 ) / factor, ( full.getHeight() + factor - 1 ) / factor, full.hasAlpha(), full.getChannelOrder() );
+	for( int32_t y = 0; y < result.getHeight(); ++y ) {
+		for( int32_t x = 0; x < result.getWidth(); ++x ) {
+			double sum[4] = { 0, 0, 0, 0 };
+			int count = 0;
+			for( int32_t sy = y * factor; sy < std::min( full.getHeight(), ( y + 1 ) * factor ); ++sy ) {
+				for( int32_t sx = x * factor; sx < std::min( full.getWidth(), ( x + 1 ) * factor ); ++sx ) {
+					const ColorAT<T> c = full.getPixel( ivec2( sx, sy ) );
+					sum[0] += c.r; sum[1] += c.g; sum[2] += c.b; sum[3] += c.a;
+					++count;
+				}
+			}
+			ColorAT<T> average;
+			if constexpr( std::is_same<T,float>::value )
+				average = ColorAT<T>( float( sum[0] / count ), float( sum[1] / count ), float( sum[2] / count ), float( sum[3] / count ) );
+			else
+				average = ColorAT<T>( T( sum[0] / count + 0.5 ), T( sum[1] / count + 0.5 ), T( sum[2] / count + 0.5 ), T( sum[3] / count + 0.5 ) );
+			result.setPixel( ivec2( x, y ), average );
+		}
+	}
+
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageIo" )
+{
+	SECTION( "8-bit copies and swizzles match the per-channel conversion" )
+	{
+		checkAllChannelOrders<uint8_t,uint8_t>();
+	}
+
+	SECTION( "8-bit to float conversions match the per-channel conversion" )
+	{
+		checkAllChannelOrders<uint8_t,float>();
+	}
+
+	SECTION( "Float to 8-bit conversions match the per-channel conversion" )
+	{
+		checkAllChannelOrders<float,uint8_t>();
+	}
+
+	SECTION( "Other conversions match the per-channel conversion" )
+	{
+		checkAllChannelOrders<uint16_t,uint16_t>();
+		checkAllChannelOrders<float,float>();
+		checkAllChannelOrders<uint16_t,uint8_t>();
+	}
+
+	SECTION( "Gray sources expand into every RGB channel order" )
+	{
+		Rand rnd( 11 );
+		Channel8u gray( 37, 5 );
+		for( int32_t y = 0; y < gray.getHeight(); ++y ) {
+			for( int32_t x = 0; x < gray.getWidth(); ++x )
+				*gray.getData( ivec2( x, y ) ) = uint8_t( rnd.nextUint( 256 ) );
+		}
+
+		for( auto targetOrder : sChannelOrders ) {
+			for( bool simd : { true, false } ) {
+				INFO( "target order " << targetOrder << ( simd ? " SIMD" : " scalar" ) );
+				ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy().simd( simd ) );
+				Surface8u target( gray.getWidth(), gray.getHeight(), SurfaceChannelOrder( targetOrder ).hasAlpha(), targetOrder );
+				writeImage( (ImageTargetRef)target, (ImageSourceRef)gray );
+				for( int32_t y = 0; y < gray.getHeight(); ++y ) {
+					for( int32_t x = 0; x < gray.getWidth(); ++x ) {
+						const uint8_t v = gray.getValue( ivec2( x, y ) );
+						REQUIRE( target.getPixel( ivec2( x, y ) ) == ColorA8u( v, v, v, 255 ) );
+					}
+				}
+			}
+		}
+	}
+
+	SECTION( "Reduced decodes box-filter the image while decoding" )
+	{
+		// make sure the platform's image codecs are registered
+		app::Platform::get();
+
+		for( string extension : { "png", "qoi" } ) {
+			for( bool alpha : { false, true } ) {
+				INFO( extension << ( alpha ? " with alpha" : " without alpha" ) );
+				const Surface8u original = makeSurface<uint8_t>( 301, 197, alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB, 17 );
+				const fs::path path = fs::temp_directory_path() / ( "cinder_image_io_reduced." + extension );
+				writeImage( path, original );
+
+				for( int32_t factor : { 1, 2, 4, 8 } ) {
+					INFO( "factor " << factor );
+					ImageSourceRef source = loadImage( path, ImageSource::Options().reductionFactor( factor ) );
+					REQUIRE( source->getReductionFactor() == factor );
+					const Surface8u reduced( source );
+					const Surface8u expected = reduceReference( Surface8u( loadImage( path ) ), factor );
+					REQUIRE( reduced.getSize() == expected.getSize() );
+					for( int32_t y = 0; y < expected.getHeight(); ++y ) {
+						for( int32_t x = 0; x < expected.getWidth(); ++x )
+							REQUIRE( reduced.getPixel( ivec2( x, y ) ) == expected.getPixel( ivec2( x, y ) ) );
+					}
+				}
+
+				// the largest reduction whose longer side is still at least maxSize, and non powers of two round down
+				ImageSourceRef thumbnail = loadImage( path, ImageSource::Options().maxSize( 64 ) );
+				REQUIRE( thumbnail->getReductionFactor() == 4 );
+				REQUIRE( thumbnail->getWidth() == 76 );
+				REQUIRE( thumbnail->getHeight() == 50 );
+				REQUIRE( loadImage( path, ImageSource::Options().reductionFactor( 7 ) )->getReductionFactor() == 4 );
+				REQUIRE( loadImage( path, ImageSource::Options().maxSize( 400 ) )->getReductionFactor() == 1 );
+				// reductions past a single pixel stop there
+				ImageSourceRef pixel = loadImage( path, ImageSource::Options().reductionFactor( INT32_MAX ) );
+				REQUIRE( pixel->getReductionFactor() == 512 );
+				REQUIRE( Surface8u( pixel ).getSize() == ivec2( 1, 1 ) );
+
+				fs::remove( path );
+			}
+		}
+
+		const Surface32f original = makeSurface<float>( 45, 30, SurfaceChannelOrder::RGBA, 23 );
+		const fs::path path = fs::temp_directory_path() / "cinder_image_io_reduced.exr";
+		writeImage( path, original );
+		const Surface32f reduced( loadImage( path, ImageSource::Options().reductionFactor( 4 ) ) );
+		const Surface32f expected = reduceReference( Surface32f( loadImage( path ) ), 4 );
+		REQUIRE( reduced.getSize() == ivec2( 12, 8 ) );
+		for( int32_t y = 0; y < expected.getHeight(); ++y ) {
+			for( int32_t x = 0; x < expected.getWidth(); ++x ) {
+				const ColorA r = reduced.getPixel( ivec2( x, y ) ), e = expected.getPixel( ivec2( x, y ) );
+				REQUIRE( glm::abs( r.r - e.r ) + glm::abs( r.g - e.g ) + glm::abs( r.b - e.b ) + glm::abs( r.a - e.a ) < 0.01f );
+			}
+		}
+		fs::remove( path );
+	}
+}
@@ -0,0 +1,185 @@
+#include "catch.hpp"
+
+#include "cinder/KdTree.h"
+#include "cinder/Rand.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// clusters of points with exact duplicates, so that ties and degenerate splits are exercised
+vector<vec3> makePoints( size_t numPoints, uint32_t seed )
+{
+	Rand rnd( seed );
+	vector<vec3> result;
+	while( result.size() < numPoints ) {
+		if( result.size() > 10 && rnd.nextUint( 20 ) == 0 )
+			result.push_back( result[rnd.nextUint( uint32_t( result.size() ) )] );
+		else if( rnd.nextBool() )
+			result.push_back( vec3( rnd.nextFloat( -2, 0 ), rnd.nextFloat( -2, 0 ), rnd.nextFloat( -0.01f, 0.01f ) ) );
+		else
+			result.push_back( rnd.randVec3() * rnd.nextFloat( 0.5f, 3 ) );
+	}
+
+	return result;
+}
+
+float distSqrd( const vec3 &a, const vec3 &b )
+{
+	float result = 0;
+	for( int k = 0; k < 3; ++k )
+		result += ( a[k] - b[k] ) * ( a[k] - b[k] );
+	return result;
+}
+
+// the \a k nearest by distance and then index, as the tree orders them
+vector<pair<float,uint32_t>> bruteNearest( const vector<vec3> &points, const vec3 &p, size_t k, float maxDist = FLT_MAX )
+{
+	vector<pair<float,uint32_t>> result;
+	for( uint32_t i = 0; i < points.size(); ++i ) {
+		const float d = distSqrd( points[i], p );
+		if( maxDist == FLT_MAX || d < maxDist * maxDist )
+			result.push_back( { d, i } );
+	}
+	sort( result.begin(), result.end() );
+	result.resize( min( k, result.size() ) );
+	return result;
+}
+
+vector<uint32_t> bruteInRadius( const vector<vec3> &points, const vec3 &p, float radius )
+{
+	vector<uint32_t> result;
+	for( uint32_t i = 0; i < points.size(); ++i ) {
+		if( distSqrd( points[i], p ) < radius * radius )
+			result.push_back( i );
+	}
+	return result;
+}
+
+struct CollectProc {
+	void process( uint32_t id, float distSqrd, float &maxDistSqrd ) const { mResults->push_back( { distSqrd, id } ); }
+
+	vector<pair<float,uint32_t>>	*mResults;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "KdTree" )
+{
+	const vector<vec3> points = makePoints( 5000, 3 );
+	const vector<vec3> queries = makePoints( 200, 5 );
+
+	SECTION( "k-nearest and radius queries match brute force" )
+	{
+		for( uint32_t leafSize : { 1u, 8u, 64u } ) {
+			INFO( "leaf size " << leafSize );
+			KdTree<vec3> tree( points, leafSize );
+			REQUIRE( tree.size() == points.size() );
+			for( const vec3 &q : queries ) {
+				for( size_t k : { 1, 7, 100 } ) {
+					for( float maxDist : { FLT_MAX, 0.3f } ) {
+						const auto expected = bruteNearest( points, q, k, maxDist );
+						vector<uint32_t> indices( k );
+						vector<float> dists( k );
+						const size_t found = tree.findNearest( q, k, indices.data(), dists.data(), maxDist );
+						REQUIRE( found == expected.size() );
+						for( size_t i = 0; i < found; ++i ) {
+							REQUIRE( indices[i] == expected[i].second );
+							REQUIRE( dists[i] == expected[i].first );
+						}
+					}
+				}
+
+				for( float radius : { 0.0f, 0.05f, 0.4f } ) {
+					const vector<uint32_t> expected = bruteInRadius( points, q, radius );
+					vector<uint32_t> indices;
+					tree.findInRadius( q, radius, &indices );
+					sort( indices.begin(), indices.end() );
+					REQUIRE( indices == expected );
+
+					// a small buffer still reports the total
+					uint32_t buffer[4];
+					REQUIRE( tree.findInRadius( q, radius, buffer, 4 ) == expected.size() );
+					for( size_t i = 0; i < min<size_t>( 4, expected.size() ); ++i )
+						REQUIRE( binary_search( expected.begin(), expected.end(), buffer[i] ) );
+				}
+			}
+		}
+	}
+
+	SECTION( "Batched queries match single queries and don't depend on the number of threads" )
+	{
+		const size_t k = 5, maxResults = 16;
+		const float radius = 0.2f;
+		KdTree<vec3> tree( points, 8, 1 );
+		KdTree<vec3> threadedTree( points, 8, 4 );
+
+		vector<uint32_t> indices( queries.size() * k ), counts( queries.size() ), radiusIndices( queries.size() * maxResults );
+		vector<float> dists( queries.size() * k );
+		for( int numThreads : { 1, 3 } ) {
+			INFO( numThreads << " threads" );
+			threadedTree.findNearest( queries.data(), queries.size(), k, indices.data(), dists.data(), 0.1f, numThreads );
+			threadedTree.findInRadius( queries.data(), queries.size(), radius, maxResults, radiusIndices.data(), counts.data(), nullptr, numThreads );
+			for( size_t i = 0; i < queries.size(); ++i ) {
+				uint32_t expected[k];
+				const size_t found = tree.findNearest( queries[i], k, expected, nullptr, 0.1f );
+				for( size_t j = 0; j < k; ++j ) {
+					REQUIRE( indices[i * k + j] == ( j < found ? expected[j] : KdTree<vec3>::INVALID_INDEX ) );
+					if( j >= found )
+						REQUIRE( dists[i * k + j] == FLT_MAX );
+				}
+
+				const vector<uint32_t> inRadius = bruteInRadius( points, queries[i], radius );
+				REQUIRE( counts[i] == inRadius.size() );
+				vector<uint32_t> batched( radiusIndices.begin() + i * maxResults, radiusIndices.begin() + i * maxResults + min<size_t>( counts[i], maxResults ) );
+				for( uint32_t index : batched )
+					REQUIRE( binary_search( inRadius.begin(), inRadius.end(), index ) );
+			}
+		}
+	}
+
+	SECTION( "lookup() and the legacy findNearest() match brute force" )
+	{
+		KdTree<vec3, 3, CollectProc> tree( points );
+		for( const vec3 &q : queries ) {
+			vector<pair<float,uint32_t>> results;
+			tree.lookup( q, CollectProc{ &results }, 0.3f );
+			sort( results.begin(), results.end() );
+			REQUIRE( results == bruteNearest( points, q, points.size(), 0.3f ) );
+
+			float p[3] = { q.x, q.y, q.z }, result[3];
+			uint32_t index;
+			tree.findNearest( p, result, &index );
+			REQUIRE( index == bruteNearest( points, q, 1 )[0].second );
+			REQUIRE( vec3( result[0], result[1], result[2] ) == points[index] );
+		}
+	}
+
+	SECTION( "2D and empty trees" )
+	{
+		Rand rnd( 7 );
+		vector<vec2> points2d;
+		for( int i = 0; i < 1000; ++i )
+			points2d.push_back( rnd.randVec2() * rnd.nextFloat( 10 ) );
+		KdTree<vec2, 2> tree( points2d );
+		for( int i = 0; i < 50; ++i ) {
+			const vec2 q = rnd.randVec2() * rnd.nextFloat( 10 );
+			uint32_t nearest;
+			REQUIRE( tree.findNearest( q, 1, &nearest ) == 1 );
+			for( const vec2 &p : points2d )
+				REQUIRE( length2( p - q ) >= length2( points2d[nearest] - q ) );
+		}
+
+		KdTree<vec3> empty{ vector<vec3>() };
+		REQUIRE( empty.empty() );
+		uint32_t index;
+		REQUIRE( empty.findNearest( vec3( 0 ), 3, &index ) == 0 );
+		REQUIRE( empty.findInRadius( vec3( 0 ), 1, &index, 1 ) == 0 );
+		float p[3] = { 0, 0, 0 }, result[3];
+		empty.findNearest( p, result, &index );
+		REQUIRE( index == uint32_t( -1 ) );
+	}
+}
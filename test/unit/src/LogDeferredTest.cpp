@@ -0,0 +1,231 @@
+#include "catch.hpp"
+
+#include "cinder/LogDeferred.h"
+
+#include <condition_variable>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// records every entry it is given, optionally stalling the first write until release() is called
+class LoggerCapture : public log::Logger {
+  public:
+	LoggerCapture( bool stallFirst = false ) : Logger( log::LEVEL_VERBOSE ), mStalled( stallFirst ) {}
+
+	void write( const log::Metadata &meta, const std::string &text ) override
+	{
+		unique_lock<mutex> lock( mMutex );
+		mWriting = true;
+		mCondition.notify_all();
+		mCondition.wait( lock, [this] { return ! mStalled; } );
+		mMetadata.push_back( meta );
+		mEntries.push_back( text );
+	}
+
+	void waitUntilWriting()
+	{
+		unique_lock<mutex> lock( mMutex );
+		mCondition.wait( lock, [this] { return mWriting; } );
+	}
+
+	void release()
+	{
+		{
+			lock_guard<mutex> lock( mMutex );
+			mStalled = false;
+		}
+		mCondition.notify_all();
+	}
+
+	mutex						mMutex;
+	condition_variable			mCondition;
+	bool						mStalled, mWriting = false;
+	vector<log::Metadata>		mMetadata;
+	vector<string>				mEntries;
+};
+
+string readFile( const fs::path &path )
+{
+	ifstream in( path.string(), ios::binary );
+	stringstream result;
+	result << in.rdbuf();
+	return result.str();
+}
+
+} // anonymous namespace
+
+TEST_CASE( "LogDeferred" )
+{
+	auto capture = make_shared<LoggerCapture>();
+	log::manager()->resetLogger( capture );
+	log::DeferredLogManager *deferred = log::deferredManager();
+
+	SECTION( "Arguments format as they would through CI_LOG" )
+	{
+		const string str = "string";
+		const string_view view = string_view( str ).substr( 0, 3 );
+		const char *nullStr = nullptr;
+		int value = 0;
+		CI_LOG_DEFERRED_I( "{} {} {} {} {} {} {} {} {} {} {} {}", true, 'c', (uint8_t)65, (int16_t)-3, -7, 4000000000u, -( 1ll << 40 ), 1.0f / 3, 1e300, str, view, &value );
+		CI_LOG_DEFERRED_W( "literal {} and {}, missing {}", "text", nullStr );
+		CI_LOG_DEFERRED_E( "no arguments {}" );
+		deferred->flush();
+
+		REQUIRE( capture->mEntries.size() == 3 );
+		stringstream expected;
+		expected << true << " " << 'c' << " " << (uint8_t)65 << " " << (int16_t)-3 << " " << -7 << " " << 4000000000u << " " << -( 1ll << 40 ) << " " << 1.0f / 3 << " " << 1e300
+			<< " " << str << " " << view << " " << (const void*)&value;
+		REQUIRE( capture->mEntries[0] == expected.str() );
+		REQUIRE( capture->mEntries[1] == "literal text and (null), missing {}" );
+		REQUIRE( capture->mEntries[2] == "no arguments {}" );
+
+		REQUIRE( capture->mMetadata[0].mLevel == log::LEVEL_INFO );
+		REQUIRE( capture->mMetadata[1].mLevel == log::LEVEL_WARNING );
+		REQUIRE( capture->mMetadata[2].mLevel == log::LEVEL_ERROR );
+		REQUIRE( capture->mMetadata[0].mLocation.getFunctionName() == CINDER_CURRENT_FUNCTION );
+		REQUIRE( capture->mMetadata[0].mLocation.getLineNumber() == capture->mMetadata[1].mLocation.getLineNumber() - 1 );
+		REQUIRE( capture->mMetadata[0].mTime <= capture->mMetadata[1].mTime );
+	}
+
+	SECTION( "The binary file decodes to what the Loggers were given, in order for each thread" )
+	{
+		const fs::path binaryPath = fs::temp_directory_path() / "cinder_log_deferred.bin";
+		deferred->setBinaryFile( binaryPath );
+
+		const int numThreads = 4, numEntries = 5000;
+		vector<thread> threads;
+		for( int t = 0; t < numThreads; ++t ) {
+			threads.emplace_back( [t] {
+				for( int i = 0; i < numEntries; ++i )
+					CI_LOG_DEFERRED_V( "thread {} entry {} of {}", t, i, "5000" );
+			} );
+		}
+		for( auto &thread : threads )
+			thread.join();
+		deferred->flush();
+		deferred->setBinaryFile( fs::path() );
+		REQUIRE( deferred->getNumDropped() == 0 );
+
+		vector<log::Metadata> metadata;
+		vector<string> entries;
+		log::readDeferredLog( binaryPath, [&]( const log::Metadata &meta, const string &text ) {
+			metadata.push_back( meta );
+			entries.push_back( text );
+		} );
+
+		REQUIRE( entries == capture->mEntries );
+		REQUIRE( entries.size() == numThreads * numEntries );
+		vector<int> next( numThreads, 0 );
+		for( size_t i = 0; i < entries.size(); ++i ) {
+			REQUIRE( metadata[i].mTime == capture->mMetadata[i].mTime );
+			REQUIRE( metadata[i].mLevel == log::LEVEL_VERBOSE );
+			int t, index;
+			REQUIRE( sscanf( entries[i].c_str(), "thread %d entry %d of 5000", &t, &index ) == 2 );
+			REQUIRE( index == next[t]++ );
+		}
+
+		fs::remove( binaryPath );
+	}
+
+	SECTION( "Decoding reproduces LoggerFile's layout" )
+	{
+		const fs::path binaryPath = fs::temp_directory_path() / "cinder_log_deferred_layout.bin";
+		const fs::path textPath = fs::temp_directory_path() / "cinder_log_deferred_layout.txt";
+		const fs::path decodedPath = fs::temp_directory_path() / "cinder_log_deferred_layout_decoded.txt";
+		auto fileLogger = make_shared<log::LoggerFile>( textPath, false );
+		fileLogger->setLevel( log::LEVEL_VERBOSE );
+		log::manager()->resetLogger( fileLogger );
+		deferred->setBinaryFile( binaryPath );
+
+		for( int i = 0; i < 100; ++i )
+			CI_LOG_DEFERRED_I( "entry {} at {}", i, i * 0.25 );
+		deferred->flush();
+		deferred->setBinaryFile( fs::path() );
+		log::manager()->resetLogger( capture );
+		fileLogger.reset();
+
+		{
+			log::LoggerFile decoded( decodedPath, false );
+			decoded.setLevel( log::LEVEL_VERBOSE );
+			log::readDeferredLog( binaryPath, [&]( const log::Metadata &meta, const string &text ) { decoded.write( meta, text ); } );
+		}
+
+		const string text = readFile( textPath );
+		REQUIRE( ! text.empty() );
+		REQUIRE( text == readFile( decodedPath ) );
+
+		fs::remove( binaryPath );
+		fs::remove( textPath );
+		fs::remove( decodedPath );
+	}
+
+	SECTION( "Full buffers drop and count entries" )
+	{
+		auto stalled = make_shared<LoggerCapture>( true );
+		log::manager()->resetLogger( stalled );
+		deferred->setThreadBufferSize( 1024 );
+		const uint64_t numDroppedBefore = deferred->getNumDropped();
+		// a new thread, since the size applies to threads logging their first deferred entry
+		thread( [stalled] {
+			CI_LOG_DEFERRED_I( "first" );
+			// the drain thread is stuck writing the first entry while the buffer fills up
+			stalled->waitUntilWriting();
+			for( int i = 0; i < 1000; ++i )
+				CI_LOG_DEFERRED_I( "entry {}", i );
+		} ).join();
+		const uint64_t numDropped = deferred->getNumDropped() - numDroppedBefore;
+		REQUIRE( numDropped > 900 );
+
+		stalled->release();
+		deferred->flush();
+		REQUIRE( stalled->mEntries.size() == 1 + 1000 - numDropped + 1 );
+		// reported by the drain pass that was stalled, ahead of the entries that were still buffered
+		auto report = find( stalled->mEntries.begin(), stalled->mEntries.end(), to_string( numDropped ) + " deferred log entries were dropped because their thread's buffer was full" );
+		REQUIRE( report != stalled->mEntries.end() );
+		REQUIRE( stalled->mMetadata[report - stalled->mEntries.begin()].mLevel == log::LEVEL_WARNING );
+
+		deferred->setThreadBufferSize( 256 * 1024 );
+	}
+
+	SECTION( "Malformed files throw" )
+	{
+		const fs::path path = fs::temp_directory_path() / "cinder_log_deferred_malformed.bin";
+		{
+			ofstream out( path.string(), ios::binary );
+			out << "not a log";
+		}
+		REQUIRE_THROWS_AS( log::readDeferredLog( path, []( const log::Metadata &, const string & ) {} ), log::DeferredLogExc );
+		fs::remove( path );
+		REQUIRE_THROWS_AS( log::readDeferredLog( path, []( const log::Metadata &, const string & ) {} ), log::DeferredLogExc );
+
+		// a valid header followed by a format whose id or name length is far beyond what the file holds
+		const auto writeFormat = [&]( uint32_t id, uint32_t formatLength ) {
+			ofstream out( path.string(), ios::binary );
+			const uint32_t byteOrderMark = 0x01020304, version = 1, line = 1;
+			const uint8_t level = uint8_t( log::LEVEL_INFO ), numArgs = 0;
+			out.write( "CIDEFLOG", 8 );
+			out.write( reinterpret_cast<const char*>( &byteOrderMark ), sizeof( byteOrderMark ) );
+			out.write( reinterpret_cast<const char*>( &version ), sizeof( version ) );
+			out.put( 'F' );
+			out.write( reinterpret_cast<const char*>( &id ), sizeof( id ) );
+			out.write( reinterpret_cast<const char*>( &level ), sizeof( level ) );
+			out.write( reinterpret_cast<const char*>( &line ), sizeof( line ) );
+			out.write( reinterpret_cast<const char*>( &numArgs ), sizeof( numArgs ) );
+			// the format's length, then empty function and file names
+			const uint32_t lengths[3] = { formatLength, 0, 0 };
+			out.write( reinterpret_cast<const char*>( lengths ), sizeof( lengths ) );
+		};
+		writeFormat( 0xFFFFFFF0, 0 );
+		REQUIRE_THROWS_AS( log::readDeferredLog( path, []( const log::Metadata &, const string & ) {} ), log::DeferredLogExc );
+		writeFormat( 1, 0xFFFFFFF0 );
+		REQUIRE_THROWS_AS( log::readDeferredLog( path, []( const log::Metadata &, const string & ) {} ), log::DeferredLogExc );
+		fs::remove( path );
+	}
+
+	log::manager()->restoreToDefault();
+}
@@ -0,0 +1,189 @@
+#include "catch.hpp"
+
+#include "cinder/Log.h"
+
+#include <condition_variable>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <thread>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// records every entry it is given, optionally stalling on the first one until release() is called
+class LoggerCapture : public log::Logger {
+  public:
+	LoggerCapture( bool stallFirst = false )
+		: Logger( log::LEVEL_VERBOSE ), mStalled( stallFirst )
+	{}
+
+	void write( const log::Metadata &meta, const std::string &text ) override
+	{
+		unique_lock<mutex> lock( mMutex );
+		mCondition.wait( lock, [this] { return ! mStalled; } );
+		mEntries.push_back( text );
+		mLevels.push_back( meta.mLevel );
+		mThreads.push_back( this_thread::get_id() );
+	}
+
+	void release()
+	{
+		{
+			lock_guard<mutex> lock( mMutex );
+			mStalled = false;
+		}
+		mCondition.notify_all();
+	}
+
+	vector<string> getEntries()
+	{
+		lock_guard<mutex> lock( mMutex );
+		return mEntries;
+	}
+
+	vector<log::Level>			mLevels;
+	vector<thread::id>			mThreads;
+
+  private:
+	mutex					mMutex;
+	condition_variable		mCondition;
+	bool					mStalled;
+	vector<string>			mEntries;
+};
+
+string logNested()
+{
+	CI_LOG_I( "inner" );
+	return "nested";
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Log" )
+{
+	auto capture = make_shared<LoggerCapture>();
+	log::manager()->resetLogger( capture );
+
+	SECTION( "Entries format the same synchronously and asynchronously, without leaking formatting state" )
+	{
+		for( bool async : { false, true } ) {
+			INFO( ( async ? "async" : "sync" ) );
+			if( async )
+				log::manager()->enableAsync( 16 );
+
+			CI_LOG_I( hex << 255 << " " << setw( 4 ) << 1 );
+			CI_LOG_I( 255 << " " << 1.0f / 3 );
+			CI_LOG_I( "outer " << logNested() );
+			CI_LOG_W( string( 10000, 'x' ) );
+			log::manager()->flush();
+
+			const vector<string> entries = capture->getEntries();
+			REQUIRE( entries.size() == 5 );
+			REQUIRE( entries[0] == "ff    1" );
+			REQUIRE( entries[1] == "255 0.333333" );
+			REQUIRE( entries[2] == "inner" );
+			REQUIRE( entries[3] == "outer nested" );
+			REQUIRE( entries[4] == string( 10000, 'x' ) );
+			REQUIRE( capture->mLevels[4] == log::LEVEL_WARNING );
+			REQUIRE( ( capture->mThreads[0] == this_thread::get_id() ) == ! async );
+
+			log::manager()->disableAsync();
+			capture = make_shared<LoggerCapture>();
+			log::manager()->resetLogger( capture );
+		}
+	}
+
+	SECTION( "Asynchronous entries from several threads are all written in per-thread order before flush() returns" )
+	{
+		log::manager()->enableAsync( 64, log::OVERFLOW_BLOCK );
+		REQUIRE( log::manager()->isAsyncEnabled() );
+
+		const int numThreads = 4, numEntries = 2000;
+		vector<thread> threads;
+		for( int t = 0; t < numThreads; ++t ) {
+			threads.emplace_back( [t] {
+				for( int i = 0; i < numEntries; ++i )
+					CI_LOG_I( t << " " << i );
+			} );
+		}
+		for( auto &thread : threads )
+			thread.join();
+		log::manager()->flush();
+
+		const vector<string> entries = capture->getEntries();
+		REQUIRE( entries.size() == numThreads * numEntries );
+		vector<int> next( numThreads, 0 );
+		for( const string &entry : entries ) {
+			int t, i;
+			REQUIRE( sscanf( entry.c_str(), "%d %d", &t, &i ) == 2 );
+			REQUIRE( i == next[t]++ );
+		}
+		REQUIRE( log::manager()->getNumDropped() == 0 );
+
+		log::manager()->disableAsync();
+		REQUIRE( ! log::manager()->isAsyncEnabled() );
+		CI_LOG_I( "sync" );
+		REQUIRE( capture->getEntries().back() == "sync" );
+	}
+
+	SECTION( "A full queue drops and counts entries under OVERFLOW_DROP" )
+	{
+		auto stalled = make_shared<LoggerCapture>( true );
+		log::manager()->resetLogger( stalled );
+		log::manager()->enableAsync( 16, log::OVERFLOW_DROP );
+
+		const int numEntries = 100;
+		for( int i = 0; i < numEntries; ++i )
+			CI_LOG_I( i );
+		const uint64_t numDropped = log::manager()->getNumDropped();
+		REQUIRE( numDropped >= numEntries - 16 - 1 );
+
+		stalled->release();
+		log::manager()->flush();
+
+		const vector<string> entries = stalled->getEntries();
+		REQUIRE( entries.size() == numEntries - numDropped + 1 );
+		REQUIRE( entries.back() == to_string( numDropped ) + " log entries were dropped because the asynchronous log queue was full" );
+		REQUIRE( stalled->mLevels.back() == log::LEVEL_WARNING );
+
+		log::manager()->disableAsync();
+	}
+
+	SECTION( "A full queue holds producers back under OVERFLOW_BLOCK, and async logging can be re-enabled after it" )
+	{
+		auto stalled = make_shared<LoggerCapture>( true );
+		log::manager()->resetLogger( stalled );
+		log::manager()->enableAsync( 16, log::OVERFLOW_BLOCK );
+
+		const int numEntries = 100;
+		thread producer( [] {
+			for( int i = 0; i < numEntries; ++i )
+				CI_LOG_I( i );
+		} );
+		this_thread::sleep_for( chrono::milliseconds( 20 ) );
+		stalled->release();
+		producer.join();
+		log::manager()->flush();
+
+		vector<string> entries = stalled->getEntries();
+		REQUIRE( entries.size() == numEntries );
+		for( int i = 0; i < numEntries; ++i )
+			REQUIRE( entries[i] == to_string( i ) );
+		REQUIRE( log::manager()->getNumDropped() == 0 );
+
+		for( int i = 0; i < 3; ++i ) {
+			log::manager()->disableAsync();
+			log::manager()->enableAsync( 16, log::OVERFLOW_BLOCK );
+			CI_LOG_I( "again " << i );
+			log::manager()->flush();
+			REQUIRE( stalled->getEntries().back() == "again " + to_string( i ) );
+		}
+
+		log::manager()->disableAsync();
+	}
+
+	log::manager()->restoreToDefault();
+}
@@ -1,9 +1,253 @@
 
 #include "catch.hpp"
 #include "cinder/ObjLoader.h"
+#include "cinder/Rand.h"
 #include "cinder/TriMesh.h"
 
+#include <cstdio>
+#include <map>
+#include <sstream>
+
 using namespace cinder;
+using namespace std;
+
+namespace {
+
+// The stringstream based parser ObjLoader used before it parsed in parallel, as the reference for its records
+struct LegacyObj {
+	vector<vec3>				mVertices, mNormals;
+	vector<vec2>				mTexCoords;
+	vector<ObjLoader::Group>	mGroups;
+};
+
+void legacyParseFace( ObjLoader::Group *group, const ObjLoader::Material *material, const string &s, bool includeNormals, bool includeTexCoords )
+{
+	ObjLoader::Face result;
+	result.mNumVertices = 0;
+	result.mMaterial = material;
+
+	size_t offset = 2; // account for "f "
+	size_t length = s.length();
+	while( offset < length ) {
+		size_t endOfTriple, firstSlashOffset, secondSlashOffset;
+		while( s[offset] == ' ' )
+			++offset;
+		endOfTriple = s.find( ' ', offset );
+		if( endOfTriple == string::npos ) endOfTriple = length;
+		firstSlashOffset = s.find( '/', offset );
+		if( firstSlashOffset != string::npos ) {
+			secondSlashOffset = s.find( '/', firstSlashOffset + 1 );
+			if( secondSlashOffset > endOfTriple ) secondSlashOffset = string::npos;
+		}
+		else
+			secondSlashOffset = string::npos;
+
+		int vertexIndex = ( firstSlashOffset != string::npos ) ? stoi( s.substr( offset, firstSlashOffset - offset ) ) : stoi( s.substr( offset, endOfTriple - offset ) );
+		if( vertexIndex < 0 )
+			result.mVertexIndices.push_back( group->mBaseVertexOffset + vertexIndex );
+		else
+			result.mVertexIndices.push_back( vertexIndex - 1 );
+
+		if( includeTexCoords && ( firstSlashOffset != string::npos ) ) {
+			size_t numSize = ( secondSlashOffset == string::npos ) ? ( endOfTriple - firstSlashOffset - 1 ) : secondSlashOffset - firstSlashOffset - 1;
+			if( numSize > 0 ) {
+				int texCoordIndex = stoi( s.substr( firstSlashOffset + 1, numSize ) );
+				if( texCoordIndex < 0 )
+					result.mTexCoordIndices.push_back( group->mBaseTexCoordOffset + texCoordIndex );
+				else
+					result.mTexCoordIndices.push_back( texCoordIndex - 1 );
+				if( group->mFaces.empty() )
+					group->mHasTexCoords = true;
+			}
+			else
+				group->mHasTexCoords = false;
+		}
+		else if( group->mFaces.empty() )
+			group->mHasTexCoords = false;
+
+		if( includeNormals && ( secondSlashOffset != string::npos ) ) {
+			int normalIndex = stoi( s.substr( secondSlashOffset + 1, endOfTriple - secondSlashOffset - 1 ) );
+			if( normalIndex < 0 )
+				result.mNormalIndices.push_back( group->mBaseNormalOffset + normalIndex );
+			else
+				result.mNormalIndices.push_back( normalIndex - 1 );
+			group->mHasNormals = true;
+		}
+		else if( group->mFaces.empty() )
+			group->mHasNormals = false;
+
+		offset = endOfTriple + 1;
+		result.mNumVertices++;
+	}
+
+	group->mFaces.push_back( result );
+}
+
+LegacyObj legacyParse( const string &text, const map<string, ObjLoader::Material> &materials, bool includeNormals, bool includeTexCoords )
+{
+	LegacyObj result;
+	IStreamRef stream = IStreamMem::create( text.data(), text.size() );
+	result.mGroups.push_back( ObjLoader::Group() );
+	ObjLoader::Group *currentGroup = &result.mGroups.back();
+	currentGroup->mBaseVertexOffset = currentGroup->mBaseTexCoordOffset = currentGroup->mBaseNormalOffset = 0;
+	const ObjLoader::Material *currentMaterial = nullptr;
+
+	while( ! stream->isEof() ) {
+		string line = stream->readLine(), tag;
+		if( line.empty() || line[0] == '#' )
+			continue;
+		while( line.back() == '\\' && ! stream->isEof() )
+			line = line.substr( 0, line.size() - 1 ) + stream->readLine();
+
+		stringstream ss( line );
+		ss >> tag;
+		if( tag == "v" ) {
+			vec3 v;
+			ss >> v.x >> v.y >> v.z;
+			result.mVertices.push_back( v );
+		}
+		else if( tag == "vt" ) {
+			if( includeTexCoords ) {
+				vec2 tex;
+				ss >> tex.x >> tex.y;
+				result.mTexCoords.push_back( tex );
+			}
+		}
+		else if( tag == "vn" ) {
+			if( includeNormals ) {
+				vec3 v;
+				ss >> v.x >> v.y >> v.z;
+				result.mNormals.push_back( normalize( v ) );
+			}
+		}
+		else if( tag == "f" )
+			legacyParseFace( currentGroup, currentMaterial, line, includeNormals, includeTexCoords );
+		else if( tag == "g" ) {
+			if( ! currentGroup->mFaces.empty() )
+				result.mGroups.push_back( ObjLoader::Group() );
+			currentGroup = &result.mGroups.back();
+			currentGroup->mBaseVertexOffset = (int32_t)result.mVertices.size();
+			currentGroup->mBaseTexCoordOffset = (int32_t)result.mTexCoords.size();
+			currentGroup->mBaseNormalOffset = (int32_t)result.mNormals.size();
+			currentGroup->mName = line.substr( line.find( ' ' ) + 1 );
+		}
+		else if( tag == "usemtl" ) {
+			string name;
+			ss >> name;
+			auto m = materials.find( name );
+			if( m != materials.end() )
+				currentMaterial = &m->second;
+		}
+	}
+
+	return result;
+}
+
+void requireSameGroups( const vector<ObjLoader::Group> &groups, const vector<ObjLoader::Group> &expected )
+{
+	REQUIRE( groups.size() == expected.size() );
+	for( size_t g = 0; g < groups.size(); ++g ) {
+		INFO( "group " << g );
+		REQUIRE( groups[g].mName == expected[g].mName );
+		REQUIRE( groups[g].mBaseVertexOffset == expected[g].mBaseVertexOffset );
+		REQUIRE( groups[g].mBaseTexCoordOffset == expected[g].mBaseTexCoordOffset );
+		REQUIRE( groups[g].mBaseNormalOffset == expected[g].mBaseNormalOffset );
+		REQUIRE( groups[g].mHasTexCoords == expected[g].mHasTexCoords );
+		REQUIRE( groups[g].mHasNormals == expected[g].mHasNormals );
+		REQUIRE( groups[g].mFaces.size() == expected[g].mFaces.size() );
+		for( size_t f = 0; f < groups[g].mFaces.size(); ++f ) {
+			const ObjLoader::Face &face = groups[g].mFaces[f], &expectedFace = expected[g].mFaces[f];
+			REQUIRE( face.mNumVertices == expectedFace.mNumVertices );
+			REQUIRE( face.mVertexIndices == expectedFace.mVertexIndices );
+			REQUIRE( face.mTexCoordIndices == expectedFace.mTexCoordIndices );
+			REQUIRE( face.mNormalIndices == expectedFace.mNormalIndices );
+			REQUIRE( ( face.mMaterial ? face.mMaterial->mName : "" ) == ( expectedFace.mMaterial ? expectedFace.mMaterial->mName : "" ) );
+		}
+	}
+}
+
+// A float in one of the notations found in OBJ files
+string randomFloat( Rand &rnd )
+{
+	char result[64];
+	const float value = rnd.nextFloat( -100, 100 );
+	switch( rnd.nextUint( 4 ) ) {
+		case 0: snprintf( result, sizeof( result ), "%.*f", (int)rnd.nextUint( 10 ), value ); break;
+		case 1: snprintf( result, sizeof( result ), "%e", value ); break;
+		case 2: snprintf( result, sizeof( result ), "%+.3f", value ); break;
+		default: snprintf( result, sizeof( result ), "%.9g", value ); break;
+	}
+	return result;
+}
+
+// Appends \a line with a random line ending, occasionally splitting it with a '\' continuation at one of its spaces
+void appendLine( string *text, const string &line, Rand &rnd )
+{
+	const char *endings[] = { "\n", "\r\n", "\r" };
+	size_t split = line.find( ' ', 2 );
+	if( rnd.nextUint( 10 ) == 0 && split != string::npos )
+		*text += line.substr( 0, split ) + " \\" + endings[rnd.nextUint( 3 )] + line.substr( split );
+	else
+		*text += line;
+	*text += endings[rnd.nextUint( 3 )];
+}
+
+// A face of 3 to 5 vertices indexing \a numVertices positions, tex coords and normals, in any of the "v", "v/vt", "v//vn" and "v/vt/vn" forms unless \a complete
+string randomFace( Rand &rnd, uint32_t numVertices, bool complete )
+{
+	string result = "f";
+	uint32_t form = complete ? 3 : rnd.nextUint( 4 );
+	for( uint32_t v = 0, count = 3 + rnd.nextUint( 3 ); v < count; ++v ) {
+		auto index = [&] { return ( ! complete && rnd.nextUint( 8 ) == 0 ) ? -1 - (int)rnd.nextUint( 10 ) : 1 + (int)rnd.nextUint( numVertices ); };
+		// incomplete faces occasionally change form between vertices, but never back from "v", whose parsing would run into the following vertex's slashes
+		const uint32_t vertexForm = ( ! complete && form != 0 && rnd.nextUint( 20 ) == 0 ) ? rnd.nextUint( 4 ) : form;
+		if( vertexForm == 0 )
+			form = 0;
+		result += " " + to_string( index() );
+		if( vertexForm == 1 )
+			result += "/" + to_string( index() );
+		else if( vertexForm == 2 )
+			result += "//" + to_string( index() );
+		else if( vertexForm == 3 )
+			result += "/" + to_string( index() ) + "/" + to_string( index() );
+	}
+	return result;
+}
+
+// Several MB of OBJ records, so that they are parsed in more than one chunk
+string makeObj( uint32_t seed, bool complete )
+{
+	Rand rnd( seed );
+	const uint32_t numVertices = 20000;
+	string result = "# generated\n";
+	for( uint32_t i = 0; i < numVertices; ++i ) {
+		appendLine( &result, "v " + randomFloat( rnd ) + " " + randomFloat( rnd ) + " " + randomFloat( rnd ), rnd );
+		appendLine( &result, "vt " + randomFloat( rnd ) + " " + randomFloat( rnd ), rnd );
+		appendLine( &result, "vn " + randomFloat( rnd ) + " " + randomFloat( rnd ) + " " + randomFloat( rnd ), rnd );
+	}
+	for( uint32_t i = 0; i < 60000; ++i ) {
+		const uint32_t kind = rnd.nextUint( 400 );
+		if( kind == 0 )
+			appendLine( &result, "g group" + to_string( i ), rnd );
+		else if( kind == 1 )
+			appendLine( &result, complete ? "# comment \\" : "usemtl red", rnd );
+		else if( kind == 2 )
+			appendLine( &result, complete ? "" : "usemtl missing", rnd );
+		else if( kind == 3 && ! complete )
+			appendLine( &result, "  v " + randomFloat( rnd ) + " 1 2", rnd );
+		else
+			appendLine( &result, randomFace( rnd, numVertices, complete ), rnd );
+	}
+	return result;
+}
+
+template<typename T>
+bool equalArrays( const T *a, const vector<T> &b )
+{
+	return std::equal( b.begin(), b.end(), a );
+}
+
+} // anonymous namespace
 
 TEST_CASE( "ObjLoader" )
 {
@@ -94,4 +338,83 @@ SECTION( "ObjLoader successfully parses faces with line continuations." )
 	REQUIRE( matchesExpectedPositions( mesh->getPositions<3>() ) );
 }
 
+SECTION( "ObjLoader parses large files in chunks into the same records as the stringstream parser" )
+{
+	const string obj = makeObj( 1, false );
+	const string mtl = "newmtl red\nKd 1 0 0\nnewmtl blue\nKd 0 0 1\n";
+	map<string, ObjLoader::Material> materials;
+	materials["red"].mName = "red";
+	materials["blue"].mName = "blue";
+
+	for( bool includeNormals : { false, true } ) {
+		for( bool includeTexCoords : { false, true } ) {
+			INFO( ( includeNormals ? "normals " : "" ) << ( includeTexCoords ? "tex coords" : "" ) );
+			const LegacyObj expected = legacyParse( obj, materials, includeNormals, includeTexCoords );
+			REQUIRE( expected.mGroups.size() > 100 );
+			ObjLoader loader( DataSourceBuffer::create( Buffer::create( (void*)obj.data(), obj.size() ) ), DataSourceBuffer::create( Buffer::create( (void*)mtl.data(), mtl.size() ) ), includeNormals, includeTexCoords );
+			requireSameGroups( loader.getGroups(), expected.mGroups );
+		}
+	}
+}
+
+SECTION( "ObjLoader output matches the records of the stringstream parser" )
+{
+	const string obj = makeObj( 2, true );
+	const fs::path path = fs::temp_directory_path() / "cinder_obj_loader_test.obj";
+	{
+		FILE *file = fopen( path.string().c_str(), "wb" );
+		fwrite( obj.data(), 1, obj.size(), file );
+		fclose( file );
+	}
+
+	const LegacyObj legacy = legacyParse( obj, {}, true, true );
+	for( bool includeNormals : { false, true } ) {
+		for( bool includeTexCoords : { false, true } ) {
+			INFO( ( includeNormals ? "normals " : "" ) << ( includeTexCoords ? "tex coords" : "" ) );
+
+			// the first appearance of each combination of indices becomes the next output vertex
+			map<tuple<int32_t,int32_t,int32_t>, uint32_t> uniqueVerts;
+			vector<vec3> positions, normals;
+			vector<vec2> texCoords;
+			vector<uint32_t> indices;
+			for( const auto &group : legacy.mGroups ) {
+				for( const auto &face : group.mFaces ) {
+					vector<uint32_t> faceIndices;
+					for( int v = 0; v < face.mNumVertices; ++v ) {
+						auto key = make_tuple( face.mVertexIndices[v], includeTexCoords ? face.mTexCoordIndices[v] : 0, includeNormals ? face.mNormalIndices[v] : 0 );
+						auto result = uniqueVerts.insert( make_pair( key, (uint32_t)positions.size() ) );
+						if( result.second ) {
+							positions.push_back( legacy.mVertices[face.mVertexIndices[v]] );
+							if( includeNormals )
+								normals.push_back( legacy.mNormals[face.mNormalIndices[v]] );
+							if( includeTexCoords )
+								texCoords.push_back( legacy.mTexCoords[face.mTexCoordIndices[v]] );
+						}
+						faceIndices.push_back( result.first->second );
+					}
+					for( size_t t = 0; t + 2 < faceIndices.size(); ++t )
+						indices.insert( indices.end(), { faceIndices[0], faceIndices[t + 1], faceIndices[t + 2] } );
+				}
+			}
+
+			// through the file's memory mapping, and through a buffered stream
+			for( bool mapped : { false, true } ) {
+				INFO( ( mapped ? "mapped" : "streamed" ) );
+				ObjLoader loader = mapped ? ObjLoader( DataSourcePath::create( path ), includeNormals, includeTexCoords ) : ObjLoader( loadFileStream( path ), includeNormals, includeTexCoords );
+				TriMesh mesh( loader );
+				REQUIRE( mesh.getNumVertices() == positions.size() );
+				REQUIRE( mesh.getIndices() == indices );
+				REQUIRE( equalArrays( mesh.getPositions<3>(), positions ) );
+				REQUIRE( mesh.getNormals().size() == normals.size() );
+				REQUIRE( equalArrays( mesh.getNormals().data(), normals ) );
+				REQUIRE( mesh.hasTexCoords0() == includeTexCoords );
+				if( includeTexCoords )
+					REQUIRE( equalArrays( mesh.getTexCoords0<2>(), texCoords ) );
+			}
+		}
+	}
+
+	fs::remove( path );
+}
+
 } // ObjLoader tests
@@ -29,6 +29,23 @@ namespace {
 		}
 		return true;
 	}
+
+	// a random walk of \a numSegments lines, which crosses itself often
+	Path2d makeRandomPolyline( size_t numSegments, uint32_t seed, vec2 pt = vec2( 0 ) ) {
+		Rand rnd( seed );
+		Path2d result;
+		result.moveTo( pt );
+		for( size_t s = 0; s < numSegments; ++s ) {
+			pt += rnd.nextVec2() * rnd.nextFloat( 1, 20 );
+			result.lineTo( pt );
+		}
+		return result;
+	}
+
+	bool segmentsCross( const vec2 &a, const vec2 &b, const vec2 &c, const vec2 &d ) {
+		auto orient = []( const dvec2 &p, const dvec2 &q, const dvec2 &r ) { return ( q.x - p.x ) * ( r.y - p.y ) - ( q.y - p.y ) * ( r.x - p.x ); };
+		return ( orient( a, b, c ) > 0 ) != ( orient( a, b, d ) > 0 ) && ( orient( c, d, a ) > 0 ) != ( orient( c, d, b ) > 0 );
+	}
 }
 
 bool subPathHelper( const Path2d &p, float start, float end )
@@ -740,6 +757,38 @@ TEST_CASE("Path2d::findSelfIntersections")
 		// These curves should cross (probably in multiple places)
 		REQUIRE( results.size() >= 1 );
 	}
+
+	SECTION("Long polylines match a test of every pair of lines, regardless of threads")
+	{
+		const Path2d path = makeRandomPolyline( 2000, 11 );
+		const auto& pts = path.getPoints();
+		vector<pair<size_t, size_t>> expected;
+		for( size_t i = 0; i < path.getNumSegments(); ++i ) {
+			for( size_t j = i + 2; j < path.getNumSegments(); ++j ) {
+				if( segmentsCross( pts[i], pts[i + 1], pts[j], pts[j + 1] ) )
+					expected.emplace_back( i, j );
+			}
+		}
+		REQUIRE( expected.size() > 100 );
+
+		auto results = path.findSelfIntersections( 1e-4f, 1 );
+		vector<pair<size_t, size_t>> found;
+		for( const auto& isect : results ) {
+			REQUIRE( isect.segment1 < isect.segment2 );
+			found.emplace_back( isect.segment1, isect.segment2 );
+		}
+		sort( found.begin(), found.end() );
+		REQUIRE( found == expected );
+
+		auto threadedResults = path.findSelfIntersections( 1e-4f, 4 );
+		REQUIRE( threadedResults.size() == results.size() );
+		for( size_t r = 0; r < results.size(); ++r ) {
+			REQUIRE( threadedResults[r].segment1 == results[r].segment1 );
+			REQUIRE( threadedResults[r].segment2 == results[r].segment2 );
+			REQUIRE( threadedResults[r].t1 == results[r].t1 );
+			REQUIRE( threadedResults[r].point == results[r].point );
+		}
+	}
 }
 
 //=============================================================================
@@ -829,6 +878,31 @@ TEST_CASE("Path2d::findIntersections")
 		REQUIRE( results[0].point.x == Approx( 25.0f ).margin( 0.1f ) );
 	}
 
+	SECTION("Long polylines match a test of every pair of lines, ordered by segment")
+	{
+		const Path2d path1 = makeRandomPolyline( 1500, 12 ), path2 = makeRandomPolyline( 1000, 13, vec2( 3.5f, 1.5f ) );
+		const auto& pts1 = path1.getPoints();
+		const auto& pts2 = path2.getPoints();
+		vector<pair<size_t, size_t>> expected;
+		for( size_t i = 0; i < path1.getNumSegments(); ++i ) {
+			for( size_t j = 0; j < path2.getNumSegments(); ++j ) {
+				if( segmentsCross( pts1[i], pts1[i + 1], pts2[j], pts2[j + 1] ) )
+					expected.emplace_back( i, j );
+			}
+		}
+		REQUIRE( expected.size() > 50 );
+
+		for( int numThreads : { 1, 4 } ) {
+			INFO( numThreads << " threads" );
+			vector<pair<size_t, size_t>> found;
+			for( const auto& ix : path1.findIntersections( path2, 1e-4f, numThreads ) ) {
+				REQUIRE( ix.contour2 == 0 );
+				found.emplace_back( ix.segment1, ix.segment2 );
+			}
+			REQUIRE( found == expected );
+		}
+	}
+
 	SECTION("Empty paths return no intersections")
 	{
 		Path2d path1;
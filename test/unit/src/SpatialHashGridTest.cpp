@@ -0,0 +1,160 @@
+#include "catch.hpp"
+
+#include "cinder/SpatialHashGrid.h"
+#include "cinder/Rand.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+vector<vec3> makePoints( size_t numPoints, uint32_t seed )
+{
+	Rand rnd( seed );
+	vector<vec3> result;
+	for( size_t i = 0; i < numPoints; ++i )
+		result.push_back( vec3( rnd.nextFloat( -3, 3 ), rnd.nextFloat( -3, 3 ), rnd.nextFloat( -1, 1 ) ) );
+	return result;
+}
+
+template<typename VecT>
+vector<uint32_t> bruteInRadius( const vector<VecT> &points, const VecT &p, float radius )
+{
+	vector<uint32_t> result;
+	for( uint32_t i = 0; i < points.size(); ++i ) {
+		const VecT delta = points[i] - p;
+		if( glm::dot( delta, delta ) < radius * radius )
+			result.push_back( i );
+	}
+	return result;
+}
+
+template<typename Grid>
+vector<uint32_t> sortedInRadius( const Grid &grid, const typename Grid::VecT &p, float radius )
+{
+	vector<uint32_t> result;
+	grid.findInRadius( p, radius, &result );
+	sort( result.begin(), result.end() );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "SpatialHashGrid" )
+{
+	const vector<vec3> points = makePoints( 4000, 1 );
+	const vector<vec3> queries = makePoints( 100, 2 );
+
+	SECTION( "Radius and box queries match brute force" )
+	{
+		// few buckets force collisions between neighboring cells, and large radii visit more cells than there are buckets
+		for( uint32_t numBuckets : { 0u, 16u } ) {
+			for( float cellSize : { 0.1f, 0.5f } ) {
+				INFO( numBuckets << " buckets, cell size " << cellSize );
+				SpatialHashGrid<> grid( cellSize, numBuckets );
+				grid.build( points );
+				REQUIRE( grid.size() == points.size() );
+				for( const vec3 &q : queries ) {
+					for( float radius : { 0.0f, 0.1f, 0.35f, 4.0f } ) {
+						const vector<uint32_t> expected = bruteInRadius( points, q, radius );
+						REQUIRE( sortedInRadius( grid, q, radius ) == expected );
+
+						uint32_t buffer[4];
+						float distances[4];
+						REQUIRE( grid.findInRadius( q, radius, buffer, 4, distances ) == expected.size() );
+						for( size_t i = 0; i < min<size_t>( 4, expected.size() ); ++i ) {
+							REQUIRE( binary_search( expected.begin(), expected.end(), buffer[i] ) );
+							REQUIRE( distances[i] == glm::dot( points[buffer[i]] - q, points[buffer[i]] - q ) );
+						}
+					}
+
+					const AxisAlignedBox box( q - vec3( 0.3f, 0.2f, 0.5f ), q + vec3( 0.1f, 0.4f, 0.5f ) );
+					vector<uint32_t> inBox, expected;
+					grid.forEachInBox( box, [&]( uint32_t index, const vec3 &position ) {
+						REQUIRE( position == points[index] );
+						inBox.push_back( index );
+					} );
+					for( uint32_t i = 0; i < points.size(); ++i ) {
+						if( glm::all( glm::greaterThanEqual( points[i], box.getMin() ) ) && glm::all( glm::lessThanEqual( points[i], box.getMax() ) ) )
+							expected.push_back( i );
+					}
+					sort( inBox.begin(), inBox.end() );
+					REQUIRE( inBox == expected );
+				}
+			}
+		}
+	}
+
+	SECTION( "Updates track moving points and rebuild when too many move" )
+	{
+		SpatialHashGrid<> grid( 0.25f );
+		vector<vec3> moving = points;
+		grid.build( moving );
+		Rand rnd( 3 );
+		for( int frame = 0; frame < 10; ++frame ) {
+			// a few points jump, and the rest drift by less than a cell
+			for( size_t i = 0; i < moving.size(); ++i )
+				moving[i] += ( i % 50 == 0 ) ? rnd.randVec3() : rnd.randVec3() * 0.01f;
+			REQUIRE( grid.update( moving ) );
+			REQUIRE( grid.getNumMoved() > 0 );
+			REQUIRE( grid.getNumMoved() < moving.size() / 4 );
+			for( const vec3 &q : queries )
+				REQUIRE( sortedInRadius( grid, q, 0.3f ) == bruteInRadius( moving, q, 0.3f ) );
+		}
+
+		// points returning to their bucket stop counting as moved
+		grid.update( points );
+		REQUIRE( grid.getNumMoved() == 0 );
+
+		const vector<vec3> scattered = makePoints( points.size(), 4 );
+		REQUIRE( ! grid.update( scattered ) );
+		REQUIRE( grid.getNumMoved() == 0 );
+		for( const vec3 &q : queries )
+			REQUIRE( sortedInRadius( grid, q, 0.3f ) == bruteInRadius( scattered, q, 0.3f ) );
+
+		REQUIRE( ! grid.update( queries ) );
+		REQUIRE( grid.size() == queries.size() );
+	}
+
+	SECTION( "Builds and batched queries don't depend on the number of threads" )
+	{
+		// enough points for the build to split them into several chunks
+		const vector<vec3> manyPoints = makePoints( 20000, 3 );
+		const size_t maxResults = 8;
+		vector<uint32_t> indices[2], counts[2];
+		for( int t = 0; t < 2; ++t ) {
+			SpatialHashGrid<> grid( 0.2f );
+			grid.build( manyPoints, t == 0 ? 1 : 4 );
+			indices[t].resize( queries.size() * maxResults );
+			counts[t].resize( queries.size() );
+			grid.findInRadius( queries.data(), queries.size(), 0.3f, maxResults, indices[t].data(), counts[t].data(), nullptr, t == 0 ? 1 : 3 );
+		}
+		REQUIRE( indices[0] == indices[1] );
+		REQUIRE( counts[0] == counts[1] );
+		for( size_t i = 0; i < queries.size(); ++i )
+			REQUIRE( counts[0][i] == bruteInRadius( manyPoints, queries[i], 0.3f ).size() );
+	}
+
+	SECTION( "2D and empty grids" )
+	{
+		Rand rnd( 5 );
+		vector<vec2> points2d;
+		for( int i = 0; i < 2000; ++i )
+			points2d.push_back( rnd.randVec2() * rnd.nextFloat( 5 ) );
+		SpatialHashGrid<float, 2> grid( 0.3f );
+		grid.build( points2d );
+		for( int i = 0; i < 50; ++i ) {
+			const vec2 q = rnd.randVec2() * rnd.nextFloat( 5 );
+			REQUIRE( sortedInRadius( grid, q, 0.4f ) == bruteInRadius( points2d, q, 0.4f ) );
+		}
+
+		SpatialHashGrid<> empty;
+		REQUIRE( empty.empty() );
+		uint32_t index;
+		REQUIRE( empty.findInRadius( vec3( 0 ), 1, &index, 1 ) == 0 );
+		empty.build( vector<vec3>() );
+		REQUIRE( empty.findInRadius( vec3( 0 ), 1, &index, 1 ) == 0 );
+	}
+}
@@ -0,0 +1,147 @@
+#include "catch.hpp"
+
+#include "cinder/Stream.h"
+#include "cinder/Rand.h"
+
+#include <fstream>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// random lines of up to \a maxLength characters, terminated by a mix of "\n", "\r\n" and "\r"
+string makeText( size_t numLines, uint32_t maxLength, bool terminateLast, uint32_t seed )
+{
+	const char *terminators[] = { "\n", "\r\n", "\r" };
+	Rand rnd( seed );
+	string result;
+	for( size_t i = 0; i < numLines; ++i ) {
+		const uint32_t length = rnd.nextUint( maxLength + 1 );
+		for( uint32_t c = 0; c < length; ++c )
+			result += char( 'a' + rnd.nextUint( 26 ) );
+		if( i + 1 < numLines || terminateLast )
+			result += terminators[rnd.nextUint( 3 )];
+	}
+
+	return result;
+}
+
+// splits \a text a character at a time, as IStreamCinder::readLine() always has
+vector<string> splitLines( const string &text )
+{
+	vector<string> result;
+	size_t i = 0;
+	while( i < text.size() ) {
+		string line;
+		while( i < text.size() && text[i] != '\n' && text[i] != '\r' )
+			line += text[i++];
+		if( i < text.size() ) {
+			if( text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n' )
+				++i;
+			++i;
+		}
+		result.push_back( line );
+	}
+
+	return result;
+}
+
+vector<string> readLines( const IStreamRef &stream )
+{
+	vector<string> result;
+	while( ! stream->isEof() )
+		result.push_back( stream->readLine() );
+	return result;
+}
+
+vector<string> readLinesWithReader( const IStreamRef &stream )
+{
+	vector<string> result;
+	for( string_view line : LineReader( stream ) )
+		result.push_back( string( line ) );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Stream" )
+{
+	const fs::path path = fs::temp_directory_path() / "cinder_stream_test.txt";
+
+	SECTION( "readLine() and LineReader split mixed line endings like the character at a time reader" )
+	{
+		for( uint32_t maxLength : { 0u, 5u, 40u, 300u } ) {
+			for( bool terminateLast : { false, true } ) {
+				const string text = makeText( 500, maxLength, terminateLast, maxLength * 2 + terminateLast );
+				const vector<string> expected = splitLines( text );
+				{
+					ofstream out( path.string(), ios::binary );
+					out << text;
+				}
+
+				INFO( "max line length " << maxLength << ( terminateLast ? ", terminated" : ", unterminated" ) );
+				REQUIRE( readLines( IStreamMem::create( text.data(), text.size() ) ) == expected );
+				REQUIRE( readLinesWithReader( IStreamMem::create( text.data(), text.size() ) ) == expected );
+
+				// small buffers make lines and "\r\n" pairs span refills
+				for( int32_t bufferSize : { 1, 7, 64, 2048 } ) {
+					INFO( "buffer size " << bufferSize );
+					REQUIRE( readLines( IStreamFile::create( fopen( path.string().c_str(), "rb" ), true, bufferSize ) ) == expected );
+					REQUIRE( readLinesWithReader( IStreamFile::create( fopen( path.string().c_str(), "rb" ), true, bufferSize ) ) == expected );
+				}
+
+				// IoStreamFile doesn't expose its buffer, and is read a line at a time through readLine()
+				REQUIRE( readLinesWithReader( IoStreamFile::create( fopen( path.string().c_str(), "rb" ) ) ) == expected );
+			}
+		}
+
+		fs::remove( path );
+	}
+
+	SECTION( "LineReader returns views into memory streams and leaves the stream after the last line" )
+	{
+		const string text = "first\r\nsecond\rthird\n\nlast";
+		IStreamMemRef stream = IStreamMem::create( text.data(), text.size() );
+		LineReader reader( stream );
+
+		string_view line;
+		REQUIRE( reader.readLine( &line ) );
+		REQUIRE( line == "first" );
+		REQUIRE( line.data() == text.data() );
+		REQUIRE( stream->tell() == 7 );
+		REQUIRE( reader.readLine( &line ) );
+		REQUIRE( line == "second" );
+		REQUIRE( line.data() == text.data() + 7 );
+
+		// the stream can be mixed with other reads
+		REQUIRE( stream->readLine() == "third" );
+		REQUIRE( reader.readLine( &line ) );
+		REQUIRE( line.empty() );
+		REQUIRE( reader.readLine( &line ) );
+		REQUIRE( line == "last" );
+		REQUIRE( line.data() == text.data() + text.size() - 4 );
+		REQUIRE( ! reader.readLine( &line ) );
+		REQUIRE( stream->isEof() );
+	}
+
+	SECTION( "File streams see lines appended after reaching the end" )
+	{
+		{
+			ofstream out( path.string(), ios::binary );
+			out << "first\n";
+		}
+		IStreamFileRef stream = IStreamFile::create( fopen( path.string().c_str(), "rb" ), true );
+		REQUIRE( stream->readLine() == "first" );
+		REQUIRE( stream->isEof() );
+		{
+			ofstream out( path.string(), ios::binary | ios::app );
+			out << "second\n";
+		}
+		REQUIRE( ! stream->isEof() );
+		REQUIRE( stream->readLine() == "second" );
+		REQUIRE( stream->isEof() );
+		stream.reset();
+		fs::remove( path );
+	}
+}
@@ -0,0 +1,177 @@
+#include "catch.hpp"
+
+#include "cinder/Buffer.h"
+
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// the byte at position \a index of the test stream
+uint8_t streamByte( size_t index )
+{
+	return uint8_t( index * 7 + ( index >> 8 ) );
+}
+
+// a cheap deterministic sequence of chunk sizes
+size_t nextChunkSize( uint32_t *state, size_t maxSize )
+{
+	*state = *state * 1664525u + 1013904223u;
+	return 1 + ( *state >> 8 ) % maxSize;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "StreamingBuffer" )
+{
+	SECTION( "reserve() and commit() write in place, peek() and consume() read in place" )
+	{
+		StreamingBuffer sb( 8 );
+		size_t reserved;
+		uint8_t *data = sb.reserve( 100, &reserved );
+		REQUIRE( reserved == 8 );
+		for( size_t i = 0; i < 5; ++i )
+			data[i] = streamByte( i );
+		REQUIRE( sb.empty() );
+		sb.commit( 5 );
+		REQUIRE( sb.getSize() == 5 );
+
+		// what's left of the block, then a new one
+		uint8_t *rest = sb.reserve( 100, &reserved );
+		REQUIRE( rest == data + 5 );
+		REQUIRE( reserved == 3 );
+		rest[0] = streamByte( 5 );
+		sb.commit( 1 );
+		const vector<uint8_t> tail = { streamByte( 6 ), streamByte( 7 ), streamByte( 8 ), streamByte( 9 ), streamByte( 10 ) };
+		sb.pushFront( tail.data(), tail.size() );
+		REQUIRE( sb.getSize() == 11 );
+
+		StreamingBuffer::Region regions[4];
+		REQUIRE( sb.peek( regions, 4 ) == 2 );
+		REQUIRE( regions[0].mData == data );
+		REQUIRE( regions[0].mSize == 8 );
+		REQUIRE( regions[1].mSize == 3 );
+		size_t index = 0;
+		for( size_t r = 0; r < 2; ++r )
+			for( size_t i = 0; i < regions[r].mSize; ++i )
+				REQUIRE( regions[r].mData[i] == streamByte( index++ ) );
+
+		// limits on the number of regions and bytes
+		REQUIRE( sb.peek( regions, 1 ) == 1 );
+		REQUIRE( regions[0].mSize == 8 );
+		REQUIRE( sb.peek( regions, 4, 3 ) == 1 );
+		REQUIRE( regions[0].mSize == 3 );
+		REQUIRE( sb.peek( regions, 4, 0 ) == 0 );
+		REQUIRE( sb.getSize() == 11 );
+
+		sb.consume( 9 );
+		REQUIRE( sb.getSize() == 2 );
+		REQUIRE( sb.peek( regions, 4 ) == 1 );
+		REQUIRE( regions[0].mSize == 2 );
+		REQUIRE( regions[0].mData[0] == streamByte( 9 ) );
+
+		// consuming more than is there stops at the end
+		sb.consume( 100 );
+		REQUIRE( sb.empty() );
+		REQUIRE( sb.peek( regions, 4 ) == 0 );
+	}
+
+	SECTION( "A steady stream reuses the same blocks" )
+	{
+		StreamingBuffer sb( 16 );
+		set<const uint8_t*> blocks;
+		vector<uint8_t> chunk( 40 ), output( 40 );
+		for( int i = 0; i < 1000; ++i ) {
+			size_t reserved;
+			blocks.insert( sb.reserve( 16, &reserved ) - ( i * 40 ) % 16 );
+			sb.pushFront( chunk.data(), chunk.size() );
+			REQUIRE( sb.popBack( output.data(), output.size() ) == 40 );
+		}
+		// the blocks holding a chunk, plus the one the consumer is still on
+		REQUIRE( blocks.size() <= 5 );
+
+		sb.pushFront( chunk.data(), chunk.size() );
+		sb.shrinkToFit();
+		REQUIRE( sb.popBack( output.data(), output.size() ) == 40 );
+		REQUIRE( sb.empty() );
+	}
+
+	SECTION( "Bytes arrive intact and in order across threads" )
+	{
+		for( size_t blockSize : { (size_t)1, (size_t)61, (size_t)4096 } ) {
+			INFO( "block size " << blockSize );
+			StreamingBuffer sb( blockSize );
+			const size_t total = 4 * 1024 * 1024;
+			atomic<size_t> numMismatched( 0 ), numReceived( 0 );
+
+			// the consumer alternates between copying out and parsing in place
+			thread consumer( [&] {
+				vector<uint8_t> output( 10000 );
+				StreamingBuffer::Region regions[8];
+				uint32_t state = 2;
+				size_t index = 0, mismatched = 0;
+				while( index < total ) {
+					const size_t maxSize = nextChunkSize( &state, output.size() );
+					if( state & 0x10000 ) {
+						const size_t count = sb.popBack( output.data(), maxSize );
+						for( size_t i = 0; i < count; ++i )
+							mismatched += output[i] != streamByte( index++ );
+					}
+					else {
+						const size_t numRegions = sb.peek( regions, 8, maxSize );
+						size_t count = 0;
+						for( size_t r = 0; r < numRegions; ++r ) {
+							for( size_t i = 0; i < regions[r].mSize; ++i )
+								mismatched += regions[r].mData[i] != streamByte( index++ );
+							count += regions[r].mSize;
+						}
+						sb.consume( count );
+					}
+					if( sb.empty() )
+						this_thread::yield();
+				}
+				numMismatched = mismatched;
+				numReceived = index;
+			} );
+
+			// the producer alternates between copying in and writing in place, occasionally releasing spare blocks
+			vector<uint8_t> input( 10000 );
+			uint32_t state = 1;
+			size_t index = 0;
+			while( index < total ) {
+				const size_t size = min( nextChunkSize( &state, input.size() ), total - index );
+				if( state & 0x10000 ) {
+					for( size_t i = 0; i < size; ++i )
+						input[i] = streamByte( index + i );
+					sb.pushFront( input.data(), size );
+				}
+				else {
+					for( size_t written = 0; written < size; ) {
+						size_t reserved;
+						uint8_t *data = sb.reserve( size - written, &reserved );
+						for( size_t i = 0; i < reserved; ++i )
+							data[i] = streamByte( index + written + i );
+						sb.commit( reserved );
+						written += reserved;
+					}
+				}
+				index += size;
+				if( ( state & 0x700000 ) == 0 )
+					sb.shrinkToFit();
+				while( sb.getSize() > 256 * 1024 )
+					this_thread::yield();
+			}
+			consumer.join();
+
+			REQUIRE( numReceived == total );
+			REQUIRE( numMismatched == 0 );
+			REQUIRE( sb.empty() );
+		}
+	}
+}
@@ -22,6 +22,7 @@ TEST_CASE("System", "[noisy]")
 	console() << " has SSE3:" << System::hasSse3() << std::endl;
 	console() << " has SSE4.1:" << System::hasSse4_1() << std::endl;
 	console() << " has SSE4.2:" << System::hasSse4_2() << std::endl;
+	console() << " has AVX2:" << System::hasAvx2() << std::endl;
 	console() << " has 64 bit:" << System::hasX86_64() << std::endl;
 	console() << " CPUs:" << System::getNumCpus() << std::endl;
 	console() << " Cores:" << System::getNumCores() << std::endl;
@@ -0,0 +1,200 @@
+#include "catch.hpp"
+
+#include "cinder/Thread.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// sums [begin, end) by splitting it recursively, with a TaskGroup per level
+int64_t forkJoinSum( int64_t begin, int64_t end, TaskScheduler *scheduler )
+{
+	if( end - begin <= 16 ) {
+		int64_t result = 0;
+		for( int64_t i = begin; i < end; ++i )
+			result += i;
+		return result;
+	}
+
+	const int64_t mid = ( begin + end ) / 2;
+	int64_t left = 0, right = 0;
+	TaskGroup group( scheduler );
+	group.run( [&] { left = forkJoinSum( begin, mid, scheduler ); } );
+	group.run( [&] { right = forkJoinSum( mid, end, scheduler ); } );
+	group.wait();
+	return left + right;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TaskScheduler" )
+{
+	TaskScheduler scheduler( TaskScheduler::Options().numThreads( 3 ) );
+	REQUIRE( scheduler.getNumThreads() == 3 );
+	REQUIRE( scheduler.getCurrentThreadIndex() == -1 );
+
+	SECTION( "parallelFor covers every index exactly once, including when nested" )
+	{
+		for( int64_t grainSize : { 0, 1, 7, 1000, 5000 } ) {
+			for( int maxThreads : { 0, 1, 2 } ) {
+				INFO( "grain size " << grainSize << ", max threads " << maxThreads );
+				vector<atomic<int>> visits( 1001 );
+				atomic<int> numEmptyChunks( 0 );
+				// Catch's assertions are only used on the main thread
+				scheduler.parallelFor( 0, (int64_t)visits.size(), [&]( int64_t begin, int64_t end ) {
+					if( begin >= end )
+						++numEmptyChunks;
+					for( int64_t i = begin; i < end; ++i )
+						++visits[i];
+				}, grainSize, maxThreads );
+				REQUIRE( numEmptyChunks == 0 );
+				for( auto &v : visits )
+					REQUIRE( v == 1 );
+			}
+		}
+
+		vector<atomic<int>> visits( 64 * 64 );
+		scheduler.parallelFor( 0, 64, [&]( int64_t rowBegin, int64_t rowEnd ) {
+			for( int64_t row = rowBegin; row < rowEnd; ++row ) {
+				scheduler.parallelFor( 0, 64, [&]( int64_t begin, int64_t end ) {
+					for( int64_t i = begin; i < end; ++i )
+						++visits[row * 64 + i];
+				}, 4 );
+			}
+		}, 1 );
+		for( auto &v : visits )
+			REQUIRE( v == 1 );
+
+		int calls = 0;
+		scheduler.parallelFor( 5, 5, [&]( int64_t, int64_t ) { ++calls; } );
+		REQUIRE( calls == 0 );
+	}
+
+	SECTION( "TaskGroups wait on tasks spawned by their own tasks" )
+	{
+		REQUIRE( forkJoinSum( 0, 100000, &scheduler ) == 100000ll * 99999 / 2 );
+
+		atomic<int> numRun( 0 );
+		vector<int> threadIndices( 100, -2 );
+		TaskGroup group( &scheduler );
+		for( int i = 0; i < 100; ++i ) {
+			group.run( [&, i] {
+				threadIndices[i] = scheduler.getCurrentThreadIndex();
+				group.run( [&] { ++numRun; } );
+			} );
+		}
+		group.wait();
+		REQUIRE( group.isDone() );
+		REQUIRE( numRun == 100 );
+		// tasks also run on the waiting thread, which isn't one of the workers
+		for( int index : threadIndices )
+			REQUIRE( ( index >= -1 && index < 3 ) );
+	}
+
+	SECTION( "Exceptions reach wait() and parallelFor() callers" )
+	{
+		TaskGroup group( &scheduler );
+		for( int i = 0; i < 20; ++i ) {
+			group.run( [i] {
+				if( i % 5 == 0 )
+					throw runtime_error( "task failure" );
+			} );
+		}
+		REQUIRE_THROWS_AS( group.wait(), runtime_error );
+		// retrieved exceptions are cleared
+		group.run( [] {} );
+		REQUIRE_NOTHROW( group.wait() );
+
+		atomic<int> numChunks( 0 );
+		REQUIRE_THROWS_AS( scheduler.parallelFor( 0, 1000, [&]( int64_t begin, int64_t ) {
+			++numChunks;
+			if( begin == 0 )
+				throw runtime_error( "chunk failure" );
+		}, 1 ), runtime_error );
+		REQUIRE( numChunks < 1000 );
+	}
+
+	SECTION( "Continuations run once the group's tasks have completed" )
+	{
+		atomic<int> numRun( 0 );
+		atomic<int> seenByContinuation( -1 );
+		atomic<bool> continued( false );
+		TaskGroup group( &scheduler );
+		for( int i = 0; i < 50; ++i )
+			group.run( [&] { ++numRun; } );
+		group.then( [&] {
+			seenByContinuation = numRun.load();
+			continued = true;
+		} );
+		group.wait();
+		while( ! continued )
+			this_thread::yield();
+		REQUIRE( seenByContinuation == 50 );
+
+		// a group without tasks continues right away
+		TaskGroup emptyGroup( &scheduler );
+		atomic<bool> emptyContinued( false );
+		emptyGroup.then( [&] { emptyContinued = true; } );
+		while( ! emptyContinued )
+			this_thread::yield();
+	}
+
+	SECTION( "High priority tasks start ahead of queued normal ones" )
+	{
+		TaskScheduler single( TaskScheduler::Options().numThreads( 1 ).pinThreads() );
+		mutex orderMutex;
+		vector<int> order;
+		atomic<bool> blocking( false ), release( false );
+
+		TaskGroup group( &single );
+		// occupies the only worker until everything else is queued
+		group.run( [&] {
+			blocking = true;
+			while( ! release )
+				this_thread::yield();
+		} );
+		while( ! blocking )
+			this_thread::yield();
+		for( int i = 0; i < 5; ++i ) {
+			group.run( [&, i] {
+				lock_guard<mutex> lock( orderMutex );
+				order.push_back( i );
+			} );
+		}
+		group.run( [&] {
+			lock_guard<mutex> lock( orderMutex );
+			order.push_back( -1 );
+		}, TaskPriority::HIGH );
+		release = true;
+		// a worker that isn't waiting keeps the caller from helping, which would change the order
+		while( ! group.isDone() )
+			this_thread::yield();
+		group.wait();
+
+		REQUIRE( order.size() == 6 );
+		REQUIRE( order[0] == -1 );
+		for( int i = 0; i < 5; ++i )
+			REQUIRE( order[i + 1] == i );
+	}
+
+	SECTION( "Destroying a scheduler runs the tasks it still has queued" )
+	{
+		atomic<int> numRun( 0 );
+		{
+			TaskScheduler temporary( TaskScheduler::Options().numThreads( 2 ) );
+			for( int i = 0; i < 1000; ++i ) {
+				temporary.spawn( [&] {
+					++numRun;
+				} );
+			}
+			// logged rather than thrown
+			temporary.spawn( [] { throw runtime_error( "spawned failure" ); } );
+		}
+		REQUIRE( numRun == 1000 );
+	}
+}
@@ -0,0 +1,316 @@
+#include "catch.hpp"
+
+#include "cinder/TriMeshBvh.h"
+#include "cinder/GeomIo.h"
+#include "cinder/Rand.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// random triangles of up to \a size in the unit cube, a few of them degenerate
+TriMesh makeSoup( size_t numTriangles, float size, uint32_t seed )
+{
+	Rand rnd( seed );
+	TriMesh result( TriMesh::Format().positions() );
+	for( size_t t = 0; t < numTriangles; ++t ) {
+		const vec3 center( rnd.nextFloat( -1, 1 ), rnd.nextFloat( -1, 1 ), rnd.nextFloat( -1, 1 ) );
+		const vec3 a = center + rnd.nextVec3() * rnd.nextFloat( size );
+		const vec3 b = ( t % 50 == 0 ) ? a : center + rnd.nextVec3() * rnd.nextFloat( size );
+		result.appendPosition( a );
+		result.appendPosition( b );
+		result.appendPosition( center + rnd.nextVec3() * rnd.nextFloat( size ) );
+		result.appendTriangle( uint32_t( t * 3 ), uint32_t( t * 3 + 1 ), uint32_t( t * 3 + 2 ) );
+	}
+
+	return result;
+}
+
+void getTriangle( const TriMesh &mesh, size_t t, vec3 v[3] )
+{
+	mesh.getTriangleVertices( t, &v[0], &v[1], &v[2] );
+}
+
+// the closest intersection by testing every triangle, or a negative distance
+float intersectEvery( const TriMesh &mesh, const Ray &ray )
+{
+	float result = -1;
+	for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+		vec3 v[3];
+		getTriangle( mesh, t, v );
+		float distance;
+		if( ray.calcTriangleIntersection( v[0], v[1], v[2], &distance ) && distance >= 0 && ( result < 0 || distance < result ) )
+			result = distance;
+	}
+
+	return result;
+}
+
+vec3 closestPointOnSegment( const vec3 &p, const vec3 &a, const vec3 &b )
+{
+	const float length2 = glm::length2( b - a );
+	return length2 > 0 ? a + ( b - a ) * glm::clamp( dot( p - a, b - a ) / length2, 0.0f, 1.0f ) : a;
+}
+
+// the distance from \a p to a triangle, as the closest of its projection onto the plane and its edges
+float distanceToTriangle( const vec3 &p, const vec3 v[3] )
+{
+	float result = std::numeric_limits<float>::max();
+	const vec3 normal = cross( v[1] - v[0], v[2] - v[0] );
+	if( glm::length2( normal ) > 0 ) {
+		const vec3 projected = p - normal * dot( p - v[0], normal ) / glm::length2( normal );
+		bool inside = true;
+		for( int e = 0; e < 3; ++e )
+			inside = inside && dot( cross( v[( e + 1 ) % 3] - v[e], projected - v[e] ), normal ) >= 0;
+		if( inside )
+			result = distance( p, projected );
+	}
+	for( int e = 0; e < 3; ++e )
+		result = std::min( result, distance( p, closestPointOnSegment( p, v[e], v[( e + 1 ) % 3] ) ) );
+
+	return result;
+}
+
+// checks that every triangle is in exactly one leaf of at most \a maxLeafTriangles, within the leaf's bounds, and that every child lies within its parent
+void checkHierarchy( const TriMeshBvh &bvh, const TriMesh &mesh, uint32_t maxLeafTriangles )
+{
+	const auto &nodes = bvh.getNodes();
+	vector<int> seen( bvh.getNumTriangles(), 0 );
+	for( const TriMeshBvh::Node &node : nodes ) {
+		for( int c = 0; c < 4; ++c ) {
+			const vec3 min( node.min[0][c], node.min[1][c], node.min[2][c] ), max( node.max[0][c], node.max[1][c], node.max[2][c] );
+			if( node.numTriangles[c] ) {
+				REQUIRE( node.numTriangles[c] <= maxLeafTriangles );
+				for( uint32_t t = node.children[c]; t < node.children[c] + node.numTriangles[c]; ++t ) {
+					++seen[t];
+					vec3 v[3];
+					getTriangle( mesh, bvh.getTriangleIds()[t], v );
+					for( const vec3 &p : v )
+						REQUIRE( glm::all( glm::greaterThanEqual( p, min ) && glm::lessThanEqual( p, max ) ) );
+				}
+			}
+			else if( node.children[c] ) {
+				REQUIRE( node.children[c] > size_t( &node - nodes.data() ) );
+				const TriMeshBvh::Node &child = nodes[node.children[c]];
+				for( int k = 0; k < 4; ++k ) {
+					if( child.numTriangles[k] || child.children[k] ) {
+						for( int a = 0; a < 3; ++a )
+							REQUIRE( ( child.min[a][k] >= min[a] && child.max[a][k] <= max[a] ) );
+					}
+				}
+			}
+		}
+	}
+	REQUIRE( std::all_of( seen.begin(), seen.end(), []( int count ) { return count == 1; } ) );
+	vector<uint32_t> ids = bvh.getTriangleIds();
+	sort( ids.begin(), ids.end() );
+	for( size_t t = 0; t < ids.size(); ++t )
+		REQUIRE( ids[t] == t );
+}
+
+void checkRays( const TriMeshBvh &bvh, const TriMesh &mesh, int numRays, uint32_t seed )
+{
+	Rand rnd( seed );
+	for( int i = 0; i < numRays; ++i ) {
+		const Ray ray( vec3( rnd.nextFloat( -2, 2 ), rnd.nextFloat( -2, 2 ), rnd.nextFloat( -2, 2 ) ), rnd.nextVec3() * rnd.nextFloat( 0.5f, 2 ) );
+		const float expected = intersectEvery( mesh, ray );
+		TriMeshBvh::Hit hit;
+		INFO( "ray " << i );
+		REQUIRE( bvh.calcIntersection( ray, &hit ) == ( expected >= 0 ) );
+		REQUIRE( bvh.intersects( ray ) == ( expected >= 0 ) );
+		if( expected < 0 )
+			continue;
+
+		REQUIRE( hit.distance == expected );
+		vec3 v[3];
+		getTriangle( mesh, hit.triangle, v );
+		float distance;
+		REQUIRE( ray.calcTriangleIntersection( v[0], v[1], v[2], &distance ) );
+		REQUIRE( distance == expected );
+		const vec3 interpolated = v[0] + ( v[1] - v[0] ) * hit.barycentric.x + ( v[2] - v[0] ) * hit.barycentric.y;
+		REQUIRE( glm::distance( interpolated, hit.position ) < 1e-4f );
+
+		// limited to before the hit
+		REQUIRE( ! bvh.calcIntersection( ray, &hit, expected * 0.999f ) );
+		REQUIRE( ! bvh.intersects( ray, expected * 0.999f ) );
+		REQUIRE( bvh.intersects( ray, expected * 1.001f ) );
+	}
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TriMeshBvh" )
+{
+	const TriMesh sphere( geom::Sphere().subdivisions( 48 ) );
+	const TriMesh soup = makeSoup( 12000, 0.1f, 7 );
+
+	SECTION( "Ray intersections find the closest triangle that testing every one does" )
+	{
+		for( uint32_t maxLeafTriangles : { 1u, 4u, 16u } ) {
+			INFO( "max leaf triangles " << maxLeafTriangles );
+			const TriMeshBvh sphereBvh( sphere, TriMeshBvh::Options().maxLeafTriangles( maxLeafTriangles ) );
+			checkHierarchy( sphereBvh, sphere, maxLeafTriangles );
+			checkRays( sphereBvh, sphere, 300, 1 );
+
+			const TriMeshBvh soupBvh( soup, TriMeshBvh::Options().maxLeafTriangles( maxLeafTriangles ) );
+			checkHierarchy( soupBvh, soup, maxLeafTriangles );
+			checkRays( soupBvh, soup, 300, 2 );
+		}
+	}
+
+	SECTION( "Overlaps and closest points match testing every triangle" )
+	{
+		const TriMeshBvh bvh( soup );
+		Rand rnd( 3 );
+		vector<uint32_t> found;
+		for( int i = 0; i < 100; ++i ) {
+			const vec3 center( rnd.nextFloat( -1.2f, 1.2f ), rnd.nextFloat( -1.2f, 1.2f ), rnd.nextFloat( -1.2f, 1.2f ) );
+			const float radius = rnd.nextFloat( 0.01f, 0.3f );
+
+			// a triangle with a corner in the box overlaps it, while one whose bounds don't overlap the box doesn't
+			const AxisAlignedBox box( center - vec3( radius, radius * 0.5f, radius * 2 ), center + vec3( radius, radius * 0.5f, radius * 2 ) );
+			bvh.calcOverlaps( box, &found );
+			sort( found.begin(), found.end() );
+			REQUIRE( unique( found.begin(), found.end() ) == found.end() );
+			for( size_t t = 0; t < soup.getNumTriangles(); ++t ) {
+				vec3 v[3];
+				getTriangle( soup, t, v );
+				const bool isFound = binary_search( found.begin(), found.end(), uint32_t( t ) );
+				if( box.contains( v[0] ) || box.contains( v[1] ) || box.contains( v[2] ) )
+					REQUIRE( isFound );
+				if( ! box.intersects( AxisAlignedBox( glm::min( v[0], glm::min( v[1], v[2] ) ), glm::max( v[0], glm::max( v[1], v[2] ) ) ) ) )
+					REQUIRE( ! isFound );
+			}
+
+			bvh.calcOverlaps( Sphere( center, radius ), &found );
+			sort( found.begin(), found.end() );
+			float closest = std::numeric_limits<float>::max();
+			for( size_t t = 0; t < soup.getNumTriangles(); ++t ) {
+				vec3 v[3];
+				getTriangle( soup, t, v );
+				const float distance = distanceToTriangle( center, v );
+				closest = std::min( closest, distance );
+				if( std::abs( distance - radius ) > 1e-4f )
+					REQUIRE( binary_search( found.begin(), found.end(), uint32_t( t ) ) == ( distance < radius ) );
+			}
+
+			TriMeshBvh::Hit hit;
+			REQUIRE( bvh.calcClosestPoint( center, &hit ) );
+			REQUIRE( hit.distance == Approx( closest ).margin( 1e-5 ) );
+			vec3 v[3];
+			getTriangle( soup, hit.triangle, v );
+			REQUIRE( distanceToTriangle( hit.position, v ) < 1e-5f );
+			REQUIRE( bvh.calcClosestPoint( center, &hit, closest * 1.001f ) );
+			REQUIRE( ! bvh.calcClosestPoint( center, &hit, closest * 0.999f ) );
+		}
+	}
+
+	SECTION( "The hierarchy doesn't depend on the number of threads, and refit() follows a deforming mesh" )
+	{
+		const TriMeshBvh serial( soup, TriMeshBvh::Options().numThreads( 1 ) );
+		TriMeshBvh parallel( soup, TriMeshBvh::Options().numThreads( 4 ) );
+		REQUIRE( serial.getNodes().size() == parallel.getNodes().size() );
+		REQUIRE( memcmp( serial.getNodes().data(), parallel.getNodes().data(), serial.getNodes().size() * sizeof( TriMeshBvh::Node ) ) == 0 );
+		REQUIRE( serial.getTriangleIds() == parallel.getTriangleIds() );
+
+		// twist the soup about the y axis
+		TriMesh twisted = soup;
+		for( size_t i = 0; i < twisted.getNumVertices(); ++i ) {
+			vec3 &p = twisted.getPositions<3>()[i];
+			const float angle = p.y * 1.5f;
+			p = vec3( p.x * std::cos( angle ) - p.z * std::sin( angle ), p.y, p.x * std::sin( angle ) + p.z * std::cos( angle ) );
+		}
+		parallel.refit( twisted );
+		checkHierarchy( parallel, twisted, 4 );
+		checkRays( parallel, twisted, 200, 4 );
+		REQUIRE( parallel.getBounds().getMin() == TriMeshBvh( twisted ).getBounds().getMin() );
+		REQUIRE( parallel.getBounds().getMax() == TriMeshBvh( twisted ).getBounds().getMax() );
+
+		TriMesh shrunk = twisted;
+		shrunk.getBufferPositions().resize( 3 * ( shrunk.getNumVertices() - 1 ) );
+		REQUIRE_THROWS_AS( parallel.refit( shrunk ), ci::Exception );
+	}
+
+	SECTION( "Empty and degenerate meshes" )
+	{
+		const Ray ray( vec3( 0, 0, -5 ), vec3( 0, 0, 1 ) );
+		TriMeshBvh::Hit hit;
+		vector<uint32_t> found;
+
+		const TriMeshBvh empty( TriMesh( TriMesh::Format().positions() ) );
+		REQUIRE( empty.getNumTriangles() == 0 );
+		REQUIRE( ! empty.calcIntersection( ray, &hit ) );
+		REQUIRE( ! empty.intersects( ray ) );
+		REQUIRE( ! empty.calcClosestPoint( vec3( 0 ), &hit ) );
+		empty.calcOverlaps( Sphere( vec3( 0 ), 100 ), &found );
+		REQUIRE( found.empty() );
+
+		// one triangle makes a root with a single leaf
+		TriMesh single( TriMesh::Format().positions() );
+		single.appendPosition( vec3( -1, -1, 0 ) );
+		single.appendPosition( vec3( 1, -1, 0 ) );
+		single.appendPosition( vec3( 0, 1, 0 ) );
+		single.appendTriangle( 0, 1, 2 );
+		const TriMeshBvh singleBvh( single );
+		REQUIRE( singleBvh.calcIntersection( ray, &hit ) );
+		REQUIRE( hit.triangle == 0 );
+		REQUIRE( hit.distance == 5 );
+		REQUIRE( hit.position == vec3( 0, 0, 0 ) );
+		REQUIRE( ! singleBvh.intersects( Ray( vec3( 0, 0, 5 ), vec3( 0, 0, 1 ) ) ) );
+		REQUIRE( singleBvh.calcClosestPoint( vec3( 0, 3, 0 ), &hit ) );
+		REQUIRE( hit.position == vec3( 0, 1, 0 ) );
+		REQUIRE( hit.barycentric == vec2( 0, 1 ) );
+
+		// identical triangles can't be split by position, so are halved instead
+		TriMesh stacked( TriMesh::Format().positions() );
+		stacked.appendPositions( single.getPositions<3>(), 3 );
+		for( int t = 0; t < 100; ++t )
+			stacked.appendTriangle( 0, 1, 2 );
+		const TriMeshBvh stackedBvh( stacked );
+		checkHierarchy( stackedBvh, stacked, 4 );
+		stackedBvh.calcOverlaps( AxisAlignedBox( vec3( -0.1f ), vec3( 0.1f ) ), &found );
+		REQUIRE( found.size() == 100 );
+		REQUIRE( stackedBvh.calcIntersection( ray, &hit ) );
+
+		const uint32_t indices[] = { 0, 1, 5 };
+		REQUIRE_THROWS_AS( TriMeshBvh( single.getPositions<3>(), 3, indices, 1 ), ci::Exception );
+	}
+
+	SECTION( "NaN and infinite vertices don't break the build or hide other triangles" )
+	{
+		for( uint32_t maxLeafTriangles : { 1u, 4u } ) {
+			INFO( "max leaf triangles " << maxLeafTriangles );
+			TriMesh broken = makeSoup( 3000, 0.1f, 8 );
+			broken.getPositions<3>()[100].x = std::numeric_limits<float>::quiet_NaN();
+			broken.getPositions<3>()[2000] = vec3( std::numeric_limits<float>::quiet_NaN() );
+			broken.getPositions<3>()[4000].y = std::numeric_limits<float>::infinity();
+			broken.getPositions<3>()[6000].z = -std::numeric_limits<float>::infinity();
+			const TriMeshBvh bvh( broken, TriMeshBvh::Options().maxLeafTriangles( maxLeafTriangles ) );
+			vector<uint32_t> ids = bvh.getTriangleIds();
+			sort( ids.begin(), ids.end() );
+			REQUIRE( ids.size() == broken.getNumTriangles() );
+			for( size_t t = 0; t < ids.size(); ++t )
+				REQUIRE( ids[t] == t );
+			checkRays( bvh, broken, 300, 9 );
+		}
+	}
+
+	SECTION( "Rays with a negative zero direction component still enter boxes" )
+	{
+		const TriMeshBvh bvh( sphere );
+		for( const vec3 &direction : { vec3( -0.0f, -0.0f, 1 ), vec3( 1, -0.0f, 0.0f ), vec3( -0.0f, -1, -0.0f ), vec3( 0.3f, -0.0f, -1 ) } ) {
+			INFO( "direction " << direction );
+			const Ray ray( -direction * 3.0f + vec3( 0.01f, 0.02f, 0.03f ), direction );
+			const float expected = intersectEvery( sphere, ray );
+			REQUIRE( expected >= 0 );
+			TriMeshBvh::Hit hit;
+			REQUIRE( bvh.calcIntersection( ray, &hit ) );
+			REQUIRE( hit.distance == expected );
+			REQUIRE( bvh.intersects( ray ) );
+		}
+	}
+}
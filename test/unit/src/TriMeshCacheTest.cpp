@@ -0,0 +1,218 @@
+#include "catch.hpp"
+
+#include "cinder/TriMeshCache.h"
+#include "cinder/TriMesh.h"
+#include "cinder/Rand.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// a mesh with every kind of attribute TriMesh stores, filled with random data
+TriMesh makeMesh( size_t numVertices, size_t numTriangles, uint32_t seed )
+{
+	TriMesh result( TriMesh::Format().positions( 3 ).normals().tangents().bitangents().boneIndices().boneWeights().colors( 4 ).texCoords0( 2 ).texCoords1( 3 ).texCoords2( 1 ).texCoords3( 4 ) );
+	Rand rnd( seed );
+	auto randomFloats = [&]( vector<float> *v, size_t count ) {
+		for( size_t i = 0; i < count; ++i )
+			v->push_back( rnd.nextFloat( -10, 10 ) );
+	};
+
+	randomFloats( &result.getBufferPositions(), numVertices * 3 );
+	randomFloats( &result.getBufferColors(), numVertices * 4 );
+	randomFloats( &result.getBufferTexCoords0(), numVertices * 2 );
+	randomFloats( &result.getBufferTexCoords1(), numVertices * 3 );
+	randomFloats( &result.getBufferTexCoords2(), numVertices * 1 );
+	randomFloats( &result.getBufferTexCoords3(), numVertices * 4 );
+	for( size_t i = 0; i < numVertices; ++i ) {
+		result.appendNormal( rnd.nextVec3() );
+		result.appendTangent( rnd.nextVec3() );
+		result.appendBitangent( rnd.nextVec3() );
+		result.getBoneIndices().push_back( vec4( rnd.nextUint( 64 ), rnd.nextUint( 64 ), rnd.nextUint( 64 ), rnd.nextUint( 64 ) ) );
+		result.getBoneWeights().push_back( vec4( rnd.nextFloat(), rnd.nextFloat(), rnd.nextFloat(), rnd.nextFloat() ) );
+	}
+	for( size_t t = 0; t < numTriangles; ++t )
+		result.appendTriangle( rnd.nextUint( (uint32_t)numVertices ), rnd.nextUint( (uint32_t)numVertices ), rnd.nextUint( (uint32_t)numVertices ) );
+
+	return result;
+}
+
+template<typename T>
+bool sameData( const void *data, const vector<T> &expected )
+{
+	return data && memcmp( data, expected.data(), expected.size() * sizeof( T ) ) == 0;
+}
+
+template<typename T>
+bool sameData( const vector<T> &a, const vector<T> &b )
+{
+	return a.size() == b.size() && ( a.empty() || sameData( a.data(), b ) );
+}
+
+bool sameMeshes( const TriMesh &a, const TriMesh &b )
+{
+	for( int attrib = 0; attrib < geom::NUM_ATTRIBS; ++attrib ) {
+		if( a.getAttribDims( (geom::Attrib)attrib ) != b.getAttribDims( (geom::Attrib)attrib ) )
+			return false;
+	}
+
+	return sameData( a.getIndices(), b.getIndices() ) && sameData( a.getBufferPositions(), b.getBufferPositions() ) && sameData( a.getBufferColors(), b.getBufferColors() )
+		&& sameData( a.getBufferTexCoords0(), b.getBufferTexCoords0() ) && sameData( a.getBufferTexCoords1(), b.getBufferTexCoords1() )
+		&& sameData( a.getBufferTexCoords2(), b.getBufferTexCoords2() ) && sameData( a.getBufferTexCoords3(), b.getBufferTexCoords3() )
+		&& sameData( a.getNormals(), b.getNormals() ) && sameData( a.getTangents(), b.getTangents() ) && sameData( a.getBitangents(), b.getBitangents() )
+		&& sameData( a.getBoneIndices(), b.getBoneIndices() ) && sameData( a.getBoneWeights(), b.getBoneWeights() );
+}
+
+// checks the cache's attribute pointers against \a mesh
+bool cacheMatches( const TriMeshCache &cache, const TriMesh &mesh )
+{
+	return cache.getNumVertices() == mesh.getNumVertices() && cache.getNumIndices() == mesh.getNumIndices() && cache.getPrimitive() == geom::Primitive::TRIANGLES
+		&& cache.getAvailableAttribs() == mesh.getAvailableAttribs()
+		&& sameData( cache.getIndices(), mesh.getIndices() ) && sameData( cache.getAttribData( geom::POSITION ), mesh.getBufferPositions() )
+		&& sameData( cache.getAttribData( geom::COLOR ), mesh.getBufferColors() ) && sameData( cache.getAttribData( geom::TEX_COORD_1 ), mesh.getBufferTexCoords1() )
+		&& sameData( cache.getAttribData( geom::NORMAL ), mesh.getNormals() ) && sameData( cache.getAttribData( geom::BONE_WEIGHT ), mesh.getBoneWeights() );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TriMeshCache" )
+{
+	const fs::path path = fs::temp_directory_path() / "cinder_trimesh_cache_test.bin";
+
+	SECTION( "Uncompressed caches are used in place, with every block 64-byte aligned" )
+	{
+		const TriMesh mesh = makeMesh( 5000, 9000, 1 );
+		TriMeshCache::write( DataTargetPath::createRef( path ), mesh );
+
+		DataSourcePathRef source = DataSourcePath::create( path );
+		TriMeshCacheRef cache = TriMeshCache::create( source );
+		REQUIRE( source->isMemoryMapped() );
+		REQUIRE( cacheMatches( *cache, mesh ) );
+
+		// every attribute points into the mapped file
+		const uint8_t *begin = (const uint8_t*)cache->getBuffer()->getData();
+		const uint8_t *end = begin + cache->getBuffer()->getSize();
+		for( geom::Attrib attrib : cache->getAvailableAttribs() ) {
+			const uint8_t *data = (const uint8_t*)cache->getAttribData( attrib );
+			REQUIRE( data >= begin );
+			REQUIRE( data < end );
+			REQUIRE( ( data - begin ) % 64 == 0 );
+		}
+		REQUIRE( ( (const uint8_t*)cache->getIndices() - begin ) % 64 == 0 );
+
+		REQUIRE( sameMeshes( TriMesh( *cache ), mesh ) );
+		unique_ptr<geom::Source> clone( cache->clone() );
+		cache.reset();
+		REQUIRE( sameMeshes( TriMesh( *clone ), mesh ) );
+
+		// TriMesh::read() loads caches as version 3
+		TriMesh read;
+		read.read( DataSourcePath::create( path ) );
+		REQUIRE( sameMeshes( read, mesh ) );
+		read.read( DataSourcePath::create( path, false ) );
+		REQUIRE( sameMeshes( read, mesh ) );
+
+		clone.reset();
+		fs::remove( path );
+	}
+
+	SECTION( "Compressed caches inflate their blocks and are smaller" )
+	{
+		// smooth data compresses well, whereas the random attributes are stored uncompressed
+		TriMesh mesh = makeMesh( 3000, 6000, 2 );
+		for( size_t i = 0; i < mesh.getBufferTexCoords0().size(); ++i )
+			mesh.getBufferTexCoords0()[i] = float( i / 64 );
+		for( size_t i = 0; i < mesh.getIndices().size(); ++i )
+			mesh.getIndices()[i] = uint32_t( i / 6 );
+
+		TriMeshCache::write( DataTargetPath::createRef( path ), mesh );
+		const uintmax_t uncompressedSize = fs::file_size( path );
+		TriMeshCache::write( DataTargetPath::createRef( path ), mesh, TriMeshCache::Options().compressionLevel( 6 ) );
+		REQUIRE( fs::file_size( path ) < uncompressedSize );
+
+		TriMeshCacheRef cache = TriMeshCache::create( DataSourcePath::create( path ) );
+		REQUIRE( cacheMatches( *cache, mesh ) );
+		REQUIRE( sameData( cache->getAttribData( geom::TEX_COORD_0 ), mesh.getBufferTexCoords0() ) );
+		REQUIRE( sameMeshes( TriMesh( *cache ), mesh ) );
+		fs::remove( path );
+	}
+
+	SECTION( "Attributes can be restricted, and non-indexed sources keep their primitive" )
+	{
+		const TriMesh mesh = makeMesh( 100, 50, 3 );
+		TriMeshCache::write( DataTargetPath::createRef( path ), mesh, TriMeshCache::Options().attribs( { geom::POSITION, geom::NORMAL, geom::CUSTOM_0 } ) );
+		TriMeshCacheRef cache = TriMeshCache::create( DataSourcePath::create( path ) );
+		REQUIRE( cache->getAvailableAttribs() == geom::AttribSet( { geom::POSITION, geom::NORMAL } ) );
+		REQUIRE( sameData( cache->getAttribData( geom::NORMAL ), mesh.getNormals() ) );
+		REQUIRE( cache->getAttribData( geom::COLOR ) == nullptr );
+		REQUIRE( cache->getAttribDims( geom::COLOR ) == 0 );
+
+		const geom::Circle circle = geom::Circle().subdivisions( 30 );
+		TriMeshCache::write( DataTargetPath::createRef( path ), circle );
+		cache = TriMeshCache::create( DataSourcePath::create( path ) );
+		REQUIRE( cache->getPrimitive() == geom::Primitive::TRIANGLE_FAN );
+		REQUIRE( cache->getNumIndices() == 0 );
+		REQUIRE( cache->getIndices() == nullptr );
+		REQUIRE( cache->getNumVertices() == circle.getNumVertices() );
+		REQUIRE( cache->getAvailableAttribs() == circle.getAvailableAttribs() );
+		REQUIRE( sameMeshes( TriMesh( *cache ), TriMesh( circle ) ) );
+		fs::remove( path );
+	}
+
+	SECTION( "Invalid files throw" )
+	{
+		TriMeshCache::write( DataTargetPath::createRef( path ), makeMesh( 200, 100, 4 ) );
+		string contents;
+		{
+			ifstream in( path.string(), ios::binary );
+			contents.assign( istreambuf_iterator<char>( in ), istreambuf_iterator<char>() );
+		}
+		auto load = [&]( const string &data ) {
+			BufferRef buffer = Buffer::create( data.size() );
+			memcpy( buffer->getData(), data.data(), data.size() );
+			return TriMeshCache::create( DataSourceBuffer::create( buffer ) );
+		};
+
+		REQUIRE_NOTHROW( load( contents ) );
+		REQUIRE_THROWS_AS( load( contents.substr( 0, 40 ) ), TriMeshCacheExc );
+		REQUIRE_THROWS_AS( load( contents.substr( 0, contents.size() - 1 ) ), TriMeshCacheExc );
+		string badMagic = contents;
+		badMagic[1] = 'X';
+		REQUIRE_THROWS_AS( load( badMagic ), TriMeshCacheExc );
+		// the first block entry's offset, which must stay 64-byte aligned
+		string misaligned = contents;
+		misaligned[64 + 8] += 4;
+		REQUIRE_THROWS_AS( load( misaligned ), TriMeshCacheExc );
+		// the indices are the first block; point one past the last vertex
+		string outOfRange = contents;
+		uint64_t indicesOffset;
+		memcpy( &indicesOffset, &outOfRange[64 + 8], sizeof( indicesOffset ) );
+		const uint32_t badIndex = 200;
+		memcpy( &outOfRange[indicesOffset + 4], &badIndex, sizeof( badIndex ) );
+		REQUIRE_THROWS_AS( load( outOfRange ), TriMeshCacheExc );
+
+		// counts far beyond what the file holds, made consistent with the compressed indices block, throw before inflating
+		TriMesh mesh = makeMesh( 200, 100, 4 );
+		for( size_t i = 0; i < mesh.getIndices().size(); ++i )
+			mesh.getIndices()[i] = uint32_t( i / 3 );
+		TriMeshCache::write( DataTargetPath::createRef( path ), mesh, TriMeshCache::Options().compressionLevel( 6 ) );
+		{
+			ifstream in( path.string(), ios::binary );
+			contents.assign( istreambuf_iterator<char>( in ), istreambuf_iterator<char>() );
+		}
+		REQUIRE_NOTHROW( load( contents ) );
+		REQUIRE( contents[64 + 5] == 1 );
+		for( uint64_t numIndices : { uint64_t( contents.size() ) * 1000, uint64_t( 1 ) << 60 } ) {
+			string huge = contents;
+			const uint64_t bytes = numIndices * sizeof( uint32_t );
+			memcpy( &huge[24], &numIndices, sizeof( numIndices ) );
+			memcpy( &huge[64 + 24], &bytes, sizeof( bytes ) );
+			REQUIRE_THROWS_AS( load( huge ), TriMeshCacheExc );
+		}
+		fs::remove( path );
+	}
+}
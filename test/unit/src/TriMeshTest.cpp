@@ -0,0 +1,510 @@
+#include "catch.hpp"
+
+#include "cinder/TriMesh.h"
+#include "cinder/Rand.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// an n by n grid of vertices on a wave, with normals and tex coords
+TriMesh makeGrid( int n )
+{
+	TriMesh result( TriMesh::Format().positions().normals().texCoords() );
+	for( int y = 0; y < n; ++y ) {
+		for( int x = 0; x < n; ++x ) {
+			result.appendPosition( vec3( x, std::sin( x * 0.3f ) * 2, y ) );
+			result.appendNormal( normalize( vec3( -std::cos( x * 0.3f ), 1, 0 ) ) );
+			result.appendTexCoord( vec2( x, y ) / float( n ) );
+		}
+	}
+	for( int y = 0; y + 1 < n; ++y ) {
+		for( int x = 0; x + 1 < n; ++x ) {
+			const uint32_t a = y * n + x, b = a + 1, c = a + n, d = c + 1;
+			result.appendTriangle( a, b, d );
+			result.appendTriangle( a, d, c );
+		}
+	}
+
+	return result;
+}
+
+void shuffleTriangles( TriMesh *mesh, uint32_t seed )
+{
+	vector<array<uint32_t,3>> triangles( mesh->getNumTriangles() );
+	memcpy( triangles.data(), mesh->getIndices().data(), triangles.size() * sizeof( triangles[0] ) );
+	Rand rnd( seed );
+	for( size_t i = triangles.size(); i > 1; --i )
+		swap( triangles[i - 1], triangles[rnd.nextUint( uint32_t( i ) )] );
+	memcpy( mesh->getIndices().data(), triangles.data(), triangles.size() * sizeof( triangles[0] ) );
+}
+
+// the triangles, rotated to start at their lowest index so that winding is kept, in sorted order
+vector<array<uint32_t,3>> sortedTriangles( const TriMesh &mesh )
+{
+	vector<array<uint32_t,3>> result;
+	const auto &indices = mesh.getIndices();
+	for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+		array<uint32_t,3> triangle = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+		rotate( triangle.begin(), min_element( triangle.begin(), triangle.end() ), triangle.end() );
+		result.push_back( triangle );
+	}
+	sort( result.begin(), result.end() );
+	return result;
+}
+
+// the attributes of every corner of every triangle
+vector<float> cornerAttribs( const TriMesh &mesh )
+{
+	vector<float> result;
+	for( uint32_t index : mesh.getIndices() ) {
+		const vec3 p = mesh.getPositions<3>()[index], n = mesh.getNormals()[index];
+		const vec2 uv = mesh.getTexCoords0<2>()[index];
+		result.insert( result.end(), { p.x, p.y, p.z, n.x, n.y, n.z, uv.x, uv.y } );
+	}
+	return result;
+}
+
+// a copy of \a mesh where every corner of every triangle has its own vertex, moved by up to \a jitter
+TriMesh explode( const TriMesh &mesh, float jitter, uint32_t seed )
+{
+	Rand rnd( seed );
+	auto offset = [&] { return vec3( rnd.nextFloat( -jitter, jitter ), rnd.nextFloat( -jitter, jitter ), rnd.nextFloat( -jitter, jitter ) ); };
+	TriMesh result( TriMesh::Format().positions().normals().texCoords() );
+	for( uint32_t index : mesh.getIndices() ) {
+		result.appendPosition( mesh.getPositions<3>()[index] + offset() );
+		result.appendNormal( mesh.getNormals()[index] + offset() );
+		result.appendTexCoord( mesh.getTexCoords0<2>()[index] );
+		const uint32_t newIndex = uint32_t( result.getNumVertices() - 1 );
+		result.appendIndices( &newIndex, 1 );
+	}
+	return result;
+}
+
+// the normals of \a mesh accumulated a triangle at a time, without grouping vertices
+vector<vec3> referenceNormals( const TriMesh &mesh, bool weighted )
+{
+	const vec3 *positions = mesh.getPositions<3>();
+	const auto &indices = mesh.getIndices();
+	vector<vec3> sums( mesh.getNumVertices(), vec3( 0 ) );
+	for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+		const uint32_t *triangle = &indices[t * 3];
+		vec3 normal = cross( positions[triangle[1]] - positions[triangle[0]], positions[triangle[2]] - positions[triangle[0]] );
+		if( ! weighted )
+			normal = normalize( normal );
+		for( int i = 0; i < 3; ++i )
+			sums[triangle[i]] += normal;
+	}
+	for( vec3 &sum : sums )
+		sum = normalize( sum );
+
+	return sums;
+}
+
+float totalArea( const TriMesh &mesh )
+{
+	float result = 0;
+	const vec3 *positions = mesh.getPositions<3>();
+	const auto &indices = mesh.getIndices();
+	for( size_t t = 0; t < mesh.getNumTriangles(); ++t )
+		result += length( cross( positions[indices[t * 3 + 1]] - positions[indices[t * 3]], positions[indices[t * 3 + 2]] - positions[indices[t * 3]] ) ) / 2;
+	return result;
+}
+
+// the edges between positions that belong to a single triangle, which includes cracks between vertices that share a position
+vector<pair<vec3,vec3>> borderEdges( const TriMesh &mesh )
+{
+	auto key = []( const vec3 &p ) { return array<float,3>{ p.x, p.y, p.z }; };
+	map<pair<array<float,3>,array<float,3>>,int> counts;
+	const vec3 *positions = mesh.getPositions<3>();
+	const auto &indices = mesh.getIndices();
+	for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+		for( int i = 0; i < 3; ++i ) {
+			auto a = key( positions[indices[t * 3 + i]] ), b = key( positions[indices[t * 3 + ( i + 1 ) % 3]] );
+			++counts[make_pair( std::min( a, b ), std::max( a, b ) )];
+		}
+	}
+
+	vector<pair<vec3,vec3>> result;
+	for( auto &entry : counts ) {
+		if( entry.second == 1 )
+			result.emplace_back( vec3( entry.first.first[0], entry.first.first[1], entry.first.first[2] ), vec3( entry.first.second[0], entry.first.second[1], entry.first.second[2] ) );
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TriMesh" )
+{
+	SECTION( "analyzeVertexCache() simulates a FIFO cache" )
+	{
+		TriMesh mesh( TriMesh::Format().positions() );
+		for( int i = 0; i < 6; ++i )
+			mesh.appendPosition( vec3( i ) );
+		mesh.appendTriangle( 0, 1, 2 );
+		mesh.appendTriangle( 2, 1, 3 );
+		TriMesh::VertexCacheStats stats = mesh.analyzeVertexCache( 3 );
+		REQUIRE( stats.numTransformed == 4 );
+		REQUIRE( stats.acmr == 2 );
+		REQUIRE( stats.atvr == 1 );
+
+		// vertex 3 pushed 0 out of the cache, and reloading 0 and 1 pushes out 1 and 2 in turn
+		mesh.appendTriangle( 0, 1, 2 );
+		REQUIRE( mesh.analyzeVertexCache( 3 ).numTransformed == 7 );
+		REQUIRE( mesh.analyzeVertexCache( 4 ).numTransformed == 4 );
+		REQUIRE( mesh.analyzeVertexCache( 0 ).numTransformed == 9 );
+		REQUIRE( mesh.analyzeVertexCache( 0 ).atvr == 9 / 4.0f );
+	}
+
+	SECTION( "weldVertices() merges vertices within the tolerance and keeps the rest apart" )
+	{
+		const TriMesh grid = makeGrid( 40 );
+		const float tolerance = 0.01f;
+
+		TriMesh exact = explode( grid, 0, 1 );
+		REQUIRE( exact.weldVertices() == grid.getNumIndices() - grid.getNumVertices() );
+		REQUIRE( exact.getNumVertices() == grid.getNumVertices() );
+		REQUIRE( cornerAttribs( exact ) == cornerAttribs( grid ) );
+
+		TriMesh jittered = explode( grid, tolerance / 4, 2 );
+		REQUIRE( jittered.weldVertices( 0 ) == 0 );
+		REQUIRE( jittered.weldVertices( tolerance ) == grid.getNumIndices() - grid.getNumVertices() );
+		REQUIRE( jittered.getNumVertices() == grid.getNumVertices() );
+		REQUIRE( jittered.getNumIndices() == grid.getNumIndices() );
+		const vector<float> expected = cornerAttribs( grid ), welded = cornerAttribs( jittered );
+		for( size_t i = 0; i < expected.size(); ++i )
+			REQUIRE( std::abs( welded[i] - expected[i] ) <= tolerance );
+
+		// vertices whose tex coords differ stay apart
+		TriMesh seams = explode( grid, 0, 3 );
+		for( size_t v = 0; v < seams.getNumVertices(); v += 2 )
+			seams.getBufferTexCoords0()[v * 2] += 0.5f;
+		seams.weldVertices( tolerance );
+		REQUIRE( seams.getNumVertices() > grid.getNumVertices() );
+		REQUIRE( seams.getNumVertices() <= grid.getNumVertices() * 2 );
+	}
+
+	SECTION( "optimizeVertexCache() improves the cache miss ratio and keeps the triangles" )
+	{
+		TriMesh mesh = makeGrid( 100 );
+		shuffleTriangles( &mesh, 4 );
+		const auto triangles = sortedTriangles( mesh );
+		const TriMesh::VertexCacheStats before = mesh.analyzeVertexCache();
+
+		mesh.optimizeVertexCache();
+		const TriMesh::VertexCacheStats after = mesh.analyzeVertexCache();
+		INFO( "ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr );
+		REQUIRE( sortedTriangles( mesh ) == triangles );
+		REQUIRE( before.acmr > 2 );
+		REQUIRE( after.acmr < 0.8f );
+		REQUIRE( after.atvr < 1.5f );
+
+		// the overdraw pass reorders clusters without losing much locality
+		REQUIRE( mesh.optimizeOverdraw() );
+		REQUIRE( sortedTriangles( mesh ) == triangles );
+		REQUIRE( mesh.analyzeVertexCache().acmr < after.acmr * 1.2f );
+
+		TriMesh flat( TriMesh::Format().positions( 2 ) );
+		flat.appendPosition( vec2( 0 ) );
+		flat.appendPosition( vec2( 1, 0 ) );
+		flat.appendPosition( vec2( 0, 1 ) );
+		flat.appendTriangle( 0, 1, 2 );
+		REQUIRE( ! flat.optimizeOverdraw() );
+	}
+
+	SECTION( "optimizeOverdraw() draws outward facing clusters first" )
+	{
+		// a big box around a small one: the small one is never visible from the outside, and can only be hidden if drawn last
+		TriMesh mesh( TriMesh::Format().positions() );
+		auto addQuad = [&]( vec3 origin, vec3 u, vec3 v ) {
+			const uint32_t base = (uint32_t)mesh.getNumVertices();
+			mesh.appendPosition( origin );
+			mesh.appendPosition( origin + u );
+			mesh.appendPosition( origin + u + v );
+			mesh.appendPosition( origin + v );
+			mesh.appendTriangle( base, base + 1, base + 2 );
+			mesh.appendTriangle( base, base + 2, base + 3 );
+		};
+		// the inner quad faces the center, the outer one faces away from it
+		addQuad( vec3( -1, -1, 0.1f ), vec3( 0, 2, 0 ), vec3( 2, 0, 0 ) );
+		addQuad( vec3( -10, -10, 5 ), vec3( 20, 0, 0 ), vec3( 0, 20, 0 ) );
+		addQuad( vec3( -10, -10, -5 ), vec3( 0, 20, 0 ), vec3( 20, 0, 0 ) );
+
+		REQUIRE( mesh.optimizeOverdraw() );
+		REQUIRE( *min_element( mesh.getIndices().begin(), mesh.getIndices().begin() + 6 ) >= 4 );
+		REQUIRE( *min_element( mesh.getIndices().end() - 6, mesh.getIndices().end() ) == 0 );
+	}
+
+	SECTION( "optimizeVertexFetch() orders vertices by first use and drops unreferenced ones" )
+	{
+		TriMesh mesh = makeGrid( 30 );
+		shuffleTriangles( &mesh, 5 );
+		for( int i = 0; i < 100; ++i ) {
+			mesh.appendPosition( vec3( i ) );
+			mesh.appendNormal( vec3( 0, 1, 0 ) );
+			mesh.appendTexCoord( vec2( 0 ) );
+		}
+		const vector<float> before = cornerAttribs( mesh );
+
+		REQUIRE( mesh.optimizeVertexFetch() == 100 );
+		REQUIRE( mesh.getNumVertices() == 30 * 30 );
+		REQUIRE( mesh.getNormals().size() == 30 * 30 );
+		REQUIRE( mesh.getBufferTexCoords0().size() == 30 * 30 * 2 );
+		REQUIRE( cornerAttribs( mesh ) == before );
+
+		uint32_t nextNew = 0;
+		for( uint32_t index : mesh.getIndices() ) {
+			REQUIRE( index <= nextNew );
+			if( index == nextNew )
+				++nextNew;
+		}
+		REQUIRE( mesh.optimizeVertexFetch() == 0 );
+	}
+
+	SECTION( "recalculateNormals() and recalculateTangents() give the same results for any number of threads" )
+	{
+		TriMesh mesh = makeGrid( 200 );
+		shuffleTriangles( &mesh, 5 );
+		const TriMesh::Adjacency adjacency( mesh );
+
+		for( bool weighted : { false, true } ) {
+			INFO( ( weighted ? "weighted" : "unweighted" ) );
+			REQUIRE( mesh.recalculateNormals( adjacency, weighted, 1 ) );
+			REQUIRE( mesh.recalculateTangents( adjacency, 1 ) );
+			const vector<vec3> normals = mesh.getNormals(), tangents = mesh.getTangents();
+
+			const vector<vec3> reference = referenceNormals( mesh, weighted );
+			for( size_t v = 0; v < reference.size(); ++v )
+				REQUIRE( length( normals[v] - reference[v] ) < 1e-5f );
+			for( size_t v = 0; v < tangents.size(); ++v ) {
+				REQUIRE( std::abs( length( tangents[v] ) - 1 ) < 1e-5f );
+				REQUIRE( std::abs( dot( tangents[v], normals[v] ) ) < 1e-5f );
+			}
+
+			for( int numThreads : { 2, 3, 8, 0 } ) {
+				INFO( numThreads << " threads" );
+				REQUIRE( mesh.recalculateNormals( adjacency, weighted, numThreads ) );
+				REQUIRE( mesh.recalculateTangents( adjacency, numThreads ) );
+				REQUIRE( memcmp( mesh.getNormals().data(), normals.data(), normals.size() * sizeof( vec3 ) ) == 0 );
+				REQUIRE( memcmp( mesh.getTangents().data(), tangents.data(), tangents.size() * sizeof( vec3 ) ) == 0 );
+			}
+
+			// the overloads without an adjacency agree
+			REQUIRE( mesh.recalculateNormals( false, weighted ) );
+			REQUIRE( mesh.recalculateTangents() );
+			REQUIRE( memcmp( mesh.getNormals().data(), normals.data(), normals.size() * sizeof( vec3 ) ) == 0 );
+			REQUIRE( memcmp( mesh.getTangents().data(), tangents.data(), tangents.size() * sizeof( vec3 ) ) == 0 );
+		}
+	}
+
+	SECTION( "An Adjacency is reused while the mesh deforms and rejected once its topology changes" )
+	{
+		TriMesh mesh = makeGrid( 50 );
+		const TriMesh::Adjacency adjacency( mesh );
+		REQUIRE( ! adjacency.isSmooth() );
+		REQUIRE( ! TriMesh::Adjacency().matches( mesh ) );
+
+		for( int frame = 0; frame < 3; ++frame ) {
+			vec3 *positions = mesh.getPositions<3>();
+			for( size_t v = 0; v < mesh.getNumVertices(); ++v )
+				positions[v].y = std::sin( positions[v].x * 0.2f + frame ) + std::cos( positions[v].z * 0.3f );
+
+			REQUIRE( mesh.recalculateNormals( adjacency ) );
+			const vector<vec3> normals = mesh.getNormals();
+			REQUIRE( mesh.recalculateNormals( TriMesh::Adjacency( mesh ) ) );
+			REQUIRE( mesh.getNormals() == normals );
+		}
+
+		mesh.appendTriangle( 0, 1, 50 );
+		REQUIRE( ! adjacency.matches( mesh ) );
+		REQUIRE( ! mesh.recalculateNormals( adjacency ) );
+		REQUIRE( ! mesh.recalculateTangents( adjacency ) );
+
+		// indices past the vertices make an invalid adjacency
+		mesh.appendTriangle( 0, 1, uint32_t( mesh.getNumVertices() ) );
+		REQUIRE( ! TriMesh::Adjacency( mesh ).matches( mesh ) );
+		REQUIRE( ! mesh.recalculateNormals() );
+	}
+
+	SECTION( "Smooth normals average the vertices that share a position" )
+	{
+		// two halves of a bent grid, with the vertices of the seam duplicated
+		TriMesh mesh( TriMesh::Format().positions() );
+		const int n = 9;
+		for( int half = 0; half < 2; ++half ) {
+			const uint32_t base = uint32_t( mesh.getNumVertices() );
+			for( int y = 0; y < n; ++y ) {
+				for( int x = 0; x < n; ++x ) {
+					const float u = float( half * ( n - 1 ) + x );
+					mesh.appendPosition( vec3( u, u < n - 1 ? 0 : ( u - ( n - 1 ) ), y ) );
+				}
+			}
+			for( int y = 0; y + 1 < n; ++y ) {
+				for( int x = 0; x + 1 < n; ++x ) {
+					const uint32_t a = base + y * n + x, b = a + 1, c = a + n, d = c + 1;
+					mesh.appendTriangle( a, d, b );
+					mesh.appendTriangle( a, c, d );
+				}
+			}
+		}
+
+		const TriMesh::Adjacency smooth( mesh, true );
+		REQUIRE( smooth.isSmooth() );
+		REQUIRE( mesh.recalculateNormals( smooth ) );
+		const vector<vec3> smoothNormals = mesh.getNormals();
+		REQUIRE( mesh.recalculateNormals( true ) );
+		REQUIRE( mesh.getNormals() == smoothNormals );
+		REQUIRE( mesh.recalculateNormals( false ) );
+		const vector<vec3> flatNormals = mesh.getNormals();
+
+		for( int y = 0; y < n; ++y ) {
+			const uint32_t left = y * n + n - 1, right = n * n + y * n;
+			INFO( "seam row " << y );
+			REQUIRE( smoothNormals[left] == smoothNormals[right] );
+			REQUIRE( length( flatNormals[left] - vec3( 0, 1, 0 ) ) < 1e-5f );
+			REQUIRE( length( flatNormals[right] - normalize( vec3( -1, 1, 0 ) ) ) < 1e-5f );
+			// away from the corners, both sides of the seam have three triangles
+			if( y > 0 && y < n - 1 )
+				REQUIRE( length( smoothNormals[left] - normalize( flatNormals[left] + flatNormals[right] ) ) < 1e-5f );
+		}
+	}
+
+	SECTION( "simplify() removes flat regions without error and keeps the outline" )
+	{
+		TriMesh mesh = makeGrid( 30 );
+		for( size_t v = 0; v < mesh.getNumVertices(); ++v ) {
+			mesh.getPositions<3>()[v].y = 0;
+			mesh.getNormals()[v] = vec3( 0, 1, 0 );
+		}
+		const float area = totalArea( mesh );
+
+		const float error = mesh.simplify( 0, TriMesh::SimplifyOptions().targetError( 1e-4f ) );
+		REQUIRE( error <= 1e-4f );
+		REQUIRE( mesh.getNumTriangles() < 20 );
+		REQUIRE( mesh.getNumVertices() <= mesh.getNumTriangles() * 3 );
+		REQUIRE( std::abs( totalArea( mesh ) - area ) < area * 1e-4f );
+		REQUIRE( mesh.getNormals().size() == mesh.getNumVertices() );
+		REQUIRE( mesh.getBufferTexCoords0().size() == mesh.getNumVertices() * 2 );
+		for( uint32_t index : mesh.getIndices() )
+			REQUIRE( index < mesh.getNumVertices() );
+	}
+
+	SECTION( "simplify() reaches a triangle count without folding the surface, and attribute seams stay closed" )
+	{
+		// the right half of the grid has its own vertices along the middle column, with different texture coordinates
+		const int n = 40;
+		TriMesh mesh = makeGrid( n );
+		const uint32_t seamBase = uint32_t( mesh.getNumVertices() );
+		for( int y = 0; y < n; ++y ) {
+			mesh.appendPosition( mesh.getPositions<3>()[y * n + n / 2] );
+			mesh.appendNormal( mesh.getNormals()[y * n + n / 2] );
+			mesh.appendTexCoord( vec2( 0.5f, 2 ) );
+		}
+		auto &indices = mesh.getIndices();
+		for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+			const uint32_t *triangle = &indices[t * 3];
+			const bool right = ( triangle[0] % n ) + ( triangle[1] % n ) + ( triangle[2] % n ) > 3 * ( n / 2 );
+			for( int i = 0; i < 3 && right; ++i ) {
+				if( indices[t * 3 + i] % n == n / 2 )
+					indices[t * 3 + i] = seamBase + indices[t * 3 + i] / n;
+			}
+		}
+		REQUIRE( borderEdges( mesh ).size() == 4 * ( n - 1 ) );
+
+		const size_t target = mesh.getNumTriangles() / 10;
+		mesh.simplify( target );
+		REQUIRE( mesh.getNumTriangles() <= target );
+		REQUIRE( mesh.getNumTriangles() > target / 2 );
+
+		// no new border opens up inside the grid
+		for( auto &edge : borderEdges( mesh ) ) {
+			const bool onOutline = ( edge.first.x == 0 && edge.second.x == 0 ) || ( edge.first.x == n - 1 && edge.second.x == n - 1 )
+				|| ( edge.first.z == 0 && edge.second.z == 0 ) || ( edge.first.z == n - 1 && edge.second.z == n - 1 );
+			REQUIRE( onOutline );
+		}
+
+		// the grid faces down, and so do the remaining triangles
+		const vec3 *positions = mesh.getPositions<3>();
+		for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+			const vec3 normal = cross( positions[indices[t * 3 + 1]] - positions[indices[t * 3]], positions[indices[t * 3 + 2]] - positions[indices[t * 3]] );
+			REQUIRE( normal.y < 0 );
+		}
+	}
+
+	SECTION( "simplify() can lock borders, and weighs attribute differences" )
+	{
+		TriMesh mesh = makeGrid( 30 );
+		vector<vec3> outline;
+		for( auto &edge : borderEdges( mesh ) ) {
+			outline.push_back( edge.first );
+			outline.push_back( edge.second );
+		}
+
+		mesh.simplify( 10, TriMesh::SimplifyOptions().lockBorders() );
+		const vector<vec3> remaining( mesh.getPositions<3>(), mesh.getPositions<3>() + mesh.getNumVertices() );
+		for( const vec3 &p : outline )
+			REQUIRE( find( remaining.begin(), remaining.end(), p ) != remaining.end() );
+
+		// a flat grid with a sharp change in color keeps the vertices along the change
+		TriMesh colored( TriMesh::Format().positions().colors( 3 ) );
+		const int n = 20;
+		for( int y = 0; y < n; ++y ) {
+			for( int x = 0; x < n; ++x ) {
+				colored.appendPosition( vec3( x, 0, y ) );
+				colored.appendColorRgb( x < n / 2 ? Color( 1, 0, 0 ) : Color( 0, 0, 1 ) );
+			}
+		}
+		for( int y = 0; y + 1 < n; ++y ) {
+			for( int x = 0; x + 1 < n; ++x ) {
+				const uint32_t a = y * n + x, b = a + 1, c = a + n, d = c + 1;
+				colored.appendTriangle( a, d, b );
+				colored.appendTriangle( a, c, d );
+			}
+		}
+		TriMesh ignoringColors = colored;
+		ignoringColors.simplify( 0, TriMesh::SimplifyOptions().targetError( 1e-3f ).colorWeight( 0 ) );
+		colored.simplify( 0, TriMesh::SimplifyOptions().targetError( 1e-3f ) );
+		REQUIRE( colored.getNumTriangles() > ignoringColors.getNumTriangles() );
+		for( size_t t = 0; t < colored.getNumTriangles(); ++t ) {
+			// no triangle spans more than the single column where the color changes
+			float minX = n, maxX = 0;
+			for( int i = 0; i < 3; ++i ) {
+				minX = std::min( minX, colored.getPositions<3>()[colored.getIndices()[t * 3 + i]].x );
+				maxX = std::max( maxX, colored.getPositions<3>()[colored.getIndices()[t * 3 + i]].x );
+			}
+			REQUIRE( ( maxX < n / 2 || minX >= n / 2 - 1 ) );
+		}
+	}
+
+	SECTION( "generateLods() makes the levels simplify() would, in one pass" )
+	{
+		const TriMesh mesh = makeGrid( 40 );
+		vector<float> errors;
+		const vector<size_t> targets = { 2000, 500, 50 };
+		const vector<TriMesh> lods = mesh.generateLods( targets, TriMesh::SimplifyOptions(), &errors );
+		REQUIRE( lods.size() == 3 );
+		REQUIRE( errors.size() == 3 );
+		REQUIRE( lods[0].getNumTriangles() <= 2000 );
+		REQUIRE( lods[1].getNumTriangles() <= 500 );
+		REQUIRE( lods[2].getNumTriangles() <= 50 );
+		REQUIRE( errors[0] <= errors[1] );
+		REQUIRE( errors[1] <= errors[2] );
+
+		for( size_t level = 0; level < lods.size(); ++level ) {
+			INFO( "level " << level );
+			TriMesh simplified = mesh;
+			const float error = simplified.simplify( targets[level] );
+			REQUIRE( error == errors[level] );
+			REQUIRE( simplified.getIndices() == lods[level].getIndices() );
+			REQUIRE( simplified.getNumVertices() == lods[level].getNumVertices() );
+			REQUIRE( memcmp( simplified.getPositions<3>(), lods[level].getPositions<3>(), simplified.getNumVertices() * sizeof( vec3 ) ) == 0 );
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #include "catch.hpp"
+#include "Utilities.h"
 
 #include "cinder/Cinder.h"
 #include "cinder/Utilities.h"
@@ -10,6 +11,25 @@
 using namespace std;
 using namespace ci;
 
+Surface8u makeTestSurface( int32_t width, int32_t height, bool alpha, uint32_t seed )
+{
+	Surface8u result( width, height, alpha );
+	Rand rnd( seed );
+	auto iter = result.getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			const bool noisy = ( iter.y() / 8 ) % 2 == 1;
+			iter.r() = uint8_t( iter.x() * 3 + ( noisy ? rnd.nextInt( 4 ) : 0 ) );
+			iter.g() = uint8_t( iter.y() * 5 );
+			iter.b() = noisy ? uint8_t( rnd.nextInt( 256 ) ) : uint8_t( iter.x() ^ iter.y() );
+			if( alpha )
+				iter.a() = uint8_t( 255 - iter.x() );
+		}
+	}
+
+	return result;
+}
+
 struct CustomType {
 	CustomType() {}
 	CustomType( int v ) : var( v ) {}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "cinder/Surface.h"
+#include "cinder/Channel.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/Rand.h"
+
+#include <cstring>
+
+// Image helpers shared by the unit tests
+
+//! Returns smooth gradients with some noise, so that the PNG writer exercises all of its row filters
+ci::Surface8u makeTestSurface( int32_t width, int32_t height, bool alpha, uint32_t seed );
+
+//! Fills \a surface with random values
+template<typename T>
+void fillRandom( ci::SurfaceT<T> *surface, uint32_t seed )
+{
+	ci::Rand rnd( seed );
+	auto iter = surface->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = ci::CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			iter.g() = ci::CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			iter.b() = ci::CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			if( surface->hasAlpha() )
+				iter.a() = ci::CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+		}
+	}
+}
+
+//! Fills \a channel with random values
+template<typename T>
+void fillRandom( ci::ChannelT<T> *channel, uint32_t seed )
+{
+	ci::Rand rnd( seed );
+	auto iter = channel->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() )
+			iter.v() = ci::CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+	}
+}
+
+//! Returns whether the pixels of \a a and \a b are bitwise equal, for surfaces of the same size and layout
+template<typename T>
+bool pixelsEqual( const ci::SurfaceT<T> &a, const ci::SurfaceT<T> &b )
+{
+	const size_t rowBytes = a.getWidth() * a.getPixelInc() * sizeof( T );
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		if( memcmp( a.getData( ci::ivec2( 0, y ) ), b.getData( ci::ivec2( 0, y ) ), rowBytes ) != 0 )
+			return false;
+	}
+	return true;
+}
+
+//! Returns whether the values of \a a and \a b are equal, for channels of the same size
+template<typename T>
+bool pixelsEqual( const ci::ChannelT<T> &a, const ci::ChannelT<T> &b )
+{
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( a.getValue( ci::ivec2( x, y ) ) != b.getValue( ci::ivec2( x, y ) ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+//! Returns whether \a a and \a b have the same size, channel order and pixels
+template<typename T>
+bool surfacesEqual( const ci::SurfaceT<T> &a, const ci::SurfaceT<T> &b )
+{
+	if( a.getSize() != b.getSize() || a.hasAlpha() != b.hasAlpha() || a.getChannelOrder() != b.getChannelOrder() )
+		return false;
+	return pixelsEqual( a, b );
+}
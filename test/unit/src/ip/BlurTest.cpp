@@ -0,0 +1,147 @@
+#include "catch.hpp"
+
+#include "cinder/ip/Blur.h"
+#include "cinder/Rand.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+void fillRandom( Channel32f *channel, uint32_t seed )
+{
+	Rand rnd( seed );
+	auto iter = channel->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() )
+			iter.v() = rnd.nextFloat();
+	}
+}
+
+// Brute force extended box filter of one line, clamping at the edges: full weight within radius, fractional weight on the next sample
+vector<double> referenceBoxLine( const vector<double> &src, float radius )
+{
+	const int r = (int)radius;
+	const double fraction = radius - r;
+	const int last = (int)src.size() - 1;
+	auto sample = [&]( int i ) { return src[std::min( std::max( i, 0 ), last )]; };
+
+	vector<double> result( src.size() );
+	for( int x = 0; x <= last; ++x ) {
+		double sum = fraction * ( sample( x - r - 1 ) + sample( x + r + 1 ) );
+		for( int i = -r; i <= r; ++i )
+			sum += sample( x + i );
+		result[x] = sum / ( 2 * r + 1 + 2 * fraction );
+	}
+	return result;
+}
+
+Channel32f referenceBoxBlur( const Channel32f &src, float radius )
+{
+	Channel32f result = src.clone();
+	vector<double> line;
+	for( int32_t y = 0; y < src.getHeight(); ++y ) {
+		line.clear();
+		for( int32_t x = 0; x < src.getWidth(); ++x )
+			line.push_back( src.getValue( ivec2( x, y ) ) );
+		line = referenceBoxLine( line, radius );
+		for( int32_t x = 0; x < src.getWidth(); ++x )
+			result.setValue( ivec2( x, y ), (float)line[x] );
+	}
+	for( int32_t x = 0; x < src.getWidth(); ++x ) {
+		line.clear();
+		for( int32_t y = 0; y < src.getHeight(); ++y )
+			line.push_back( result.getValue( ivec2( x, y ) ) );
+		line = referenceBoxLine( line, radius );
+		for( int32_t y = 0; y < src.getHeight(); ++y )
+			result.setValue( ivec2( x, y ), (float)line[y] );
+	}
+	return result;
+}
+
+float maxDifference( const Channel32f &a, const Channel32f &b )
+{
+	float result = 0;
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x )
+			result = std::max( result, std::abs( a.getValue( ivec2( x, y ) ) - b.getValue( ivec2( x, y ) ) ) );
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Blur" )
+{
+
+SECTION( "constant images are unchanged" )
+{
+	Surface8u surface( 67, 41, true );
+	auto iter = surface.getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = 10; iter.g() = 20; iter.b() = 30; iter.a() = 40;
+		}
+	}
+
+	Surface8u box = ip::boxBlurCopy( surface, 5.5f );
+	Surface8u gaussian = ip::gaussianBlurCopy( surface, 30 );
+	for( int32_t y = 0; y < surface.getHeight(); ++y ) {
+		for( int32_t x = 0; x < surface.getWidth(); ++x ) {
+			REQUIRE( box.getPixel( ivec2( x, y ) ) == ColorA8u( 10, 20, 30, 40 ) );
+			REQUIRE( gaussian.getPixel( ivec2( x, y ) ) == ColorA8u( 10, 20, 30, 40 ) );
+		}
+	}
+}
+
+SECTION( "boxBlur matches a brute force reference" )
+{
+	Channel32f channel( 53, 37 );
+	fillRandom( &channel, 7 );
+
+	for( float radius : { 1.0f, 2.5f, 4.75f, 40.0f } ) {
+		Channel32f blurred = ip::boxBlurCopy( channel, radius );
+		REQUIRE( maxDifference( blurred, referenceBoxBlur( channel, radius ) ) < 1e-5f );
+	}
+
+	Channel32f region = channel.clone();
+	ip::boxBlur( &region, Area( 10, 5, 30, 25 ), 3.5f );
+	Channel32f expected = referenceBoxBlur( channel.clone( Area( 10, 5, 30, 25 ) ), 3.5f );
+	REQUIRE( region.getValue( ivec2( 9, 5 ) ) == channel.getValue( ivec2( 9, 5 ) ) );
+	REQUIRE( region.getValue( ivec2( 30, 24 ) ) == channel.getValue( ivec2( 30, 24 ) ) );
+	REQUIRE( std::abs( region.getValue( ivec2( 10, 5 ) ) - expected.getValue( ivec2( 0, 0 ) ) ) < 1e-5f );
+	REQUIRE( std::abs( region.getValue( ivec2( 29, 24 ) ) - expected.getValue( ivec2( 19, 19 ) ) ) < 1e-5f );
+}
+
+SECTION( "gaussianBlur impulse response has the requested variance" )
+{
+	for( float sigma : { 0.8f, 2.0f, 3.3f, 12.7f } ) {
+		Channel32f impulse( 301, 1 );
+		for( int32_t x = 0; x < impulse.getWidth(); ++x )
+			impulse.setValue( ivec2( x, 0 ), 0 );
+		impulse.setValue( ivec2( 150, 0 ), 1 );
+		ip::gaussianBlur( &impulse, sigma );
+
+		double sum = 0, variance = 0;
+		for( int32_t x = 0; x < impulse.getWidth(); ++x ) {
+			double v = impulse.getValue( ivec2( x, 0 ) );
+			sum += v;
+			variance += v * ( x - 150 ) * ( x - 150 );
+		}
+		REQUIRE( sum == Approx( 1 ).epsilon( 1e-5 ) );
+		REQUIRE( std::sqrt( variance ) == Approx( sigma ).epsilon( 1e-3 ) );
+	}
+}
+
+SECTION( "non-positive sizes leave the image unchanged" )
+{
+	Channel32f channel( 16, 16 );
+	fillRandom( &channel, 3 );
+	REQUIRE( maxDifference( ip::gaussianBlurCopy( channel, 0 ), channel ) == 0 );
+	REQUIRE( maxDifference( ip::boxBlurCopy( channel, -1 ), channel ) == 0 );
+}
+
+} // "ip/Blur"
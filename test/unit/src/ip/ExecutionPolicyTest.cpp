@@ -0,0 +1,124 @@
+#include "catch.hpp"
+#include "Utilities.h"
+
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/Flip.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/Resize.h"
+#include "cinder/ip/Threshold.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// Runs \a fn on a copy of \a source serially and on another copy with many small bands, returning whether the results match
+template<typename IMAGET, typename FN>
+bool matchesSerial( const IMAGET &source, FN fn )
+{
+	IMAGET serial = source.clone();
+	{
+		ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy::serial() );
+		fn( &serial );
+	}
+
+	IMAGET parallel = source.clone();
+	{
+		ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy::parallel( 4 ).minRowsPerTask( 3 ) );
+		fn( &parallel );
+	}
+
+	return pixelsEqual( serial, parallel );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/ExecutionPolicy" )
+{
+
+SECTION( "policy defaults to serial and is restored by ScopedExecutionPolicy" )
+{
+	REQUIRE( ip::getExecutionPolicy().isSerial() );
+	{
+		ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy::parallel( 3 ) );
+		REQUIRE( ip::getExecutionPolicy().getNumThreads() == 3 );
+	}
+	REQUIRE( ip::getExecutionPolicy().isSerial() );
+	REQUIRE( ip::ExecutionPolicy::parallel().getNumThreads() >= 1 );
+}
+
+SECTION( "parallelBands covers every index exactly once" )
+{
+	ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy::parallel( 4 ).minRowsPerTask( 1 ) );
+	vector<std::atomic<int>> visits( 1001 );
+	for( auto &v : visits )
+		v = 0;
+
+	ip::detail::parallelBands( 0, (int32_t)visits.size(), [&]( int32_t begin, int32_t end ) {
+		for( int32_t i = begin; i < end; ++i )
+			++visits[i];
+	} );
+
+	for( auto &v : visits )
+		REQUIRE( v == 1 );
+}
+
+SECTION( "parallelBands rethrows exceptions on the calling thread" )
+{
+	ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy::parallel( 4 ).minRowsPerTask( 1 ) );
+	REQUIRE_THROWS( ip::detail::parallelBands( 0, 64, []( int32_t begin, int32_t end ) {
+		if( begin <= 40 && 40 < end )
+			throw std::runtime_error( "band failure" );
+	} ) );
+}
+
+SECTION( "parallel results match serial results" )
+{
+	Surface8u surface8u( 173, 131, true );
+	fillRandom( &surface8u, 1 );
+	Surface8u foreground8u( 173, 131, true );
+	fillRandom( &foreground8u, 2 );
+	Surface32f surface32f( 97, 113, true );
+	fillRandom( &surface32f, 3 );
+	Channel8u channel8u( 211, 97 );
+	fillRandom( &channel8u, 4 );
+	Channel32f channel32f( 89, 143 );
+	fillRandom( &channel32f, 5 );
+
+	REQUIRE( matchesSerial( surface8u, []( Surface8u *s ) { ip::stackBlur( s, 7 ); } ) );
+	REQUIRE( matchesSerial( channel8u, []( Channel8u *c ) { ip::stackBlur( c, 11 ); } ) );
+	REQUIRE( matchesSerial( surface32f, []( Surface32f *s ) { ip::stackBlur( s, 5 ); } ) );
+	REQUIRE( matchesSerial( channel32f, []( Channel32f *c ) { ip::stackBlur( c, Area( 10, 10, 60, 100 ), 4 ); } ) );
+	REQUIRE( matchesSerial( surface8u, []( Surface8u *s ) { ip::gaussianBlur( s, 6.5f ); } ) );
+	REQUIRE( matchesSerial( channel32f, []( Channel32f *c ) { ip::boxBlur( c, Area( 5, 20, 80, 90 ), 3.25f ); } ) );
+
+	REQUIRE( matchesSerial( surface8u, []( Surface8u *s ) { ip::threshold( s, (uint8_t)100 ); } ) );
+	REQUIRE( matchesSerial( channel8u, []( Channel8u *c ) { ip::adaptiveThreshold( c, 16, 0.1f ); } ) );
+	REQUIRE( matchesSerial( channel8u, []( Channel8u *c ) { ip::adaptiveThresholdZero( c, 16 ); } ) );
+	REQUIRE( matchesSerial( channel8u, []( Channel8u *c ) { Channel8u src = c->clone(); ip::boxFilter( src, 9, c ); } ) );
+	REQUIRE( matchesSerial( channel32f, []( Channel32f *c ) { Channel32f src = c->clone(); ip::localContrastNormalize( src, 9, c ); } ) );
+
+	REQUIRE( matchesSerial( surface8u, []( Surface8u *s ) { ip::premultiply( s ); } ) );
+	REQUIRE( matchesSerial( surface8u, []( Surface8u *s ) { ip::unpremultiply( s ); } ) );
+	REQUIRE( matchesSerial( surface32f, []( Surface32f *s ) { ip::premultiply( s ); } ) );
+	REQUIRE( matchesSerial( surface8u, []( Surface8u *s ) { ip::flipVertical( s ); } ) );
+	REQUIRE( matchesSerial( surface8u, [&]( Surface8u *s ) { ip::blend( s, foreground8u ); } ) );
+	REQUIRE( matchesSerial( surface32f, [&]( Surface32f *s ) { Surface32f src = s->clone(); ip::flipVertical( src, s ); } ) );
+	REQUIRE( matchesSerial( surface8u, [&]( Surface8u *s ) { ip::grayscale( foreground8u, s ); } ) );
+	REQUIRE( matchesSerial( channel8u, [&]( Channel8u *c ) { Channel8u src = c->clone(); ip::edgeDetectSobel( src, c ); } ) );
+
+	Surface8u resized8u( 61, 250, true );
+	REQUIRE( matchesSerial( resized8u, [&]( Surface8u *s ) { ip::resize( surface8u, s, FilterCubic() ); } ) );
+	Channel32f resized32f( 300, 37 );
+	REQUIRE( matchesSerial( resized32f, [&]( Channel32f *c ) { ip::resize( channel32f, c, FilterGaussian() ); } ) );
+}
+
+} // "ip/ExecutionPolicy"
@@ -0,0 +1,150 @@
+#include "catch.hpp"
+#include "Utilities.h"
+
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/Rand.h"
+
+#include <cmath>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+template<typename T>
+void bruteForce( const ChannelT<T> &channel, const Area &area, double *sum, double *sumSquares, int32_t *count )
+{
+	const Area clipped = area.getClipBy( channel.getBounds() );
+	*sum = *sumSquares = 0;
+	*count = std::max( 0, clipped.getWidth() ) * std::max( 0, clipped.getHeight() );
+	for( int32_t y = clipped.y1; y < clipped.y2; ++y ) {
+		for( int32_t x = clipped.x1; x < clipped.x2; ++x ) {
+			double v = channel.getValue( ivec2( x, y ) );
+			*sum += v;
+			*sumSquares += v * v;
+		}
+	}
+}
+
+template<typename T>
+void checkQueries( const ChannelT<T> &channel, const ip::IntegralImageT<T> &integralImage, uint32_t seed )
+{
+	Rand rnd( seed );
+	for( int i = 0; i < 200; ++i ) {
+		int32_t x1 = rnd.nextInt( -10, channel.getWidth() + 10 ), y1 = rnd.nextInt( -10, channel.getHeight() + 10 );
+		Area area( x1, y1, x1 + rnd.nextInt( 0, 60 ), y1 + rnd.nextInt( 0, 60 ) );
+		double sum, sumSquares;
+		int32_t count;
+		bruteForce( channel, area, &sum, &sumSquares, &count );
+
+		REQUIRE( (double)integralImage.getSum( area ) == Approx( sum ).epsilon( 1e-9 ) );
+		REQUIRE( (double)integralImage.getSumSquares( area ) == Approx( sumSquares ).epsilon( 1e-9 ) );
+		if( count > 0 ) {
+			double mean = sum / count;
+			REQUIRE( integralImage.getMean( area ) == Approx( mean ).epsilon( 1e-9 ) );
+			REQUIRE( integralImage.getVariance( area ) == Approx( sumSquares / count - mean * mean ).epsilon( 1e-6 ).margin( 1e-9 ) );
+		}
+		else
+			REQUIRE( integralImage.getMean( area ) == 0 );
+	}
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/IntegralImage" )
+{
+
+SECTION( "rectangle queries match brute force sums" )
+{
+	Channel8u channel8u( 97, 61 );
+	fillRandom( &channel8u, 1 );
+	checkQueries( channel8u, ip::IntegralImage8u( channel8u, true ), 2 );
+
+	Channel16u channel16u( 83, 71 );
+	fillRandom( &channel16u, 3 );
+	checkQueries( channel16u, ip::IntegralImage16u( channel16u, true ), 4 );
+
+	Channel32f channel32f( 64, 64 );
+	fillRandom( &channel32f, 5 );
+	checkQueries( channel32f, ip::IntegralImage32f( channel32f, true ), 6 );
+
+	REQUIRE( ! ip::IntegralImage8u( channel8u ).hasSquares() );
+	REQUIRE( ip::IntegralImage8u( channel8u ).getSize() == channel8u.getSize() );
+}
+
+SECTION( "updating a sub-Area matches rebuilding the table" )
+{
+	Channel16u channel( 75, 50 );
+	fillRandom( &channel, 7 );
+	ip::IntegralImage16u integralImage( channel, true );
+
+	const Area changed( 20, 10, 41, 33 );
+	Rand rnd( 8 );
+	for( int32_t y = changed.y1; y < changed.y2; ++y ) {
+		for( int32_t x = changed.x1; x < changed.x2; ++x )
+			channel.setValue( ivec2( x, y ), (uint16_t)rnd.nextInt( 65536 ) );
+	}
+	integralImage.update( channel, changed );
+
+	ip::IntegralImage16u rebuilt( channel, true );
+	const size_t numEntries = integralImage.getStride() * ( channel.getHeight() + 1 );
+	REQUIRE( std::equal( integralImage.getSums(), integralImage.getSums() + numEntries, rebuilt.getSums() ) );
+	REQUIRE( std::equal( integralImage.getSumsSquares(), integralImage.getSumsSquares() + numEntries, rebuilt.getSumsSquares() ) );
+}
+
+SECTION( "boxFilter averages the clipped window" )
+{
+	Channel8u channel( 45, 38 );
+	fillRandom( &channel, 9 );
+	Channel8u filtered( 45, 38 );
+	ip::boxFilter( channel, 7, &filtered );
+
+	for( int32_t y = 0; y < channel.getHeight(); ++y ) {
+		for( int32_t x = 0; x < channel.getWidth(); ++x ) {
+			double sum, sumSquares;
+			int32_t count;
+			bruteForce( channel, Area( x - 3, y - 3, x + 4, y + 4 ), &sum, &sumSquares, &count );
+			REQUIRE( filtered.getValue( ivec2( x, y ) ) == (uint8_t)( sum / count + 0.5 ) );
+		}
+	}
+}
+
+SECTION( "localContrastNormalize produces z-scores" )
+{
+	Channel32f channel( 40, 30 );
+	fillRandom( &channel, 10 );
+	Channel32f normalized( 40, 30 );
+	ip::IntegralImage32f integralImage( channel, true );
+	ip::localContrastNormalize( channel, integralImage, 9, &normalized );
+
+	for( int32_t y = 0; y < channel.getHeight(); y += 3 ) {
+		for( int32_t x = 0; x < channel.getWidth(); x += 3 ) {
+			double sum, sumSquares;
+			int32_t count;
+			bruteForce( channel, Area( x - 4, y - 4, x + 5, y + 5 ), &sum, &sumSquares, &count );
+			double mean = sum / count, stdDev = std::sqrt( sumSquares / count - mean * mean );
+			REQUIRE( normalized.getValue( ivec2( x, y ) ) == Approx( ( channel.getValue( ivec2( x, y ) ) - mean ) / stdDev ).epsilon( 1e-4 ) );
+		}
+	}
+
+	REQUIRE_THROWS( ip::localContrastNormalize( channel, ip::IntegralImage32f( channel ), 9, &normalized ) );
+}
+
+SECTION( "adaptiveThreshold can share an IntegralImage" )
+{
+	Channel8u channel( 120, 90 );
+	fillRandom( &channel, 11 );
+	ip::IntegralImage8u integralImage( channel );
+
+	Channel8u shared( 120, 90 ), own( 120, 90 );
+	ip::adaptiveThreshold( channel, integralImage, 15, 0.1f, &shared );
+	ip::adaptiveThreshold( channel, 15, 0.1f, &own );
+	REQUIRE( std::equal( shared.getData(), shared.getData() + shared.getRowBytes() * shared.getHeight(), own.getData() ) );
+
+	ip::adaptiveThresholdZero( channel, integralImage, 15, &shared );
+	ip::adaptiveThresholdZero( channel, 15, &own );
+	REQUIRE( std::equal( shared.getData(), shared.getData() + shared.getRowBytes() * shared.getHeight(), own.getData() ) );
+}
+
+} // "ip/IntegralImage"
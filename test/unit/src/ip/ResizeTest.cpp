@@ -0,0 +1,108 @@
+#include "catch.hpp"
+#include "Utilities.h"
+
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Resize.h"
+
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace ci;
+
+TEST_CASE( "ip/Resize" )
+{
+
+SECTION( "ResizePlan matches ip::resize and can be reused" )
+{
+	Surface8u src8u( 193, 121, true );
+	Surface32f src32f( 193, 121, false );
+	fillRandom( &src8u, 1 );
+	fillRandom( &src32f, 2 );
+
+	for( ivec2 dstSize : { ivec2( 64, 40 ), ivec2( 300, 77 ), ivec2( 193, 121 ) } ) {
+		ip::ResizePlan plan( src8u.getSize(), dstSize, FilterCubic() );
+		Surface8u expected8u( dstSize.x, dstSize.y, true );
+		ip::resize( src8u, &expected8u, FilterCubic() );
+		Surface32f expected32f( dstSize.x, dstSize.y, false );
+		ip::resize( src32f, &expected32f, FilterCubic() );
+
+		for( int run = 0; run < 2; ++run ) {
+			Surface8u result8u( dstSize.x, dstSize.y, true );
+			plan.execute( src8u, &result8u );
+			REQUIRE( pixelsEqual( result8u, expected8u ) );
+
+			Surface32f result32f( dstSize.x, dstSize.y, false );
+			plan.execute( src32f, &result32f );
+			REQUIRE( pixelsEqual( result32f, expected32f ) );
+		}
+	}
+}
+
+SECTION( "ResizePlan results do not depend on the ExecutionPolicy" )
+{
+	Surface8u src( 640, 360, true );
+	fillRandom( &src, 3 );
+	ip::ResizePlan plan( src.getSize(), Area( 20, 10, 600, 350 ), ivec2( 211, 117 ), Area( 5, 5, 200, 110 ), FilterGaussian() );
+
+	Surface8u serial( 211, 117, true ), parallel( 211, 117, true );
+	ip::fill( &serial, ColorA8u( 0, 0, 0, 0 ) );
+	ip::fill( &parallel, ColorA8u( 0, 0, 0, 0 ) );
+	{
+		ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy::serial().simd( false ) );
+		plan.execute( src, &serial );
+	}
+	{
+		ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy::parallel( 4 ).minRowsPerTask( 3 ) );
+		plan.execute( src, &parallel );
+	}
+	REQUIRE( pixelsEqual( serial, parallel ) );
+	REQUIRE( plan.getDstArea().getUL() == ivec2( 5, 5 ) );
+	REQUIRE( serial.getPixel( ivec2( 2, 2 ) ) == ColorA8u( 0, 0, 0, 0 ) );
+}
+
+SECTION( "A ResizePlan can first be executed from several threads at once" )
+{
+	Surface8u src8u( 160, 90, true );
+	Surface32f src32f( 160, 90, true );
+	fillRandom( &src8u, 4 );
+	fillRandom( &src32f, 5 );
+	Surface8u expected8u( 97, 61, true );
+	ip::resize( src8u, &expected8u );
+	Surface32f expected32f( 97, 61, true );
+	ip::resize( src32f, &expected32f );
+
+	// each thread's first execution of either channel type may be the one that builds its weights
+	ip::ResizePlan plan( src8u.getSize(), expected8u.getSize() );
+	vector<Surface8u> results8u( 4, Surface8u( 97, 61, true ) );
+	vector<Surface32f> results32f( 4, Surface32f( 97, 61, true ) );
+	vector<thread> threads;
+	for( size_t t = 0; t < 4; ++t ) {
+		threads.emplace_back( [&, t] {
+			plan.execute( src8u, &results8u[t] );
+			plan.execute( src32f, &results32f[t] );
+		} );
+	}
+	for( auto &thread : threads )
+		thread.join();
+
+	for( size_t t = 0; t < 4; ++t ) {
+		REQUIRE( pixelsEqual( results8u[t], expected8u ) );
+		REQUIRE( pixelsEqual( results32f[t], expected32f ) );
+	}
+}
+
+SECTION( "ResizePlan rejects images of other sizes" )
+{
+	ip::ResizePlan plan( ivec2( 64, 64 ), ivec2( 32, 32 ) );
+	Channel8u src( 64, 64 ), wrongSrc( 65, 64 ), dst( 32, 32 );
+	REQUIRE_NOTHROW( plan.execute( src, &dst ) );
+	REQUIRE_THROWS_AS( plan.execute( wrongSrc, &dst ), ip::ResizePlan::Exception );
+
+	ip::ResizePlan empty;
+	REQUIRE( empty.isEmpty() );
+	REQUIRE( ip::ResizePlan( ivec2( 64, 64 ), Area( 100, 100, 120, 120 ), ivec2( 32, 32 ), Area( 0, 0, 32, 32 ) ).isEmpty() );
+}
+
+} // "ip/Resize"
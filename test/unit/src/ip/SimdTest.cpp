@@ -0,0 +1,189 @@
+#include "catch.hpp"
+#include "../../../../src/cinder/ip/Simd.h"
+
+#include "cinder/ip/ExecutionPolicy.h"
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/Rand.h"
+
+#include <cmath>
+
+using namespace std;
+using namespace ci;
+
+namespace {
+
+// Fills with random values, biasing alpha towards the fully transparent and fully opaque edge cases
+template<typename T>
+void fillRandom( SurfaceT<T> *surface, uint32_t seed )
+{
+	Rand rnd( seed );
+	auto iter = surface->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			iter.g() = CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			iter.b() = CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			if( surface->hasAlpha() ) {
+				int choice = rnd.nextInt( 8 );
+				uint8_t alpha = ( choice == 0 ) ? 0 : ( ( choice == 1 ) ? 255 : (uint8_t)rnd.nextInt( 256 ) );
+				iter.a() = CHANTRAIT<T>::convert( alpha );
+			}
+		}
+	}
+}
+
+bool valuesMatch( uint8_t a, uint8_t b )
+{
+	return a == b;
+}
+
+bool valuesMatch( float a, float b )
+{
+	return std::abs( a - b ) <= 1e-5f * std::max( 1.0f, std::abs( a ) );
+}
+
+// 8-bit results must be bit-exact, float results may differ by rounding
+template<typename T>
+bool imagesMatch( const SurfaceT<T> &a, const SurfaceT<T> &b )
+{
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		const T *rowA = a.getData( ivec2( 0, y ) ), *rowB = b.getData( ivec2( 0, y ) );
+		for( int32_t i = 0; i < a.getWidth() * a.getPixelInc(); ++i ) {
+			if( ! valuesMatch( rowA[i], rowB[i] ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+template<typename T>
+bool imagesMatch( const ChannelT<T> &a, const ChannelT<T> &b )
+{
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( ! valuesMatch( a.getValue( ivec2( x, y ) ), b.getValue( ivec2( x, y ) ) ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+// Runs \a fn on a copy of \a source with SIMD kernels disabled and on another copy with them enabled, returning whether the results match
+template<typename IMAGET, typename FN>
+bool matchesScalar( const IMAGET &source, FN fn )
+{
+	IMAGET scalar = source.clone();
+	{
+		ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy::serial().simd( false ) );
+		fn( &scalar );
+	}
+
+	IMAGET simd = source.clone();
+	fn( &simd );
+
+	return imagesMatch( scalar, simd );
+}
+
+const int kAlphaOrders[] = { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR };
+// the 4-byte orders without alpha that keep the color offsets of the corresponding entry of kAlphaOrders
+const int kNoAlphaOrders[] = { SurfaceChannelOrder::RGBX, SurfaceChannelOrder::BGRX, SurfaceChannelOrder::XRGB, SurfaceChannelOrder::XBGR };
+// widths that exercise the widest vectors as well as the scalar remainder of each row
+const int32_t kWidths[] = { 3, 53, 131 };
+
+template<typename T>
+SurfaceT<T> makeSurface( int32_t width, int order, bool alpha, uint32_t seed )
+{
+	SurfaceT<T> result( width, 7, alpha, SurfaceChannelOrder( order ) );
+	fillRandom( &result, seed );
+	return result;
+}
+
+template<typename T>
+void testPremultiply()
+{
+	for( auto order : kAlphaOrders ) {
+		for( int32_t width : kWidths ) {
+			SurfaceT<T> surface = makeSurface<T>( width, order, true, width * 7 + order );
+			REQUIRE( matchesScalar( surface, []( SurfaceT<T> *s ) { ip::premultiply( s ); } ) );
+			surface.setPremultiplied( true );
+			REQUIRE( matchesScalar( surface, []( SurfaceT<T> *s ) { ip::unpremultiply( s ); } ) );
+		}
+	}
+}
+
+template<typename T>
+void testGrayscale()
+{
+	for( auto order : kAlphaOrders ) {
+		for( int32_t width : kWidths ) {
+			SurfaceT<T> surface = makeSurface<T>( width, order, true, width * 11 + order );
+			REQUIRE( matchesScalar( surface, []( SurfaceT<T> *s ) { ip::grayscale( s->clone(), s ); } ) );
+
+			// into a surface of a different channel order
+			SurfaceT<T> bgra = makeSurface<T>( width, SurfaceChannelOrder::BGRA, true, width );
+			REQUIRE( matchesScalar( bgra, [&]( SurfaceT<T> *s ) { ip::grayscale( surface, s ); } ) );
+
+			ChannelT<T> channel( width, surface.getHeight() );
+			REQUIRE( matchesScalar( channel, [&]( ChannelT<T> *c ) { ip::grayscale( surface, c ); } ) );
+		}
+	}
+}
+
+template<typename T>
+void testBlend()
+{
+	for( size_t o = 0; o < 4; ++o ) {
+		for( int32_t width : kWidths ) {
+			for( bool srcPremult : { false, true } ) {
+				SurfaceT<T> foreground = makeSurface<T>( width, kAlphaOrders[o], true, width * 13 + (uint32_t)o );
+				foreground.setPremultiplied( srcPremult );
+
+				for( bool dstPremult : { false, true } ) {
+					SurfaceT<T> background = makeSurface<T>( width, kAlphaOrders[o], true, width * 17 + (uint32_t)o );
+					background.setPremultiplied( dstPremult );
+					REQUIRE( matchesScalar( background, [&]( SurfaceT<T> *s ) { ip::blend( s, foreground ); } ) );
+				}
+
+				SurfaceT<T> noAlpha = makeSurface<T>( width, kNoAlphaOrders[o], false, width * 19 + (uint32_t)o );
+				REQUIRE( matchesScalar( noAlpha, [&]( SurfaceT<T> *s ) { ip::blend( s, foreground ); } ) );
+
+				// mismatched channel orders fall back to the scalar code
+				SurfaceT<T> mismatched = makeSurface<T>( width, kAlphaOrders[( o + 1 ) % 4], true, width * 23 + (uint32_t)o );
+				mismatched.setPremultiplied( true );
+				REQUIRE( matchesScalar( mismatched, [&]( SurfaceT<T> *s ) { ip::blend( s, foreground ); } ) );
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Simd" )
+{
+	SECTION( "policy disables SIMD" )
+	{
+		ip::ScopedExecutionPolicy scp( ip::ExecutionPolicy().simd( false ) );
+		REQUIRE( ! ip::getExecutionPolicy().isSimdEnabled() );
+		REQUIRE( ip::detail::getSimdLevel() == ip::detail::SimdLevel::NONE );
+	}
+
+	SECTION( "premultiply and unpremultiply match scalar" )
+	{
+		testPremultiply<uint8_t>();
+		testPremultiply<float>();
+	}
+
+	SECTION( "grayscale matches scalar" )
+	{
+		testGrayscale<uint8_t>();
+		testGrayscale<float>();
+	}
+
+	SECTION( "blend matches scalar" )
+	{
+		testBlend<uint8_t>();
+		testBlend<float>();
+	}
+}
@@ -0,0 +1,82 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Decodes a binary log written through ci::log::DeferredLogManager::setBinaryFile() into the layout of the text Loggers.
+//
+// usage: LogDecoder <binary log> [<text file>] [--timestamps | --no-timestamps]
+//
+// With a text file the entries are written as LoggerFile would have, timestamps included. Otherwise they are printed to the console as
+// LoggerConsole would, without timestamps. The flags override either default.
+
+#include "cinder/LogDeferred.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace ci;
+
+int main( int argc, char *argv[] )
+{
+	std::vector<std::string> paths;
+	int timestamps = -1;
+	for( int i = 1; i < argc; ++i ) {
+		if( std::strcmp( argv[i], "--timestamps" ) == 0 )
+			timestamps = 1;
+		else if( std::strcmp( argv[i], "--no-timestamps" ) == 0 )
+			timestamps = 0;
+		else
+			paths.push_back( argv[i] );
+	}
+
+	if( paths.empty() || paths.size() > 2 ) {
+		std::fprintf( stderr, "usage: %s <binary log> [<text file>] [--timestamps | --no-timestamps]\n", argc > 0 ? argv[0] : "LogDecoder" );
+		return 2;
+	}
+
+	std::unique_ptr<log::Logger> logger;
+	// LoggerFile would otherwise place a bare file name next to the executable rather than in the working directory
+	if( paths.size() == 2 )
+		logger.reset( new log::LoggerFile( fs::absolute( paths[1] ), false ) );
+	else
+		logger.reset( new log::LoggerConsole );
+	logger->setLevel( log::LEVEL_VERBOSE );
+	if( timestamps >= 0 )
+		logger->setTimestampEnabled( timestamps == 1 );
+
+	size_t numEntries = 0;
+	try {
+		log::readDeferredLog( paths[0], [&]( const log::Metadata &meta, const std::string &text ) {
+			logger->write( meta, text );
+			++numEntries;
+		} );
+	}
+	catch( const log::DeferredLogExc &exc ) {
+		// the entries before a truncated record, as left by a crash, are still written
+		logger->flush();
+		std::fprintf( stderr, "LogDecoder: %s, after %zu entries\n", exc.what(), numEntries );
+		return 1;
+	}
+
+	logger->flush();
+	return 0;
+}